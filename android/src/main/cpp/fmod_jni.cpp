@@ -2,9 +2,34 @@
 #include <android/log.h>
 #include <string>
 #include <map>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
 #include <fmod.hpp>
 #include <fmod_studio.hpp>
 #include <fmod_errors.h>
+#include "audio_interruption.h"
+#include "beat_clock.h"
+#include "deferred_writes.h"
+#include "dsp_effects.h"
+#include "emitter_culler.h"
+#include "event_lookup.h"
+#include "global_parameters.h"
+#include "instance_pool.h"
+#include "instance_states.h"
+#include "instance_sweeper.h"
+#include "mic_capture.h"
+#include "mixer_control.h"
+#include "mixer_lifecycle.h"
+#include "offline_output.h"
+#include "parameter_automation.h"
+#include "pcm_sounds.h"
+#include "pcm_stream.h"
+#include "sound_library.h"
+#include "spectrum_analyzer.h"
+#include "voice_stats.h"
 
 #define LOG_TAG "FmodJNI"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
@@ -17,11 +42,445 @@ static FMOD::System* coreSystem = nullptr;
 // Map to track event instances by path
 static std::map<std::string, FMOD::Studio::EventInstance*> eventInstances;
 
+// A 3D emitter registered from Dart. instance is nullptr while the emitter
+// is culled; only emitters started by the caller are culled.
+struct Emitter {
+    FMOD::Studio::EventDescription* description;
+    FMOD::Studio::EventInstance* instance;
+    FMOD_3D_ATTRIBUTES attributes;
+    float maxDistance;
+    bool playing;
+};
+
+// 3D emitters keyed by emitter id. Unlike eventInstances, several emitters
+// may play the same event.
+static std::map<int, Emitter> emitters;
+static int nextEmitterId = 1;
+static int listenerCount = 1;
+
+// Distance culling of emitters against the listener positions (xyz per
+// listener) from the last spatial update
+static fmod_flutter::EmitterCuller emitterCuller;
+static std::vector<float> listenerPositions;
+static bool emitterCulling = false;
+
+// Built-in DSP effects attached to buses
+static fmod_flutter::BusEffects busEffects;
+
+// Bus, VCA and snapshot handles cached at bank load; volume ramps advance
+// on each update tick
+static fmod_flutter::MixerControl mixerControl;
+
+// Mixer suspended while the activity is paused or audio focus is lost
+static fmod_flutter::MixerLifecycle mixerLifecycle;
+
+// Loose sounds outside Studio banks, including the compact .fca format
+static fmod_flutter::SoundLibrary soundLibrary;
+
+// Streams that Dart pushes PCM into through dart:ffi
+static fmod_flutter::PcmStreams pcmStreams;
+
+// Microphone recording, tapped for Dart on each update tick
+static fmod_flutter::MicCapture micCapture;
+
+// Voice and virtualization statistics, sampled on each update tick
+static fmod_flutter::VoiceStats voiceStats;
+
+// Device, headless or offline output chosen at initialize
+static fmod_flutter::OfflineOutput offlineOutput;
+
+// Response to audio focus loss, per interruption policy
+static fmod_flutter::AudioInterruption audioInterruption;
+
+// Global parameter IDs resolved at bank load
+static fmod_flutter::GlobalParameters globalParameters;
+
+// Stopped instances kept for reuse by playEvent, per event path
+static fmod_flutter::InstancePool instancePool;
+
+// Parameter curves applied on each update tick
+static fmod_flutter::ParameterAutomation parameterAutomation;
+
+// When the update tick last ran; unset before the first
+static std::chrono::steady_clock::time_point lastUpdate;
+
+// Parameter, volume and pitch writes, coalesced and flushed before each
+// Studio update
+static fmod_flutter::DeferredWrites deferredWrites;
+
+// FFT analyzers on buses and instances, published on each update tick
+static fmod_flutter::SpectrumAnalyzers spectrumAnalyzers;
+
+// States of every live event and emitter instance, read on each update tick
+static fmod_flutter::InstanceStates instanceStates;
+
+// Instances started by playEvent, swept on each update tick for those that
+// finished on their own; their events wait in finishedEvents for Kotlin
+static fmod_flutter::InstanceSweeper instanceSweeper;
+static std::vector<std::string> finishedEvents;
+
+// Packed spatial layout: position, velocity, forward and up vectors
+// (matches FMOD_3D_ATTRIBUTES)
+static const int kSpatialFloatsPerEntity = 12;
+
+// How far ahead of a beat a schedule is armed on the DSP clock. Must cover
+// at least one update tick (~16 ms) plus timer jitter.
+static const int kBeatScheduleLookaheadMs = 50;
+
+// Latest timeline beat reported by FMOD for an event instance, anchored to
+// the mixer DSP clock on the next update tick.
+struct BeatState {
+    int bar;
+    int beat;
+    int beatsPerBar;
+    float tempo;
+    int position;
+    bool anchored;
+    unsigned long long anchorClock;
+};
+
+// A pending scheduleAtBeat request.
+struct BeatSchedule {
+    int id;
+    std::string eventPath;
+    int bar;
+    int beat;
+    std::string startEventPath;
+};
+
+// A schedule that has been armed, waiting to be reported to Kotlin.
+struct FiredBeatSchedule {
+    int id;
+    int bar;
+    int beat;
+    unsigned long long dspClock;
+};
+
+// Beat states are written from the Studio update thread (event callbacks)
+// and read from the main thread, so they are guarded by beatMutex.
+static std::mutex beatMutex;
+static std::map<FMOD_STUDIO_EVENTINSTANCE*, BeatState> beatStates;
+static std::vector<BeatSchedule> beatSchedules;
+static std::vector<FiredBeatSchedule> firedBeatSchedules;
+static int nextBeatScheduleId = 1;
+
+static FMOD_RESULT F_CALL beatCallback(
+    FMOD_STUDIO_EVENT_CALLBACK_TYPE type,
+    FMOD_STUDIO_EVENTINSTANCE* event,
+    void* parameters) {
+    
+    // Replaces the voice statistics description callback on this instance.
+    if ((type & FMOD_FLUTTER_VOICE_STATS_CALLBACKS) != 0) {
+        return fmod_flutter::VoiceStats::EventCallback(type, event, parameters);
+    }
+    
+    std::lock_guard<std::mutex> lock(beatMutex);
+    
+    if (type == FMOD_STUDIO_EVENT_CALLBACK_DESTROYED) {
+        beatStates.erase(event);
+        return FMOD_OK;
+    }
+    
+    const FMOD_STUDIO_TIMELINE_BEAT_PROPERTIES* props =
+        static_cast<const FMOD_STUDIO_TIMELINE_BEAT_PROPERTIES*>(parameters);
+    
+    BeatState& state = beatStates[event];
+    state.bar = props->bar;
+    state.beat = props->beat;
+    state.beatsPerBar = props->timesignatureupper;
+    state.tempo = props->tempo;
+    state.position = props->position;
+    state.anchored = false;
+    state.anchorClock = 0;
+    return FMOD_OK;
+}
+
+// Reads the current mixer DSP clock and output sample rate.
+static bool getMixerClock(unsigned long long* clock, int* sampleRate) {
+    if (coreSystem == nullptr) {
+        return false;
+    }
+    
+    FMOD::ChannelGroup* masterGroup = nullptr;
+    if (coreSystem->getMasterChannelGroup(&masterGroup) != FMOD_OK ||
+        masterGroup->getDSPClock(clock, nullptr) != FMOD_OK) {
+        return false;
+    }
+    
+    return coreSystem->getSoftwareFormat(sampleRate, nullptr, nullptr) == FMOD_OK;
+}
+
+// The C and C++ handles are interchangeable; the shared sources use the C API
+static FMOD_STUDIO_SYSTEM* studioC() {
+    return reinterpret_cast<FMOD_STUDIO_SYSTEM*>(studioSystem);
+}
+
+static FMOD_SYSTEM* coreC() {
+    return reinterpret_cast<FMOD_SYSTEM*>(coreSystem);
+}
+
+static std::string toStdString(JNIEnv* env, jstring value) {
+    const char* chars = env->GetStringUTFChars(value, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(value, chars);
+    return result;
+}
+
+static FMOD_STUDIO_EVENTINSTANCE* instanceC(FMOD::Studio::EventInstance* instance) {
+    return reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(instance);
+}
+
+// Returns a stopped (or stopping) instance to its event's pool. Curves,
+// queued writes and beat tracking are dropped so a reused instance starts
+// clean.
+static void recycleInstance(const std::string& path, FMOD::Studio::EventInstance* instance) {
+    parameterAutomation.CancelInstance(instanceC(instance));
+    deferredWrites.Forget(instanceC(instance));
+    instanceSweeper.Forget(instanceC(instance));
+    {
+        std::lock_guard<std::mutex> lock(beatMutex);
+        beatStates.erase(instanceC(instance));
+    }
+    instancePool.Recycle(path.c_str(), instanceC(instance));
+}
+
+// Creates and starts an instance of eventPath, replacing any instance already
+// tracked for that path. A non-zero startClock delays the instance's channel
+// group until that mixer DSP clock tick, giving sample-accurate start.
+static bool startEvent(const std::string& path, unsigned long long startClock) {
+    // Check if event already has an instance
+    auto it = eventInstances.find(path);
+    if (it != eventInstances.end()) {
+        // Stop existing instance
+        it->second->stop(FMOD_STUDIO_STOP_IMMEDIATE);
+        recycleInstance(path, it->second);
+        eventInstances.erase(it);
+    }
+    
+    // Take an idle instance from the event's pool, or create one
+    FMOD::Studio::EventInstance* eventInstance = reinterpret_cast<FMOD::Studio::EventInstance*>(
+        instancePool.Acquire(studioC(), path.c_str()));
+    if (eventInstance == nullptr) {
+        FMOD_RESULT result = instancePool.last_result();
+        LOGE("Failed to create event instance for %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return false;
+    }
+    
+    FMOD_RESULT result;
+    
+    eventInstance->setCallback(
+        beatCallback,
+        FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_BEAT | FMOD_STUDIO_EVENT_CALLBACK_DESTROYED |
+            FMOD_FLUTTER_VOICE_STATS_CALLBACKS);
+    
+    if (startClock != 0) {
+        // The channel group only exists once the create command has been
+        // processed, so flush before delaying it.
+        FMOD::ChannelGroup* group = nullptr;
+        studioSystem->flushCommands();
+        result = eventInstance->getChannelGroup(&group);
+        if (result == FMOD_OK) {
+            group->setDelay(startClock, 0, false);
+        } else {
+            LOGE("Failed to get channel group for %s, starting immediately: %d - %s",
+                 path.c_str(), result, FMOD_ErrorString(result));
+        }
+    }
+    
+    // Start the event
+    result = eventInstance->start();
+    if (result != FMOD_OK) {
+        LOGE("Failed to start event: %d - %s", result, FMOD_ErrorString(result));
+        recycleInstance(path, eventInstance);
+        return false;
+    }
+    
+    // Store the instance
+    eventInstances[path] = eventInstance;
+    instanceSweeper.Watch(path.c_str(), instanceC(eventInstance));
+    return true;
+}
+
+static bool activateEmitter(int emitterId, Emitter& emitter) {
+    if (emitter.instance != nullptr) {
+        return true;
+    }
+    
+    FMOD_RESULT result = emitter.description->createInstance(&emitter.instance);
+    if (result != FMOD_OK) {
+        LOGE("Failed to create instance for emitter %d: %d - %s", emitterId, result, FMOD_ErrorString(result));
+        emitter.instance = nullptr;
+        return false;
+    }
+    
+    emitter.instance->set3DAttributes(&emitter.attributes);
+    emitter.instance->start();
+    return true;
+}
+
+static void deactivateEmitter(Emitter& emitter) {
+    if (emitter.instance == nullptr) {
+        return;
+    }
+    emitter.instance->stop(FMOD_STUDIO_STOP_ALLOWFADEOUT);
+    emitter.instance->release();
+    emitter.instance = nullptr;
+}
+
+// Wall-clock seconds since the previous update tick, which advance ramps and
+// curves. Renders advance them by the audio they mix instead, in
+// onRenderBlock, so a tick in a non-realtime mode adds no time.
+static float updateElapsedSeconds() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    float elapsed = 0.0f;
+    if (lastUpdate != std::chrono::steady_clock::time_point() &&
+        !offlineOutput.non_realtime()) {
+        elapsed = std::chrono::duration<float>(now - lastUpdate).count();
+    }
+    lastUpdate = now;
+    return elapsed;
+}
+
+// Advances ramps and curves after each block offlineOutput.Render mixes
+static void onRenderBlock(void* context, float blockSeconds) {
+    mixerControl.Update(blockSeconds);
+    parameterAutomation.Update(blockSeconds);
+}
+
+// Recycles tracked instances that finished on their own, a bounded number
+// per tick, and queues their events for Dart
+static void sweepFinishedInstances() {
+    instanceSweeper.Sweep(FMOD_FLUTTER_INSTANCE_SWEEP_BUDGET);
+    for (const auto& finished : instanceSweeper.finished()) {
+        // Dart may have played the event again since; only the tracked
+        // instance is reclaimed.
+        auto it = eventInstances.find(finished.key);
+        if (it == eventInstances.end() || instanceC(it->second) != finished.instance) {
+            continue;
+        }
+        recycleInstance(finished.key, it->second);
+        eventInstances.erase(it);
+        finishedEvents.push_back(finished.key);
+    }
+}
+
+// Reads back every tracked instance for queryInstances
+static void refreshInstanceStates() {
+    instanceStates.Begin();
+    for (const auto& pair : eventInstances) {
+        instanceStates.Add(pair.first.c_str(), instanceC(pair.second));
+    }
+    for (const auto& pair : emitters) {
+        if (pair.second.instance != nullptr) {
+            instanceStates.AddEmitter(pair.first, instanceC(pair.second.instance));
+        }
+    }
+}
+
+// Starts emitters that came into range and releases those that left it
+static void processEmitterCulling() {
+    if (!emitterCulling || emitters.empty()) {
+        return;
+    }
+    
+    emitterCuller.Evaluate(listenerPositions.data(), (int)(listenerPositions.size() / 3));
+    
+    const std::vector<int>& deactivated = emitterCuller.deactivated();
+    for (size_t i = 0; i < deactivated.size(); i++) {
+        auto it = emitters.find(deactivated[i]);
+        if (it != emitters.end()) {
+            deactivateEmitter(it->second);
+        }
+    }
+    
+    const std::vector<int>& activated = emitterCuller.activated();
+    for (size_t i = 0; i < activated.size(); i++) {
+        auto it = emitters.find(activated[i]);
+        if (it != emitters.end()) {
+            activateEmitter(activated[i], it->second);
+        }
+    }
+}
+
+// Anchors new beats to the DSP clock and arms any schedule whose target beat
+// falls within the lookahead window. Called once per update tick.
+static void processBeatSchedules() {
+    std::vector<BeatSchedule> armed;
+    std::vector<unsigned long long> armedClocks;
+    
+    {
+        std::lock_guard<std::mutex> lock(beatMutex);
+        
+        if (beatSchedules.empty()) {
+            return;
+        }
+        
+        unsigned long long now = 0;
+        int sampleRate = 0;
+        if (!getMixerClock(&now, &sampleRate) || sampleRate <= 0) {
+            return;
+        }
+        
+        long long lookahead = (long long)sampleRate * kBeatScheduleLookaheadMs / 1000;
+        
+        for (auto it = beatSchedules.begin(); it != beatSchedules.end();) {
+            auto instanceIt = eventInstances.find(it->eventPath);
+            if (instanceIt == eventInstances.end()) {
+                ++it;
+                continue;
+            }
+            
+            FMOD::Studio::EventInstance* instance = instanceIt->second;
+            auto stateIt = beatStates.find(reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(instance));
+            if (stateIt == beatStates.end() || stateIt->second.tempo <= 0.0f) {
+                ++it;
+                continue;
+            }
+            
+            BeatState& state = stateIt->second;
+            if (!state.anchored) {
+                // Place the beat on the DSP clock by how far the timeline has
+                // moved past it since the callback fired
+                int timelinePosition = state.position;
+                instance->getTimelinePosition(&timelinePosition);
+                long long sinceBeat = (long long)(timelinePosition - state.position) * sampleRate / 1000;
+                state.anchorClock = now - (sinceBeat > 0 ? sinceBeat : 0);
+                state.anchored = true;
+            }
+            
+            // A beat already behind now lands on now and fires at once.
+            unsigned long long target = fmod_flutter::BeatTargetClock(
+                state.anchorClock, state.bar, state.beat, state.beatsPerBar,
+                state.tempo, sampleRate, it->bar, it->beat, now);
+            if (target - now > (unsigned long long)lookahead) {
+                ++it;
+                continue;
+            }
+            
+            FiredBeatSchedule fired = { it->id, it->bar, it->beat, target };
+            firedBeatSchedules.push_back(fired);
+            armed.push_back(*it);
+            armedClocks.push_back(target);
+            it = beatSchedules.erase(it);
+        }
+    }
+    
+    // Started outside the lock: flushCommands waits on the Studio thread,
+    // which takes beatMutex when delivering callbacks
+    for (size_t i = 0; i < armed.size(); i++) {
+        if (!armed[i].startEventPath.empty() &&
+            startEvent(armed[i].startEventPath, armedClocks[i])) {
+            LOGD("Scheduled %s at bar %d beat %d (dsp clock %llu)",
+                 armed[i].startEventPath.c_str(), armed[i].bar, armed[i].beat, armedClocks[i]);
+        }
+    }
+}
+
 extern "C" {
 
 JNIEXPORT jboolean JNICALL
 Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeInitialize(
-    JNIEnv* env, jobject thiz) {
+    JNIEnv* env, jobject thiz, jint outputMode, jstring wavPath) {
     
     FMOD_RESULT result;
     
@@ -39,12 +498,22 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeInitialize(
         return JNI_FALSE;
     }
     
-    // Initialize with 512 channels
+    // Device output unless a headless or offline output was asked for
+    std::string wavFile = wavPath != nullptr ? toStdString(env, wavPath) : std::string();
+    if (!offlineOutput.Configure(coreC(), outputMode, wavFile.c_str())) {
+        result = offlineOutput.last_result();
+        LOGE("Failed to set output type %d: %d - %s", outputMode, result, FMOD_ErrorString(result));
+        if (outputMode != FMOD_FLUTTER_OUTPUT_DEVICE) {
+            return JNI_FALSE;
+        }
+    }
+    
+    // Initialize with the shared channel limit
     result = studioSystem->initialize(
-        512,
-        FMOD_STUDIO_INIT_NORMAL,
-        FMOD_INIT_NORMAL,
-        nullptr
+        FMOD_FLUTTER_MAX_CHANNELS,
+        offlineOutput.studio_init_flags(),
+        offlineOutput.core_init_flags(),
+        offlineOutput.extra_driver_data()
     );
     
     if (result != FMOD_OK) {
@@ -92,6 +561,9 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeLoadBank(
         return JNI_FALSE;
     }
     
+    mixerControl.CacheBanks(studioC());
+    globalParameters.CacheBanks(studioC());
+    
     LOGD("Bank loaded successfully");
     return JNI_TRUE;
 }
@@ -109,44 +581,61 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativePlayEvent(
     std::string path(pathStr);
     env->ReleaseStringUTFChars(eventPath, pathStr);
     
-    // Check if event already has an instance
-    auto it = eventInstances.find(path);
-    if (it != eventInstances.end()) {
-        // Stop existing instance
-        it->second->stop(FMOD_STUDIO_STOP_IMMEDIATE);
-        it->second->release();
-        eventInstances.erase(it);
+    if (!startEvent(path, 0)) {
+        return JNI_FALSE;
     }
     
-    // Get event description
-    FMOD::Studio::EventDescription* eventDesc = nullptr;
-    FMOD_RESULT result = studioSystem->getEvent(path.c_str(), &eventDesc);
-    if (result != FMOD_OK) {
-        LOGE("Failed to get event %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
-        return JNI_FALSE;
+    LOGD("Playing event: %s", path.c_str());
+    return JNI_TRUE;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativePlayEventAt(
+    JNIEnv* env, jobject thiz, jstring eventPath, jlong dspClockOffset, jlong fromDspClock) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
     }
     
-    // Create instance
-    FMOD::Studio::EventInstance* eventInstance = nullptr;
-    result = eventDesc->createInstance(&eventInstance);
-    if (result != FMOD_OK) {
-        LOGE("Failed to create event instance: %d - %s", result, FMOD_ErrorString(result));
-        return JNI_FALSE;
+    const char* pathStr = env->GetStringUTFChars(eventPath, nullptr);
+    std::string path(pathStr);
+    env->ReleaseStringUTFChars(eventPath, pathStr);
+    
+    unsigned long long base = (unsigned long long)fromDspClock;
+    if (base == 0) {
+        int sampleRate = 0;
+        if (!getMixerClock(&base, &sampleRate)) {
+            LOGE("Failed to read mixer DSP clock");
+            return 0;
+        }
     }
     
-    // Start the event
-    result = eventInstance->start();
-    if (result != FMOD_OK) {
-        LOGE("Failed to start event: %d - %s", result, FMOD_ErrorString(result));
-        eventInstance->release();
-        return JNI_FALSE;
+    unsigned long long startClock = base + (unsigned long long)(dspClockOffset > 0 ? dspClockOffset : 0);
+    if (!startEvent(path, startClock)) {
+        return 0;
     }
     
-    // Store the instance
-    eventInstances[path] = eventInstance;
+    LOGD("Playing event: %s at dsp clock %llu", path.c_str(), startClock);
+    return (jlong)startClock;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetDspClock(
+    JNIEnv* env, jobject thiz) {
     
-    LOGD("Playing event: %s", path.c_str());
-    return JNI_TRUE;
+    unsigned long long clock = 0;
+    int sampleRate = 0;
+    if (!getMixerClock(&clock, &sampleRate)) {
+        LOGE("Failed to read mixer DSP clock");
+        return nullptr;
+    }
+    
+    // Packed as [dspClock, sampleRate]
+    jlong packed[2] = { (jlong)clock, (jlong)sampleRate };
+    jlongArray result = env->NewLongArray(2);
+    env->SetLongArrayRegion(result, 0, 2, packed);
+    return result;
 }
 
 JNIEXPORT jboolean JNICALL
@@ -163,13 +652,16 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStopEvent(
         return JNI_FALSE;
     }
     
+    // Writes from earlier in this tick still apply to the fade-out; the
+    // instance is recycled below, which drops anything still queued.
+    deferredWrites.FlushInstance(instanceC(it->second));
     FMOD_RESULT result = it->second->stop(FMOD_STUDIO_STOP_ALLOWFADEOUT);
     if (result != FMOD_OK) {
         LOGE("Failed to stop event: %d - %s", result, FMOD_ErrorString(result));
         return JNI_FALSE;
     }
     
-    it->second->release();
+    recycleInstance(path, it->second);
     eventInstances.erase(it);
     
     LOGD("Stopped event: %s", path.c_str());
@@ -194,8 +686,9 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetParameter(
         return JNI_FALSE;
     }
     
-    FMOD_RESULT result = it->second->setParameterByName(param.c_str(), value);
-    if (result != FMOD_OK) {
+    parameterAutomation.CancelParameter(instanceC(it->second), param.c_str());
+    if (!deferredWrites.SetParameter(instanceC(it->second), param.c_str(), value)) {
+        FMOD_RESULT result = deferredWrites.last_result();
         LOGE("Failed to set parameter: %d - %s", result, FMOD_ErrorString(result));
         return JNI_FALSE;
     }
@@ -242,8 +735,8 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetVolume(
         return JNI_FALSE;
     }
     
-    FMOD_RESULT result = it->second->setVolume(volume);
-    if (result != FMOD_OK) {
+    if (!deferredWrites.SetVolume(instanceC(it->second), volume)) {
+        FMOD_RESULT result = deferredWrites.last_result();
         LOGE("Failed to set volume: %d - %s", result, FMOD_ErrorString(result));
         return JNI_FALSE;
     }
@@ -252,12 +745,47 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetVolume(
     return JNI_TRUE;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetPitch(
+    JNIEnv* env, jobject thiz, jstring eventPath, jfloat pitch) {
+    
+    const char* pathStr = env->GetStringUTFChars(eventPath, nullptr);
+    std::string path(pathStr);
+    env->ReleaseStringUTFChars(eventPath, pathStr);
+    
+    auto it = eventInstances.find(path);
+    if (it == eventInstances.end()) {
+        LOGD("No instance found for event: %s", path.c_str());
+        return JNI_FALSE;
+    }
+    
+    if (!deferredWrites.SetPitch(instanceC(it->second), pitch)) {
+        FMOD_RESULT result = deferredWrites.last_result();
+        LOGE("Failed to set pitch: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    
+    LOGD("Set pitch = %f for event: %s", pitch, path.c_str());
+    return JNI_TRUE;
+}
+
 JNIEXPORT void JNICALL
 Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeUpdate(
     JNIEnv* env, jobject thiz) {
     
     if (studioSystem != nullptr) {
+        deferredWrites.Flush();
         studioSystem->update();
+        processBeatSchedules();
+        processEmitterCulling();
+        float elapsed = updateElapsedSeconds();
+        mixerControl.Update(elapsed);
+        parameterAutomation.Update(elapsed);
+        spectrumAnalyzers.Update();
+        micCapture.Update();
+        voiceStats.Update();
+        sweepFinishedInstances();
+        refreshInstanceStates();
     }
 }
 
@@ -272,11 +800,54 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeRelease(
     }
     eventInstances.clear();
     
+    // Release all emitters
+    for (auto& pair : emitters) {
+        if (pair.second.instance != nullptr) {
+            pair.second.instance->stop(FMOD_STUDIO_STOP_IMMEDIATE);
+            pair.second.instance->release();
+        }
+    }
+    emitters.clear();
+    emitterCuller.Clear();
+    listenerPositions.clear();
+    listenerCount = 1;
+    
+    {
+        std::lock_guard<std::mutex> lock(beatMutex);
+        beatSchedules.clear();
+        firedBeatSchedules.clear();
+    }
+    
+    busEffects.Clear();
+    soundLibrary.Clear();
+    pcmStreams.Clear();
+    micCapture.Clear();
+    voiceStats.Clear();
+    instanceStates.Clear();
+    instanceSweeper.Clear();
+    finishedEvents.clear();
+    deferredWrites.Clear();
+    spectrumAnalyzers.Clear();
+    mixerControl.Clear();
+    parameterAutomation.Clear();
+    globalParameters.Clear();
+    instancePool.Clear();
+    lastUpdate = std::chrono::steady_clock::time_point();
+    
     // Release FMOD Studio System
     if (studioSystem != nullptr) {
+        mixerLifecycle.Resume(coreC(), studioC(), FMOD_FLUTTER_SUSPEND_ALL);
+        mixerLifecycle.Clear();
+        audioInterruption.Clear();
         studioSystem->release();
         studioSystem = nullptr;
         coreSystem = nullptr;
+        offlineOutput.Clear();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(beatMutex);
+        beatStates.clear();
     }
     
     LOGD("FMOD released");
@@ -337,16 +908,8 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetMasterPaused(
         return JNI_FALSE;
     }
     
-    FMOD::Studio::Bus* masterBus = nullptr;
-    FMOD_RESULT result = studioSystem->getBus("bus:/", &masterBus);
-    
-    if (result != FMOD_OK || masterBus == nullptr) {
-        LOGE("Failed to get master bus: %d - %s", result, FMOD_ErrorString(result));
-        return JNI_FALSE;
-    }
-    
-    result = masterBus->setPaused(paused == JNI_TRUE);
-    if (result != FMOD_OK) {
+    if (!mixerControl.SetBusPaused(studioC(), "bus:/", paused == JNI_TRUE)) {
+        FMOD_RESULT result = mixerControl.last_result();
         LOGE("Failed to set master paused: %d - %s", result, FMOD_ErrorString(result));
         return JNI_FALSE;
     }
@@ -355,5 +918,1150 @@ Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetMasterPaused(
     return JNI_TRUE;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeScheduleAtBeat(
+    JNIEnv* env, jobject thiz, jstring eventPath, jint bar, jint beat, jstring startEventPath) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    BeatSchedule schedule;
+    
+    const char* pathStr = env->GetStringUTFChars(eventPath, nullptr);
+    schedule.eventPath = pathStr;
+    env->ReleaseStringUTFChars(eventPath, pathStr);
+    
+    if (startEventPath != nullptr) {
+        const char* startStr = env->GetStringUTFChars(startEventPath, nullptr);
+        schedule.startEventPath = startStr;
+        env->ReleaseStringUTFChars(startEventPath, startStr);
+    }
+    
+    schedule.bar = bar;
+    schedule.beat = beat;
+    
+    std::lock_guard<std::mutex> lock(beatMutex);
+    schedule.id = nextBeatScheduleId++;
+    beatSchedules.push_back(schedule);
+    
+    LOGD("Scheduled beat %d.%d on %s (id %d)", bar, beat, schedule.eventPath.c_str(), schedule.id);
+    return schedule.id;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeCancelBeatSchedule(
+    JNIEnv* env, jobject thiz, jint scheduleId) {
+    
+    std::lock_guard<std::mutex> lock(beatMutex);
+    for (auto it = beatSchedules.begin(); it != beatSchedules.end(); ++it) {
+        if (it->id == scheduleId) {
+            beatSchedules.erase(it);
+            return JNI_TRUE;
+        }
+    }
+    
+    return JNI_FALSE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeDrainFiredBeatSchedules(
+    JNIEnv* env, jobject thiz) {
+    
+    std::vector<jlong> packed;
+    {
+        std::lock_guard<std::mutex> lock(beatMutex);
+        if (firedBeatSchedules.empty()) {
+            return nullptr;
+        }
+        
+        // Packed as [id, bar, beat, dspClock] per fired schedule
+        for (const FiredBeatSchedule& fired : firedBeatSchedules) {
+            packed.push_back(fired.id);
+            packed.push_back(fired.bar);
+            packed.push_back(fired.beat);
+            packed.push_back((jlong)fired.dspClock);
+        }
+        firedBeatSchedules.clear();
+    }
+    
+    jlongArray result = env->NewLongArray((jsize)packed.size());
+    env->SetLongArrayRegion(result, 0, (jsize)packed.size(), packed.data());
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeCreateEmitter(
+    JNIEnv* env, jobject thiz, jstring eventPath, jboolean start) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    const char* pathStr = env->GetStringUTFChars(eventPath, nullptr);
+    std::string path(pathStr);
+    env->ReleaseStringUTFChars(eventPath, pathStr);
+    
+    FMOD::Studio::EventDescription* eventDesc = nullptr;
+    FMOD_RESULT result = fmod_flutter::GetEvent(studioC(), path.c_str(),
+        reinterpret_cast<FMOD_STUDIO_EVENTDESCRIPTION**>(&eventDesc));
+    if (result != FMOD_OK) {
+        LOGE("Failed to get event %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    float minDistance = 0.0f;
+    float maxDistance = 0.0f;
+    bool is3D = false;
+    eventDesc->is3D(&is3D);
+    if (is3D) {
+        eventDesc->getMinMaxDistance(&minDistance, &maxDistance);
+    }
+    
+    int emitterId = nextEmitterId;
+    Emitter emitter = {eventDesc, nullptr, {}, maxDistance, start == JNI_TRUE};
+    emitter.attributes.forward.z = 1.0f;
+    emitter.attributes.up.y = 1.0f;
+    
+    if (emitterCulling && emitter.playing) {
+        // Started on the next update tick if a listener is in range
+        emitterCuller.Add(emitterId, maxDistance, false);
+    } else {
+        result = eventDesc->createInstance(&emitter.instance);
+        if (result != FMOD_OK) {
+            LOGE("Failed to create emitter instance: %d - %s", result, FMOD_ErrorString(result));
+            return 0;
+        }
+        
+        if (emitter.playing) {
+            result = emitter.instance->start();
+            if (result != FMOD_OK) {
+                LOGE("Failed to start emitter: %d - %s", result, FMOD_ErrorString(result));
+                emitter.instance->release();
+                return 0;
+            }
+        }
+    }
+    
+    nextEmitterId++;
+    emitters[emitterId] = emitter;
+    
+    LOGD("Created emitter %d for event: %s", emitterId, path.c_str());
+    return emitterId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeReleaseEmitter(
+    JNIEnv* env, jobject thiz, jint emitterId) {
+    
+    auto it = emitters.find(emitterId);
+    if (it == emitters.end()) {
+        LOGD("No emitter found with id: %d", emitterId);
+        return JNI_FALSE;
+    }
+    
+    deactivateEmitter(it->second);
+    emitterCuller.Remove(emitterId);
+    emitters.erase(it);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeUpdateSpatial(
+    JNIEnv* env, jobject thiz, jfloatArray listeners, jintArray emitterIds, jfloatArray emitterAttributes) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    jsize numListeners = env->GetArrayLength(listeners) / kSpatialFloatsPerEntity;
+    jsize numEmitters = env->GetArrayLength(emitterIds);
+    if (numListeners < 1 || numListeners > FMOD_MAX_LISTENERS ||
+        env->GetArrayLength(emitterAttributes) < numEmitters * kSpatialFloatsPerEntity) {
+        LOGE("Invalid spatial update: %d listeners, %d emitters", numListeners, numEmitters);
+        return JNI_FALSE;
+    }
+    
+    if (numListeners != listenerCount) {
+        studioSystem->setNumListeners(numListeners);
+        listenerCount = numListeners;
+    }
+    
+    FMOD_3D_ATTRIBUTES attributes;
+    
+    listenerPositions.resize(numListeners * 3);
+    jfloat* listenerData = env->GetFloatArrayElements(listeners, nullptr);
+    for (jsize i = 0; i < numListeners; i++) {
+        memcpy(&attributes, listenerData + i * kSpatialFloatsPerEntity, sizeof(attributes));
+        studioSystem->setListenerAttributes(i, &attributes);
+        listenerPositions[i * 3] = attributes.position.x;
+        listenerPositions[i * 3 + 1] = attributes.position.y;
+        listenerPositions[i * 3 + 2] = attributes.position.z;
+    }
+    env->ReleaseFloatArrayElements(listeners, listenerData, JNI_ABORT);
+    
+    std::vector<jint> ids(numEmitters);
+    env->GetIntArrayRegion(emitterIds, 0, numEmitters, ids.data());
+    
+    jfloat* emitterData = env->GetFloatArrayElements(emitterAttributes, nullptr);
+    for (jsize i = 0; i < numEmitters; i++) {
+        auto it = emitters.find(ids[i]);
+        if (it == emitters.end()) {
+            continue;
+        }
+        Emitter& emitter = it->second;
+        memcpy(&emitter.attributes, emitterData + i * kSpatialFloatsPerEntity, sizeof(emitter.attributes));
+        if (emitterCulling && emitter.playing) {
+            emitterCuller.Move(it->first, emitter.attributes.position.x,
+                               emitter.attributes.position.y, emitter.attributes.position.z);
+        }
+        if (emitter.instance != nullptr) {
+            emitter.instance->set3DAttributes(&emitter.attributes);
+        }
+    }
+    env->ReleaseFloatArrayElements(emitterAttributes, emitterData, JNI_ABORT);
+    
+    return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetEmitterCulling(
+    JNIEnv* env, jobject thiz, jboolean enabled, jfloat hysteresis) {
+    
+    emitterCuller.SetHysteresis(hysteresis);
+    bool enable = enabled == JNI_TRUE;
+    if (emitterCulling == enable) {
+        return;
+    }
+    emitterCulling = enable;
+    
+    for (auto& pair : emitters) {
+        Emitter& emitter = pair.second;
+        if (!emitter.playing) {
+            continue;
+        }
+        if (enable) {
+            emitterCuller.Add(pair.first, emitter.maxDistance, emitter.instance != nullptr);
+            emitterCuller.Move(pair.first, emitter.attributes.position.x,
+                               emitter.attributes.position.y, emitter.attributes.position.z);
+        } else {
+            // Bring back everything that was culled
+            activateEmitter(pair.first, emitter);
+        }
+    }
+    if (!enable) {
+        emitterCuller.Clear();
+    }
+    
+    LOGD("Emitter culling %s", enable ? "enabled" : "disabled");
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeAddBusEffect(
+    JNIEnv* env, jobject thiz, jstring busPath, jint type, jintArray parameterIndices, jfloatArray parameterValues) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    const char* pathStr = env->GetStringUTFChars(busPath, nullptr);
+    std::string path(pathStr);
+    env->ReleaseStringUTFChars(busPath, pathStr);
+    
+    jsize count = env->GetArrayLength(parameterIndices);
+    if (env->GetArrayLength(parameterValues) < count) {
+        LOGE("Invalid bus effect parameters for %s", path.c_str());
+        return 0;
+    }
+    std::vector<jint> indices(count);
+    std::vector<jfloat> values(count);
+    env->GetIntArrayRegion(parameterIndices, 0, count, indices.data());
+    env->GetFloatArrayRegion(parameterValues, 0, count, values.data());
+    
+    // The C and C++ handles are interchangeable
+    int effectId = busEffects.Add(reinterpret_cast<FMOD_STUDIO_SYSTEM*>(studioSystem),
+                                  path.c_str(), type, indices.data(), values.data(), count);
+    if (effectId == 0) {
+        FMOD_RESULT result = busEffects.last_result();
+        LOGE("Failed to add effect to bus %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    LOGD("Added effect %d to bus %s (%s kernels)", effectId, path.c_str(),
+         fmod_flutter::BusEffects::KernelName());
+    return effectId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeRemoveBusEffect(
+    JNIEnv* env, jobject thiz, jint effectId) {
+    
+    if (!busEffects.Remove(effectId)) {
+        LOGD("No bus effect found with id: %d", effectId);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetBusEffectParameter(
+    JNIEnv* env, jobject thiz, jint effectId, jint index, jfloat value) {
+    
+    if (!busEffects.SetParameter(effectId, index, value)) {
+        FMOD_RESULT result = busEffects.last_result();
+        LOGE("Failed to set parameter %d on bus effect %d: %d - %s", index, effectId, result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeAddSpectrumAnalyzer(
+    JNIEnv* env, jobject thiz, jstring target, jint bands, jint windowSize) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    const char* targetStr = env->GetStringUTFChars(target, nullptr);
+    std::string path(targetStr);
+    env->ReleaseStringUTFChars(target, targetStr);
+    
+    // The C and C++ handles are interchangeable
+    FMOD_STUDIO_SYSTEM* system = reinterpret_cast<FMOD_STUDIO_SYSTEM*>(studioSystem);
+    int analyzerId = 0;
+    if (path.rfind("bus:/", 0) == 0) {
+        analyzerId = spectrumAnalyzers.AddToBus(system, path.c_str(), bands, windowSize);
+    } else {
+        auto it = eventInstances.find(path);
+        if (it == eventInstances.end()) {
+            LOGE("No instance found for %s", path.c_str());
+            return 0;
+        }
+        analyzerId = spectrumAnalyzers.AddToInstance(
+            system, reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(it->second), bands, windowSize);
+    }
+    
+    if (analyzerId == 0) {
+        FMOD_RESULT result = spectrumAnalyzers.last_result();
+        LOGE("Failed to add spectrum analyzer to %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+    }
+    return analyzerId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeRemoveSpectrumAnalyzer(
+    JNIEnv* env, jobject thiz, jint analyzerId) {
+    
+    if (!spectrumAnalyzers.Remove(analyzerId)) {
+        LOGD("No spectrum analyzer found with id: %d", analyzerId);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetBusVolume(
+    JNIEnv* env, jobject thiz, jstring busPath, jfloat volume, jint rampMs) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, busPath);
+    if (!mixerControl.SetBusVolume(studioC(), path.c_str(), volume, rampMs / 1000.0f)) {
+        FMOD_RESULT result = mixerControl.last_result();
+        LOGE("Failed to set volume of %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetVcaVolume(
+    JNIEnv* env, jobject thiz, jstring vcaPath, jfloat volume, jint rampMs) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, vcaPath);
+    if (!mixerControl.SetVcaVolume(studioC(), path.c_str(), volume, rampMs / 1000.0f)) {
+        FMOD_RESULT result = mixerControl.last_result();
+        LOGE("Failed to set volume of %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetBusMute(
+    JNIEnv* env, jobject thiz, jstring busPath, jboolean muted) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, busPath);
+    if (!mixerControl.SetBusMute(studioC(), path.c_str(), muted == JNI_TRUE)) {
+        FMOD_RESULT result = mixerControl.last_result();
+        LOGE("Failed to set mute state of %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetBusPaused(
+    JNIEnv* env, jobject thiz, jstring busPath, jboolean paused) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, busPath);
+    if (!mixerControl.SetBusPaused(studioC(), path.c_str(), paused == JNI_TRUE)) {
+        FMOD_RESULT result = mixerControl.last_result();
+        LOGE("Failed to set paused state of %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStartSnapshot(
+    JNIEnv* env, jobject thiz, jstring snapshotPath) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, snapshotPath);
+    if (!mixerControl.StartSnapshot(studioC(), path.c_str())) {
+        FMOD_RESULT result = mixerControl.last_result();
+        LOGE("Failed to start snapshot %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStopSnapshot(
+    JNIEnv* env, jobject thiz, jstring snapshotPath, jboolean allowFadeOut) {
+    
+    std::string path = toStdString(env, snapshotPath);
+    if (!mixerControl.StopSnapshot(path.c_str(), allowFadeOut == JNI_TRUE)) {
+        LOGD("Snapshot not active: %s", path.c_str());
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeAutomateParameter(
+    JNIEnv* env, jobject thiz, jstring eventPath, jstring paramName, jint type, jfloatArray data) {
+    
+    std::string path = toStdString(env, eventPath);
+    std::string param = toStdString(env, paramName);
+    
+    auto it = eventInstances.find(path);
+    if (it == eventInstances.end()) {
+        LOGD("No instance found for event: %s", path.c_str());
+        return 0;
+    }
+    
+    jsize count = env->GetArrayLength(data);
+    std::vector<jfloat> values(count);
+    env->GetFloatArrayRegion(data, 0, count, values.data());
+    
+    // The curve starts from the parameter's latest value.
+    deferredWrites.Flush();
+    int automationId = parameterAutomation.Add(
+        reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(it->second), param.c_str(),
+        type, values.data(), count);
+    if (automationId == 0) {
+        FMOD_RESULT result = parameterAutomation.last_result();
+        LOGE("Failed to automate parameter %s on %s: %d - %s", param.c_str(), path.c_str(), result, FMOD_ErrorString(result));
+    }
+    return automationId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeReleaseAutomation(
+    JNIEnv* env, jobject thiz, jint automationId) {
+    
+    if (!parameterAutomation.Release(automationId)) {
+        LOGD("No envelope automation found with id: %d", automationId);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeCancelAutomation(
+    JNIEnv* env, jobject thiz, jint automationId) {
+    
+    return parameterAutomation.Cancel(automationId) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetGlobalParameter(
+    JNIEnv* env, jobject thiz, jstring name, jfloat value) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string param = toStdString(env, name);
+    if (!globalParameters.Set(studioC(), param.c_str(), value)) {
+        FMOD_RESULT result = globalParameters.last_result();
+        LOGE("Failed to set global parameter %s: %d - %s", param.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetGlobalParameter(
+    JNIEnv* env, jobject thiz, jstring name) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return NAN;
+    }
+    
+    std::string param = toStdString(env, name);
+    float value = 0.0f;
+    if (!globalParameters.Get(studioC(), param.c_str(), &value)) {
+        FMOD_RESULT result = globalParameters.last_result();
+        LOGE("Failed to get global parameter %s: %d - %s", param.c_str(), result, FMOD_ErrorString(result));
+        return NAN;
+    }
+    return value;
+}
+
+JNIEXPORT jintArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeResolveGlobalParameters(
+    JNIEnv* env, jobject thiz, jobjectArray names) {
+    
+    jsize count = env->GetArrayLength(names);
+    std::vector<jint> slots(count, -1);
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+    } else {
+        for (jsize i = 0; i < count; i++) {
+            jstring name = static_cast<jstring>(env->GetObjectArrayElement(names, i));
+            std::string param = toStdString(env, name);
+            env->DeleteLocalRef(name);
+            slots[i] = globalParameters.Resolve(studioC(), param.c_str());
+            if (slots[i] < 0) {
+                LOGE("No global parameter named %s", param.c_str());
+            }
+        }
+    }
+    
+    jintArray result = env->NewIntArray(count);
+    env->SetIntArrayRegion(result, 0, count, slots.data());
+    return result;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetGlobalParameters(
+    JNIEnv* env, jobject thiz, jintArray slots, jfloatArray values) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    jsize count = env->GetArrayLength(slots);
+    if (env->GetArrayLength(values) < count) {
+        LOGE("Invalid global parameter batch");
+        return JNI_FALSE;
+    }
+    // Called every frame; the arrays are only read, so skip the copy
+    jint* slotData = env->GetIntArrayElements(slots, nullptr);
+    jfloat* valueData = env->GetFloatArrayElements(values, nullptr);
+    bool success = globalParameters.SetBatch(studioC(), slotData, valueData, count);
+    env->ReleaseFloatArrayElements(values, valueData, JNI_ABORT);
+    env->ReleaseIntArrayElements(slots, slotData, JNI_ABORT);
+    
+    if (!success) {
+        FMOD_RESULT result = globalParameters.last_result();
+        LOGE("Failed to set global parameters: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeConfigureInstancePool(
+    JNIEnv* env, jobject thiz, jstring eventPath, jint prewarmCount, jint capacity) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, eventPath);
+    if (!instancePool.Configure(studioC(), path.c_str(), prewarmCount, capacity)) {
+        FMOD_RESULT result = instancePool.last_result();
+        LOGE("Failed to configure instance pool for %s: %d - %s", path.c_str(), result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetInstancePoolStats(
+    JNIEnv* env, jobject thiz, jstring eventPath) {
+    
+    std::string path = eventPath != nullptr ? toStdString(env, eventPath) : std::string();
+    FmodInstancePoolStats stats;
+    if (!instancePool.GetStats(path.empty() ? nullptr : path.c_str(), &stats)) {
+        return nullptr;
+    }
+    
+    // Packed as [idleCount, capacity, hits, misses]
+    jlong packed[4] = { stats.idle_count, stats.capacity, stats.hits, stats.misses };
+    jlongArray result = env->NewLongArray(4);
+    env->SetLongArrayRegion(result, 0, 4, packed);
+    return result;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeQueryInstanceStates(
+    JNIEnv* env, jobject thiz) {
+    
+    // FmodInstanceState records as raw bytes, in the order of
+    // nativeQueryInstanceKeys
+    jsize size = static_cast<jsize>(instanceStates.count() * sizeof(FmodInstanceState));
+    jbyteArray result = env->NewByteArray(size);
+    env->SetByteArrayRegion(result, 0, size,
+        reinterpret_cast<const jbyte*>(instanceStates.states()));
+    return result;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeQueryInstanceKeys(
+    JNIEnv* env, jobject thiz) {
+    
+    jobjectArray result = env->NewObjectArray(
+        instanceStates.count(), env->FindClass("java/lang/String"), nullptr);
+    for (int i = 0; i < instanceStates.count(); i++) {
+        jstring key = env->NewStringUTF(instanceStates.key(i).c_str());
+        env->SetObjectArrayElement(result, i, key);
+        env->DeleteLocalRef(key);
+    }
+    return result;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeDrainFinishedEvents(
+    JNIEnv* env, jobject thiz) {
+    
+    if (finishedEvents.empty()) {
+        return nullptr;
+    }
+    
+    jobjectArray result = env->NewObjectArray(
+        static_cast<jsize>(finishedEvents.size()), env->FindClass("java/lang/String"), nullptr);
+    for (size_t i = 0; i < finishedEvents.size(); i++) {
+        jstring path = env->NewStringUTF(finishedEvents[i].c_str());
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), path);
+        env->DeleteLocalRef(path);
+    }
+    finishedEvents.clear();
+    return result;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeEventIdKey(
+    JNIEnv* env, jobject thiz, jbyteArray eventId) {
+    
+    // The caller checks for 16 bytes, the size of an FMOD_GUID.
+    uint8_t id[16];
+    env->GetByteArrayRegion(eventId, 0, 16, reinterpret_cast<jbyte*>(id));
+    return env->NewStringUTF(fmod_flutter::EventIdKey(id).c_str());
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSuspendMixer(
+    JNIEnv* env, jobject thiz) {
+    
+    if (coreSystem == nullptr) {
+        return JNI_FALSE;
+    }
+    
+    if (!mixerLifecycle.Suspend(coreC(), FMOD_FLUTTER_SUSPEND_LIFECYCLE)) {
+        FMOD_RESULT result = mixerLifecycle.last_result();
+        LOGE("Failed to suspend mixer: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    LOGD("Mixer suspended");
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeResumeMixer(
+    JNIEnv* env, jobject thiz) {
+    
+    if (coreSystem == nullptr) {
+        return JNI_FALSE;
+    }
+    
+    bool wasSuspended = mixerLifecycle.suspended();
+    if (!mixerLifecycle.Resume(coreC(), studioC(), FMOD_FLUTTER_SUSPEND_LIFECYCLE)) {
+        FMOD_RESULT result = mixerLifecycle.last_result();
+        LOGE("Failed to resume mixer: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    if (wasSuspended && !mixerLifecycle.suspended()) {
+        LOGD("Mixer resumed in %.2f ms", mixerLifecycle.last_resume_ms());
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jdouble JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetMixerResumeLatency(
+    JNIEnv* env, jobject thiz) {
+    
+    return mixerLifecycle.last_resume_ms();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeIsMixerSuspended(
+    JNIEnv* env, jobject thiz) {
+    
+    return mixerLifecycle.suspended() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeSetInterruptionPolicy(
+    JNIEnv* env, jobject thiz, jint transientResponse, jint canDuckResponse, jint lossResponse,
+    jfloat duckVolume, jfloat rampSeconds) {
+    
+    audioInterruption.SetPolicy(transientResponse, canDuckResponse, lossResponse, duckVolume, rampSeconds);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeBeginInterruption(
+    JNIEnv* env, jobject thiz, jint kind) {
+    
+    if (coreSystem == nullptr) {
+        return FMOD_FLUTTER_RESPONSE_NONE;
+    }
+    
+    int response = audioInterruption.Begin(coreC(), kind);
+    if (audioInterruption.last_result() != FMOD_OK) {
+        FMOD_RESULT result = audioInterruption.last_result();
+        LOGE("Failed to apply audio interruption: %d - %s", result, FMOD_ErrorString(result));
+    }
+    if (response == FMOD_FLUTTER_RESPONSE_SUSPEND &&
+        !mixerLifecycle.Suspend(coreC(), FMOD_FLUTTER_SUSPEND_INTERRUPTION)) {
+        FMOD_RESULT result = mixerLifecycle.last_result();
+        LOGE("Failed to suspend mixer: %d - %s", result, FMOD_ErrorString(result));
+    }
+    LOGD("Audio interruption %d began, response %d", kind, response);
+    return response;
+}
+
+// Returns how long recovery took in milliseconds, or -1 if there was no
+// interruption
+JNIEXPORT jdouble JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeEndInterruption(
+    JNIEnv* env, jobject thiz) {
+    
+    if (coreSystem == nullptr || !audioInterruption.active()) {
+        return -1.0;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    if (audioInterruption.response() == FMOD_FLUTTER_RESPONSE_SUSPEND &&
+        !mixerLifecycle.Resume(coreC(), studioC(), FMOD_FLUTTER_SUSPEND_INTERRUPTION)) {
+        FMOD_RESULT result = mixerLifecycle.last_result();
+        LOGE("Failed to resume mixer: %d - %s", result, FMOD_ErrorString(result));
+    }
+    audioInterruption.End(coreC());
+    double recoveryMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    LOGD("Audio interruption ended, recovered in %.2f ms", recoveryMs);
+    return recoveryMs;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStartCommandCapture(
+    JNIEnv* env, jobject thiz, jstring fileName, jboolean flushEachCommand) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, fileName);
+    FMOD_RESULT result = FMOD_Studio_System_StartCommandCapture(
+        studioC(), path.c_str(),
+        flushEachCommand ? FMOD_STUDIO_COMMANDCAPTURE_FILEFLUSH : FMOD_STUDIO_COMMANDCAPTURE_NORMAL);
+    if (result != FMOD_OK) {
+        LOGE("Failed to start command capture: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    LOGD("Capturing commands to %s", path.c_str());
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStopCommandCapture(
+    JNIEnv* env, jobject thiz) {
+    
+    if (studioSystem == nullptr) {
+        return JNI_FALSE;
+    }
+    
+    FMOD_RESULT result = FMOD_Studio_System_StopCommandCapture(studioC());
+    if (result != FMOD_OK) {
+        LOGE("Failed to stop command capture: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    LOGD("Command capture stopped");
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeIsNonRealtime(
+    JNIEnv* env, jobject thiz) {
+    
+    return offlineOutput.non_realtime() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jdoubleArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeRenderOffline(
+    JNIEnv* env, jobject thiz, jfloat seconds) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return nullptr;
+    }
+    
+    deferredWrites.Flush();
+    if (!offlineOutput.Render(studioC(), coreC(), seconds, onRenderBlock, nullptr)) {
+        FMOD_RESULT result = offlineOutput.last_result();
+        LOGE("Failed to render %.2f s: %d - %s", seconds, result, FMOD_ErrorString(result));
+        return nullptr;
+    }
+    
+    jdouble packed[2] = {
+        offlineOutput.last_rendered_seconds(),
+        offlineOutput.last_render_ms()
+    };
+    jdoubleArray result = env->NewDoubleArray(2);
+    env->SetDoubleArrayRegion(result, 0, 2, packed);
+    return result;
+}
+
+JNIEXPORT jfloatArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeTakeRenderedAudio(
+    JNIEnv* env, jobject thiz, jintArray format) {
+    
+    if (offlineOutput.mode() != FMOD_FLUTTER_OUTPUT_MEMORY_NRT) {
+        return nullptr;
+    }
+    
+    // Sample rate and channel count go back through format
+    jint packedFormat[2] = {offlineOutput.sample_rate(), offlineOutput.channels()};
+    env->SetIntArrayRegion(format, 0, 2, packedFormat);
+    
+    const std::vector<float>& captured = offlineOutput.captured();
+    jfloatArray samples = env->NewFloatArray(static_cast<jsize>(captured.size()));
+    env->SetFloatArrayRegion(samples, 0, static_cast<jsize>(captured.size()), captured.data());
+    offlineOutput.ClearCaptured();
+    return samples;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeLoadSound(
+    JNIEnv* env, jobject thiz, jbyteArray soundData, jboolean stream) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    // FMOD copies the data, so the array can be released straight away
+    jsize dataSize = env->GetArrayLength(soundData);
+    jbyte* data = env->GetByteArrayElements(soundData, nullptr);
+    int soundId = soundLibrary.LoadFromMemory(studioC(), data, dataSize, stream == JNI_TRUE);
+    env->ReleaseByteArrayElements(soundData, data, JNI_ABORT);
+    
+    if (soundId == 0) {
+        FMOD_RESULT result = soundLibrary.last_result();
+        LOGE("Failed to load sound: %d - %s", result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    LOGD("Loaded sound %d (%d bytes, %s .fca kernels)", soundId, dataSize,
+         fmod_flutter::SoundLibrary::KernelName());
+    return soundId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativePlaySound(
+    JNIEnv* env, jobject thiz, jint soundId, jfloat volume) {
+    
+    if (!soundLibrary.Play(soundId, volume)) {
+        FMOD_RESULT result = soundLibrary.last_result();
+        LOGE("Failed to play sound %d: %d - %s", soundId, result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeUnloadSound(
+    JNIEnv* env, jobject thiz, jint soundId) {
+    
+    if (!soundLibrary.Unload(soundId)) {
+        LOGE("No sound found with id %d", soundId);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeCreatePcmSound(
+    JNIEnv* env, jobject thiz, jint bufferId, jint sampleRate, jint channels, jint format) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    fmod_flutter::PcmFormat pcmFormat = {sampleRate, channels, format};
+    int soundId = soundLibrary.LoadPcm(studioC(), bufferId, pcmFormat);
+    if (soundId == 0) {
+        FMOD_RESULT result = soundLibrary.last_result();
+        LOGE("Failed to create sound from PCM buffer %d: %d - %s", bufferId, result, FMOD_ErrorString(result));
+        return 0;
+    }
+    return soundId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativePlayEventWithPcm(
+    JNIEnv* env, jobject thiz, jstring eventPath, jint bufferId, jint sampleRate,
+    jint channels, jint format) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    std::string path = toStdString(env, eventPath);
+    fmod_flutter::PcmFormat pcmFormat = {sampleRate, channels, format};
+    FMOD_RESULT result = fmod_flutter::StartProgrammerSoundEvent(
+        studioC(), path.c_str(), bufferId, pcmFormat);
+    if (result != FMOD_OK) {
+        LOGE("Failed to play %s with PCM buffer %d: %d - %s", path.c_str(), bufferId, result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeCreatePcmStream(
+    JNIEnv* env, jobject thiz, jint sampleRate, jint channels, jint capacityMs) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return 0;
+    }
+    
+    int streamId = pcmStreams.Create(studioC(), sampleRate, channels, capacityMs);
+    if (streamId == 0) {
+        FMOD_RESULT result = pcmStreams.last_result();
+        LOGE("Failed to create PCM stream: %d - %s", result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    LOGD("Created PCM stream %d (%d Hz, %d channels)", streamId, sampleRate, channels);
+    return streamId;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeReleasePcmStream(
+    JNIEnv* env, jobject thiz, jint streamId) {
+    
+    if (!pcmStreams.Destroy(streamId)) {
+        LOGE("No PCM stream found with id %d", streamId);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetPcmStreamStats(
+    JNIEnv* env, jobject thiz, jint streamId) {
+    
+    FmodPcmStreamStats stats;
+    if (!pcmStreams.GetStats(streamId, &stats)) {
+        return nullptr;
+    }
+    
+    // Packed as [sampleRate, channels, capacityFrames, queuedFrames,
+    // underruns, underrunFrames, droppedFrames, latencyUs]
+    jlong packed[8] = {
+        stats.sample_rate, stats.channels, stats.capacity_frames, stats.queued_frames,
+        stats.underruns, stats.underrun_frames, stats.dropped_frames, stats.latency_us
+    };
+    jlongArray result = env->NewLongArray(8);
+    env->SetLongArrayRegion(result, 0, 8, packed);
+    return result;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStartRecording(
+    JNIEnv* env, jobject thiz, jint driver, jboolean monitor, jint latencyMs) {
+    
+    if (coreSystem == nullptr) {
+        LOGE("FMOD Core System not initialized");
+        return JNI_FALSE;
+    }
+    
+    if (!micCapture.Start(coreC(), driver, monitor == JNI_TRUE, latencyMs)) {
+        FMOD_RESULT result = micCapture.last_result();
+        LOGE("Failed to start recording from driver %d: %d - %s", driver, result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    
+    LOGD("Recording from driver %d%s", driver, monitor ? " with monitoring" : "");
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStopRecording(
+    JNIEnv* env, jobject thiz) {
+    
+    return micCapture.Stop() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetRecordingStats(
+    JNIEnv* env, jobject thiz) {
+    
+    FmodMicStats stats;
+    if (!micCapture.GetStats(&stats)) {
+        return nullptr;
+    }
+    
+    // Packed as [recording, monitoring, sampleRate, channels, recordedFrames,
+    // droppedSamples, monitorLatencyUs, targetLatencyUs]
+    jlong packed[8] = {
+        stats.recording, stats.monitoring, stats.sample_rate, stats.channels,
+        stats.recorded_frames, stats.dropped_samples, stats.monitor_latency_us,
+        stats.target_latency_us
+    };
+    jlongArray result = env->NewLongArray(8);
+    env->SetLongArrayRegion(result, 0, 8, packed);
+    return result;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStartVoiceStats(
+    JNIEnv* env, jobject thiz, jint windowMs) {
+    
+    if (studioSystem == nullptr) {
+        LOGE("FMOD Studio System not initialized");
+        return JNI_FALSE;
+    }
+    
+    if (!voiceStats.Start(studioC(), windowMs)) {
+        FMOD_RESULT result = voiceStats.last_result();
+        LOGE("Failed to start voice stats: %d - %s", result, FMOD_ErrorString(result));
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeStopVoiceStats(
+    JNIEnv* env, jobject thiz) {
+    
+    voiceStats.Stop();
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetVoiceStatsWindows(
+    JNIEnv* env, jobject thiz) {
+    
+    FmodVoiceStatsWindow windows[FMOD_FLUTTER_VOICE_STATS_WINDOWS];
+    int count = voiceStats.GetWindows(windows, FMOD_FLUTTER_VOICE_STATS_WINDOWS);
+    
+    // Packed as [endUs, durationUs, samples, maxChannels, softwareChannels,
+    // realPeak, virtualPeak, saturatedSamples, realSum, virtualSum, starts,
+    // startFailures, virtualizations] per window
+    std::vector<jlong> packed;
+    packed.reserve(count * 13);
+    for (int i = 0; i < count; i++) {
+        const FmodVoiceStatsWindow& w = windows[i];
+        jlong fields[13] = {
+            w.end_us, w.duration_us, w.samples, w.max_channels, w.software_channels,
+            w.real_peak, w.virtual_peak, w.saturated_samples, w.real_sum, w.virtual_sum,
+            w.starts, w.start_failures, w.virtualizations
+        };
+        packed.insert(packed.end(), fields, fields + 13);
+    }
+    jlongArray result = env->NewLongArray(static_cast<jsize>(packed.size()));
+    env->SetLongArrayRegion(result, 0, static_cast<jsize>(packed.size()), packed.data());
+    return result;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetEventVoicePaths(
+    JNIEnv* env, jobject thiz) {
+    
+    const std::vector<fmod_flutter::VoiceStats::EventStats>& events = voiceStats.last_events();
+    jobjectArray result = env->NewObjectArray(
+        static_cast<jsize>(events.size()), env->FindClass("java/lang/String"), nullptr);
+    for (size_t i = 0; i < events.size(); i++) {
+        jstring path = env->NewStringUTF(events[i].path.c_str());
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), path);
+        env->DeleteLocalRef(path);
+    }
+    return result;
+}
+
+JNIEXPORT jintArray JNICALL
+Java_com_midnightlaunchgames_fmod_1flutter_FmodManager_nativeGetEventVoiceStats(
+    JNIEnv* env, jobject thiz) {
+    
+    const std::vector<fmod_flutter::VoiceStats::EventStats>& events = voiceStats.last_events();
+    
+    // Packed as [instances, peakInstances, starts, startFailures,
+    // virtualizations] per event, in the order of nativeGetEventVoicePaths
+    std::vector<jint> packed;
+    packed.reserve(events.size() * 5);
+    for (size_t i = 0; i < events.size(); i++) {
+        const FmodEventVoiceStats& e = events[i].stats;
+        jint fields[5] = {
+            e.instances, e.peak_instances, e.starts, e.start_failures, e.virtualizations
+        };
+        packed.insert(packed.end(), fields, fields + 5);
+    }
+    jintArray result = env->NewIntArray(static_cast<jsize>(packed.size()));
+    env->SetIntArrayRegion(result, 0, static_cast<jsize>(packed.size()), packed.data());
+    return result;
+}
+
 } // extern "C"
 
@@ -1,30 +1,68 @@
 package com.midnightlaunchgames.fmod_flutter
 
+import android.app.Activity
+import android.app.Application
 import android.content.Context
+import android.os.Bundle
 import androidx.annotation.NonNull
 import io.flutter.embedding.engine.plugins.FlutterPlugin
+import io.flutter.embedding.engine.plugins.activity.ActivityAware
+import io.flutter.embedding.engine.plugins.activity.ActivityPluginBinding
 import io.flutter.plugin.common.MethodCall
 import io.flutter.plugin.common.MethodChannel
 import io.flutter.plugin.common.MethodChannel.MethodCallHandler
 import io.flutter.plugin.common.MethodChannel.Result
 
 /** FmodFlutterPlugin */
-class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
+class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler, ActivityAware {
   private lateinit var channel: MethodChannel
   private lateinit var context: Context
   private lateinit var fmodManager: FmodManager
+  private var activity: Activity? = null
+
+  // Suspends the FMOD mixer while the Flutter activity is paused, so the
+  // mixer thread stops using CPU in the background.
+  private val lifecycleCallbacks = object : Application.ActivityLifecycleCallbacks {
+    override fun onActivityPaused(paused: Activity) {
+      if (paused === activity) {
+        fmodManager.suspendMixer()
+      }
+    }
+
+    override fun onActivityResumed(resumed: Activity) {
+      if (resumed === activity) {
+        fmodManager.resumeMixer()
+      }
+    }
+
+    override fun onActivityCreated(created: Activity, savedInstanceState: Bundle?) {}
+    override fun onActivityStarted(started: Activity) {}
+    override fun onActivityStopped(stopped: Activity) {}
+    override fun onActivitySaveInstanceState(saved: Activity, outState: Bundle) {}
+    override fun onActivityDestroyed(destroyed: Activity) {}
+  }
 
   override fun onAttachedToEngine(@NonNull flutterPluginBinding: FlutterPlugin.FlutterPluginBinding) {
     context = flutterPluginBinding.applicationContext
     channel = MethodChannel(flutterPluginBinding.binaryMessenger, "fmod_flutter")
     channel.setMethodCallHandler(this)
     fmodManager = FmodManager(context)
+    fmodManager.onBeatScheduleFired = { args ->
+      channel.invokeMethod("onBeatScheduleFired", args)
+    }
+    fmodManager.onEventsFinished = { paths ->
+      channel.invokeMethod("onEventsFinished", paths)
+    }
+    fmodManager.onAudioInterruption = { args ->
+      channel.invokeMethod("onAudioInterruption", args)
+    }
   }
 
   override fun onMethodCall(@NonNull call: MethodCall, @NonNull result: Result) {
     when (call.method) {
       "initialize" -> {
-        result.success(fmodManager.initialize())
+        val output = call.argument<Int>("output") ?: 0
+        result.success(fmodManager.initialize(output, call.argument<String>("wavPath")))
       }
       "loadBanks" -> {
         val banks = call.argument<List<String>>("banks")
@@ -35,7 +73,7 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
         }
       }
       "playEvent" -> {
-        val path = call.argument<String>("path")
+        val path = eventKey(call)
         if (path != null) {
           fmodManager.playEvent(path)
           result.success(null)
@@ -43,8 +81,21 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
           result.error("INVALID_ARGS", "Event path required", null)
         }
       }
+      "playEventAt" -> {
+        val path = eventKey(call)
+        val offset = call.argument<Number>("offset")
+        val from = call.argument<Number>("fromDspClock")
+        if (path != null && offset != null) {
+          result.success(fmodManager.playEventAt(path, offset.toLong(), from?.toLong() ?: 0L))
+        } else {
+          result.error("INVALID_ARGS", "Path and offset required", null)
+        }
+      }
+      "getDspClock" -> {
+        result.success(fmodManager.getDspClock())
+      }
       "stopEvent" -> {
-        val path = call.argument<String>("path")
+        val path = eventKey(call)
         if (path != null) {
           fmodManager.stopEvent(path)
           result.success(null)
@@ -53,7 +104,7 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
         }
       }
       "setParameter" -> {
-        val path = call.argument<String>("path")
+        val path = eventKey(call)
         val param = call.argument<String>("parameter")
         val value = call.argument<Double>("value")
         if (path != null && param != null && value != null) {
@@ -64,7 +115,7 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
         }
       }
       "setPaused" -> {
-        val path = call.argument<String>("path")
+        val path = eventKey(call)
         val paused = call.argument<Boolean>("paused")
         if (path != null && paused != null) {
           fmodManager.setPaused(path, paused)
@@ -82,7 +133,7 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
         }
       }
       "setVolume" -> {
-        val path = call.argument<String>("path")
+        val path = eventKey(call)
         val volume = call.argument<Double>("volume")
         if (path != null && volume != null) {
           fmodManager.setVolume(path, volume.toFloat())
@@ -91,6 +142,402 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
           result.error("INVALID_ARGS", "Path and volume required", null)
         }
       }
+      "setPitch" -> {
+        val path = eventKey(call)
+        val pitch = call.argument<Double>("pitch")
+        if (path != null && pitch != null) {
+          fmodManager.setPitch(path, pitch.toFloat())
+          result.success(null)
+        } else {
+          result.error("INVALID_ARGS", "Path and pitch required", null)
+        }
+      }
+      "scheduleAtBeat" -> {
+        val path = eventKey(call)
+        val bar = call.argument<Int>("bar")
+        val beat = call.argument<Int>("beat")
+        val startEvent = eventKey(call, "startEvent")
+        if (path != null && bar != null && beat != null) {
+          result.success(fmodManager.scheduleAtBeat(path, bar, beat, startEvent))
+        } else {
+          result.error("INVALID_ARGS", "Path, bar, and beat required", null)
+        }
+      }
+      "cancelBeatSchedule" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.cancelBeatSchedule(id))
+        } else {
+          result.error("INVALID_ARGS", "Schedule id required", null)
+        }
+      }
+      "createEmitter" -> {
+        val path = eventKey(call)
+        val start = call.argument<Boolean>("start") ?: true
+        if (path != null) {
+          result.success(fmodManager.createEmitter(path, start))
+        } else {
+          result.error("INVALID_ARGS", "Event path required", null)
+        }
+      }
+      "releaseEmitter" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.releaseEmitter(id))
+        } else {
+          result.error("INVALID_ARGS", "Emitter id required", null)
+        }
+      }
+      "updateSpatial" -> {
+        val listeners = call.argument<FloatArray>("listeners")
+        val emitterIds = call.argument<IntArray>("emitterIds")
+        val emitters = call.argument<FloatArray>("emitters")
+        if (listeners != null && emitterIds != null && emitters != null) {
+          result.success(fmodManager.updateSpatial(listeners, emitterIds, emitters))
+        } else {
+          result.error("INVALID_ARGS", "Listeners, emitter ids, and emitters required", null)
+        }
+      }
+      "setEmitterCulling" -> {
+        val enabled = call.argument<Boolean>("enabled")
+        val hysteresis = call.argument<Double>("hysteresis")
+        if (enabled != null && hysteresis != null) {
+          fmodManager.setEmitterCulling(enabled, hysteresis.toFloat())
+          result.success(null)
+        } else {
+          result.error("INVALID_ARGS", "Enabled and hysteresis required", null)
+        }
+      }
+      "addBusEffect" -> {
+        val busPath = call.argument<String>("busPath")
+        val type = call.argument<Int>("type")
+        val parameterIndices = call.argument<IntArray>("parameterIndices")
+        val parameterValues = call.argument<FloatArray>("parameterValues")
+        if (busPath != null && type != null && parameterIndices != null && parameterValues != null) {
+          result.success(fmodManager.addBusEffect(busPath, type, parameterIndices, parameterValues))
+        } else {
+          result.error("INVALID_ARGS", "Bus path, type, and parameters required", null)
+        }
+      }
+      "removeBusEffect" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.removeBusEffect(id))
+        } else {
+          result.error("INVALID_ARGS", "Effect id required", null)
+        }
+      }
+      "setBusEffectParameter" -> {
+        val id = call.argument<Int>("id")
+        val index = call.argument<Int>("index")
+        val value = call.argument<Double>("value")
+        if (id != null && index != null && value != null) {
+          result.success(fmodManager.setBusEffectParameter(id, index, value.toFloat()))
+        } else {
+          result.error("INVALID_ARGS", "Effect id, index, and value required", null)
+        }
+      }
+      "addSpectrumAnalyzer" -> {
+        val target = call.argument<String>("target")
+        val bands = call.argument<Int>("bands")
+        val windowSize = call.argument<Int>("windowSize")
+        if (target != null && bands != null && windowSize != null) {
+          result.success(fmodManager.addSpectrumAnalyzer(target, bands, windowSize))
+        } else {
+          result.error("INVALID_ARGS", "Target, bands, and window size required", null)
+        }
+      }
+      "removeSpectrumAnalyzer" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.removeSpectrumAnalyzer(id))
+        } else {
+          result.error("INVALID_ARGS", "Analyzer id required", null)
+        }
+      }
+      "setBusVolume" -> {
+        val path = call.argument<String>("path")
+        val volume = call.argument<Double>("volume")
+        val rampMs = call.argument<Int>("rampMs")
+        if (path != null && volume != null && rampMs != null) {
+          result.success(fmodManager.setBusVolume(path, volume.toFloat(), rampMs))
+        } else {
+          result.error("INVALID_ARGS", "Path, volume, and ramp required", null)
+        }
+      }
+      "setVcaVolume" -> {
+        val path = call.argument<String>("path")
+        val volume = call.argument<Double>("volume")
+        val rampMs = call.argument<Int>("rampMs")
+        if (path != null && volume != null && rampMs != null) {
+          result.success(fmodManager.setVcaVolume(path, volume.toFloat(), rampMs))
+        } else {
+          result.error("INVALID_ARGS", "Path, volume, and ramp required", null)
+        }
+      }
+      "setBusMute" -> {
+        val path = call.argument<String>("path")
+        val muted = call.argument<Boolean>("muted")
+        if (path != null && muted != null) {
+          result.success(fmodManager.setBusMute(path, muted))
+        } else {
+          result.error("INVALID_ARGS", "Path and muted state required", null)
+        }
+      }
+      "setBusPaused" -> {
+        val path = call.argument<String>("path")
+        val paused = call.argument<Boolean>("paused")
+        if (path != null && paused != null) {
+          result.success(fmodManager.setBusPaused(path, paused))
+        } else {
+          result.error("INVALID_ARGS", "Path and paused state required", null)
+        }
+      }
+      "startSnapshot" -> {
+        val path = call.argument<String>("path")
+        if (path != null) {
+          result.success(fmodManager.startSnapshot(path))
+        } else {
+          result.error("INVALID_ARGS", "Snapshot path required", null)
+        }
+      }
+      "stopSnapshot" -> {
+        val path = call.argument<String>("path")
+        val allowFadeOut = call.argument<Boolean>("allowFadeOut")
+        if (path != null && allowFadeOut != null) {
+          result.success(fmodManager.stopSnapshot(path, allowFadeOut))
+        } else {
+          result.error("INVALID_ARGS", "Snapshot path and fade out flag required", null)
+        }
+      }
+      "suspendMixer" -> {
+        result.success(fmodManager.suspendMixer())
+      }
+      "resumeMixer" -> {
+        result.success(fmodManager.resumeMixer())
+      }
+      "getMixerResumeLatency" -> {
+        result.success(fmodManager.getMixerResumeLatency())
+      }
+      "setInterruptionPolicy" -> {
+        val transient = call.argument<Int>("transient")
+        val canDuck = call.argument<Int>("canDuck")
+        val loss = call.argument<Int>("loss")
+        val duckVolume = call.argument<Double>("duckVolume")
+        val rampMs = call.argument<Int>("rampMs")
+        if (transient != null && canDuck != null && loss != null && duckVolume != null && rampMs != null) {
+          fmodManager.setInterruptionPolicy(transient, canDuck, loss, duckVolume.toFloat(), rampMs / 1000f)
+          result.success(true)
+        } else {
+          result.error("INVALID_ARGS", "Interruption responses, duck volume, and ramp required", null)
+        }
+      }
+      "renderOffline" -> {
+        val seconds = call.argument<Double>("seconds")
+        if (seconds != null) {
+          result.success(fmodManager.renderOffline(seconds))
+        } else {
+          result.error("INVALID_ARGS", "Render duration required", null)
+        }
+      }
+      "getRenderedAudio" -> {
+        result.success(fmodManager.getRenderedAudio())
+      }
+      "loadSound" -> {
+        val path = call.argument<String>("path")
+        val stream = call.argument<Boolean>("stream")
+        if (path != null && stream != null) {
+          result.success(fmodManager.loadSound(path, stream))
+        } else {
+          result.error("INVALID_ARGS", "Sound path and stream flag required", null)
+        }
+      }
+      "playSound" -> {
+        val id = call.argument<Int>("id")
+        val volume = call.argument<Double>("volume")
+        if (id != null && volume != null) {
+          result.success(fmodManager.playSound(id, volume.toFloat()))
+        } else {
+          result.error("INVALID_ARGS", "Sound id and volume required", null)
+        }
+      }
+      "unloadSound" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.unloadSound(id))
+        } else {
+          result.error("INVALID_ARGS", "Sound id required", null)
+        }
+      }
+      "createPcmSound" -> {
+        val bufferId = call.argument<Int>("bufferId")
+        val sampleRate = call.argument<Int>("sampleRate")
+        val channels = call.argument<Int>("channels")
+        val format = call.argument<Int>("format")
+        if (bufferId != null && sampleRate != null && channels != null && format != null) {
+          result.success(fmodManager.createPcmSound(bufferId, sampleRate, channels, format))
+        } else {
+          result.error("INVALID_ARGS", "PCM buffer id and format required", null)
+        }
+      }
+      "playEventWithPcm" -> {
+        val path = call.argument<String>("path")
+        val bufferId = call.argument<Int>("bufferId")
+        val sampleRate = call.argument<Int>("sampleRate")
+        val channels = call.argument<Int>("channels")
+        val format = call.argument<Int>("format")
+        if (path != null && bufferId != null && sampleRate != null && channels != null && format != null) {
+          result.success(fmodManager.playEventWithPcm(path, bufferId, sampleRate, channels, format))
+        } else {
+          result.error("INVALID_ARGS", "Event path, PCM buffer id and format required", null)
+        }
+      }
+      "createPcmStream" -> {
+        val sampleRate = call.argument<Int>("sampleRate")
+        val channels = call.argument<Int>("channels")
+        val capacityMs = call.argument<Int>("capacityMs")
+        if (sampleRate != null && channels != null && capacityMs != null) {
+          result.success(fmodManager.createPcmStream(sampleRate, channels, capacityMs))
+        } else {
+          result.error("INVALID_ARGS", "Sample rate, channels and capacity required", null)
+        }
+      }
+      "releasePcmStream" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.releasePcmStream(id))
+        } else {
+          result.error("INVALID_ARGS", "Stream id required", null)
+        }
+      }
+      "getPcmStreamStats" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.getPcmStreamStats(id))
+        } else {
+          result.error("INVALID_ARGS", "Stream id required", null)
+        }
+      }
+      "startRecording" -> {
+        val driver = call.argument<Int>("driver")
+        val monitor = call.argument<Boolean>("monitor")
+        val latencyMs = call.argument<Int>("latencyMs")
+        if (driver != null && monitor != null && latencyMs != null) {
+          result.success(fmodManager.startRecording(driver, monitor, latencyMs))
+        } else {
+          result.error("INVALID_ARGS", "Driver, monitor and latency required", null)
+        }
+      }
+      "stopRecording" -> {
+        result.success(fmodManager.stopRecording())
+      }
+      "getRecordingStats" -> {
+        result.success(fmodManager.getRecordingStats())
+      }
+      "startVoiceStats" -> {
+        val windowMs = call.argument<Int>("windowMs")
+        if (windowMs != null) {
+          result.success(fmodManager.startVoiceStats(windowMs))
+        } else {
+          result.error("INVALID_ARGS", "Window length required", null)
+        }
+      }
+      "stopVoiceStats" -> {
+        fmodManager.stopVoiceStats()
+        result.success(null)
+      }
+      "getVoiceStats" -> {
+        result.success(fmodManager.getVoiceStats())
+      }
+      "queryInstances" -> {
+        result.success(fmodManager.queryInstances())
+      }
+      "startCommandCapture" -> {
+        val path = call.argument<String>("path")
+        val flushEachCommand = call.argument<Boolean>("flushEachCommand")
+        if (path != null && flushEachCommand != null) {
+          result.success(fmodManager.startCommandCapture(path, flushEachCommand))
+        } else {
+          result.error("INVALID_ARGS", "Capture path and flush flag required", null)
+        }
+      }
+      "stopCommandCapture" -> {
+        result.success(fmodManager.stopCommandCapture())
+      }
+      "configureInstancePool" -> {
+        val path = call.argument<String>("path")
+        val prewarm = call.argument<Int>("prewarm")
+        val capacity = call.argument<Int>("capacity")
+        if (path != null && prewarm != null && capacity != null) {
+          result.success(fmodManager.configureInstancePool(path, prewarm, capacity))
+        } else {
+          result.error("INVALID_ARGS", "Path, prewarm count, and capacity required", null)
+        }
+      }
+      "getInstancePoolStats" -> {
+        result.success(fmodManager.getInstancePoolStats(call.argument<String>("path")))
+      }
+      "setGlobalParameter" -> {
+        val name = call.argument<String>("name")
+        val value = call.argument<Double>("value")
+        if (name != null && value != null) {
+          result.success(fmodManager.setGlobalParameter(name, value.toFloat()))
+        } else {
+          result.error("INVALID_ARGS", "Name and value required", null)
+        }
+      }
+      "getGlobalParameter" -> {
+        val name = call.argument<String>("name")
+        if (name != null) {
+          result.success(fmodManager.getGlobalParameter(name)?.toDouble())
+        } else {
+          result.error("INVALID_ARGS", "Name required", null)
+        }
+      }
+      "resolveGlobalParameters" -> {
+        val names = call.argument<List<String>>("names")
+        if (names != null) {
+          result.success(fmodManager.resolveGlobalParameters(names))
+        } else {
+          result.error("INVALID_ARGS", "Parameter names required", null)
+        }
+      }
+      "setGlobalParameters" -> {
+        val slots = call.argument<IntArray>("slots")
+        val values = call.argument<FloatArray>("values")
+        if (slots != null && values != null && values.size >= slots.size) {
+          result.success(fmodManager.setGlobalParameters(slots, values))
+        } else {
+          result.error("INVALID_ARGS", "Slots and values required", null)
+        }
+      }
+      "automateParameter" -> {
+        val path = call.argument<String>("path")
+        val parameter = call.argument<String>("parameter")
+        val type = call.argument<Int>("type")
+        val data = call.argument<FloatArray>("data")
+        if (path != null && parameter != null && type != null && data != null) {
+          result.success(fmodManager.automateParameter(path, parameter, type, data))
+        } else {
+          result.error("INVALID_ARGS", "Path, parameter, type, and curve data required", null)
+        }
+      }
+      "releaseAutomation" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.releaseAutomation(id))
+        } else {
+          result.error("INVALID_ARGS", "Automation id required", null)
+        }
+      }
+      "cancelAutomation" -> {
+        val id = call.argument<Int>("id")
+        if (id != null) {
+          result.success(fmodManager.cancelAutomation(id))
+        } else {
+          result.error("INVALID_ARGS", "Automation id required", null)
+        }
+      }
       "update" -> {
         fmodManager.update()
         result.success(null)
@@ -103,9 +550,37 @@ class FmodFlutterPlugin: FlutterPlugin, MethodCallHandler {
     }
   }
 
+  // The event an event method targets in argument [name]: a path, or an
+  // event ID sent as the 16 bytes of an FMOD_GUID, which becomes its ID key.
+  private fun eventKey(call: MethodCall, name: String = "path"): String? {
+    return when (val path = call.argument<Any>(name)) {
+      is String -> path
+      is ByteArray -> if (path.size == 16) fmodManager.eventIdKey(path) else null
+      else -> null
+    }
+  }
+
   override fun onDetachedFromEngine(@NonNull binding: FlutterPlugin.FlutterPluginBinding) {
     channel.setMethodCallHandler(null)
     fmodManager.release()
   }
+
+  override fun onAttachedToActivity(binding: ActivityPluginBinding) {
+    activity = binding.activity
+    binding.activity.application.registerActivityLifecycleCallbacks(lifecycleCallbacks)
+  }
+
+  override fun onDetachedFromActivity() {
+    activity?.application?.unregisterActivityLifecycleCallbacks(lifecycleCallbacks)
+    activity = null
+  }
+
+  override fun onReattachedToActivityForConfigChanges(binding: ActivityPluginBinding) {
+    onAttachedToActivity(binding)
+  }
+
+  override fun onDetachedFromActivityForConfigChanges() {
+    onDetachedFromActivity()
+  }
 }
 
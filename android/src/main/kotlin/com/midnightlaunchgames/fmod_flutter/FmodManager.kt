@@ -2,9 +2,14 @@ package com.midnightlaunchgames.fmod_flutter
 
 import android.content.Context
 import android.content.res.AssetManager
+import android.media.AudioAttributes
+import android.media.AudioFocusRequest
+import android.media.AudioManager
+import android.os.Build
 import android.util.Log
 import android.os.Handler
 import android.os.Looper
+import java.io.File
 import java.io.IOException
 
 /**
@@ -17,6 +22,14 @@ class FmodManager(private val context: Context) {
     companion object {
         private const val TAG = "FmodManager"
         
+        // Interruption kinds (see audio_interruption.h)
+        private const val INTERRUPTION_TRANSIENT = 0
+        private const val INTERRUPTION_CAN_DUCK = 1
+        private const val INTERRUPTION_LOSS = 2
+        
+        // Output mode using the audio device (see offline_output.h)
+        private const val OUTPUT_DEVICE = 0
+        
         // Load native library
         init {
             System.loadLibrary("fmod")
@@ -29,36 +42,146 @@ class FmodManager(private val context: Context) {
     private val updateRunnable = object : Runnable {
         override fun run() {
             nativeUpdate()
+            dispatchFiredBeatSchedules()
+            dispatchFinishedEvents()
             handler.postDelayed(this, 16) // ~60 FPS
         }
     }
     
+    /**
+     * Called on the main thread when a beat schedule is armed on the DSP clock.
+     * Receives the schedule id, bar, beat and target DSP clock.
+     */
+    var onBeatScheduleFired: ((Map<String, Any>) -> Unit)? = null
+    
+    /**
+     * Called on the main thread with the events whose instances finished
+     * on their own and were reclaimed by the update loop.
+     */
+    var onEventsFinished: ((List<String>) -> Unit)? = null
+    
+    /**
+     * Called on the main thread when audio focus is lost or regained.
+     */
+    var onAudioInterruption: ((Map<String, Any>) -> Unit)? = null
+    
+    private var outputMode = OUTPUT_DEVICE
+    
+    private val audioManager = context.getSystemService(Context.AUDIO_SERVICE) as AudioManager
+    private var focusRequest: AudioFocusRequest? = null
+    private var hasAudioFocus = false
+    private val focusChangeListener = AudioManager.OnAudioFocusChangeListener { change ->
+        when (change) {
+            AudioManager.AUDIOFOCUS_GAIN -> {
+                hasAudioFocus = true
+                endInterruption()
+            }
+            AudioManager.AUDIOFOCUS_LOSS -> {
+                hasAudioFocus = false
+                beginInterruption(INTERRUPTION_LOSS)
+            }
+            AudioManager.AUDIOFOCUS_LOSS_TRANSIENT -> beginInterruption(INTERRUPTION_TRANSIENT)
+            AudioManager.AUDIOFOCUS_LOSS_TRANSIENT_CAN_DUCK -> beginInterruption(INTERRUPTION_CAN_DUCK)
+        }
+    }
+    
     // Native methods
-    private external fun nativeInitialize(): Boolean
+    private external fun nativeInitialize(outputMode: Int, wavPath: String?): Boolean
     private external fun nativeLoadBank(bankData: ByteArray): Boolean
     private external fun nativePlayEvent(eventPath: String): Boolean
+    private external fun nativePlayEventAt(eventPath: String, dspClockOffset: Long, fromDspClock: Long): Long
+    private external fun nativeGetDspClock(): LongArray?
     private external fun nativeStopEvent(eventPath: String): Boolean
     private external fun nativeSetParameter(eventPath: String, paramName: String, value: Float): Boolean
     private external fun nativeSetPaused(eventPath: String, paused: Boolean): Boolean
     private external fun nativeSetVolume(eventPath: String, volume: Float): Boolean
+    private external fun nativeSetPitch(eventPath: String, pitch: Float): Boolean
     private external fun nativeUpdate()
     private external fun nativeRelease()
     private external fun nativeLogAvailableEvents()
     private external fun nativeSetMasterPaused(paused: Boolean): Boolean
+    private external fun nativeScheduleAtBeat(eventPath: String, bar: Int, beat: Int, startEventPath: String?): Int
+    private external fun nativeCancelBeatSchedule(scheduleId: Int): Boolean
+    private external fun nativeDrainFiredBeatSchedules(): LongArray?
+    private external fun nativeCreateEmitter(eventPath: String, start: Boolean): Int
+    private external fun nativeReleaseEmitter(emitterId: Int): Boolean
+    private external fun nativeUpdateSpatial(listeners: FloatArray, emitterIds: IntArray, emitterAttributes: FloatArray): Boolean
+    private external fun nativeSetEmitterCulling(enabled: Boolean, hysteresis: Float)
+    private external fun nativeAddBusEffect(busPath: String, type: Int, parameterIndices: IntArray, parameterValues: FloatArray): Int
+    private external fun nativeRemoveBusEffect(effectId: Int): Boolean
+    private external fun nativeSetBusEffectParameter(effectId: Int, index: Int, value: Float): Boolean
+    private external fun nativeAddSpectrumAnalyzer(target: String, bands: Int, windowSize: Int): Int
+    private external fun nativeRemoveSpectrumAnalyzer(analyzerId: Int): Boolean
+    private external fun nativeSetBusVolume(busPath: String, volume: Float, rampMs: Int): Boolean
+    private external fun nativeSetVcaVolume(vcaPath: String, volume: Float, rampMs: Int): Boolean
+    private external fun nativeSetBusMute(busPath: String, muted: Boolean): Boolean
+    private external fun nativeSetBusPaused(busPath: String, paused: Boolean): Boolean
+    private external fun nativeStartSnapshot(snapshotPath: String): Boolean
+    private external fun nativeStopSnapshot(snapshotPath: String, allowFadeOut: Boolean): Boolean
+    private external fun nativeAutomateParameter(eventPath: String, paramName: String, type: Int, data: FloatArray): Int
+    private external fun nativeReleaseAutomation(automationId: Int): Boolean
+    private external fun nativeCancelAutomation(automationId: Int): Boolean
+    private external fun nativeSetGlobalParameter(name: String, value: Float): Boolean
+    private external fun nativeGetGlobalParameter(name: String): Float
+    private external fun nativeResolveGlobalParameters(names: Array<String>): IntArray
+    private external fun nativeSetGlobalParameters(slots: IntArray, values: FloatArray): Boolean
+    private external fun nativeSuspendMixer(): Boolean
+    private external fun nativeResumeMixer(): Boolean
+    private external fun nativeGetMixerResumeLatency(): Double
+    private external fun nativeIsMixerSuspended(): Boolean
+    private external fun nativeSetInterruptionPolicy(transientResponse: Int, canDuckResponse: Int, lossResponse: Int, duckVolume: Float, rampSeconds: Float)
+    private external fun nativeBeginInterruption(kind: Int): Int
+    private external fun nativeEndInterruption(): Double
+    private external fun nativeStartCommandCapture(fileName: String, flushEachCommand: Boolean): Boolean
+    private external fun nativeStopCommandCapture(): Boolean
+    private external fun nativeIsNonRealtime(): Boolean
+    private external fun nativeRenderOffline(seconds: Float): DoubleArray?
+    private external fun nativeTakeRenderedAudio(format: IntArray): FloatArray?
+    private external fun nativeLoadSound(soundData: ByteArray, stream: Boolean): Int
+    private external fun nativePlaySound(soundId: Int, volume: Float): Boolean
+    private external fun nativeUnloadSound(soundId: Int): Boolean
+    private external fun nativeCreatePcmSound(bufferId: Int, sampleRate: Int, channels: Int, format: Int): Int
+    private external fun nativeCreatePcmStream(sampleRate: Int, channels: Int, capacityMs: Int): Int
+    private external fun nativeReleasePcmStream(streamId: Int): Boolean
+    private external fun nativeGetPcmStreamStats(streamId: Int): LongArray?
+    private external fun nativeStartRecording(driver: Int, monitor: Boolean, latencyMs: Int): Boolean
+    private external fun nativeStopRecording(): Boolean
+    private external fun nativeGetRecordingStats(): LongArray?
+    private external fun nativeStartVoiceStats(windowMs: Int): Boolean
+    private external fun nativeStopVoiceStats()
+    private external fun nativeGetVoiceStatsWindows(): LongArray
+    private external fun nativeGetEventVoicePaths(): Array<String>
+    private external fun nativeGetEventVoiceStats(): IntArray
+    private external fun nativePlayEventWithPcm(eventPath: String, bufferId: Int, sampleRate: Int, channels: Int, format: Int): Boolean
+    private external fun nativeConfigureInstancePool(eventPath: String, prewarmCount: Int, capacity: Int): Boolean
+    private external fun nativeGetInstancePoolStats(eventPath: String?): LongArray?
+    private external fun nativeEventIdKey(eventId: ByteArray): String
+    private external fun nativeQueryInstanceStates(): ByteArray
+    private external fun nativeQueryInstanceKeys(): Array<String>
+    private external fun nativeDrainFinishedEvents(): Array<String>?
     
     /**
      * Initialize the FMOD Studio system.
+     * @param outputMode Output mode (see offline_output.h); 0 is the audio device
+     * @param wavPath File written by the WAV writer output; relative paths
+     *                resolve against the app's files directory
      * @return true if successful
      */
-    fun initialize(): Boolean {
+    fun initialize(outputMode: Int = OUTPUT_DEVICE, wavPath: String? = null): Boolean {
         Log.d(TAG, "Initializing FMOD...")
         
-        val success = nativeInitialize()
+        val wavFile = wavPath?.let { File(it).let { file -> if (file.isAbsolute) file else File(context.filesDir, it) } }
+        wavFile?.parentFile?.mkdirs()
+        this.outputMode = outputMode
+        val success = nativeInitialize(outputMode, wavFile?.absolutePath)
         
         if (success) {
             Log.d(TAG, "FMOD initialized successfully")
-            // Start update loop
-            handler.post(updateRunnable)
+            // Start update loop; offline outputs only mix in renderOffline
+            syncUpdateLoop()
+            if (outputMode == OUTPUT_DEVICE) {
+                requestAudioFocus()
+            }
         } else {
             Log.e(TAG, "Failed to initialize FMOD")
         }
@@ -126,6 +249,31 @@ class FmodManager(private val context: Context) {
         }
     }
     
+    /**
+     * Play an FMOD event starting on a specific mixer DSP clock tick.
+     * @param path Event path
+     * @param dspClockOffset Offset in output samples from [fromDspClock]
+     * @param fromDspClock Base DSP clock, or 0 for the current mixer clock
+     * @return The DSP clock the event starts on, or 0 on failure
+     */
+    fun playEventAt(path: String, dspClockOffset: Long, fromDspClock: Long): Long {
+        Log.d(TAG, "Playing event: $path at +$dspClockOffset samples")
+        val startClock = nativePlayEventAt(path, dspClockOffset, fromDspClock)
+        if (startClock == 0L) {
+            Log.e(TAG, "Failed to play event: $path")
+        }
+        return startClock
+    }
+    
+    /**
+     * Read the current mixer DSP clock.
+     * @return Map with dspClock and sampleRate, or null on failure
+     */
+    fun getDspClock(): Map<String, Long>? {
+        val packed = nativeGetDspClock() ?: return null
+        return mapOf("dspClock" to packed[0], "sampleRate" to packed[1])
+    }
+    
     /**
      * Stop a playing event.
      * @param path Event path
@@ -171,6 +319,679 @@ class FmodManager(private val context: Context) {
         }
     }
     
+    /**
+     * Set the pitch of an event.
+     * @param path Event path
+     * @param pitch Pitch multiplier (1.0 is the authored pitch)
+     */
+    fun setPitch(path: String, pitch: Float) {
+        if (!nativeSetPitch(path, pitch)) {
+            Log.e(TAG, "Failed to set pitch for event: $path")
+        }
+    }
+    
+    /**
+     * The key the event methods take for an event ID, in place of a path.
+     * Events named by ID are looked up without the strings bank.
+     * @param eventId The 16 bytes of the event's FMOD_GUID
+     */
+    fun eventIdKey(eventId: ByteArray): String = nativeEventIdKey(eventId)
+    
+    /**
+     * Schedule work on a musical beat of a playing event.
+     * The beat is tracked natively from the event's timeline and the
+     * schedule is armed on the mixer DSP clock shortly before it lands.
+     * @param path Event path whose timeline drives the schedule
+     * @param bar Bar number (1-based, as reported by FMOD)
+     * @param beat Beat within the bar (1-based)
+     * @param startEventPath Optional event to start sample-accurately on the beat
+     * @return Schedule id, or 0 on failure
+     */
+    fun scheduleAtBeat(path: String, bar: Int, beat: Int, startEventPath: String?): Int {
+        val id = nativeScheduleAtBeat(path, bar, beat, startEventPath)
+        if (id == 0) {
+            Log.e(TAG, "Failed to schedule beat $bar.$beat on event: $path")
+        }
+        return id
+    }
+    
+    /**
+     * Cancel a pending beat schedule.
+     * @param scheduleId Id returned by [scheduleAtBeat]
+     * @return true if the schedule was still pending
+     */
+    fun cancelBeatSchedule(scheduleId: Int): Boolean {
+        return nativeCancelBeatSchedule(scheduleId)
+    }
+    
+    /**
+     * Create a 3D emitter: a dedicated instance of an event whose position is
+     * driven by [updateSpatial].
+     * @param path Event path
+     * @param start Whether to start the emitter immediately
+     * @return Emitter id, or 0 on failure
+     */
+    fun createEmitter(path: String, start: Boolean): Int {
+        val id = nativeCreateEmitter(path, start)
+        if (id == 0) {
+            Log.e(TAG, "Failed to create emitter for event: $path")
+        }
+        return id
+    }
+    
+    /**
+     * Stop and release a 3D emitter.
+     * @param emitterId Id returned by [createEmitter]
+     */
+    fun releaseEmitter(emitterId: Int): Boolean {
+        return nativeReleaseEmitter(emitterId)
+    }
+    
+    /**
+     * Apply listener and emitter 3D attributes in one pass.
+     * Each entity is 12 floats: position, velocity, forward and up vectors.
+     * @param listeners Packed attributes for every listener
+     * @param emitterIds Emitter ids, in the same order as [emitterAttributes]
+     * @param emitterAttributes Packed attributes for every emitter
+     * @return true if successful
+     */
+    fun updateSpatial(listeners: FloatArray, emitterIds: IntArray, emitterAttributes: FloatArray): Boolean {
+        return nativeUpdateSpatial(listeners, emitterIds, emitterAttributes)
+    }
+    
+    /**
+     * Enable or disable distance culling of started emitters. While enabled,
+     * an emitter only holds an event instance when a listener is within the
+     * event's max distance.
+     * @param enabled Whether to cull emitters
+     * @param hysteresis Fraction of max distance an emitter may drift past
+     * before its instance is released
+     */
+    fun setEmitterCulling(enabled: Boolean, hysteresis: Float) {
+        nativeSetEmitterCulling(enabled, hysteresis)
+    }
+    
+    /**
+     * Append a built-in DSP effect to a bus's DSP chain (after the fader).
+     * @param busPath Bus path (e.g., "bus:/SFX")
+     * @param type Effect type (0 = soft limiter, 1 = biquad, 2 = loudness meter)
+     * @param parameterIndices Indices of the parameters to set before the
+     * effect starts processing
+     * @param parameterValues Values for [parameterIndices]
+     * @return Effect id, or 0 on failure
+     */
+    fun addBusEffect(busPath: String, type: Int, parameterIndices: IntArray, parameterValues: FloatArray): Int {
+        val id = nativeAddBusEffect(busPath, type, parameterIndices, parameterValues)
+        if (id == 0) {
+            Log.e(TAG, "Failed to add effect to bus: $busPath")
+        }
+        return id
+    }
+    
+    /**
+     * Remove and release a bus effect.
+     * @param effectId Id returned by [addBusEffect]
+     */
+    fun removeBusEffect(effectId: Int): Boolean {
+        return nativeRemoveBusEffect(effectId)
+    }
+    
+    /**
+     * Set a parameter on a bus effect.
+     * @param effectId Id returned by [addBusEffect]
+     * @param index Parameter index
+     * @param value Parameter value
+     */
+    fun setBusEffectParameter(effectId: Int, index: Int, value: Float): Boolean {
+        return nativeSetBusEffectParameter(effectId, index, value)
+    }
+    
+    /**
+     * Attach an FFT spectrum analyzer to a bus or a playing event instance.
+     * Frames are published natively on each update tick and read from Dart
+     * through FFI.
+     * @param target Bus path (e.g., "bus:/Music") or event path
+     * @param bands Number of log-spaced bands (1 to 128)
+     * @param windowSize FFT window size (power of two, 128 to 32768)
+     * @return Analyzer id, or 0 on failure
+     */
+    fun addSpectrumAnalyzer(target: String, bands: Int, windowSize: Int): Int {
+        val id = nativeAddSpectrumAnalyzer(target, bands, windowSize)
+        if (id == 0) {
+            Log.e(TAG, "Failed to add spectrum analyzer: $target")
+        }
+        return id
+    }
+    
+    /**
+     * Remove and release a spectrum analyzer.
+     * @param analyzerId Id returned by [addSpectrumAnalyzer]
+     */
+    fun removeSpectrumAnalyzer(analyzerId: Int): Boolean {
+        return nativeRemoveSpectrumAnalyzer(analyzerId)
+    }
+    
+    /**
+     * Set the volume of a bus, optionally ramping to it natively.
+     * @param busPath Bus path (e.g., "bus:/Music")
+     * @param volume Target volume (0.0 to 1.0)
+     * @param rampMs Ramp duration in milliseconds; 0 sets it at once
+     */
+    fun setBusVolume(busPath: String, volume: Float, rampMs: Int): Boolean {
+        return nativeSetBusVolume(busPath, volume, rampMs)
+    }
+    
+    /**
+     * Set the volume of a VCA, optionally ramping to it natively.
+     * @param vcaPath VCA path (e.g., "vca:/SFX")
+     * @param volume Target volume (0.0 to 1.0)
+     * @param rampMs Ramp duration in milliseconds; 0 sets it at once
+     */
+    fun setVcaVolume(vcaPath: String, volume: Float, rampMs: Int): Boolean {
+        return nativeSetVcaVolume(vcaPath, volume, rampMs)
+    }
+    
+    /**
+     * Mute or unmute a bus.
+     * @param busPath Bus path (e.g., "bus:/Music")
+     */
+    fun setBusMute(busPath: String, muted: Boolean): Boolean {
+        return nativeSetBusMute(busPath, muted)
+    }
+    
+    /**
+     * Pause or resume a bus.
+     * @param busPath Bus path (e.g., "bus:/Music")
+     */
+    fun setBusPaused(busPath: String, paused: Boolean): Boolean {
+        return nativeSetBusPaused(busPath, paused)
+    }
+    
+    /**
+     * Start a mixer snapshot, restarting it if already active.
+     * @param snapshotPath Snapshot path (e.g., "snapshot:/Pause")
+     */
+    fun startSnapshot(snapshotPath: String): Boolean {
+        return nativeStartSnapshot(snapshotPath)
+    }
+    
+    /**
+     * Stop and release a snapshot started with [startSnapshot].
+     * @param snapshotPath Snapshot path (e.g., "snapshot:/Pause")
+     * @param allowFadeOut Whether the snapshot fades out per its AHDSR
+     */
+    fun stopSnapshot(snapshotPath: String, allowFadeOut: Boolean): Boolean {
+        return nativeStopSnapshot(snapshotPath, allowFadeOut)
+    }
+    
+    /**
+     * Drive a parameter of a playing event with a curve evaluated natively
+     * on each update tick.
+     * @param eventPath Event path whose instance owns the parameter
+     * @param paramName Parameter name
+     * @param type Curve type (0 = linear, 1 = exponential, 2 = keyframes,
+     * 3 = LFO, 4 = ADSR)
+     * @param data Packed curve data (see parameter_automation.h)
+     * @return Automation id, or 0 on failure
+     */
+    fun automateParameter(eventPath: String, paramName: String, type: Int, data: FloatArray): Int {
+        val id = nativeAutomateParameter(eventPath, paramName, type, data)
+        if (id == 0) {
+            Log.e(TAG, "Failed to automate parameter $paramName on $eventPath")
+        }
+        return id
+    }
+    
+    /**
+     * Move an ADSR automation into its release stage.
+     * @param automationId Id returned by [automateParameter]
+     */
+    fun releaseAutomation(automationId: Int): Boolean {
+        return nativeReleaseAutomation(automationId)
+    }
+    
+    /**
+     * Stop an automation, leaving the parameter at its last value.
+     * @param automationId Id returned by [automateParameter]
+     */
+    fun cancelAutomation(automationId: Int): Boolean {
+        return nativeCancelAutomation(automationId)
+    }
+    
+    /**
+     * Set a global parameter.
+     * @param name Parameter name
+     * @param value Parameter value
+     */
+    fun setGlobalParameter(name: String, value: Float): Boolean {
+        return nativeSetGlobalParameter(name, value)
+    }
+    
+    /**
+     * Get the value of a global parameter, or null on failure.
+     * @param name Parameter name
+     */
+    fun getGlobalParameter(name: String): Float? {
+        val value = nativeGetGlobalParameter(name)
+        return if (value.isNaN()) null else value
+    }
+    
+    /**
+     * Resolve global parameter names to slots for [setGlobalParameters].
+     * @param names Parameter names
+     * @return One slot per name, -1 where no such global parameter exists
+     */
+    fun resolveGlobalParameters(names: List<String>): IntArray {
+        return nativeResolveGlobalParameters(names.toTypedArray())
+    }
+    
+    /**
+     * Set many global parameters in one native call.
+     * @param slots Slots from [resolveGlobalParameters]
+     * @param values Values for [slots]
+     */
+    fun setGlobalParameters(slots: IntArray, values: FloatArray): Boolean {
+        return nativeSetGlobalParameters(slots, values)
+    }
+    
+    /**
+     * Stop the update loop and suspend the FMOD mixer thread.
+     * Called when the activity pauses.
+     */
+    fun suspendMixer(): Boolean {
+        if (!nativeSuspendMixer()) {
+            return false
+        }
+        syncUpdateLoop()
+        return true
+    }
+    
+    /**
+     * Resume the FMOD mixer thread and the update loop.
+     * Called when the activity resumes. The mixer stays suspended while an
+     * audio interruption holds it; focus lost for good is requested again.
+     */
+    fun resumeMixer(): Boolean {
+        if (!nativeResumeMixer()) {
+            return false
+        }
+        syncUpdateLoop()
+        if (!hasAudioFocus && outputMode == OUTPUT_DEVICE) {
+            requestAudioFocus()
+        }
+        return true
+    }
+    
+    /**
+     * Set how audio focus loss is handled.
+     * Responses are 0 (duck), 1 (pause) or 2 (suspend the mixer).
+     */
+    fun setInterruptionPolicy(transientResponse: Int, canDuckResponse: Int, lossResponse: Int,
+                              duckVolume: Float, rampSeconds: Float) {
+        nativeSetInterruptionPolicy(transientResponse, canDuckResponse, lossResponse, duckVolume, rampSeconds)
+    }
+    
+    // Runs the update loop only while the mixer is running in realtime
+    private fun syncUpdateLoop() {
+        handler.removeCallbacks(updateRunnable)
+        if (!nativeIsMixerSuspended() && !nativeIsNonRealtime()) {
+            handler.post(updateRunnable)
+        }
+    }
+    
+    private fun requestAudioFocus() {
+        val result = if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+            val request = focusRequest ?: AudioFocusRequest.Builder(AudioManager.AUDIOFOCUS_GAIN)
+                .setAudioAttributes(
+                    AudioAttributes.Builder()
+                        .setUsage(AudioAttributes.USAGE_GAME)
+                        .setContentType(AudioAttributes.CONTENT_TYPE_SONIFICATION)
+                        .build()
+                )
+                // Duck per the interruption policy rather than by the system
+                .setWillPauseWhenDucked(true)
+                .setOnAudioFocusChangeListener(focusChangeListener, handler)
+                .build()
+                .also { focusRequest = it }
+            audioManager.requestAudioFocus(request)
+        } else {
+            @Suppress("DEPRECATION")
+            audioManager.requestAudioFocus(focusChangeListener, AudioManager.STREAM_MUSIC,
+                                           AudioManager.AUDIOFOCUS_GAIN)
+        }
+        hasAudioFocus = result == AudioManager.AUDIOFOCUS_REQUEST_GRANTED
+        if (hasAudioFocus) {
+            endInterruption()
+        } else {
+            Log.w(TAG, "Audio focus request not granted: $result")
+        }
+    }
+    
+    private fun abandonAudioFocus() {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+            focusRequest?.let { audioManager.abandonAudioFocusRequest(it) }
+        } else {
+            @Suppress("DEPRECATION")
+            audioManager.abandonAudioFocus(focusChangeListener)
+        }
+        hasAudioFocus = false
+    }
+    
+    private fun beginInterruption(kind: Int) {
+        val response = nativeBeginInterruption(kind)
+        if (response < 0) {
+            return
+        }
+        syncUpdateLoop()
+        onAudioInterruption?.invoke(mapOf(
+            "interrupted" to true,
+            "kind" to kind,
+            "response" to response
+        ))
+    }
+    
+    private fun endInterruption() {
+        val recoveryMs = nativeEndInterruption()
+        if (recoveryMs < 0) {
+            return
+        }
+        syncUpdateLoop()
+        Log.d(TAG, "Recovered from audio interruption in $recoveryMs ms")
+        onAudioInterruption?.invoke(mapOf(
+            "interrupted" to false,
+            "recoveryMs" to recoveryMs
+        ))
+    }
+    
+    /**
+     * How long the last mixer resume took, in milliseconds, or null if the
+     * mixer has not been resumed.
+     */
+    fun getMixerResumeLatency(): Double? {
+        val latency = nativeGetMixerResumeLatency()
+        return if (latency < 0) null else latency
+    }
+    
+    /**
+     * Mix audio faster than realtime in a non-realtime output mode.
+     * @param seconds Audio to mix
+     * @return Map with renderedSeconds and renderMs, or null on failure
+     */
+    fun renderOffline(seconds: Double): Map<String, Double>? {
+        val packed = nativeRenderOffline(seconds.toFloat()) ?: return null
+        return mapOf(
+            "renderedSeconds" to packed[0],
+            "renderMs" to packed[1]
+        )
+    }
+    
+    /**
+     * Take the mix captured by the memory output since the last call.
+     * @return Map with sampleRate, channels and interleaved samples, or null
+     *         if the output is not the memory output
+     */
+    fun getRenderedAudio(): Map<String, Any>? {
+        val format = IntArray(2)
+        val samples = nativeTakeRenderedAudio(format) ?: return null
+        return mapOf(
+            "sampleRate" to format[0],
+            "channels" to format[1],
+            "samples" to samples
+        )
+    }
+    
+    /**
+     * Load a sound that is not in a Studio bank, e.g. a compact .fca file.
+     * Assets are read into memory, so a stream still holds the whole file.
+     * @param assetPath Flutter asset path
+     * @param stream Decode while playing instead of at load
+     * @return Sound id, or 0 on failure
+     */
+    fun loadSound(assetPath: String, stream: Boolean): Int {
+        return try {
+            val inputStream = try {
+                context.assets.open("flutter_assets/$assetPath")
+            } catch (e: IOException) {
+                context.assets.open(assetPath)
+            }
+            val soundData = inputStream.use { it.readBytes() }
+            val id = nativeLoadSound(soundData, stream)
+            if (id == 0) {
+                Log.e(TAG, "Failed to load sound: $assetPath")
+            }
+            id
+        } catch (e: IOException) {
+            Log.e(TAG, "Failed to read sound file: $assetPath", e)
+            0
+        }
+    }
+    
+    /**
+     * Play a sound loaded with [loadSound] once.
+     * @param soundId Id returned by [loadSound]
+     * @param volume Linear volume, 1.0 is unchanged
+     */
+    fun playSound(soundId: Int, volume: Float): Boolean {
+        return nativePlaySound(soundId, volume)
+    }
+    
+    /**
+     * Release a sound loaded with [loadSound].
+     * @param soundId Id returned by [loadSound]
+     */
+    fun unloadSound(soundId: Int): Boolean {
+        return nativeUnloadSound(soundId)
+    }
+    
+    /**
+     * Create a sound over a PCM buffer that Dart filled through dart:ffi.
+     * The sound plays from the buffer's memory and keeps it alive until
+     * it is unloaded with [unloadSound].
+     * @param bufferId Id of the native PCM buffer
+     * @param format 0 for 16-bit integer samples, 1 for 32-bit float
+     * @return Sound id, or 0 on failure
+     */
+    fun createPcmSound(bufferId: Int, sampleRate: Int, channels: Int, format: Int): Int {
+        return nativeCreatePcmSound(bufferId, sampleRate, channels, format)
+    }
+    
+    /**
+     * Start a one-shot instance of an event whose programmer instruments
+     * play a PCM buffer that Dart filled through dart:ffi.
+     * @param bufferId Id of the native PCM buffer
+     * @param format 0 for 16-bit integer samples, 1 for 32-bit float
+     */
+    fun playEventWithPcm(eventPath: String, bufferId: Int, sampleRate: Int, channels: Int, format: Int): Boolean {
+        return nativePlayEventWithPcm(eventPath, bufferId, sampleRate, channels, format)
+    }
+    
+    /**
+     * Create a stream that Dart pushes float PCM into through dart:ffi,
+     * and start playing it.
+     * @param capacityMs Most audio the stream buffers ahead of playback
+     * @return Stream id, or 0 on failure
+     */
+    fun createPcmStream(sampleRate: Int, channels: Int, capacityMs: Int): Int {
+        return nativeCreatePcmStream(sampleRate, channels, capacityMs)
+    }
+    
+    /**
+     * Stop and release a stream created with [createPcmStream].
+     */
+    fun releasePcmStream(streamId: Int): Boolean {
+        return nativeReleasePcmStream(streamId)
+    }
+    
+    /**
+     * Read buffering, underrun and latency statistics of a PCM stream.
+     * @return Map of the statistics, or null if no such stream
+     */
+    fun getPcmStreamStats(streamId: Int): Map<String, Long>? {
+        val packed = nativeGetPcmStreamStats(streamId) ?: return null
+        return mapOf(
+            "sampleRate" to packed[0],
+            "channels" to packed[1],
+            "capacityFrames" to packed[2],
+            "queuedFrames" to packed[3],
+            "underruns" to packed[4],
+            "underrunFrames" to packed[5],
+            "droppedFrames" to packed[6],
+            "latencyUs" to packed[7]
+        )
+    }
+    
+    /**
+     * Record from a microphone. The app must hold the RECORD_AUDIO
+     * permission; recorded audio is read from Dart through dart:ffi.
+     * @param driver Record driver index; 0 is the default input
+     * @param monitor Also play the input back through the output
+     * @param latencyMs Target delay between recording and monitor playback
+     * @return true if recording started
+     */
+    fun startRecording(driver: Int, monitor: Boolean, latencyMs: Int): Boolean {
+        return nativeStartRecording(driver, monitor, latencyMs)
+    }
+    
+    /**
+     * Stop recording and monitoring.
+     */
+    fun stopRecording(): Boolean {
+        return nativeStopRecording()
+    }
+    
+    /**
+     * Read recording and monitor latency statistics.
+     * @return Map of the statistics, or null if not recording
+     */
+    fun getRecordingStats(): Map<String, Any>? {
+        val packed = nativeGetRecordingStats() ?: return null
+        return mapOf(
+            "recording" to (packed[0] != 0L),
+            "monitoring" to (packed[1] != 0L),
+            "sampleRate" to packed[2],
+            "channels" to packed[3],
+            "recordedFrames" to packed[4],
+            "droppedSamples" to packed[5],
+            "monitorLatencyUs" to packed[6],
+            "targetLatencyUs" to packed[7]
+        )
+    }
+    
+    /**
+     * Start sampling real and virtual voices and per-event instances on
+     * each update tick, aggregated over windows of [windowMs].
+     * @return true if sampling started
+     */
+    fun startVoiceStats(windowMs: Int): Boolean {
+        return nativeStartVoiceStats(windowMs)
+    }
+    
+    /**
+     * Stop sampling voices; complete windows stay readable.
+     */
+    fun stopVoiceStats() {
+        nativeStopVoiceStats()
+    }
+    
+    /**
+     * Read the complete voice statistics windows, oldest first, and the
+     * events of the newest window.
+     * @return Map with "windows" and "events" lists
+     */
+    fun getVoiceStats(): Map<String, Any> {
+        val packed = nativeGetVoiceStatsWindows()
+        val windows = (0 until packed.size / 13).map { i ->
+            val w = i * 13
+            mapOf(
+                "endUs" to packed[w],
+                "durationUs" to packed[w + 1],
+                "samples" to packed[w + 2],
+                "maxChannels" to packed[w + 3],
+                "softwareChannels" to packed[w + 4],
+                "realPeak" to packed[w + 5],
+                "virtualPeak" to packed[w + 6],
+                "saturatedSamples" to packed[w + 7],
+                "realSum" to packed[w + 8],
+                "virtualSum" to packed[w + 9],
+                "starts" to packed[w + 10],
+                "startFailures" to packed[w + 11],
+                "virtualizations" to packed[w + 12]
+            )
+        }
+        val paths = nativeGetEventVoicePaths()
+        val counts = nativeGetEventVoiceStats()
+        val events = paths.mapIndexed { i, path ->
+            val e = i * 5
+            mapOf(
+                "path" to path,
+                "instances" to counts[e],
+                "peakInstances" to counts[e + 1],
+                "starts" to counts[e + 2],
+                "startFailures" to counts[e + 3],
+                "virtualizations" to counts[e + 4]
+            )
+        }
+        return mapOf("windows" to windows, "events" to events)
+    }
+    
+    /**
+     * Every live event and emitter instance as of the last update tick.
+     * @return Map with "states", packed FmodInstanceState records
+     *         (instance_states.h), and "keys", the event key of each
+     */
+    fun queryInstances(): Map<String, Any> {
+        return mapOf(
+            "states" to nativeQueryInstanceStates(),
+            "keys" to nativeQueryInstanceKeys().toList()
+        )
+    }
+    
+    /**
+     * Record every Studio API call for replay with tool/command_replay.
+     * @param path Capture file; relative paths resolve against the app's
+     *             files directory
+     * @param flushEachCommand Write each command as it is issued, so the
+     *                         capture survives a crash
+     * @return The absolute path being written, or null on failure
+     */
+    fun startCommandCapture(path: String, flushEachCommand: Boolean): String? {
+        val file = File(path).let { if (it.isAbsolute) it else File(context.filesDir, path) }
+        file.parentFile?.mkdirs()
+        return if (nativeStartCommandCapture(file.absolutePath, flushEachCommand)) file.absolutePath else null
+    }
+    
+    /**
+     * Stop the command capture and close its file.
+     */
+    fun stopCommandCapture(): Boolean {
+        return nativeStopCommandCapture()
+    }
+    
+    /**
+     * Keep stopped instances of an event for reuse by [playEvent].
+     * @param path Event path
+     * @param prewarmCount Instances to create now
+     * @param capacity Most idle instances kept; 0 removes the pool
+     */
+    fun configureInstancePool(path: String, prewarmCount: Int, capacity: Int): Boolean {
+        return nativeConfigureInstancePool(path, prewarmCount, capacity)
+    }
+    
+    /**
+     * Read instance pool statistics.
+     * @param path Event path, or null for totals across every pool
+     * @return Map with idleCount, capacity, hits and misses, or null if no such pool
+     */
+    fun getInstancePoolStats(path: String?): Map<String, Long>? {
+        val packed = nativeGetInstancePoolStats(path) ?: return null
+        return mapOf(
+            "idleCount" to packed[0],
+            "capacity" to packed[1],
+            "hits" to packed[2],
+            "misses" to packed[3]
+        )
+    }
+    
     /**
      * Update the FMOD system.
      * Should be called regularly (e.g., once per frame).
@@ -178,6 +999,28 @@ class FmodManager(private val context: Context) {
      */
     fun update() {
         nativeUpdate()
+        dispatchFiredBeatSchedules()
+        dispatchFinishedEvents()
+    }
+    
+    private fun dispatchFinishedEvents() {
+        val finished = nativeDrainFinishedEvents() ?: return
+        onEventsFinished?.invoke(finished.toList())
+    }
+    
+    private fun dispatchFiredBeatSchedules() {
+        val fired = nativeDrainFiredBeatSchedules() ?: return
+        val listener = onBeatScheduleFired ?: return
+        
+        // Packed as [id, bar, beat, dspClock] per fired schedule
+        for (i in 0 until fired.size / 4) {
+            listener(mapOf(
+                "id" to fired[i * 4].toInt(),
+                "bar" to fired[i * 4 + 1].toInt(),
+                "beat" to fired[i * 4 + 2].toInt(),
+                "dspClock" to fired[i * 4 + 3]
+            ))
+        }
     }
     
     /**
@@ -205,6 +1048,7 @@ class FmodManager(private val context: Context) {
     fun release() {
         Log.d(TAG, "Releasing FMOD...")
         handler.removeCallbacks(updateRunnable)
+        abandonAudioFocus()
         nativeRelease()
     }
 }
@@ -9,12 +9,162 @@
 #import <fmod.h>
 #import <fmod_studio.h>
 #import <fmod_errors.h>
+#import "audio_interruption.h"
+#import "beat_clock.h"
+#import "deferred_writes.h"
+#import "dsp_effects.h"
+#import "emitter_culler.h"
+#import "event_lookup.h"
+#import "global_parameters.h"
+#import "instance_pool.h"
+#import "instance_states.h"
+#import "instance_sweeper.h"
+#import "mic_capture.h"
+#import "mixer_control.h"
+#import "mixer_lifecycle.h"
+#import "offline_output.h"
+#import "parameter_automation.h"
+#import "pcm_sounds.h"
+#import "pcm_stream.h"
+#import "sound_library.h"
+#import "spectrum_analyzer.h"
+#import "voice_stats.h"
 #import <AVFoundation/AVFoundation.h>
 
+// How far ahead of a beat a schedule is armed on the DSP clock. Must cover
+// at least one update tick (~16 ms) plus timer jitter.
+static const int kBeatScheduleLookaheadMs = 50;
+
+// Packed spatial layout: position, velocity, forward and up vectors
+// (matches FMOD_3D_ATTRIBUTES)
+static const int kSpatialFloatsPerEntity = 12;
+
+// Latest timeline beat reported by FMOD for an event instance, anchored to
+// the mixer DSP clock on the next update tick.
+typedef struct {
+    int bar;
+    int beat;
+    int beatsPerBar;
+    float tempo;
+    int position;
+    BOOL anchored;
+    unsigned long long anchorClock;
+} FmodBeatState;
+
+// A pending scheduleAtBeat request.
+@interface FmodBeatSchedule : NSObject
+@property (nonatomic) int scheduleId;
+@property (nonatomic, copy) NSString *eventPath;
+@property (nonatomic) int bar;
+@property (nonatomic) int beat;
+@property (nonatomic, copy, nullable) NSString *startEventPath;
+@end
+
+@implementation FmodBeatSchedule
+@end
+
+// A 3D emitter registered from Dart. instance is NULL while the emitter is
+// culled; only emitters started by the caller are culled.
+@interface FmodEmitter : NSObject
+@property (nonatomic) FMOD_STUDIO_EVENTDESCRIPTION *eventDescription;
+@property (nonatomic) FMOD_STUDIO_EVENTINSTANCE *instance;
+@property (nonatomic) FMOD_3D_ATTRIBUTES attributes;
+@property (nonatomic) float maxDistance;
+@property (nonatomic) BOOL playing;
+@end
+
+@implementation FmodEmitter
+@end
+
+@interface FmodBridge ()
+- (void)handleBeatCallback:(FMOD_STUDIO_EVENT_CALLBACK_TYPE)type
+                  instance:(FMOD_STUDIO_EVENTINSTANCE *)instance
+                parameters:(void *)parameters;
+- (BOOL)getMixerClock:(unsigned long long *)clock sampleRate:(int *)sampleRate;
+- (void)advanceAutomation:(float)seconds;
+- (void)restoreAmbientSession;
+@end
+
+static FMOD_RESULT F_CALL FmodBridgeBeatCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type,
+                                                 FMOD_STUDIO_EVENTINSTANCE *event,
+                                                 void *parameters) {
+    // Replaces the voice statistics description callback on this instance.
+    if ((type & FMOD_FLUTTER_VOICE_STATS_CALLBACKS) != 0) {
+        return fmod_voice_stats_event_callback(type, event, parameters);
+    }
+    void *userData = NULL;
+    FMOD_Studio_EventInstance_GetUserData(event, &userData);
+    if (userData != NULL) {
+        FmodBridge *bridge = (__bridge FmodBridge *)userData;
+        [bridge handleBeatCallback:type instance:event parameters:parameters];
+    }
+    return FMOD_OK;
+}
+
+// Advances ramps and curves after each block a render mixes
+static void FmodBridgeRenderBlockCallback(void *context, float blockSeconds) {
+    FmodBridge *bridge = (__bridge FmodBridge *)context;
+    [bridge advanceAutomation:blockSeconds];
+}
+
 @implementation FmodBridge {
     FMOD_STUDIO_SYSTEM *studioSystem;
     FMOD_SYSTEM *coreSystem;
     NSMutableDictionary<NSString *, NSValue *> *eventInstances;
+    // 3D emitters keyed by emitter id; several may play the same event
+    NSMutableDictionary<NSNumber *, FmodEmitter *> *emitters;
+    int nextEmitterId;
+    int listenerCount;
+    // Distance culling of emitters against the listener positions (xyz per
+    // listener) from the last spatial update
+    FmodEmitterCuller *emitterCuller;
+    float listenerPositions[FMOD_MAX_LISTENERS * 3];
+    BOOL emitterCulling;
+    // Built-in DSP effects attached to buses
+    FmodBusEffects *busEffects;
+    // Bus, VCA and snapshot handles cached at bank load; volume ramps
+    // advance on each update tick
+    FmodMixerControl *mixerControl;
+    // Mixer suspended while the app is in the background or interrupted
+    FmodMixerLifecycle *mixerLifecycle;
+    // Device, headless or offline output chosen at initialize
+    FmodOfflineOutput *offlineOutput;
+    // Loose sounds outside Studio banks, including the compact .fca format
+    FmodSoundLibrary *soundLibrary;
+    // Streams that Dart pushes PCM into through dart:ffi
+    FmodPcmStreams *pcmStreams;
+    // Microphone recording, tapped for Dart on each update tick
+    FmodMicCapture *micCapture;
+    // Voice and virtualization statistics, sampled on each update tick
+    FmodVoiceStats *voiceStats;
+    // Parameter, volume and pitch writes, coalesced and flushed before each
+    // Studio update
+    FmodDeferredWrites *deferredWrites;
+    // Response to audio session interruptions, per interruption policy
+    FmodAudioInterruption *audioInterruption;
+    // Global parameter IDs resolved at bank load
+    FmodGlobalParameters *globalParameters;
+    // Stopped instances kept for reuse by playEvent, per event path
+    FmodInstancePool *instancePool;
+    // Parameter curves applied on each update tick
+    FmodParameterAutomation *parameterAutomation;
+    // FFT analyzers on buses and instances, published on each update tick
+    FmodSpectrumAnalyzers *spectrumAnalyzers;
+    // States of every live event and emitter instance, read on each update
+    // tick
+    FmodInstanceStates *instanceStates;
+    // Instances started by playEvent, swept on each update tick for those
+    // that finished on their own; their events wait in finishedEvents
+    FmodInstanceSweeper *instanceSweeper;
+    NSMutableArray<NSString *> *finishedEvents;
+    // Beat state is written from FMOD's Studio thread, so beatStates,
+    // beatSchedules and firedBeatSchedules are guarded by @synchronized(beatStates)
+    NSMutableDictionary<NSValue *, NSValue *> *beatStates;
+    NSMutableArray<FmodBeatSchedule *> *beatSchedules;
+    NSMutableArray<NSDictionary<NSString *, NSNumber *> *> *firedBeatSchedules;
+    int nextBeatScheduleId;
+    // System uptime when update last ran; 0 before the first
+    NSTimeInterval lastUpdateTime;
 }
 
 - (instancetype)init {
@@ -23,32 +173,61 @@
         studioSystem = NULL;
         coreSystem = NULL;
         eventInstances = [NSMutableDictionary dictionary];
+        emitters = [NSMutableDictionary dictionary];
+        nextEmitterId = 1;
+        listenerCount = 1;
+        emitterCuller = fmod_emitter_culler_create();
+        emitterCulling = NO;
+        busEffects = fmod_bus_effects_create();
+        mixerControl = fmod_mixer_control_create();
+        mixerLifecycle = fmod_mixer_lifecycle_create();
+        offlineOutput = fmod_offline_output_create();
+        soundLibrary = fmod_sound_library_create();
+        pcmStreams = fmod_pcm_streams_create();
+        micCapture = fmod_mic_capture_create();
+        voiceStats = fmod_voice_stats_create();
+        deferredWrites = fmod_deferred_writes_create();
+        audioInterruption = fmod_audio_interruption_create();
+        globalParameters = fmod_global_parameters_create();
+        instancePool = fmod_instance_pool_create();
+        parameterAutomation = fmod_parameter_automation_create();
+        spectrumAnalyzers = fmod_spectrum_analyzers_create();
+        instanceStates = fmod_instance_states_create();
+        instanceSweeper = fmod_instance_sweeper_create();
+        finishedEvents = [NSMutableArray array];
+        beatStates = [NSMutableDictionary dictionary];
+        beatSchedules = [NSMutableArray array];
+        firedBeatSchedules = [NSMutableArray array];
+        nextBeatScheduleId = 1;
     }
     return self;
 }
 
-- (BOOL)initializeFmod {
+- (BOOL)initializeFmodWithOutput:(int)outputMode
+                         wavPath:(NSString *)wavPath {
     FMOD_RESULT result;
     
-    // Configure iOS Audio Session first
-    NSError *error = nil;
-    AVAudioSession *audioSession = [AVAudioSession sharedInstance];
-    
-    // Set audio session category to Ambient:
-    // - Respects the silent switch (mutes when phone is silenced)
-    // - Mixes with other apps' audio (user can listen to their own music)
-    [audioSession setCategory:AVAudioSessionCategoryAmbient
-                        error:&error];
-    
-    if (error) {
-        NSLog(@"FmodBridge: Failed to set audio session category: %@", error);
-    }
-    
-    // Activate the audio session
-    [audioSession setActive:YES error:&error];
-    
-    if (error) {
-        NSLog(@"FmodBridge: Failed to activate audio session: %@", error);
+    // Configure iOS Audio Session first; other outputs use no device
+    if (outputMode == FMOD_FLUTTER_OUTPUT_DEVICE) {
+        NSError *error = nil;
+        AVAudioSession *audioSession = [AVAudioSession sharedInstance];
+        
+        // Set audio session category to Ambient:
+        // - Respects the silent switch (mutes when phone is silenced)
+        // - Mixes with other apps' audio (user can listen to their own music)
+        [audioSession setCategory:AVAudioSessionCategoryAmbient
+                            error:&error];
+        
+        if (error) {
+            NSLog(@"FmodBridge: Failed to set audio session category: %@", error);
+        }
+        
+        // Activate the audio session
+        [audioSession setActive:YES error:&error];
+        
+        if (error) {
+            NSLog(@"FmodBridge: Failed to activate audio session: %@", error);
+        }
     }
     
     // Create FMOD Studio System
@@ -67,17 +246,23 @@
         return NO;
     }
     
-    // Set output type to auto-detect (let FMOD choose best for iOS)
-    result = FMOD_System_SetOutput(coreSystem, FMOD_OUTPUTTYPE_AUTODETECT);
-    if (result != FMOD_OK) {
-        NSLog(@"FmodBridge: Warning - failed to set output type: %d - %s", 
-              result, FMOD_ErrorString(result));
+    // Auto-detect the device unless a headless or offline output was asked for
+    if (!fmod_offline_output_configure(offlineOutput, coreSystem, outputMode,
+                                       [wavPath UTF8String])) {
+        result = fmod_offline_output_last_result(offlineOutput);
+        NSLog(@"FmodBridge: Failed to set output type %d: %d - %s",
+              outputMode, result, FMOD_ErrorString(result));
+        if (outputMode != FMOD_FLUTTER_OUTPUT_DEVICE) {
+            return NO;
+        }
     }
     
     // Initialize FMOD Studio System
-    result = FMOD_Studio_System_Initialize(studioSystem, 512, 
-                                          FMOD_STUDIO_INIT_NORMAL,
-                                          FMOD_INIT_NORMAL, NULL);
+    result = FMOD_Studio_System_Initialize(
+        studioSystem, FMOD_FLUTTER_MAX_CHANNELS,
+        fmod_offline_output_studio_init_flags(offlineOutput),
+        fmod_offline_output_core_init_flags(offlineOutput),
+        fmod_offline_output_extra_driver_data(offlineOutput));
     if (result != FMOD_OK) {
         NSLog(@"FmodBridge: Failed to initialize FMOD Studio System: %d - %s", 
               result, FMOD_ErrorString(result));
@@ -95,6 +280,12 @@
     return YES;
 }
 
++ (NSString *)eventKeyForId:(NSData *)eventId {
+    char key[FMOD_FLUTTER_EVENT_ID_KEY_LENGTH];
+    fmod_event_id_key((const uint8_t *)eventId.bytes, key);
+    return [NSString stringWithUTF8String:key];
+}
+
 - (BOOL)loadBankAtPath:(NSString *)path {
     if (studioSystem == NULL) {
         NSLog(@"FmodBridge: Studio system not initialized");
@@ -113,6 +304,9 @@
         return NO;
     }
     
+    fmod_mixer_control_cache_banks(mixerControl, studioSystem);
+    fmod_global_parameters_cache_banks(globalParameters, studioSystem);
+    
     NSLog(@"FmodBridge: Loaded bank: %@", path);
     return YES;
 }
@@ -123,66 +317,121 @@
         return NO;
     }
     
-    FMOD_RESULT result;
+    if (![self startEvent:eventPath atDSPClock:0]) {
+        return NO;
+    }
     
-    // Get the event description
-    FMOD_STUDIO_EVENTDESCRIPTION *eventDescription = NULL;
-    result = FMOD_Studio_System_GetEvent(studioSystem, 
-                                        [eventPath UTF8String],
-                                        &eventDescription);
+    NSLog(@"FmodBridge: Started playing event: %@", eventPath);
+    return YES;
+}
+
+- (unsigned long long)playEvent:(NSString *)eventPath
+              atDSPClockOffset:(unsigned long long)offset
+                  fromDSPClock:(unsigned long long)fromClock {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
     
-    if (result != FMOD_OK) {
-        NSLog(@"FmodBridge: Failed to get event %@: %d - %s", 
-              eventPath, result, FMOD_ErrorString(result));
-        return NO;
+    unsigned long long base = fromClock;
+    if (base == 0) {
+        int sampleRate = 0;
+        if (![self getMixerClock:&base sampleRate:&sampleRate]) {
+            NSLog(@"FmodBridge: Failed to read mixer DSP clock");
+            return 0;
+        }
+    }
+    
+    unsigned long long startClock = base + offset;
+    if (![self startEvent:eventPath atDSPClock:startClock]) {
+        return 0;
+    }
+    
+    NSLog(@"FmodBridge: Started playing event: %@ at dsp clock %llu", eventPath, startClock);
+    return startClock;
+}
+
+- (nullable NSDictionary<NSString *, NSNumber *> *)currentDSPClock {
+    unsigned long long clock = 0;
+    int sampleRate = 0;
+    if (![self getMixerClock:&clock sampleRate:&sampleRate]) {
+        NSLog(@"FmodBridge: Failed to read mixer DSP clock");
+        return nil;
     }
     
-    // Check if an instance is already playing for this event
+    return @{ @"dspClock": @(clock), @"sampleRate": @(sampleRate) };
+}
+
+// Starts eventPath, restarting the tracked instance if it is still playing.
+// A non-zero startClock delays the instance's channel group until that mixer
+// DSP clock tick, giving sample-accurate start.
+- (BOOL)startEvent:(NSString *)eventPath atDSPClock:(unsigned long long)startClock {
+    FMOD_RESULT result;
+    
+    // Check if an instance is already playing for this event. A restart
+    // stops it and goes through the same acquire, flush, delay and start
+    // steps as a fresh start, so a scheduled restart delays a channel group
+    // that exists.
     NSValue *existingValue = eventInstances[eventPath];
     if (existingValue != nil) {
         FMOD_STUDIO_EVENTINSTANCE *existingInstance = [existingValue pointerValue];
         FMOD_STUDIO_PLAYBACK_STATE state;
         FMOD_Studio_EventInstance_GetPlaybackState(existingInstance, &state);
         
-        // If still playing, restart it
         if (state == FMOD_STUDIO_PLAYBACK_PLAYING || 
             state == FMOD_STUDIO_PLAYBACK_STARTING) {
             NSLog(@"FmodBridge: Restarting already playing event: %@", eventPath);
             FMOD_Studio_EventInstance_Stop(existingInstance, FMOD_STUDIO_STOP_IMMEDIATE);
-            FMOD_Studio_EventInstance_Start(existingInstance);
-            return YES;
-        } else {
-            // Release the old stopped instance
-            FMOD_Studio_EventInstance_Release(existingInstance);
-            [eventInstances removeObjectForKey:eventPath];
         }
+        // Return the old instance to the pool
+        [self recycleInstance:existingInstance forEvent:eventPath];
+        [eventInstances removeObjectForKey:eventPath];
     }
     
-    // Create an instance of the event
-    FMOD_STUDIO_EVENTINSTANCE *eventInstance = NULL;
-    result = FMOD_Studio_EventDescription_CreateInstance(eventDescription, 
-                                                        &eventInstance);
+    // Take an idle instance from the event's pool, or create one
+    FMOD_STUDIO_EVENTINSTANCE *eventInstance =
+        fmod_instance_pool_acquire(instancePool, studioSystem, [eventPath UTF8String]);
     
-    if (result != FMOD_OK) {
+    if (eventInstance == NULL) {
+        result = fmod_instance_pool_last_result(instancePool);
         NSLog(@"FmodBridge: Failed to create event instance for %@: %d - %s", 
               eventPath, result, FMOD_ErrorString(result));
         return NO;
     }
     
+    FMOD_Studio_EventInstance_SetUserData(eventInstance, (__bridge void *)self);
+    FMOD_Studio_EventInstance_SetCallback(eventInstance, FmodBridgeBeatCallback,
+                                          FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_BEAT |
+                                          FMOD_STUDIO_EVENT_CALLBACK_DESTROYED |
+                                          FMOD_FLUTTER_VOICE_STATS_CALLBACKS);
+    
+    if (startClock != 0) {
+        // The channel group only exists once the create command has been
+        // processed, so flush before delaying it
+        FMOD_CHANNELGROUP *group = NULL;
+        FMOD_Studio_System_FlushCommands(studioSystem);
+        result = FMOD_Studio_EventInstance_GetChannelGroup(eventInstance, &group);
+        if (result == FMOD_OK) {
+            FMOD_ChannelGroup_SetDelay(group, startClock, 0, 0);
+        } else {
+            NSLog(@"FmodBridge: Failed to get channel group for %@, starting immediately: %d - %s",
+                  eventPath, result, FMOD_ErrorString(result));
+        }
+    }
+    
     // Start the event
     result = FMOD_Studio_EventInstance_Start(eventInstance);
     
     if (result != FMOD_OK) {
         NSLog(@"FmodBridge: Failed to start event %@: %d - %s", 
               eventPath, result, FMOD_ErrorString(result));
-        FMOD_Studio_EventInstance_Release(eventInstance);
+        [self recycleInstance:eventInstance forEvent:eventPath];
         return NO;
     }
     
     // Store the instance for later control
     eventInstances[eventPath] = [NSValue valueWithPointer:eventInstance];
-    NSLog(@"FmodBridge: Started playing event: %@", eventPath);
-    
+    fmod_instance_sweeper_watch(instanceSweeper, [eventPath UTF8String], eventInstance);
     return YES;
 }
 
@@ -195,6 +444,10 @@
     
     FMOD_STUDIO_EVENTINSTANCE *eventInstance = [instanceValue pointerValue];
     
+    // Writes from earlier in this tick still apply to the fade-out; the
+    // instance is recycled below, which drops anything still queued.
+    fmod_deferred_writes_flush_instance(deferredWrites, eventInstance);
+    
     // Stop the event with fade out
     FMOD_RESULT result = FMOD_Studio_EventInstance_Stop(eventInstance, 
                                                         FMOD_STUDIO_STOP_ALLOWFADEOUT);
@@ -205,8 +458,8 @@
         return NO;
     }
     
-    // Release the instance
-    FMOD_Studio_EventInstance_Release(eventInstance);
+    // Return the instance to the pool once it has faded out
+    [self recycleInstance:eventInstance forEvent:eventPath];
     [eventInstances removeObjectForKey:eventPath];
     
     NSLog(@"FmodBridge: Stopped event: %@", eventPath);
@@ -224,12 +477,11 @@
     
     FMOD_STUDIO_EVENTINSTANCE *eventInstance = [instanceValue pointerValue];
     
-    FMOD_RESULT result = FMOD_Studio_EventInstance_SetParameterByName(eventInstance,
-                                                                      [paramName UTF8String],
-                                                                      value,
-                                                                      false);
-    
-    if (result != FMOD_OK) {
+    fmod_parameter_automation_cancel_parameter(parameterAutomation, eventInstance,
+                                               [paramName UTF8String]);
+    if (!fmod_deferred_writes_set_parameter(deferredWrites, eventInstance,
+                                            [paramName UTF8String], value)) {
+        FMOD_RESULT result = fmod_deferred_writes_last_result(deferredWrites);
         NSLog(@"FmodBridge: Failed to set parameter %@ on %@: %d - %s", 
               paramName, eventPath, result, FMOD_ErrorString(result));
         return NO;
@@ -268,9 +520,8 @@
     
     FMOD_STUDIO_EVENTINSTANCE *eventInstance = [instanceValue pointerValue];
     
-    FMOD_RESULT result = FMOD_Studio_EventInstance_SetVolume(eventInstance, volume);
-    
-    if (result != FMOD_OK) {
+    if (!fmod_deferred_writes_set_volume(deferredWrites, eventInstance, volume)) {
+        FMOD_RESULT result = fmod_deferred_writes_last_result(deferredWrites);
         NSLog(@"FmodBridge: Failed to set volume on %@: %d - %s", 
               eventPath, result, FMOD_ErrorString(result));
         return NO;
@@ -279,100 +530,1345 @@
     return YES;
 }
 
+- (BOOL)setPitchForEvent:(NSString *)eventPath pitch:(float)pitch {
+    NSValue *instanceValue = eventInstances[eventPath];
+    if (instanceValue == nil) {
+        NSLog(@"FmodBridge: No instance found for %@", eventPath);
+        return NO;
+    }
+    
+    FMOD_STUDIO_EVENTINSTANCE *eventInstance = [instanceValue pointerValue];
+    
+    if (!fmod_deferred_writes_set_pitch(deferredWrites, eventInstance, pitch)) {
+        FMOD_RESULT result = fmod_deferred_writes_last_result(deferredWrites);
+        NSLog(@"FmodBridge: Failed to set pitch on %@: %d - %s",
+              eventPath, result, FMOD_ErrorString(result));
+        return NO;
+    }
+    
+    return YES;
+}
+
 - (void)update {
     if (studioSystem != NULL) {
+        fmod_deferred_writes_flush(deferredWrites);
         FMOD_Studio_System_Update(studioSystem);
+        [self processBeatSchedules];
+        [self processEmitterCulling];
+        // Ramps and curves follow the wall clock here; renders advance them
+        // by the audio they mix instead, through
+        // FmodBridgeRenderBlockCallback
+        NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+        float elapsed = 0.0f;
+        if (lastUpdateTime > 0 && !fmod_offline_output_non_realtime(offlineOutput)) {
+            elapsed = (float)(now - lastUpdateTime);
+        }
+        lastUpdateTime = now;
+        [self advanceAutomation:elapsed];
+        fmod_spectrum_analyzers_update(spectrumAnalyzers);
+        fmod_mic_capture_update(micCapture);
+        fmod_voice_stats_update(voiceStats);
+        [self sweepFinishedInstances];
+        [self refreshInstanceStates];
     }
 }
 
-- (void)releaseFmod {
-    // Stop and release all event instances
-    for (NSString *key in eventInstances) {
-        FMOD_STUDIO_EVENTINSTANCE *instance = [eventInstances[key] pointerValue];
-        FMOD_Studio_EventInstance_Stop(instance, FMOD_STUDIO_STOP_IMMEDIATE);
-        FMOD_Studio_EventInstance_Release(instance);
+- (void)advanceAutomation:(float)seconds {
+    fmod_mixer_control_update(mixerControl, seconds);
+    fmod_parameter_automation_update(parameterAutomation, seconds);
+}
+
+// Recycles tracked instances that finished on their own, a bounded number
+// per tick, and queues their events for drainFinishedEvents
+- (void)sweepFinishedInstances {
+    int count = fmod_instance_sweeper_sweep(instanceSweeper,
+                                            FMOD_FLUTTER_INSTANCE_SWEEP_BUDGET);
+    for (int i = 0; i < count; i++) {
+        const char *key = NULL;
+        FMOD_STUDIO_EVENTINSTANCE *instance =
+            fmod_instance_sweeper_finished(instanceSweeper, i, &key);
+        NSString *eventPath = [NSString stringWithUTF8String:key];
+        // Dart may have played the event again since; only the tracked
+        // instance is reclaimed.
+        if ([eventInstances[eventPath] pointerValue] != instance) {
+            continue;
+        }
+        [self recycleInstance:instance forEvent:eventPath];
+        [eventInstances removeObjectForKey:eventPath];
+        [finishedEvents addObject:eventPath];
     }
-    [eventInstances removeAllObjects];
-    
-    // Release FMOD Studio system
-    if (studioSystem != NULL) {
-        FMOD_Studio_System_Release(studioSystem);
-        studioSystem = NULL;
-        coreSystem = NULL;
+}
+
+- (NSArray<NSString *> *)drainFinishedEvents {
+    NSArray<NSString *> *finished = [finishedEvents copy];
+    [finishedEvents removeAllObjects];
+    return finished;
+}
+
+- (void)refreshInstanceStates {
+    fmod_instance_states_begin(instanceStates);
+    for (NSString *path in eventInstances) {
+        fmod_instance_states_add(instanceStates, [path UTF8String],
+                                 [eventInstances[path] pointerValue]);
+    }
+    for (NSNumber *emitterId in emitters) {
+        FmodEmitter *emitter = emitters[emitterId];
+        if (emitter.instance != NULL) {
+            fmod_instance_states_add_emitter(instanceStates, [emitterId intValue],
+                                             emitter.instance);
+        }
     }
-    
-    NSLog(@"FmodBridge: Released FMOD resources");
 }
 
-- (void)logAvailableEvents {
+- (int)createEmitterForEvent:(NSString *)eventPath start:(BOOL)start {
     if (studioSystem == NULL) {
-        return;
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
     }
     
-    // Get bank count
-    int bankCount = 0;
-    FMOD_Studio_System_GetBankCount(studioSystem, &bankCount);
-    
-    if (bankCount == 0) {
-        return;
+    FMOD_STUDIO_EVENTDESCRIPTION *eventDescription = NULL;
+    FMOD_RESULT result = fmod_get_event(studioSystem,
+                                        [eventPath UTF8String],
+                                        &eventDescription);
+    if (result != FMOD_OK) {
+        NSLog(@"FmodBridge: Failed to get event %@: %d - %s",
+              eventPath, result, FMOD_ErrorString(result));
+        return 0;
     }
     
-    NSLog(@"FmodBridge: Available FMOD events:");
+    float minDistance = 0.0f;
+    float maxDistance = 0.0f;
+    FMOD_BOOL is3D = 0;
+    FMOD_Studio_EventDescription_Is3D(eventDescription, &is3D);
+    if (is3D) {
+        FMOD_Studio_EventDescription_GetMinMaxDistance(eventDescription, &minDistance, &maxDistance);
+    }
     
-    // Iterate through banks
-    FMOD_STUDIO_BANK *banks[bankCount];
-    int actualCount = 0;
-    FMOD_Studio_System_GetBankList(studioSystem, banks, bankCount, &actualCount);
+    int emitterId = nextEmitterId;
+    FmodEmitter *emitter = [[FmodEmitter alloc] init];
+    emitter.eventDescription = eventDescription;
+    emitter.maxDistance = maxDistance;
+    emitter.playing = start;
+    FMOD_3D_ATTRIBUTES attributes = {0};
+    attributes.forward.z = 1.0f;
+    attributes.up.y = 1.0f;
+    emitter.attributes = attributes;
     
-    for (int i = 0; i < actualCount; i++) {
-        // Get event count in this bank
-        int eventCount = 0;
-        FMOD_Studio_Bank_GetEventCount(banks[i], &eventCount);
+    if (emitterCulling && start) {
+        // Started on the next update tick if a listener is in range
+        fmod_emitter_culler_add(emitterCuller, emitterId, maxDistance, 0);
+    } else {
+        FMOD_STUDIO_EVENTINSTANCE *eventInstance = NULL;
+        result = FMOD_Studio_EventDescription_CreateInstance(eventDescription, &eventInstance);
+        if (result != FMOD_OK) {
+            NSLog(@"FmodBridge: Failed to create emitter instance for %@: %d - %s",
+                  eventPath, result, FMOD_ErrorString(result));
+            return 0;
+        }
         
-        if (eventCount > 0) {
-            FMOD_STUDIO_EVENTDESCRIPTION *events[eventCount];
-            int actualEventCount = 0;
-            FMOD_Studio_Bank_GetEventList(banks[i], events, eventCount, &actualEventCount);
-            
-            for (int j = 0; j < actualEventCount; j++) {
-                char eventPath[512];
-                FMOD_Studio_EventDescription_GetPath(events[j], eventPath, 512, NULL);
-                NSLog(@"  - %s", eventPath);
+        if (start) {
+            result = FMOD_Studio_EventInstance_Start(eventInstance);
+            if (result != FMOD_OK) {
+                NSLog(@"FmodBridge: Failed to start emitter %@: %d - %s",
+                      eventPath, result, FMOD_ErrorString(result));
+                FMOD_Studio_EventInstance_Release(eventInstance);
+                return 0;
             }
         }
+        emitter.instance = eventInstance;
     }
+    
+    nextEmitterId++;
+    emitters[@(emitterId)] = emitter;
+    return emitterId;
 }
 
+- (BOOL)releaseEmitter:(int)emitterId {
+    FmodEmitter *emitter = emitters[@(emitterId)];
+    if (emitter == nil) {
+        NSLog(@"FmodBridge: No emitter found with id %d", emitterId);
+        return NO;
+    }
+    
+    [self deactivateEmitter:emitter];
+    fmod_emitter_culler_remove(emitterCuller, emitterId);
+    [emitters removeObjectForKey:@(emitterId)];
+    return YES;
+}
 
-- (BOOL)setMasterPaused:(BOOL)paused {
+- (BOOL)updateSpatialWithListeners:(const float *)listeners
+                     listenerCount:(int)count
+                        emitterIds:(const int32_t *_Nullable)emitterIds
+                 emitterAttributes:(const float *_Nullable)emitterAttributes
+                      emitterCount:(int)emitterCount {
     if (studioSystem == NULL) {
         NSLog(@"FmodBridge: Studio system not initialized");
         return NO;
     }
     
-    FMOD_STUDIO_BUS *masterBus = NULL;
-    FMOD_RESULT result = FMOD_Studio_System_GetBus(studioSystem, "bus:/", &masterBus);
-    
-    if (result != FMOD_OK || masterBus == NULL) {
-        NSLog(@"FmodBridge: Failed to get master bus: %d - %s", 
-              result, FMOD_ErrorString(result));
+    if (count < 1 || count > FMOD_MAX_LISTENERS) {
+        NSLog(@"FmodBridge: Invalid listener count %d", count);
         return NO;
     }
     
-    result = FMOD_Studio_Bus_SetPaused(masterBus, paused ? 1 : 0);
+    if (count != listenerCount) {
+        FMOD_Studio_System_SetNumListeners(studioSystem, count);
+        listenerCount = count;
+    }
+    
+    FMOD_3D_ATTRIBUTES attributes;
+    for (int i = 0; i < count; i++) {
+        memcpy(&attributes, listeners + i * kSpatialFloatsPerEntity, sizeof(attributes));
+        FMOD_Studio_System_SetListenerAttributes(studioSystem, i, &attributes, NULL);
+        listenerPositions[i * 3] = attributes.position.x;
+        listenerPositions[i * 3 + 1] = attributes.position.y;
+        listenerPositions[i * 3 + 2] = attributes.position.z;
+    }
+    
+    for (int i = 0; i < emitterCount; i++) {
+        FmodEmitter *emitter = emitters[@(emitterIds[i])];
+        if (emitter == nil) {
+            continue;
+        }
+        memcpy(&attributes, emitterAttributes + i * kSpatialFloatsPerEntity, sizeof(attributes));
+        emitter.attributes = attributes;
+        if (emitterCulling && emitter.playing) {
+            fmod_emitter_culler_move(emitterCuller, emitterIds[i], attributes.position.x,
+                                     attributes.position.y, attributes.position.z);
+        }
+        if (emitter.instance != NULL) {
+            FMOD_Studio_EventInstance_Set3DAttributes(emitter.instance, &attributes);
+        }
+    }
+    
+    return YES;
+}
+
+- (void)setEmitterCulling:(BOOL)enabled hysteresis:(float)hysteresis {
+    fmod_emitter_culler_set_hysteresis(emitterCuller, hysteresis);
+    if (emitterCulling == enabled) {
+        return;
+    }
+    emitterCulling = enabled;
+    
+    for (NSNumber *key in emitters) {
+        FmodEmitter *emitter = emitters[key];
+        if (!emitter.playing) {
+            continue;
+        }
+        if (enabled) {
+            fmod_emitter_culler_add(emitterCuller, key.intValue, emitter.maxDistance,
+                                    emitter.instance != NULL);
+            FMOD_3D_ATTRIBUTES attributes = emitter.attributes;
+            fmod_emitter_culler_move(emitterCuller, key.intValue, attributes.position.x,
+                                     attributes.position.y, attributes.position.z);
+        } else {
+            // Bring back everything that was culled
+            [self activateEmitter:emitter emitterId:key.intValue];
+        }
+    }
+    if (!enabled) {
+        fmod_emitter_culler_clear(emitterCuller);
+    }
+    
+    NSLog(@"FmodBridge: Emitter culling %@", enabled ? @"enabled" : @"disabled");
+}
+
+- (BOOL)activateEmitter:(FmodEmitter *)emitter emitterId:(int)emitterId {
+    if (emitter.instance != NULL) {
+        return YES;
+    }
     
+    FMOD_STUDIO_EVENTINSTANCE *eventInstance = NULL;
+    FMOD_RESULT result = FMOD_Studio_EventDescription_CreateInstance(emitter.eventDescription,
+                                                                     &eventInstance);
     if (result != FMOD_OK) {
-        NSLog(@"FmodBridge: Failed to set master paused state: %d - %s", 
-              result, FMOD_ErrorString(result));
+        NSLog(@"FmodBridge: Failed to create instance for emitter %d: %d - %s",
+              emitterId, result, FMOD_ErrorString(result));
         return NO;
     }
     
-    NSLog(@"FmodBridge: Master bus paused = %@", paused ? @"YES" : @"NO");
+    FMOD_3D_ATTRIBUTES attributes = emitter.attributes;
+    FMOD_Studio_EventInstance_Set3DAttributes(eventInstance, &attributes);
+    FMOD_Studio_EventInstance_Start(eventInstance);
+    emitter.instance = eventInstance;
+    return YES;
+}
+
+- (void)deactivateEmitter:(FmodEmitter *)emitter {
+    if (emitter.instance == NULL) {
+        return;
+    }
+    FMOD_Studio_EventInstance_Stop(emitter.instance, FMOD_STUDIO_STOP_ALLOWFADEOUT);
+    FMOD_Studio_EventInstance_Release(emitter.instance);
+    emitter.instance = NULL;
+}
+
+- (int)addEffectToBus:(NSString *)busPath
+                 type:(int)type
+     parameterIndices:(const int32_t *)parameterIndices
+      parameterValues:(const float *)parameterValues
+       parameterCount:(int)parameterCount {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
+    
+    int effectId = fmod_bus_effects_add(busEffects, studioSystem, [busPath UTF8String], type,
+                                        parameterIndices, parameterValues, parameterCount);
+    if (effectId == 0) {
+        FMOD_RESULT result = fmod_bus_effects_last_result(busEffects);
+        NSLog(@"FmodBridge: Failed to add effect to bus %@: %d - %s",
+              busPath, result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    NSLog(@"FmodBridge: Added effect %d to bus %@ (%s kernels)",
+          effectId, busPath, fmod_bus_effects_kernel_name());
+    return effectId;
+}
+
+- (BOOL)removeBusEffect:(int)effectId {
+    if (!fmod_bus_effects_remove(busEffects, effectId)) {
+        NSLog(@"FmodBridge: No bus effect found with id %d", effectId);
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)setBusEffectParameter:(int)effectId index:(int)index value:(float)value {
+    if (!fmod_bus_effects_set_parameter(busEffects, effectId, index, value)) {
+        FMOD_RESULT result = fmod_bus_effects_last_result(busEffects);
+        NSLog(@"FmodBridge: Failed to set parameter %d on bus effect %d: %d - %s",
+              index, effectId, result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (int)addSpectrumAnalyzer:(NSString *)target bands:(int)bands windowSize:(int)windowSize {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
+    
+    int analyzerId = 0;
+    if ([target hasPrefix:@"bus:/"]) {
+        analyzerId = fmod_spectrum_analyzers_add_to_bus(spectrumAnalyzers, studioSystem,
+                                                        [target UTF8String], bands, windowSize);
+    } else {
+        NSValue *instanceValue = eventInstances[target];
+        if (instanceValue == nil) {
+            NSLog(@"FmodBridge: No instance found for %@", target);
+            return 0;
+        }
+        analyzerId = fmod_spectrum_analyzers_add_to_instance(spectrumAnalyzers, studioSystem,
+                                                             [instanceValue pointerValue],
+                                                             bands, windowSize);
+    }
+    
+    if (analyzerId == 0) {
+        FMOD_RESULT result = fmod_spectrum_analyzers_last_result(spectrumAnalyzers);
+        NSLog(@"FmodBridge: Failed to add spectrum analyzer to %@: %d - %s",
+              target, result, FMOD_ErrorString(result));
+    }
+    return analyzerId;
+}
+
+- (BOOL)removeSpectrumAnalyzer:(int)analyzerId {
+    if (!fmod_spectrum_analyzers_remove(spectrumAnalyzers, analyzerId)) {
+        NSLog(@"FmodBridge: No spectrum analyzer found with id %d", analyzerId);
+        return NO;
+    }
     return YES;
 }
 
+// Starts emitters that came into range and releases those that left it
+- (void)processEmitterCulling {
+    if (!emitterCulling || emitters.count == 0) {
+        return;
+    }
+    
+    fmod_emitter_culler_evaluate(emitterCuller, listenerPositions, listenerCount);
+    
+    int count = 0;
+    const int *deactivated = fmod_emitter_culler_deactivated(emitterCuller, &count);
+    for (int i = 0; i < count; i++) {
+        FmodEmitter *emitter = emitters[@(deactivated[i])];
+        if (emitter != nil) {
+            [self deactivateEmitter:emitter];
+        }
+    }
+    
+    const int *activated = fmod_emitter_culler_activated(emitterCuller, &count);
+    for (int i = 0; i < count; i++) {
+        FmodEmitter *emitter = emitters[@(activated[i])];
+        if (emitter != nil) {
+            [self activateEmitter:emitter emitterId:activated[i]];
+        }
+    }
+}
+
+- (int)scheduleAtBeatForEvent:(NSString *)eventPath
+                          bar:(int)bar
+                         beat:(int)beat
+                   startEvent:(nullable NSString *)startEventPath {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
+    
+    FmodBeatSchedule *schedule = [[FmodBeatSchedule alloc] init];
+    schedule.eventPath = eventPath;
+    schedule.bar = bar;
+    schedule.beat = beat;
+    schedule.startEventPath = startEventPath;
+    
+    @synchronized (beatStates) {
+        schedule.scheduleId = nextBeatScheduleId++;
+        [beatSchedules addObject:schedule];
+    }
+    
+    NSLog(@"FmodBridge: Scheduled beat %d.%d on %@ (id %d)", bar, beat, eventPath, schedule.scheduleId);
+    return schedule.scheduleId;
+}
+
+- (BOOL)cancelBeatSchedule:(int)scheduleId {
+    @synchronized (beatStates) {
+        for (NSUInteger i = 0; i < beatSchedules.count; i++) {
+            if (beatSchedules[i].scheduleId == scheduleId) {
+                [beatSchedules removeObjectAtIndex:i];
+                return YES;
+            }
+        }
+    }
+    return NO;
+}
+
+- (NSArray<NSDictionary<NSString *, NSNumber *> *> *)drainFiredBeatSchedules {
+    @synchronized (beatStates) {
+        NSArray *fired = [firedBeatSchedules copy];
+        [firedBeatSchedules removeAllObjects];
+        return fired;
+    }
+}
+
+- (void)handleBeatCallback:(FMOD_STUDIO_EVENT_CALLBACK_TYPE)type
+                  instance:(FMOD_STUDIO_EVENTINSTANCE *)instance
+                parameters:(void *)parameters {
+    NSValue *key = [NSValue valueWithPointer:instance];
+    
+    @synchronized (beatStates) {
+        if (type == FMOD_STUDIO_EVENT_CALLBACK_DESTROYED) {
+            [beatStates removeObjectForKey:key];
+            return;
+        }
+        
+        FMOD_STUDIO_TIMELINE_BEAT_PROPERTIES *props = parameters;
+        FmodBeatState state = {
+            props->bar, props->beat, props->timesignatureupper,
+            props->tempo, props->position, NO, 0
+        };
+        beatStates[key] = [NSValue valueWithBytes:&state objCType:@encode(FmodBeatState)];
+    }
+}
+
+// Reads the current mixer DSP clock and output sample rate.
+- (BOOL)getMixerClock:(unsigned long long *)clock sampleRate:(int *)sampleRate {
+    if (coreSystem == NULL) {
+        return NO;
+    }
+    
+    FMOD_CHANNELGROUP *masterGroup = NULL;
+    if (FMOD_System_GetMasterChannelGroup(coreSystem, &masterGroup) != FMOD_OK ||
+        FMOD_ChannelGroup_GetDSPClock(masterGroup, clock, NULL) != FMOD_OK) {
+        return NO;
+    }
+    
+    return FMOD_System_GetSoftwareFormat(coreSystem, sampleRate, NULL, NULL) == FMOD_OK;
+}
+
+// Anchors new beats to the DSP clock and arms any schedule whose target beat
+// falls within the lookahead window. Called once per update tick.
+- (void)processBeatSchedules {
+    NSMutableArray<FmodBeatSchedule *> *armed = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *armedClocks = [NSMutableArray array];
+    
+    @synchronized (beatStates) {
+        if (beatSchedules.count == 0) {
+            return;
+        }
+        
+        unsigned long long now = 0;
+        int sampleRate = 0;
+        if (![self getMixerClock:&now sampleRate:&sampleRate] || sampleRate <= 0) {
+            return;
+        }
+        
+        long long lookahead = (long long)sampleRate * kBeatScheduleLookaheadMs / 1000;
+        
+        for (FmodBeatSchedule *schedule in [beatSchedules copy]) {
+            NSValue *instanceValue = eventInstances[schedule.eventPath];
+            if (instanceValue == nil) {
+                continue;
+            }
+            
+            NSValue *stateValue = beatStates[instanceValue];
+            if (stateValue == nil) {
+                continue;
+            }
+            
+            FmodBeatState state;
+            [stateValue getValue:&state];
+            if (state.tempo <= 0.0f) {
+                continue;
+            }
+            
+            if (!state.anchored) {
+                // Place the beat on the DSP clock by how far the timeline has
+                // moved past it since the callback fired
+                int timelinePosition = state.position;
+                FMOD_Studio_EventInstance_GetTimelinePosition([instanceValue pointerValue],
+                                                              &timelinePosition);
+                long long sinceBeat = (long long)(timelinePosition - state.position) * sampleRate / 1000;
+                state.anchorClock = now - (sinceBeat > 0 ? sinceBeat : 0);
+                state.anchored = YES;
+                beatStates[instanceValue] = [NSValue valueWithBytes:&state
+                                                           objCType:@encode(FmodBeatState)];
+            }
+            
+            // A beat already behind now lands on now and fires at once.
+            unsigned long long target = fmod_beat_target_clock(
+                state.anchorClock, state.bar, state.beat, state.beatsPerBar,
+                state.tempo, sampleRate, schedule.bar, schedule.beat, now);
+            if (target - now > (unsigned long long)lookahead) {
+                continue;
+            }
+            
+            [firedBeatSchedules addObject:@{
+                @"id": @(schedule.scheduleId),
+                @"bar": @(schedule.bar),
+                @"beat": @(schedule.beat),
+                @"dspClock": @(target),
+            }];
+            [armed addObject:schedule];
+            [armedClocks addObject:@(target)];
+            [beatSchedules removeObject:schedule];
+        }
+    }
+    
+    // Started outside the lock: flushing waits on the Studio thread, which
+    // takes the lock when delivering callbacks
+    for (NSUInteger i = 0; i < armed.count; i++) {
+        if (armed[i].startEventPath != nil) {
+            [self startEvent:armed[i].startEventPath
+                  atDSPClock:[armedClocks[i] unsignedLongLongValue]];
+        }
+    }
+}
+
+- (void)releaseFmod {
+    // Stop and release all event instances
+    for (NSString *key in eventInstances) {
+        FMOD_STUDIO_EVENTINSTANCE *instance = [eventInstances[key] pointerValue];
+        FMOD_Studio_EventInstance_Stop(instance, FMOD_STUDIO_STOP_IMMEDIATE);
+        FMOD_Studio_EventInstance_Release(instance);
+    }
+    [eventInstances removeAllObjects];
+    
+    // Stop and release all emitters
+    for (NSNumber *key in emitters) {
+        FMOD_STUDIO_EVENTINSTANCE *instance = emitters[key].instance;
+        if (instance != NULL) {
+            FMOD_Studio_EventInstance_Stop(instance, FMOD_STUDIO_STOP_IMMEDIATE);
+            FMOD_Studio_EventInstance_Release(instance);
+        }
+    }
+    [emitters removeAllObjects];
+    fmod_emitter_culler_clear(emitterCuller);
+    listenerCount = 1;
+    
+    @synchronized (beatStates) {
+        [beatSchedules removeAllObjects];
+        [firedBeatSchedules removeAllObjects];
+    }
+    
+    fmod_bus_effects_clear(busEffects);
+    fmod_sound_library_clear(soundLibrary);
+    fmod_pcm_streams_clear(pcmStreams);
+    fmod_mic_capture_clear(micCapture);
+    fmod_voice_stats_clear(voiceStats);
+    fmod_instance_states_clear(instanceStates);
+    fmod_instance_sweeper_clear(instanceSweeper);
+    [finishedEvents removeAllObjects];
+    fmod_deferred_writes_clear(deferredWrites);
+    fmod_spectrum_analyzers_clear(spectrumAnalyzers);
+    fmod_mixer_control_clear(mixerControl);
+    fmod_parameter_automation_clear(parameterAutomation);
+    lastUpdateTime = 0;
+    fmod_global_parameters_clear(globalParameters);
+    fmod_instance_pool_clear(instancePool);
+    
+    // Release FMOD Studio system
+    if (studioSystem != NULL) {
+        fmod_mixer_lifecycle_resume(mixerLifecycle, coreSystem, studioSystem,
+                                    FMOD_FLUTTER_SUSPEND_ALL);
+        fmod_mixer_lifecycle_clear(mixerLifecycle);
+        fmod_audio_interruption_clear(audioInterruption);
+        FMOD_Studio_System_Release(studioSystem);
+        studioSystem = NULL;
+        coreSystem = NULL;
+        fmod_offline_output_clear(offlineOutput);
+    }
+    
+    @synchronized (beatStates) {
+        [beatStates removeAllObjects];
+    }
+    
+    NSLog(@"FmodBridge: Released FMOD resources");
+}
+
+- (void)logAvailableEvents {
+    if (studioSystem == NULL) {
+        return;
+    }
+    
+    // Get bank count
+    int bankCount = 0;
+    FMOD_Studio_System_GetBankCount(studioSystem, &bankCount);
+    
+    if (bankCount == 0) {
+        return;
+    }
+    
+    NSLog(@"FmodBridge: Available FMOD events:");
+    
+    // Iterate through banks
+    FMOD_STUDIO_BANK *banks[bankCount];
+    int actualCount = 0;
+    FMOD_Studio_System_GetBankList(studioSystem, banks, bankCount, &actualCount);
+    
+    for (int i = 0; i < actualCount; i++) {
+        // Get event count in this bank
+        int eventCount = 0;
+        FMOD_Studio_Bank_GetEventCount(banks[i], &eventCount);
+        
+        if (eventCount > 0) {
+            FMOD_STUDIO_EVENTDESCRIPTION *events[eventCount];
+            int actualEventCount = 0;
+            FMOD_Studio_Bank_GetEventList(banks[i], events, eventCount, &actualEventCount);
+            
+            for (int j = 0; j < actualEventCount; j++) {
+                char eventPath[512];
+                FMOD_Studio_EventDescription_GetPath(events[j], eventPath, 512, NULL);
+                NSLog(@"  - %s", eventPath);
+            }
+        }
+    }
+}
+
+
+- (BOOL)setMasterPaused:(BOOL)paused {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_mixer_control_set_bus_paused(mixerControl, studioSystem, "bus:/", paused ? 1 : 0)) {
+        [self logMixerFailure:@"set paused state of" path:@"bus:/"];
+        return NO;
+    }
+    
+    NSLog(@"FmodBridge: Master bus paused = %@", paused ? @"YES" : @"NO");
+    return YES;
+}
+
+- (BOOL)setBusVolume:(NSString *)busPath volume:(float)volume rampMs:(int)rampMs {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_mixer_control_set_bus_volume(mixerControl, studioSystem, [busPath UTF8String],
+                                           volume, rampMs / 1000.0f)) {
+        [self logMixerFailure:@"set volume of" path:busPath];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)setVcaVolume:(NSString *)vcaPath volume:(float)volume rampMs:(int)rampMs {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_mixer_control_set_vca_volume(mixerControl, studioSystem, [vcaPath UTF8String],
+                                           volume, rampMs / 1000.0f)) {
+        [self logMixerFailure:@"set volume of" path:vcaPath];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)setBusMute:(NSString *)busPath muted:(BOOL)muted {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_mixer_control_set_bus_mute(mixerControl, studioSystem, [busPath UTF8String],
+                                         muted ? 1 : 0)) {
+        [self logMixerFailure:@"set mute state of" path:busPath];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)setBusPaused:(NSString *)busPath paused:(BOOL)paused {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_mixer_control_set_bus_paused(mixerControl, studioSystem, [busPath UTF8String],
+                                           paused ? 1 : 0)) {
+        [self logMixerFailure:@"set paused state of" path:busPath];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)startSnapshot:(NSString *)snapshotPath {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_mixer_control_start_snapshot(mixerControl, studioSystem, [snapshotPath UTF8String])) {
+        [self logMixerFailure:@"start snapshot" path:snapshotPath];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)stopSnapshot:(NSString *)snapshotPath allowFadeOut:(BOOL)allowFadeOut {
+    if (!fmod_mixer_control_stop_snapshot(mixerControl, [snapshotPath UTF8String],
+                                          allowFadeOut ? 1 : 0)) {
+        NSLog(@"FmodBridge: Snapshot not active: %@", snapshotPath);
+        return NO;
+    }
+    return YES;
+}
+
+- (int)automateParameterForEvent:(NSString *)eventPath
+                       paramName:(NSString *)paramName
+                            type:(int)type
+                            data:(const float *)data
+                       dataCount:(int)dataCount {
+    NSValue *instanceValue = eventInstances[eventPath];
+    if (instanceValue == nil) {
+        NSLog(@"FmodBridge: No instance found for %@", eventPath);
+        return 0;
+    }
+    
+    // The curve starts from the parameter's latest value.
+    fmod_deferred_writes_flush(deferredWrites);
+    int automationId = fmod_parameter_automation_add(parameterAutomation,
+                                                     [instanceValue pointerValue],
+                                                     [paramName UTF8String],
+                                                     type, data, dataCount);
+    if (automationId == 0) {
+        FMOD_RESULT result = fmod_parameter_automation_last_result(parameterAutomation);
+        NSLog(@"FmodBridge: Failed to automate parameter %@ on %@: %d - %s",
+              paramName, eventPath, result, FMOD_ErrorString(result));
+    }
+    return automationId;
+}
+
+- (BOOL)releaseAutomation:(int)automationId {
+    if (!fmod_parameter_automation_release(parameterAutomation, automationId)) {
+        NSLog(@"FmodBridge: No envelope automation found with id %d", automationId);
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)cancelAutomation:(int)automationId {
+    return fmod_parameter_automation_cancel(parameterAutomation, automationId) != 0;
+}
+
+- (BOOL)setGlobalParameter:(NSString *)name value:(float)value {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_global_parameters_set(globalParameters, studioSystem, [name UTF8String], value)) {
+        FMOD_RESULT result = fmod_global_parameters_last_result(globalParameters);
+        NSLog(@"FmodBridge: Failed to set global parameter %@: %d - %s",
+              name, result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (NSNumber *)globalParameterValue:(NSString *)name {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return nil;
+    }
+    
+    float value = 0.0f;
+    if (!fmod_global_parameters_get(globalParameters, studioSystem, [name UTF8String], &value)) {
+        FMOD_RESULT result = fmod_global_parameters_last_result(globalParameters);
+        NSLog(@"FmodBridge: Failed to get global parameter %@: %d - %s",
+              name, result, FMOD_ErrorString(result));
+        return nil;
+    }
+    return @(value);
+}
+
+- (NSData *)resolveGlobalParameters:(NSArray<NSString *> *)names {
+    NSMutableData *slots = [NSMutableData dataWithLength:names.count * sizeof(int32_t)];
+    int32_t *slotData = slots.mutableBytes;
+    for (NSUInteger i = 0; i < names.count; i++) {
+        slotData[i] = -1;
+        if (studioSystem == NULL) {
+            continue;
+        }
+        slotData[i] = fmod_global_parameters_resolve(globalParameters, studioSystem,
+                                                     [names[i] UTF8String]);
+        if (slotData[i] < 0) {
+            NSLog(@"FmodBridge: No global parameter named %@", names[i]);
+        }
+    }
+    return slots;
+}
+
+- (BOOL)setGlobalParametersWithSlots:(const int32_t *)slots
+                              values:(const float *)values
+                               count:(int)count {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_global_parameters_set_batch(globalParameters, studioSystem, slots, values, count)) {
+        FMOD_RESULT result = fmod_global_parameters_last_result(globalParameters);
+        NSLog(@"FmodBridge: Failed to set global parameters: %d - %s",
+              result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)suspendMixer {
+    if (coreSystem == NULL) {
+        return NO;
+    }
+    
+    if (!fmod_mixer_lifecycle_suspend(mixerLifecycle, coreSystem, FMOD_FLUTTER_SUSPEND_LIFECYCLE)) {
+        FMOD_RESULT result = fmod_mixer_lifecycle_last_result(mixerLifecycle);
+        NSLog(@"FmodBridge: Failed to suspend mixer: %d - %s",
+              result, FMOD_ErrorString(result));
+        return NO;
+    }
+    NSLog(@"FmodBridge: Mixer suspended");
+    return YES;
+}
+
+- (BOOL)resumeMixer {
+    if (coreSystem == NULL) {
+        return NO;
+    }
+    
+    BOOL wasSuspended = fmod_mixer_lifecycle_suspended(mixerLifecycle) != 0;
+    if (!fmod_mixer_lifecycle_resume(mixerLifecycle, coreSystem, studioSystem,
+                                     FMOD_FLUTTER_SUSPEND_LIFECYCLE)) {
+        FMOD_RESULT result = fmod_mixer_lifecycle_last_result(mixerLifecycle);
+        NSLog(@"FmodBridge: Failed to resume mixer: %d - %s",
+              result, FMOD_ErrorString(result));
+        return NO;
+    }
+    if (wasSuspended && !fmod_mixer_lifecycle_suspended(mixerLifecycle)) {
+        NSLog(@"FmodBridge: Mixer resumed in %.2f ms",
+              fmod_mixer_lifecycle_last_resume_ms(mixerLifecycle));
+    }
+    return YES;
+}
+
+- (double)lastMixerResumeMs {
+    return fmod_mixer_lifecycle_last_resume_ms(mixerLifecycle);
+}
+
+- (BOOL)isMixerSuspended {
+    return fmod_mixer_lifecycle_suspended(mixerLifecycle) != 0;
+}
+
+- (BOOL)isNonRealtime {
+    return fmod_offline_output_non_realtime(offlineOutput) != 0;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)renderOffline:(double)seconds {
+    if (!studioSystem) {
+        NSLog(@"FmodBridge: FMOD Studio System not initialized");
+        return nil;
+    }
+    
+    fmod_deferred_writes_flush(deferredWrites);
+    if (!fmod_offline_output_render(offlineOutput, studioSystem, coreSystem,
+                                    (float)seconds, FmodBridgeRenderBlockCallback,
+                                    (__bridge void *)self)) {
+        FMOD_RESULT result = fmod_offline_output_last_result(offlineOutput);
+        NSLog(@"FmodBridge: Failed to render %.2f s: %d - %s",
+              seconds, result, FMOD_ErrorString(result));
+        return nil;
+    }
+    return @{
+        @"renderedSeconds": @(fmod_offline_output_last_rendered_seconds(offlineOutput)),
+        @"renderMs": @(fmod_offline_output_last_render_ms(offlineOutput)),
+    };
+}
+
+- (NSDictionary<NSString *, id> *)takeRenderedAudio {
+    if (fmod_offline_output_mode(offlineOutput) != FMOD_FLUTTER_OUTPUT_MEMORY_NRT) {
+        return nil;
+    }
+    
+    int count = fmod_offline_output_captured_sample_count(offlineOutput);
+    NSMutableData *samples = [NSMutableData dataWithLength:count * sizeof(float)];
+    fmod_offline_output_take_captured(offlineOutput, samples.mutableBytes, count);
+    return @{
+        @"sampleRate": @(fmod_offline_output_sample_rate(offlineOutput)),
+        @"channels": @(fmod_offline_output_channels(offlineOutput)),
+        @"samples": samples,
+    };
+}
+
+- (int)loadSoundAtPath:(NSString *)path stream:(BOOL)stream {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
+    
+    int soundId = fmod_sound_library_load(soundLibrary, studioSystem,
+                                          [path fileSystemRepresentation], stream);
+    if (soundId == 0) {
+        FMOD_RESULT result = fmod_sound_library_last_result(soundLibrary);
+        NSLog(@"FmodBridge: Failed to load sound %@: %d - %s",
+              path, result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    NSLog(@"FmodBridge: Loaded sound %d from %@ (%s .fca kernels)",
+          soundId, path, fmod_sound_library_kernel_name());
+    return soundId;
+}
+
+- (BOOL)playSound:(int)soundId volume:(float)volume {
+    if (!fmod_sound_library_play(soundLibrary, soundId, volume)) {
+        FMOD_RESULT result = fmod_sound_library_last_result(soundLibrary);
+        NSLog(@"FmodBridge: Failed to play sound %d: %d - %s",
+              soundId, result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)unloadSound:(int)soundId {
+    if (!fmod_sound_library_unload(soundLibrary, soundId)) {
+        NSLog(@"FmodBridge: No sound found with id %d", soundId);
+        return NO;
+    }
+    return YES;
+}
+
+- (int)createPcmSoundWithBuffer:(int)bufferId
+                     sampleRate:(int)sampleRate
+                       channels:(int)channels
+                         format:(int)format {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
+    
+    int soundId = fmod_sound_library_load_pcm(soundLibrary, studioSystem, bufferId,
+                                              sampleRate, channels, format);
+    if (soundId == 0) {
+        FMOD_RESULT result = fmod_sound_library_last_result(soundLibrary);
+        NSLog(@"FmodBridge: Failed to create sound from PCM buffer %d: %d - %s",
+              bufferId, result, FMOD_ErrorString(result));
+        return 0;
+    }
+    return soundId;
+}
+
+- (BOOL)playEvent:(NSString *)eventPath
+    withPcmBuffer:(int)bufferId
+       sampleRate:(int)sampleRate
+         channels:(int)channels
+           format:(int)format {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    FMOD_RESULT result = fmod_pcm_sounds_start_programmer_event(
+        studioSystem, [eventPath UTF8String], bufferId, sampleRate, channels, format);
+    if (result != FMOD_OK) {
+        NSLog(@"FmodBridge: Failed to play %@ with PCM buffer %d: %d - %s",
+              eventPath, bufferId, result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (int)createPcmStreamWithSampleRate:(int)sampleRate
+                            channels:(int)channels
+                          capacityMs:(int)capacityMs {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return 0;
+    }
+    
+    int streamId = fmod_pcm_streams_create_stream(pcmStreams, studioSystem,
+                                                  sampleRate, channels, capacityMs);
+    if (streamId == 0) {
+        FMOD_RESULT result = fmod_pcm_streams_last_result(pcmStreams);
+        NSLog(@"FmodBridge: Failed to create PCM stream: %d - %s",
+              result, FMOD_ErrorString(result));
+        return 0;
+    }
+    
+    NSLog(@"FmodBridge: Created PCM stream %d (%d Hz, %d channels)",
+          streamId, sampleRate, channels);
+    return streamId;
+}
+
+- (BOOL)releasePcmStream:(int)streamId {
+    if (!fmod_pcm_streams_destroy_stream(pcmStreams, streamId)) {
+        NSLog(@"FmodBridge: No PCM stream found with id %d", streamId);
+        return NO;
+    }
+    return YES;
+}
+
+- (nullable NSDictionary<NSString *, NSNumber *> *)pcmStreamStats:(int)streamId {
+    FmodPcmStreamStats stats;
+    if (!fmod_pcm_streams_get_stats(pcmStreams, streamId, &stats)) {
+        return nil;
+    }
+    return @{
+        @"sampleRate": @(stats.sample_rate),
+        @"channels": @(stats.channels),
+        @"capacityFrames": @(stats.capacity_frames),
+        @"queuedFrames": @(stats.queued_frames),
+        @"underruns": @(stats.underruns),
+        @"underrunFrames": @(stats.underrun_frames),
+        @"droppedFrames": @(stats.dropped_frames),
+        @"latencyUs": @(stats.latency_us)
+    };
+}
+
+- (BOOL)startRecordingFromDriver:(int)driver
+                         monitor:(BOOL)monitor
+                       latencyMs:(int)latencyMs {
+    if (coreSystem == NULL) {
+        NSLog(@"FmodBridge: Core system not initialized");
+        return NO;
+    }
+    
+    // Ambient cannot record; switch for as long as the recording runs
+    NSError *error = nil;
+    [[AVAudioSession sharedInstance]
+        setCategory:AVAudioSessionCategoryPlayAndRecord
+        withOptions:AVAudioSessionCategoryOptionMixWithOthers |
+                    AVAudioSessionCategoryOptionDefaultToSpeaker |
+                    AVAudioSessionCategoryOptionAllowBluetooth
+              error:&error];
+    if (error) {
+        NSLog(@"FmodBridge: Failed to set audio session category: %@", error);
+        return NO;
+    }
+    
+    if (!fmod_mic_capture_start(micCapture, coreSystem, driver, monitor ? 1 : 0,
+                                latencyMs)) {
+        FMOD_RESULT result = fmod_mic_capture_last_result(micCapture);
+        NSLog(@"FmodBridge: Failed to start recording from driver %d: %d - %s",
+              driver, result, FMOD_ErrorString(result));
+        [self restoreAmbientSession];
+        return NO;
+    }
+    
+    NSLog(@"FmodBridge: Recording from driver %d%@", driver,
+          monitor ? @" with monitoring" : @"");
+    return YES;
+}
+
+- (BOOL)stopRecording {
+    BOOL stopped = fmod_mic_capture_stop(micCapture) != 0;
+    if (stopped) {
+        [self restoreAmbientSession];
+    }
+    return stopped;
+}
+
+- (void)restoreAmbientSession {
+    NSError *error = nil;
+    [[AVAudioSession sharedInstance]
+        setCategory:AVAudioSessionCategoryAmbient error:&error];
+    if (error) {
+        NSLog(@"FmodBridge: Failed to set audio session category: %@", error);
+    }
+}
+
+- (nullable NSDictionary<NSString *, NSNumber *> *)recordingStats {
+    FmodMicStats stats;
+    if (!fmod_mic_capture_get_stats(micCapture, &stats)) {
+        return nil;
+    }
+    return @{
+        @"recording": @(stats.recording != 0),
+        @"monitoring": @(stats.monitoring != 0),
+        @"sampleRate": @(stats.sample_rate),
+        @"channels": @(stats.channels),
+        @"recordedFrames": @(stats.recorded_frames),
+        @"droppedSamples": @(stats.dropped_samples),
+        @"monitorLatencyUs": @(stats.monitor_latency_us),
+        @"targetLatencyUs": @(stats.target_latency_us)
+    };
+}
+
+- (BOOL)startVoiceStatsWithWindowMs:(int)windowMs {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_voice_stats_start(voiceStats, studioSystem, windowMs)) {
+        FMOD_RESULT result = fmod_voice_stats_last_result(voiceStats);
+        NSLog(@"FmodBridge: Failed to start voice stats: %d - %s",
+              result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (void)stopVoiceStats {
+    fmod_voice_stats_stop(voiceStats);
+}
+
+- (NSDictionary<NSString *, NSArray *> *)voiceStats {
+    FmodVoiceStatsWindow windows[FMOD_FLUTTER_VOICE_STATS_WINDOWS];
+    int windowCount = fmod_voice_stats_get_windows(
+        voiceStats, windows, FMOD_FLUTTER_VOICE_STATS_WINDOWS);
+    NSMutableArray *windowList = [NSMutableArray arrayWithCapacity:windowCount];
+    for (int i = 0; i < windowCount; i++) {
+        const FmodVoiceStatsWindow *w = &windows[i];
+        [windowList addObject:@{
+            @"endUs": @(w->end_us),
+            @"durationUs": @(w->duration_us),
+            @"samples": @(w->samples),
+            @"maxChannels": @(w->max_channels),
+            @"softwareChannels": @(w->software_channels),
+            @"realPeak": @(w->real_peak),
+            @"virtualPeak": @(w->virtual_peak),
+            @"saturatedSamples": @(w->saturated_samples),
+            @"realSum": @(w->real_sum),
+            @"virtualSum": @(w->virtual_sum),
+            @"starts": @(w->starts),
+            @"startFailures": @(w->start_failures),
+            @"virtualizations": @(w->virtualizations)
+        }];
+    }
+    
+    int eventCount = fmod_voice_stats_event_count(voiceStats);
+    NSMutableArray *eventList = [NSMutableArray arrayWithCapacity:eventCount];
+    for (int i = 0; i < eventCount; i++) {
+        FmodEventVoiceStats stats;
+        const char *path = fmod_voice_stats_get_event(voiceStats, i, &stats);
+        [eventList addObject:@{
+            @"path": [NSString stringWithUTF8String:path],
+            @"instances": @(stats.instances),
+            @"peakInstances": @(stats.peak_instances),
+            @"starts": @(stats.starts),
+            @"startFailures": @(stats.start_failures),
+            @"virtualizations": @(stats.virtualizations)
+        }];
+    }
+    return @{@"windows": windowList, @"events": eventList};
+}
+
+- (NSDictionary<NSString *, id> *)queryInstances {
+    int count = fmod_instance_states_count(instanceStates);
+    NSData *states = [NSData dataWithBytes:fmod_instance_states_data(instanceStates)
+                                    length:count * sizeof(FmodInstanceState)];
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:count];
+    for (int i = 0; i < count; i++) {
+        [keys addObject:[NSString stringWithUTF8String:
+                            fmod_instance_states_key(instanceStates, i)]];
+    }
+    return @{@"states": states, @"keys": keys};
+}
+
+- (BOOL)startCommandCaptureToPath:(NSString *)path
+                 flushEachCommand:(BOOL)flushEachCommand {
+    if (!studioSystem) {
+        NSLog(@"FmodBridge: FMOD Studio System not initialized");
+        return NO;
+    }
+    
+    FMOD_RESULT result = FMOD_Studio_System_StartCommandCapture(
+        studioSystem, [path UTF8String],
+        flushEachCommand ? FMOD_STUDIO_COMMANDCAPTURE_FILEFLUSH
+                         : FMOD_STUDIO_COMMANDCAPTURE_NORMAL);
+    if (result != FMOD_OK) {
+        NSLog(@"FmodBridge: Failed to start command capture: %d - %s",
+              result, FMOD_ErrorString(result));
+        return NO;
+    }
+    NSLog(@"FmodBridge: Capturing commands to %@", path);
+    return YES;
+}
+
+- (BOOL)stopCommandCapture {
+    if (!studioSystem) {
+        return NO;
+    }
+    
+    FMOD_RESULT result = FMOD_Studio_System_StopCommandCapture(studioSystem);
+    if (result != FMOD_OK) {
+        NSLog(@"FmodBridge: Failed to stop command capture: %d - %s",
+              result, FMOD_ErrorString(result));
+        return NO;
+    }
+    NSLog(@"FmodBridge: Command capture stopped");
+    return YES;
+}
+
+- (void)setInterruptionPolicyWithTransient:(int)transientResponse
+                                   canDuck:(int)canDuckResponse
+                                      loss:(int)lossResponse
+                                duckVolume:(float)duckVolume
+                               rampSeconds:(float)rampSeconds {
+    fmod_audio_interruption_set_policy(audioInterruption, transientResponse, canDuckResponse,
+                                       lossResponse, duckVolume, rampSeconds);
+}
+
+- (int)beginInterruption:(int)kind {
+    if (coreSystem == NULL) {
+        return FMOD_FLUTTER_RESPONSE_NONE;
+    }
+    
+    int response = fmod_audio_interruption_begin(audioInterruption, coreSystem, kind);
+    if (response == FMOD_FLUTTER_RESPONSE_SUSPEND &&
+        !fmod_mixer_lifecycle_suspend(mixerLifecycle, coreSystem,
+                                      FMOD_FLUTTER_SUSPEND_INTERRUPTION)) {
+        FMOD_RESULT result = fmod_mixer_lifecycle_last_result(mixerLifecycle);
+        NSLog(@"FmodBridge: Failed to suspend mixer: %d - %s",
+              result, FMOD_ErrorString(result));
+    }
+    NSLog(@"FmodBridge: Audio interruption %d began, response %d", kind, response);
+    return response;
+}
+
+- (double)endInterruption {
+    if (coreSystem == NULL ||
+        fmod_audio_interruption_response(audioInterruption) == FMOD_FLUTTER_RESPONSE_NONE) {
+        return -1.0;
+    }
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    // The session must be active again before the mixer can output
+    NSError *error = nil;
+    if (![[AVAudioSession sharedInstance] setActive:YES error:&error]) {
+        NSLog(@"FmodBridge: Failed to reactivate audio session: %@", error);
+    }
+    if (fmod_audio_interruption_response(audioInterruption) == FMOD_FLUTTER_RESPONSE_SUSPEND &&
+        !fmod_mixer_lifecycle_resume(mixerLifecycle, coreSystem, studioSystem,
+                                     FMOD_FLUTTER_SUSPEND_INTERRUPTION)) {
+        FMOD_RESULT result = fmod_mixer_lifecycle_last_result(mixerLifecycle);
+        NSLog(@"FmodBridge: Failed to resume mixer: %d - %s",
+              result, FMOD_ErrorString(result));
+    }
+    fmod_audio_interruption_end(audioInterruption, coreSystem);
+    
+    double recoveryMs = (CFAbsoluteTimeGetCurrent() - start) * 1000.0;
+    NSLog(@"FmodBridge: Audio interruption ended, recovered in %.2f ms", recoveryMs);
+    return recoveryMs;
+}
+
+- (BOOL)configureInstancePoolForEvent:(NSString *)eventPath
+                         prewarmCount:(int)prewarmCount
+                             capacity:(int)capacity {
+    if (studioSystem == NULL) {
+        NSLog(@"FmodBridge: Studio system not initialized");
+        return NO;
+    }
+    
+    if (!fmod_instance_pool_configure(instancePool, studioSystem, [eventPath UTF8String],
+                                      prewarmCount, capacity)) {
+        FMOD_RESULT result = fmod_instance_pool_last_result(instancePool);
+        NSLog(@"FmodBridge: Failed to configure instance pool for %@: %d - %s",
+              eventPath, result, FMOD_ErrorString(result));
+        return NO;
+    }
+    return YES;
+}
+
+- (nullable NSDictionary<NSString *, NSNumber *> *)instancePoolStatsForEvent:(nullable NSString *)eventPath {
+    FmodInstancePoolStats stats;
+    if (!fmod_instance_pool_get_stats(instancePool, [eventPath UTF8String], &stats)) {
+        return nil;
+    }
+    return @{
+        @"idleCount": @(stats.idle_count),
+        @"capacity": @(stats.capacity),
+        @"hits": @(stats.hits),
+        @"misses": @(stats.misses)
+    };
+}
+
+// Returns a stopped (or stopping) instance to its event's pool. Curves,
+// queued writes and beat tracking are dropped so a reused instance starts
+// clean.
+- (void)recycleInstance:(FMOD_STUDIO_EVENTINSTANCE *)instance forEvent:(NSString *)eventPath {
+    fmod_parameter_automation_cancel_instance(parameterAutomation, instance);
+    fmod_deferred_writes_forget(deferredWrites, instance);
+    fmod_instance_sweeper_forget(instanceSweeper, instance);
+    @synchronized (beatStates) {
+        [beatStates removeObjectForKey:[NSValue valueWithPointer:instance]];
+    }
+    fmod_instance_pool_recycle(instancePool, [eventPath UTF8String], instance);
+}
+
+- (void)logMixerFailure:(NSString *)action path:(NSString *)path {
+    FMOD_RESULT result = fmod_mixer_control_last_result(mixerControl);
+    NSLog(@"FmodBridge: Failed to %@ %@: %d - %s",
+          action, path, result, FMOD_ErrorString(result));
+}
+
 - (void)dealloc {
     [self releaseFmod];
+    fmod_emitter_culler_destroy(emitterCuller);
+    fmod_bus_effects_destroy(busEffects);
+    fmod_spectrum_analyzers_destroy(spectrumAnalyzers);
+    fmod_mixer_control_destroy(mixerControl);
+    fmod_mixer_lifecycle_destroy(mixerLifecycle);
+    fmod_offline_output_destroy(offlineOutput);
+    fmod_sound_library_destroy(soundLibrary);
+    fmod_pcm_streams_destroy(pcmStreams);
+    fmod_mic_capture_destroy(micCapture);
+    fmod_voice_stats_destroy(voiceStats);
+    fmod_instance_states_destroy(instanceStates);
+    fmod_instance_sweeper_destroy(instanceSweeper);
+    fmod_deferred_writes_destroy(deferredWrites);
+    fmod_audio_interruption_destroy(audioInterruption);
+    fmod_parameter_automation_destroy(parameterAutomation);
+    fmod_global_parameters_destroy(globalParameters);
+    fmod_instance_pool_destroy(instancePool);
 }
 
 @end
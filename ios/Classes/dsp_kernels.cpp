@@ -0,0 +1,3 @@
+// Relative include so the shared C++ sources in ../../src are compiled as
+// part of this pod. See the comment in ../fmod_flutter.podspec.
+#include "../../src/dsp_kernels.cpp"
@@ -6,6 +6,7 @@ library;
 
 export 'src/fmod_platform_interface.dart';
 export 'src/fmod_service.dart';
+export 'src/fmod_types.dart';
 
 void registerFmodWebPlugin() {
   // This is called automatically by Flutter web
@@ -1,14 +1,55 @@
+import 'dart:async';
+import 'dart:typed_data';
+
 import 'package:flutter/services.dart';
 import 'fmod_platform_interface.dart';
+import 'fmod_types.dart';
 
 /// An implementation of [FmodPlatform] that uses method channels.
 class MethodChannelFmod extends FmodPlatform {
   final MethodChannel _channel = const MethodChannel('fmod_flutter');
 
+  final StreamController<FmodBeatScheduleFired> _beatScheduleFired =
+      StreamController<FmodBeatScheduleFired>.broadcast();
+
+  final StreamController<FmodAudioInterruption> _audioInterruption =
+      StreamController<FmodAudioInterruption>.broadcast();
+
+  final StreamController<String> _eventFinished =
+      StreamController<String>.broadcast();
+
+  /// Handles notifications sent from the native side.
+  Future<void> _handleNativeCall(MethodCall call) async {
+    switch (call.method) {
+      case 'onBeatScheduleFired':
+        _beatScheduleFired.add(
+          FmodBeatScheduleFired.fromMap(call.arguments as Map),
+        );
+        break;
+      case 'onAudioInterruption':
+        _audioInterruption.add(
+          FmodAudioInterruption.fromMap(call.arguments as Map),
+        );
+        break;
+      case 'onEventsFinished':
+        for (final path in call.arguments as List) {
+          _eventFinished.add(path as String);
+        }
+        break;
+    }
+  }
+
   @override
-  Future<bool> initialize() async {
+  Future<bool> initialize({
+    FmodOutputMode output = FmodOutputMode.device,
+    String? wavPath,
+  }) async {
+    _channel.setMethodCallHandler(_handleNativeCall);
     try {
-      final result = await _channel.invokeMethod<bool>('initialize');
+      final result = await _channel.invokeMethod<bool>('initialize', {
+        'output': output.index,
+        'wavPath': wavPath,
+      });
       return result ?? false;
     } catch (e) {
       throw Exception('Failed to initialize FMOD: $e');
@@ -32,6 +73,26 @@ class MethodChannelFmod extends FmodPlatform {
     await _channel.invokeMethod('playEvent', {'path': eventPath});
   }
 
+  @override
+  Future<int> playEventAt(
+    String eventPath,
+    int dspClockOffsetSamples, {
+    int? fromDspClock,
+  }) async {
+    final result = await _channel.invokeMethod<int>('playEventAt', {
+      'path': eventPath,
+      'offset': dspClockOffsetSamples,
+      'fromDspClock': fromDspClock,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<FmodDspClock?> getDspClock() async {
+    final result = await _channel.invokeMethod<Map>('getDspClock');
+    return result == null ? null : FmodDspClock.fromMap(result);
+  }
+
   @override
   Future<void> stopEvent(String eventPath) async {
     await _channel.invokeMethod('stopEvent', {'path': eventPath});
@@ -66,6 +127,103 @@ class MethodChannelFmod extends FmodPlatform {
     });
   }
 
+  @override
+  Future<void> setPitch(String eventPath, double pitch) async {
+    await _channel.invokeMethod('setPitch', {
+      'path': eventPath,
+      'pitch': pitch,
+    });
+  }
+
+  // Event methods take the 16 bytes of an FMOD_GUID in place of a path;
+  // the bridges resolve them with Studio::System::getEventByID.
+
+  @override
+  Future<void> playEventById(FmodGuid id) async {
+    await _channel.invokeMethod('playEvent', {'path': id.bytes});
+  }
+
+  @override
+  Future<void> stopEventById(FmodGuid id) async {
+    await _channel.invokeMethod('stopEvent', {'path': id.bytes});
+  }
+
+  @override
+  Future<void> setParameterById(
+    FmodGuid id,
+    String paramName,
+    double value,
+  ) async {
+    await _channel.invokeMethod('setParameter', {
+      'path': id.bytes,
+      'parameter': paramName,
+      'value': value,
+    });
+  }
+
+  @override
+  Future<void> setPausedById(FmodGuid id, bool paused) async {
+    await _channel.invokeMethod('setPaused', {
+      'path': id.bytes,
+      'paused': paused,
+    });
+  }
+
+  @override
+  Future<void> setVolumeById(FmodGuid id, double volume) async {
+    await _channel.invokeMethod('setVolume', {
+      'path': id.bytes,
+      'volume': volume,
+    });
+  }
+
+  @override
+  Future<void> setPitchById(FmodGuid id, double pitch) async {
+    await _channel.invokeMethod('setPitch', {
+      'path': id.bytes,
+      'pitch': pitch,
+    });
+  }
+
+  @override
+  Future<int> playEventAtById(
+    FmodGuid id,
+    int dspClockOffsetSamples, {
+    int? fromDspClock,
+  }) async {
+    final result = await _channel.invokeMethod<int>('playEventAt', {
+      'path': id.bytes,
+      'offset': dspClockOffsetSamples,
+      'fromDspClock': fromDspClock,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<int> scheduleAtBeatById(
+    FmodGuid id,
+    int bar,
+    int beat, {
+    FmodGuid? startEvent,
+  }) async {
+    final result = await _channel.invokeMethod<int>('scheduleAtBeat', {
+      'path': id.bytes,
+      'bar': bar,
+      'beat': beat,
+      'startEvent': startEvent?.bytes,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<int> createEmitterById(FmodGuid id, {bool start = true}) async {
+    final result = await _channel.invokeMethod<int>('createEmitter', {
+      'path': id.bytes,
+      'start': start,
+    });
+    return result ?? 0;
+  }
+
   @override
   Future<void> update() async {
     await _channel.invokeMethod('update');
@@ -80,5 +238,479 @@ class MethodChannelFmod extends FmodPlatform {
   Future<void> setMasterPaused(bool paused) async {
     await _channel.invokeMethod('setMasterPaused', {'paused': paused});
   }
-}
 
+  @override
+  Future<int> scheduleAtBeat(
+    String eventPath,
+    int bar,
+    int beat, {
+    String? startEventPath,
+  }) async {
+    final result = await _channel.invokeMethod<int>('scheduleAtBeat', {
+      'path': eventPath,
+      'bar': bar,
+      'beat': beat,
+      'startEvent': startEventPath,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> cancelBeatSchedule(int scheduleId) async {
+    final result = await _channel.invokeMethod<bool>('cancelBeatSchedule', {
+      'id': scheduleId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Stream<FmodBeatScheduleFired> get onBeatScheduleFired =>
+      _beatScheduleFired.stream;
+
+  @override
+  Stream<String> get onEventFinished => _eventFinished.stream;
+
+  @override
+  Future<int> createEmitter(String eventPath, {bool start = true}) async {
+    final result = await _channel.invokeMethod<int>('createEmitter', {
+      'path': eventPath,
+      'start': start,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> releaseEmitter(int emitterId) async {
+    final result = await _channel.invokeMethod<bool>('releaseEmitter', {
+      'id': emitterId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> updateSpatial(
+    Float32List listeners,
+    Int32List emitterIds,
+    Float32List emitters,
+  ) async {
+    final result = await _channel.invokeMethod<bool>('updateSpatial', {
+      'listeners': listeners,
+      'emitterIds': emitterIds,
+      'emitters': emitters,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<void> setEmitterCulling(
+    bool enabled, {
+    double hysteresis = 0.1,
+  }) async {
+    await _channel.invokeMethod('setEmitterCulling', {
+      'enabled': enabled,
+      'hysteresis': hysteresis,
+    });
+  }
+
+  @override
+  Future<int> addBusEffect(
+    String busPath,
+    int type,
+    Int32List parameterIndices,
+    Float32List parameterValues,
+  ) async {
+    final result = await _channel.invokeMethod<int>('addBusEffect', {
+      'busPath': busPath,
+      'type': type,
+      'parameterIndices': parameterIndices,
+      'parameterValues': parameterValues,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> removeBusEffect(int effectId) async {
+    final result = await _channel.invokeMethod<bool>('removeBusEffect', {
+      'id': effectId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> setBusEffectParameter(
+    int effectId,
+    int index,
+    double value,
+  ) async {
+    final result = await _channel.invokeMethod<bool>('setBusEffectParameter', {
+      'id': effectId,
+      'index': index,
+      'value': value,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<int> addSpectrumAnalyzer(
+    String target,
+    int bands,
+    int windowSize,
+  ) async {
+    final result = await _channel.invokeMethod<int>('addSpectrumAnalyzer', {
+      'target': target,
+      'bands': bands,
+      'windowSize': windowSize,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> removeSpectrumAnalyzer(int analyzerId) async {
+    final result = await _channel.invokeMethod<bool>('removeSpectrumAnalyzer', {
+      'id': analyzerId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> setBusVolume(String busPath, double volume, int rampMs) async {
+    final result = await _channel.invokeMethod<bool>('setBusVolume', {
+      'path': busPath,
+      'volume': volume,
+      'rampMs': rampMs,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> setVcaVolume(String vcaPath, double volume, int rampMs) async {
+    final result = await _channel.invokeMethod<bool>('setVcaVolume', {
+      'path': vcaPath,
+      'volume': volume,
+      'rampMs': rampMs,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> setBusMute(String busPath, bool muted) async {
+    final result = await _channel.invokeMethod<bool>('setBusMute', {
+      'path': busPath,
+      'muted': muted,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> setBusPaused(String busPath, bool paused) async {
+    final result = await _channel.invokeMethod<bool>('setBusPaused', {
+      'path': busPath,
+      'paused': paused,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> startSnapshot(String snapshotPath) async {
+    final result = await _channel.invokeMethod<bool>('startSnapshot', {
+      'path': snapshotPath,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> stopSnapshot(String snapshotPath, bool allowFadeOut) async {
+    final result = await _channel.invokeMethod<bool>('stopSnapshot', {
+      'path': snapshotPath,
+      'allowFadeOut': allowFadeOut,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> suspendMixer() async {
+    final result = await _channel.invokeMethod<bool>('suspendMixer');
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> resumeMixer() async {
+    final result = await _channel.invokeMethod<bool>('resumeMixer');
+    return result ?? false;
+  }
+
+  @override
+  Future<double?> getMixerResumeLatency() {
+    return _channel.invokeMethod<double>('getMixerResumeLatency');
+  }
+
+  @override
+  Future<bool> setInterruptionPolicy(FmodInterruptionPolicy policy) async {
+    final result = await _channel.invokeMethod<bool>(
+      'setInterruptionPolicy',
+      policy.toMap(),
+    );
+    return result ?? false;
+  }
+
+  @override
+  Stream<FmodAudioInterruption> get onAudioInterruption =>
+      _audioInterruption.stream;
+
+  @override
+  Future<String?> startCommandCapture(
+    String path,
+    bool flushEachCommand,
+  ) async {
+    return await _channel.invokeMethod<String>('startCommandCapture', {
+      'path': path,
+      'flushEachCommand': flushEachCommand,
+    });
+  }
+
+  @override
+  Future<bool> stopCommandCapture() async {
+    final result = await _channel.invokeMethod<bool>('stopCommandCapture');
+    return result ?? false;
+  }
+
+  @override
+  Future<Map<dynamic, dynamic>?> renderOffline(double seconds) async {
+    return await _channel.invokeMethod<Map>('renderOffline', {
+      'seconds': seconds,
+    });
+  }
+
+  @override
+  Future<FmodRenderedAudio?> getRenderedAudio() async {
+    final result = await _channel.invokeMethod<Map>('getRenderedAudio');
+    return result == null ? null : FmodRenderedAudio.fromMap(result);
+  }
+
+  @override
+  Future<int> loadSound(String assetPath, bool stream) async {
+    final result = await _channel.invokeMethod<int>('loadSound', {
+      'path': assetPath,
+      'stream': stream,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> playSound(int soundId, double volume) async {
+    final result = await _channel.invokeMethod<bool>('playSound', {
+      'id': soundId,
+      'volume': volume,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> unloadSound(int soundId) async {
+    final result = await _channel.invokeMethod<bool>('unloadSound', {
+      'id': soundId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<int> createPcmSound(
+    int bufferId,
+    int sampleRate,
+    int channels,
+    FmodPcmFormat format,
+  ) async {
+    final result = await _channel.invokeMethod<int>('createPcmSound', {
+      'bufferId': bufferId,
+      'sampleRate': sampleRate,
+      'channels': channels,
+      'format': format.index,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> playEventWithPcm(
+    String eventPath,
+    int bufferId,
+    int sampleRate,
+    int channels,
+    FmodPcmFormat format,
+  ) async {
+    final result = await _channel.invokeMethod<bool>('playEventWithPcm', {
+      'path': eventPath,
+      'bufferId': bufferId,
+      'sampleRate': sampleRate,
+      'channels': channels,
+      'format': format.index,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<int> createPcmStream(
+    int sampleRate,
+    int channels,
+    int capacityMs,
+  ) async {
+    final result = await _channel.invokeMethod<int>('createPcmStream', {
+      'sampleRate': sampleRate,
+      'channels': channels,
+      'capacityMs': capacityMs,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> releasePcmStream(int streamId) async {
+    final result = await _channel.invokeMethod<bool>('releasePcmStream', {
+      'id': streamId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<FmodPcmStreamStats?> getPcmStreamStats(int streamId) async {
+    final result = await _channel.invokeMethod<Map>('getPcmStreamStats', {
+      'id': streamId,
+    });
+    return result == null ? null : FmodPcmStreamStats.fromMap(result);
+  }
+
+  @override
+  Future<bool> startRecording(int driver, bool monitor, int latencyMs) async {
+    final result = await _channel.invokeMethod<bool>('startRecording', {
+      'driver': driver,
+      'monitor': monitor,
+      'latencyMs': latencyMs,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> stopRecording() async {
+    final result = await _channel.invokeMethod<bool>('stopRecording');
+    return result ?? false;
+  }
+
+  @override
+  Future<FmodRecordingStats?> getRecordingStats() async {
+    final result = await _channel.invokeMethod<Map>('getRecordingStats');
+    return result == null ? null : FmodRecordingStats.fromMap(result);
+  }
+
+  @override
+  Future<bool> startVoiceStats(int windowMs) async {
+    final result = await _channel.invokeMethod<bool>('startVoiceStats', {
+      'windowMs': windowMs,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<void> stopVoiceStats() async {
+    await _channel.invokeMethod('stopVoiceStats');
+  }
+
+  @override
+  Future<FmodVoiceStats> getVoiceStats() async {
+    final result = await _channel.invokeMethod<Map>('getVoiceStats');
+    return result == null
+        ? const FmodVoiceStats(windows: [], events: [])
+        : FmodVoiceStats.fromMap(result);
+  }
+
+  @override
+  Future<FmodInstanceSnapshot> queryInstances() async {
+    final result = await _channel.invokeMethod<Map>('queryInstances');
+    return result == null
+        ? const FmodInstanceSnapshot([])
+        : FmodInstanceSnapshot.fromMap(result);
+  }
+
+  @override
+  Future<bool> configureInstancePool(
+    String eventPath,
+    int prewarmCount,
+    int capacity,
+  ) async {
+    final result = await _channel.invokeMethod<bool>('configureInstancePool', {
+      'path': eventPath,
+      'prewarm': prewarmCount,
+      'capacity': capacity,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<FmodInstancePoolStats?> getInstancePoolStats(String? eventPath) async {
+    final result = await _channel.invokeMethod<Map>('getInstancePoolStats', {
+      'path': eventPath,
+    });
+    return result == null ? null : FmodInstancePoolStats.fromMap(result);
+  }
+
+  @override
+  Future<bool> setGlobalParameter(String name, double value) async {
+    final result = await _channel.invokeMethod<bool>('setGlobalParameter', {
+      'name': name,
+      'value': value,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<double?> getGlobalParameter(String name) {
+    return _channel.invokeMethod<double>('getGlobalParameter', {'name': name});
+  }
+
+  @override
+  Future<Int32List> resolveGlobalParameters(List<String> names) async {
+    final result = await _channel.invokeMethod<Int32List>(
+      'resolveGlobalParameters',
+      {'names': names},
+    );
+    return result ?? (Int32List(names.length)..fillRange(0, names.length, -1));
+  }
+
+  @override
+  Future<bool> setGlobalParameters(Int32List slots, Float32List values) async {
+    final result = await _channel.invokeMethod<bool>('setGlobalParameters', {
+      'slots': slots,
+      'values': values,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<int> automateParameter(
+    String eventPath,
+    String parameter,
+    int type,
+    Float32List data,
+  ) async {
+    final result = await _channel.invokeMethod<int>('automateParameter', {
+      'path': eventPath,
+      'parameter': parameter,
+      'type': type,
+      'data': data,
+    });
+    return result ?? 0;
+  }
+
+  @override
+  Future<bool> releaseAutomation(int automationId) async {
+    final result = await _channel.invokeMethod<bool>('releaseAutomation', {
+      'id': automationId,
+    });
+    return result ?? false;
+  }
+
+  @override
+  Future<bool> cancelAutomation(int automationId) async {
+    final result = await _channel.invokeMethod<bool>('cancelAutomation', {
+      'id': automationId,
+    });
+    return result ?? false;
+  }
+}
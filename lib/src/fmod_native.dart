@@ -0,0 +1,7 @@
+/// Direct access to memory published by the native plugin library.
+///
+/// Uses dart:ffi where it is available and a stub that reports nothing on
+/// the web.
+library;
+
+export 'fmod_native_stub.dart' if (dart.library.ffi) 'fmod_native_ffi.dart';
@@ -0,0 +1,193 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'fmod_types.dart';
+
+/// Reads the tables the native plugin library publishes in shared memory.
+///
+/// Mirrors the C layouts in src/loudness_meter.h and src/spectrum_analyzer.h.
+/// The mixer thread writes each loudness slot under a sequence counter that
+/// is odd while a write is in progress, so a read is retried until the
+/// counter is even and unchanged. Spectrum frames come from a native triple
+/// buffer and are viewed in place. PCM buffers (src/pcm_sounds.h) are
+/// allocated natively and filled in place, and PCM streams
+/// (src/pcm_stream.h) are written and microphone audio (src/mic_capture.h)
+/// is read without a platform channel.
+class FmodNative {
+  FmodNative._(
+    this._loudness,
+    this._loudnessSlots,
+    this._spectrumLatest,
+    this._pcmBufferCreate,
+    this._pcmBufferData,
+    this._pcmBufferRelease,
+    this._pcmStreamWrite,
+    this._micRead,
+  );
+
+  static const int _loudnessSlotSize = 32;
+  static const int _maxReadAttempts = 4;
+
+  static bool _opened = false;
+  static FmodNative? _instance;
+
+  final ByteData _loudness;
+  final int _loudnessSlots;
+  final Pointer<Uint8> Function(int) _spectrumLatest;
+  final int Function(int) _pcmBufferCreate;
+  final Pointer<Uint8> Function(int) _pcmBufferData;
+  final Pointer<NativeFinalizerFunction> _pcmBufferRelease;
+  final int Function(int, Pointer<Float>, int) _pcmStreamWrite;
+  final int Function(Pointer<Float>, int) _micRead;
+
+  /// The native tables, or null if the plugin library cannot be opened.
+  static FmodNative? get instance {
+    if (!_opened) {
+      _opened = true;
+      try {
+        _instance = _load(_openLibrary());
+      } catch (_) {
+        _instance = null;
+      }
+    }
+    return _instance;
+  }
+
+  static DynamicLibrary _openLibrary() {
+    if (Platform.isAndroid) {
+      return DynamicLibrary.open('libfmod_flutter.so');
+    }
+    if (Platform.isWindows) {
+      return DynamicLibrary.open('fmod_flutter_plugin.dll');
+    }
+    if (Platform.isIOS || Platform.isMacOS) {
+      try {
+        return DynamicLibrary.open('fmod_flutter.framework/fmod_flutter');
+      } on ArgumentError {
+        // Linked statically into the app.
+        return DynamicLibrary.process();
+      }
+    }
+    return DynamicLibrary.process();
+  }
+
+  static FmodNative _load(DynamicLibrary library) {
+    final readings = library
+        .lookupFunction<Pointer<Uint8> Function(), Pointer<Uint8> Function()>(
+          'fmod_flutter_loudness_readings',
+        );
+    final count = library.lookupFunction<Int32 Function(), int Function()>(
+      'fmod_flutter_loudness_reading_count',
+    );
+    final spectrumLatest = library
+        .lookupFunction<
+          Pointer<Uint8> Function(Int32),
+          Pointer<Uint8> Function(int)
+        >('fmod_flutter_spectrum_latest', isLeaf: true);
+    final pcmBufferCreate = library
+        .lookupFunction<Int32 Function(Int32), int Function(int)>(
+          'fmod_flutter_pcm_buffer_create',
+        );
+    final pcmBufferData = library
+        .lookupFunction<
+          Pointer<Uint8> Function(Int32),
+          Pointer<Uint8> Function(int)
+        >('fmod_flutter_pcm_buffer_data');
+    final pcmBufferRelease = library.lookup<NativeFinalizerFunction>(
+      'fmod_flutter_pcm_buffer_release',
+    );
+    final pcmStreamWrite = library
+        .lookupFunction<
+          Int32 Function(Int32, Pointer<Float>, Int32),
+          int Function(int, Pointer<Float>, int)
+        >('fmod_flutter_pcm_stream_write', isLeaf: true);
+    final micRead = library
+        .lookupFunction<
+          Int32 Function(Pointer<Float>, Int32),
+          int Function(Pointer<Float>, int)
+        >('fmod_flutter_mic_read', isLeaf: true);
+    final slots = count();
+    final bytes = readings().asTypedList(slots * _loudnessSlotSize);
+    return FmodNative._(
+      bytes.buffer.asByteData(bytes.offsetInBytes),
+      slots,
+      spectrumLatest,
+      pcmBufferCreate,
+      pcmBufferData,
+      pcmBufferRelease,
+      pcmStreamWrite,
+      micRead,
+    );
+  }
+
+  /// Allocate [size] bytes of zeroed native memory for PCM, or return null
+  /// on failure. The view's finalizer drops Dart's reference to it.
+  FmodPcmBuffer? createPcmBuffer(int size) {
+    final id = _pcmBufferCreate(size);
+    if (id == 0) return null;
+
+    final bytes = _pcmBufferData(id).asTypedList(
+      size,
+      finalizer: _pcmBufferRelease,
+      token: Pointer<Void>.fromAddress(id),
+    );
+    return FmodPcmBuffer(id: id, bytes: bytes);
+  }
+
+  /// Queue [samples] on the PCM stream [streamId]. The leaf call reads the
+  /// list in place, so the only copy is into the native ring. Returns the
+  /// number of samples queued, or -1 for an unknown stream.
+  int writePcmStream(int streamId, Float32List samples) {
+    return _pcmStreamWrite(streamId, samples.address, samples.length);
+  }
+
+  /// Move recorded microphone audio into [into], whole frames only, and
+  /// return the number of samples moved. The leaf call writes the list in
+  /// place.
+  int readRecordedAudio(Float32List into) {
+    return _micRead(into.address, into.length);
+  }
+
+  /// The newest frame of the spectrum analyzer [analyzerId], or null if no
+  /// such analyzer exists. The bands view native memory that stays
+  /// unchanged until the next call for the same analyzer.
+  FmodSpectrumFrame? readSpectrum(int analyzerId) {
+    final frame = _spectrumLatest(analyzerId);
+    if (frame == nullptr) return null;
+
+    final header = frame.cast<Int32>().asTypedList(2);
+    return FmodSpectrumFrame(
+      sequence: header[0].toUnsigned(32),
+      bands: (frame + 8).cast<Float>().asTypedList(header[1]),
+    );
+  }
+
+  /// The latest reading of the loudness meter with effect id [meterId], or
+  /// null if no such meter exists.
+  FmodLoudness? readLoudness(int meterId) {
+    for (var slot = 0; slot < _loudnessSlots; slot++) {
+      final offset = slot * _loudnessSlotSize;
+      if (_loudness.getInt32(offset + 4, Endian.host) != meterId) continue;
+
+      for (var attempt = 0; attempt < _maxReadAttempts; attempt++) {
+        final sequence = _loudness.getUint32(offset, Endian.host);
+        if (sequence.isOdd) continue;
+        final reading = FmodLoudness(
+          momentaryLufs: _loudness.getFloat32(offset + 8, Endian.host),
+          shortTermLufs: _loudness.getFloat32(offset + 12, Endian.host),
+          integratedLufs: _loudness.getFloat32(offset + 16, Endian.host),
+          rmsDb: _loudness.getFloat32(offset + 20, Endian.host),
+          peakDb: _loudness.getFloat32(offset + 24, Endian.host),
+          truePeakDb: _loudness.getFloat32(offset + 28, Endian.host),
+        );
+        if (_loudness.getUint32(offset, Endian.host) == sequence &&
+            _loudness.getInt32(offset + 4, Endian.host) == meterId) {
+          return reading;
+        }
+      }
+      return null;
+    }
+    return null;
+  }
+}
@@ -0,0 +1,26 @@
+import 'dart:typed_data';
+
+import 'fmod_types.dart';
+
+/// Stub used where dart:ffi is unavailable (web).
+class FmodNative {
+  FmodNative._();
+
+  /// Always null: there is no native library to read from.
+  static FmodNative? get instance => null;
+
+  /// Always null on this platform.
+  FmodLoudness? readLoudness(int meterId) => null;
+
+  /// Always null on this platform.
+  FmodSpectrumFrame? readSpectrum(int analyzerId) => null;
+
+  /// Always null on this platform.
+  FmodPcmBuffer? createPcmBuffer(int size) => null;
+
+  /// Always -1 on this platform.
+  int writePcmStream(int streamId, Float32List samples) => -1;
+
+  /// Always 0 on this platform.
+  int readRecordedAudio(Float32List into) => 0;
+}
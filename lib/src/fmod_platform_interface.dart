@@ -1,5 +1,9 @@
+import 'dart:async';
+import 'dart:typed_data';
+
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 import 'fmod_method_channel.dart';
+import 'fmod_types.dart';
 
 /// The interface that implementations of fmod_flutter must implement.
 abstract class FmodPlatform extends PlatformInterface {
@@ -18,8 +22,12 @@ abstract class FmodPlatform extends PlatformInterface {
     _instance = instance;
   }
 
-  /// Initialize the FMOD system
-  Future<bool> initialize();
+  /// Initialize the FMOD system, mixing to [output]. [wavPath] is the file
+  /// written by [FmodOutputMode.wavWriterNrt].
+  Future<bool> initialize({
+    FmodOutputMode output = FmodOutputMode.device,
+    String? wavPath,
+  });
 
   /// Load FMOD banks from asset paths
   Future<bool> loadBanks(List<String> bankPaths);
@@ -27,6 +35,22 @@ abstract class FmodPlatform extends PlatformInterface {
   /// Play an FMOD event by path
   Future<void> playEvent(String eventPath);
 
+  /// Play an FMOD event starting on mixer DSP clock tick
+  /// `fromDspClock + dspClockOffsetSamples`, where a null [fromDspClock]
+  /// means the current mixer clock. Returns the start clock, or 0 on failure.
+  Future<int> playEventAt(
+    String eventPath,
+    int dspClockOffsetSamples, {
+    int? fromDspClock,
+  }) {
+    throw UnimplementedError('playEventAt() has not been implemented.');
+  }
+
+  /// Read the current mixer DSP clock
+  Future<FmodDspClock?> getDspClock() {
+    throw UnimplementedError('getDspClock() has not been implemented.');
+  }
+
   /// Stop a playing event
   Future<void> stopEvent(String eventPath);
 
@@ -39,9 +63,405 @@ abstract class FmodPlatform extends PlatformInterface {
   /// Set the volume of an event
   Future<void> setVolume(String eventPath, double volume);
 
+  /// Set the pitch multiplier of an event
+  Future<void> setPitch(String eventPath, double pitch);
+
+  // The ...ById methods default to the path methods with the ID's braced
+  // text form, which FMOD's getEvent accepts in place of a path.
+
+  /// Play an event by its ID
+  Future<void> playEventById(FmodGuid id) => playEvent(id.toString());
+
+  /// Stop an event played by ID
+  Future<void> stopEventById(FmodGuid id) => stopEvent(id.toString());
+
+  /// Set a parameter value on an event played by ID
+  Future<void> setParameterById(FmodGuid id, String paramName, double value) =>
+      setParameter(id.toString(), paramName, value);
+
+  /// Pause or resume an event played by ID
+  Future<void> setPausedById(FmodGuid id, bool paused) =>
+      setPaused(id.toString(), paused);
+
+  /// Set the volume of an event played by ID
+  Future<void> setVolumeById(FmodGuid id, double volume) =>
+      setVolume(id.toString(), volume);
+
+  /// Set the pitch multiplier of an event played by ID
+  Future<void> setPitchById(FmodGuid id, double pitch) =>
+      setPitch(id.toString(), pitch);
+
+  /// Play an event by ID on a mixer DSP clock tick
+  Future<int> playEventAtById(
+    FmodGuid id,
+    int dspClockOffsetSamples, {
+    int? fromDspClock,
+  }) =>
+      playEventAt(
+        id.toString(),
+        dspClockOffsetSamples,
+        fromDspClock: fromDspClock,
+      );
+
   /// Pause or resume the master bus (all audio)
   Future<void> setMasterPaused(bool paused);
 
+  /// Schedule work on a timeline beat (1-based [bar] and [beat]) of a
+  /// playing event.
+  ///
+  /// If [startEventPath] is given, that event is started sample-accurately on
+  /// the beat using the mixer DSP clock. Returns a schedule id that is
+  /// reported through [onBeatScheduleFired] when the beat is armed.
+  Future<int> scheduleAtBeat(
+    String eventPath,
+    int bar,
+    int beat, {
+    String? startEventPath,
+  }) {
+    throw UnimplementedError('scheduleAtBeat() has not been implemented.');
+  }
+
+  /// Schedule work on a timeline beat of an event played by ID, optionally
+  /// starting [startEvent], also named by ID
+  Future<int> scheduleAtBeatById(
+    FmodGuid id,
+    int bar,
+    int beat, {
+    FmodGuid? startEvent,
+  }) =>
+      scheduleAtBeat(
+        id.toString(),
+        bar,
+        beat,
+        startEventPath: startEvent?.toString(),
+      );
+
+  /// Cancel a pending beat schedule
+  Future<bool> cancelBeatSchedule(int scheduleId) {
+    throw UnimplementedError('cancelBeatSchedule() has not been implemented.');
+  }
+
+  /// Beat schedules as they are armed on the mixer DSP clock
+  Stream<FmodBeatScheduleFired> get onBeatScheduleFired => const Stream.empty();
+
+  /// Events whose instance finished on its own and was released natively
+  Stream<String> get onEventFinished => const Stream.empty();
+
+  /// Create a 3D emitter: a dedicated instance of [eventPath] whose
+  /// position is driven by [updateSpatial]. Returns the emitter id, or 0 on
+  /// failure.
+  Future<int> createEmitter(String eventPath, {bool start = true}) {
+    throw UnimplementedError('createEmitter() has not been implemented.');
+  }
+
+  /// Create a 3D emitter for an event named by ID
+  Future<int> createEmitterById(FmodGuid id, {bool start = true}) =>
+      createEmitter(id.toString(), start: start);
+
+  /// Stop and release a 3D emitter
+  Future<bool> releaseEmitter(int emitterId) {
+    throw UnimplementedError('releaseEmitter() has not been implemented.');
+  }
+
+  /// Apply packed 3D attributes for all listeners and emitters in one pass.
+  ///
+  /// Each entity is 12 floats (position, velocity, forward, up).
+  /// [emitterIds] gives the emitter for each entry in [emitters].
+  Future<bool> updateSpatial(
+    Float32List listeners,
+    Int32List emitterIds,
+    Float32List emitters,
+  ) {
+    throw UnimplementedError('updateSpatial() has not been implemented.');
+  }
+
+  /// Enable or disable native distance culling of started emitters.
+  ///
+  /// [hysteresis] is the fraction of an event's max distance an emitter may
+  /// drift past before its instance is released.
+  Future<void> setEmitterCulling(bool enabled, {double hysteresis = 0.1}) {
+    throw UnimplementedError('setEmitterCulling() has not been implemented.');
+  }
+
+  /// Append a built-in DSP effect of [type] to the bus at [busPath], after
+  /// setting each parameter in [parameterIndices] to the matching entry of
+  /// [parameterValues]. Returns the effect id, or 0 on failure.
+  Future<int> addBusEffect(
+    String busPath,
+    int type,
+    Int32List parameterIndices,
+    Float32List parameterValues,
+  ) {
+    throw UnimplementedError('addBusEffect() has not been implemented.');
+  }
+
+  /// Remove and release a bus effect
+  Future<bool> removeBusEffect(int effectId) {
+    throw UnimplementedError('removeBusEffect() has not been implemented.');
+  }
+
+  /// Set a parameter on a bus effect
+  Future<bool> setBusEffectParameter(int effectId, int index, double value) {
+    throw UnimplementedError(
+      'setBusEffectParameter() has not been implemented.',
+    );
+  }
+
+  /// Attach an FFT analyzer with [bands] log-spaced bands and an FFT of
+  /// [windowSize] samples to a bus ('bus:/...') or the playing instance of
+  /// an event path. Returns the analyzer id, or 0 on failure.
+  Future<int> addSpectrumAnalyzer(String target, int bands, int windowSize) {
+    throw UnimplementedError('addSpectrumAnalyzer() has not been implemented.');
+  }
+
+  /// Remove and release a spectrum analyzer
+  Future<bool> removeSpectrumAnalyzer(int analyzerId) {
+    throw UnimplementedError(
+      'removeSpectrumAnalyzer() has not been implemented.',
+    );
+  }
+
+  /// Set the volume of a bus, ramping to it over [rampMs] milliseconds
+  /// natively (0 sets it at once)
+  Future<bool> setBusVolume(String busPath, double volume, int rampMs) {
+    throw UnimplementedError('setBusVolume() has not been implemented.');
+  }
+
+  /// Set the volume of a VCA, ramping to it over [rampMs] milliseconds
+  /// natively (0 sets it at once)
+  Future<bool> setVcaVolume(String vcaPath, double volume, int rampMs) {
+    throw UnimplementedError('setVcaVolume() has not been implemented.');
+  }
+
+  /// Mute or unmute a bus
+  Future<bool> setBusMute(String busPath, bool muted) {
+    throw UnimplementedError('setBusMute() has not been implemented.');
+  }
+
+  /// Pause or resume a bus
+  Future<bool> setBusPaused(String busPath, bool paused) {
+    throw UnimplementedError('setBusPaused() has not been implemented.');
+  }
+
+  /// Start a mixer snapshot, restarting it if already active
+  Future<bool> startSnapshot(String snapshotPath) {
+    throw UnimplementedError('startSnapshot() has not been implemented.');
+  }
+
+  /// Stop a snapshot started with [startSnapshot]
+  Future<bool> stopSnapshot(String snapshotPath, bool allowFadeOut) {
+    throw UnimplementedError('stopSnapshot() has not been implemented.');
+  }
+
+  /// Stop the update tick and suspend the FMOD mixer thread
+  Future<bool> suspendMixer() {
+    throw UnimplementedError('suspendMixer() has not been implemented.');
+  }
+
+  /// Resume the mixer thread and update tick after [suspendMixer]
+  Future<bool> resumeMixer() {
+    throw UnimplementedError('resumeMixer() has not been implemented.');
+  }
+
+  /// Milliseconds the last mixer resume took, or null if there was none
+  Future<double?> getMixerResumeLatency() {
+    throw UnimplementedError(
+      'getMixerResumeLatency() has not been implemented.',
+    );
+  }
+
+  /// Set how audio interruptions are handled
+  Future<bool> setInterruptionPolicy(FmodInterruptionPolicy policy) {
+    throw UnimplementedError(
+      'setInterruptionPolicy() has not been implemented.',
+    );
+  }
+
+  /// Audio interruptions as they begin and end
+  Stream<FmodAudioInterruption> get onAudioInterruption =>
+      const Stream.empty();
+
+  /// Record every Studio API call to [path]; returns the absolute path
+  /// written, or null on failure
+  Future<String?> startCommandCapture(String path, bool flushEachCommand) {
+    throw UnimplementedError(
+      'startCommandCapture() has not been implemented.',
+    );
+  }
+
+  /// Stop a capture started with [startCommandCapture]
+  Future<bool> stopCommandCapture() {
+    throw UnimplementedError('stopCommandCapture() has not been implemented.');
+  }
+
+  /// Mix [seconds] of audio as fast as possible. Only in the non-realtime
+  /// output modes. Returns {renderedSeconds, renderMs}, or null on failure.
+  Future<Map<dynamic, dynamic>?> renderOffline(double seconds) {
+    throw UnimplementedError('renderOffline() has not been implemented.');
+  }
+
+  /// Take the mix captured by [FmodOutputMode.memoryNrt] since the last call
+  Future<FmodRenderedAudio?> getRenderedAudio() {
+    throw UnimplementedError('getRenderedAudio() has not been implemented.');
+  }
+
+  /// Load a sound that is not in a Studio bank. Returns its id, or 0 on
+  /// failure.
+  Future<int> loadSound(String assetPath, bool stream) {
+    throw UnimplementedError('loadSound() has not been implemented.');
+  }
+
+  /// Play a sound loaded with [loadSound] once
+  Future<bool> playSound(int soundId, double volume) {
+    throw UnimplementedError('playSound() has not been implemented.');
+  }
+
+  /// Release a sound loaded with [loadSound]
+  Future<bool> unloadSound(int soundId) {
+    throw UnimplementedError('unloadSound() has not been implemented.');
+  }
+
+  /// Create a sound over the native PCM buffer [bufferId]. Returns its id
+  /// for [playSound] and [unloadSound], or 0 on failure.
+  Future<int> createPcmSound(
+    int bufferId,
+    int sampleRate,
+    int channels,
+    FmodPcmFormat format,
+  ) {
+    throw UnimplementedError('createPcmSound() has not been implemented.');
+  }
+
+  /// Start a one-shot instance of [eventPath] whose programmer instruments
+  /// play the native PCM buffer [bufferId]
+  Future<bool> playEventWithPcm(
+    String eventPath,
+    int bufferId,
+    int sampleRate,
+    int channels,
+    FmodPcmFormat format,
+  ) {
+    throw UnimplementedError('playEventWithPcm() has not been implemented.');
+  }
+
+  /// Create and start a PCM stream buffering up to [capacityMs]. Returns
+  /// its id, or 0 on failure.
+  Future<int> createPcmStream(int sampleRate, int channels, int capacityMs) {
+    throw UnimplementedError('createPcmStream() has not been implemented.');
+  }
+
+  /// Stop and release a PCM stream
+  Future<bool> releasePcmStream(int streamId) {
+    throw UnimplementedError('releasePcmStream() has not been implemented.');
+  }
+
+  /// Buffering statistics of a PCM stream, or null if no such stream
+  Future<FmodPcmStreamStats?> getPcmStreamStats(int streamId) {
+    throw UnimplementedError('getPcmStreamStats() has not been implemented.');
+  }
+
+  /// Record from record driver [driver], playing the input back
+  /// [latencyMs] behind if [monitor] is set
+  Future<bool> startRecording(int driver, bool monitor, int latencyMs) {
+    throw UnimplementedError('startRecording() has not been implemented.');
+  }
+
+  /// Stop recording and monitoring
+  Future<bool> stopRecording() {
+    throw UnimplementedError('stopRecording() has not been implemented.');
+  }
+
+  /// Recording statistics, or null if not recording
+  Future<FmodRecordingStats?> getRecordingStats() {
+    throw UnimplementedError('getRecordingStats() has not been implemented.');
+  }
+
+  /// Sample voices and event instances into windows of [windowMs]
+  Future<bool> startVoiceStats(int windowMs) {
+    throw UnimplementedError('startVoiceStats() has not been implemented.');
+  }
+
+  /// Stop sampling voices
+  Future<void> stopVoiceStats() {
+    throw UnimplementedError('stopVoiceStats() has not been implemented.');
+  }
+
+  /// Complete voice statistics windows and the events of the newest one
+  Future<FmodVoiceStats> getVoiceStats() {
+    throw UnimplementedError('getVoiceStats() has not been implemented.');
+  }
+
+  /// The states of every tracked event and emitter instance, as read back
+  /// after the latest update tick
+  Future<FmodInstanceSnapshot> queryInstances() {
+    throw UnimplementedError('queryInstances() has not been implemented.');
+  }
+
+  /// Keep up to [capacity] stopped instances of [eventPath] for reuse,
+  /// creating [prewarmCount] now. A [capacity] of 0 removes the pool.
+  Future<bool> configureInstancePool(
+    String eventPath,
+    int prewarmCount,
+    int capacity,
+  ) {
+    throw UnimplementedError(
+      'configureInstancePool() has not been implemented.',
+    );
+  }
+
+  /// Pool statistics for [eventPath], or totals when it is null
+  Future<FmodInstancePoolStats?> getInstancePoolStats(String? eventPath) {
+    throw UnimplementedError(
+      'getInstancePoolStats() has not been implemented.',
+    );
+  }
+
+  /// Set a global parameter
+  Future<bool> setGlobalParameter(String name, double value) {
+    throw UnimplementedError('setGlobalParameter() has not been implemented.');
+  }
+
+  /// Get the value of a global parameter, or null on failure
+  Future<double?> getGlobalParameter(String name) {
+    throw UnimplementedError('getGlobalParameter() has not been implemented.');
+  }
+
+  /// Resolve global parameter names to native slots (-1 if unknown)
+  Future<Int32List> resolveGlobalParameters(List<String> names) {
+    throw UnimplementedError(
+      'resolveGlobalParameters() has not been implemented.',
+    );
+  }
+
+  /// Set values[i] on slots[i] for every slot in one native call
+  Future<bool> setGlobalParameters(Int32List slots, Float32List values) {
+    throw UnimplementedError(
+      'setGlobalParameters() has not been implemented.',
+    );
+  }
+
+  /// Drive [parameter] of the playing instance of [eventPath] with a
+  /// natively evaluated curve of [type] described by packed [data].
+  /// Returns the automation id, or 0 on failure.
+  Future<int> automateParameter(
+    String eventPath,
+    String parameter,
+    int type,
+    Float32List data,
+  ) {
+    throw UnimplementedError('automateParameter() has not been implemented.');
+  }
+
+  /// Move an ADSR automation into its release stage
+  Future<bool> releaseAutomation(int automationId) {
+    throw UnimplementedError('releaseAutomation() has not been implemented.');
+  }
+
+  /// Stop an automation, leaving the parameter at its last value
+  Future<bool> cancelAutomation(int automationId) {
+    throw UnimplementedError('cancelAutomation() has not been implemented.');
+  }
+
   /// Update the FMOD system (should be called regularly)
   Future<void> update();
 
@@ -1,6 +1,11 @@
+import 'dart:async';
+import 'dart:typed_data';
+
 import 'package:flutter/widgets.dart';
 
+import 'fmod_native.dart';
 import 'fmod_platform_interface.dart';
+import 'fmod_types.dart';
 
 /// High-level service for managing FMOD audio in Flutter applications.
 ///
@@ -21,6 +26,9 @@ class FmodService with WidgetsBindingObserver {
   final Map<String, bool> _playingEvents = {};
   final Map<String, bool> _pausedBySystem = {};
   bool _isPausedByLifecycle = false;
+  final Map<int, void Function(FmodBeatScheduleFired)> _beatCallbacks = {};
+  StreamSubscription<FmodBeatScheduleFired>? _beatSubscription;
+  StreamSubscription<String>? _finishedSubscription;
 
   /// Whether FMOD has been successfully initialized
   bool get isInitialized => _isInitialized;
@@ -28,15 +36,32 @@ class FmodService with WidgetsBindingObserver {
   /// Initialize the FMOD system.
   ///
   /// This must be called before any other FMOD operations.
+  /// [output] selects where FMOD mixes to; the non-realtime modes need no
+  /// audio device and mix only in [renderOffline]. [wavPath] is the file
+  /// written by [FmodOutputMode.wavWriterNrt], relative to the app's
+  /// files directory (Android), Documents directory (iOS, macOS) or working
+  /// directory (Windows). The web build always uses the device.
   /// Returns true if initialization was successful.
-  Future<bool> initialize() async {
+  Future<bool> initialize({
+    FmodOutputMode output = FmodOutputMode.device,
+    String? wavPath,
+  }) async {
     if (_isInitialized) return true;
 
     try {
-      _isInitialized = await _platform.initialize();
+      _isInitialized = await _platform.initialize(
+        output: output,
+        wavPath: wavPath,
+      );
       if (_isInitialized) {
         // Register lifecycle observer to handle app backgrounding
         WidgetsBinding.instance.addObserver(this);
+        _beatSubscription = _platform.onBeatScheduleFired.listen(
+          _handleBeatScheduleFired,
+        );
+        _finishedSubscription = _platform.onEventFinished.listen(
+          _handleEventFinished,
+        );
       }
       debugPrint('FMOD initialized: $_isInitialized');
       return _isInitialized;
@@ -96,6 +121,61 @@ class FmodService with WidgetsBindingObserver {
     }
   }
 
+  /// Play an FMOD event starting on a specific mixer DSP clock tick.
+  ///
+  /// Unlike [playEvent], which starts on the next FMOD update, the event is
+  /// delayed on the mixer so it starts exactly
+  /// [dspClockOffsetSamples] output samples after [fromDspClock] (or after
+  /// the current mixer clock when [fromDspClock] is null).
+  ///
+  /// To line up layered stems, read the clock once and start every layer
+  /// from it:
+  /// ```dart
+  /// final clock = await fmod.getDspClock();
+  /// if (clock != null) {
+  ///   final offset = clock.samplesFor(const Duration(milliseconds: 100));
+  ///   for (final stem in ['event:/Music/Drums', 'event:/Music/Bass']) {
+  ///     await fmod.playEventAt(stem, offset, fromDspClock: clock.dspClock);
+  ///   }
+  /// }
+  /// ```
+  ///
+  /// Returns the DSP clock the event starts on, or null on failure.
+  Future<int?> playEventAt(
+    String eventPath,
+    int dspClockOffsetSamples, {
+    int? fromDspClock,
+  }) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final startClock = await _platform.playEventAt(
+        eventPath,
+        dspClockOffsetSamples,
+        fromDspClock: fromDspClock,
+      );
+      if (startClock == 0) return null;
+      _playingEvents[eventPath] = true;
+      debugPrint('Playing FMOD event: $eventPath at DSP clock $startClock');
+      return startClock;
+    } catch (e) {
+      debugPrint('Failed to play event $eventPath: $e');
+      return null;
+    }
+  }
+
+  /// Read the current mixer DSP clock and output sample rate.
+  Future<FmodDspClock?> getDspClock() async {
+    if (!_isInitialized) return null;
+
+    try {
+      return await _platform.getDspClock();
+    } catch (e) {
+      debugPrint('Failed to read DSP clock: $e');
+      return null;
+    }
+  }
+
   /// Stop a playing FMOD event.
   ///
   /// The event will fade out if configured in FMOD Studio.
@@ -119,6 +199,10 @@ class FmodService with WidgetsBindingObserver {
   /// ```
   ///
   /// Parameters must be defined in your FMOD Studio project.
+  ///
+  /// On native platforms writes are applied once per update tick: calling
+  /// this many times within a frame, e.g. from a gesture stream, costs one
+  /// FMOD call per event with only the last value of each parameter.
   Future<void> setParameter(
     String eventPath,
     String paramName,
@@ -171,6 +255,439 @@ class FmodService with WidgetsBindingObserver {
     }
   }
 
+  /// Stop FMOD's update tick and suspend its mixer thread, so it uses no
+  /// CPU until [resumeMixer].
+  ///
+  /// The plugin already does this natively when the app is backgrounded
+  /// (Android, iOS), hidden or minimized (macOS, Windows), and resumes on
+  /// return. Call it directly for other idle states.
+  Future<bool> suspendMixer() async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.suspendMixer();
+    } catch (e) {
+      debugPrint('Failed to suspend mixer: $e');
+      return false;
+    }
+  }
+
+  /// Resume the mixer after [suspendMixer]. Commands issued while suspended
+  /// are applied before this completes.
+  Future<bool> resumeMixer() async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.resumeMixer();
+    } catch (e) {
+      debugPrint('Failed to resume mixer: $e');
+      return false;
+    }
+  }
+
+  /// How long the last mixer resume took, native or requested, or null if
+  /// the mixer has not been suspended.
+  Future<Duration?> getMixerResumeLatency() async {
+    if (!_isInitialized) return null;
+    try {
+      final ms = await _platform.getMixerResumeLatency();
+      return ms == null ? null : Duration(microseconds: (ms * 1000).round());
+    } catch (e) {
+      debugPrint('Failed to get mixer resume latency: $e');
+      return null;
+    }
+  }
+
+  /// Set how FMOD responds to audio interruptions: Android audio focus
+  /// loss and iOS audio session interruptions such as calls or Siri.
+  ///
+  /// By default calls and focus loss suspend the mixer and ducking
+  /// requests lower the output to a quarter. Output is restored natively
+  /// when the interruption ends, or when the app returns to the foreground
+  /// if the end was never reported.
+  Future<bool> setInterruptionPolicy(FmodInterruptionPolicy policy) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.setInterruptionPolicy(policy);
+    } catch (e) {
+      debugPrint('Failed to set interruption policy: $e');
+      return false;
+    }
+  }
+
+  /// Audio interruptions as they begin and end, with the time output took
+  /// to recover.
+  Stream<FmodAudioInterruption> get audioInterruptions =>
+      _platform.onAudioInterruption;
+
+  /// Record every FMOD Studio API call to a capture file, for replay with
+  /// the `tool/command_replay` benchmark.
+  ///
+  /// Relative paths resolve against the app's files directory (Android),
+  /// Documents directory (iOS, macOS) or working directory (Windows).
+  /// Start before loading banks so the capture can load them on replay.
+  /// [flushEachCommand] writes every command as it is issued, so a capture
+  /// survives a crash at some cost in speed.
+  ///
+  /// Returns the absolute path of the capture, or null on failure.
+  Future<String?> startCommandCapture(
+    String path, {
+    bool flushEachCommand = false,
+  }) async {
+    if (!_isInitialized) return null;
+    try {
+      return await _platform.startCommandCapture(path, flushEachCommand);
+    } catch (e) {
+      debugPrint('Failed to start command capture: $e');
+      return null;
+    }
+  }
+
+  /// Stop the command capture and close its file.
+  Future<bool> stopCommandCapture() async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.stopCommandCapture();
+    } catch (e) {
+      debugPrint('Failed to stop command capture: $e');
+      return false;
+    }
+  }
+
+  /// Mix [duration] of audio as fast as the CPU allows.
+  ///
+  /// Only when initialized with a non-realtime [FmodOutputMode]; events,
+  /// snapshots and parameters set beforehand are heard in the render.
+  /// Parameter automation and mixer ramps advance by the audio mixed, so
+  /// the same calls render the same audio.
+  ///
+  /// Returns how much was mixed and how long it took, or null on failure.
+  Future<FmodRenderStats?> renderOffline(Duration duration) async {
+    if (!_isInitialized) return null;
+    try {
+      final result = await _platform.renderOffline(
+        duration.inMicroseconds / 1e6,
+      );
+      return result == null ? null : FmodRenderStats.fromMap(result);
+    } catch (e) {
+      debugPrint('Failed to render offline: $e');
+      return null;
+    }
+  }
+
+  /// Take the audio mixed by [renderOffline] since the last call, when
+  /// initialized with [FmodOutputMode.memoryNrt].
+  Future<FmodRenderedAudio?> getRenderedAudio() async {
+    if (!_isInitialized) return null;
+    try {
+      return await _platform.getRenderedAudio();
+    } catch (e) {
+      debugPrint('Failed to get rendered audio: $e');
+      return null;
+    }
+  }
+
+  /// Load a sound that is not in a Studio bank, such as a UI sound pack.
+  ///
+  /// Compact `.fca` files, made with `tool/compact_codec`, cost far less to
+  /// decode than Vorbis; any other format FMOD reads works too. A sound is
+  /// decoded into memory at load unless [stream] is true.
+  ///
+  /// Returns the sound id, or null on failure.
+  Future<int?> loadSound(String assetPath, {bool stream = false}) async {
+    if (!_isInitialized) return null;
+    try {
+      final id = await _platform.loadSound(assetPath, stream);
+      return id == 0 ? null : id;
+    } catch (e) {
+      debugPrint('Failed to load sound $assetPath: $e');
+      return null;
+    }
+  }
+
+  /// Play a sound loaded with [loadSound] once at [volume] (linear).
+  Future<bool> playSound(int soundId, {double volume = 1.0}) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.playSound(soundId, volume);
+    } catch (e) {
+      debugPrint('Failed to play sound $soundId: $e');
+      return false;
+    }
+  }
+
+  /// Release a sound loaded with [loadSound].
+  Future<bool> unloadSound(int soundId) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.unloadSound(soundId);
+    } catch (e) {
+      debugPrint('Failed to unload sound $soundId: $e');
+      return false;
+    }
+  }
+
+  /// Allocate [size] bytes of native memory to fill with PCM, e.g.
+  /// generated speech or procedural tones, or null where dart:ffi is
+  /// unavailable.
+  ///
+  /// Write samples through [FmodPcmBuffer.asFloat32] or
+  /// [FmodPcmBuffer.asInt16], then play them with [createPcmSound] or
+  /// [playEventWithPcm]. Sounds read the buffer in place, so nothing is
+  /// copied, and the native side keeps it alive while any sound uses it.
+  /// Writing while a sound plays the buffer changes what is heard.
+  FmodPcmBuffer? createPcmBuffer(int size) {
+    return FmodNative.instance?.createPcmBuffer(size);
+  }
+
+  /// Create a sound over [buffer] for [playSound] and [unloadSound].
+  ///
+  /// Returns the sound id, or null on failure.
+  Future<int?> createPcmSound(
+    FmodPcmBuffer buffer, {
+    required int sampleRate,
+    int channels = 1,
+    FmodPcmFormat format = FmodPcmFormat.float32,
+  }) async {
+    if (!_isInitialized) return null;
+    try {
+      final id = await _platform.createPcmSound(
+        buffer.id,
+        sampleRate,
+        channels,
+        format,
+      );
+      return id == 0 ? null : id;
+    } catch (e) {
+      debugPrint('Failed to create PCM sound: $e');
+      return null;
+    }
+  }
+
+  /// Play a one-shot instance of [eventPath] whose programmer instruments
+  /// play [buffer].
+  ///
+  /// The event keeps the buffer alive until it finishes, so its effects,
+  /// mixing and parameters apply to generated audio such as dialogue.
+  Future<bool> playEventWithPcm(
+    String eventPath,
+    FmodPcmBuffer buffer, {
+    required int sampleRate,
+    int channels = 1,
+    FmodPcmFormat format = FmodPcmFormat.float32,
+  }) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.playEventWithPcm(
+        eventPath,
+        buffer.id,
+        sampleRate,
+        channels,
+        format,
+      );
+    } catch (e) {
+      debugPrint('Failed to play $eventPath with PCM: $e');
+      return false;
+    }
+  }
+
+  /// Create a stream that PCM is pushed into while it plays, such as voice
+  /// chat or procedural music, and start it.
+  ///
+  /// [FmodPcmStream.write] queues float samples in a lock-free ring
+  /// buffering up to [capacity] of audio; a larger ring rides out bigger
+  /// gaps in writing at the cost of latency once it fills. Watch underruns
+  /// and latency with [getPcmStreamStats]. Returns null on failure, or
+  /// where dart:ffi is unavailable.
+  Future<FmodPcmStream?> createPcmStream(
+    int sampleRate,
+    int channels, {
+    Duration capacity = const Duration(milliseconds: 250),
+  }) async {
+    if (!_isInitialized) return null;
+    final native = FmodNative.instance;
+    if (native == null) return null;
+    try {
+      final id = await _platform.createPcmStream(
+        sampleRate,
+        channels,
+        capacity.inMilliseconds,
+      );
+      if (id == 0) return null;
+      return FmodPcmStream(
+        id: id,
+        sampleRate: sampleRate,
+        channels: channels,
+        writer: native.writePcmStream,
+      );
+    } catch (e) {
+      debugPrint('Failed to create PCM stream: $e');
+      return null;
+    }
+  }
+
+  /// Stop and release a stream from [createPcmStream].
+  Future<bool> releasePcmStream(FmodPcmStream stream) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.releasePcmStream(stream.id);
+    } catch (e) {
+      debugPrint('Failed to release PCM stream ${stream.id}: $e');
+      return false;
+    }
+  }
+
+  /// Buffering, underrun and latency statistics of a PCM stream.
+  Future<FmodPcmStreamStats?> getPcmStreamStats(FmodPcmStream stream) async {
+    if (!_isInitialized) return null;
+    try {
+      return await _platform.getPcmStreamStats(stream.id);
+    } catch (e) {
+      debugPrint('Failed to get PCM stream stats: $e');
+      return null;
+    }
+  }
+
+  /// Record from a microphone: the default input, or record driver
+  /// [driver].
+  ///
+  /// Audio is recorded at the device's native rate and channel count (see
+  /// [getRecordingStats]) and read with [readRecordedAudio] or
+  /// [recordedAudioStream], through dart:ffi rather than the platform
+  /// channel. With [monitor] set, the input is also played back through the
+  /// output [monitorLatency] behind, drift-corrected against the output
+  /// clock; [monitorLatency] must be 1 to 500 ms. Recording needs the
+  /// platform's microphone permission; see the README. Returns false on
+  /// failure.
+  Future<bool> startRecording({
+    int driver = 0,
+    bool monitor = false,
+    Duration monitorLatency = const Duration(milliseconds: 50),
+  }) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.startRecording(
+        driver,
+        monitor,
+        monitorLatency.inMilliseconds,
+      );
+    } catch (e) {
+      debugPrint('Failed to start recording: $e');
+      return false;
+    }
+  }
+
+  /// Stop a recording from [startRecording].
+  Future<bool> stopRecording() async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.stopRecording();
+    } catch (e) {
+      debugPrint('Failed to stop recording: $e');
+      return false;
+    }
+  }
+
+  /// Move recorded audio into [into] as interleaved float samples and
+  /// return the number of samples moved.
+  ///
+  /// Audio is tapped natively on each update tick into a ring of about a
+  /// second; audio not read before the ring fills is dropped and counted
+  /// in [FmodRecordingStats.droppedSamples]. Returns 0 on the web.
+  int readRecordedAudio(Float32List into) {
+    return FmodNative.instance?.readRecordedAudio(into) ?? 0;
+  }
+
+  /// Poll [readRecordedAudio] every [interval] while the stream is listened
+  /// to, emitting chunks of up to [maxSamples] samples.
+  Stream<Float32List> recordedAudioStream({
+    Duration interval = const Duration(milliseconds: 20),
+    int maxSamples = 8192,
+  }) {
+    return Stream<Float32List?>.periodic(interval, (_) {
+      final chunk = Float32List(maxSamples);
+      final count = readRecordedAudio(chunk);
+      return count == 0 ? null : Float32List.sublistView(chunk, 0, count);
+    }).where((chunk) => chunk != null).cast<Float32List>();
+  }
+
+  /// Recording format and monitor latency, or null if not recording.
+  Future<FmodRecordingStats?> getRecordingStats() async {
+    if (!_isInitialized) return null;
+    try {
+      return await _platform.getRecordingStats();
+    } catch (e) {
+      debugPrint('Failed to get recording stats: $e');
+      return null;
+    }
+  }
+
+  /// Start sampling voice usage on every update tick, aggregated over
+  /// windows of [window].
+  ///
+  /// Each window reports real and virtual voice counts against the channel
+  /// limits, ticks where the voice limit was reached and new voices stole
+  /// playing ones, and per-event instance peaks, starts, starts refused by
+  /// instance limits and virtualizations. Use it to size channel limits
+  /// for a device class. The last 32 windows are kept; read them with
+  /// [getVoiceStats].
+  Future<bool> startVoiceStats({
+    Duration window = const Duration(seconds: 1),
+  }) async {
+    if (!_isInitialized) return false;
+    try {
+      return await _platform.startVoiceStats(window.inMilliseconds);
+    } catch (e) {
+      debugPrint('Failed to start voice stats: $e');
+      return false;
+    }
+  }
+
+  /// Stop sampling started by [startVoiceStats]. Complete windows stay
+  /// readable.
+  Future<void> stopVoiceStats() async {
+    if (!_isInitialized) return;
+    try {
+      await _platform.stopVoiceStats();
+    } catch (e) {
+      debugPrint('Failed to stop voice stats: $e');
+    }
+  }
+
+  /// The complete windows from [startVoiceStats], oldest first, and the
+  /// events of the newest one.
+  Future<FmodVoiceStats?> getVoiceStats() async {
+    if (!_isInitialized) return null;
+    try {
+      return await _platform.getVoiceStats();
+    } catch (e) {
+      debugPrint('Failed to get voice stats: $e');
+      return null;
+    }
+  }
+
+  /// The playback state, timeline position, volume and paused and virtual
+  /// flags of every event and emitter instance the plugin tracks.
+  ///
+  /// The native side reads them back from FMOD once per update tick, so
+  /// one query costs a single platform call however many events play.
+  /// Events that have finished on their own since they were played are
+  /// reported stopped, and [isEventPlaying] is brought up to date.
+  Future<FmodInstanceSnapshot?> queryInstances() async {
+    if (!_isInitialized) return null;
+    try {
+      final snapshot = await _platform.queryInstances();
+      final playing = <String>{
+        for (final instance in snapshot.instances)
+          if (instance.emitterId == null && instance.isPlaying)
+            instance.eventPath,
+      };
+      _playingEvents.updateAll((eventPath, _) => playing.contains(eventPath));
+      return snapshot;
+    } catch (e) {
+      debugPrint('Failed to query instances: $e');
+      return null;
+    }
+  }
+
   /// Set the volume for a playing event.
   ///
   /// Volume should be between 0.0 (silent) and 1.0 (full volume).
@@ -184,6 +701,746 @@ class FmodService with WidgetsBindingObserver {
     }
   }
 
+  /// Set the pitch multiplier for a playing event; 1.0 is the authored
+  /// pitch, 2.0 an octave up and 0.5 an octave down.
+  ///
+  /// Like [setParameter] and [setVolume], only the last value set within an
+  /// update tick reaches FMOD on native platforms.
+  Future<void> setPitch(String eventPath, double pitch) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setPitch(eventPath, pitch < 0.0 ? 0.0 : pitch);
+    } catch (e) {
+      debugPrint('Failed to set pitch on $eventPath: $e');
+    }
+  }
+
+  /// Play an event by its ID, e.g. one generated by `tool/bank_codegen`.
+  ///
+  /// IDs resolve natively through `Studio::System::getEventByID`, which does
+  /// not need the strings bank, so an app that names every event by ID can
+  /// leave `Master.strings.bank` out of [loadBanks] to save its memory.
+  /// ```dart
+  /// await fmod.playEventById(FmodEvents.mainMusic.id);
+  /// await fmod.setParameterById(FmodEvents.mainMusic.id, 'Intensity', 0.8);
+  /// ```
+  ///
+  /// The instance is tracked under the ID, so control it with the other
+  /// `...ById` methods rather than by path. [isEventPlaying] takes the ID's
+  /// text form, `id.toString()`.
+  Future<void> playEventById(FmodGuid id) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.playEventById(id);
+      _playingEvents[id.toString()] = true;
+      debugPrint('Playing FMOD event: $id');
+    } catch (e) {
+      debugPrint('Failed to play event $id: $e');
+    }
+  }
+
+  /// Stop an event played with [playEventById].
+  Future<void> stopEventById(FmodGuid id) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.stopEventById(id);
+      _playingEvents[id.toString()] = false;
+      debugPrint('Stopped FMOD event: $id');
+    } catch (e) {
+      debugPrint('Failed to stop event $id: $e');
+    }
+  }
+
+  /// [setParameter] for an event played with [playEventById].
+  Future<void> setParameterById(
+    FmodGuid id,
+    String paramName,
+    double value,
+  ) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setParameterById(id, paramName, value);
+    } catch (e) {
+      debugPrint('Failed to set parameter on $id: $e');
+    }
+  }
+
+  /// [setPaused] for an event played with [playEventById].
+  Future<void> setPausedById(FmodGuid id, bool paused) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setPausedById(id, paused);
+    } catch (e) {
+      debugPrint('Failed to set paused state on $id: $e');
+    }
+  }
+
+  /// [setVolume] for an event played with [playEventById].
+  Future<void> setVolumeById(FmodGuid id, double volume) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setVolumeById(id, volume.clamp(0.0, 1.0));
+    } catch (e) {
+      debugPrint('Failed to set volume on $id: $e');
+    }
+  }
+
+  /// [setPitch] for an event played with [playEventById].
+  Future<void> setPitchById(FmodGuid id, double pitch) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setPitchById(id, pitch < 0.0 ? 0.0 : pitch);
+    } catch (e) {
+      debugPrint('Failed to set pitch on $id: $e');
+    }
+  }
+
+  /// [playEventAt] for an event named by ID.
+  Future<int?> playEventAtById(
+    FmodGuid id,
+    int dspClockOffsetSamples, {
+    int? fromDspClock,
+  }) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final startClock = await _platform.playEventAtById(
+        id,
+        dspClockOffsetSamples,
+        fromDspClock: fromDspClock,
+      );
+      if (startClock == 0) return null;
+      _playingEvents[id.toString()] = true;
+      debugPrint('Playing FMOD event: $id at DSP clock $startClock');
+      return startClock;
+    } catch (e) {
+      debugPrint('Failed to play event $id: $e');
+      return null;
+    }
+  }
+
+  /// Schedule work on a musical beat of a playing event.
+  ///
+  /// The beat is tracked natively from the timeline of [eventPath] and
+  /// extrapolated on the mixer DSP clock, so it stays in time regardless of
+  /// Dart timer jitter. [bar] and [beat] are 1-based, matching the values
+  /// FMOD Studio shows on the timeline.
+  ///
+  /// If [startEvent] is given, that event is started sample-accurately on the
+  /// beat. [onBeat] is called when the beat is armed, shortly before it is
+  /// heard.
+  ///
+  /// A schedule is not dropped when its beat has already played by the time
+  /// it is armed, e.g. when it was scheduled late or the timeline jumped
+  /// past the beat: [onBeat] is called on the next update and [startEvent]
+  /// starts right away, off the beat. [FmodBeatScheduleFired.dspClock] is
+  /// then the clock it was armed on rather than the beat's.
+  ///
+  /// Example:
+  /// ```dart
+  /// await fmod.scheduleAtBeat(
+  ///   'event:/Music/MainTheme',
+  ///   5,
+  ///   1,
+  ///   startEvent: 'event:/Music/Stinger',
+  /// );
+  /// ```
+  ///
+  /// Returns the schedule id, or null if scheduling failed.
+  Future<int?> scheduleAtBeat(
+    String eventPath,
+    int bar,
+    int beat, {
+    String? startEvent,
+    void Function(FmodBeatScheduleFired fired)? onBeat,
+  }) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final id = await _platform.scheduleAtBeat(
+        eventPath,
+        bar,
+        beat,
+        startEventPath: startEvent,
+      );
+      if (id == 0) return null;
+      if (onBeat != null) {
+        _beatCallbacks[id] = onBeat;
+      }
+      return id;
+    } catch (e) {
+      debugPrint('Failed to schedule beat on $eventPath: $e');
+      return null;
+    }
+  }
+
+  /// [scheduleAtBeat] on an event played by ID, optionally starting
+  /// [startEvent], also named by ID.
+  Future<int?> scheduleAtBeatById(
+    FmodGuid id,
+    int bar,
+    int beat, {
+    FmodGuid? startEvent,
+    void Function(FmodBeatScheduleFired fired)? onBeat,
+  }) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final scheduleId = await _platform.scheduleAtBeatById(
+        id,
+        bar,
+        beat,
+        startEvent: startEvent,
+      );
+      if (scheduleId == 0) return null;
+      if (onBeat != null) {
+        _beatCallbacks[scheduleId] = onBeat;
+      }
+      return scheduleId;
+    } catch (e) {
+      debugPrint('Failed to schedule beat on $id: $e');
+      return null;
+    }
+  }
+
+  /// Cancel a beat schedule created with [scheduleAtBeat].
+  Future<void> cancelBeatSchedule(int scheduleId) async {
+    if (!_isInitialized) return;
+
+    _beatCallbacks.remove(scheduleId);
+    try {
+      await _platform.cancelBeatSchedule(scheduleId);
+    } catch (e) {
+      debugPrint('Failed to cancel beat schedule $scheduleId: $e');
+    }
+  }
+
+  void _handleBeatScheduleFired(FmodBeatScheduleFired fired) {
+    _beatCallbacks.remove(fired.id)?.call(fired);
+  }
+
+  /// Events played with [playEvent] or [playEventById] whose instance
+  /// reached its end on its own, by path or ID text.
+  ///
+  /// The native update loop checks a few tracked instances per tick and
+  /// releases, or returns to their pool, those that have stopped, so
+  /// one-shots do not hold memory until played again. Events with a
+  /// sustain point or a loop never finish on their own; stop them with
+  /// [stopEvent]. [isEventPlaying] turns false as each event is reported.
+  Stream<String> get eventFinished => _platform.onEventFinished;
+
+  void _handleEventFinished(String eventPath) {
+    _playingEvents[eventPath] = false;
+    _pausedBySystem.remove(eventPath);
+  }
+
+  /// Create a 3D emitter for [eventPath].
+  ///
+  /// Each emitter is its own event instance, so many emitters can play the
+  /// same event. Position them with [updateSpatial].
+  ///
+  /// Returns the emitter id, or null on failure.
+  Future<int?> createEmitter(String eventPath, {bool start = true}) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final id = await _platform.createEmitter(eventPath, start: start);
+      return id == 0 ? null : id;
+    } catch (e) {
+      debugPrint('Failed to create emitter for $eventPath: $e');
+      return null;
+    }
+  }
+
+  /// [createEmitter] for an event named by ID.
+  Future<int?> createEmitterById(FmodGuid id, {bool start = true}) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final emitterId = await _platform.createEmitterById(id, start: start);
+      return emitterId == 0 ? null : emitterId;
+    } catch (e) {
+      debugPrint('Failed to create emitter for $id: $e');
+      return null;
+    }
+  }
+
+  /// Stop and release an emitter created with [createEmitter].
+  Future<void> releaseEmitter(int emitterId) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.releaseEmitter(emitterId);
+    } catch (e) {
+      debugPrint('Failed to release emitter $emitterId: $e');
+    }
+  }
+
+  /// Submit listener and emitter positions for this frame in one call.
+  ///
+  /// Example:
+  /// ```dart
+  /// final batch = FmodSpatialBatch();
+  /// // Each frame:
+  /// batch
+  ///   ..clear()
+  ///   ..setListener(0, camera.position, forward: camera.forward)
+  ///   ..addEmitter(torchEmitter, torch.position);
+  /// await fmod.updateSpatial(batch);
+  /// ```
+  Future<void> updateSpatial(FmodSpatialBatch batch) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.updateSpatial(
+        batch.listeners,
+        batch.emitterIds,
+        batch.emitters,
+      );
+    } catch (e) {
+      debugPrint('Failed to update spatial attributes: $e');
+    }
+  }
+
+  /// Enable or disable distance culling of emitters.
+  ///
+  /// While enabled, a started emitter only holds an FMOD event instance when
+  /// a listener is within the event's max distance (as authored in FMOD
+  /// Studio). Emitters out of range are stopped and released natively and
+  /// restarted from the beginning when a listener comes back in range, so
+  /// this suits looping ambience rather than one-shots. Events without
+  /// distance attenuation are never culled.
+  ///
+  /// [hysteresis] is the fraction of the max distance an audible emitter may
+  /// drift past before it is culled, so emitters on the edge do not restart
+  /// every frame.
+  Future<void> setEmitterCulling(
+    bool enabled, {
+    double hysteresis = 0.1,
+  }) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setEmitterCulling(enabled, hysteresis: hysteresis);
+    } catch (e) {
+      debugPrint('Failed to set emitter culling: $e');
+    }
+  }
+
+  /// Attach a built-in DSP effect to the bus at [busPath].
+  ///
+  /// Effects are appended after the bus fader, in the order they are added.
+  /// [parameters] maps parameter indices (see [FmodSoftLimiterParam] and
+  /// [FmodBiquadParam]) to values applied before the effect starts
+  /// processing.
+  ///
+  /// Example:
+  /// ```dart
+  /// await fmod.addBusEffect('bus:/', FmodBusEffectType.softLimiter,
+  ///     parameters: {FmodSoftLimiterParam.ceiling: -0.3});
+  /// await fmod.addBusEffect('bus:/Music', FmodBusEffectType.biquad,
+  ///     parameters: {
+  ///       FmodBiquadParam.type: FmodBiquadType.highPass.index.toDouble(),
+  ///       FmodBiquadParam.frequency: 80,
+  ///     });
+  /// ```
+  ///
+  /// Returns the effect id, or null on failure.
+  Future<int?> addBusEffect(
+    String busPath,
+    FmodBusEffectType type, {
+    Map<int, double> parameters = const {},
+  }) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final id = await _platform.addBusEffect(
+        busPath,
+        type.index,
+        Int32List.fromList(parameters.keys.toList()),
+        Float32List.fromList(parameters.values.toList()),
+      );
+      return id == 0 ? null : id;
+    } catch (e) {
+      debugPrint('Failed to add effect to bus $busPath: $e');
+      return null;
+    }
+  }
+
+  /// Remove an effect added with [addBusEffect].
+  Future<void> removeBusEffect(int effectId) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.removeBusEffect(effectId);
+    } catch (e) {
+      debugPrint('Failed to remove bus effect $effectId: $e');
+    }
+  }
+
+  /// Set parameter [index] of a bus effect to [value].
+  Future<void> setBusEffectParameter(
+    int effectId,
+    int index,
+    double value,
+  ) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.setBusEffectParameter(effectId, index, value);
+    } catch (e) {
+      debugPrint('Failed to set parameter $index on bus effect $effectId: $e');
+    }
+  }
+
+  /// Attach a loudness meter to the bus at [busPath] ('bus:/' for the
+  /// master bus).
+  ///
+  /// The meter measures the bus after its fader and any effects added
+  /// before it. Up to 16 meters can exist at once. Returns the meter's
+  /// effect id for [readLoudness], or null on failure. Remove it with
+  /// [removeBusEffect].
+  Future<int?> addLoudnessMeter(String busPath) {
+    return addBusEffect(busPath, FmodBusEffectType.loudnessMeter);
+  }
+
+  /// The latest reading of a meter added with [addLoudnessMeter].
+  ///
+  /// Readings are published natively every 100 ms into memory shared with
+  /// Dart, so this is a synchronous memory read with no platform channel
+  /// call; it is cheap enough to call every frame. Returns null if the
+  /// meter does not exist or on the web.
+  FmodLoudness? readLoudness(int meterId) {
+    return FmodNative.instance?.readLoudness(meterId);
+  }
+
+  /// Poll [readLoudness] every [interval] while the stream is listened to.
+  Stream<FmodLoudness> loudnessStream(
+    int meterId, {
+    Duration interval = const Duration(milliseconds: 100),
+  }) {
+    return Stream<FmodLoudness?>.periodic(
+      interval,
+      (_) => readLoudness(meterId),
+    ).where((reading) => reading != null).cast<FmodLoudness>();
+  }
+
+  /// Restart the integrated loudness measurement of a meter.
+  Future<void> resetLoudness(int meterId) {
+    return setBusEffectParameter(meterId, FmodLoudnessMeterParam.reset, 1);
+  }
+
+  /// Attach an FFT spectrum analyzer to [target]: a bus path ('bus:/' for
+  /// the master bus) or the path of a playing event.
+  ///
+  /// The spectrum is split into [bands] log-spaced bands (1 to 128) from an
+  /// FFT of [windowSize] samples (a power of two from 128 to 32768). Up to
+  /// 8 analyzers can exist at once. Returns the analyzer id for
+  /// [readSpectrum], or null on failure.
+  Future<int?> addSpectrumAnalyzer(
+    String target, {
+    int bands = 32,
+    int windowSize = 2048,
+  }) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final id = await _platform.addSpectrumAnalyzer(
+        target,
+        bands,
+        windowSize,
+      );
+      return id == 0 ? null : id;
+    } catch (e) {
+      debugPrint('Failed to add spectrum analyzer to $target: $e');
+      return null;
+    }
+  }
+
+  /// Remove an analyzer added with [addSpectrumAnalyzer].
+  Future<void> removeSpectrumAnalyzer(int analyzerId) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.removeSpectrumAnalyzer(analyzerId);
+    } catch (e) {
+      debugPrint('Failed to remove spectrum analyzer $analyzerId: $e');
+    }
+  }
+
+  /// The newest frame of a spectrum analyzer.
+  ///
+  /// Frames are binned natively on each update tick (~60 Hz) and handed
+  /// over through a lock-free triple buffer, so this is a synchronous,
+  /// copy-free read meant to be called from a frame callback or painter.
+  /// Returns null if the analyzer does not exist or on the web.
+  FmodSpectrumFrame? readSpectrum(int analyzerId) {
+    return FmodNative.instance?.readSpectrum(analyzerId);
+  }
+
+  /// Set the volume of a bus ('bus:/' for the master bus).
+  ///
+  /// With a non-zero [ramp] the volume fades linearly from its current
+  /// value on the native update tick, so a fade is a single call. A new
+  /// call replaces any ramp already running on the bus. Bus and VCA
+  /// handles are cached natively when banks load.
+  Future<bool> setBusVolume(
+    String busPath,
+    double volume, {
+    Duration ramp = Duration.zero,
+  }) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.setBusVolume(
+        busPath,
+        volume,
+        ramp.inMilliseconds,
+      );
+    } catch (e) {
+      debugPrint('Failed to set volume of $busPath: $e');
+      return false;
+    }
+  }
+
+  /// Set the volume of a VCA, optionally fading over [ramp] as in
+  /// [setBusVolume].
+  Future<bool> setVcaVolume(
+    String vcaPath,
+    double volume, {
+    Duration ramp = Duration.zero,
+  }) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.setVcaVolume(
+        vcaPath,
+        volume,
+        ramp.inMilliseconds,
+      );
+    } catch (e) {
+      debugPrint('Failed to set volume of $vcaPath: $e');
+      return false;
+    }
+  }
+
+  /// Mute or unmute a bus.
+  Future<bool> setBusMute(String busPath, bool muted) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.setBusMute(busPath, muted);
+    } catch (e) {
+      debugPrint('Failed to set mute state of $busPath: $e');
+      return false;
+    }
+  }
+
+  /// Pause or resume everything routed through a bus.
+  Future<bool> setBusPaused(String busPath, bool paused) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.setBusPaused(busPath, paused);
+    } catch (e) {
+      debugPrint('Failed to set paused state of $busPath: $e');
+      return false;
+    }
+  }
+
+  /// Start a mixer snapshot (e.g. 'snapshot:/Pause'). Starting a snapshot
+  /// that is already active restarts it.
+  Future<bool> startSnapshot(String snapshotPath) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.startSnapshot(snapshotPath);
+    } catch (e) {
+      debugPrint('Failed to start snapshot $snapshotPath: $e');
+      return false;
+    }
+  }
+
+  /// Stop a snapshot started with [startSnapshot], letting it fade out
+  /// unless [allowFadeOut] is false.
+  Future<bool> stopSnapshot(
+    String snapshotPath, {
+    bool allowFadeOut = true,
+  }) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.stopSnapshot(snapshotPath, allowFadeOut);
+    } catch (e) {
+      debugPrint('Failed to stop snapshot $snapshotPath: $e');
+      return false;
+    }
+  }
+
+  /// Keep stopped instances of [eventPath] for reuse by [playEvent], so
+  /// latency-critical sounds such as footsteps or UI clicks skip instance
+  /// creation.
+  ///
+  /// [prewarm] instances are created now and the event's sample data is
+  /// loaded. Stopped instances return to the pool until it holds
+  /// [capacity]; beyond that they are released. Reused instances keep
+  /// their last parameter values.
+  Future<bool> configureInstancePool(
+    String eventPath, {
+    int prewarm = 0,
+    int capacity = 8,
+  }) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.configureInstancePool(
+        eventPath,
+        prewarm,
+        capacity,
+      );
+    } catch (e) {
+      debugPrint('Failed to configure instance pool for $eventPath: $e');
+      return false;
+    }
+  }
+
+  /// Release the pooled instances of [eventPath] and stop pooling it.
+  Future<bool> removeInstancePool(String eventPath) {
+    return configureInstancePool(eventPath, capacity: 0);
+  }
+
+  /// Hit and miss counts for the pool of [eventPath], or for every pool
+  /// when it is omitted. Null if [eventPath] is not pooled.
+  Future<FmodInstancePoolStats?> getInstancePoolStats([
+    String? eventPath,
+  ]) async {
+    if (!_isInitialized) return null;
+
+    try {
+      return await _platform.getInstancePoolStats(eventPath);
+    } catch (e) {
+      debugPrint('Failed to get instance pool stats: $e');
+      return null;
+    }
+  }
+
+  /// Set a global parameter such as time of day or weather, which applies
+  /// to every event that uses it. IDs are resolved natively when banks
+  /// load.
+  Future<bool> setGlobalParameter(String name, double value) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.setGlobalParameter(name, value);
+    } catch (e) {
+      debugPrint('Failed to set global parameter $name: $e');
+      return false;
+    }
+  }
+
+  /// The value of a global parameter, or null on failure.
+  Future<double?> getGlobalParameter(String name) async {
+    if (!_isInitialized) return null;
+
+    try {
+      return await _platform.getGlobalParameter(name);
+    } catch (e) {
+      debugPrint('Failed to get global parameter $name: $e');
+      return null;
+    }
+  }
+
+  /// Resolve global parameter [names] once for [setGlobalParameters].
+  ///
+  /// Names that are not global parameters get a slot of -1 and are skipped
+  /// when the batch is sent. Resolve again after loading banks that add
+  /// globals.
+  Future<FmodGlobalParameterBatch?> resolveGlobalParameters(
+    List<String> names,
+  ) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final slots = await _platform.resolveGlobalParameters(names);
+      return FmodGlobalParameterBatch(List.unmodifiable(names), slots);
+    } catch (e) {
+      debugPrint('Failed to resolve global parameters: $e');
+      return null;
+    }
+  }
+
+  /// Write every value of [batch] in one call, e.g. once per frame for
+  /// world-state parameters.
+  Future<bool> setGlobalParameters(FmodGlobalParameterBatch batch) async {
+    if (!_isInitialized) return false;
+
+    try {
+      return await _platform.setGlobalParameters(batch.slots, batch.values);
+    } catch (e) {
+      debugPrint('Failed to set global parameters: $e');
+      return false;
+    }
+  }
+
+  /// Drive [parameter] of the playing instance of [eventPath] with
+  /// [curve], evaluated natively on every update tick.
+  ///
+  /// This replaces per-frame [setParameter] calls for fades and modulation:
+  /// the curve crosses the platform channel once. Starting a curve replaces
+  /// any curve already driving the parameter, and [setParameter] cancels
+  /// it. Curves end on their own when finished or when the instance is
+  /// released. Returns the automation id, or null on failure.
+  Future<int?> automateParameter(
+    String eventPath,
+    String parameter,
+    FmodAutomationCurve curve,
+  ) async {
+    if (!_isInitialized) return null;
+
+    try {
+      final id = await _platform.automateParameter(
+        eventPath,
+        parameter,
+        curve.type,
+        curve.data,
+      );
+      return id == 0 ? null : id;
+    } catch (e) {
+      debugPrint('Failed to automate $parameter on $eventPath: $e');
+      return null;
+    }
+  }
+
+  /// Release an [FmodAutomationCurve.adsr] curve that holds its sustain
+  /// level until released.
+  Future<void> releaseAutomation(int automationId) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.releaseAutomation(automationId);
+    } catch (e) {
+      debugPrint('Failed to release automation $automationId: $e');
+    }
+  }
+
+  /// Stop an automation, leaving the parameter at its current value.
+  Future<void> cancelAutomation(int automationId) async {
+    if (!_isInitialized) return;
+
+    try {
+      await _platform.cancelAutomation(automationId);
+    } catch (e) {
+      debugPrint('Failed to cancel automation $automationId: $e');
+    }
+  }
+
   /// Update the FMOD system.
   ///
   /// This should be called regularly (e.g., in a game loop) to process
@@ -203,6 +1460,11 @@ class FmodService with WidgetsBindingObserver {
 
     try {
       WidgetsBinding.instance.removeObserver(this);
+      await _beatSubscription?.cancel();
+      _beatSubscription = null;
+      await _finishedSubscription?.cancel();
+      _finishedSubscription = null;
+      _beatCallbacks.clear();
       await _platform.release();
       _isInitialized = false;
       _playingEvents.clear();
@@ -0,0 +1,1181 @@
+import 'dart:typed_data';
+
+/// Reported when a beat schedule created with `scheduleAtBeat` is armed on
+/// the mixer DSP clock.
+class FmodBeatScheduleFired {
+  const FmodBeatScheduleFired({
+    required this.id,
+    required this.bar,
+    required this.beat,
+    required this.dspClock,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodBeatScheduleFired.fromMap(Map<dynamic, dynamic> map) {
+    return FmodBeatScheduleFired(
+      id: map['id'] as int,
+      bar: map['bar'] as int,
+      beat: map['beat'] as int,
+      dspClock: map['dspClock'] as int,
+    );
+  }
+
+  /// The id returned when the schedule was created.
+  final int id;
+
+  /// The bar the schedule targeted (1-based).
+  final int bar;
+
+  /// The beat within [bar] the schedule targeted (1-based).
+  final int beat;
+
+  /// The mixer DSP clock tick (in output samples) the beat lands on, or the
+  /// tick the schedule was armed on if the beat had already played.
+  final int dspClock;
+}
+
+/// A reading of the FMOD mixer DSP clock.
+class FmodDspClock {
+  const FmodDspClock({required this.dspClock, required this.sampleRate});
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodDspClock.fromMap(Map<dynamic, dynamic> map) {
+    return FmodDspClock(
+      dspClock: map['dspClock'] as int,
+      sampleRate: map['sampleRate'] as int,
+    );
+  }
+
+  /// The mixer clock, in output samples since the mixer started.
+  final int dspClock;
+
+  /// The mixer output sample rate.
+  final int sampleRate;
+
+  /// Converts a duration to a DSP clock offset at this [sampleRate].
+  int samplesFor(Duration duration) =>
+      duration.inMicroseconds * sampleRate ~/ Duration.microsecondsPerSecond;
+}
+
+/// A 3D vector in FMOD's coordinate space (left-handed, metres by default).
+class FmodVector {
+  const FmodVector(this.x, this.y, this.z);
+
+  static const FmodVector zero = FmodVector(0, 0, 0);
+
+  final double x;
+  final double y;
+  final double z;
+}
+
+/// Packed listener and emitter 3D attributes submitted to the native side
+/// once per frame with `FmodService.updateSpatial`.
+///
+/// Each entity occupies [stride] floats: position, velocity, forward and up
+/// vectors, matching `FMOD_3D_ATTRIBUTES`. Buffers are reused between frames;
+/// call [clear] and re-add emitters each frame.
+class FmodSpatialBatch {
+  FmodSpatialBatch({int listenerCount = 1, int emitterCapacity = 64})
+    : listeners = Float32List(listenerCount * stride),
+      _emitterIds = Int32List(emitterCapacity),
+      _emitters = Float32List(emitterCapacity * stride) {
+    for (var i = 0; i < listenerCount; i++) {
+      setListener(i, FmodVector.zero);
+    }
+  }
+
+  /// Number of floats per listener or emitter.
+  static const int stride = 12;
+
+  /// Packed attributes for every listener.
+  final Float32List listeners;
+
+  Int32List _emitterIds;
+  Float32List _emitters;
+  int _emitterCount = 0;
+
+  /// Number of emitters added since the last [clear].
+  int get emitterCount => _emitterCount;
+
+  /// Emitter ids, in the same order as [emitters].
+  Int32List get emitterIds =>
+      Int32List.sublistView(_emitterIds, 0, _emitterCount);
+
+  /// Packed attributes for every emitter added since the last [clear].
+  Float32List get emitters =>
+      Float32List.sublistView(_emitters, 0, _emitterCount * stride);
+
+  /// Set the attributes of listener [index].
+  void setListener(
+    int index,
+    FmodVector position, {
+    FmodVector velocity = FmodVector.zero,
+    FmodVector forward = const FmodVector(0, 0, 1),
+    FmodVector up = const FmodVector(0, 1, 0),
+  }) {
+    _write(listeners, index * stride, position, velocity, forward, up);
+  }
+
+  /// Add the attributes of an emitter created with `createEmitter`.
+  void addEmitter(
+    int emitterId,
+    FmodVector position, {
+    FmodVector velocity = FmodVector.zero,
+    FmodVector forward = const FmodVector(0, 0, 1),
+    FmodVector up = const FmodVector(0, 1, 0),
+  }) {
+    if (_emitterCount == _emitterIds.length) {
+      final capacity = _emitterIds.length * 2;
+      _emitterIds = Int32List(capacity)..setAll(0, _emitterIds);
+      _emitters = Float32List(capacity * stride)..setAll(0, _emitters);
+    }
+    _emitterIds[_emitterCount] = emitterId;
+    _write(_emitters, _emitterCount * stride, position, velocity, forward, up);
+    _emitterCount++;
+  }
+
+  /// Remove all emitters, keeping the buffers for reuse.
+  void clear() {
+    _emitterCount = 0;
+  }
+
+  static void _write(
+    Float32List data,
+    int offset,
+    FmodVector position,
+    FmodVector velocity,
+    FmodVector forward,
+    FmodVector up,
+  ) {
+    data[offset] = position.x;
+    data[offset + 1] = position.y;
+    data[offset + 2] = position.z;
+    data[offset + 3] = velocity.x;
+    data[offset + 4] = velocity.y;
+    data[offset + 5] = velocity.z;
+    data[offset + 6] = forward.x;
+    data[offset + 7] = forward.y;
+    data[offset + 8] = forward.z;
+    data[offset + 9] = up.x;
+    data[offset + 10] = up.y;
+    data[offset + 11] = up.z;
+  }
+}
+
+/// Built-in DSP effects that can be attached to a bus with `addBusEffect`.
+///
+/// The effects run natively on FMOD's mixer thread using SIMD kernels
+/// (NEON, SSE2 or AVX2, chosen at runtime).
+enum FmodBusEffectType {
+  /// Smooth saturating limiter. Parameters: [FmodSoftLimiterParam].
+  softLimiter,
+
+  /// Single biquad filter. Parameters: [FmodBiquadParam].
+  biquad,
+
+  /// Pass-through loudness meter. Parameters: [FmodLoudnessMeterParam].
+  /// Read it with `FmodService.readLoudness`.
+  loudnessMeter,
+}
+
+/// Parameter indices for [FmodBusEffectType.softLimiter].
+abstract final class FmodSoftLimiterParam {
+  /// Input gain before limiting, 0 to 24 dB (default 0).
+  static const int drive = 0;
+
+  /// Output ceiling, -24 to 0 dB (default -1).
+  static const int ceiling = 1;
+}
+
+/// Parameter indices for [FmodBusEffectType.biquad].
+abstract final class FmodBiquadParam {
+  /// Filter shape; use [FmodBiquadType.index] (default peaking).
+  static const int type = 0;
+
+  /// Cutoff or center frequency, 20 to 20000 Hz (default 1000).
+  static const int frequency = 1;
+
+  /// Resonance, 0.1 to 10 (default 0.707).
+  static const int q = 2;
+
+  /// Gain for peaking and shelf filters, -24 to 24 dB (default 0).
+  static const int gain = 3;
+}
+
+/// Filter shapes for [FmodBiquadParam.type].
+enum FmodBiquadType { lowPass, highPass, peaking, lowShelf, highShelf }
+
+/// The latest frame of a spectrum analyzer.
+class FmodSpectrumFrame {
+  /// Number of frames the analyzer has published; increases by one per
+  /// update tick, so an unchanged value means no new data.
+  final int sequence;
+
+  /// Mean power per log-spaced band from 20 Hz to 20 kHz, in dB and floored
+  /// at -100.
+  ///
+  /// On native platforms this is a view of native memory, not a copy. It is
+  /// only valid until the next `readSpectrum` call for the same analyzer;
+  /// copy it to keep it longer.
+  final Float32List bands;
+
+  const FmodSpectrumFrame({required this.sequence, required this.bands});
+}
+
+/// Parameter indices for [FmodBusEffectType.loudnessMeter].
+abstract final class FmodLoudnessMeterParam {
+  /// Set to 1 to restart the integrated loudness measurement.
+  static const int reset = 0;
+}
+
+/// A reading from a loudness meter, updated natively every 100 ms.
+///
+/// Loudness follows ITU-R BS.1770 / EBU R128. Every level is
+/// [double.negativeInfinity] for silence or until enough audio has been
+/// measured (400 ms for momentary, 3 s for short-term).
+class FmodLoudness {
+  /// Loudness over the last 400 ms, in LUFS.
+  final double momentaryLufs;
+
+  /// Loudness over the last 3 s, in LUFS.
+  final double shortTermLufs;
+
+  /// Gated loudness since the meter was added or reset, in LUFS.
+  final double integratedLufs;
+
+  /// RMS level of the last 100 ms across all channels, in dBFS.
+  final double rmsDb;
+
+  /// Sample peak of the last 100 ms, in dBFS.
+  final double peakDb;
+
+  /// 4x oversampled peak of the last 100 ms, in dBTP.
+  final double truePeakDb;
+
+  const FmodLoudness({
+    required this.momentaryLufs,
+    required this.shortTermLufs,
+    required this.integratedLufs,
+    required this.rmsDb,
+    required this.peakDb,
+    required this.truePeakDb,
+  });
+
+  @override
+  String toString() =>
+      'FmodLoudness(M: $momentaryLufs, S: $shortTermLufs, '
+      'I: $integratedLufs, RMS: $rmsDb, peak: $peakDb, TP: $truePeakDb)';
+}
+
+/// A cubic Bezier easing from (0, 0) to (1, 1), as in CSS `cubic-bezier()`.
+class FmodEasing {
+  const FmodEasing(this.x1, this.y1, this.x2, this.y2);
+
+  static const FmodEasing linear = FmodEasing(0, 0, 1, 1);
+  static const FmodEasing ease = FmodEasing(0.25, 0.1, 0.25, 1);
+  static const FmodEasing easeIn = FmodEasing(0.42, 0, 1, 1);
+  static const FmodEasing easeOut = FmodEasing(0, 0, 0.58, 1);
+  static const FmodEasing easeInOut = FmodEasing(0.42, 0, 0.58, 1);
+
+  final double x1;
+  final double y1;
+  final double x2;
+  final double y2;
+}
+
+/// A point on an [FmodAutomationCurve.keyframes] curve.
+class FmodKeyframe {
+  const FmodKeyframe(this.time, this.value, {this.easing = FmodEasing.linear});
+
+  /// Time since the curve started.
+  final Duration time;
+
+  /// Parameter value at [time].
+  final double value;
+
+  /// Easing of the segment that ends at this keyframe.
+  final FmodEasing easing;
+}
+
+/// Waveforms for [FmodAutomationCurve.lfo].
+enum FmodLfoWaveform { sine, triangle, square, saw }
+
+/// A parameter curve evaluated natively on every update tick by
+/// `FmodService.automateParameter`.
+///
+/// The curve is sent once as a packed [Float32List] whose layout matches
+/// `src/parameter_automation.h`.
+class FmodAutomationCurve {
+  const FmodAutomationCurve._(this.type, this.data);
+
+  /// Ramp linearly from the parameter's current value to [target].
+  factory FmodAutomationCurve.linear(double target, Duration duration) {
+    return FmodAutomationCurve._(
+      0,
+      Float32List.fromList([target, _seconds(duration)]),
+    );
+  }
+
+  /// Ramp from the current value to [target] along an exponential shape.
+  /// A positive [curvature] starts slowly and a negative one starts
+  /// quickly; 0 is linear.
+  factory FmodAutomationCurve.exponential(
+    double target,
+    Duration duration, {
+    double curvature = 4,
+  }) {
+    return FmodAutomationCurve._(
+      1,
+      Float32List.fromList([target, _seconds(duration), curvature]),
+    );
+  }
+
+  /// Follow [keyframes], which must be in time order. The curve starts at
+  /// the first keyframe's value and ends at the last keyframe.
+  factory FmodAutomationCurve.keyframes(List<FmodKeyframe> keyframes) {
+    final data = Float32List(keyframes.length * 6);
+    for (var i = 0; i < keyframes.length; i++) {
+      final key = keyframes[i];
+      data.setAll(i * 6, [
+        _seconds(key.time),
+        key.value,
+        key.easing.x1,
+        key.easing.y1,
+        key.easing.x2,
+        key.easing.y2,
+      ]);
+    }
+    return FmodAutomationCurve._(2, data);
+  }
+
+  /// Oscillate around [center] by [depth] at [rate] Hz, until cancelled or
+  /// for [duration] before returning to [center].
+  factory FmodAutomationCurve.lfo({
+    required double rate,
+    required double center,
+    required double depth,
+    FmodLfoWaveform waveform = FmodLfoWaveform.sine,
+    Duration? duration,
+  }) {
+    return FmodAutomationCurve._(
+      3,
+      Float32List.fromList([
+        waveform.index.toDouble(),
+        rate,
+        center,
+        depth,
+        duration == null ? 0 : _seconds(duration),
+      ]),
+    );
+  }
+
+  /// Rise from [floor] to [peak] over [attack], fall to [sustain] over
+  /// [decay], then release back to [floor] over [release]. The sustain level
+  /// holds for [hold], or until `FmodService.releaseAutomation` when [hold]
+  /// is null.
+  factory FmodAutomationCurve.adsr({
+    double floor = 0,
+    required double peak,
+    required double sustain,
+    Duration attack = Duration.zero,
+    Duration decay = Duration.zero,
+    Duration release = Duration.zero,
+    Duration? hold,
+  }) {
+    return FmodAutomationCurve._(
+      4,
+      Float32List.fromList([
+        floor,
+        peak,
+        sustain,
+        _seconds(attack),
+        _seconds(decay),
+        _seconds(release),
+        hold == null ? -1 : _seconds(hold),
+      ]),
+    );
+  }
+
+  /// Curve type, matching `FMOD_FLUTTER_CURVE_*`.
+  final int type;
+
+  /// Packed curve data.
+  final Float32List data;
+
+  static double _seconds(Duration duration) =>
+      duration.inMicroseconds / Duration.microsecondsPerSecond;
+}
+
+/// Global parameters resolved once with
+/// `FmodService.resolveGlobalParameters` and written together with
+/// `FmodService.setGlobalParameters`, which sends every value in one call
+/// and applies them natively with a single `SetParametersByIDs`.
+///
+/// Values persist between calls, so only the ones that change need to be
+/// written each frame.
+class FmodGlobalParameterBatch {
+  FmodGlobalParameterBatch(this.names, this.slots)
+    : values = Float32List(names.length);
+
+  /// Parameter names, in the order passed to `resolveGlobalParameters`.
+  final List<String> names;
+
+  /// Native slot of each name; -1 where no such global parameter exists.
+  final Int32List slots;
+
+  /// The value sent for each name.
+  final Float32List values;
+
+  /// Whether every name resolved to a global parameter.
+  bool get isResolved => !slots.contains(-1);
+
+  /// Set the value of [name].
+  void set(String name, double value) {
+    final index = names.indexOf(name);
+    if (index < 0) {
+      throw ArgumentError.value(name, 'name', 'not in this batch');
+    }
+    values[index] = value;
+  }
+
+  /// Set the value at [index] of [names].
+  void operator []=(int index, double value) {
+    values[index] = value;
+  }
+}
+
+/// Statistics of an event instance pool, or of every pool together.
+class FmodInstancePoolStats {
+  const FmodInstancePoolStats({
+    required this.idleCount,
+    required this.capacity,
+    required this.hits,
+    required this.misses,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodInstancePoolStats.fromMap(Map<dynamic, dynamic> map) {
+    return FmodInstancePoolStats(
+      idleCount: map['idleCount'] as int,
+      capacity: map['capacity'] as int,
+      hits: map['hits'] as int,
+      misses: map['misses'] as int,
+    );
+  }
+
+  /// Stopped instances waiting to be reused.
+  final int idleCount;
+
+  /// The most idle instances kept.
+  final int capacity;
+
+  /// Plays that reused an idle instance.
+  final int hits;
+
+  /// Plays that had to create an instance.
+  final int misses;
+
+  /// The fraction of plays that reused an instance, or 0 before any play.
+  double get hitRate {
+    final total = hits + misses;
+    return total == 0 ? 0 : hits / total;
+  }
+}
+
+/// What interrupted FMOD's audio.
+enum FmodInterruptionKind {
+  /// A phone call, alarm or voice assistant; audio comes back afterwards.
+  transient,
+
+  /// Another app playing briefly over this one, e.g. navigation prompts.
+  canDuck,
+
+  /// Another app took over audio until the user returns (Android).
+  loss,
+}
+
+/// How FMOD's output responds to an interruption.
+enum FmodInterruptionResponse {
+  /// Lower the output to [FmodInterruptionPolicy.duckVolume].
+  duck,
+
+  /// Pause the output; the mixer keeps running.
+  pause,
+
+  /// Pause the output and suspend the mixer thread.
+  suspend,
+}
+
+/// The response to each kind of audio interruption (Android audio focus
+/// loss, iOS audio session interruptions).
+class FmodInterruptionPolicy {
+  const FmodInterruptionPolicy({
+    this.transient = FmodInterruptionResponse.suspend,
+    this.canDuck = FmodInterruptionResponse.duck,
+    this.loss = FmodInterruptionResponse.suspend,
+    this.duckVolume = 0.25,
+    this.duckRamp = const Duration(milliseconds: 200),
+  });
+
+  /// Response to [FmodInterruptionKind.transient].
+  final FmodInterruptionResponse transient;
+
+  /// Response to [FmodInterruptionKind.canDuck].
+  final FmodInterruptionResponse canDuck;
+
+  /// Response to [FmodInterruptionKind.loss].
+  final FmodInterruptionResponse loss;
+
+  /// Output gain while ducked, 0 to 1.
+  final double duckVolume;
+
+  /// How long ducking and restoring take.
+  final Duration duckRamp;
+
+  /// The map sent over the method channel.
+  Map<String, dynamic> toMap() => {
+    'transient': transient.index,
+    'canDuck': canDuck.index,
+    'loss': loss.index,
+    'duckVolume': duckVolume,
+    'rampMs': duckRamp.inMilliseconds,
+  };
+}
+
+/// Reported when an audio interruption begins or ends.
+class FmodAudioInterruption {
+  const FmodAudioInterruption({
+    required this.interrupted,
+    this.kind,
+    this.response,
+    this.recovery,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodAudioInterruption.fromMap(Map<dynamic, dynamic> map) {
+    final interrupted = map['interrupted'] as bool;
+    final recoveryMs = map['recoveryMs'] as double?;
+    return FmodAudioInterruption(
+      interrupted: interrupted,
+      kind: interrupted
+          ? FmodInterruptionKind.values[map['kind'] as int]
+          : null,
+      response: interrupted
+          ? FmodInterruptionResponse.values[map['response'] as int]
+          : null,
+      recovery: recoveryMs == null
+          ? null
+          : Duration(microseconds: (recoveryMs * 1000).round()),
+    );
+  }
+
+  /// Whether the interruption began (true) or ended (false).
+  final bool interrupted;
+
+  /// What interrupted audio; set when [interrupted].
+  final FmodInterruptionKind? kind;
+
+  /// How the output responded; set when [interrupted].
+  final FmodInterruptionResponse? response;
+
+  /// How long output took to come back; set when the interruption ended.
+  final Duration? recovery;
+}
+
+/// Where FMOD sends its mix, chosen at initialization.
+///
+/// The non-realtime (Nrt) modes need no audio device and mix only when
+/// asked to, via `renderOffline`, as fast as the CPU allows. They are meant
+/// for headless tests, golden-audio comparisons and benchmarks.
+enum FmodOutputMode {
+  /// The default audio device, in realtime.
+  device,
+
+  /// No device, mixing in realtime.
+  noSound,
+
+  /// No device, mixing only when rendering.
+  noSoundNrt,
+
+  /// A .wav file, written only when rendering.
+  wavWriterNrt,
+
+  /// An in-memory buffer read with `getRenderedAudio`, filled only when
+  /// rendering.
+  memoryNrt,
+}
+
+/// Result of an offline render.
+class FmodRenderStats {
+  const FmodRenderStats({required this.rendered, required this.wallTime});
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodRenderStats.fromMap(Map<dynamic, dynamic> map) {
+    final renderedSeconds = map['renderedSeconds'] as double;
+    final renderMs = map['renderMs'] as double;
+    return FmodRenderStats(
+      rendered: Duration(microseconds: (renderedSeconds * 1e6).round()),
+      wallTime: Duration(microseconds: (renderMs * 1000).round()),
+    );
+  }
+
+  /// Audio mixed, rounded up to whole mixer blocks.
+  final Duration rendered;
+
+  /// Time the render took.
+  final Duration wallTime;
+
+  /// How many times faster than realtime the mix ran.
+  double get realtimeFactor => wallTime == Duration.zero
+      ? 0.0
+      : rendered.inMicroseconds / wallTime.inMicroseconds;
+}
+
+/// Mix captured by [FmodOutputMode.memoryNrt].
+class FmodRenderedAudio {
+  const FmodRenderedAudio({
+    required this.sampleRate,
+    required this.channels,
+    required this.samples,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodRenderedAudio.fromMap(Map<dynamic, dynamic> map) {
+    return FmodRenderedAudio(
+      sampleRate: map['sampleRate'] as int,
+      channels: map['channels'] as int,
+      samples: map['samples'] as Float32List,
+    );
+  }
+
+  final int sampleRate;
+  final int channels;
+
+  /// Interleaved samples, nominally in -1..1.
+  final Float32List samples;
+
+  /// Length of the captured audio.
+  Duration get duration => sampleRate == 0 || channels == 0
+      ? Duration.zero
+      : Duration(
+          microseconds: samples.length * 1000000 ~/ (sampleRate * channels),
+        );
+}
+
+/// Sample formats of an [FmodPcmBuffer]. Samples are interleaved.
+enum FmodPcmFormat {
+  /// 16-bit signed integers; view the buffer with [FmodPcmBuffer.asInt16].
+  int16,
+
+  /// 32-bit floats, nominally in -1..1; view the buffer with
+  /// [FmodPcmBuffer.asFloat32].
+  float32,
+}
+
+/// Native memory that sounds play PCM from, filled in place from Dart.
+///
+/// Created by `FmodService.createPcmBuffer`. [bytes] is a view of memory
+/// that never moves, so sounds made from the buffer read what Dart wrote
+/// without a copy. The native side counts references: this view holds one
+/// until it is garbage collected, and each sound made from the buffer holds
+/// another until it is released, so the memory outlives all of them.
+class FmodPcmBuffer {
+  const FmodPcmBuffer({required this.id, required this.bytes});
+
+  /// Native id passed to the bridges.
+  final int id;
+
+  /// The whole buffer, zeroed at creation.
+  final Uint8List bytes;
+
+  /// The buffer as 16-bit samples.
+  Int16List asInt16() =>
+      bytes.buffer.asInt16List(bytes.offsetInBytes, bytes.lengthInBytes ~/ 2);
+
+  /// The buffer as 32-bit float samples.
+  Float32List asFloat32() => bytes.buffer.asFloat32List(
+    bytes.offsetInBytes,
+    bytes.lengthInBytes ~/ 4,
+  );
+}
+
+/// A stream that PCM is pushed into while it plays, e.g. voice chat or
+/// procedural music.
+///
+/// Created by `FmodService.createPcmStream`. [write] copies samples straight
+/// into a lock-free native ring buffer through dart:ffi; FMOD's stream
+/// thread drains it and plays silence when it runs dry.
+class FmodPcmStream {
+  FmodPcmStream({
+    required this.id,
+    required this.sampleRate,
+    required this.channels,
+    required int Function(int streamId, Float32List samples) writer,
+  }) : _writer = writer;
+
+  final int id;
+  final int sampleRate;
+  final int channels;
+  final int Function(int streamId, Float32List samples) _writer;
+
+  /// Queue interleaved [samples], as many whole frames as fit in the ring.
+  ///
+  /// Returns the number of samples queued, which is less than
+  /// `samples.length` when the ring is full, or -1 once the stream has been
+  /// released. Never blocks; write from one isolate at a time.
+  int write(Float32List samples) => _writer(id, samples);
+}
+
+/// Buffering statistics of an [FmodPcmStream].
+class FmodPcmStreamStats {
+  const FmodPcmStreamStats({
+    required this.sampleRate,
+    required this.capacityFrames,
+    required this.queuedFrames,
+    required this.underruns,
+    required this.underrunFrames,
+    required this.droppedFrames,
+    required this.latency,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodPcmStreamStats.fromMap(Map<dynamic, dynamic> map) {
+    return FmodPcmStreamStats(
+      sampleRate: map['sampleRate'] as int,
+      capacityFrames: map['capacityFrames'] as int,
+      queuedFrames: map['queuedFrames'] as int,
+      underruns: map['underruns'] as int,
+      underrunFrames: map['underrunFrames'] as int,
+      droppedFrames: map['droppedFrames'] as int,
+      latency: Duration(microseconds: map['latencyUs'] as int),
+    );
+  }
+
+  final int sampleRate;
+
+  /// Frames the ring buffer holds.
+  final int capacityFrames;
+
+  /// Frames written but not yet read by FMOD.
+  final int queuedFrames;
+
+  /// Reads that found the ring empty after the first write.
+  final int underruns;
+
+  /// Frames of silence played in place of missing audio.
+  final int underrunFrames;
+
+  /// Frames refused because the ring was full.
+  final int droppedFrames;
+
+  /// Upper bound on the time from a write to the output: the queued audio,
+  /// FMOD's decode buffer and the mixer's DSP buffers.
+  final Duration latency;
+
+  /// Audio written but not yet played.
+  Duration get queued =>
+      Duration(microseconds: queuedFrames * 1000000 ~/ sampleRate);
+}
+
+/// Recording and monitoring statistics from
+/// [FmodService.getRecordingStats].
+class FmodRecordingStats {
+  const FmodRecordingStats({
+    required this.recording,
+    required this.monitoring,
+    required this.sampleRate,
+    required this.channels,
+    required this.recordedFrames,
+    required this.droppedSamples,
+    required this.monitorLatency,
+    required this.targetLatency,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodRecordingStats.fromMap(Map<dynamic, dynamic> map) {
+    return FmodRecordingStats(
+      recording: map['recording'] as bool,
+      monitoring: map['monitoring'] as bool,
+      sampleRate: map['sampleRate'] as int,
+      channels: map['channels'] as int,
+      recordedFrames: map['recordedFrames'] as int,
+      droppedSamples: map['droppedSamples'] as int,
+      monitorLatency: Duration(microseconds: map['monitorLatencyUs'] as int),
+      targetLatency: Duration(microseconds: map['targetLatencyUs'] as int),
+    );
+  }
+
+  /// Whether the driver is still recording; false once the device is lost.
+  final bool recording;
+
+  /// Whether the input is being played back through the output.
+  final bool monitoring;
+
+  /// Sample rate of the recorded audio, the device's native rate.
+  final int sampleRate;
+
+  /// Channels of the recorded audio, interleaved.
+  final int channels;
+
+  final int recordedFrames;
+
+  /// Recorded samples lost because they were not read in time.
+  final int droppedSamples;
+
+  /// Smoothed delay between recording and monitor playback.
+  final Duration monitorLatency;
+
+  /// The delay monitoring is held to: the requested latency, or the
+  /// driver's block size if that is larger.
+  final Duration targetLatency;
+}
+
+/// System-wide voice statistics over one window of
+/// [FmodService.startVoiceStats].
+class FmodVoiceStatsWindow {
+  const FmodVoiceStatsWindow({
+    required this.end,
+    required this.duration,
+    required this.samples,
+    required this.maxChannels,
+    required this.softwareChannels,
+    required this.realPeak,
+    required this.virtualPeak,
+    required this.saturatedSamples,
+    required this.realMean,
+    required this.virtualMean,
+    required this.starts,
+    required this.startFailures,
+    required this.virtualizations,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodVoiceStatsWindow.fromMap(Map<dynamic, dynamic> map) {
+    final samples = map['samples'] as int;
+    return FmodVoiceStatsWindow(
+      end: Duration(microseconds: map['endUs'] as int),
+      duration: Duration(microseconds: map['durationUs'] as int),
+      samples: samples,
+      maxChannels: map['maxChannels'] as int,
+      softwareChannels: map['softwareChannels'] as int,
+      realPeak: map['realPeak'] as int,
+      virtualPeak: map['virtualPeak'] as int,
+      saturatedSamples: map['saturatedSamples'] as int,
+      realMean: samples == 0 ? 0 : (map['realSum'] as int) / samples,
+      virtualMean: samples == 0 ? 0 : (map['virtualSum'] as int) / samples,
+      starts: map['starts'] as int,
+      startFailures: map['startFailures'] as int,
+      virtualizations: map['virtualizations'] as int,
+    );
+  }
+
+  /// When the window closed, since sampling started.
+  final Duration end;
+
+  final Duration duration;
+
+  /// Update ticks sampled.
+  final int samples;
+
+  /// The most voices, real or virtual, before FMOD steals one.
+  final int maxChannels;
+
+  /// The most voices mixed for real; the rest play virtual.
+  final int softwareChannels;
+
+  final int realPeak;
+  final int virtualPeak;
+
+  /// Ticks at [maxChannels], where any new voice stole a playing one.
+  final int saturatedSamples;
+
+  final double realMean;
+  final double virtualMean;
+
+  /// Event starts, summed over every event.
+  final int starts;
+
+  /// Starts refused by an event's instance limit.
+  final int startFailures;
+
+  /// Event instances that went virtual.
+  final int virtualizations;
+}
+
+/// Instance statistics of one event over the newest window of
+/// [FmodService.startVoiceStats].
+class FmodEventVoiceStats {
+  const FmodEventVoiceStats({
+    required this.path,
+    required this.instances,
+    required this.peakInstances,
+    required this.starts,
+    required this.startFailures,
+    required this.virtualizations,
+  });
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodEventVoiceStats.fromMap(Map<dynamic, dynamic> map) {
+    return FmodEventVoiceStats(
+      path: map['path'] as String,
+      instances: map['instances'] as int,
+      peakInstances: map['peakInstances'] as int,
+      starts: map['starts'] as int,
+      startFailures: map['startFailures'] as int,
+      virtualizations: map['virtualizations'] as int,
+    );
+  }
+
+  /// The event path, or its GUID when no strings bank is loaded.
+  final String path;
+
+  /// Live instances when the window closed.
+  final int instances;
+
+  final int peakInstances;
+  final int starts;
+
+  /// Starts refused by the event's instance limit.
+  final int startFailures;
+
+  /// Instances that went virtual.
+  final int virtualizations;
+}
+
+/// Voice statistics from [FmodService.getVoiceStats].
+class FmodVoiceStats {
+  const FmodVoiceStats({required this.windows, required this.events});
+
+  /// Creates an instance from the map sent over the method channel.
+  factory FmodVoiceStats.fromMap(Map<dynamic, dynamic> map) {
+    return FmodVoiceStats(
+      windows: [
+        for (final window in map['windows'] as List)
+          FmodVoiceStatsWindow.fromMap(window as Map),
+      ],
+      events: [
+        for (final event in map['events'] as List)
+          FmodEventVoiceStats.fromMap(event as Map),
+      ],
+    );
+  }
+
+  /// Complete windows, oldest first.
+  final List<FmodVoiceStatsWindow> windows;
+
+  /// Events of the newest window that had instances or counts, busiest
+  /// first.
+  final List<FmodEventVoiceStats> events;
+}
+
+/// Playback state of an event instance, in FMOD's order.
+enum FmodPlaybackState { playing, sustaining, stopped, starting, stopping }
+
+/// One event instance in an [FmodInstanceSnapshot].
+class FmodInstanceState {
+  const FmodInstanceState({
+    required this.eventPath,
+    required this.handle,
+    required this.emitterId,
+    required this.playbackState,
+    required this.timelinePosition,
+    required this.volume,
+    required this.paused,
+    required this.isVirtual,
+  });
+
+  /// The path the event was played under, or its GUID text for events
+  /// played by ID and, without a strings bank, for emitters.
+  final String eventPath;
+
+  /// Identifies the native instance while it lives; a later instance may
+  /// reuse the value.
+  final int handle;
+
+  /// The [FmodService.createEmitter] id, or null for events played with
+  /// [FmodService.playEvent].
+  final int? emitterId;
+
+  final FmodPlaybackState playbackState;
+  final Duration timelinePosition;
+
+  /// The volume set on the instance.
+  final double volume;
+
+  final bool paused;
+
+  /// Playing, but not mixed because every real voice is taken.
+  final bool isVirtual;
+
+  /// Whether the instance has started and not yet stopped.
+  bool get isPlaying =>
+      playbackState != FmodPlaybackState.stopped &&
+      playbackState != FmodPlaybackState.stopping;
+}
+
+/// Every event instance the plugin tracks, as of the latest update tick;
+/// from [FmodService.queryInstances].
+class FmodInstanceSnapshot {
+  const FmodInstanceSnapshot(this.instances);
+
+  /// Size of one native record in the 'states' bytes.
+  static const int recordSize = 32;
+
+  /// Creates an instance from the map sent over the method channel: the
+  /// records as little-endian bytes and one event key per record.
+  factory FmodInstanceSnapshot.fromMap(Map<dynamic, dynamic> map) {
+    final bytes = map['states'] as Uint8List;
+    final keys = map['keys'] as List;
+    final data = ByteData.sublistView(bytes);
+    final count = bytes.length ~/ recordSize;
+    return FmodInstanceSnapshot([
+      for (var i = 0; i < count && i < keys.length; i++)
+        _readState(data, i * recordSize, keys[i] as String),
+    ]);
+  }
+
+  static FmodInstanceState _readState(ByteData data, int offset, String key) {
+    final emitterId = data.getInt32(offset + 8, Endian.little);
+    final state = data.getInt32(offset + 12, Endian.little);
+    final known = state >= 0 && state < FmodPlaybackState.values.length;
+    return FmodInstanceState(
+      eventPath: key,
+      handle: data.getUint64(offset, Endian.little),
+      emitterId: emitterId == 0 ? null : emitterId,
+      playbackState: known
+          ? FmodPlaybackState.values[state]
+          : FmodPlaybackState.stopped,
+      timelinePosition: Duration(
+        milliseconds: data.getInt32(offset + 16, Endian.little),
+      ),
+      volume: data.getFloat32(offset + 20, Endian.little),
+      paused: data.getUint8(offset + 24) != 0,
+      isVirtual: data.getUint8(offset + 25) != 0,
+    );
+  }
+
+  final List<FmodInstanceState> instances;
+}
+
+/// The 128-bit ID FMOD Studio gives every event, snapshot, bus and VCA.
+///
+/// Held as the 16 bytes of an `FMOD_GUID` read as four little-endian 32-bit
+/// words, which is how `tool/bank_codegen` writes them. Unlike paths, IDs
+/// survive renames in FMOD Studio and resolve without the strings bank.
+class FmodGuid {
+  const FmodGuid(this.word0, this.word1, this.word2, this.word3);
+
+  /// Parses FMOD's `{xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx}` form, with or
+  /// without braces.
+  factory FmodGuid.parse(String text) {
+    final hex = text.replaceAll(RegExp(r'[{}\-]'), '');
+    if (hex.length != 32 || !RegExp(r'^[0-9a-fA-F]+$').hasMatch(hex)) {
+      throw FormatException('Not an FMOD GUID', text);
+    }
+    int field(int start, int length) =>
+        int.parse(hex.substring(start, start + length), radix: 16);
+    // Data4 is a byte array, so its bytes keep their textual order.
+    int bytes(int start) =>
+        field(start, 2) |
+        field(start + 2, 2) << 8 |
+        field(start + 4, 2) << 16 |
+        field(start + 6, 2) << 24;
+    return FmodGuid(
+      field(0, 8),
+      field(8, 4) | field(12, 4) << 16,
+      bytes(16),
+      bytes(24),
+    );
+  }
+
+  final int word0;
+  final int word1;
+  final int word2;
+  final int word3;
+
+  /// The 16 bytes of the `FMOD_GUID`, as the native bridges take them.
+  Uint8List get bytes {
+    final data = ByteData(16)
+      ..setUint32(0, word0, Endian.little)
+      ..setUint32(4, word1, Endian.little)
+      ..setUint32(8, word2, Endian.little)
+      ..setUint32(12, word3, Endian.little);
+    return data.buffer.asUint8List();
+  }
+
+  @override
+  bool operator ==(Object other) =>
+      other is FmodGuid &&
+      other.word0 == word0 &&
+      other.word1 == word1 &&
+      other.word2 == word2 &&
+      other.word3 == word3;
+
+  @override
+  int get hashCode => Object.hash(word0, word1, word2, word3);
+
+  /// FMOD's braced form, as FMOD Studio shows it.
+  @override
+  String toString() {
+    String hex(int value, int digits) =>
+        value.toRadixString(16).padLeft(digits, '0');
+    final data4 = bytes.sublist(8).map((byte) => hex(byte, 2)).join();
+    return '{${hex(word0, 8)}-${hex(word1 & 0xffff, 4)}-'
+        '${hex(word1 >> 16, 4)}-${data4.substring(0, 4)}-'
+        '${data4.substring(4)}}';
+  }
+}
+
+/// An event or snapshot, as generated by `tool/bank_codegen`.
+class FmodEventRef {
+  const FmodEventRef(this.path, this.id);
+
+  /// The `event:/` or `snapshot:/` path, for the path-based methods.
+  final String path;
+
+  final FmodGuid id;
+
+  @override
+  String toString() => path;
+}
+
+/// A mixer bus, as generated by `tool/bank_codegen`.
+class FmodBusRef {
+  const FmodBusRef(this.path, this.id);
+
+  /// The `bus:/` path, for the bus methods.
+  final String path;
+
+  final FmodGuid id;
+
+  @override
+  String toString() => path;
+}
+
+/// A VCA, as generated by `tool/bank_codegen`.
+class FmodVcaRef {
+  const FmodVcaRef(this.path, this.id);
+
+  /// The `vca:/` path, for the VCA methods.
+  final String path;
+
+  final FmodGuid id;
+
+  @override
+  String toString() => path;
+}
+
+/// An event or global parameter, as generated by `tool/bank_codegen`.
+class FmodParameterRef {
+  const FmodParameterRef(this.name, this.data1, this.data2);
+
+  /// The name setParameter and setGlobalParameter take.
+  final String name;
+
+  /// The two words of the `FMOD_STUDIO_PARAMETER_ID`.
+  final int data1;
+  final int data2;
+
+  @override
+  String toString() => name;
+}
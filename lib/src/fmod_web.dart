@@ -5,6 +5,7 @@ import 'dart:js_interop_unsafe';
 import 'package:flutter_web_plugins/flutter_web_plugins.dart';
 
 import 'fmod_platform_interface.dart';
+import 'fmod_types.dart';
 
 /// Web implementation of FmodPlatform using FMOD's Emscripten-compiled WASM API.
 ///
@@ -74,7 +75,10 @@ class FmodWeb extends FmodPlatform {
   // ------------------------------------------------------------------
 
   @override
-  Future<bool> initialize() async {
+  Future<bool> initialize({
+    FmodOutputMode output = FmodOutputMode.device,
+    String? wavPath,
+  }) async {
     if (_isInitialized) return true;
 
     try {
@@ -451,6 +455,18 @@ class FmodWeb extends FmodPlatform {
     }
   }
 
+  @override
+  Future<void> setPitch(String eventPath, double pitch) async {
+    if (!_isInitialized) return;
+    final instance = _eventInstances[eventPath];
+    if (instance == null) return;
+    try {
+      _call(instance, 'setPitch', [pitch.toJS]);
+    } catch (e) {
+      print('[FMOD Web] setPitch error on $eventPath: $e');
+    }
+  }
+
   @override
   Future<void> setMasterPaused(bool paused) async {
     if (!_isInitialized || _system == null) return;
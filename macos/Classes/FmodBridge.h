@@ -11,19 +11,162 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface FmodBridge : NSObject
 
-- (BOOL)initializeFmod;
+// outputMode is one of FMOD_FLUTTER_OUTPUT_* (offline_output.h); wavPath is
+// the file written in WAVWRITER_NRT mode.
+- (BOOL)initializeFmodWithOutput:(int)outputMode
+                         wavPath:(nullable NSString *)wavPath
+    NS_SWIFT_NAME(initializeFmod(output:wavPath:));
 - (BOOL)loadBankAtPath:(NSString *)path;
+// Event methods take an event path, or the key this returns for the 16
+// bytes of an event's FMOD_GUID (see event_lookup.h).
++ (NSString *)eventKeyForId:(NSData *)eventId NS_SWIFT_NAME(eventKey(forId:));
 - (BOOL)playEvent:(NSString *)eventPath;
+- (unsigned long long)playEvent:(NSString *)eventPath
+              atDSPClockOffset:(unsigned long long)offset
+                  fromDSPClock:(unsigned long long)fromClock
+    NS_SWIFT_NAME(playEvent(_:dspClockOffset:fromDspClock:));
+- (nullable NSDictionary<NSString *, NSNumber *> *)currentDSPClock;
 - (BOOL)stopEvent:(NSString *)eventPath;
 - (BOOL)setParameterForEvent:(NSString *)eventPath
                    paramName:(NSString *)paramName
                        value:(float)value;
 - (BOOL)setPausedForEvent:(NSString *)eventPath paused:(BOOL)paused;
 - (BOOL)setVolumeForEvent:(NSString *)eventPath volume:(float)volume;
+- (BOOL)setPitchForEvent:(NSString *)eventPath pitch:(float)pitch;
 - (void)update;
 - (void)releaseFmod;
 - (void)logAvailableEvents;
 - (BOOL)setMasterPaused:(BOOL)paused;
+- (BOOL)setBusVolume:(NSString *)busPath volume:(float)volume rampMs:(int)rampMs
+    NS_SWIFT_NAME(setBusVolume(_:volume:rampMs:));
+- (BOOL)setVcaVolume:(NSString *)vcaPath volume:(float)volume rampMs:(int)rampMs
+    NS_SWIFT_NAME(setVcaVolume(_:volume:rampMs:));
+- (BOOL)setBusMute:(NSString *)busPath muted:(BOOL)muted
+    NS_SWIFT_NAME(setBusMute(_:muted:));
+- (BOOL)setBusPaused:(NSString *)busPath paused:(BOOL)paused
+    NS_SWIFT_NAME(setBusPaused(_:paused:));
+- (BOOL)startSnapshot:(NSString *)snapshotPath;
+- (BOOL)stopSnapshot:(NSString *)snapshotPath allowFadeOut:(BOOL)allowFadeOut
+    NS_SWIFT_NAME(stopSnapshot(_:allowFadeOut:));
+- (int)automateParameterForEvent:(NSString *)eventPath
+                       paramName:(NSString *)paramName
+                            type:(int)type
+                            data:(const float *_Nullable)data
+                       dataCount:(int)dataCount
+    NS_SWIFT_NAME(automateParameter(eventPath:paramName:type:data:dataCount:));
+- (BOOL)releaseAutomation:(int)automationId;
+- (BOOL)cancelAutomation:(int)automationId;
+- (BOOL)setGlobalParameter:(NSString *)name value:(float)value
+    NS_SWIFT_NAME(setGlobalParameter(_:value:));
+- (nullable NSNumber *)globalParameterValue:(NSString *)name;
+- (NSData *)resolveGlobalParameters:(NSArray<NSString *> *)names;
+- (BOOL)setGlobalParametersWithSlots:(const int32_t *_Nullable)slots
+                              values:(const float *_Nullable)values
+                               count:(int)count
+    NS_SWIFT_NAME(setGlobalParameters(slots:values:count:));
+- (BOOL)suspendMixer;
+- (BOOL)resumeMixer;
+- (double)lastMixerResumeMs;
+- (BOOL)isMixerSuspended;
+- (BOOL)isNonRealtime;
+// Mixes seconds of audio faster than realtime in a non-realtime output
+// mode; returns renderedSeconds and renderMs, or nil on failure.
+- (nullable NSDictionary<NSString *, NSNumber *> *)renderOffline:(double)seconds;
+// The mix captured by the memory output since the last call: sampleRate,
+// channels and interleaved float samples (NSData), or nil.
+- (nullable NSDictionary<NSString *, id> *)takeRenderedAudio;
+// Loose sounds outside Studio banks, including the compact .fca format.
+// loadSoundAtPath returns a sound id, or 0 on failure.
+- (int)loadSoundAtPath:(NSString *)path stream:(BOOL)stream
+    NS_SWIFT_NAME(loadSound(atPath:stream:));
+- (BOOL)playSound:(int)soundId volume:(float)volume;
+- (BOOL)unloadSound:(int)soundId;
+// Sounds over PCM that Dart wrote into a pcm_sounds.h buffer, without a
+// copy. createPcmSound adds one to the loose sounds above and returns its
+// id, or 0; playEventWithPcm starts a one-shot event whose programmer
+// instruments play the buffer.
+- (int)createPcmSoundWithBuffer:(int)bufferId
+                     sampleRate:(int)sampleRate
+                       channels:(int)channels
+                         format:(int)format
+    NS_SWIFT_NAME(createPcmSound(bufferId:sampleRate:channels:format:));
+- (BOOL)playEvent:(NSString *)eventPath
+    withPcmBuffer:(int)bufferId
+       sampleRate:(int)sampleRate
+         channels:(int)channels
+           format:(int)format
+    NS_SWIFT_NAME(playEventWithPcm(_:bufferId:sampleRate:channels:format:));
+// Streams that Dart pushes float PCM into through dart:ffi.
+// createPcmStream returns a stream id, or 0 on failure.
+- (int)createPcmStreamWithSampleRate:(int)sampleRate
+                            channels:(int)channels
+                          capacityMs:(int)capacityMs
+    NS_SWIFT_NAME(createPcmStream(sampleRate:channels:capacityMs:));
+- (BOOL)releasePcmStream:(int)streamId;
+- (nullable NSDictionary<NSString *, NSNumber *> *)pcmStreamStats:(int)streamId
+    NS_SWIFT_NAME(pcmStreamStats(_:));
+// Microphone recording; Dart reads the recorded audio through dart:ffi.
+// With monitor set, the input also plays back latencyMs behind.
+- (BOOL)startRecordingFromDriver:(int)driver
+                         monitor:(BOOL)monitor
+                       latencyMs:(int)latencyMs
+    NS_SWIFT_NAME(startRecording(driver:monitor:latencyMs:));
+- (BOOL)stopRecording;
+- (nullable NSDictionary<NSString *, NSNumber *> *)recordingStats;
+// Voice and virtualization statistics aggregated over windows of windowMs.
+// voiceStats holds the complete windows, oldest first, under "windows" and
+// the events of the newest one under "events".
+- (BOOL)startVoiceStatsWithWindowMs:(int)windowMs
+    NS_SWIFT_NAME(startVoiceStats(windowMs:));
+- (void)stopVoiceStats;
+- (NSDictionary<NSString *, NSArray *> *)voiceStats;
+// Every live event and emitter instance as of the last update tick:
+// packed FmodInstanceState records (instance_states.h, NSData) under
+// "states" and the event key of each under "keys".
+- (NSDictionary<NSString *, id> *)queryInstances;
+- (BOOL)startCommandCaptureToPath:(NSString *)path
+                 flushEachCommand:(BOOL)flushEachCommand
+    NS_SWIFT_NAME(startCommandCapture(path:flushEachCommand:));
+- (BOOL)stopCommandCapture;
+- (BOOL)configureInstancePoolForEvent:(NSString *)eventPath
+                         prewarmCount:(int)prewarmCount
+                             capacity:(int)capacity
+    NS_SWIFT_NAME(configureInstancePool(eventPath:prewarmCount:capacity:));
+- (nullable NSDictionary<NSString *, NSNumber *> *)instancePoolStatsForEvent:(nullable NSString *)eventPath
+    NS_SWIFT_NAME(instancePoolStats(eventPath:));
+- (int)scheduleAtBeatForEvent:(NSString *)eventPath
+                          bar:(int)bar
+                         beat:(int)beat
+                   startEvent:(nullable NSString *)startEventPath
+    NS_SWIFT_NAME(scheduleAtBeat(eventPath:bar:beat:startEvent:));
+- (BOOL)cancelBeatSchedule:(int)scheduleId;
+- (int)createEmitterForEvent:(NSString *)eventPath start:(BOOL)start
+    NS_SWIFT_NAME(createEmitter(eventPath:start:));
+- (BOOL)releaseEmitter:(int)emitterId;
+- (BOOL)updateSpatialWithListeners:(const float *)listeners
+                     listenerCount:(int)listenerCount
+                        emitterIds:(const int32_t *_Nullable)emitterIds
+                 emitterAttributes:(const float *_Nullable)emitterAttributes
+                      emitterCount:(int)emitterCount
+    NS_SWIFT_NAME(updateSpatial(listeners:listenerCount:emitterIds:emitterAttributes:emitterCount:));
+- (void)setEmitterCulling:(BOOL)enabled hysteresis:(float)hysteresis
+    NS_SWIFT_NAME(setEmitterCulling(_:hysteresis:));
+- (int)addEffectToBus:(NSString *)busPath
+                 type:(int)type
+     parameterIndices:(const int32_t *_Nullable)parameterIndices
+      parameterValues:(const float *_Nullable)parameterValues
+       parameterCount:(int)parameterCount
+    NS_SWIFT_NAME(addBusEffect(busPath:type:parameterIndices:parameterValues:parameterCount:));
+- (BOOL)removeBusEffect:(int)effectId;
+- (BOOL)setBusEffectParameter:(int)effectId index:(int)index value:(float)value
+    NS_SWIFT_NAME(setBusEffectParameter(_:index:value:));
+- (int)addSpectrumAnalyzer:(NSString *)target bands:(int)bands windowSize:(int)windowSize
+    NS_SWIFT_NAME(addSpectrumAnalyzer(_:bands:windowSize:));
+- (BOOL)removeSpectrumAnalyzer:(int)analyzerId;
+- (NSArray<NSDictionary<NSString *, NSNumber *> *> *)drainFiredBeatSchedules;
+// Events whose instance finished on its own and was reclaimed by update
+// since the last call.
+- (NSArray<NSString *> *)drainFinishedEvents;
 
 @end
 
@@ -2,21 +2,27 @@ import FlutterMacOS
 
 public class FmodFlutterPlugin: NSObject, FlutterPlugin {
     private var fmodManager: FmodManager?
+    private var channel: FlutterMethodChannel?
     
     public static func register(with registrar: FlutterPluginRegistrar) {
         let channel = FlutterMethodChannel(name: "fmod_flutter", binaryMessenger: registrar.messenger)
         let instance = FmodFlutterPlugin()
+        instance.channel = channel
         registrar.addMethodCallDelegate(instance, channel: channel)
     }
 
     public func handle(_ call: FlutterMethodCall, result: @escaping FlutterResult) {
         switch call.method {
         case "initialize":
-            handleInitialize(result: result)
+            handleInitialize(call: call, result: result)
         case "loadBanks":
             handleLoadBanks(call: call, result: result)
         case "playEvent":
             handlePlayEvent(call: call, result: result)
+        case "playEventAt":
+            handlePlayEventAt(call: call, result: result)
+        case "getDspClock":
+            result(fmodManager?.getDspClock())
         case "stopEvent":
             handleStopEvent(call: call, result: result)
         case "setParameter":
@@ -25,8 +31,114 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
             handleSetPaused(call: call, result: result)
         case "setVolume":
             handleSetVolume(call: call, result: result)
+        case "setPitch":
+            handleSetPitch(call: call, result: result)
         case "setMasterPaused":
             handleSetMasterPaused(call: call, result: result)
+        case "scheduleAtBeat":
+            handleScheduleAtBeat(call: call, result: result)
+        case "cancelBeatSchedule":
+            handleCancelBeatSchedule(call: call, result: result)
+        case "createEmitter":
+            handleCreateEmitter(call: call, result: result)
+        case "releaseEmitter":
+            handleReleaseEmitter(call: call, result: result)
+        case "updateSpatial":
+            handleUpdateSpatial(call: call, result: result)
+        case "setEmitterCulling":
+            handleSetEmitterCulling(call: call, result: result)
+        case "addBusEffect":
+            handleAddBusEffect(call: call, result: result)
+        case "removeBusEffect":
+            handleRemoveBusEffect(call: call, result: result)
+        case "setBusEffectParameter":
+            handleSetBusEffectParameter(call: call, result: result)
+        case "addSpectrumAnalyzer":
+            handleAddSpectrumAnalyzer(call: call, result: result)
+        case "removeSpectrumAnalyzer":
+            handleRemoveSpectrumAnalyzer(call: call, result: result)
+        case "setBusVolume", "setVcaVolume":
+            handleSetMixerVolume(call: call, result: result)
+        case "setBusMute":
+            handleSetBusMute(call: call, result: result)
+        case "setBusPaused":
+            handleSetBusPaused(call: call, result: result)
+        case "startSnapshot":
+            handleStartSnapshot(call: call, result: result)
+        case "stopSnapshot":
+            handleStopSnapshot(call: call, result: result)
+        case "setGlobalParameter":
+            handleSetGlobalParameter(call: call, result: result)
+        case "getGlobalParameter":
+            handleGetGlobalParameter(call: call, result: result)
+        case "resolveGlobalParameters":
+            handleResolveGlobalParameters(call: call, result: result)
+        case "setGlobalParameters":
+            handleSetGlobalParameters(call: call, result: result)
+        case "suspendMixer":
+            result(fmodManager?.suspendMixer() ?? false)
+        case "resumeMixer":
+            result(fmodManager?.resumeMixer() ?? false)
+        case "getMixerResumeLatency":
+            result(fmodManager?.getMixerResumeLatency())
+        case "renderOffline":
+            handleRenderOffline(call: call, result: result)
+        case "getRenderedAudio":
+            handleGetRenderedAudio(result: result)
+        case "loadSound":
+            handleLoadSound(call: call, result: result)
+        case "playSound":
+            handlePlaySound(call: call, result: result)
+        case "unloadSound":
+            handleUnloadSound(call: call, result: result)
+        case "createPcmSound":
+            handleCreatePcmSound(call: call, result: result)
+        case "playEventWithPcm":
+            handlePlayEventWithPcm(call: call, result: result)
+        case "createPcmStream":
+            handleCreatePcmStream(call: call, result: result)
+        case "releasePcmStream":
+            handleReleasePcmStream(call: call, result: result)
+        case "getPcmStreamStats":
+            let args = call.arguments as? [String: Any]
+            guard let id = args?["id"] as? Int else {
+                result(FlutterError(code: "INVALID_ARGS", message: "Stream id required", details: nil))
+                return
+            }
+            result(fmodManager?.getPcmStreamStats(id))
+        case "startRecording":
+            handleStartRecording(call: call, result: result)
+        case "stopRecording":
+            result(fmodManager?.stopRecording() ?? false)
+        case "getRecordingStats":
+            result(fmodManager?.getRecordingStats())
+        case "startVoiceStats":
+            let args = call.arguments as? [String: Any]
+            guard let windowMs = args?["windowMs"] as? Int else {
+                result(FlutterError(code: "INVALID_ARGS", message: "Window length required", details: nil))
+                return
+            }
+            result(fmodManager?.startVoiceStats(windowMs: windowMs) ?? false)
+        case "stopVoiceStats":
+            fmodManager?.stopVoiceStats()
+            result(nil)
+        case "getVoiceStats":
+            result(fmodManager?.getVoiceStats())
+        case "queryInstances":
+            handleQueryInstances(result: result)
+        case "startCommandCapture":
+            handleStartCommandCapture(call: call, result: result)
+        case "stopCommandCapture":
+            result(fmodManager?.stopCommandCapture() ?? false)
+        case "configureInstancePool":
+            handleConfigureInstancePool(call: call, result: result)
+        case "getInstancePoolStats":
+            let args = call.arguments as? [String: Any]
+            result(fmodManager?.getInstancePoolStats(args?["path"] as? String))
+        case "automateParameter":
+            handleAutomateParameter(call: call, result: result)
+        case "releaseAutomation", "cancelAutomation":
+            handleEndAutomation(call: call, result: result)
         case "update":
             fmodManager?.update()
             result(nil)
@@ -39,9 +151,17 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
         }
     }
     
-    private func handleInitialize(result: @escaping FlutterResult) {
+    private func handleInitialize(call: FlutterMethodCall, result: @escaping FlutterResult) {
         fmodManager = FmodManager()
-        let success = fmodManager?.initialize() ?? false
+        fmodManager?.onBeatScheduleFired = { [weak self] args in
+            self?.channel?.invokeMethod("onBeatScheduleFired", arguments: args)
+        }
+        fmodManager?.onEventsFinished = { [weak self] paths in
+            self?.channel?.invokeMethod("onEventsFinished", arguments: paths)
+        }
+        let args = call.arguments as? [String: Any]
+        let success = fmodManager?.initialize(output: args?["output"] as? Int ?? 0,
+                                              wavPath: args?["wavPath"] as? String) ?? false
         result(success)
     }
     
@@ -56,9 +176,21 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
         result(success)
     }
     
+    // The event an event method targets: a path, or an event ID sent as the
+    // 16 bytes of an FMOD_GUID, which becomes its ID key.
+    private func eventKey(_ value: Any?) -> String? {
+        if let path = value as? String {
+            return path
+        }
+        if let id = value as? FlutterStandardTypedData, id.data.count == 16 {
+            return fmodManager?.eventIdKey(id.data)
+        }
+        return nil
+    }
+    
     private func handlePlayEvent(call: FlutterMethodCall, result: @escaping FlutterResult) {
         guard let args = call.arguments as? [String: Any],
-              let path = args["path"] as? String else {
+              let path = eventKey(args["path"]) else {
             result(FlutterError(code: "INVALID_ARGS", message: "Event path required", details: nil))
             return
         }
@@ -67,9 +199,24 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
         result(nil)
     }
     
+    private func handlePlayEventAt(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = eventKey(args["path"]),
+              let offset = args["offset"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path and offset required", details: nil))
+            return
+        }
+        
+        let fromDspClock = args["fromDspClock"] as? Int ?? 0
+        let startClock = fmodManager?.playEventAt(path,
+                                                  dspClockOffset: UInt64(max(offset, 0)),
+                                                  fromDspClock: UInt64(max(fromDspClock, 0))) ?? 0
+        result(Int(startClock))
+    }
+    
     private func handleStopEvent(call: FlutterMethodCall, result: @escaping FlutterResult) {
         guard let args = call.arguments as? [String: Any],
-              let path = args["path"] as? String else {
+              let path = eventKey(args["path"]) else {
             result(FlutterError(code: "INVALID_ARGS", message: "Event path required", details: nil))
             return
         }
@@ -80,7 +227,7 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
     
     private func handleSetParameter(call: FlutterMethodCall, result: @escaping FlutterResult) {
         guard let args = call.arguments as? [String: Any],
-              let path = args["path"] as? String,
+              let path = eventKey(args["path"]),
               let parameter = args["parameter"] as? String,
               let value = args["value"] as? Double else {
             result(FlutterError(code: "INVALID_ARGS", message: "Path, parameter, and value required", details: nil))
@@ -93,7 +240,7 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
     
     private func handleSetPaused(call: FlutterMethodCall, result: @escaping FlutterResult) {
         guard let args = call.arguments as? [String: Any],
-              let path = args["path"] as? String,
+              let path = eventKey(args["path"]),
               let paused = args["paused"] as? Bool else {
             result(FlutterError(code: "INVALID_ARGS", message: "Path and paused state required", details: nil))
             return
@@ -105,7 +252,7 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
     
     private func handleSetVolume(call: FlutterMethodCall, result: @escaping FlutterResult) {
         guard let args = call.arguments as? [String: Any],
-              let path = args["path"] as? String,
+              let path = eventKey(args["path"]),
               let volume = args["volume"] as? Double else {
             result(FlutterError(code: "INVALID_ARGS", message: "Path and volume required", details: nil))
             return
@@ -115,6 +262,18 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
         result(nil)
     }
     
+    private func handleSetPitch(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = eventKey(args["path"]),
+              let pitch = args["pitch"] as? Double else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path and pitch required", details: nil))
+            return
+        }
+        
+        fmodManager?.setPitch(path: path, pitch: Float(pitch))
+        result(nil)
+    }
+    
     private func handleSetMasterPaused(call: FlutterMethodCall, result: @escaping FlutterResult) {
         guard let args = call.arguments as? [String: Any],
               let paused = args["paused"] as? Bool else {
@@ -125,4 +284,421 @@ public class FmodFlutterPlugin: NSObject, FlutterPlugin {
         fmodManager?.setMasterPaused(paused)
         result(nil)
     }
+    
+    private func handleScheduleAtBeat(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = eventKey(args["path"]),
+              let bar = args["bar"] as? Int,
+              let beat = args["beat"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path, bar, and beat required", details: nil))
+            return
+        }
+        
+        let startEvent = eventKey(args["startEvent"])
+        result(fmodManager?.scheduleAtBeat(path: path, bar: bar, beat: beat, startEvent: startEvent) ?? 0)
+    }
+    
+    private func handleCancelBeatSchedule(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Schedule id required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.cancelBeatSchedule(id) ?? false)
+    }
+    
+    private func handleCreateEmitter(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = eventKey(args["path"]) else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Event path required", details: nil))
+            return
+        }
+        
+        let start = args["start"] as? Bool ?? true
+        result(fmodManager?.createEmitter(path: path, start: start) ?? 0)
+    }
+    
+    private func handleReleaseEmitter(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Emitter id required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.releaseEmitter(id) ?? false)
+    }
+    
+    private func handleUpdateSpatial(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let listeners = args["listeners"] as? FlutterStandardTypedData,
+              let emitterIds = args["emitterIds"] as? FlutterStandardTypedData,
+              let emitters = args["emitters"] as? FlutterStandardTypedData,
+              listeners.data.count >= 12 * MemoryLayout<Float>.size else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Listeners, emitter ids, and emitters required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.updateSpatial(listeners: listeners.data,
+                                          emitterIds: emitterIds.data,
+                                          emitters: emitters.data) ?? false)
+    }
+    
+    private func handleSetEmitterCulling(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let enabled = args["enabled"] as? Bool,
+              let hysteresis = args["hysteresis"] as? Double else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Enabled and hysteresis required", details: nil))
+            return
+        }
+        
+        fmodManager?.setEmitterCulling(enabled, hysteresis: Float(hysteresis))
+        result(nil)
+    }
+    
+    private func handleAddBusEffect(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let busPath = args["busPath"] as? String,
+              let type = args["type"] as? Int,
+              let parameterIndices = args["parameterIndices"] as? FlutterStandardTypedData,
+              let parameterValues = args["parameterValues"] as? FlutterStandardTypedData else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Bus path, type, and parameters required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.addBusEffect(busPath: busPath,
+                                         type: type,
+                                         parameterIndices: parameterIndices.data,
+                                         parameterValues: parameterValues.data) ?? 0)
+    }
+    
+    private func handleRemoveBusEffect(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Effect id required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.removeBusEffect(id) ?? false)
+    }
+    
+    private func handleSetBusEffectParameter(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int,
+              let index = args["index"] as? Int,
+              let value = args["value"] as? Double else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Effect id, index, and value required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.setBusEffectParameter(id, index: index, value: Float(value)) ?? false)
+    }
+    
+    private func handleAddSpectrumAnalyzer(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let target = args["target"] as? String,
+              let bands = args["bands"] as? Int,
+              let windowSize = args["windowSize"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Target, bands, and window size required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.addSpectrumAnalyzer(target, bands: bands, windowSize: windowSize) ?? 0)
+    }
+    
+    private func handleRemoveSpectrumAnalyzer(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Analyzer id required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.removeSpectrumAnalyzer(id) ?? false)
+    }
+    
+    private func handleSetMixerVolume(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let volume = args["volume"] as? Double,
+              let rampMs = args["rampMs"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path, volume, and ramp required", details: nil))
+            return
+        }
+        
+        if call.method == "setVcaVolume" {
+            result(fmodManager?.setVcaVolume(path, volume: Float(volume), rampMs: rampMs) ?? false)
+        } else {
+            result(fmodManager?.setBusVolume(path, volume: Float(volume), rampMs: rampMs) ?? false)
+        }
+    }
+    
+    private func handleSetBusMute(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let muted = args["muted"] as? Bool else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path and muted state required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.setBusMute(path, muted: muted) ?? false)
+    }
+    
+    private func handleSetBusPaused(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let paused = args["paused"] as? Bool else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path and paused state required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.setBusPaused(path, paused: paused) ?? false)
+    }
+    
+    private func handleStartSnapshot(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Snapshot path required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.startSnapshot(path) ?? false)
+    }
+    
+    private func handleStopSnapshot(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let allowFadeOut = args["allowFadeOut"] as? Bool else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Snapshot path and fade out flag required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.stopSnapshot(path, allowFadeOut: allowFadeOut) ?? false)
+    }
+    
+    private func handleSetGlobalParameter(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let name = args["name"] as? String,
+              let value = args["value"] as? Double else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Name and value required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.setGlobalParameter(name, value: Float(value)) ?? false)
+    }
+    
+    private func handleGetGlobalParameter(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let name = args["name"] as? String else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Name required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.getGlobalParameter(name))
+    }
+    
+    private func handleResolveGlobalParameters(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let names = args["names"] as? [String] else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Parameter names required", details: nil))
+            return
+        }
+        
+        guard let slots = fmodManager?.resolveGlobalParameters(names) else {
+            result(nil)
+            return
+        }
+        result(FlutterStandardTypedData(int32: slots))
+    }
+    
+    private func handleSetGlobalParameters(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let slots = args["slots"] as? FlutterStandardTypedData,
+              let values = args["values"] as? FlutterStandardTypedData else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Slots and values required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.setGlobalParameters(slots: slots.data, values: values.data) ?? false)
+    }
+    
+    private func handleRenderOffline(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let seconds = args["seconds"] as? Double else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Render duration required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.renderOffline(seconds))
+    }
+    
+    private func handleQueryInstances(result: @escaping FlutterResult) {
+        guard var snapshot = fmodManager?.queryInstances(),
+              let states = snapshot["states"] as? Data else {
+            result(nil)
+            return
+        }
+        
+        snapshot["states"] = FlutterStandardTypedData(bytes: states)
+        result(snapshot)
+    }
+    
+    private func handleGetRenderedAudio(result: @escaping FlutterResult) {
+        guard var audio = fmodManager?.getRenderedAudio(),
+              let samples = audio["samples"] as? Data else {
+            result(nil)
+            return
+        }
+        
+        audio["samples"] = FlutterStandardTypedData(float32: samples)
+        result(audio)
+    }
+    
+    private func handleLoadSound(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let stream = args["stream"] as? Bool else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Sound path and stream flag required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.loadSound(path, stream: stream) ?? 0)
+    }
+    
+    private func handlePlaySound(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int,
+              let volume = args["volume"] as? Double else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Sound id and volume required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.playSound(id, volume: Float(volume)) ?? false)
+    }
+    
+    private func handleUnloadSound(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Sound id required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.unloadSound(id) ?? false)
+    }
+    
+    private func handleCreatePcmSound(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let bufferId = args["bufferId"] as? Int,
+              let sampleRate = args["sampleRate"] as? Int,
+              let channels = args["channels"] as? Int,
+              let format = args["format"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "PCM buffer id and format required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.createPcmSound(bufferId: bufferId, sampleRate: sampleRate,
+                                           channels: channels, format: format) ?? 0)
+    }
+    
+    private func handlePlayEventWithPcm(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let bufferId = args["bufferId"] as? Int,
+              let sampleRate = args["sampleRate"] as? Int,
+              let channels = args["channels"] as? Int,
+              let format = args["format"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Event path, PCM buffer id and format required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.playEventWithPcm(path, bufferId: bufferId, sampleRate: sampleRate,
+                                             channels: channels, format: format) ?? false)
+    }
+    
+    private func handleCreatePcmStream(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let sampleRate = args["sampleRate"] as? Int,
+              let channels = args["channels"] as? Int,
+              let capacityMs = args["capacityMs"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Sample rate, channels and capacity required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.createPcmStream(sampleRate: sampleRate, channels: channels,
+                                            capacityMs: capacityMs) ?? 0)
+    }
+    
+    private func handleReleasePcmStream(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Stream id required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.releasePcmStream(id) ?? false)
+    }
+    
+    private func handleStartCommandCapture(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let flushEachCommand = args["flushEachCommand"] as? Bool else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Capture path and flush flag required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.startCommandCapture(path, flushEachCommand: flushEachCommand))
+    }
+    
+    private func handleStartRecording(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let driver = args["driver"] as? Int,
+              let monitor = args["monitor"] as? Bool,
+              let latencyMs = args["latencyMs"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Driver, monitor and latency required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.startRecording(driver: driver, monitor: monitor, latencyMs: latencyMs) ?? false)
+    }
+    
+    private func handleConfigureInstancePool(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let prewarm = args["prewarm"] as? Int,
+              let capacity = args["capacity"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path, prewarm count, and capacity required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.configureInstancePool(path, prewarmCount: prewarm, capacity: capacity) ?? false)
+    }
+    
+    private func handleAutomateParameter(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let path = args["path"] as? String,
+              let parameter = args["parameter"] as? String,
+              let type = args["type"] as? Int,
+              let data = args["data"] as? FlutterStandardTypedData else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Path, parameter, type, and curve data required", details: nil))
+            return
+        }
+        
+        result(fmodManager?.automateParameter(eventPath: path,
+                                              paramName: parameter,
+                                              type: type,
+                                              data: data.data) ?? 0)
+    }
+    
+    private func handleEndAutomation(call: FlutterMethodCall, result: @escaping FlutterResult) {
+        guard let args = call.arguments as? [String: Any],
+              let id = args["id"] as? Int else {
+            result(FlutterError(code: "INVALID_ARGS", message: "Automation id required", details: nil))
+            return
+        }
+        
+        if call.method == "releaseAutomation" {
+            result(fmodManager?.releaseAutomation(id) ?? false)
+        } else {
+            result(fmodManager?.cancelAutomation(id) ?? false)
+        }
+    }
 }
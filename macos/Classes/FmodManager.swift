@@ -1,3 +1,4 @@
+import AppKit
 import Foundation
 
 /**
@@ -7,24 +8,115 @@ import Foundation
 class FmodManager {
     private let bridge = FmodBridge()
     private var updateTimer: Timer?
+    private var lifecycleObservers: [NSObjectProtocol] = []
+    
+    /**
+     * Called on the main thread when a beat schedule is armed on the DSP clock.
+     * Receives the schedule id, bar, beat and target DSP clock.
+     */
+    var onBeatScheduleFired: (([String: Any]) -> Void)?
+    
+    /**
+     * Called on the main thread with the events whose instances finished
+     * on their own and were reclaimed by the update loop.
+     */
+    var onEventsFinished: (([String]) -> Void)?
     
     /**
      * Initialize the FMOD Studio system.
+     * @param output Output mode (see offline_output.h); 0 is the audio device
+     * @param wavPath File written by the WAV writer output; relative paths
+     *                resolve against the app's Documents directory
      * @return true if initialization was successful
      */
-    func initialize() -> Bool {
-        let success = bridge.initializeFmod()
+    func initialize(output: Int = 0, wavPath: String? = nil) -> Bool {
+        var wavFile: String?
+        if let wavPath = wavPath {
+            var url = URL(fileURLWithPath: wavPath)
+            if !wavPath.hasPrefix("/") {
+                let documents = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+                url = documents.appendingPathComponent(wavPath)
+            }
+            try? FileManager.default.createDirectory(at: url.deletingLastPathComponent(),
+                                                     withIntermediateDirectories: true)
+            wavFile = url.path
+        }
+        let success = bridge.initializeFmod(output: Int32(output), wavPath: wavFile)
         
         if success {
-            // Start update timer to call FMOD update regularly (60 times per second)
-            updateTimer = Timer.scheduledTimer(withTimeInterval: 1.0/60.0, repeats: true) { [weak self] _ in
-                self?.bridge.update()
-            }
+            // Offline outputs only mix in renderOffline
+            syncUpdateTimer()
+            observeLifecycle()
         }
         
         return success
     }
     
+    private func startUpdateTimer() {
+        // Call FMOD update regularly (60 times per second)
+        updateTimer = Timer.scheduledTimer(withTimeInterval: 1.0/60.0, repeats: true) { [weak self] _ in
+            self?.update()
+        }
+    }
+    
+    // Suspend the mixer while the app is hidden or its window minimized
+    private func observeLifecycle() {
+        let center = NotificationCenter.default
+        let suspend: (Notification) -> Void = { [weak self] _ in
+            _ = self?.suspendMixer()
+        }
+        let resume: (Notification) -> Void = { [weak self] _ in
+            _ = self?.resumeMixer()
+        }
+        lifecycleObservers = [
+            center.addObserver(forName: NSApplication.didHideNotification,
+                               object: nil, queue: .main, using: suspend),
+            center.addObserver(forName: NSApplication.didUnhideNotification,
+                               object: nil, queue: .main, using: resume),
+            center.addObserver(forName: NSWindow.didMiniaturizeNotification,
+                               object: nil, queue: .main, using: suspend),
+            center.addObserver(forName: NSWindow.didDeminiaturizeNotification,
+                               object: nil, queue: .main, using: resume),
+        ]
+    }
+    
+    /**
+     * Find a Flutter asset in the app bundle.
+     * @return The file's path, or nil if it is not bundled
+     */
+    private func resolveAssetPath(_ assetPath: String) -> String? {
+        // On macOS, Flutter assets are in the app bundle's Contents/Frameworks/App.framework/Resources/flutter_assets/
+        var fullPath: String?
+        
+        // Try the macOS bundle path
+        if let resourcePath = Bundle.main.resourcePath {
+            let macPath = "\(resourcePath)/flutter_assets/\(assetPath)"
+            if FileManager.default.fileExists(atPath: macPath) {
+                fullPath = macPath
+            }
+        }
+        
+        // Try Frameworks/App.framework path
+        if fullPath == nil {
+            if let frameworksPath = Bundle.main.privateFrameworksPath {
+                let appFrameworkPath = "\(frameworksPath)/App.framework/Resources/flutter_assets/\(assetPath)"
+                if FileManager.default.fileExists(atPath: appFrameworkPath) {
+                    fullPath = appFrameworkPath
+                }
+            }
+        }
+        
+        // Last resort: try in main bundle directly
+        if fullPath == nil {
+            fullPath = Bundle.main.path(forResource: assetPath, ofType: nil)
+        }
+        
+        guard let validPath = fullPath, FileManager.default.fileExists(atPath: validPath) else {
+            return nil
+        }
+        return validPath
+    }
+    
     /**
      * Load FMOD banks from bundle paths.
      * @param bankPaths List of paths to FMOD bank files in Flutter assets
@@ -34,33 +126,7 @@ class FmodManager {
         var allLoaded = true
         
         for bankPath in bankPaths {
-            // On macOS, Flutter assets are in the app bundle's Contents/Frameworks/App.framework/Resources/flutter_assets/
-            var fullPath: String?
-            
-            // Try the macOS bundle path
-            if let resourcePath = Bundle.main.resourcePath {
-                let macPath = "\(resourcePath)/flutter_assets/\(bankPath)"
-                if FileManager.default.fileExists(atPath: macPath) {
-                    fullPath = macPath
-                }
-            }
-            
-            // Try Frameworks/App.framework path
-            if fullPath == nil {
-                if let frameworksPath = Bundle.main.privateFrameworksPath {
-                    let appFrameworkPath = "\(frameworksPath)/App.framework/Resources/flutter_assets/\(bankPath)"
-                    if FileManager.default.fileExists(atPath: appFrameworkPath) {
-                        fullPath = appFrameworkPath
-                    }
-                }
-            }
-            
-            // Last resort: try in main bundle directly
-            if fullPath == nil {
-                fullPath = Bundle.main.path(forResource: bankPath, ofType: nil)
-            }
-            
-            guard let validPath = fullPath, FileManager.default.fileExists(atPath: validPath) else {
+            guard let validPath = resolveAssetPath(bankPath) else {
                 print("FmodManager: Bank file not found: \(bankPath)")
                 allLoaded = false
                 continue
@@ -88,6 +154,29 @@ class FmodManager {
         }
     }
     
+    /**
+     * Play an FMOD event starting on a specific mixer DSP clock tick.
+     * @param path Event path
+     * @param dspClockOffset Offset in output samples from fromDspClock
+     * @param fromDspClock Base DSP clock, or 0 for the current mixer clock
+     * @return The DSP clock the event starts on, or 0 on failure
+     */
+    func playEventAt(_ path: String, dspClockOffset: UInt64, fromDspClock: UInt64) -> UInt64 {
+        let startClock = bridge.playEvent(path, dspClockOffset: dspClockOffset, fromDspClock: fromDspClock)
+        if startClock == 0 {
+            print("FmodManager: Failed to play event: \(path)")
+        }
+        return startClock
+    }
+    
+    /**
+     * Read the current mixer DSP clock.
+     * @return dspClock and sampleRate, or nil on failure
+     */
+    func getDspClock() -> [String: NSNumber]? {
+        return bridge.currentDSPClock()
+    }
+    
     /**
      * Stop a playing event.
      * @param path Event path
@@ -120,6 +209,22 @@ class FmodManager {
         _ = bridge.setVolumeForEvent(path, volume: volume)
     }
     
+    /**
+     * Set the pitch of an event.
+     */
+    func setPitch(path: String, pitch: Float) {
+        _ = bridge.setPitchForEvent(path, pitch: pitch)
+    }
+    
+    /**
+     * The key the event methods take for an event ID, in place of a path.
+     * Events named by ID are looked up without the strings bank.
+     * @param eventId The 16 bytes of the event's FMOD_GUID
+     */
+    func eventIdKey(_ eventId: Data) -> String {
+        return FmodBridge.eventKey(forId: eventId)
+    }
+    
     /**
      * Pause or resume the master bus (all audio).
      */
@@ -127,11 +232,583 @@ class FmodManager {
         _ = bridge.setMasterPaused(paused)
     }
     
+    /**
+     * Schedule work on a musical beat of a playing event.
+     * The beat is tracked natively from the event's timeline and the
+     * schedule is armed on the mixer DSP clock shortly before it lands.
+     * @param path Event path whose timeline drives the schedule
+     * @param bar Bar number (1-based, as reported by FMOD)
+     * @param beat Beat within the bar (1-based)
+     * @param startEvent Optional event to start sample-accurately on the beat
+     * @return Schedule id, or 0 on failure
+     */
+    func scheduleAtBeat(path: String, bar: Int, beat: Int, startEvent: String?) -> Int {
+        let id = bridge.scheduleAtBeat(eventPath: path, bar: Int32(bar), beat: Int32(beat), startEvent: startEvent)
+        if id == 0 {
+            print("FmodManager: Failed to schedule beat \(bar).\(beat) on event: \(path)")
+        }
+        return Int(id)
+    }
+    
+    /**
+     * Create a 3D emitter: a dedicated instance of an event whose position is
+     * driven by updateSpatial.
+     * @param path Event path
+     * @param start Whether to start the emitter immediately
+     * @return Emitter id, or 0 on failure
+     */
+    func createEmitter(path: String, start: Bool) -> Int {
+        let id = bridge.createEmitter(eventPath: path, start: start)
+        if id == 0 {
+            print("FmodManager: Failed to create emitter for event: \(path)")
+        }
+        return Int(id)
+    }
+    
+    /**
+     * Stop and release a 3D emitter.
+     */
+    func releaseEmitter(_ id: Int) -> Bool {
+        return bridge.releaseEmitter(Int32(id))
+    }
+    
+    /**
+     * Apply listener and emitter 3D attributes in one pass.
+     * Each entity is 12 floats: position, velocity, forward and up vectors.
+     * @param listeners Packed Float32 attributes for every listener
+     * @param emitterIds Packed Int32 emitter ids
+     * @param emitters Packed Float32 attributes for every emitter
+     * @return true if successful
+     */
+    func updateSpatial(listeners: Data, emitterIds: Data, emitters: Data) -> Bool {
+        let listenerCount = listeners.count / (12 * MemoryLayout<Float>.size)
+        let emitterCount = emitterIds.count / MemoryLayout<Int32>.size
+        guard listenerCount > 0,
+              emitters.count >= emitterCount * 12 * MemoryLayout<Float>.size else {
+            return false
+        }
+        
+        return listeners.withUnsafeBytes { listenerBytes in
+            emitterIds.withUnsafeBytes { idBytes in
+                emitters.withUnsafeBytes { emitterBytes in
+                    bridge.updateSpatial(
+                        listeners: listenerBytes.bindMemory(to: Float.self).baseAddress!,
+                        listenerCount: Int32(listenerCount),
+                        emitterIds: idBytes.bindMemory(to: Int32.self).baseAddress,
+                        emitterAttributes: emitterBytes.bindMemory(to: Float.self).baseAddress,
+                        emitterCount: Int32(emitterCount))
+                }
+            }
+        }
+    }
+    
+    /**
+     * Enable or disable distance culling of started emitters. While enabled,
+     * an emitter only holds an event instance when a listener is within the
+     * event's max distance.
+     * @param enabled Whether to cull emitters
+     * @param hysteresis Fraction of max distance an emitter may drift past
+     * before its instance is released
+     */
+    func setEmitterCulling(_ enabled: Bool, hysteresis: Float) {
+        bridge.setEmitterCulling(enabled, hysteresis: hysteresis)
+    }
+    
+    /**
+     * Append a built-in DSP effect to a bus's DSP chain (after the fader).
+     * @param busPath Bus path (e.g., "bus:/SFX")
+     * @param type Effect type (0 = soft limiter, 1 = biquad, 2 = loudness meter)
+     * @param parameterIndices Packed Int32 indices of the parameters to set
+     * before the effect starts processing
+     * @param parameterValues Packed Float32 values for parameterIndices
+     * @return Effect id, or 0 on failure
+     */
+    func addBusEffect(busPath: String, type: Int, parameterIndices: Data, parameterValues: Data) -> Int {
+        let count = parameterIndices.count / MemoryLayout<Int32>.size
+        guard parameterValues.count >= count * MemoryLayout<Float>.size else {
+            return 0
+        }
+        
+        let id = parameterIndices.withUnsafeBytes { indexBytes in
+            parameterValues.withUnsafeBytes { valueBytes in
+                bridge.addBusEffect(
+                    busPath: busPath,
+                    type: Int32(type),
+                    parameterIndices: indexBytes.bindMemory(to: Int32.self).baseAddress,
+                    parameterValues: valueBytes.bindMemory(to: Float.self).baseAddress,
+                    parameterCount: Int32(count))
+            }
+        }
+        if id == 0 {
+            print("FmodManager: Failed to add effect to bus: \(busPath)")
+        }
+        return Int(id)
+    }
+    
+    /**
+     * Remove and release a bus effect.
+     * @param id Id returned by addBusEffect
+     */
+    func removeBusEffect(_ id: Int) -> Bool {
+        return bridge.removeBusEffect(Int32(id))
+    }
+    
+    /**
+     * Set a parameter on a bus effect.
+     * @param id Id returned by addBusEffect
+     * @param index Parameter index
+     * @param value Parameter value
+     */
+    func setBusEffectParameter(_ id: Int, index: Int, value: Float) -> Bool {
+        return bridge.setBusEffectParameter(Int32(id), index: Int32(index), value: value)
+    }
+    
+    /**
+     * Attach an FFT spectrum analyzer to a bus or a playing event instance.
+     * Frames are published natively on each update tick and read from Dart
+     * through FFI.
+     * @param target Bus path (e.g., "bus:/Music") or event path
+     * @param bands Number of log-spaced bands (1 to 128)
+     * @param windowSize FFT window size (power of two, 128 to 32768)
+     * @return Analyzer id, or 0 on failure
+     */
+    func addSpectrumAnalyzer(_ target: String, bands: Int, windowSize: Int) -> Int {
+        let id = bridge.addSpectrumAnalyzer(target, bands: Int32(bands), windowSize: Int32(windowSize))
+        if id == 0 {
+            print("FmodManager: Failed to add spectrum analyzer: \(target)")
+        }
+        return Int(id)
+    }
+    
+    /**
+     * Remove and release a spectrum analyzer.
+     * @param id Id returned by addSpectrumAnalyzer
+     */
+    func removeSpectrumAnalyzer(_ id: Int) -> Bool {
+        return bridge.removeSpectrumAnalyzer(Int32(id))
+    }
+    
+    /**
+     * Set the volume of a bus, optionally ramping to it natively.
+     * @param path Bus path (e.g., "bus:/Music")
+     * @param volume Target volume (0.0 to 1.0)
+     * @param rampMs Ramp duration in milliseconds; 0 sets it at once
+     */
+    func setBusVolume(_ path: String, volume: Float, rampMs: Int) -> Bool {
+        return bridge.setBusVolume(path, volume: volume, rampMs: Int32(rampMs))
+    }
+    
+    /**
+     * Set the volume of a VCA, optionally ramping to it natively.
+     * @param path VCA path (e.g., "vca:/SFX")
+     * @param volume Target volume (0.0 to 1.0)
+     * @param rampMs Ramp duration in milliseconds; 0 sets it at once
+     */
+    func setVcaVolume(_ path: String, volume: Float, rampMs: Int) -> Bool {
+        return bridge.setVcaVolume(path, volume: volume, rampMs: Int32(rampMs))
+    }
+    
+    /**
+     * Mute or unmute a bus.
+     * @param path Bus path (e.g., "bus:/Music")
+     */
+    func setBusMute(_ path: String, muted: Bool) -> Bool {
+        return bridge.setBusMute(path, muted: muted)
+    }
+    
+    /**
+     * Pause or resume a bus.
+     * @param path Bus path (e.g., "bus:/Music")
+     */
+    func setBusPaused(_ path: String, paused: Bool) -> Bool {
+        return bridge.setBusPaused(path, paused: paused)
+    }
+    
+    /**
+     * Start a mixer snapshot, restarting it if already active.
+     * @param path Snapshot path (e.g., "snapshot:/Pause")
+     */
+    func startSnapshot(_ path: String) -> Bool {
+        return bridge.startSnapshot(path)
+    }
+    
+    /**
+     * Stop and release a snapshot started with startSnapshot.
+     * @param path Snapshot path (e.g., "snapshot:/Pause")
+     * @param allowFadeOut Whether the snapshot fades out per its AHDSR
+     */
+    func stopSnapshot(_ path: String, allowFadeOut: Bool) -> Bool {
+        return bridge.stopSnapshot(path, allowFadeOut: allowFadeOut)
+    }
+    
+    /**
+     * Drive a parameter of a playing event with a curve evaluated natively
+     * on each update tick.
+     * @param eventPath Event path whose instance owns the parameter
+     * @param paramName Parameter name
+     * @param type Curve type (0 = linear, 1 = exponential, 2 = keyframes,
+     * 3 = LFO, 4 = ADSR)
+     * @param data Packed Float32 curve data (see parameter_automation.h)
+     * @return Automation id, or 0 on failure
+     */
+    func automateParameter(eventPath: String, paramName: String, type: Int, data: Data) -> Int {
+        let count = data.count / MemoryLayout<Float>.size
+        let id = data.withUnsafeBytes { bytes in
+            bridge.automateParameter(
+                eventPath: eventPath,
+                paramName: paramName,
+                type: Int32(type),
+                data: bytes.bindMemory(to: Float.self).baseAddress,
+                dataCount: Int32(count))
+        }
+        if id == 0 {
+            print("FmodManager: Failed to automate parameter \(paramName) on \(eventPath)")
+        }
+        return Int(id)
+    }
+    
+    /**
+     * Move an ADSR automation into its release stage.
+     * @param id Id returned by automateParameter
+     */
+    func releaseAutomation(_ id: Int) -> Bool {
+        return bridge.releaseAutomation(Int32(id))
+    }
+    
+    /**
+     * Stop an automation, leaving the parameter at its last value.
+     * @param id Id returned by automateParameter
+     */
+    func cancelAutomation(_ id: Int) -> Bool {
+        return bridge.cancelAutomation(Int32(id))
+    }
+    
+    /**
+     * Set a global parameter.
+     * @param name Parameter name
+     * @param value Parameter value
+     */
+    func setGlobalParameter(_ name: String, value: Float) -> Bool {
+        return bridge.setGlobalParameter(name, value: value)
+    }
+    
+    /**
+     * Get the value of a global parameter, or nil on failure.
+     * @param name Parameter name
+     */
+    func getGlobalParameter(_ name: String) -> Double? {
+        return bridge.globalParameterValue(name)?.doubleValue
+    }
+    
+    /**
+     * Resolve global parameter names to slots for setGlobalParameters.
+     * @param names Parameter names
+     * @return Packed Int32 slots, -1 where no such global parameter exists
+     */
+    func resolveGlobalParameters(_ names: [String]) -> Data {
+        return bridge.resolveGlobalParameters(names)
+    }
+    
+    /**
+     * Set many global parameters in one native call.
+     * @param slots Packed Int32 slots from resolveGlobalParameters
+     * @param values Packed Float32 values for slots
+     */
+    func setGlobalParameters(slots: Data, values: Data) -> Bool {
+        let count = slots.count / MemoryLayout<Int32>.size
+        guard values.count >= count * MemoryLayout<Float>.size else {
+            return false
+        }
+        
+        return slots.withUnsafeBytes { slotBytes in
+            values.withUnsafeBytes { valueBytes in
+                bridge.setGlobalParameters(
+                    slots: slotBytes.bindMemory(to: Int32.self).baseAddress,
+                    values: valueBytes.bindMemory(to: Float.self).baseAddress,
+                    count: Int32(count))
+            }
+        }
+    }
+    
+    /**
+     * Stop the update timer and suspend the FMOD mixer thread.
+     */
+    func suspendMixer() -> Bool {
+        guard bridge.suspendMixer() else {
+            return false
+        }
+        syncUpdateTimer()
+        return true
+    }
+    
+    /**
+     * Resume the FMOD mixer thread and the update timer.
+     */
+    func resumeMixer() -> Bool {
+        guard bridge.resumeMixer() else {
+            return false
+        }
+        syncUpdateTimer()
+        return true
+    }
+    
+    // Runs the update timer only while the mixer is running
+    private func syncUpdateTimer() {
+        if bridge.isMixerSuspended() || bridge.isNonRealtime() {
+            updateTimer?.invalidate()
+            updateTimer = nil
+        } else if updateTimer == nil {
+            startUpdateTimer()
+        }
+    }
+    
+    /**
+     * How long the last mixer resume took, in milliseconds, or nil if the
+     * mixer has not been resumed.
+     */
+    func getMixerResumeLatency() -> Double? {
+        let latency = bridge.lastMixerResumeMs()
+        return latency < 0 ? nil : latency
+    }
+    
+    /**
+     * Mix audio faster than realtime in a non-realtime output mode.
+     * @param seconds Audio to mix
+     * @return renderedSeconds and renderMs, or nil on failure
+     */
+    func renderOffline(_ seconds: Double) -> [String: Double]? {
+        guard let stats = bridge.renderOffline(seconds) else {
+            return nil
+        }
+        return stats.mapValues { $0.doubleValue }
+    }
+    
+    /**
+     * Take the mix captured by the memory output since the last call.
+     * @return sampleRate, channels and interleaved float samples (Data), or
+     *         nil if the output is not the memory output
+     */
+    func getRenderedAudio() -> [String: Any]? {
+        return bridge.takeRenderedAudio()
+    }
+    
+    /**
+     * Load a sound that is not in a Studio bank, e.g. a compact .fca file.
+     * @param assetPath Flutter asset path
+     * @param stream Decode while playing instead of at load
+     * @return Sound id, or 0 on failure
+     */
+    func loadSound(_ assetPath: String, stream: Bool) -> Int {
+        guard let path = resolveAssetPath(assetPath) else {
+            print("FmodManager: Sound file not found: \(assetPath)")
+            return 0
+        }
+        return Int(bridge.loadSound(atPath: path, stream: stream))
+    }
+    
+    /**
+     * Play a sound loaded with loadSound once.
+     * @param id Id returned by loadSound
+     * @param volume Linear volume, 1.0 is unchanged
+     */
+    func playSound(_ id: Int, volume: Float) -> Bool {
+        return bridge.playSound(Int32(id), volume: volume)
+    }
+    
+    /**
+     * Release a sound loaded with loadSound.
+     * @param id Id returned by loadSound
+     */
+    func unloadSound(_ id: Int) -> Bool {
+        return bridge.unloadSound(Int32(id))
+    }
+    
+    /**
+     * Create a sound over a PCM buffer that Dart filled through dart:ffi.
+     * The sound plays from the buffer's memory and keeps it alive until
+     * it is unloaded with unloadSound.
+     * @param bufferId Id of the native PCM buffer
+     * @param format 0 for 16-bit integer samples, 1 for 32-bit float
+     * @return Sound id, or 0 on failure
+     */
+    func createPcmSound(bufferId: Int, sampleRate: Int, channels: Int, format: Int) -> Int {
+        return Int(bridge.createPcmSound(bufferId: Int32(bufferId),
+                                         sampleRate: Int32(sampleRate),
+                                         channels: Int32(channels),
+                                         format: Int32(format)))
+    }
+    
+    /**
+     * Create a stream that Dart pushes float PCM into through dart:ffi,
+     * and start playing it.
+     * @param capacityMs Most audio the stream buffers ahead of playback
+     * @return Stream id, or 0 on failure
+     */
+    func createPcmStream(sampleRate: Int, channels: Int, capacityMs: Int) -> Int {
+        return Int(bridge.createPcmStream(sampleRate: Int32(sampleRate),
+                                          channels: Int32(channels),
+                                          capacityMs: Int32(capacityMs)))
+    }
+    
+    /**
+     * Stop and release a stream created with createPcmStream.
+     */
+    func releasePcmStream(_ id: Int) -> Bool {
+        return bridge.releasePcmStream(Int32(id))
+    }
+    
+    /**
+     * Read buffering, underrun and latency statistics of a PCM stream.
+     * @return The statistics, or nil if no such stream
+     */
+    func getPcmStreamStats(_ id: Int) -> [String: NSNumber]? {
+        return bridge.pcmStreamStats(Int32(id))
+    }
+    
+    /**
+     * Record from a microphone. The app needs the microphone permission and the audio-input entitlement;
+     * recorded audio is read from Dart through dart:ffi.
+     * @param driver Record driver index; 0 is the default input
+     * @param monitor Also play the input back through the output
+     * @param latencyMs Target delay between recording and monitor playback
+     */
+    func startRecording(driver: Int, monitor: Bool, latencyMs: Int) -> Bool {
+        return bridge.startRecording(driver: Int32(driver),
+                                     monitor: monitor,
+                                     latencyMs: Int32(latencyMs))
+    }
+    
+    /**
+     * Stop recording and monitoring.
+     */
+    func stopRecording() -> Bool {
+        return bridge.stopRecording()
+    }
+    
+    /**
+     * Read recording and monitor latency statistics.
+     * @return The statistics, or nil if not recording
+     */
+    func getRecordingStats() -> [String: NSNumber]? {
+        return bridge.recordingStats()
+    }
+    
+    /**
+     * Start sampling real and virtual voices and per-event instances on
+     * each update tick, aggregated over windows of windowMs.
+     */
+    func startVoiceStats(windowMs: Int) -> Bool {
+        return bridge.startVoiceStats(windowMs: Int32(windowMs))
+    }
+    
+    /**
+     * Stop sampling voices; complete windows stay readable.
+     */
+    func stopVoiceStats() {
+        bridge.stopVoiceStats()
+    }
+    
+    /**
+     * Read the complete voice statistics windows, oldest first, and the
+     * events of the newest window.
+     */
+    func getVoiceStats() -> [String: [Any]] {
+        return bridge.voiceStats()
+    }
+    
+    /**
+     * Every live event and emitter instance as of the last update tick.
+     * @return "states", packed FmodInstanceState records, and "keys", the
+     *         event key of each
+     */
+    func queryInstances() -> [String: Any] {
+        return bridge.queryInstances()
+    }
+    
+    /**
+     * Start a one-shot instance of an event whose programmer instruments
+     * play a PCM buffer that Dart filled through dart:ffi.
+     * @param bufferId Id of the native PCM buffer
+     * @param format 0 for 16-bit integer samples, 1 for 32-bit float
+     */
+    func playEventWithPcm(_ eventPath: String, bufferId: Int, sampleRate: Int, channels: Int, format: Int) -> Bool {
+        return bridge.playEventWithPcm(eventPath,
+                                       bufferId: Int32(bufferId),
+                                       sampleRate: Int32(sampleRate),
+                                       channels: Int32(channels),
+                                       format: Int32(format))
+    }
+    
+    /**
+     * Record every Studio API call for replay with tool/command_replay.
+     * @param path Capture file; relative paths resolve against the app's
+     *             Documents directory
+     * @param flushEachCommand Write each command as it is issued, so the
+     *                         capture survives a crash
+     * @return The absolute path being written, or nil on failure
+     */
+    func startCommandCapture(_ path: String, flushEachCommand: Bool) -> String? {
+        var url = URL(fileURLWithPath: path)
+        if !path.hasPrefix("/") {
+            let documents = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+            url = documents.appendingPathComponent(path)
+        }
+        try? FileManager.default.createDirectory(at: url.deletingLastPathComponent(),
+                                                 withIntermediateDirectories: true)
+        return bridge.startCommandCapture(path: url.path, flushEachCommand: flushEachCommand) ? url.path : nil
+    }
+    
+    /**
+     * Stop the command capture and close its file.
+     */
+    func stopCommandCapture() -> Bool {
+        return bridge.stopCommandCapture()
+    }
+    
+    /**
+     * Keep stopped instances of an event for reuse by playEvent.
+     * @param path Event path
+     * @param prewarmCount Instances to create now
+     * @param capacity Most idle instances kept; 0 removes the pool
+     */
+    func configureInstancePool(_ path: String, prewarmCount: Int, capacity: Int) -> Bool {
+        return bridge.configureInstancePool(eventPath: path,
+                                            prewarmCount: Int32(prewarmCount),
+                                            capacity: Int32(capacity))
+    }
+    
+    /**
+     * Read instance pool statistics.
+     * @param path Event path, or nil for totals across every pool
+     * @return idleCount, capacity, hits and misses, or nil if no such pool
+     */
+    func getInstancePoolStats(_ path: String?) -> [String: NSNumber]? {
+        return bridge.instancePoolStats(eventPath: path)
+    }
+    
+    /**
+     * Cancel a pending beat schedule.
+     * @param id Id returned by scheduleAtBeat
+     * @return true if the schedule was still pending
+     */
+    func cancelBeatSchedule(_ id: Int) -> Bool {
+        return bridge.cancelBeatSchedule(Int32(id))
+    }
+    
     /**
      * Update the FMOD system.
      */
     func update() {
         bridge.update()
+        
+        for fired in bridge.drainFiredBeatSchedules() {
+            onBeatScheduleFired?(fired)
+        }
+        
+        let finished = bridge.drainFinishedEvents()
+        if !finished.isEmpty {
+            onEventsFinished?(finished)
+        }
     }
     
     /**
@@ -140,6 +817,10 @@ class FmodManager {
     func release() {
         updateTimer?.invalidate()
         updateTimer = nil
+        for observer in lifecycleObservers {
+            NotificationCenter.default.removeObserver(observer)
+        }
+        lifecycleObservers.removeAll()
         bridge.releaseFmod()
     }
     
@@ -0,0 +1,157 @@
+#include "audio_interruption.h"
+
+namespace fmod_flutter {
+
+AudioInterruption::AudioInterruption()
+    : duck_volume_(0.25f),
+      ramp_seconds_(0.2f),
+      response_(FMOD_FLUTTER_RESPONSE_NONE),
+      kind_(FMOD_FLUTTER_INTERRUPTION_TRANSIENT),
+      was_paused_(0),
+      last_result_(FMOD_OK) {
+  responses_[FMOD_FLUTTER_INTERRUPTION_TRANSIENT] =
+      FMOD_FLUTTER_RESPONSE_SUSPEND;
+  responses_[FMOD_FLUTTER_INTERRUPTION_CAN_DUCK] = FMOD_FLUTTER_RESPONSE_DUCK;
+  responses_[FMOD_FLUTTER_INTERRUPTION_LOSS] = FMOD_FLUTTER_RESPONSE_SUSPEND;
+}
+
+static int ClampResponse(int response) {
+  if (response < FMOD_FLUTTER_RESPONSE_DUCK) {
+    return FMOD_FLUTTER_RESPONSE_DUCK;
+  }
+  if (response > FMOD_FLUTTER_RESPONSE_SUSPEND) {
+    return FMOD_FLUTTER_RESPONSE_SUSPEND;
+  }
+  return response;
+}
+
+void AudioInterruption::SetPolicy(int transient_response,
+                                  int can_duck_response, int loss_response,
+                                  float duck_volume, float ramp_seconds) {
+  responses_[FMOD_FLUTTER_INTERRUPTION_TRANSIENT] =
+      ClampResponse(transient_response);
+  responses_[FMOD_FLUTTER_INTERRUPTION_CAN_DUCK] =
+      ClampResponse(can_duck_response);
+  responses_[FMOD_FLUTTER_INTERRUPTION_LOSS] = ClampResponse(loss_response);
+  duck_volume_ = duck_volume < 0.0f ? 0.0f : duck_volume;
+  ramp_seconds_ = ramp_seconds < 0.0f ? 0.0f : ramp_seconds;
+}
+
+int AudioInterruption::Begin(FMOD_SYSTEM* core_system, int kind) {
+  if (kind < FMOD_FLUTTER_INTERRUPTION_TRANSIENT ||
+      kind > FMOD_FLUTTER_INTERRUPTION_LOSS) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return response_;
+  }
+  int response = responses_[kind];
+  if (response <= response_) {
+    last_result_ = FMOD_OK;
+    return response_;
+  }
+
+  // Escalating; a DUCK gives way to the pause. PAUSE to SUSPEND leaves the
+  // master paused as it is, so End() restores the pause state saved before
+  // the first pause rather than the pause applied here.
+  if (response_ == FMOD_FLUTTER_RESPONSE_DUCK) {
+    Apply(core_system, FMOD_FLUTTER_RESPONSE_DUCK, false);
+  }
+  if (response_ < FMOD_FLUTTER_RESPONSE_PAUSE) {
+    last_result_ = Apply(core_system, response, true);
+  } else {
+    last_result_ = FMOD_OK;
+  }
+  response_ = response;
+  kind_ = kind;
+  return response_;
+}
+
+int AudioInterruption::End(FMOD_SYSTEM* core_system) {
+  int response = response_;
+  if (response != FMOD_FLUTTER_RESPONSE_NONE) {
+    last_result_ = Apply(core_system, response, false);
+  } else {
+    last_result_ = FMOD_OK;
+  }
+  response_ = FMOD_FLUTTER_RESPONSE_NONE;
+  return response;
+}
+
+void AudioInterruption::Clear() {
+  response_ = FMOD_FLUTTER_RESPONSE_NONE;
+}
+
+FMOD_RESULT AudioInterruption::Apply(FMOD_SYSTEM* core_system, int response,
+                                     bool on) {
+  FMOD_CHANNELGROUP* master = nullptr;
+  FMOD_RESULT result = FMOD_System_GetMasterChannelGroup(core_system, &master);
+  if (result != FMOD_OK) {
+    return result;
+  }
+
+  if (response == FMOD_FLUTTER_RESPONSE_DUCK) {
+    // Fade points scale the output without changing the volume Dart set.
+    unsigned long long clock = 0;
+    int sample_rate = 0;
+    result = FMOD_ChannelGroup_GetDSPClock(master, nullptr, &clock);
+    if (result == FMOD_OK) {
+      result = FMOD_System_GetSoftwareFormat(core_system, &sample_rate,
+                                             nullptr, nullptr);
+    }
+    if (result != FMOD_OK) {
+      return result;
+    }
+    unsigned long long ramp_samples =
+        static_cast<unsigned long long>(ramp_seconds_ * sample_rate);
+    return FMOD_ChannelGroup_SetFadePointRamp(master, clock + ramp_samples,
+                                              on ? duck_volume_ : 1.0f);
+  }
+
+  // PAUSE, and SUSPEND, which pauses so the resumed mixer starts silent.
+  if (on) {
+    FMOD_ChannelGroup_GetPaused(master, &was_paused_);
+    return FMOD_ChannelGroup_SetPaused(master, 1);
+  }
+  return FMOD_ChannelGroup_SetPaused(master, was_paused_);
+}
+
+}  // namespace fmod_flutter
+
+struct FmodAudioInterruption {
+  fmod_flutter::AudioInterruption interruption;
+};
+
+FmodAudioInterruption* fmod_audio_interruption_create(void) {
+  return new FmodAudioInterruption();
+}
+
+void fmod_audio_interruption_destroy(FmodAudioInterruption* interruption) {
+  delete interruption;
+}
+
+void fmod_audio_interruption_set_policy(FmodAudioInterruption* interruption,
+                                        int transient_response,
+                                        int can_duck_response,
+                                        int loss_response, float duck_volume,
+                                        float ramp_seconds) {
+  interruption->interruption.SetPolicy(transient_response, can_duck_response,
+                                       loss_response, duck_volume,
+                                       ramp_seconds);
+}
+
+int fmod_audio_interruption_begin(FmodAudioInterruption* interruption,
+                                  FMOD_SYSTEM* core_system, int kind) {
+  return interruption->interruption.Begin(core_system, kind);
+}
+
+int fmod_audio_interruption_end(FmodAudioInterruption* interruption,
+                                FMOD_SYSTEM* core_system) {
+  return interruption->interruption.End(core_system);
+}
+
+void fmod_audio_interruption_clear(FmodAudioInterruption* interruption) {
+  interruption->interruption.Clear();
+}
+
+int fmod_audio_interruption_response(FmodAudioInterruption* interruption) {
+  return interruption->interruption.response();
+}
@@ -0,0 +1,104 @@
+#ifndef FMOD_FLUTTER_AUDIO_INTERRUPTION_H_
+#define FMOD_FLUTTER_AUDIO_INTERRUPTION_H_
+
+// Audio interruption policy shared by the mobile bridges.
+//
+// The bridges translate platform events (Android audio focus changes,
+// AVAudioSession interruptions) into Begin() and End() calls. Begin()
+// ducks or pauses the core master channel group according to the policy,
+// leaving the Studio master bus volume and pause state Dart controls
+// untouched; a SUSPEND response also tells the bridge to suspend the mixer
+// (see mixer_lifecycle.h). Nested interruptions escalate to the strongest
+// response and a single End() undoes it.
+
+#include <fmod.h>
+
+// Interruption kinds.
+//
+// TRANSIENT  Phone call, alarm or voice assistant; audio comes back.
+// CAN_DUCK   Another app plays briefly over us, e.g. navigation prompts.
+// LOSS       Another app took over audio until the user returns.
+#define FMOD_FLUTTER_INTERRUPTION_TRANSIENT 0
+#define FMOD_FLUTTER_INTERRUPTION_CAN_DUCK 1
+#define FMOD_FLUTTER_INTERRUPTION_LOSS 2
+
+// Responses, weakest first.
+#define FMOD_FLUTTER_RESPONSE_NONE -1
+#define FMOD_FLUTTER_RESPONSE_DUCK 0
+#define FMOD_FLUTTER_RESPONSE_PAUSE 1
+#define FMOD_FLUTTER_RESPONSE_SUSPEND 2
+
+#ifdef __cplusplus
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class AudioInterruption {
+ public:
+  AudioInterruption();
+
+  // The response to each interruption kind, and how far and how quickly
+  // a DUCK lowers the output.
+  void SetPolicy(int transient_response, int can_duck_response,
+                 int loss_response, float duck_volume, float ramp_seconds);
+
+  // Starts an interruption, or escalates the active one if this kind calls
+  // for a stronger response. Returns the active response. On SUSPEND the
+  // output is paused here and the caller suspends the mixer.
+  int Begin(FMOD_SYSTEM* core_system, int kind);
+
+  // Ends the interruption, restoring the output. On SUSPEND the caller
+  // resumes the mixer first. Returns the response that was active.
+  int End(FMOD_SYSTEM* core_system);
+
+  // Forgets the interruption without touching the output. Call after
+  // releasing the Studio system.
+  void Clear();
+
+  bool active() const { return response_ != FMOD_FLUTTER_RESPONSE_NONE; }
+  int response() const { return response_; }
+  int kind() const { return kind_; }
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  // Applies (or undoes) a DUCK or PAUSE on the master channel group.
+  FMOD_RESULT Apply(FMOD_SYSTEM* core_system, int response, bool on);
+
+  int responses_[3];
+  float duck_volume_;
+  float ramp_seconds_;
+  int response_;
+  int kind_;
+  // Master channel group pause state from before a PAUSE, restored on End.
+  FMOD_BOOL was_paused_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodAudioInterruption FmodAudioInterruption;
+
+FmodAudioInterruption* fmod_audio_interruption_create(void);
+void fmod_audio_interruption_destroy(FmodAudioInterruption* interruption);
+void fmod_audio_interruption_set_policy(FmodAudioInterruption* interruption,
+                                        int transient_response,
+                                        int can_duck_response,
+                                        int loss_response, float duck_volume,
+                                        float ramp_seconds);
+int fmod_audio_interruption_begin(FmodAudioInterruption* interruption,
+                                  FMOD_SYSTEM* core_system, int kind);
+int fmod_audio_interruption_end(FmodAudioInterruption* interruption,
+                                FMOD_SYSTEM* core_system);
+void fmod_audio_interruption_clear(FmodAudioInterruption* interruption);
+int fmod_audio_interruption_response(FmodAudioInterruption* interruption);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_AUDIO_INTERRUPTION_H_
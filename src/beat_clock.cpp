@@ -0,0 +1,32 @@
+#include "beat_clock.h"
+
+namespace fmod_flutter {
+
+unsigned long long BeatTargetClock(unsigned long long anchor_clock,
+                                   int anchor_bar, int anchor_beat,
+                                   int beats_per_bar, float tempo,
+                                   int sample_rate, int bar, int beat,
+                                   unsigned long long now) {
+  long long beats_ahead =
+      static_cast<long long>(bar - anchor_bar) * beats_per_bar +
+      (beat - anchor_beat);
+  double samples_per_beat = 60.0 / tempo * sample_rate;
+  long long target = static_cast<long long>(anchor_clock) +
+                     static_cast<long long>(beats_ahead * samples_per_beat);
+  if (target < static_cast<long long>(now)) {
+    return now;
+  }
+  return static_cast<unsigned long long>(target);
+}
+
+}  // namespace fmod_flutter
+
+unsigned long long fmod_beat_target_clock(unsigned long long anchor_clock,
+                                          int anchor_bar, int anchor_beat,
+                                          int beats_per_bar, float tempo,
+                                          int sample_rate, int bar, int beat,
+                                          unsigned long long now) {
+  return fmod_flutter::BeatTargetClock(anchor_clock, anchor_bar, anchor_beat,
+                                       beats_per_bar, tempo, sample_rate, bar,
+                                       beat, now);
+}
@@ -0,0 +1,49 @@
+#ifndef FMOD_FLUTTER_BEAT_CLOCK_H_
+#define FMOD_FLUTTER_BEAT_CLOCK_H_
+
+// Beat schedule timing shared by all native bridges.
+//
+// A beat schedule names a timeline beat of a playing event. The bridges
+// anchor the last FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_BEAT of the event on
+// the mixer DSP clock and extrapolate from it at the event's tempo to place
+// the scheduled beat on the same clock, where the schedule is armed and its
+// start event delayed to.
+//
+// A schedule whose beat is already behind the mixer clock when it is armed
+// fires at once: its callback is reported and its start event starts on the
+// current clock, off the beat. That happens when the beat was scheduled
+// after it played, or the timeline moved past it before the schedule's
+// event was playing. Late schedules are not dropped, so a callback waiting
+// on the beat always runs.
+
+#ifdef __cplusplus
+
+namespace fmod_flutter {
+
+// The mixer DSP clock of beat `beat` of bar `bar`, extrapolated at tempo
+// (beats per minute) from beat anchor_beat of bar anchor_bar, heard at
+// anchor_clock. Bars and beats are 1-based. Returns now instead for a beat
+// already behind now.
+unsigned long long BeatTargetClock(unsigned long long anchor_clock,
+                                   int anchor_bar, int anchor_beat,
+                                   int beats_per_bar, float tempo,
+                                   int sample_rate, int bar, int beat,
+                                   unsigned long long now);
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+unsigned long long fmod_beat_target_clock(unsigned long long anchor_clock,
+                                          int anchor_bar, int anchor_beat,
+                                          int beats_per_bar, float tempo,
+                                          int sample_rate, int bar, int beat,
+                                          unsigned long long now);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_BEAT_CLOCK_H_
@@ -0,0 +1,627 @@
+#include "compact_codec.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define FMOD_FLUTTER_CODEC_X86 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+// Integer only, so unlike dsp_kernels.cpp ARMv7 NEON qualifies too.
+#define FMOD_FLUTTER_CODEC_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace fmod_flutter {
+
+static const char kCompactCodecName[] = "fmod_flutter compact";
+static const uint8_t kCompactMagic[4] = {'F', 'C', 'A', '1'};
+
+// QOA's quantizer: scale factor s is round((s + 1)^2.75), and the eight
+// residual codes dequantize to +/-0.75, 2.5, 4.5 and 7 times it.
+// kReciprocals holds 65536 / scale factor, rounded up.
+static const int kReciprocals[16] = {65536, 9363, 3121, 1457, 781, 475,
+                                     311,   216,  156,  117,  90,  71,
+                                     57,    47,   39,   32};
+static const int32_t kDequant[16][8] = {
+    {1, -1, 3, -3, 5, -5, 7, -7},
+    {5, -5, 18, -18, 32, -32, 49, -49},
+    {16, -16, 53, -53, 95, -95, 147, -147},
+    {34, -34, 113, -113, 203, -203, 315, -315},
+    {63, -63, 210, -210, 378, -378, 588, -588},
+    {104, -104, 345, -345, 621, -621, 966, -966},
+    {158, -158, 528, -528, 950, -950, 1477, -1477},
+    {228, -228, 760, -760, 1368, -1368, 2128, -2128},
+    {316, -316, 1053, -1053, 1895, -1895, 2947, -2947},
+    {422, -422, 1405, -1405, 2529, -2529, 3934, -3934},
+    {548, -548, 1828, -1828, 3290, -3290, 5117, -5117},
+    {696, -696, 2320, -2320, 4176, -4176, 6496, -6496},
+    {868, -868, 2893, -2893, 5207, -5207, 8099, -8099},
+    {1064, -1064, 3548, -3548, 6386, -6386, 9933, -9933},
+    {1286, -1286, 4288, -4288, 7718, -7718, 12005, -12005},
+    {1536, -1536, 5120, -5120, 9216, -9216, 14336, -14336},
+};
+// Code of a scaled residual clamped to -8..8, indexed from -8.
+static const int kQuantize[17] = {7, 7, 7, 5, 5, 3, 3, 1, 0,
+                                  0, 2, 2, 4, 4, 6, 6, 6};
+
+static const int32_t kInitialWeights[4] = {0, 0, -(1 << 13), 1 << 14};
+
+// Byte offset of a lane's first slice in a channel block.
+static const int kLaneStateBytes = 16;
+static const int kSlicesOffset = kCompactLanes * kLaneStateBytes;
+
+static inline uint16_t ReadU16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t ReadU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline uint64_t ReadU64(const uint8_t* p) {
+  return static_cast<uint64_t>(ReadU32(p)) |
+         (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+static inline void WriteU16(uint8_t* p, uint16_t value) {
+  p[0] = static_cast<uint8_t>(value);
+  p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static inline void WriteU32(uint8_t* p, uint32_t value) {
+  WriteU16(p, static_cast<uint16_t>(value));
+  WriteU16(p + 2, static_cast<uint16_t>(value >> 16));
+}
+
+static inline void WriteU64(uint8_t* p, uint64_t value) {
+  WriteU32(p, static_cast<uint32_t>(value));
+  WriteU32(p + 4, static_cast<uint32_t>(value >> 32));
+}
+
+static inline int32_t ClampS16(int32_t value) {
+  return value < -32768 ? -32768 : (value > 32767 ? 32767 : value);
+}
+
+bool ReadCompactHeader(const uint8_t* data, CompactHeader* header) {
+  if (std::memcmp(data, kCompactMagic, sizeof(kCompactMagic)) != 0 ||
+      data[5] != 0 || ReadU16(data + 6) != 0) {
+    return false;
+  }
+  header->channels = data[4];
+  header->sample_rate = static_cast<int>(ReadU32(data + 8));
+  header->length = ReadU32(data + 12);
+  return header->channels >= 1 && header->channels <= kCompactMaxChannels &&
+         header->sample_rate > 0 && header->length > 0;
+}
+
+// One lane's predictor. Arithmetic wraps like the SIMD registers do, so
+// every kernel agrees even on pathological input.
+struct Lms {
+  int32_t history[4];
+  int32_t weights[4];
+
+  int32_t Predict() const {
+    uint32_t sum = 0;
+    for (int i = 0; i < 4; i++) {
+      sum += static_cast<uint32_t>(weights[i]) *
+             static_cast<uint32_t>(history[i]);
+    }
+    return static_cast<int32_t>(sum) >> 13;
+  }
+
+  void Update(int32_t sample, int32_t residual) {
+    int32_t delta = residual >> 4;
+    for (int i = 0; i < 4; i++) {
+      uint32_t step = static_cast<uint32_t>(history[i] < 0 ? -delta : delta);
+      weights[i] = static_cast<int32_t>(static_cast<uint32_t>(weights[i]) +
+                                        step);
+    }
+    history[0] = history[1];
+    history[1] = history[2];
+    history[2] = history[3];
+    history[3] = sample;
+  }
+};
+
+static void ReadLaneState(const uint8_t* in, int lane, Lms* lms) {
+  const uint8_t* p = in + lane * kLaneStateBytes;
+  for (int i = 0; i < 4; i++) {
+    lms->history[i] = static_cast<int16_t>(ReadU16(p + i * 2));
+    lms->weights[i] = static_cast<int16_t>(ReadU16(p + 8 + i * 2));
+  }
+}
+
+static inline const uint8_t* SlicePointer(const uint8_t* in, int slice,
+                                          int lane) {
+  return in + kSlicesOffset + (slice * kCompactLanes + lane) * 8;
+}
+
+static inline int SliceCode(uint64_t slice, int index) {
+  return static_cast<int>(slice >> (57 - 3 * index)) & 7;
+}
+
+static void ScalarDecodeChannel(const uint8_t* in, int16_t* out) {
+  for (int lane = 0; lane < kCompactLanes; lane++) {
+    Lms lms;
+    ReadLaneState(in, lane, &lms);
+    int16_t* lane_out = out + lane * kCompactLaneSamples;
+    for (int s = 0; s < kCompactSlicesPerLane; s++) {
+      uint64_t slice = ReadU64(SlicePointer(in, s, lane));
+      const int32_t* dequant = kDequant[slice >> 60];
+      for (int j = 0; j < kCompactSliceSamples; j++) {
+        int32_t residual = dequant[SliceCode(slice, j)];
+        int32_t sample = ClampS16(lms.Predict() + residual);
+        lms.Update(sample, residual);
+        lane_out[s * kCompactSliceSamples + j] = static_cast<int16_t>(sample);
+      }
+    }
+  }
+}
+
+// Dequantized residuals of slice s for all lanes, sample-major, so a SIMD
+// kernel can load one register per sample.
+static void LoadResiduals(const uint8_t* in, int s,
+                          int32_t residuals[][kCompactLanes]) {
+  for (int lane = 0; lane < kCompactLanes; lane++) {
+    uint64_t slice = ReadU64(SlicePointer(in, s, lane));
+    const int32_t* dequant = kDequant[slice >> 60];
+    for (int j = 0; j < kCompactSliceSamples; j++) {
+      residuals[j][lane] = dequant[SliceCode(slice, j)];
+    }
+  }
+}
+
+#if defined(FMOD_FLUTTER_CODEC_X86)
+
+// SSE2 has no 32-bit low multiply (SSE4.1's pmulld); build it from two
+// 32x32->64 multiplies of the even and odd lanes.
+static inline __m128i MulLo32(__m128i a, __m128i b) {
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Adds delta to weight where history >= 0 and subtracts it elsewhere.
+static inline __m128i SseSignStep(__m128i weight, __m128i history,
+                                  __m128i delta) {
+  __m128i negative = _mm_srai_epi32(history, 31);
+  return _mm_add_epi32(
+      weight, _mm_sub_epi32(_mm_xor_si128(delta, negative), negative));
+}
+
+static void SseDecodeChannel(const uint8_t* in, int16_t* out) {
+  Lms lanes[kCompactLanes];
+  for (int lane = 0; lane < kCompactLanes; lane++) {
+    ReadLaneState(in, lane, &lanes[lane]);
+  }
+  __m128i h[4];
+  __m128i w[4];
+  for (int i = 0; i < 4; i++) {
+    h[i] = _mm_setr_epi32(lanes[0].history[i], lanes[1].history[i],
+                          lanes[2].history[i], lanes[3].history[i]);
+    w[i] = _mm_setr_epi32(lanes[0].weights[i], lanes[1].weights[i],
+                          lanes[2].weights[i], lanes[3].weights[i]);
+  }
+
+  int32_t residuals[kCompactSliceSamples][kCompactLanes];
+  int32_t samples[kCompactLanes];
+  for (int s = 0; s < kCompactSlicesPerLane; s++) {
+    LoadResiduals(in, s, residuals);
+    for (int j = 0; j < kCompactSliceSamples; j++) {
+      __m128i r =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(residuals[j]));
+      __m128i sum = _mm_add_epi32(
+          _mm_add_epi32(MulLo32(w[0], h[0]), MulLo32(w[1], h[1])),
+          _mm_add_epi32(MulLo32(w[2], h[2]), MulLo32(w[3], h[3])));
+      __m128i sample = _mm_add_epi32(_mm_srai_epi32(sum, 13), r);
+      // Saturate to 16 bits and sign-extend back.
+      __m128i packed = _mm_packs_epi32(sample, sample);
+      sample = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+
+      __m128i delta = _mm_srai_epi32(r, 4);
+      for (int i = 0; i < 4; i++) {
+        w[i] = SseSignStep(w[i], h[i], delta);
+      }
+      h[0] = h[1];
+      h[1] = h[2];
+      h[2] = h[3];
+      h[3] = sample;
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(samples), sample);
+      int index = s * kCompactSliceSamples + j;
+      for (int lane = 0; lane < kCompactLanes; lane++) {
+        out[lane * kCompactLaneSamples + index] =
+            static_cast<int16_t>(samples[lane]);
+      }
+    }
+  }
+}
+
+#elif defined(FMOD_FLUTTER_CODEC_NEON)
+
+static inline int32x4_t NeonSignStep(int32x4_t weight, int32x4_t history,
+                                     int32x4_t delta) {
+  int32x4_t negative = vshrq_n_s32(history, 31);
+  return vaddq_s32(weight,
+                   vsubq_s32(veorq_s32(delta, negative), negative));
+}
+
+static void NeonDecodeChannel(const uint8_t* in, int16_t* out) {
+  Lms lanes[kCompactLanes];
+  for (int lane = 0; lane < kCompactLanes; lane++) {
+    ReadLaneState(in, lane, &lanes[lane]);
+  }
+  int32x4_t h[4];
+  int32x4_t w[4];
+  for (int i = 0; i < 4; i++) {
+    int32_t history[kCompactLanes] = {lanes[0].history[i], lanes[1].history[i],
+                                      lanes[2].history[i],
+                                      lanes[3].history[i]};
+    int32_t weights[kCompactLanes] = {lanes[0].weights[i], lanes[1].weights[i],
+                                      lanes[2].weights[i],
+                                      lanes[3].weights[i]};
+    h[i] = vld1q_s32(history);
+    w[i] = vld1q_s32(weights);
+  }
+
+  int32_t residuals[kCompactSliceSamples][kCompactLanes];
+  int16_t samples[kCompactLanes];
+  for (int s = 0; s < kCompactSlicesPerLane; s++) {
+    LoadResiduals(in, s, residuals);
+    for (int j = 0; j < kCompactSliceSamples; j++) {
+      int32x4_t r = vld1q_s32(residuals[j]);
+      int32x4_t sum = vmulq_s32(w[0], h[0]);
+      sum = vmlaq_s32(sum, w[1], h[1]);
+      sum = vmlaq_s32(sum, w[2], h[2]);
+      sum = vmlaq_s32(sum, w[3], h[3]);
+      int16x4_t narrow = vqmovn_s32(vaddq_s32(vshrq_n_s32(sum, 13), r));
+      int32x4_t sample = vmovl_s16(narrow);
+
+      int32x4_t delta = vshrq_n_s32(r, 4);
+      for (int i = 0; i < 4; i++) {
+        w[i] = NeonSignStep(w[i], h[i], delta);
+      }
+      h[0] = h[1];
+      h[1] = h[2];
+      h[2] = h[3];
+      h[3] = sample;
+
+      vst1_s16(samples, narrow);
+      int index = s * kCompactSliceSamples + j;
+      for (int lane = 0; lane < kCompactLanes; lane++) {
+        out[lane * kCompactLaneSamples + index] = samples[lane];
+      }
+    }
+  }
+}
+
+#endif
+
+static const CompactCodecKernels kScalarKernels = {"scalar",
+                                                   ScalarDecodeChannel};
+#if defined(FMOD_FLUTTER_CODEC_X86)
+static const CompactCodecKernels kSseKernels = {"sse2", SseDecodeChannel};
+#elif defined(FMOD_FLUTTER_CODEC_NEON)
+static const CompactCodecKernels kNeonKernels = {"neon", NeonDecodeChannel};
+#endif
+
+const CompactCodecKernels& GetCompactCodecKernels() {
+  // SSE2 and NEON are baseline on every target that compiles them in, so
+  // there is nothing to probe at runtime.
+#if defined(FMOD_FLUTTER_CODEC_X86)
+  return kSseKernels;
+#elif defined(FMOD_FLUTTER_CODEC_NEON)
+  return kNeonKernels;
+#else
+  return kScalarKernels;
+#endif
+}
+
+const CompactCodecKernels& GetScalarCompactCodecKernels() {
+  return kScalarKernels;
+}
+
+void DecodeCompactFrame(const CompactCodecKernels& kernels,
+                        const uint8_t* in, int channels, int16_t* scratch,
+                        int16_t* out) {
+  for (int ch = 0; ch < channels; ch++) {
+    kernels.decode_channel(in + ch * kCompactChannelBytes, scratch);
+    for (int i = 0; i < kCompactFrameSamples; i++) {
+      out[i * channels + ch] = scratch[i];
+    }
+  }
+}
+
+// Encoder
+
+// Residual divided by a scale factor, rounded away from zero.
+static inline int DivideByScale(int value, int scale_index) {
+  int n = (value * kReciprocals[scale_index] + (1 << 15)) >> 16;
+  return n + ((value > 0) - (value < 0)) - ((n > 0) - (n < 0));
+}
+
+// Encodes kCompactSliceSamples from source, trying every scale factor and
+// keeping the one with the least error. Advances lms past the slice.
+static uint64_t EncodeSlice(const int32_t* source, Lms* lms,
+                            int* previous_scale) {
+  uint64_t best_error = ~static_cast<uint64_t>(0);
+  uint64_t best_slice = 0;
+  Lms best_lms = *lms;
+  int best_scale = *previous_scale;
+  for (int k = 0; k < 16; k++) {
+    // Starting from the last slice's choice finds a good bound early.
+    int scale = (k + *previous_scale) % 16;
+    Lms trial = *lms;
+    uint64_t slice = static_cast<uint64_t>(scale);
+    uint64_t error = 0;
+    for (int j = 0; j < kCompactSliceSamples && error < best_error; j++) {
+      int32_t predicted = trial.Predict();
+      int scaled = DivideByScale(source[j] - predicted, scale);
+      scaled = scaled < -8 ? -8 : (scaled > 8 ? 8 : scaled);
+      int code = kQuantize[scaled + 8];
+      int32_t residual = kDequant[scale][code];
+      int32_t reconstructed = ClampS16(predicted + residual);
+
+      // Penalize runaway weights, which cause clicks on some material.
+      int64_t weight_energy = 0;
+      for (int i = 0; i < 4; i++) {
+        weight_energy +=
+            static_cast<int64_t>(trial.weights[i]) * trial.weights[i];
+      }
+      int64_t penalty = (weight_energy >> 18) - 0x8ff;
+      penalty = penalty < 0 ? 0 : penalty;
+
+      int64_t difference = source[j] - reconstructed;
+      error += static_cast<uint64_t>(difference * difference +
+                                     penalty * penalty);
+      trial.Update(reconstructed, residual);
+      slice = (slice << 3) | static_cast<uint64_t>(code);
+    }
+    if (error < best_error) {
+      best_error = error;
+      best_slice = slice;
+      best_lms = trial;
+      best_scale = scale;
+    }
+  }
+  *lms = best_lms;
+  *previous_scale = best_scale;
+  return best_slice;
+}
+
+bool EncodeCompactAudio(const int16_t* samples, uint32_t length,
+                        int channels, int sample_rate,
+                        std::vector<uint8_t>* out) {
+  if (channels < 1 || channels > kCompactMaxChannels || sample_rate <= 0 ||
+      length == 0) {
+    return false;
+  }
+  uint32_t frame_count = CompactFrameCount(length);
+  size_t frame_bytes = CompactFrameBytes(channels);
+  out->assign(kCompactHeaderBytes + frame_count * frame_bytes, 0);
+  uint8_t* data = out->data();
+  std::memcpy(data, kCompactMagic, sizeof(kCompactMagic));
+  data[4] = static_cast<uint8_t>(channels);
+  WriteU32(data + 8, static_cast<uint32_t>(sample_rate));
+  WriteU32(data + 12, length);
+
+  // Source sample at a position relative to the start of the file; zero
+  // outside it.
+  auto source_at = [&](int64_t position, int ch) -> int32_t {
+    return position < 0 || position >= length
+               ? 0
+               : samples[position * channels + ch];
+  };
+
+  for (int ch = 0; ch < channels; ch++) {
+    Lms lms;
+    std::memcpy(lms.weights, kInitialWeights, sizeof(lms.weights));
+    int previous_scale = 0;
+    for (uint32_t f = 0; f < frame_count; f++) {
+      uint8_t* block = data + kCompactHeaderBytes + f * frame_bytes +
+                       ch * kCompactChannelBytes;
+      for (int lane = 0; lane < kCompactLanes; lane++) {
+        int64_t start = static_cast<int64_t>(f) * kCompactFrameSamples +
+                        lane * kCompactLaneSamples;
+        // Each lane starts from the true preceding samples and the weights
+        // the previous lane adapted to, stored so it decodes on its own.
+        uint8_t* state = block + lane * kLaneStateBytes;
+        for (int i = 0; i < 4; i++) {
+          lms.history[i] = source_at(start - 4 + i, ch);
+          lms.weights[i] = ClampS16(lms.weights[i]);
+          WriteU16(state + i * 2, static_cast<uint16_t>(lms.history[i]));
+          WriteU16(state + 8 + i * 2, static_cast<uint16_t>(lms.weights[i]));
+        }
+        for (int s = 0; s < kCompactSlicesPerLane; s++) {
+          int32_t source[kCompactSliceSamples];
+          for (int j = 0; j < kCompactSliceSamples; j++) {
+            source[j] = source_at(start + s * kCompactSliceSamples + j, ch);
+          }
+          uint64_t slice = EncodeSlice(source, &lms, &previous_scale);
+          WriteU64(block + kSlicesOffset + (s * kCompactLanes + lane) * 8,
+                   slice);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Codec plugin
+
+static const uint32_t kNoFrame = 0xffffffffu;
+
+struct CompactCodecState {
+  FMOD_CODEC_WAVEFORMAT format;
+  CompactHeader header;
+  std::vector<uint8_t> frame;
+  std::vector<int16_t> scratch;
+  // The frame at decoded_frame, interleaved.
+  std::vector<int16_t> decoded;
+  uint32_t decoded_frame;
+  // The frame the file is positioned at.
+  uint32_t file_frame;
+  uint32_t position;
+};
+
+static FMOD_RESULT F_CALL CodecOpen(FMOD_CODEC_STATE* codec,
+                                    FMOD_MODE /*mode*/,
+                                    FMOD_CREATESOUNDEXINFO* /*exinfo*/) {
+  uint8_t bytes[kCompactHeaderBytes];
+  unsigned int read = 0;
+  CompactHeader header;
+  FMOD_RESULT result = FMOD_CODEC_FILE_SEEK(codec, 0,
+                                            FMOD_CODEC_SEEK_METHOD_SET);
+  if (result == FMOD_OK) {
+    result = FMOD_CODEC_FILE_READ(codec, bytes, sizeof(bytes), &read);
+  }
+  if (result != FMOD_OK || read != sizeof(bytes) ||
+      !ReadCompactHeader(bytes, &header)) {
+    return FMOD_ERR_FORMAT;
+  }
+  unsigned int size = 0;
+  FMOD_CODEC_FILE_SIZE(codec, &size);
+  uint64_t needed =
+      kCompactHeaderBytes + static_cast<uint64_t>(CompactFrameCount(
+                                header.length)) *
+                                CompactFrameBytes(header.channels);
+  if (size < needed) {
+    return FMOD_ERR_FILE_BAD;
+  }
+
+  CompactCodecState* state = new CompactCodecState();
+  state->header = header;
+  state->frame.resize(CompactFrameBytes(header.channels));
+  state->scratch.resize(kCompactFrameSamples);
+  state->decoded.resize(static_cast<size_t>(kCompactFrameSamples) *
+                        header.channels);
+  state->decoded_frame = kNoFrame;
+  state->file_frame = 0;
+  state->position = 0;
+
+  std::memset(&state->format, 0, sizeof(state->format));
+  state->format.name = kCompactCodecName;
+  state->format.format = FMOD_SOUND_FORMAT_PCM16;
+  state->format.channels = header.channels;
+  state->format.frequency = header.sample_rate;
+  state->format.lengthbytes = size;
+  state->format.lengthpcm = header.length;
+  state->format.pcmblocksize = kCompactFrameSamples;
+
+  codec->waveformat = &state->format;
+  codec->numsubsounds = 0;
+  codec->plugindata = state;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL CodecClose(FMOD_CODEC_STATE* codec) {
+  delete static_cast<CompactCodecState*>(codec->plugindata);
+  codec->plugindata = nullptr;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT LoadFrame(FMOD_CODEC_STATE* codec,
+                             CompactCodecState* state, uint32_t frame) {
+  if (frame == state->decoded_frame) {
+    return FMOD_OK;
+  }
+  FMOD_RESULT result;
+  if (frame != state->file_frame) {
+    uint64_t offset = kCompactHeaderBytes +
+                      static_cast<uint64_t>(frame) * state->frame.size();
+    result = FMOD_CODEC_FILE_SEEK(codec, static_cast<unsigned int>(offset),
+                                  FMOD_CODEC_SEEK_METHOD_SET);
+    if (result != FMOD_OK) {
+      return result;
+    }
+  }
+  unsigned int read = 0;
+  result = FMOD_CODEC_FILE_READ(
+      codec, state->frame.data(),
+      static_cast<unsigned int>(state->frame.size()), &read);
+  if (result != FMOD_OK || read != state->frame.size()) {
+    state->file_frame = kNoFrame;
+    return result != FMOD_OK ? result : FMOD_ERR_FILE_BAD;
+  }
+  state->file_frame = frame + 1;
+  DecodeCompactFrame(GetCompactCodecKernels(), state->frame.data(),
+                     state->header.channels, state->scratch.data(),
+                     state->decoded.data());
+  state->decoded_frame = frame;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL CodecRead(FMOD_CODEC_STATE* codec, void* buffer,
+                                    unsigned int samples_in,
+                                    unsigned int* samples_out) {
+  CompactCodecState* state =
+      static_cast<CompactCodecState*>(codec->plugindata);
+  int channels = state->header.channels;
+  int16_t* out = static_cast<int16_t*>(buffer);
+  unsigned int done = 0;
+  while (done < samples_in && state->position < state->header.length) {
+    uint32_t frame = state->position / kCompactFrameSamples;
+    uint32_t offset = state->position % kCompactFrameSamples;
+    FMOD_RESULT result = LoadFrame(codec, state, frame);
+    if (result != FMOD_OK) {
+      *samples_out = done;
+      return result;
+    }
+    uint32_t count = kCompactFrameSamples - offset;
+    if (count > samples_in - done) {
+      count = samples_in - done;
+    }
+    if (count > state->header.length - state->position) {
+      count = state->header.length - state->position;
+    }
+    std::memcpy(out + static_cast<size_t>(done) * channels,
+                state->decoded.data() + static_cast<size_t>(offset) * channels,
+                static_cast<size_t>(count) * channels * sizeof(int16_t));
+    done += count;
+    state->position += count;
+  }
+  *samples_out = done;
+  return done == 0 && samples_in > 0 ? FMOD_ERR_FILE_EOF : FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL CodecSetPosition(FMOD_CODEC_STATE* codec,
+                                           int /*subsound*/,
+                                           unsigned int position,
+                                           FMOD_TIMEUNIT postype) {
+  if (postype != FMOD_TIMEUNIT_PCM) {
+    return FMOD_ERR_FORMAT;
+  }
+  CompactCodecState* state =
+      static_cast<CompactCodecState*>(codec->plugindata);
+  // Frames carry their own predictor state, so any frame decodes on its
+  // own; LoadFrame seeks on the next read.
+  state->position =
+      position < state->header.length ? position : state->header.length;
+  return FMOD_OK;
+}
+
+static FMOD_CODEC_DESCRIPTION kCompactCodecDescription = {
+    FMOD_CODEC_PLUGIN_VERSION,
+    kCompactCodecName,
+    0x00010000,
+    0,  // Decoded into memory unless FMOD_CREATESTREAM is passed.
+    FMOD_TIMEUNIT_PCM,
+    CodecOpen,
+    CodecClose,
+    CodecRead,
+    nullptr,  // getlength: FMOD reads lengthpcm.
+    CodecSetPosition,
+    nullptr,  // getposition
+    nullptr,  // soundcreate
+    nullptr,  // getwaveformat: no subsounds.
+};
+
+const FMOD_CODEC_DESCRIPTION* GetCompactCodecDescription() {
+  return &kCompactCodecDescription;
+}
+
+}  // namespace fmod_flutter
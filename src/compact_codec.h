@@ -0,0 +1,101 @@
+#ifndef FMOD_FLUTTER_COMPACT_CODEC_H_
+#define FMOD_FLUTTER_COMPACT_CODEC_H_
+
+// A compact in-app sound format (.fca) and the FMOD codec plugin that plays
+// it, registered with System_RegisterCodec by sound_library.h.
+//
+// The coding follows QOA: a 4-tap sign-sign LMS predictor and 3-bit
+// residuals with a 4-bit scale factor per slice of 20 samples, about 3.8
+// bits per sample. Unlike QOA, each frame splits every channel into four
+// lanes that carry their own predictor state, so a decoder can run the
+// four predictors side by side in one SIMD register. Decoding is integer
+// only and every kernel variant is bit-identical to the scalar reference.
+//
+// Layout, little-endian:
+//   header   "FCA1", u8 channels, u8 0, u16 0, u32 sample rate,
+//            u32 length in samples per channel
+//   frames   kCompactFrameSamples per channel, the last one zero-padded;
+//            per channel, kCompactLanes lane states (i16 history[4],
+//            i16 weights[4]), then kCompactSlicesPerLane rounds of one
+//            u64 slice per lane. A slice holds the scale factor in bits
+//            63-60 and 20 residual codes from bit 59 down.
+// Lane n decodes samples [n * kCompactLaneSamples, (n + 1) *
+// kCompactLaneSamples) of its frame.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fmod.h>
+#include <fmod_codec.h>
+
+#ifdef __cplusplus
+
+#include <vector>
+
+namespace fmod_flutter {
+
+static const int kCompactHeaderBytes = 16;
+static const int kCompactMaxChannels = 8;
+static const int kCompactLanes = 4;
+static const int kCompactSliceSamples = 20;
+static const int kCompactSlicesPerLane = 10;
+static const int kCompactLaneSamples =
+    kCompactSliceSamples * kCompactSlicesPerLane;
+static const int kCompactFrameSamples = kCompactLaneSamples * kCompactLanes;
+// Encoded size of one channel of one frame.
+static const int kCompactChannelBytes =
+    kCompactLanes * 16 + kCompactLanes * kCompactSlicesPerLane * 8;
+
+struct CompactHeader {
+  int channels;
+  int sample_rate;
+  uint32_t length;
+};
+
+// Parses the first kCompactHeaderBytes of a file.
+bool ReadCompactHeader(const uint8_t* data, CompactHeader* header);
+
+inline size_t CompactFrameBytes(int channels) {
+  return static_cast<size_t>(kCompactChannelBytes) * channels;
+}
+
+inline uint32_t CompactFrameCount(uint32_t length) {
+  return (length + kCompactFrameSamples - 1) / kCompactFrameSamples;
+}
+
+struct CompactCodecKernels {
+  const char* name;
+
+  // Decodes one channel of one frame (kCompactChannelBytes) into
+  // kCompactFrameSamples contiguous samples.
+  void (*decode_channel)(const uint8_t* in, int16_t* out);
+};
+
+// The fastest kernels supported by this CPU. Selected on first use.
+const CompactCodecKernels& GetCompactCodecKernels();
+
+// The portable reference implementation.
+const CompactCodecKernels& GetScalarCompactCodecKernels();
+
+// Decodes one frame of every channel into interleaved samples.
+// scratch holds kCompactFrameSamples samples.
+void DecodeCompactFrame(const CompactCodecKernels& kernels,
+                        const uint8_t* in, int channels, int16_t* scratch,
+                        int16_t* out);
+
+// Encodes length interleaved samples per channel into a complete file.
+// Searches every scale factor of every slice, so runs offline.
+bool EncodeCompactAudio(const int16_t* samples, uint32_t length,
+                        int channels, int sample_rate,
+                        std::vector<uint8_t>* out);
+
+// Codec plugin for System_RegisterCodec. Opens .fca files and memory
+// (FMOD_OPENMEMORY) as 16-bit PCM, as samples or streams; any other data
+// is declined with FMOD_ERR_FORMAT after reading its header.
+const FMOD_CODEC_DESCRIPTION* GetCompactCodecDescription();
+
+}  // namespace fmod_flutter
+
+#endif  // __cplusplus
+
+#endif  // FMOD_FLUTTER_COMPACT_CODEC_H_
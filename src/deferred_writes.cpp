@@ -0,0 +1,248 @@
+#include "deferred_writes.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace fmod_flutter {
+
+// setParametersByIDs takes at most this many parameters per call.
+static const int kMaxParametersPerCall = 32;
+
+static bool SameParameter(const FMOD_STUDIO_PARAMETER_ID& a,
+                          const FMOD_STUDIO_PARAMETER_ID& b) {
+  return a.data1 == b.data1 && a.data2 == b.data2;
+}
+
+DeferredWrites::DeferredWrites() : pending_count_(0), last_result_(FMOD_OK) {
+  std::memset(&stats_, 0, sizeof(stats_));
+}
+
+bool DeferredWrites::SetParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                                  const char* parameter_name, float value) {
+  Pending* pending = Find(instance);
+  FMOD_STUDIO_PARAMETER_ID parameter;
+  if (pending == nullptr ||
+      !FindParameter(pending->description, parameter_name, &parameter)) {
+    return false;
+  }
+  stats_.writes++;
+  for (size_t i = 0; i < pending->parameters.size(); i++) {
+    if (SameParameter(pending->parameters[i], parameter)) {
+      pending->values[i] = value;
+      stats_.coalesced++;
+      return true;
+    }
+  }
+  pending->parameters.push_back(parameter);
+  pending->values.push_back(value);
+  return true;
+}
+
+bool DeferredWrites::SetVolume(FMOD_STUDIO_EVENTINSTANCE* instance,
+                               float volume) {
+  Pending* pending = Find(instance);
+  if (pending == nullptr) {
+    return false;
+  }
+  stats_.writes++;
+  if (pending->has_volume) {
+    stats_.coalesced++;
+  }
+  pending->has_volume = true;
+  pending->volume = volume;
+  return true;
+}
+
+bool DeferredWrites::SetPitch(FMOD_STUDIO_EVENTINSTANCE* instance,
+                              float pitch) {
+  Pending* pending = Find(instance);
+  if (pending == nullptr) {
+    return false;
+  }
+  stats_.writes++;
+  if (pending->has_pitch) {
+    stats_.coalesced++;
+  }
+  pending->has_pitch = true;
+  pending->pitch = pitch;
+  return true;
+}
+
+void DeferredWrites::Forget(FMOD_STUDIO_EVENTINSTANCE* instance) {
+  for (size_t i = 0; i < pending_count_; i++) {
+    if (pending_[i].instance == instance) {
+      Remove(i);
+      return;
+    }
+  }
+}
+
+void DeferredWrites::FlushInstance(FMOD_STUDIO_EVENTINSTANCE* instance) {
+  for (size_t i = 0; i < pending_count_; i++) {
+    if (pending_[i].instance == instance) {
+      stats_.flushes++;
+      Apply(pending_[i]);
+      Remove(i);
+      return;
+    }
+  }
+}
+
+void DeferredWrites::Flush() {
+  if (pending_count_ == 0) {
+    return;
+  }
+  stats_.flushes++;
+  for (size_t i = 0; i < pending_count_; i++) {
+    Apply(pending_[i]);
+  }
+  pending_count_ = 0;
+}
+
+void DeferredWrites::Clear() {
+  pending_.clear();
+  pending_count_ = 0;
+  parameter_ids_.clear();
+  std::memset(&stats_, 0, sizeof(stats_));
+}
+
+DeferredWrites::Pending* DeferredWrites::Find(
+    FMOD_STUDIO_EVENTINSTANCE* instance) {
+  // A tick touches few instances; a scan beats hashing them.
+  for (size_t i = 0; i < pending_count_; i++) {
+    if (pending_[i].instance == instance) {
+      return &pending_[i];
+    }
+  }
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  last_result_ =
+      FMOD_Studio_EventInstance_GetDescription(instance, &description);
+  if (last_result_ != FMOD_OK) {
+    return nullptr;
+  }
+  if (pending_count_ == pending_.size()) {
+    pending_.push_back(Pending());
+  }
+  Pending& pending = pending_[pending_count_++];
+  pending.instance = instance;
+  pending.description = description;
+  pending.parameters.clear();
+  pending.values.clear();
+  pending.has_volume = false;
+  pending.volume = 1.0f;
+  pending.has_pitch = false;
+  pending.pitch = 1.0f;
+  return &pending;
+}
+
+void DeferredWrites::Apply(Pending& pending) {
+  int count = static_cast<int>(pending.parameters.size());
+  for (int first = 0; first < count; first += kMaxParametersPerCall) {
+    Issue(FMOD_Studio_EventInstance_SetParametersByIDs(
+        pending.instance, &pending.parameters[first], &pending.values[first],
+        std::min(kMaxParametersPerCall, count - first), 0));
+  }
+  if (pending.has_volume) {
+    Issue(FMOD_Studio_EventInstance_SetVolume(pending.instance,
+                                              pending.volume));
+  }
+  if (pending.has_pitch) {
+    Issue(
+        FMOD_Studio_EventInstance_SetPitch(pending.instance, pending.pitch));
+  }
+}
+
+void DeferredWrites::Remove(size_t index) {
+  // Keeps the live entries at the front.
+  std::swap(pending_[index], pending_[pending_count_ - 1]);
+  pending_count_--;
+}
+
+bool DeferredWrites::FindParameter(FMOD_STUDIO_EVENTDESCRIPTION* description,
+                                   const char* parameter_name,
+                                   FMOD_STUDIO_PARAMETER_ID* parameter) {
+  ParameterIds& ids = parameter_ids_[description];
+  auto it = ids.find(parameter_name);
+  if (it != ids.end()) {
+    *parameter = it->second;
+    last_result_ = FMOD_OK;
+    return true;
+  }
+  FMOD_STUDIO_PARAMETER_DESCRIPTION parameter_description;
+  last_result_ = FMOD_Studio_EventDescription_GetParameterDescriptionByName(
+      description, parameter_name, &parameter_description);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  ids[parameter_name] = parameter_description.id;
+  *parameter = parameter_description.id;
+  return true;
+}
+
+void DeferredWrites::Issue(FMOD_RESULT result) {
+  stats_.fmod_calls++;
+  if (result != FMOD_OK) {
+    stats_.failed_calls++;
+    last_result_ = result;
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodDeferredWrites {
+  fmod_flutter::DeferredWrites writes;
+};
+
+FmodDeferredWrites* fmod_deferred_writes_create(void) {
+  return new FmodDeferredWrites();
+}
+
+void fmod_deferred_writes_destroy(FmodDeferredWrites* writes) {
+  delete writes;
+}
+
+int fmod_deferred_writes_set_parameter(FmodDeferredWrites* writes,
+                                       FMOD_STUDIO_EVENTINSTANCE* instance,
+                                       const char* parameter_name,
+                                       float value) {
+  return writes->writes.SetParameter(instance, parameter_name, value) ? 1 : 0;
+}
+
+int fmod_deferred_writes_set_volume(FmodDeferredWrites* writes,
+                                    FMOD_STUDIO_EVENTINSTANCE* instance,
+                                    float volume) {
+  return writes->writes.SetVolume(instance, volume) ? 1 : 0;
+}
+
+int fmod_deferred_writes_set_pitch(FmodDeferredWrites* writes,
+                                   FMOD_STUDIO_EVENTINSTANCE* instance,
+                                   float pitch) {
+  return writes->writes.SetPitch(instance, pitch) ? 1 : 0;
+}
+
+void fmod_deferred_writes_forget(FmodDeferredWrites* writes,
+                                 FMOD_STUDIO_EVENTINSTANCE* instance) {
+  writes->writes.Forget(instance);
+}
+
+void fmod_deferred_writes_flush_instance(FmodDeferredWrites* writes,
+                                         FMOD_STUDIO_EVENTINSTANCE* instance) {
+  writes->writes.FlushInstance(instance);
+}
+
+void fmod_deferred_writes_flush(FmodDeferredWrites* writes) {
+  writes->writes.Flush();
+}
+
+void fmod_deferred_writes_get_stats(FmodDeferredWrites* writes,
+                                    FmodDeferredWriteStats* stats) {
+  writes->writes.GetStats(stats);
+}
+
+void fmod_deferred_writes_clear(FmodDeferredWrites* writes) {
+  writes->writes.Clear();
+}
+
+FMOD_RESULT fmod_deferred_writes_last_result(FmodDeferredWrites* writes) {
+  return writes->writes.last_result();
+}
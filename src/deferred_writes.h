@@ -0,0 +1,147 @@
+#ifndef FMOD_FLUTTER_DEFERRED_WRITES_H_
+#define FMOD_FLUTTER_DEFERRED_WRITES_H_
+
+// Deferred event instance writes shared by all native bridges.
+//
+// Dart can set the same parameter many times within one frame, e.g. from a
+// gesture stream. Parameter, volume and pitch writes are therefore held in
+// a table for the current update tick, keyed by instance and parameter id,
+// where a later write replaces an earlier one. Flush(), called once before
+// Studio::System::update, applies each instance's parameters with one
+// setParametersByIDs call plus at most one setVolume and one setPitch.
+// Studio queues every call until the update anyway, so nothing reaches the
+// mix later than it would have.
+//
+// Parameter names are resolved to ids as they are written, through a cache
+// per event description, so an unknown name or a released instance still
+// fails at the call site.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+// Counters since the last Clear().
+typedef struct FmodDeferredWriteStats {
+  int64_t writes;        // parameter, volume and pitch writes accepted
+  int64_t coalesced;     // writes replaced by a later one before a flush
+  int64_t fmod_calls;    // setter calls issued by Flush()
+  int64_t failed_calls;  // e.g. on an instance released before the flush
+  int64_t flushes;       // flushes that had anything to apply
+} FmodDeferredWriteStats;
+
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class DeferredWrites {
+ public:
+  DeferredWrites();
+
+  // Queue a write for the next Flush(). Return false when the instance is
+  // invalid or, for SetParameter, has no such parameter; see last_result().
+  bool SetParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                    const char* parameter_name, float value);
+  bool SetVolume(FMOD_STUDIO_EVENTINSTANCE* instance, float volume);
+  bool SetPitch(FMOD_STUDIO_EVENTINSTANCE* instance, float pitch);
+
+  // Drops every queued write to an instance, e.g. before it is reused.
+  void Forget(FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  // Applies the queued writes to one instance now. Call before stopping
+  // it, so writes made earlier in the tick still shape its fade-out
+  // rather than being dropped when it is recycled.
+  void FlushInstance(FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  // Applies the queued writes. Call once per tick, before the Studio
+  // update, and before anything that reads back or overrides a queued
+  // value, such as starting a curve on a parameter.
+  void Flush();
+
+  void GetStats(FmodDeferredWriteStats* stats) const { *stats = stats_; }
+  int pending_count() const { return static_cast<int>(pending_count_); }
+
+  // Drops queued writes, cached parameter ids and counters. Call before
+  // releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  struct Pending {
+    FMOD_STUDIO_EVENTINSTANCE* instance;
+    FMOD_STUDIO_EVENTDESCRIPTION* description;
+    std::vector<FMOD_STUDIO_PARAMETER_ID> parameters;
+    std::vector<float> values;
+    bool has_volume;
+    float volume;
+    bool has_pitch;
+    float pitch;
+  };
+
+  typedef std::unordered_map<std::string, FMOD_STUDIO_PARAMETER_ID>
+      ParameterIds;
+
+  // The queued writes of an instance, added if it has none yet; null if
+  // the instance is invalid.
+  Pending* Find(FMOD_STUDIO_EVENTINSTANCE* instance);
+  // Issues the setter calls of one entry.
+  void Apply(Pending& pending);
+  void Remove(size_t index);
+  bool FindParameter(FMOD_STUDIO_EVENTDESCRIPTION* description,
+                     const char* parameter_name,
+                     FMOD_STUDIO_PARAMETER_ID* parameter);
+  void Issue(FMOD_RESULT result);
+
+  // The first pending_count_ entries are live; the rest keep their
+  // capacity for later ticks.
+  std::vector<Pending> pending_;
+  size_t pending_count_;
+  // Kept until Clear(); bounded by the parameters the app names.
+  std::unordered_map<FMOD_STUDIO_EVENTDESCRIPTION*, ParameterIds>
+      parameter_ids_;
+
+  FmodDeferredWriteStats stats_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodDeferredWrites FmodDeferredWrites;
+
+FmodDeferredWrites* fmod_deferred_writes_create(void);
+void fmod_deferred_writes_destroy(FmodDeferredWrites* writes);
+int fmod_deferred_writes_set_parameter(FmodDeferredWrites* writes,
+                                       FMOD_STUDIO_EVENTINSTANCE* instance,
+                                       const char* parameter_name,
+                                       float value);
+int fmod_deferred_writes_set_volume(FmodDeferredWrites* writes,
+                                    FMOD_STUDIO_EVENTINSTANCE* instance,
+                                    float volume);
+int fmod_deferred_writes_set_pitch(FmodDeferredWrites* writes,
+                                   FMOD_STUDIO_EVENTINSTANCE* instance,
+                                   float pitch);
+void fmod_deferred_writes_forget(FmodDeferredWrites* writes,
+                                 FMOD_STUDIO_EVENTINSTANCE* instance);
+void fmod_deferred_writes_flush_instance(FmodDeferredWrites* writes,
+                                         FMOD_STUDIO_EVENTINSTANCE* instance);
+void fmod_deferred_writes_flush(FmodDeferredWrites* writes);
+void fmod_deferred_writes_get_stats(FmodDeferredWrites* writes,
+                                    FmodDeferredWriteStats* stats);
+void fmod_deferred_writes_clear(FmodDeferredWrites* writes);
+FMOD_RESULT fmod_deferred_writes_last_result(FmodDeferredWrites* writes);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_DEFERRED_WRITES_H_
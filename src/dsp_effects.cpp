@@ -0,0 +1,644 @@
+#include "dsp_effects.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "dsp_kernels.h"
+#include "loudness_meter.h"
+
+namespace fmod_flutter {
+
+static const double kPi = 3.14159265358979323846;
+
+static float DbToLinear(float db) {
+  return std::pow(10.0f, db / 20.0f);
+}
+
+// Soft limiter
+
+struct SoftLimiterState {
+  float drive_db;
+  float ceiling_db;
+  // Derived on the setter thread; the mixer only reads them.
+  std::atomic<float> gain;
+  std::atomic<float> ceiling;
+};
+
+static void UpdateSoftLimiter(SoftLimiterState* state) {
+  float ceiling = DbToLinear(state->ceiling_db);
+  state->gain.store(DbToLinear(state->drive_db) / ceiling);
+  state->ceiling.store(ceiling);
+}
+
+static FMOD_RESULT F_CALL SoftLimiterCreate(FMOD_DSP_STATE* dsp_state) {
+  SoftLimiterState* state = new SoftLimiterState();
+  state->drive_db = 0.0f;
+  state->ceiling_db = -1.0f;
+  UpdateSoftLimiter(state);
+  dsp_state->plugindata = state;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL SoftLimiterRelease(FMOD_DSP_STATE* dsp_state) {
+  delete static_cast<SoftLimiterState*>(dsp_state->plugindata);
+  dsp_state->plugindata = nullptr;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL SoftLimiterRead(FMOD_DSP_STATE* dsp_state,
+                                          float* inbuffer, float* outbuffer,
+                                          unsigned int length, int inchannels,
+                                          int* outchannels) {
+  SoftLimiterState* state =
+      static_cast<SoftLimiterState*>(dsp_state->plugindata);
+  *outchannels = inchannels;
+  GetDspKernels().soft_clip(inbuffer, outbuffer,
+                            static_cast<int>(length) * inchannels,
+                            state->gain.load(), state->ceiling.load());
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL SoftLimiterShouldIProcess(
+    FMOD_DSP_STATE* /*dsp_state*/, FMOD_BOOL inputsidle,
+    unsigned int /*length*/, FMOD_CHANNELMASK /*inmask*/,
+    int /*inchannels*/, FMOD_SPEAKERMODE /*speakermode*/) {
+  return inputsidle ? FMOD_ERR_DSP_DONTPROCESS : FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL SoftLimiterSetFloat(FMOD_DSP_STATE* dsp_state,
+                                              int index, float value) {
+  SoftLimiterState* state =
+      static_cast<SoftLimiterState*>(dsp_state->plugindata);
+  switch (index) {
+    case FMOD_FLUTTER_SOFT_LIMITER_DRIVE:
+      state->drive_db = value;
+      break;
+    case FMOD_FLUTTER_SOFT_LIMITER_CEILING:
+      state->ceiling_db = value;
+      break;
+    default:
+      return FMOD_ERR_INVALID_PARAM;
+  }
+  UpdateSoftLimiter(state);
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL SoftLimiterGetFloat(FMOD_DSP_STATE* dsp_state,
+                                              int index, float* value,
+                                              char* valuestr) {
+  SoftLimiterState* state =
+      static_cast<SoftLimiterState*>(dsp_state->plugindata);
+  switch (index) {
+    case FMOD_FLUTTER_SOFT_LIMITER_DRIVE:
+      *value = state->drive_db;
+      break;
+    case FMOD_FLUTTER_SOFT_LIMITER_CEILING:
+      *value = state->ceiling_db;
+      break;
+    default:
+      return FMOD_ERR_INVALID_PARAM;
+  }
+  if (valuestr != nullptr) {
+    snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%.1f dB", *value);
+  }
+  return FMOD_OK;
+}
+
+// Biquad
+
+struct BiquadState {
+  std::atomic<int> type;
+  std::atomic<float> frequency;
+  std::atomic<float> q;
+  std::atomic<float> gain_db;
+  // Bumped by the setters; the mixer recomputes coefficients when it sees a
+  // new version or a sample rate change.
+  std::atomic<int> version;
+  int applied_version;
+  int sample_rate;
+  BiquadCoefficients coefficients;
+  float z1[FMOD_MAX_CHANNEL_WIDTH];
+  float z2[FMOD_MAX_CHANNEL_WIDTH];
+};
+
+// Robert Bristow-Johnson's audio EQ cookbook.
+static BiquadCoefficients ComputeBiquad(int type, float frequency, float q,
+                                        float gain_db, int sample_rate) {
+  double nyquist_limit = sample_rate * 0.49;
+  double f = frequency < nyquist_limit ? frequency : nyquist_limit;
+  double w0 = 2.0 * kPi * f / sample_rate;
+  double cos_w0 = std::cos(w0);
+  double alpha = std::sin(w0) / (2.0 * (q > 0.01f ? q : 0.01f));
+  double a = std::pow(10.0, gain_db / 40.0);
+  double shelf = 2.0 * std::sqrt(a) * alpha;
+
+  double b0, b1, b2, a0, a1, a2;
+  switch (type) {
+    case FMOD_FLUTTER_BIQUAD_HIGHPASS:
+      b0 = (1.0 + cos_w0) / 2.0;
+      b1 = -(1.0 + cos_w0);
+      b2 = b0;
+      a0 = 1.0 + alpha;
+      a1 = -2.0 * cos_w0;
+      a2 = 1.0 - alpha;
+      break;
+    case FMOD_FLUTTER_BIQUAD_PEAKING:
+      b0 = 1.0 + alpha * a;
+      b1 = -2.0 * cos_w0;
+      b2 = 1.0 - alpha * a;
+      a0 = 1.0 + alpha / a;
+      a1 = -2.0 * cos_w0;
+      a2 = 1.0 - alpha / a;
+      break;
+    case FMOD_FLUTTER_BIQUAD_LOWSHELF:
+      b0 = a * ((a + 1.0) - (a - 1.0) * cos_w0 + shelf);
+      b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cos_w0);
+      b2 = a * ((a + 1.0) - (a - 1.0) * cos_w0 - shelf);
+      a0 = (a + 1.0) + (a - 1.0) * cos_w0 + shelf;
+      a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cos_w0);
+      a2 = (a + 1.0) + (a - 1.0) * cos_w0 - shelf;
+      break;
+    case FMOD_FLUTTER_BIQUAD_HIGHSHELF:
+      b0 = a * ((a + 1.0) + (a - 1.0) * cos_w0 + shelf);
+      b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0);
+      b2 = a * ((a + 1.0) + (a - 1.0) * cos_w0 - shelf);
+      a0 = (a + 1.0) - (a - 1.0) * cos_w0 + shelf;
+      a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cos_w0);
+      a2 = (a + 1.0) - (a - 1.0) * cos_w0 - shelf;
+      break;
+    case FMOD_FLUTTER_BIQUAD_LOWPASS:
+    default:
+      b0 = (1.0 - cos_w0) / 2.0;
+      b1 = 1.0 - cos_w0;
+      b2 = b0;
+      a0 = 1.0 + alpha;
+      a1 = -2.0 * cos_w0;
+      a2 = 1.0 - alpha;
+      break;
+  }
+
+  BiquadCoefficients c;
+  c.b0 = static_cast<float>(b0 / a0);
+  c.b1 = static_cast<float>(b1 / a0);
+  c.b2 = static_cast<float>(b2 / a0);
+  c.a1 = static_cast<float>(a1 / a0);
+  c.a2 = static_cast<float>(a2 / a0);
+  return c;
+}
+
+static FMOD_RESULT F_CALL BiquadCreate(FMOD_DSP_STATE* dsp_state) {
+  BiquadState* state = new BiquadState();
+  state->type.store(FMOD_FLUTTER_BIQUAD_PEAKING);
+  state->frequency.store(1000.0f);
+  state->q.store(0.707f);
+  state->gain_db.store(0.0f);
+  state->version.store(1);
+  state->applied_version = 0;
+  state->sample_rate = 0;
+  std::memset(&state->coefficients, 0, sizeof(state->coefficients));
+  std::memset(state->z1, 0, sizeof(state->z1));
+  std::memset(state->z2, 0, sizeof(state->z2));
+  dsp_state->plugindata = state;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadRelease(FMOD_DSP_STATE* dsp_state) {
+  delete static_cast<BiquadState*>(dsp_state->plugindata);
+  dsp_state->plugindata = nullptr;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadReset(FMOD_DSP_STATE* dsp_state) {
+  BiquadState* state = static_cast<BiquadState*>(dsp_state->plugindata);
+  std::memset(state->z1, 0, sizeof(state->z1));
+  std::memset(state->z2, 0, sizeof(state->z2));
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadRead(FMOD_DSP_STATE* dsp_state,
+                                     float* inbuffer, float* outbuffer,
+                                     unsigned int length, int inchannels,
+                                     int* outchannels) {
+  BiquadState* state = static_cast<BiquadState*>(dsp_state->plugindata);
+  *outchannels = inchannels;
+
+  int sample_rate = 0;
+  FMOD_DSP_GETSAMPLERATE(dsp_state, &sample_rate);
+  int version = state->version.load();
+  if (version != state->applied_version || sample_rate != state->sample_rate) {
+    state->coefficients =
+        ComputeBiquad(state->type.load(), state->frequency.load(),
+                      state->q.load(), state->gain_db.load(), sample_rate);
+    state->applied_version = version;
+    state->sample_rate = sample_rate;
+  }
+
+  int channels =
+      inchannels < FMOD_MAX_CHANNEL_WIDTH ? inchannels : FMOD_MAX_CHANNEL_WIDTH;
+  GetDspKernels().biquad(inbuffer, outbuffer, static_cast<int>(length),
+                         channels, state->coefficients, state->z1, state->z2);
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadShouldIProcess(
+    FMOD_DSP_STATE* dsp_state, FMOD_BOOL inputsidle,
+    unsigned int /*length*/, FMOD_CHANNELMASK /*inmask*/,
+    int /*inchannels*/, FMOD_SPEAKERMODE /*speakermode*/) {
+  if (inputsidle) {
+    // Idle input means silence, so the filter state can start from rest.
+    BiquadReset(dsp_state);
+    return FMOD_ERR_DSP_DONTPROCESS;
+  }
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadSetFloat(FMOD_DSP_STATE* dsp_state, int index,
+                                         float value) {
+  BiquadState* state = static_cast<BiquadState*>(dsp_state->plugindata);
+  switch (index) {
+    case FMOD_FLUTTER_BIQUAD_FREQUENCY:
+      state->frequency.store(value);
+      break;
+    case FMOD_FLUTTER_BIQUAD_Q:
+      state->q.store(value);
+      break;
+    case FMOD_FLUTTER_BIQUAD_GAIN:
+      state->gain_db.store(value);
+      break;
+    default:
+      return FMOD_ERR_INVALID_PARAM;
+  }
+  state->version.fetch_add(1);
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadGetFloat(FMOD_DSP_STATE* dsp_state, int index,
+                                         float* value, char* valuestr) {
+  BiquadState* state = static_cast<BiquadState*>(dsp_state->plugindata);
+  const char* unit = "";
+  switch (index) {
+    case FMOD_FLUTTER_BIQUAD_FREQUENCY:
+      *value = state->frequency.load();
+      unit = " Hz";
+      break;
+    case FMOD_FLUTTER_BIQUAD_Q:
+      *value = state->q.load();
+      break;
+    case FMOD_FLUTTER_BIQUAD_GAIN:
+      *value = state->gain_db.load();
+      unit = " dB";
+      break;
+    default:
+      return FMOD_ERR_INVALID_PARAM;
+  }
+  if (valuestr != nullptr) {
+    snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%.2f%s", *value,
+             unit);
+  }
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadSetInt(FMOD_DSP_STATE* dsp_state, int index,
+                                       int value) {
+  if (index != FMOD_FLUTTER_BIQUAD_TYPE) {
+    return FMOD_ERR_INVALID_PARAM;
+  }
+  BiquadState* state = static_cast<BiquadState*>(dsp_state->plugindata);
+  state->type.store(value);
+  state->version.fetch_add(1);
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL BiquadGetInt(FMOD_DSP_STATE* dsp_state, int index,
+                                       int* value, char* /*valuestr*/) {
+  if (index != FMOD_FLUTTER_BIQUAD_TYPE) {
+    return FMOD_ERR_INVALID_PARAM;
+  }
+  BiquadState* state = static_cast<BiquadState*>(dsp_state->plugindata);
+  *value = state->type.load();
+  return FMOD_OK;
+}
+
+// Descriptions
+
+static FMOD_DSP_PARAMETER_DESC soft_limiter_drive;
+static FMOD_DSP_PARAMETER_DESC soft_limiter_ceiling;
+static FMOD_DSP_PARAMETER_DESC* soft_limiter_params[] = {
+    &soft_limiter_drive, &soft_limiter_ceiling};
+
+static FMOD_DSP_PARAMETER_DESC biquad_type;
+static FMOD_DSP_PARAMETER_DESC biquad_frequency;
+static FMOD_DSP_PARAMETER_DESC biquad_q;
+static FMOD_DSP_PARAMETER_DESC biquad_gain;
+static FMOD_DSP_PARAMETER_DESC* biquad_params[] = {
+    &biquad_type, &biquad_frequency, &biquad_q, &biquad_gain};
+static const char* biquad_type_names[] = {"Low Pass", "High Pass", "Peaking",
+                                          "Low Shelf", "High Shelf"};
+
+static FMOD_DSP_DESCRIPTION descriptions[FMOD_FLUTTER_DSP_EFFECT_COUNT];
+
+static void InitDescriptions() {
+  FMOD_DSP_INIT_PARAMDESC_FLOAT(soft_limiter_drive, "Drive", "dB",
+                                "Input gain before limiting", 0.0f, 24.0f,
+                                0.0f);
+  FMOD_DSP_INIT_PARAMDESC_FLOAT(soft_limiter_ceiling, "Ceiling", "dB",
+                                "Output ceiling", -24.0f, 0.0f, -1.0f);
+
+  FMOD_DSP_INIT_PARAMDESC_INT_ENUMERATED(biquad_type, "Type", "",
+                                         "Filter shape",
+                                         FMOD_FLUTTER_BIQUAD_PEAKING,
+                                         biquad_type_names);
+  FMOD_DSP_INIT_PARAMDESC_FLOAT(biquad_frequency, "Frequency", "Hz",
+                                "Cutoff or center frequency", 20.0f, 20000.0f,
+                                1000.0f);
+  FMOD_DSP_INIT_PARAMDESC_FLOAT(biquad_q, "Q", "", "Resonance", 0.1f, 10.0f,
+                                0.707f);
+  FMOD_DSP_INIT_PARAMDESC_FLOAT(biquad_gain, "Gain", "dB",
+                                "Peaking and shelf gain", -24.0f, 24.0f, 0.0f);
+
+  FMOD_DSP_DESCRIPTION& limiter = descriptions[FMOD_FLUTTER_DSP_SOFT_LIMITER];
+  std::memset(&limiter, 0, sizeof(limiter));
+  limiter.pluginsdkversion = FMOD_PLUGIN_SDK_VERSION;
+  std::strncpy(limiter.name, "FmodFlutter Soft Limiter",
+               sizeof(limiter.name) - 1);
+  limiter.version = 0x00010000;
+  limiter.numinputbuffers = 1;
+  limiter.numoutputbuffers = 1;
+  limiter.create = SoftLimiterCreate;
+  limiter.release = SoftLimiterRelease;
+  limiter.read = SoftLimiterRead;
+  limiter.shouldiprocess = SoftLimiterShouldIProcess;
+  limiter.numparameters = 2;
+  limiter.paramdesc = soft_limiter_params;
+  limiter.setparameterfloat = SoftLimiterSetFloat;
+  limiter.getparameterfloat = SoftLimiterGetFloat;
+
+  FMOD_DSP_DESCRIPTION& biquad = descriptions[FMOD_FLUTTER_DSP_BIQUAD];
+  std::memset(&biquad, 0, sizeof(biquad));
+  biquad.pluginsdkversion = FMOD_PLUGIN_SDK_VERSION;
+  std::strncpy(biquad.name, "FmodFlutter Biquad", sizeof(biquad.name) - 1);
+  biquad.version = 0x00010000;
+  biquad.numinputbuffers = 1;
+  biquad.numoutputbuffers = 1;
+  biquad.create = BiquadCreate;
+  biquad.release = BiquadRelease;
+  biquad.reset = BiquadReset;
+  biquad.read = BiquadRead;
+  biquad.shouldiprocess = BiquadShouldIProcess;
+  biquad.numparameters = 4;
+  biquad.paramdesc = biquad_params;
+  biquad.setparameterfloat = BiquadSetFloat;
+  biquad.setparameterint = BiquadSetInt;
+  biquad.getparameterfloat = BiquadGetFloat;
+  biquad.getparameterint = BiquadGetInt;
+
+  descriptions[FMOD_FLUTTER_DSP_LOUDNESS_METER] = GetLoudnessMeterDescription();
+}
+
+// Bus channel group locks
+
+static std::map<FMOD_STUDIO_BUS*, int> bus_locks;
+
+FMOD_RESULT AcquireBusChannelGroup(FMOD_STUDIO_SYSTEM* studio_system,
+                                   FMOD_STUDIO_BUS* bus,
+                                   FMOD_CHANNELGROUP** group) {
+  // The bus's channel group only exists once the lock has been executed.
+  int& locks = bus_locks[bus];
+  if (locks == 0) {
+    FMOD_RESULT result = FMOD_Studio_Bus_LockChannelGroup(bus);
+    if (result == FMOD_OK) {
+      result = FMOD_Studio_System_FlushCommands(studio_system);
+    }
+    if (result != FMOD_OK) {
+      bus_locks.erase(bus);
+      return result;
+    }
+  }
+  locks++;
+
+  FMOD_RESULT result = FMOD_Studio_Bus_GetChannelGroup(bus, group);
+  if (result != FMOD_OK) {
+    ReleaseBusChannelGroup(bus);
+  }
+  return result;
+}
+
+void ReleaseBusChannelGroup(FMOD_STUDIO_BUS* bus) {
+  auto it = bus_locks.find(bus);
+  if (it != bus_locks.end() && --it->second == 0) {
+    FMOD_Studio_Bus_UnlockChannelGroup(bus);
+    bus_locks.erase(it);
+  }
+}
+
+// BusEffects
+
+BusEffects::BusEffects()
+    : registered_system_(nullptr), next_effect_id_(1), last_result_(FMOD_OK) {
+  std::memset(handles_, 0, sizeof(handles_));
+}
+
+bool BusEffects::RegisterDescriptions(FMOD_SYSTEM* core_system) {
+  if (registered_system_ == core_system) {
+    return true;
+  }
+
+  static bool initialized = false;
+  if (!initialized) {
+    InitDescriptions();
+    initialized = true;
+  }
+
+  for (int i = 0; i < FMOD_FLUTTER_DSP_EFFECT_COUNT; i++) {
+    last_result_ =
+        FMOD_System_RegisterDSP(core_system, &descriptions[i], &handles_[i]);
+    if (last_result_ != FMOD_OK) {
+      return false;
+    }
+  }
+  registered_system_ = core_system;
+  return true;
+}
+
+int BusEffects::Add(FMOD_STUDIO_SYSTEM* studio_system, const char* bus_path,
+                    int type, const int32_t* parameter_indices,
+                    const float* parameter_values, int count) {
+  if (type < 0 || type >= FMOD_FLUTTER_DSP_EFFECT_COUNT) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return 0;
+  }
+
+  FMOD_SYSTEM* core_system = nullptr;
+  last_result_ = FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (last_result_ != FMOD_OK || !RegisterDescriptions(core_system)) {
+    return 0;
+  }
+
+  FMOD_STUDIO_BUS* bus = nullptr;
+  last_result_ = FMOD_Studio_System_GetBus(studio_system, bus_path, &bus);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+
+  int effect_id = next_effect_id_;
+  Effect effect = {bus, nullptr, nullptr, -1};
+  last_result_ = AcquireBusChannelGroup(studio_system, bus, &effect.group);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  last_result_ =
+      FMOD_System_CreateDSPByPlugin(core_system, handles_[type], &effect.dsp);
+  if (last_result_ == FMOD_OK && type == FMOD_FLUTTER_DSP_LOUDNESS_METER) {
+    effect.meter_slot = AcquireLoudnessSlot(effect_id);
+    last_result_ = effect.meter_slot >= 0
+                       ? FMOD_DSP_SetParameterInt(
+                             effect.dsp, FMOD_FLUTTER_LOUDNESS_METER_SLOT,
+                             effect.meter_slot)
+                       : FMOD_ERR_MEMORY;
+  }
+  if (last_result_ != FMOD_OK) {
+    ReleaseEffect(effect);
+    return 0;
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (type == FMOD_FLUTTER_DSP_LOUDNESS_METER &&
+        parameter_indices[i] == FMOD_FLUTTER_LOUDNESS_METER_SLOT) {
+      continue;
+    }
+    FMOD_DSP_PARAMETER_DESC* desc = nullptr;
+    if (FMOD_DSP_GetParameterInfo(effect.dsp, parameter_indices[i], &desc) !=
+        FMOD_OK) {
+      continue;
+    }
+    if (desc->type == FMOD_DSP_PARAMETER_TYPE_INT) {
+      FMOD_DSP_SetParameterInt(effect.dsp, parameter_indices[i],
+                               static_cast<int>(parameter_values[i]));
+    } else {
+      FMOD_DSP_SetParameterFloat(effect.dsp, parameter_indices[i],
+                                 parameter_values[i]);
+    }
+  }
+
+  // The head of the chain is processed last, so each new effect runs after
+  // the fader and any effects added before it.
+  last_result_ =
+      FMOD_ChannelGroup_AddDSP(effect.group, FMOD_CHANNELCONTROL_DSP_HEAD,
+                               effect.dsp);
+  if (last_result_ != FMOD_OK) {
+    ReleaseEffect(effect);
+    return 0;
+  }
+
+  next_effect_id_++;
+  effects_[effect_id] = effect;
+  return effect_id;
+}
+
+bool BusEffects::Remove(int effect_id) {
+  auto it = effects_.find(effect_id);
+  if (it == effects_.end()) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  FMOD_ChannelGroup_RemoveDSP(it->second.group, it->second.dsp);
+  ReleaseEffect(it->second);
+  effects_.erase(it);
+  last_result_ = FMOD_OK;
+  return true;
+}
+
+bool BusEffects::SetParameter(int effect_id, int index, float value) {
+  auto it = effects_.find(effect_id);
+  if (it == effects_.end()) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+
+  if (it->second.meter_slot >= 0 &&
+      index == FMOD_FLUTTER_LOUDNESS_METER_SLOT) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return false;
+  }
+
+  FMOD_DSP_PARAMETER_DESC* desc = nullptr;
+  last_result_ = FMOD_DSP_GetParameterInfo(it->second.dsp, index, &desc);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  if (desc->type == FMOD_DSP_PARAMETER_TYPE_INT) {
+    last_result_ = FMOD_DSP_SetParameterInt(it->second.dsp, index,
+                                            static_cast<int>(value));
+  } else {
+    last_result_ = FMOD_DSP_SetParameterFloat(it->second.dsp, index, value);
+  }
+  return last_result_ == FMOD_OK;
+}
+
+void BusEffects::Clear() {
+  for (auto& pair : effects_) {
+    FMOD_ChannelGroup_RemoveDSP(pair.second.group, pair.second.dsp);
+    ReleaseEffect(pair.second);
+  }
+  effects_.clear();
+  // Plugin handles die with the core system.
+  registered_system_ = nullptr;
+}
+
+void BusEffects::ReleaseEffect(const Effect& effect) {
+  if (effect.dsp != nullptr) {
+    FMOD_DSP_Release(effect.dsp);
+  }
+  ReleaseLoudnessSlot(effect.meter_slot);
+  ReleaseBusChannelGroup(effect.bus);
+}
+
+const char* BusEffects::KernelName() {
+  return GetDspKernels().name;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodBusEffects {
+  fmod_flutter::BusEffects effects;
+};
+
+FmodBusEffects* fmod_bus_effects_create(void) {
+  return new FmodBusEffects();
+}
+
+void fmod_bus_effects_destroy(FmodBusEffects* effects) {
+  delete effects;
+}
+
+int fmod_bus_effects_add(FmodBusEffects* effects,
+                         FMOD_STUDIO_SYSTEM* studio_system,
+                         const char* bus_path, int type,
+                         const int32_t* parameter_indices,
+                         const float* parameter_values, int count) {
+  return effects->effects.Add(studio_system, bus_path, type,
+                              parameter_indices, parameter_values, count);
+}
+
+int fmod_bus_effects_remove(FmodBusEffects* effects, int effect_id) {
+  return effects->effects.Remove(effect_id) ? 1 : 0;
+}
+
+int fmod_bus_effects_set_parameter(FmodBusEffects* effects, int effect_id,
+                                   int index, float value) {
+  return effects->effects.SetParameter(effect_id, index, value) ? 1 : 0;
+}
+
+void fmod_bus_effects_clear(FmodBusEffects* effects) {
+  effects->effects.Clear();
+}
+
+FMOD_RESULT fmod_bus_effects_last_result(FmodBusEffects* effects) {
+  return effects->effects.last_result();
+}
+
+const char* fmod_bus_effects_kernel_name(void) {
+  return fmod_flutter::BusEffects::KernelName();
+}
@@ -0,0 +1,123 @@
+#ifndef FMOD_FLUTTER_DSP_EFFECTS_H_
+#define FMOD_FLUTTER_DSP_EFFECTS_H_
+
+// Built-in DSP effects registered with FMOD via System_RegisterDSP, and the
+// per-bus effect chains the bridges attach them to.
+//
+// The effects run on FMOD's mixer thread using the SIMD kernels from
+// dsp_kernels.h. BusEffects is driven from the bridge's method-call thread.
+
+#include <stdint.h>
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+// Effect types, matching FmodBusEffectType in Dart.
+#define FMOD_FLUTTER_DSP_SOFT_LIMITER 0
+#define FMOD_FLUTTER_DSP_BIQUAD 1
+#define FMOD_FLUTTER_DSP_LOUDNESS_METER 2
+#define FMOD_FLUTTER_DSP_EFFECT_COUNT 3
+
+// Soft limiter parameters.
+#define FMOD_FLUTTER_SOFT_LIMITER_DRIVE 0    // dB, 0 to 24
+#define FMOD_FLUTTER_SOFT_LIMITER_CEILING 1  // dB, -24 to 0
+
+// Biquad parameters.
+#define FMOD_FLUTTER_BIQUAD_TYPE 0       // int, see FMOD_FLUTTER_BIQUAD_*
+#define FMOD_FLUTTER_BIQUAD_FREQUENCY 1  // Hz, 20 to 20000
+#define FMOD_FLUTTER_BIQUAD_Q 2          // 0.1 to 10
+#define FMOD_FLUTTER_BIQUAD_GAIN 3       // dB, -24 to 24 (peaking/shelves)
+
+#define FMOD_FLUTTER_BIQUAD_LOWPASS 0
+#define FMOD_FLUTTER_BIQUAD_HIGHPASS 1
+#define FMOD_FLUTTER_BIQUAD_PEAKING 2
+#define FMOD_FLUTTER_BIQUAD_LOWSHELF 3
+#define FMOD_FLUTTER_BIQUAD_HIGHSHELF 4
+
+// Loudness meter parameters. Readings are published through
+// loudness_meter.h rather than read back as parameters.
+#define FMOD_FLUTTER_LOUDNESS_METER_RESET 0  // int, nonzero restarts metering
+#define FMOD_FLUTTER_LOUDNESS_METER_SLOT 1   // int, assigned by BusEffects
+
+#ifdef __cplusplus
+
+#include <map>
+
+namespace fmod_flutter {
+
+// Locks the bus's channel group, so it exists and keeps any DSPs attached
+// to it, and returns it. Locks are counted per bus so BusEffects and
+// SpectrumAnalyzers can share one; pair every successful call with
+// ReleaseBusChannelGroup. Call from the bridge's method-call thread.
+FMOD_RESULT AcquireBusChannelGroup(FMOD_STUDIO_SYSTEM* studio_system,
+                                   FMOD_STUDIO_BUS* bus,
+                                   FMOD_CHANNELGROUP** group);
+void ReleaseBusChannelGroup(FMOD_STUDIO_BUS* bus);
+
+class BusEffects {
+ public:
+  BusEffects();
+
+  // Creates an effect of the given type, applies count (index, value)
+  // parameter pairs, and appends it to the end of the bus's DSP chain (after
+  // the fader). Returns the effect id, or 0 on failure; see last_result().
+  // A loudness meter publishes under its effect id; see loudness_meter.h.
+  int Add(FMOD_STUDIO_SYSTEM* studio_system, const char* bus_path, int type,
+          const int32_t* parameter_indices, const float* parameter_values,
+          int count);
+  bool Remove(int effect_id);
+  bool SetParameter(int effect_id, int index, float value);
+
+  // Removes every effect. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+  // Name of the kernel set in use ("avx2", "sse2", "neon" or "scalar").
+  static const char* KernelName();
+
+ private:
+  struct Effect {
+    FMOD_STUDIO_BUS* bus;
+    FMOD_CHANNELGROUP* group;
+    FMOD_DSP* dsp;
+    // Shared-memory slot of a loudness meter, otherwise -1.
+    int meter_slot;
+  };
+
+  bool RegisterDescriptions(FMOD_SYSTEM* core_system);
+  void ReleaseEffect(const Effect& effect);
+
+  FMOD_SYSTEM* registered_system_;
+  unsigned int handles_[FMOD_FLUTTER_DSP_EFFECT_COUNT];
+  std::map<int, Effect> effects_;
+  int next_effect_id_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodBusEffects FmodBusEffects;
+
+FmodBusEffects* fmod_bus_effects_create(void);
+void fmod_bus_effects_destroy(FmodBusEffects* effects);
+int fmod_bus_effects_add(FmodBusEffects* effects,
+                         FMOD_STUDIO_SYSTEM* studio_system,
+                         const char* bus_path, int type,
+                         const int32_t* parameter_indices,
+                         const float* parameter_values, int count);
+int fmod_bus_effects_remove(FmodBusEffects* effects, int effect_id);
+int fmod_bus_effects_set_parameter(FmodBusEffects* effects, int effect_id,
+                                   int index, float value);
+void fmod_bus_effects_clear(FmodBusEffects* effects);
+FMOD_RESULT fmod_bus_effects_last_result(FmodBusEffects* effects);
+const char* fmod_bus_effects_kernel_name(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_DSP_EFFECTS_H_
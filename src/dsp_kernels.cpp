@@ -0,0 +1,515 @@
+#include "dsp_kernels.h"
+
+#include <cmath>
+
+// Keep every variant bit-exact with the scalar reference: a contracted
+// multiply-add rounds once instead of twice.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define FMOD_FLUTTER_DSP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// ARMv7 NEON has no IEEE divide, so 32-bit ARM stays on the scalar path.
+#define FMOD_FLUTTER_DSP_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it;
+// MSVC accepts the intrinsics anywhere.
+#if defined(FMOD_FLUTTER_DSP_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FMOD_FLUTTER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FMOD_FLUTTER_TARGET_AVX2
+#endif
+
+namespace fmod_flutter {
+
+// softclip(u) = u * (27 + u^2) / (27 + 9 * u^2) for u clamped to [-3, 3].
+static const float kSoftClipLimit = 3.0f;
+static const float kSoftClipA = 27.0f;
+static const float kSoftClipB = 9.0f;
+
+static inline float SoftClipSample(float x, float gain, float ceiling) {
+  float u = x * gain;
+  u = u < -kSoftClipLimit ? -kSoftClipLimit : u;
+  u = u > kSoftClipLimit ? kSoftClipLimit : u;
+  float u2 = u * u;
+  float numerator = u * (u2 + kSoftClipA);
+  float denominator = u2 * kSoftClipB + kSoftClipA;
+  return ceiling * (numerator / denominator);
+}
+
+static inline void BiquadSample(float x, const BiquadCoefficients& c,
+                                float* out, float* z1, float* z2) {
+  float y = x * c.b0 + *z1;
+  *z1 = (x * c.b1 - y * c.a1) + *z2;
+  *z2 = x * c.b2 - y * c.a2;
+  *out = y;
+}
+
+static void ScalarSoftClip(const float* in, float* out, int count, float gain,
+                           float ceiling) {
+  for (int i = 0; i < count; i++) {
+    out[i] = SoftClipSample(in[i], gain, ceiling);
+  }
+}
+
+static void ScalarBiquadChannels(const float* in, float* out, int frames,
+                                 int channels, int first, int last,
+                                 const BiquadCoefficients& c, float* z1,
+                                 float* z2) {
+  for (int ch = first; ch < last; ch++) {
+    float s1 = z1[ch];
+    float s2 = z2[ch];
+    for (int f = 0; f < frames; f++) {
+      int i = f * channels + ch;
+      BiquadSample(in[i], c, &out[i], &s1, &s2);
+    }
+    z1[ch] = s1;
+    z2[ch] = s2;
+  }
+}
+
+static void ScalarBiquad(const float* in, float* out, int frames, int channels,
+                         const BiquadCoefficients& c, float* z1, float* z2) {
+  ScalarBiquadChannels(in, out, frames, channels, 0, channels, c, z1, z2);
+}
+
+static void ScalarChannelPowerChannels(const float* in, int frames,
+                                       int channels, int first, int last,
+                                       float* sum_squares, float* peaks) {
+  for (int ch = first; ch < last; ch++) {
+    float sum = sum_squares[ch];
+    float peak = peaks[ch];
+    for (int f = 0; f < frames; f++) {
+      float x = in[f * channels + ch];
+      sum = sum + x * x;
+      float magnitude = std::fabs(x);
+      peak = magnitude > peak ? magnitude : peak;
+    }
+    sum_squares[ch] = sum;
+    peaks[ch] = peak;
+  }
+}
+
+static void ScalarChannelPower(const float* in, int frames, int channels,
+                               float* sum_squares, float* peaks) {
+  ScalarChannelPowerChannels(in, frames, channels, 0, channels, sum_squares,
+                             peaks);
+}
+
+static void ScalarTruePeak(const float* in, int frames, int channels,
+                           const float* phase_taps, int tap_count,
+                           float* peaks) {
+  for (int ch = 0; ch < channels; ch++) {
+    float peak = peaks[ch];
+    for (int f = 0; f < frames; f++) {
+      float acc[kTruePeakPhases] = {0.0f, 0.0f, 0.0f, 0.0f};
+      for (int k = 0; k < tap_count; k++) {
+        float x = in[(f - k) * channels + ch];
+        for (int p = 0; p < kTruePeakPhases; p++) {
+          acc[p] = acc[p] + phase_taps[k * kTruePeakPhases + p] * x;
+        }
+      }
+      for (int p = 0; p < kTruePeakPhases; p++) {
+        float magnitude = std::fabs(acc[p]);
+        peak = magnitude > peak ? magnitude : peak;
+      }
+    }
+    peaks[ch] = peak;
+  }
+}
+
+#if defined(FMOD_FLUTTER_DSP_X86)
+
+static void SseSoftClip(const float* in, float* out, int count, float gain,
+                        float ceiling) {
+  const __m128 g = _mm_set1_ps(gain);
+  const __m128 ceil = _mm_set1_ps(ceiling);
+  const __m128 lo = _mm_set1_ps(-kSoftClipLimit);
+  const __m128 hi = _mm_set1_ps(kSoftClipLimit);
+  const __m128 a = _mm_set1_ps(kSoftClipA);
+  const __m128 b = _mm_set1_ps(kSoftClipB);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 u = _mm_mul_ps(_mm_loadu_ps(in + i), g);
+    u = _mm_min_ps(_mm_max_ps(u, lo), hi);
+    __m128 u2 = _mm_mul_ps(u, u);
+    __m128 numerator = _mm_mul_ps(u, _mm_add_ps(u2, a));
+    __m128 denominator = _mm_add_ps(_mm_mul_ps(u2, b), a);
+    _mm_storeu_ps(out + i, _mm_mul_ps(ceil, _mm_div_ps(numerator, denominator)));
+  }
+  for (; i < count; i++) {
+    out[i] = SoftClipSample(in[i], gain, ceiling);
+  }
+}
+
+// Filters channels [first, last) four at a time, one channel per lane.
+static int SseBiquadQuads(const float* in, float* out, int frames,
+                          int channels, int first, int last,
+                          const BiquadCoefficients& c, float* z1, float* z2) {
+  const __m128 b0 = _mm_set1_ps(c.b0);
+  const __m128 b1 = _mm_set1_ps(c.b1);
+  const __m128 b2 = _mm_set1_ps(c.b2);
+  const __m128 a1 = _mm_set1_ps(c.a1);
+  const __m128 a2 = _mm_set1_ps(c.a2);
+
+  int ch = first;
+  for (; ch + 4 <= last; ch += 4) {
+    __m128 s1 = _mm_loadu_ps(z1 + ch);
+    __m128 s2 = _mm_loadu_ps(z2 + ch);
+    for (int f = 0; f < frames; f++) {
+      int i = f * channels + ch;
+      __m128 x = _mm_loadu_ps(in + i);
+      __m128 y = _mm_add_ps(_mm_mul_ps(x, b0), s1);
+      s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, b1), _mm_mul_ps(y, a1)), s2);
+      s2 = _mm_sub_ps(_mm_mul_ps(x, b2), _mm_mul_ps(y, a2));
+      _mm_storeu_ps(out + i, y);
+    }
+    _mm_storeu_ps(z1 + ch, s1);
+    _mm_storeu_ps(z2 + ch, s2);
+  }
+
+  // A stereo pair fits the low half of a register.
+  if (ch + 2 <= last) {
+    __m128 s1 = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<double*>(z1 + ch)));
+    __m128 s2 = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<double*>(z2 + ch)));
+    for (int f = 0; f < frames; f++) {
+      int i = f * channels + ch;
+      __m128 x = _mm_castpd_ps(
+          _mm_load_sd(reinterpret_cast<const double*>(in + i)));
+      __m128 y = _mm_add_ps(_mm_mul_ps(x, b0), s1);
+      s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, b1), _mm_mul_ps(y, a1)), s2);
+      s2 = _mm_sub_ps(_mm_mul_ps(x, b2), _mm_mul_ps(y, a2));
+      _mm_store_sd(reinterpret_cast<double*>(out + i), _mm_castps_pd(y));
+    }
+    _mm_store_sd(reinterpret_cast<double*>(z1 + ch), _mm_castps_pd(s1));
+    _mm_store_sd(reinterpret_cast<double*>(z2 + ch), _mm_castps_pd(s2));
+    ch += 2;
+  }
+  return ch;
+}
+
+static void SseBiquad(const float* in, float* out, int frames, int channels,
+                      const BiquadCoefficients& c, float* z1, float* z2) {
+  int ch = SseBiquadQuads(in, out, frames, channels, 0, channels, c, z1, z2);
+  ScalarBiquadChannels(in, out, frames, channels, ch, channels, c, z1, z2);
+}
+
+static void SseChannelPower(const float* in, int frames, int channels,
+                            float* sum_squares, float* peaks) {
+  const __m128 sign = _mm_set1_ps(-0.0f);
+
+  int ch = 0;
+  for (; ch + 4 <= channels; ch += 4) {
+    __m128 sum = _mm_loadu_ps(sum_squares + ch);
+    __m128 peak = _mm_loadu_ps(peaks + ch);
+    for (int f = 0; f < frames; f++) {
+      __m128 x = _mm_loadu_ps(in + f * channels + ch);
+      sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+      peak = _mm_max_ps(peak, _mm_andnot_ps(sign, x));
+    }
+    _mm_storeu_ps(sum_squares + ch, sum);
+    _mm_storeu_ps(peaks + ch, peak);
+  }
+
+  if (ch + 2 <= channels) {
+    __m128 sum = _mm_castpd_ps(
+        _mm_load_sd(reinterpret_cast<double*>(sum_squares + ch)));
+    __m128 peak =
+        _mm_castpd_ps(_mm_load_sd(reinterpret_cast<double*>(peaks + ch)));
+    for (int f = 0; f < frames; f++) {
+      __m128 x = _mm_castpd_ps(_mm_load_sd(
+          reinterpret_cast<const double*>(in + f * channels + ch)));
+      sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+      peak = _mm_max_ps(peak, _mm_andnot_ps(sign, x));
+    }
+    _mm_store_sd(reinterpret_cast<double*>(sum_squares + ch),
+                 _mm_castps_pd(sum));
+    _mm_store_sd(reinterpret_cast<double*>(peaks + ch), _mm_castps_pd(peak));
+    ch += 2;
+  }
+
+  ScalarChannelPowerChannels(in, frames, channels, ch, channels, sum_squares,
+                             peaks);
+}
+
+// The four polyphase outputs of one frame share a register.
+static void SseTruePeak(const float* in, int frames, int channels,
+                        const float* phase_taps, int tap_count, float* peaks) {
+  const __m128 sign = _mm_set1_ps(-0.0f);
+
+  for (int ch = 0; ch < channels; ch++) {
+    __m128 peak = _mm_setzero_ps();
+    for (int f = 0; f < frames; f++) {
+      __m128 acc = _mm_setzero_ps();
+      for (int k = 0; k < tap_count; k++) {
+        __m128 x = _mm_set1_ps(in[(f - k) * channels + ch]);
+        acc = _mm_add_ps(acc,
+                         _mm_mul_ps(_mm_loadu_ps(phase_taps + k * 4), x));
+      }
+      peak = _mm_max_ps(peak, _mm_andnot_ps(sign, acc));
+    }
+    peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+    peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+    float lane_peak = _mm_cvtss_f32(peak);
+    peaks[ch] = lane_peak > peaks[ch] ? lane_peak : peaks[ch];
+  }
+}
+
+FMOD_FLUTTER_TARGET_AVX2
+static void Avx2SoftClip(const float* in, float* out, int count, float gain,
+                         float ceiling) {
+  const __m256 g = _mm256_set1_ps(gain);
+  const __m256 ceil = _mm256_set1_ps(ceiling);
+  const __m256 lo = _mm256_set1_ps(-kSoftClipLimit);
+  const __m256 hi = _mm256_set1_ps(kSoftClipLimit);
+  const __m256 a = _mm256_set1_ps(kSoftClipA);
+  const __m256 b = _mm256_set1_ps(kSoftClipB);
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 u = _mm256_mul_ps(_mm256_loadu_ps(in + i), g);
+    u = _mm256_min_ps(_mm256_max_ps(u, lo), hi);
+    __m256 u2 = _mm256_mul_ps(u, u);
+    __m256 numerator = _mm256_mul_ps(u, _mm256_add_ps(u2, a));
+    __m256 denominator = _mm256_add_ps(_mm256_mul_ps(u2, b), a);
+    _mm256_storeu_ps(out + i,
+                     _mm256_mul_ps(ceil, _mm256_div_ps(numerator, denominator)));
+  }
+  // Leave the upper AVX state clean before returning to SSE code.
+  _mm256_zeroupper();
+  SseSoftClip(in + i, out + i, count - i, gain, ceiling);
+}
+
+// Eight channels per register only helps 7.1 and wider buses; narrower
+// layouts go straight to the SSE path.
+FMOD_FLUTTER_TARGET_AVX2
+static void Avx2Biquad(const float* in, float* out, int frames, int channels,
+                       const BiquadCoefficients& c, float* z1, float* z2) {
+  const __m256 b0 = _mm256_set1_ps(c.b0);
+  const __m256 b1 = _mm256_set1_ps(c.b1);
+  const __m256 b2 = _mm256_set1_ps(c.b2);
+  const __m256 a1 = _mm256_set1_ps(c.a1);
+  const __m256 a2 = _mm256_set1_ps(c.a2);
+
+  int ch = 0;
+  for (; ch + 8 <= channels; ch += 8) {
+    __m256 s1 = _mm256_loadu_ps(z1 + ch);
+    __m256 s2 = _mm256_loadu_ps(z2 + ch);
+    for (int f = 0; f < frames; f++) {
+      int i = f * channels + ch;
+      __m256 x = _mm256_loadu_ps(in + i);
+      __m256 y = _mm256_add_ps(_mm256_mul_ps(x, b0), s1);
+      s1 = _mm256_add_ps(
+          _mm256_sub_ps(_mm256_mul_ps(x, b1), _mm256_mul_ps(y, a1)), s2);
+      s2 = _mm256_sub_ps(_mm256_mul_ps(x, b2), _mm256_mul_ps(y, a2));
+      _mm256_storeu_ps(out + i, y);
+    }
+    _mm256_storeu_ps(z1 + ch, s1);
+    _mm256_storeu_ps(z2 + ch, s2);
+  }
+  _mm256_zeroupper();
+
+  ch = SseBiquadQuads(in, out, frames, channels, ch, channels, c, z1, z2);
+  ScalarBiquadChannels(in, out, frames, channels, ch, channels, c, z1, z2);
+}
+
+static bool CpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  // OSXSAVE and AVX, then check the OS saves YMM state.
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 ||
+      (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#elif defined(FMOD_FLUTTER_DSP_NEON)
+
+static void NeonSoftClip(const float* in, float* out, int count, float gain,
+                         float ceiling) {
+  const float32x4_t g = vdupq_n_f32(gain);
+  const float32x4_t ceil = vdupq_n_f32(ceiling);
+  const float32x4_t lo = vdupq_n_f32(-kSoftClipLimit);
+  const float32x4_t hi = vdupq_n_f32(kSoftClipLimit);
+  const float32x4_t a = vdupq_n_f32(kSoftClipA);
+  const float32x4_t b = vdupq_n_f32(kSoftClipB);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t u = vmulq_f32(vld1q_f32(in + i), g);
+    u = vminq_f32(vmaxq_f32(u, lo), hi);
+    float32x4_t u2 = vmulq_f32(u, u);
+    // vmulq + vaddq rather than vfmaq to match the scalar rounding.
+    float32x4_t numerator = vmulq_f32(u, vaddq_f32(u2, a));
+    float32x4_t denominator = vaddq_f32(vmulq_f32(u2, b), a);
+    vst1q_f32(out + i, vmulq_f32(ceil, vdivq_f32(numerator, denominator)));
+  }
+  for (; i < count; i++) {
+    out[i] = SoftClipSample(in[i], gain, ceiling);
+  }
+}
+
+static void NeonBiquad(const float* in, float* out, int frames, int channels,
+                       const BiquadCoefficients& c, float* z1, float* z2) {
+  int ch = 0;
+  {
+    const float32x4_t b0 = vdupq_n_f32(c.b0);
+    const float32x4_t b1 = vdupq_n_f32(c.b1);
+    const float32x4_t b2 = vdupq_n_f32(c.b2);
+    const float32x4_t a1 = vdupq_n_f32(c.a1);
+    const float32x4_t a2 = vdupq_n_f32(c.a2);
+    for (; ch + 4 <= channels; ch += 4) {
+      float32x4_t s1 = vld1q_f32(z1 + ch);
+      float32x4_t s2 = vld1q_f32(z2 + ch);
+      for (int f = 0; f < frames; f++) {
+        int i = f * channels + ch;
+        float32x4_t x = vld1q_f32(in + i);
+        float32x4_t y = vaddq_f32(vmulq_f32(x, b0), s1);
+        s1 = vaddq_f32(vsubq_f32(vmulq_f32(x, b1), vmulq_f32(y, a1)), s2);
+        s2 = vsubq_f32(vmulq_f32(x, b2), vmulq_f32(y, a2));
+        vst1q_f32(out + i, y);
+      }
+      vst1q_f32(z1 + ch, s1);
+      vst1q_f32(z2 + ch, s2);
+    }
+  }
+
+  if (ch + 2 <= channels) {
+    const float32x2_t b0 = vdup_n_f32(c.b0);
+    const float32x2_t b1 = vdup_n_f32(c.b1);
+    const float32x2_t b2 = vdup_n_f32(c.b2);
+    const float32x2_t a1 = vdup_n_f32(c.a1);
+    const float32x2_t a2 = vdup_n_f32(c.a2);
+    float32x2_t s1 = vld1_f32(z1 + ch);
+    float32x2_t s2 = vld1_f32(z2 + ch);
+    for (int f = 0; f < frames; f++) {
+      int i = f * channels + ch;
+      float32x2_t x = vld1_f32(in + i);
+      float32x2_t y = vadd_f32(vmul_f32(x, b0), s1);
+      s1 = vadd_f32(vsub_f32(vmul_f32(x, b1), vmul_f32(y, a1)), s2);
+      s2 = vsub_f32(vmul_f32(x, b2), vmul_f32(y, a2));
+      vst1_f32(out + i, y);
+    }
+    vst1_f32(z1 + ch, s1);
+    vst1_f32(z2 + ch, s2);
+    ch += 2;
+  }
+
+  ScalarBiquadChannels(in, out, frames, channels, ch, channels, c, z1, z2);
+}
+
+static void NeonChannelPower(const float* in, int frames, int channels,
+                             float* sum_squares, float* peaks) {
+  int ch = 0;
+  for (; ch + 4 <= channels; ch += 4) {
+    float32x4_t sum = vld1q_f32(sum_squares + ch);
+    float32x4_t peak = vld1q_f32(peaks + ch);
+    for (int f = 0; f < frames; f++) {
+      float32x4_t x = vld1q_f32(in + f * channels + ch);
+      sum = vaddq_f32(sum, vmulq_f32(x, x));
+      peak = vmaxq_f32(peak, vabsq_f32(x));
+    }
+    vst1q_f32(sum_squares + ch, sum);
+    vst1q_f32(peaks + ch, peak);
+  }
+
+  if (ch + 2 <= channels) {
+    float32x2_t sum = vld1_f32(sum_squares + ch);
+    float32x2_t peak = vld1_f32(peaks + ch);
+    for (int f = 0; f < frames; f++) {
+      float32x2_t x = vld1_f32(in + f * channels + ch);
+      sum = vadd_f32(sum, vmul_f32(x, x));
+      peak = vmax_f32(peak, vabs_f32(x));
+    }
+    vst1_f32(sum_squares + ch, sum);
+    vst1_f32(peaks + ch, peak);
+    ch += 2;
+  }
+
+  ScalarChannelPowerChannels(in, frames, channels, ch, channels, sum_squares,
+                             peaks);
+}
+
+// The four polyphase outputs of one frame share a register.
+static void NeonTruePeak(const float* in, int frames, int channels,
+                         const float* phase_taps, int tap_count,
+                         float* peaks) {
+  for (int ch = 0; ch < channels; ch++) {
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    for (int f = 0; f < frames; f++) {
+      float32x4_t acc = vdupq_n_f32(0.0f);
+      for (int k = 0; k < tap_count; k++) {
+        float32x4_t x = vdupq_n_f32(in[(f - k) * channels + ch]);
+        acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(phase_taps + k * 4), x));
+      }
+      peak = vmaxq_f32(peak, vabsq_f32(acc));
+    }
+    float lane_peak = vmaxvq_f32(peak);
+    peaks[ch] = lane_peak > peaks[ch] ? lane_peak : peaks[ch];
+  }
+}
+
+#endif
+
+static const DspKernels kScalarKernels = {"scalar", ScalarSoftClip,
+                                          ScalarBiquad, ScalarChannelPower,
+                                          ScalarTruePeak};
+
+#if defined(FMOD_FLUTTER_DSP_X86)
+static const DspKernels kSseKernels = {"sse2", SseSoftClip, SseBiquad,
+                                       SseChannelPower, SseTruePeak};
+// Reductions stay on SSE: their lanes map to channels or polyphase outputs,
+// which rarely fill eight lanes.
+static const DspKernels kAvx2Kernels = {"avx2", Avx2SoftClip, Avx2Biquad,
+                                        SseChannelPower, SseTruePeak};
+#elif defined(FMOD_FLUTTER_DSP_NEON)
+static const DspKernels kNeonKernels = {"neon", NeonSoftClip, NeonBiquad,
+                                        NeonChannelPower, NeonTruePeak};
+#endif
+
+static const DspKernels& SelectDspKernels() {
+#if defined(FMOD_FLUTTER_DSP_X86)
+  // SSE2 is part of the x86-64 baseline and required by every 32-bit x86
+  // target Flutter supports.
+  return CpuSupportsAvx2() ? kAvx2Kernels : kSseKernels;
+#elif defined(FMOD_FLUTTER_DSP_NEON)
+  return kNeonKernels;
+#else
+  return kScalarKernels;
+#endif
+}
+
+const DspKernels& GetDspKernels() {
+  // Thread-safe one-time initialization.
+  static const DspKernels& kernels = SelectDspKernels();
+  return kernels;
+}
+
+const DspKernels& GetScalarDspKernels() {
+  return kScalarKernels;
+}
+
+}  // namespace fmod_flutter
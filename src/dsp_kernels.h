@@ -0,0 +1,64 @@
+#ifndef FMOD_FLUTTER_DSP_KERNELS_H_
+#define FMOD_FLUTTER_DSP_KERNELS_H_
+
+// Inner loops of the built-in DSP effects, with a scalar reference and
+// SSE2 / AVX2 / NEON variants picked once at runtime.
+//
+// Every variant performs the same IEEE operations in the same order as the
+// scalar reference (no fused multiply-add, no reciprocal estimates), so all
+// of them produce bit-identical output. Buffers are interleaved floats as
+// delivered by FMOD's read callback.
+
+namespace fmod_flutter {
+
+// Transposed direct form II coefficients, normalized so a0 == 1.
+struct BiquadCoefficients {
+  float b0;
+  float b1;
+  float b2;
+  float a1;
+  float a2;
+};
+
+struct DspKernels {
+  const char* name;
+
+  // out = ceiling * softclip(in * gain), where softclip is a rational tanh
+  // approximation that reaches exactly +/-1 at +/-3. gain is
+  // drive / ceiling. in and out may alias.
+  void (*soft_clip)(const float* in, float* out, int count, float gain,
+                    float ceiling);
+
+  // Runs the same biquad over every channel of an interleaved buffer.
+  // z1 and z2 hold one state value per channel. in and out may alias.
+  void (*biquad)(const float* in, float* out, int frames, int channels,
+                 const BiquadCoefficients& coefficients, float* z1,
+                 float* z2);
+
+  // Per-channel power of an interleaved buffer: adds each sample's square
+  // to sum_squares[channel] and raises peaks[channel] to the largest
+  // absolute sample.
+  void (*channel_power)(const float* in, int frames, int channels,
+                        float* sum_squares, float* peaks);
+
+  // Oversampled peak: for every frame and channel, evaluates the
+  // kTruePeakPhases polyphase outputs sum(phase_taps[k][p] * x[n - k]) and
+  // raises peaks[channel] to the largest absolute output. in must be
+  // preceded by tap_count - 1 frames of history.
+  void (*true_peak)(const float* in, int frames, int channels,
+                    const float* phase_taps, int tap_count, float* peaks);
+};
+
+// Oversampling factor of DspKernels::true_peak; phase_taps holds
+// kTruePeakPhases floats per tap.
+static const int kTruePeakPhases = 4;
+
+// The fastest kernels supported by this CPU. Selected on first use.
+const DspKernels& GetDspKernels();
+
+// The portable reference implementation.
+const DspKernels& GetScalarDspKernels();
+
+}  // namespace fmod_flutter
+
+#endif  // FMOD_FLUTTER_DSP_KERNELS_H_
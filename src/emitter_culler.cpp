@@ -0,0 +1,327 @@
+#include "emitter_culler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fmod_flutter {
+
+// Cell coordinates are packed into 21 bits each.
+static const int kCellCoordLimit = (1 << 20) - 1;
+
+// Smallest grid cell; keeps a world of tiny max distances from producing a
+// grid with one emitter per cell.
+static const float kMinCellSize = 1.0f;
+
+// Largest grid cell. A few emitters audible from kilometres away would
+// otherwise put every emitter into a handful of cells; those beyond this go
+// into wide_ instead.
+static const float kMaxCellSize = 200.0f;
+
+static float DistanceSquaredToNearest(float x, float y, float z,
+                                      const float* listener_positions,
+                                      int listener_count) {
+  float nearest = -1.0f;
+  for (int i = 0; i < listener_count; i++) {
+    const float* listener = listener_positions + i * 3;
+    float dx = x - listener[0];
+    float dy = y - listener[1];
+    float dz = z - listener[2];
+    float distance = dx * dx + dy * dy + dz * dz;
+    if (nearest < 0.0f || distance < nearest) {
+      nearest = distance;
+    }
+  }
+  return nearest;
+}
+
+static void EraseId(std::vector<int>* ids, int id) {
+  auto it = std::find(ids->begin(), ids->end(), id);
+  if (it != ids->end()) {
+    *it = ids->back();
+    ids->pop_back();
+  }
+}
+
+EmitterCuller::EmitterCuller()
+    : cell_size_(kMinCellSize), hysteresis_(0.1f) {}
+
+void EmitterCuller::SetHysteresis(float fraction) {
+  hysteresis_ = fraction < 0.0f ? 0.0f : fraction;
+}
+
+void EmitterCuller::Add(int id, float max_distance, bool active) {
+  Remove(id);
+
+  Entry entry = {0.0f, 0.0f, 0.0f, max_distance, 0, false};
+  if (InGrid(entry) && max_distance > cell_size_) {
+    // The grid is sized so every audible emitter in it lies in a listener's
+    // cell or one of its neighbours; grow it when a larger radius appears.
+    Rebuild(max_distance);
+  }
+
+  Entry& stored = entries_[id];
+  stored = entry;
+  Insert(id, &stored);
+  SetActive(id, &stored, active);
+}
+
+void EmitterCuller::Remove(int id) {
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    return;
+  }
+  Unlink(id, it->second);
+  if (it->second.active) {
+    EraseId(&active_, id);
+  }
+  entries_.erase(it);
+}
+
+void EmitterCuller::Move(int id, float x, float y, float z) {
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    return;
+  }
+  Entry& entry = it->second;
+  entry.x = x;
+  entry.y = y;
+  entry.z = z;
+  if (!InGrid(entry)) {
+    return;
+  }
+
+  int64_t cell = CellKey(CellCoord(x), CellCoord(y), CellCoord(z));
+  if (cell != entry.cell) {
+    Unlink(id, entry);
+    Insert(id, &entry);
+  }
+}
+
+void EmitterCuller::Clear() {
+  entries_.clear();
+  cells_.clear();
+  unbounded_.clear();
+  wide_.clear();
+  active_.clear();
+  activated_.clear();
+  deactivated_.clear();
+  cell_size_ = kMinCellSize;
+}
+
+void EmitterCuller::Evaluate(const float* listener_positions,
+                             int listener_count) {
+  activated_.clear();
+  deactivated_.clear();
+
+  // Only active emitters can leave range, so this stays proportional to the
+  // number of audible emitters rather than the number registered.
+  for (size_t i = 0; i < active_.size();) {
+    int id = active_[i];
+    Entry& entry = entries_[id];
+    if (entry.max_distance > 0.0f) {
+      float limit = entry.max_distance * (1.0f + hysteresis_);
+      float distance = DistanceSquaredToNearest(
+          entry.x, entry.y, entry.z, listener_positions, listener_count);
+      if (distance < 0.0f || distance > limit * limit) {
+        entry.active = false;
+        deactivated_.push_back(id);
+        active_[i] = active_.back();
+        active_.pop_back();
+        continue;
+      }
+    }
+    i++;
+  }
+
+  for (size_t i = 0; i < unbounded_.size(); i++) {
+    Entry& entry = entries_[unbounded_[i]];
+    if (!entry.active) {
+      SetActive(unbounded_[i], &entry, true);
+      activated_.push_back(unbounded_[i]);
+    }
+  }
+
+  for (size_t i = 0; i < wide_.size(); i++) {
+    Entry& entry = entries_[wide_[i]];
+    if (entry.active) {
+      continue;
+    }
+    float distance = DistanceSquaredToNearest(
+        entry.x, entry.y, entry.z, listener_positions, listener_count);
+    if (distance >= 0.0f &&
+        distance <= entry.max_distance * entry.max_distance) {
+      SetActive(wide_[i], &entry, true);
+      activated_.push_back(wide_[i]);
+    }
+  }
+
+  for (int l = 0; l < listener_count; l++) {
+    const float* listener = listener_positions + l * 3;
+    int cx = CellCoord(listener[0]);
+    int cy = CellCoord(listener[1]);
+    int cz = CellCoord(listener[2]);
+
+    for (int dx = -1; dx <= 1; dx++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dz = -1; dz <= 1; dz++) {
+          auto cell_it = cells_.find(CellKey(cx + dx, cy + dy, cz + dz));
+          if (cell_it == cells_.end()) {
+            continue;
+          }
+          const std::vector<int>& ids = cell_it->second;
+          for (size_t i = 0; i < ids.size(); i++) {
+            Entry& entry = entries_[ids[i]];
+            if (entry.active) {
+              continue;
+            }
+            float ex = entry.x - listener[0];
+            float ey = entry.y - listener[1];
+            float ez = entry.z - listener[2];
+            float distance = ex * ex + ey * ey + ez * ez;
+            if (distance <= entry.max_distance * entry.max_distance) {
+              SetActive(ids[i], &entry, true);
+              activated_.push_back(ids[i]);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+bool EmitterCuller::InGrid(const Entry& entry) {
+  return entry.max_distance > 0.0f && entry.max_distance <= kMaxCellSize;
+}
+
+int64_t EmitterCuller::CellKey(int cx, int cy, int cz) const {
+  const int64_t mask = 0x1FFFFF;
+  return ((static_cast<int64_t>(cx) & mask) << 42) |
+         ((static_cast<int64_t>(cy) & mask) << 21) |
+         (static_cast<int64_t>(cz) & mask);
+}
+
+int EmitterCuller::CellCoord(float value) const {
+  float coord = std::floor(value / cell_size_);
+  if (coord > kCellCoordLimit) {
+    return kCellCoordLimit;
+  }
+  if (coord < -kCellCoordLimit) {
+    return -kCellCoordLimit;
+  }
+  return static_cast<int>(coord);
+}
+
+void EmitterCuller::Insert(int id, Entry* entry) {
+  if (entry->max_distance <= 0.0f) {
+    unbounded_.push_back(id);
+    return;
+  }
+  if (!InGrid(*entry)) {
+    wide_.push_back(id);
+    return;
+  }
+  entry->cell =
+      CellKey(CellCoord(entry->x), CellCoord(entry->y), CellCoord(entry->z));
+  cells_[entry->cell].push_back(id);
+}
+
+void EmitterCuller::Unlink(int id, const Entry& entry) {
+  if (entry.max_distance <= 0.0f) {
+    EraseId(&unbounded_, id);
+    return;
+  }
+  if (!InGrid(entry)) {
+    EraseId(&wide_, id);
+    return;
+  }
+  auto cell_it = cells_.find(entry.cell);
+  if (cell_it == cells_.end()) {
+    return;
+  }
+  EraseId(&cell_it->second, id);
+  if (cell_it->second.empty()) {
+    cells_.erase(cell_it);
+  }
+}
+
+void EmitterCuller::Rebuild(float cell_size) {
+  cell_size_ = std::max(cell_size, kMinCellSize);
+  cells_.clear();
+  for (auto& pair : entries_) {
+    if (InGrid(pair.second)) {
+      pair.second.cell = CellKey(CellCoord(pair.second.x),
+                                 CellCoord(pair.second.y),
+                                 CellCoord(pair.second.z));
+      cells_[pair.second.cell].push_back(pair.first);
+    }
+  }
+}
+
+void EmitterCuller::SetActive(int id, Entry* entry, bool active) {
+  if (entry->active == active) {
+    return;
+  }
+  entry->active = active;
+  if (active) {
+    active_.push_back(id);
+  } else {
+    EraseId(&active_, id);
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodEmitterCuller {
+  fmod_flutter::EmitterCuller culler;
+};
+
+FmodEmitterCuller* fmod_emitter_culler_create(void) {
+  return new FmodEmitterCuller();
+}
+
+void fmod_emitter_culler_destroy(FmodEmitterCuller* culler) {
+  delete culler;
+}
+
+void fmod_emitter_culler_set_hysteresis(FmodEmitterCuller* culler,
+                                        float fraction) {
+  culler->culler.SetHysteresis(fraction);
+}
+
+void fmod_emitter_culler_add(FmodEmitterCuller* culler, int id,
+                             float max_distance, int active) {
+  culler->culler.Add(id, max_distance, active != 0);
+}
+
+void fmod_emitter_culler_remove(FmodEmitterCuller* culler, int id) {
+  culler->culler.Remove(id);
+}
+
+void fmod_emitter_culler_move(FmodEmitterCuller* culler, int id, float x,
+                              float y, float z) {
+  culler->culler.Move(id, x, y, z);
+}
+
+void fmod_emitter_culler_clear(FmodEmitterCuller* culler) {
+  culler->culler.Clear();
+}
+
+void fmod_emitter_culler_evaluate(FmodEmitterCuller* culler,
+                                  const float* listener_positions,
+                                  int listener_count) {
+  culler->culler.Evaluate(listener_positions, listener_count);
+}
+
+const int* fmod_emitter_culler_activated(FmodEmitterCuller* culler,
+                                         int* count) {
+  const std::vector<int>& ids = culler->culler.activated();
+  *count = static_cast<int>(ids.size());
+  return ids.empty() ? nullptr : ids.data();
+}
+
+const int* fmod_emitter_culler_deactivated(FmodEmitterCuller* culler,
+                                           int* count) {
+  const std::vector<int>& ids = culler->culler.deactivated();
+  *count = static_cast<int>(ids.size());
+  return ids.empty() ? nullptr : ids.data();
+}
@@ -0,0 +1,109 @@
+#ifndef FMOD_FLUTTER_EMITTER_CULLER_H_
+#define FMOD_FLUTTER_EMITTER_CULLER_H_
+
+// Distance culling for 3D emitters, shared by all native bridges.
+//
+// Emitters are kept in a uniform grid keyed by position, sized to the largest
+// max distance up to a cap; emitters audible farther than the cap are kept
+// in a list and checked against every listener. Each update tick
+// Evaluate() reports which emitters came within their max distance of a
+// listener (start an instance) and which left it by more than the
+// hysteresis margin (stop and release the instance). The culler only tracks
+// ids and positions; the bridges own the FMOD instances.
+
+#ifdef __cplusplus
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace fmod_flutter {
+
+class EmitterCuller {
+ public:
+  EmitterCuller();
+
+  // Fraction of max distance an active emitter may drift past before it is
+  // culled, so emitters near the edge do not restart every tick.
+  void SetHysteresis(float fraction);
+  float hysteresis() const { return hysteresis_; }
+
+  // Registers an emitter. A max_distance <= 0 means the event is not
+  // attenuated by distance and the emitter is never culled.
+  void Add(int id, float max_distance, bool active);
+  void Remove(int id);
+  void Move(int id, float x, float y, float z);
+  void Clear();
+
+  // listener_positions holds listener_count xyz triples. Results stay valid
+  // until the next call.
+  void Evaluate(const float* listener_positions, int listener_count);
+  const std::vector<int>& activated() const { return activated_; }
+  const std::vector<int>& deactivated() const { return deactivated_; }
+
+  int active_count() const { return static_cast<int>(active_.size()); }
+  int emitter_count() const { return static_cast<int>(entries_.size()); }
+  float cell_size() const { return cell_size_; }
+
+ private:
+  struct Entry {
+    float x;
+    float y;
+    float z;
+    float max_distance;
+    int64_t cell;
+    bool active;
+  };
+
+  static bool InGrid(const Entry& entry);
+  int64_t CellKey(int cx, int cy, int cz) const;
+  int CellCoord(float value) const;
+  void Insert(int id, Entry* entry);
+  void Unlink(int id, const Entry& entry);
+  void Rebuild(float cell_size);
+  void SetActive(int id, Entry* entry, bool active);
+
+  std::unordered_map<int, Entry> entries_;
+  std::unordered_map<int64_t, std::vector<int>> cells_;
+  // Emitters that are never culled (max distance <= 0).
+  std::vector<int> unbounded_;
+  // Emitters whose max distance exceeds the largest grid cell.
+  std::vector<int> wide_;
+  std::vector<int> active_;
+  std::vector<int> activated_;
+  std::vector<int> deactivated_;
+  float cell_size_;
+  float hysteresis_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodEmitterCuller FmodEmitterCuller;
+
+FmodEmitterCuller* fmod_emitter_culler_create(void);
+void fmod_emitter_culler_destroy(FmodEmitterCuller* culler);
+void fmod_emitter_culler_set_hysteresis(FmodEmitterCuller* culler,
+                                        float fraction);
+void fmod_emitter_culler_add(FmodEmitterCuller* culler, int id,
+                             float max_distance, int active);
+void fmod_emitter_culler_remove(FmodEmitterCuller* culler, int id);
+void fmod_emitter_culler_move(FmodEmitterCuller* culler, int id, float x,
+                              float y, float z);
+void fmod_emitter_culler_clear(FmodEmitterCuller* culler);
+void fmod_emitter_culler_evaluate(FmodEmitterCuller* culler,
+                                  const float* listener_positions,
+                                  int listener_count);
+const int* fmod_emitter_culler_activated(FmodEmitterCuller* culler,
+                                         int* count);
+const int* fmod_emitter_culler_deactivated(FmodEmitterCuller* culler,
+                                           int* count);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_EMITTER_CULLER_H_
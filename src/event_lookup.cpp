@@ -0,0 +1,117 @@
+#include "event_lookup.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace fmod_flutter {
+
+static const int kMaxPathLength = 512;
+
+static int HexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// Reads digits hex digits at text into value; false on a non-digit.
+static bool ReadHex(const char* text, int digits, uint32_t* value) {
+  *value = 0;
+  for (int i = 0; i < digits; i++) {
+    int digit = HexDigit(text[i]);
+    if (digit < 0) {
+      return false;
+    }
+    *value = (*value << 4) | static_cast<uint32_t>(digit);
+  }
+  return true;
+}
+
+std::string EventIdKey(const uint8_t* id_bytes) {
+  // FMOD_GUID is stored little-endian on every platform FMOD supports.
+  FMOD_GUID id;
+  std::memcpy(&id, id_bytes, sizeof(id));
+  return EventIdKey(id);
+}
+
+std::string EventIdKey(const FMOD_GUID& id) {
+  char key[FMOD_FLUTTER_EVENT_ID_KEY_LENGTH];
+  std::snprintf(key, sizeof(key),
+                "{%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x}",
+                id.Data1, id.Data2, id.Data3, id.Data4[0], id.Data4[1],
+                id.Data4[2], id.Data4[3], id.Data4[4], id.Data4[5],
+                id.Data4[6], id.Data4[7]);
+  return key;
+}
+
+bool ParseEventIdKey(const char* key, FMOD_GUID* id) {
+  if (key[0] != '{' ||
+      std::strlen(key) != FMOD_FLUTTER_EVENT_ID_KEY_LENGTH - 1 ||
+      key[9] != '-' || key[14] != '-' || key[19] != '-' || key[24] != '-' ||
+      key[37] != '}') {
+    return false;
+  }
+  uint32_t data1 = 0;
+  uint32_t data2 = 0;
+  uint32_t data3 = 0;
+  if (!ReadHex(key + 1, 8, &data1) || !ReadHex(key + 10, 4, &data2) ||
+      !ReadHex(key + 15, 4, &data3)) {
+    return false;
+  }
+  // Data4 is written as 2 bytes, a dash, then the other 6.
+  static const int kData4Offsets[8] = {20, 22, 25, 27, 29, 31, 33, 35};
+  unsigned char data4[8];
+  for (int i = 0; i < 8; i++) {
+    uint32_t byte = 0;
+    if (!ReadHex(key + kData4Offsets[i], 2, &byte)) {
+      return false;
+    }
+    data4[i] = static_cast<unsigned char>(byte);
+  }
+  id->Data1 = data1;
+  id->Data2 = static_cast<unsigned short>(data2);
+  id->Data3 = static_cast<unsigned short>(data3);
+  std::memcpy(id->Data4, data4, sizeof(data4));
+  return true;
+}
+
+FMOD_RESULT GetEvent(FMOD_STUDIO_SYSTEM* studio_system, const char* key,
+                     FMOD_STUDIO_EVENTDESCRIPTION** description) {
+  FMOD_GUID id;
+  if (ParseEventIdKey(key, &id)) {
+    return FMOD_Studio_System_GetEventByID(studio_system, &id, description);
+  }
+  return FMOD_Studio_System_GetEvent(studio_system, key, description);
+}
+
+std::string EventKey(FMOD_STUDIO_EVENTDESCRIPTION* description) {
+  char path[kMaxPathLength];
+  if (FMOD_Studio_EventDescription_GetPath(description, path, kMaxPathLength,
+                                           nullptr) == FMOD_OK) {
+    return path;
+  }
+  FMOD_GUID id;
+  if (FMOD_Studio_EventDescription_GetID(description, &id) != FMOD_OK) {
+    return std::string();
+  }
+  return EventIdKey(id);
+}
+
+}  // namespace fmod_flutter
+
+void fmod_event_id_key(const uint8_t* id_bytes,
+                       char key[FMOD_FLUTTER_EVENT_ID_KEY_LENGTH]) {
+  std::string text = fmod_flutter::EventIdKey(id_bytes);
+  std::memcpy(key, text.c_str(), FMOD_FLUTTER_EVENT_ID_KEY_LENGTH);
+}
+
+FMOD_RESULT fmod_get_event(FMOD_STUDIO_SYSTEM* studio_system, const char* key,
+                           FMOD_STUDIO_EVENTDESCRIPTION** description) {
+  return fmod_flutter::GetEvent(studio_system, key, description);
+}
@@ -0,0 +1,58 @@
+#ifndef FMOD_FLUTTER_EVENT_LOOKUP_H_
+#define FMOD_FLUTTER_EVENT_LOOKUP_H_
+
+// Event lookup shared by all native bridges.
+//
+// The bridges name an event by a key: its path, or its ID in FMOD's braced
+// text form, {xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx}. GetEvent() sends IDs
+// straight to Studio::System::getEventByID, skipping the path hash and the
+// strings bank it needs, so an app that names events only by ID does not
+// have to load Master.strings.bank. Dart sends an ID as the 16 bytes of an
+// FMOD_GUID; the bridges turn it into its text form and use that as the
+// key, so every table keyed by event path holds ID-started instances too.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+// Characters in an ID key, including the terminating null.
+#define FMOD_FLUTTER_EVENT_ID_KEY_LENGTH 39
+
+#ifdef __cplusplus
+
+#include <string>
+
+namespace fmod_flutter {
+
+// The key for an ID given as the 16 bytes of an FMOD_GUID.
+std::string EventIdKey(const uint8_t* id_bytes);
+std::string EventIdKey(const FMOD_GUID& id);
+
+// True if key is an ID key, which is then stored in id. Either case of hex
+// digit is accepted.
+bool ParseEventIdKey(const char* key, FMOD_GUID* id);
+
+// Studio::System::getEventByID for ID keys, getEvent for paths.
+FMOD_RESULT GetEvent(FMOD_STUDIO_SYSTEM* studio_system, const char* key,
+                     FMOD_STUDIO_EVENTDESCRIPTION** description);
+
+// The path of an event, or its ID key when no strings bank is loaded;
+// empty if the description is invalid.
+std::string EventKey(FMOD_STUDIO_EVENTDESCRIPTION* description);
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+void fmod_event_id_key(const uint8_t* id_bytes,
+                       char key[FMOD_FLUTTER_EVENT_ID_KEY_LENGTH]);
+FMOD_RESULT fmod_get_event(FMOD_STUDIO_SYSTEM* studio_system, const char* key,
+                           FMOD_STUDIO_EVENTDESCRIPTION** description);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_EVENT_LOOKUP_H_
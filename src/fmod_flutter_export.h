@@ -0,0 +1,15 @@
+#ifndef FMOD_FLUTTER_EXPORT_H_
+#define FMOD_FLUTTER_EXPORT_H_
+
+// Marks C functions that Dart looks up by name through dart:ffi. Windows
+// DLLs and Apple frameworks hide symbols that are not exported explicitly,
+// and nothing native references these, so they must also survive dead
+// stripping.
+#if defined(_WIN32)
+#define FMOD_FLUTTER_EXPORT __declspec(dllexport)
+#else
+#define FMOD_FLUTTER_EXPORT \
+  __attribute__((visibility("default"))) __attribute__((used))
+#endif
+
+#endif  // FMOD_FLUTTER_EXPORT_H_
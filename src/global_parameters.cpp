@@ -0,0 +1,169 @@
+#include "global_parameters.h"
+
+namespace fmod_flutter {
+
+GlobalParameters::GlobalParameters() : last_result_(FMOD_OK) {}
+
+void GlobalParameters::CacheBanks(FMOD_STUDIO_SYSTEM* studio_system) {
+  int count = 0;
+  if (FMOD_Studio_System_GetParameterDescriptionCount(studio_system,
+                                                      &count) != FMOD_OK ||
+      count <= 0) {
+    return;
+  }
+  std::vector<FMOD_STUDIO_PARAMETER_DESCRIPTION> descriptions(count);
+  if (FMOD_Studio_System_GetParameterDescriptionList(
+          studio_system, descriptions.data(), count, &count) != FMOD_OK) {
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    const FMOD_STUDIO_PARAMETER_DESCRIPTION& description = descriptions[i];
+    if ((description.flags & FMOD_STUDIO_PARAMETER_GLOBAL) != 0 &&
+        description.name != nullptr) {
+      AddSlot(description.name, description.id);
+    }
+  }
+}
+
+int GlobalParameters::Resolve(FMOD_STUDIO_SYSTEM* studio_system,
+                              const char* name) {
+  auto it = slots_.find(name);
+  if (it != slots_.end()) {
+    last_result_ = FMOD_OK;
+    return it->second;
+  }
+  FMOD_STUDIO_PARAMETER_DESCRIPTION description;
+  last_result_ = FMOD_Studio_System_GetParameterDescriptionByName(
+      studio_system, name, &description);
+  if (last_result_ != FMOD_OK) {
+    return -1;
+  }
+  return AddSlot(name, description.id);
+}
+
+bool GlobalParameters::Set(FMOD_STUDIO_SYSTEM* studio_system,
+                           const char* name, float value) {
+  int slot = Resolve(studio_system, name);
+  if (slot < 0) {
+    return false;
+  }
+  last_result_ =
+      FMOD_Studio_System_SetParameterByID(studio_system, ids_[slot], value, 0);
+  return last_result_ == FMOD_OK;
+}
+
+bool GlobalParameters::Get(FMOD_STUDIO_SYSTEM* studio_system,
+                           const char* name, float* value) {
+  int slot = Resolve(studio_system, name);
+  if (slot < 0) {
+    return false;
+  }
+  last_result_ = FMOD_Studio_System_GetParameterByID(studio_system,
+                                                     ids_[slot], value,
+                                                     nullptr);
+  return last_result_ == FMOD_OK;
+}
+
+bool GlobalParameters::SetBatch(FMOD_STUDIO_SYSTEM* studio_system,
+                                const int32_t* slots, const float* values,
+                                int count) {
+  batch_ids_.clear();
+  batch_values_.clear();
+  bool all_known = true;
+  for (int i = 0; i < count; i++) {
+    if (slots[i] < 0) {
+      continue;  // unresolved name, already reported by Resolve()
+    }
+    if (slots[i] >= static_cast<int32_t>(ids_.size())) {
+      all_known = false;
+      continue;
+    }
+    batch_ids_.push_back(ids_[slots[i]]);
+    batch_values_.push_back(values[i]);
+  }
+
+  last_result_ = all_known ? FMOD_OK : FMOD_ERR_INVALID_PARAM;
+  if (!batch_ids_.empty()) {
+    FMOD_RESULT result = FMOD_Studio_System_SetParametersByIDs(
+        studio_system, batch_ids_.data(), batch_values_.data(),
+        static_cast<int>(batch_ids_.size()), 0);
+    if (result != FMOD_OK) {
+      last_result_ = result;
+    }
+  }
+  return last_result_ == FMOD_OK;
+}
+
+void GlobalParameters::Clear() {
+  slots_.clear();
+  ids_.clear();
+}
+
+int GlobalParameters::AddSlot(const std::string& name,
+                              const FMOD_STUDIO_PARAMETER_ID& id) {
+  auto it = slots_.find(name);
+  if (it != slots_.end()) {
+    // A reloaded bank keeps the parameter's ID; refresh it anyway.
+    ids_[it->second] = id;
+    return it->second;
+  }
+  int slot = static_cast<int>(ids_.size());
+  ids_.push_back(id);
+  slots_[name] = slot;
+  return slot;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodGlobalParameters {
+  fmod_flutter::GlobalParameters parameters;
+};
+
+FmodGlobalParameters* fmod_global_parameters_create(void) {
+  return new FmodGlobalParameters();
+}
+
+void fmod_global_parameters_destroy(FmodGlobalParameters* parameters) {
+  delete parameters;
+}
+
+void fmod_global_parameters_cache_banks(FmodGlobalParameters* parameters,
+                                        FMOD_STUDIO_SYSTEM* studio_system) {
+  parameters->parameters.CacheBanks(studio_system);
+}
+
+int fmod_global_parameters_resolve(FmodGlobalParameters* parameters,
+                                   FMOD_STUDIO_SYSTEM* studio_system,
+                                   const char* name) {
+  return parameters->parameters.Resolve(studio_system, name);
+}
+
+int fmod_global_parameters_set(FmodGlobalParameters* parameters,
+                               FMOD_STUDIO_SYSTEM* studio_system,
+                               const char* name, float value) {
+  return parameters->parameters.Set(studio_system, name, value) ? 1 : 0;
+}
+
+int fmod_global_parameters_get(FmodGlobalParameters* parameters,
+                               FMOD_STUDIO_SYSTEM* studio_system,
+                               const char* name, float* value) {
+  return parameters->parameters.Get(studio_system, name, value) ? 1 : 0;
+}
+
+int fmod_global_parameters_set_batch(FmodGlobalParameters* parameters,
+                                     FMOD_STUDIO_SYSTEM* studio_system,
+                                     const int32_t* slots, const float* values,
+                                     int count) {
+  return parameters->parameters.SetBatch(studio_system, slots, values, count)
+             ? 1
+             : 0;
+}
+
+void fmod_global_parameters_clear(FmodGlobalParameters* parameters) {
+  parameters->parameters.Clear();
+}
+
+FMOD_RESULT fmod_global_parameters_last_result(
+    FmodGlobalParameters* parameters) {
+  return parameters->parameters.last_result();
+}
@@ -0,0 +1,96 @@
+#ifndef FMOD_FLUTTER_GLOBAL_PARAMETERS_H_
+#define FMOD_FLUTTER_GLOBAL_PARAMETERS_H_
+
+// Global (system-level) parameters shared by all native bridges.
+//
+// Parameter IDs are resolved by name whenever banks are loaded and kept in
+// an append-only slot table. Dart resolves the names it drives once, then
+// writes any number of globals per frame as parallel slot and value arrays,
+// which become a single SetParametersByIDs call.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class GlobalParameters {
+ public:
+  GlobalParameters();
+
+  // Resolves the ID of every global parameter known to the Studio system.
+  // Call after each bank load.
+  void CacheBanks(FMOD_STUDIO_SYSTEM* studio_system);
+
+  // Returns the slot of a global parameter for SetBatch(), resolving and
+  // caching it if needed, or -1 if there is no such global parameter.
+  // Slots stay valid until Clear().
+  int Resolve(FMOD_STUDIO_SYSTEM* studio_system, const char* name);
+
+  bool Set(FMOD_STUDIO_SYSTEM* studio_system, const char* name, float value);
+  bool Get(FMOD_STUDIO_SYSTEM* studio_system, const char* name, float* value);
+
+  // Sets values[i] on slots[i] with one SetParametersByIDs call. Slots of
+  // -1 (unresolved names) are skipped; other unknown slots are skipped and
+  // make the call return false.
+  bool SetBatch(FMOD_STUDIO_SYSTEM* studio_system, const int32_t* slots,
+                const float* values, int count);
+
+  // Forgets every slot. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  int AddSlot(const std::string& name, const FMOD_STUDIO_PARAMETER_ID& id);
+
+  std::unordered_map<std::string, int> slots_;
+  std::vector<FMOD_STUDIO_PARAMETER_ID> ids_;
+  // Scratch arrays for SetBatch(), kept to avoid per-frame allocation.
+  std::vector<FMOD_STUDIO_PARAMETER_ID> batch_ids_;
+  std::vector<float> batch_values_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodGlobalParameters FmodGlobalParameters;
+
+FmodGlobalParameters* fmod_global_parameters_create(void);
+void fmod_global_parameters_destroy(FmodGlobalParameters* parameters);
+void fmod_global_parameters_cache_banks(FmodGlobalParameters* parameters,
+                                        FMOD_STUDIO_SYSTEM* studio_system);
+int fmod_global_parameters_resolve(FmodGlobalParameters* parameters,
+                                   FMOD_STUDIO_SYSTEM* studio_system,
+                                   const char* name);
+int fmod_global_parameters_set(FmodGlobalParameters* parameters,
+                               FMOD_STUDIO_SYSTEM* studio_system,
+                               const char* name, float value);
+int fmod_global_parameters_get(FmodGlobalParameters* parameters,
+                               FMOD_STUDIO_SYSTEM* studio_system,
+                               const char* name, float* value);
+int fmod_global_parameters_set_batch(FmodGlobalParameters* parameters,
+                                     FMOD_STUDIO_SYSTEM* studio_system,
+                                     const int32_t* slots, const float* values,
+                                     int count);
+void fmod_global_parameters_clear(FmodGlobalParameters* parameters);
+FMOD_RESULT fmod_global_parameters_last_result(
+    FmodGlobalParameters* parameters);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_GLOBAL_PARAMETERS_H_
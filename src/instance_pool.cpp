@@ -0,0 +1,193 @@
+#include "instance_pool.h"
+
+#include <utility>
+
+#include "event_lookup.h"
+
+namespace fmod_flutter {
+
+InstancePool::InstancePool() : last_result_(FMOD_OK) {}
+
+bool InstancePool::Configure(FMOD_STUDIO_SYSTEM* studio_system,
+                             const char* event_path, int prewarm_count,
+                             int capacity) {
+  auto it = pools_.find(event_path);
+  if (capacity <= 0) {
+    if (it != pools_.end()) {
+      Trim(&it->second, 0);
+      FMOD_Studio_EventDescription_UnloadSampleData(it->second.description);
+      pools_.erase(it);
+    }
+    last_result_ = FMOD_OK;
+    return true;
+  }
+
+  if (it == pools_.end()) {
+    FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+    last_result_ = GetEvent(studio_system, event_path, &description);
+    if (last_result_ != FMOD_OK) {
+      return false;
+    }
+    // Sample data stays loaded for as long as the pool exists.
+    FMOD_Studio_EventDescription_LoadSampleData(description);
+    Pool pool = {description, std::vector<FMOD_STUDIO_EVENTINSTANCE*>(), 0, 0,
+                 0};
+    it = pools_.insert(std::make_pair(std::string(event_path), pool)).first;
+  }
+
+  Pool& pool = it->second;
+  pool.capacity = capacity;
+  Trim(&pool, capacity);
+
+  if (prewarm_count > capacity) {
+    prewarm_count = capacity;
+  }
+  last_result_ = FMOD_OK;
+  while (static_cast<int>(pool.idle.size()) < prewarm_count) {
+    FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
+    last_result_ = FMOD_Studio_EventDescription_CreateInstance(pool.description,
+                                                               &instance);
+    if (last_result_ != FMOD_OK) {
+      return false;
+    }
+    pool.idle.push_back(instance);
+  }
+  return true;
+}
+
+FMOD_STUDIO_EVENTINSTANCE* InstancePool::Acquire(
+    FMOD_STUDIO_SYSTEM* studio_system, const char* event_path) {
+  auto it = pools_.find(event_path);
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  if (it != pools_.end()) {
+    Pool& pool = it->second;
+    // Newest first; an instance may still be fading out from its last stop.
+    for (size_t i = pool.idle.size(); i-- > 0;) {
+      FMOD_STUDIO_EVENTINSTANCE* instance = pool.idle[i];
+      FMOD_STUDIO_PLAYBACK_STATE state = FMOD_STUDIO_PLAYBACK_STOPPED;
+      if (FMOD_Studio_EventInstance_GetPlaybackState(instance, &state) !=
+          FMOD_OK) {
+        // Invalidated, e.g. by a bank unload.
+        pool.idle.erase(pool.idle.begin() + i);
+        continue;
+      }
+      if (state != FMOD_STUDIO_PLAYBACK_STOPPED) {
+        continue;
+      }
+      pool.idle.erase(pool.idle.begin() + i);
+      FMOD_Studio_EventInstance_SetPaused(instance, 0);
+      FMOD_Studio_EventInstance_SetVolume(instance, 1.0f);
+      FMOD_Studio_EventInstance_SetPitch(instance, 1.0f);
+      pool.hits++;
+      last_result_ = FMOD_OK;
+      return instance;
+    }
+    pool.misses++;
+    description = pool.description;
+  } else {
+    last_result_ = GetEvent(studio_system, event_path, &description);
+    if (last_result_ != FMOD_OK) {
+      return nullptr;
+    }
+  }
+
+  FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
+  last_result_ =
+      FMOD_Studio_EventDescription_CreateInstance(description, &instance);
+  return last_result_ == FMOD_OK ? instance : nullptr;
+}
+
+void InstancePool::Recycle(const char* event_path,
+                           FMOD_STUDIO_EVENTINSTANCE* instance) {
+  auto it = pools_.find(event_path);
+  if (it != pools_.end() &&
+      static_cast<int>(it->second.idle.size()) < it->second.capacity) {
+    it->second.idle.push_back(instance);
+    return;
+  }
+  FMOD_Studio_EventInstance_Release(instance);
+}
+
+bool InstancePool::GetStats(const char* event_path,
+                            FmodInstancePoolStats* stats) const {
+  stats->idle_count = 0;
+  stats->capacity = 0;
+  stats->hits = 0;
+  stats->misses = 0;
+  for (const auto& pair : pools_) {
+    if (event_path != nullptr && pair.first != event_path) {
+      continue;
+    }
+    stats->idle_count += static_cast<int32_t>(pair.second.idle.size());
+    stats->capacity += pair.second.capacity;
+    stats->hits += pair.second.hits;
+    stats->misses += pair.second.misses;
+    if (event_path != nullptr) {
+      return true;
+    }
+  }
+  return event_path == nullptr;
+}
+
+void InstancePool::Clear() {
+  for (auto& pair : pools_) {
+    Trim(&pair.second, 0);
+  }
+  pools_.clear();
+}
+
+void InstancePool::Trim(Pool* pool, int capacity) {
+  while (static_cast<int>(pool->idle.size()) > capacity) {
+    FMOD_Studio_EventInstance_Release(pool->idle.back());
+    pool->idle.pop_back();
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodInstancePool {
+  fmod_flutter::InstancePool pool;
+};
+
+FmodInstancePool* fmod_instance_pool_create(void) {
+  return new FmodInstancePool();
+}
+
+void fmod_instance_pool_destroy(FmodInstancePool* pool) {
+  delete pool;
+}
+
+int fmod_instance_pool_configure(FmodInstancePool* pool,
+                                 FMOD_STUDIO_SYSTEM* studio_system,
+                                 const char* event_path, int prewarm_count,
+                                 int capacity) {
+  return pool->pool.Configure(studio_system, event_path, prewarm_count,
+                              capacity)
+             ? 1
+             : 0;
+}
+
+FMOD_STUDIO_EVENTINSTANCE* fmod_instance_pool_acquire(
+    FmodInstancePool* pool, FMOD_STUDIO_SYSTEM* studio_system,
+    const char* event_path) {
+  return pool->pool.Acquire(studio_system, event_path);
+}
+
+void fmod_instance_pool_recycle(FmodInstancePool* pool, const char* event_path,
+                                FMOD_STUDIO_EVENTINSTANCE* instance) {
+  pool->pool.Recycle(event_path, instance);
+}
+
+int fmod_instance_pool_get_stats(FmodInstancePool* pool,
+                                 const char* event_path,
+                                 FmodInstancePoolStats* stats) {
+  return pool->pool.GetStats(event_path, stats) ? 1 : 0;
+}
+
+void fmod_instance_pool_clear(FmodInstancePool* pool) {
+  pool->pool.Clear();
+}
+
+FMOD_RESULT fmod_instance_pool_last_result(FmodInstancePool* pool) {
+  return pool->pool.last_result();
+}
@@ -0,0 +1,112 @@
+#ifndef FMOD_FLUTTER_INSTANCE_POOL_H_
+#define FMOD_FLUTTER_INSTANCE_POOL_H_
+
+// Event instance pooling shared by all native bridges.
+//
+// Events with a pool keep a number of created, stopped instances ready, so
+// playing them skips EventDescription::createInstance and the sample data
+// load. Stopped instances go back to their pool instead of being released;
+// they are only released when the pool shrinks or is cleared. Events
+// without a pool are created and released on every play as before.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+// Per-event pool statistics.
+typedef struct FmodInstancePoolStats {
+  int32_t idle_count;  // stopped instances ready to play
+  int32_t capacity;    // most idle instances kept
+  int64_t hits;        // plays served from the pool
+  int64_t misses;      // plays that had to create an instance
+} FmodInstancePoolStats;
+
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class InstancePool {
+ public:
+  InstancePool();
+
+  // Creates a pool for an event, or resizes an existing one, keeping up to
+  // capacity idle instances and creating prewarm_count of them now. Loads
+  // the event's sample data so the first play does not wait on it. A
+  // capacity of 0 removes the pool and releases its idle instances.
+  bool Configure(FMOD_STUDIO_SYSTEM* studio_system, const char* event_path,
+                 int prewarm_count, int capacity);
+
+  // Returns a stopped instance of the event, reused from its pool when one
+  // has finished stopping or created otherwise. Reused instances are
+  // unpaused with volume and pitch reset; parameters keep their last
+  // values. Returns nullptr on failure; see last_result().
+  FMOD_STUDIO_EVENTINSTANCE* Acquire(FMOD_STUDIO_SYSTEM* studio_system,
+                                     const char* event_path);
+
+  // Takes back an instance from Acquire() once it has been stopped. It
+  // joins its pool while there is room and is released otherwise. An
+  // instance that is still fading out stays idle but is only reused once
+  // stopped.
+  void Recycle(const char* event_path, FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  // Statistics for one event, or summed over every pool when event_path
+  // is null. Returns false for an event without a pool.
+  bool GetStats(const char* event_path, FmodInstancePoolStats* stats) const;
+
+  // Releases every idle instance and removes every pool. Call before
+  // releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  struct Pool {
+    FMOD_STUDIO_EVENTDESCRIPTION* description;
+    std::vector<FMOD_STUDIO_EVENTINSTANCE*> idle;
+    int capacity;
+    int64_t hits;
+    int64_t misses;
+  };
+
+  void Trim(Pool* pool, int capacity);
+
+  std::unordered_map<std::string, Pool> pools_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodInstancePool FmodInstancePool;
+
+FmodInstancePool* fmod_instance_pool_create(void);
+void fmod_instance_pool_destroy(FmodInstancePool* pool);
+int fmod_instance_pool_configure(FmodInstancePool* pool,
+                                 FMOD_STUDIO_SYSTEM* studio_system,
+                                 const char* event_path, int prewarm_count,
+                                 int capacity);
+FMOD_STUDIO_EVENTINSTANCE* fmod_instance_pool_acquire(
+    FmodInstancePool* pool, FMOD_STUDIO_SYSTEM* studio_system,
+    const char* event_path);
+void fmod_instance_pool_recycle(FmodInstancePool* pool, const char* event_path,
+                                FMOD_STUDIO_EVENTINSTANCE* instance);
+int fmod_instance_pool_get_stats(FmodInstancePool* pool,
+                                 const char* event_path,
+                                 FmodInstancePoolStats* stats);
+void fmod_instance_pool_clear(FmodInstancePool* pool);
+FMOD_RESULT fmod_instance_pool_last_result(FmodInstancePool* pool);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_INSTANCE_POOL_H_
@@ -0,0 +1,125 @@
+#include "instance_states.h"
+
+#include <cstring>
+
+#include "event_lookup.h"
+
+static_assert(sizeof(FmodInstanceState) == FMOD_FLUTTER_INSTANCE_STATE_SIZE,
+              "FmodInstanceState is sent to Dart as raw bytes");
+
+namespace fmod_flutter {
+
+InstanceStates::InstanceStates() {}
+
+void InstanceStates::Begin() { states_.clear(); }
+
+void InstanceStates::Add(const char* key,
+                         FMOD_STUDIO_EVENTINSTANCE* instance) {
+  FmodInstanceState state;
+  if (!Read(instance, &state)) {
+    return;
+  }
+  if (keys_.size() <= states_.size()) {
+    keys_.resize(states_.size() + 1);
+  }
+  keys_[states_.size()] = key;
+  states_.push_back(state);
+}
+
+void InstanceStates::AddEmitter(int emitter_id,
+                                FMOD_STUDIO_EVENTINSTANCE* instance) {
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  if (FMOD_Studio_EventInstance_GetDescription(instance, &description) !=
+      FMOD_OK) {
+    return;
+  }
+  auto it = emitter_keys_.find(description);
+  if (it == emitter_keys_.end()) {
+    it = emitter_keys_.emplace(description, EventKey(description)).first;
+  }
+  size_t index = states_.size();
+  Add(it->second.c_str(), instance);
+  if (states_.size() > index) {
+    states_[index].emitter_id = emitter_id;
+  }
+}
+
+void InstanceStates::Clear() {
+  states_.clear();
+  keys_.clear();
+  emitter_keys_.clear();
+}
+
+bool InstanceStates::Read(FMOD_STUDIO_EVENTINSTANCE* instance,
+                          FmodInstanceState* state) {
+  std::memset(state, 0, sizeof(*state));
+  FMOD_STUDIO_PLAYBACK_STATE playback_state = FMOD_STUDIO_PLAYBACK_STOPPED;
+  if (FMOD_Studio_EventInstance_GetPlaybackState(instance, &playback_state) !=
+      FMOD_OK) {
+    return false;
+  }
+  int position = 0;
+  float volume = 1.0f;
+  FMOD_BOOL paused = 0;
+  FMOD_BOOL is_virtual = 0;
+  FMOD_Studio_EventInstance_GetTimelinePosition(instance, &position);
+  FMOD_Studio_EventInstance_GetVolume(instance, &volume, nullptr);
+  FMOD_Studio_EventInstance_GetPaused(instance, &paused);
+  FMOD_Studio_EventInstance_IsVirtual(instance, &is_virtual);
+  state->handle = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(instance));
+  state->playback_state = playback_state;
+  state->timeline_position = position;
+  state->volume = volume;
+  state->paused = paused ? 1 : 0;
+  state->is_virtual = is_virtual ? 1 : 0;
+  return true;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodInstanceStates {
+  fmod_flutter::InstanceStates states;
+};
+
+FmodInstanceStates* fmod_instance_states_create(void) {
+  return new FmodInstanceStates();
+}
+
+void fmod_instance_states_destroy(FmodInstanceStates* states) {
+  delete states;
+}
+
+void fmod_instance_states_begin(FmodInstanceStates* states) {
+  states->states.Begin();
+}
+
+void fmod_instance_states_add(FmodInstanceStates* states, const char* key,
+                              FMOD_STUDIO_EVENTINSTANCE* instance) {
+  states->states.Add(key, instance);
+}
+
+void fmod_instance_states_add_emitter(FmodInstanceStates* states,
+                                      int emitter_id,
+                                      FMOD_STUDIO_EVENTINSTANCE* instance) {
+  states->states.AddEmitter(emitter_id, instance);
+}
+
+int fmod_instance_states_count(FmodInstanceStates* states) {
+  return states->states.count();
+}
+
+const FmodInstanceState* fmod_instance_states_data(
+    FmodInstanceStates* states) {
+  return states->states.states();
+}
+
+const char* fmod_instance_states_key(FmodInstanceStates* states, int index) {
+  if (index < 0 || index >= states->states.count()) {
+    return nullptr;
+  }
+  return states->states.key(index).c_str();
+}
+
+void fmod_instance_states_clear(FmodInstanceStates* states) {
+  states->states.Clear();
+}
@@ -0,0 +1,100 @@
+#ifndef FMOD_FLUTTER_INSTANCE_STATES_H_
+#define FMOD_FLUTTER_INSTANCE_STATES_H_
+
+// Snapshot of live event instance states shared by all native bridges.
+//
+// Dart only knows which events it started, not which have since ended on
+// their own. Once per update tick, after the Studio update, the bridges
+// list the instances they track here, and each one's playback state,
+// timeline position, volume and paused and virtual flags are read back
+// from FMOD. A query from Dart then copies the whole set in one call, as
+// fixed-size records plus one event key per record, instead of polling
+// FMOD per event.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+// One instance; records are sent to Dart as raw little-endian bytes, so
+// the layout is fixed.
+typedef struct FmodInstanceState {
+  uint64_t handle;            // the instance pointer, unique while it lives
+  int32_t emitter_id;         // 0 unless the instance belongs to an emitter
+  int32_t playback_state;     // FMOD_STUDIO_PLAYBACK_STATE
+  int32_t timeline_position;  // milliseconds
+  float volume;               // as set on the instance
+  uint8_t paused;
+  uint8_t is_virtual;  // playing, but not being mixed for lack of voices
+  uint8_t reserved[6];
+} FmodInstanceState;
+
+#define FMOD_FLUTTER_INSTANCE_STATE_SIZE 32
+
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class InstanceStates {
+ public:
+  InstanceStates();
+
+  // Rebuilds the snapshot: call Begin(), then Add() or AddEmitter() for
+  // every tracked instance. Instances FMOD no longer knows are left out.
+  void Begin();
+  // key is the event path or ID key the bridge tracks the instance under.
+  void Add(const char* key, FMOD_STUDIO_EVENTINSTANCE* instance);
+  // Keyed by the event's path, or its ID key without a strings bank.
+  void AddEmitter(int emitter_id, FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  int count() const { return static_cast<int>(states_.size()); }
+  const FmodInstanceState* states() const { return states_.data(); }
+  const std::string& key(int index) const { return keys_[index]; }
+
+  // Drops the snapshot and the cached emitter keys. Call before releasing
+  // the Studio system.
+  void Clear();
+
+ private:
+  bool Read(FMOD_STUDIO_EVENTINSTANCE* instance, FmodInstanceState* state);
+
+  std::vector<FmodInstanceState> states_;
+  // keys_[i] names states_[i]; strings keep their capacity across ticks.
+  std::vector<std::string> keys_;
+  // Emitter keys by event, so paths are not copied out of FMOD every tick.
+  std::unordered_map<FMOD_STUDIO_EVENTDESCRIPTION*, std::string>
+      emitter_keys_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodInstanceStates FmodInstanceStates;
+
+FmodInstanceStates* fmod_instance_states_create(void);
+void fmod_instance_states_destroy(FmodInstanceStates* states);
+void fmod_instance_states_begin(FmodInstanceStates* states);
+void fmod_instance_states_add(FmodInstanceStates* states, const char* key,
+                              FMOD_STUDIO_EVENTINSTANCE* instance);
+void fmod_instance_states_add_emitter(FmodInstanceStates* states,
+                                      int emitter_id,
+                                      FMOD_STUDIO_EVENTINSTANCE* instance);
+int fmod_instance_states_count(FmodInstanceStates* states);
+// The count() records, contiguous.
+const FmodInstanceState* fmod_instance_states_data(FmodInstanceStates* states);
+const char* fmod_instance_states_key(FmodInstanceStates* states, int index);
+void fmod_instance_states_clear(FmodInstanceStates* states);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_INSTANCE_STATES_H_
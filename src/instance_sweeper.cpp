@@ -0,0 +1,152 @@
+#include "instance_sweeper.h"
+
+#include <algorithm>
+
+namespace fmod_flutter {
+
+InstanceSweeper::InstanceSweeper() : cursor_(0), sweeps_(0), new_watched_(0) {}
+
+void InstanceSweeper::Watch(const char* key,
+                            FMOD_STUDIO_EVENTINSTANCE* instance) {
+  Watched watched;
+  watched.key = key;
+  watched.instance = instance;
+  watched.seen_playing = false;
+  watched.watched_at = sweeps_;
+  watched_.push_back(watched);
+  new_watched_++;
+}
+
+void InstanceSweeper::Forget(FMOD_STUDIO_EVENTINSTANCE* instance) {
+  // Bridges track one instance per event, so the list stays short.
+  for (size_t i = 0; i < watched_.size(); i++) {
+    if (watched_[i].instance == instance) {
+      Remove(i);
+      return;
+    }
+  }
+}
+
+int InstanceSweeper::Sweep(int budget) {
+  finished_.clear();
+  sweeps_++;
+  size_t checks = std::min(
+      static_cast<size_t>(std::max(budget, 0)) + new_watched_,
+      watched_.size());
+  new_watched_ = 0;
+  // Entries that finished or went invalid are cleared here and erased in
+  // one pass below.
+  bool removed = false;
+  for (size_t i = 0; i < checks; i++) {
+    if (cursor_ >= watched_.size()) {
+      cursor_ = 0;
+    }
+    Watched& watched = watched_[cursor_++];
+    FMOD_STUDIO_PLAYBACK_STATE state;
+    if (FMOD_Studio_EventInstance_GetPlaybackState(watched.instance,
+                                                   &state) != FMOD_OK) {
+      watched.instance = nullptr;
+      removed = true;
+      continue;
+    }
+    // The update before the sweep it was watched ahead of may have run
+    // before the start was issued; the one before the next sweep has not.
+    if (state != FMOD_STUDIO_PLAYBACK_STOPPED ||
+        (!watched.seen_playing && sweeps_ - watched.watched_at < 2)) {
+      watched.seen_playing |= state != FMOD_STUDIO_PLAYBACK_STOPPED;
+      continue;
+    }
+    Finished finished;
+    finished.key.swap(watched.key);
+    finished.instance = watched.instance;
+    finished_.push_back(finished);
+    watched.instance = nullptr;
+    removed = true;
+  }
+  if (removed) {
+    Compact();
+  }
+  return static_cast<int>(finished_.size());
+}
+
+void InstanceSweeper::Clear() {
+  watched_.clear();
+  finished_.clear();
+  cursor_ = 0;
+  new_watched_ = 0;
+}
+
+void InstanceSweeper::Compact() {
+  // Kept in order so the remaining entries keep their turn.
+  size_t kept = 0;
+  size_t cursor = 0;
+  for (size_t i = 0; i < watched_.size(); i++) {
+    if (i == cursor_) {
+      cursor = kept;
+    }
+    if (watched_[i].instance == nullptr) {
+      continue;
+    }
+    if (kept != i) {
+      watched_[kept].key.swap(watched_[i].key);
+      watched_[kept].instance = watched_[i].instance;
+      watched_[kept].seen_playing = watched_[i].seen_playing;
+      watched_[kept].watched_at = watched_[i].watched_at;
+    }
+    kept++;
+  }
+  cursor_ = cursor_ >= watched_.size() ? kept : cursor;
+  watched_.resize(kept);
+}
+
+void InstanceSweeper::Remove(size_t index) {
+  // Erased in place so the remaining entries keep their turn.
+  watched_.erase(watched_.begin() + index);
+  if (cursor_ > index) {
+    cursor_--;
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodInstanceSweeper {
+  fmod_flutter::InstanceSweeper sweeper;
+};
+
+FmodInstanceSweeper* fmod_instance_sweeper_create(void) {
+  return new FmodInstanceSweeper();
+}
+
+void fmod_instance_sweeper_destroy(FmodInstanceSweeper* sweeper) {
+  delete sweeper;
+}
+
+void fmod_instance_sweeper_watch(FmodInstanceSweeper* sweeper,
+                                 const char* key,
+                                 FMOD_STUDIO_EVENTINSTANCE* instance) {
+  sweeper->sweeper.Watch(key, instance);
+}
+
+void fmod_instance_sweeper_forget(FmodInstanceSweeper* sweeper,
+                                  FMOD_STUDIO_EVENTINSTANCE* instance) {
+  sweeper->sweeper.Forget(instance);
+}
+
+int fmod_instance_sweeper_sweep(FmodInstanceSweeper* sweeper, int budget) {
+  return sweeper->sweeper.Sweep(budget);
+}
+
+FMOD_STUDIO_EVENTINSTANCE* fmod_instance_sweeper_finished(
+    FmodInstanceSweeper* sweeper, int index, const char** key) {
+  const std::vector<fmod_flutter::InstanceSweeper::Finished>& finished =
+      sweeper->sweeper.finished();
+  if (index < 0 || index >= static_cast<int>(finished.size())) {
+    return nullptr;
+  }
+  *key = finished[index].key.c_str();
+  return finished[index].instance;
+}
+
+void fmod_instance_sweeper_clear(FmodInstanceSweeper* sweeper) {
+  sweeper->sweeper.Clear();
+}
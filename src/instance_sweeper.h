@@ -0,0 +1,118 @@
+#ifndef FMOD_FLUTTER_INSTANCE_SWEEPER_H_
+#define FMOD_FLUTTER_INSTANCE_SWEEPER_H_
+
+// Reclaiming of event instances that finish on their own, shared by all
+// native bridges.
+//
+// The bridges keep the instance each playEvent started until Dart stops
+// it or plays the event again, so a one-shot that runs to its end would
+// otherwise hold its instance, and its event's sample data, for the rest
+// of the session. Each bridge watches the instances it starts here, and
+// after every Studio update Sweep() reads the playback state of a bounded
+// number of them, resuming where the previous tick left off, so update
+// time follows the play rate rather than how many events are tracked. The
+// bridge recycles the stopped instances it is handed and tells Dart which
+// events ended.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+// Watched instances checked per Sweep() call, besides those watched since
+// the previous call.
+#define FMOD_FLUTTER_INSTANCE_SWEEP_BUDGET 16
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class InstanceSweeper {
+ public:
+  struct Finished {
+    std::string key;
+    FMOD_STUDIO_EVENTINSTANCE* instance;
+  };
+
+  InstanceSweeper();
+
+  // Watches an instance the bridge has just started and tracks under key,
+  // its event path or ID key.
+  void Watch(const char* key, FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  // Stops watching an instance, e.g. when Dart stops it and it is
+  // recycled.
+  void Forget(FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  // Checks up to budget watched instances, plus one for each instance
+  // watched since the last sweep so the sweep keeps up with any play rate,
+  // each at most once, and moves those that have stopped to finished().
+  // Call once per tick, after the Studio update. Instances that FMOD no
+  // longer knows are dropped. Returns the number of instances finished.
+  int Sweep(int budget);
+
+  // Instances found stopped by the last Sweep(). They are no longer
+  // watched; the bridge still owns them.
+  const std::vector<Finished>& finished() const { return finished_; }
+
+  int watched_count() const { return static_cast<int>(watched_.size()); }
+
+  // Drops every watched instance. Call before releasing the Studio system.
+  void Clear();
+
+ private:
+  struct Watched {
+    std::string key;
+    FMOD_STUDIO_EVENTINSTANCE* instance;
+    // A start issued since the last Studio update has not taken effect,
+    // so a stopped instance only counts as finished once it has been seen
+    // playing or a whole update has run since it was watched.
+    bool seen_playing;
+    // sweeps_ when it was watched.
+    uint64_t watched_at;
+  };
+
+  // Erases the entries Sweep() cleared.
+  void Compact();
+  void Remove(size_t index);
+
+  std::vector<Watched> watched_;
+  // Where the next Sweep() resumes.
+  size_t cursor_;
+  // Sweep() calls so far.
+  uint64_t sweeps_;
+  // Watch() calls since the last Sweep().
+  size_t new_watched_;
+  std::vector<Finished> finished_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodInstanceSweeper FmodInstanceSweeper;
+
+FmodInstanceSweeper* fmod_instance_sweeper_create(void);
+void fmod_instance_sweeper_destroy(FmodInstanceSweeper* sweeper);
+void fmod_instance_sweeper_watch(FmodInstanceSweeper* sweeper,
+                                 const char* key,
+                                 FMOD_STUDIO_EVENTINSTANCE* instance);
+void fmod_instance_sweeper_forget(FmodInstanceSweeper* sweeper,
+                                  FMOD_STUDIO_EVENTINSTANCE* instance);
+int fmod_instance_sweeper_sweep(FmodInstanceSweeper* sweeper, int budget);
+// The index-th instance finished by the last sweep, and its key.
+FMOD_STUDIO_EVENTINSTANCE* fmod_instance_sweeper_finished(
+    FmodInstanceSweeper* sweeper, int index, const char** key);
+void fmod_instance_sweeper_clear(FmodInstanceSweeper* sweeper);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_INSTANCE_SWEEPER_H_
@@ -0,0 +1,479 @@
+#include "loudness_meter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "dsp_effects.h"
+#include "dsp_kernels.h"
+
+namespace fmod_flutter {
+
+static const double kPi = 3.14159265358979323846;
+
+// Frames processed per kernel call; bounds the scratch buffers.
+static const int kChunkFrames = 256;
+// Gating blocks are 400 ms long and start every 100 ms.
+static const int kMomentaryBlocks = 4;
+static const int kShortTermBlocks = 30;
+// Integrated loudness keeps a 0.1 LU histogram of gating blocks from the
+// -70 LUFS absolute gate up to +30 LUFS instead of every block.
+static const int kHistogramBins = 1000;
+static const double kAbsoluteGate = -70.0;
+static const double kRelativeGate = -10.0;
+static const double kHistogramStep = 0.1;
+// 48-tap windowed-sinc interpolator, 12 taps per polyphase output.
+static const int kTruePeakTaps = 12;
+
+static float true_peak_taps[kTruePeakTaps * kTruePeakPhases];
+static double histogram_energies[kHistogramBins];
+
+static void InitTables() {
+  const int length = kTruePeakTaps * kTruePeakPhases;
+  const double center = (length - 1) / 2.0;
+  double phase_sums[kTruePeakPhases] = {0.0, 0.0, 0.0, 0.0};
+  double taps[kTruePeakTaps * kTruePeakPhases];
+  for (int m = 0; m < length; m++) {
+    double t = (m - center) / kTruePeakPhases;
+    double sinc = t == 0.0 ? 1.0 : std::sin(kPi * t) / (kPi * t);
+    double window = 0.5 - 0.5 * std::cos(2.0 * kPi * (m + 0.5) / length);
+    taps[m] = sinc * window;
+    phase_sums[m % kTruePeakPhases] += taps[m];
+  }
+  // Tap k of phase p is h[p + 4k]; each phase is normalized to unity gain.
+  for (int k = 0; k < kTruePeakTaps; k++) {
+    for (int p = 0; p < kTruePeakPhases; p++) {
+      int m = p + k * kTruePeakPhases;
+      true_peak_taps[k * kTruePeakPhases + p] =
+          static_cast<float>(taps[m] / phase_sums[p]);
+    }
+  }
+
+  for (int i = 0; i < kHistogramBins; i++) {
+    double loudness = kAbsoluteGate + (i + 0.5) * kHistogramStep;
+    histogram_energies[i] = std::pow(10.0, (loudness + 0.691) / 10.0);
+  }
+}
+
+static double Loudness(double energy) {
+  if (energy <= 0.0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  return -0.691 + 10.0 * std::log10(energy);
+}
+
+static float Decibels(double power) {
+  if (power <= 0.0) {
+    return -std::numeric_limits<float>::infinity();
+  }
+  return static_cast<float>(10.0 * std::log10(power));
+}
+
+// Shared memory
+
+namespace {
+
+// Same layout as FmodLoudnessReading.
+struct LoudnessSlot {
+  std::atomic<uint32_t> sequence;
+  std::atomic<int32_t> meter_id;
+  float values[6];
+};
+
+}  // namespace
+
+static_assert(sizeof(LoudnessSlot) == sizeof(FmodLoudnessReading),
+              "LoudnessSlot must match FmodLoudnessReading");
+
+static LoudnessSlot slots[FMOD_FLUTTER_MAX_LOUDNESS_METERS];
+
+static void Publish(int slot_index, const float* values) {
+  LoudnessSlot& slot = slots[slot_index];
+  uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(slot.values, values, sizeof(slot.values));
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+static void PublishSilence(int slot_index) {
+  float values[6];
+  std::fill_n(values, 6, -std::numeric_limits<float>::infinity());
+  Publish(slot_index, values);
+}
+
+int AcquireLoudnessSlot(int meter_id) {
+  for (int i = 0; i < FMOD_FLUTTER_MAX_LOUDNESS_METERS; i++) {
+    int32_t free_id = 0;
+    if (slots[i].meter_id.compare_exchange_strong(free_id, meter_id)) {
+      PublishSilence(i);
+      return i;
+    }
+  }
+  return -1;
+}
+
+void ReleaseLoudnessSlot(int slot) {
+  if (slot < 0 || slot >= FMOD_FLUTTER_MAX_LOUDNESS_METERS) {
+    return;
+  }
+  PublishSilence(slot);
+  slots[slot].meter_id.store(0);
+}
+
+// DSP
+
+struct LoudnessMeterState {
+  std::atomic<int> slot;
+  std::atomic<bool> reset_requested;
+
+  int sample_rate;
+  int channels;
+  BiquadCoefficients pre_filter;
+  BiquadCoefficients rlb_filter;
+  float pre_z1[FMOD_MAX_CHANNEL_WIDTH];
+  float pre_z2[FMOD_MAX_CHANNEL_WIDTH];
+  float rlb_z1[FMOD_MAX_CHANNEL_WIDTH];
+  float rlb_z2[FMOD_MAX_CHANNEL_WIDTH];
+  float weights[FMOD_MAX_CHANNEL_WIDTH];
+
+  // Current 100 ms block.
+  int block_frames;
+  int block_position;
+  double block_energy[FMOD_MAX_CHANNEL_WIDTH];
+  double block_power;
+  float sample_peaks[FMOD_MAX_CHANNEL_WIDTH];
+  float true_peaks[FMOD_MAX_CHANNEL_WIDTH];
+
+  // Mean square of the last kShortTermBlocks blocks, oldest overwritten.
+  double block_history[kShortTermBlocks];
+  int block_count;
+  int block_index;
+  uint32_t histogram[kHistogramBins];
+
+  float k_weighted[kChunkFrames * FMOD_MAX_CHANNEL_WIDTH];
+  // kTruePeakTaps - 1 frames of history followed by the current chunk.
+  float oversampler_input[(kChunkFrames + kTruePeakTaps - 1) *
+                          FMOD_MAX_CHANNEL_WIDTH];
+};
+
+static void ResetMeasurement(LoudnessMeterState* state) {
+  state->block_position = 0;
+  std::fill_n(state->block_energy, FMOD_MAX_CHANNEL_WIDTH, 0.0);
+  state->block_power = 0.0;
+  std::fill_n(state->sample_peaks, FMOD_MAX_CHANNEL_WIDTH, 0.0f);
+  std::fill_n(state->true_peaks, FMOD_MAX_CHANNEL_WIDTH, 0.0f);
+  std::fill_n(state->block_history, kShortTermBlocks, 0.0);
+  state->block_count = 0;
+  state->block_index = 0;
+  std::fill_n(state->histogram, kHistogramBins, 0u);
+}
+
+// K-weighting filters from BS.1770 Annex 1, redesigned for the mixer's
+// sample rate from the analog prototypes.
+static void Configure(LoudnessMeterState* state, int sample_rate,
+                      int channels) {
+  state->sample_rate = sample_rate;
+  state->channels = channels;
+
+  double f0 = 1681.974450955533;
+  double gain_db = 3.999843853973347;
+  double q = 0.7071752369554196;
+  double k = std::tan(kPi * f0 / sample_rate);
+  double vh = std::pow(10.0, gain_db / 20.0);
+  double vb = std::pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  state->pre_filter.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+  state->pre_filter.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+  state->pre_filter.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+  state->pre_filter.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+  state->pre_filter.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = std::tan(kPi * f0 / sample_rate);
+  a0 = 1.0 + k / q + k * k;
+  state->rlb_filter.b0 = 1.0f;
+  state->rlb_filter.b1 = -2.0f;
+  state->rlb_filter.b2 = 1.0f;
+  state->rlb_filter.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+  state->rlb_filter.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+
+  std::fill_n(state->pre_z1, FMOD_MAX_CHANNEL_WIDTH, 0.0f);
+  std::fill_n(state->pre_z2, FMOD_MAX_CHANNEL_WIDTH, 0.0f);
+  std::fill_n(state->rlb_z1, FMOD_MAX_CHANNEL_WIDTH, 0.0f);
+  std::fill_n(state->rlb_z2, FMOD_MAX_CHANNEL_WIDTH, 0.0f);
+  std::fill_n(state->oversampler_input, (kTruePeakTaps - 1) * channels, 0.0f);
+
+  // FMOD orders 5.1 and wider as L R C LFE surrounds...; BS.1770 drops the
+  // LFE and weights surround channels by +1.5 dB.
+  for (int ch = 0; ch < channels; ch++) {
+    float weight = 1.0f;
+    if (channels >= 6 && ch == 3) {
+      weight = 0.0f;
+    } else if (channels >= 6 && ch > 3) {
+      weight = 1.41f;
+    }
+    state->weights[ch] = weight;
+  }
+
+  state->block_frames = sample_rate / 10 > 0 ? sample_rate / 10 : 1;
+  ResetMeasurement(state);
+}
+
+static double MeanEnergy(const LoudnessMeterState* state, int blocks) {
+  double sum = 0.0;
+  for (int i = 1; i <= blocks; i++) {
+    int index = (state->block_index - i + kShortTermBlocks) % kShortTermBlocks;
+    sum += state->block_history[index];
+  }
+  return sum / blocks;
+}
+
+static double IntegratedLoudness(const LoudnessMeterState* state) {
+  double energy = 0.0;
+  uint64_t count = 0;
+  for (int i = 0; i < kHistogramBins; i++) {
+    energy += state->histogram[i] * histogram_energies[i];
+    count += state->histogram[i];
+  }
+  if (count == 0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  double threshold = Loudness(energy / count) + kRelativeGate;
+  int first = static_cast<int>(
+      std::ceil((threshold - kAbsoluteGate) / kHistogramStep - 0.5));
+  first = std::max(first, 0);
+  energy = 0.0;
+  count = 0;
+  for (int i = first; i < kHistogramBins; i++) {
+    energy += state->histogram[i] * histogram_energies[i];
+    count += state->histogram[i];
+  }
+  return count == 0 ? -std::numeric_limits<double>::infinity()
+                    : Loudness(energy / count);
+}
+
+static void FinishBlock(LoudnessMeterState* state) {
+  const int channels = state->channels;
+  double energy = 0.0;
+  double peak = 0.0;
+  double true_peak = 0.0;
+  for (int ch = 0; ch < channels; ch++) {
+    energy += state->weights[ch] * state->block_energy[ch];
+    peak = std::max(peak, static_cast<double>(state->sample_peaks[ch]));
+    true_peak = std::max(true_peak, static_cast<double>(state->true_peaks[ch]));
+  }
+  energy /= state->block_frames;
+
+  state->block_history[state->block_index] = energy;
+  state->block_index = (state->block_index + 1) % kShortTermBlocks;
+  if (state->block_count < kShortTermBlocks) {
+    state->block_count++;
+  }
+
+  const double silence = -std::numeric_limits<double>::infinity();
+  double momentary = silence;
+  if (state->block_count >= kMomentaryBlocks) {
+    momentary = Loudness(MeanEnergy(state, kMomentaryBlocks));
+    if (momentary >= kAbsoluteGate) {
+      int bin = static_cast<int>((momentary - kAbsoluteGate) / kHistogramStep);
+      state->histogram[std::min(bin, kHistogramBins - 1)]++;
+    }
+  }
+  double short_term = state->block_count >= kShortTermBlocks
+                          ? Loudness(MeanEnergy(state, kShortTermBlocks))
+                          : silence;
+
+  int slot = state->slot.load();
+  if (slot >= 0) {
+    float values[6];
+    values[0] = static_cast<float>(momentary);
+    values[1] = static_cast<float>(short_term);
+    values[2] = static_cast<float>(IntegratedLoudness(state));
+    values[3] = Decibels(state->block_power /
+                         (static_cast<double>(state->block_frames) * channels));
+    values[4] = Decibels(peak * peak);
+    values[5] = Decibels(std::max(true_peak, peak) * std::max(true_peak, peak));
+    Publish(slot, values);
+  }
+
+  state->block_position = 0;
+  std::fill_n(state->block_energy, channels, 0.0);
+  state->block_power = 0.0;
+  std::fill_n(state->sample_peaks, channels, 0.0f);
+  std::fill_n(state->true_peaks, channels, 0.0f);
+}
+
+static FMOD_RESULT F_CALL LoudnessMeterCreate(FMOD_DSP_STATE* dsp_state) {
+  LoudnessMeterState* state = new LoudnessMeterState();
+  state->slot.store(-1);
+  state->reset_requested.store(false);
+  state->sample_rate = 0;
+  state->channels = 0;
+  dsp_state->plugindata = state;
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL LoudnessMeterRelease(FMOD_DSP_STATE* dsp_state) {
+  delete static_cast<LoudnessMeterState*>(dsp_state->plugindata);
+  dsp_state->plugindata = nullptr;
+  return FMOD_OK;
+}
+
+// No shouldiprocess callback: the meter keeps running on idle input so the
+// momentary and short-term levels fall back to silence.
+static FMOD_RESULT F_CALL LoudnessMeterRead(FMOD_DSP_STATE* dsp_state,
+                                            float* inbuffer, float* outbuffer,
+                                            unsigned int length,
+                                            int inchannels, int* outchannels) {
+  LoudnessMeterState* state =
+      static_cast<LoudnessMeterState*>(dsp_state->plugindata);
+  *outchannels = inchannels;
+  if (outbuffer != inbuffer) {
+    std::memcpy(outbuffer, inbuffer, sizeof(float) * length * inchannels);
+  }
+  if (inchannels <= 0 || inchannels > FMOD_MAX_CHANNEL_WIDTH) {
+    return FMOD_OK;
+  }
+
+  int sample_rate = 0;
+  FMOD_DSP_GETSAMPLERATE(dsp_state, &sample_rate);
+  if (sample_rate != state->sample_rate || inchannels != state->channels) {
+    Configure(state, sample_rate, inchannels);
+  }
+  if (state->reset_requested.exchange(false)) {
+    ResetMeasurement(state);
+  }
+
+  const DspKernels& kernels = GetDspKernels();
+  const int channels = inchannels;
+  const int history = (kTruePeakTaps - 1) * channels;
+  float* oversampler = state->oversampler_input + history;
+  int offset = 0;
+  while (offset < static_cast<int>(length)) {
+    int frames = std::min(static_cast<int>(length) - offset, kChunkFrames);
+    frames = std::min(frames, state->block_frames - state->block_position);
+    const float* samples = inbuffer + offset * channels;
+
+    kernels.biquad(samples, state->k_weighted, frames, channels,
+                   state->pre_filter, state->pre_z1, state->pre_z2);
+    kernels.biquad(state->k_weighted, state->k_weighted, frames, channels,
+                   state->rlb_filter, state->rlb_z1, state->rlb_z2);
+    float weighted[FMOD_MAX_CHANNEL_WIDTH];
+    float weighted_peaks[FMOD_MAX_CHANNEL_WIDTH];
+    float power[FMOD_MAX_CHANNEL_WIDTH];
+    std::fill_n(weighted, channels, 0.0f);
+    std::fill_n(weighted_peaks, channels, 0.0f);
+    std::fill_n(power, channels, 0.0f);
+    kernels.channel_power(state->k_weighted, frames, channels, weighted,
+                          weighted_peaks);
+    kernels.channel_power(samples, frames, channels, power,
+                          state->sample_peaks);
+
+    std::memcpy(oversampler, samples, sizeof(float) * frames * channels);
+    kernels.true_peak(oversampler, frames, channels, true_peak_taps,
+                      kTruePeakTaps, state->true_peaks);
+    std::memmove(state->oversampler_input,
+                 state->oversampler_input + frames * channels,
+                 sizeof(float) * history);
+
+    for (int ch = 0; ch < channels; ch++) {
+      state->block_energy[ch] += weighted[ch];
+      state->block_power += power[ch];
+    }
+    state->block_position += frames;
+    offset += frames;
+    if (state->block_position == state->block_frames) {
+      FinishBlock(state);
+    }
+  }
+  return FMOD_OK;
+}
+
+static FMOD_RESULT F_CALL LoudnessMeterSetInt(FMOD_DSP_STATE* dsp_state,
+                                              int index, int value) {
+  LoudnessMeterState* state =
+      static_cast<LoudnessMeterState*>(dsp_state->plugindata);
+  switch (index) {
+    case FMOD_FLUTTER_LOUDNESS_METER_RESET:
+      if (value != 0) {
+        state->reset_requested.store(true);
+      }
+      return FMOD_OK;
+    case FMOD_FLUTTER_LOUDNESS_METER_SLOT:
+      state->slot.store(value);
+      return FMOD_OK;
+    default:
+      return FMOD_ERR_INVALID_PARAM;
+  }
+}
+
+static FMOD_RESULT F_CALL LoudnessMeterGetInt(FMOD_DSP_STATE* dsp_state,
+                                              int index, int* value,
+                                              char* /*valuestr*/) {
+  LoudnessMeterState* state =
+      static_cast<LoudnessMeterState*>(dsp_state->plugindata);
+  switch (index) {
+    case FMOD_FLUTTER_LOUDNESS_METER_RESET:
+      *value = 0;
+      return FMOD_OK;
+    case FMOD_FLUTTER_LOUDNESS_METER_SLOT:
+      *value = state->slot.load();
+      return FMOD_OK;
+    default:
+      return FMOD_ERR_INVALID_PARAM;
+  }
+}
+
+static FMOD_DSP_PARAMETER_DESC loudness_meter_reset;
+static FMOD_DSP_PARAMETER_DESC loudness_meter_slot;
+static FMOD_DSP_PARAMETER_DESC* loudness_meter_params[] = {
+    &loudness_meter_reset, &loudness_meter_slot};
+
+const FMOD_DSP_DESCRIPTION& GetLoudnessMeterDescription() {
+  static FMOD_DSP_DESCRIPTION description;
+  static bool initialized = false;
+  if (initialized) {
+    return description;
+  }
+  InitTables();
+
+  FMOD_DSP_INIT_PARAMDESC_INT(loudness_meter_reset, "Reset", "",
+                              "Restart integrated loudness when set", 0, 1, 0,
+                              false, nullptr);
+  FMOD_DSP_INIT_PARAMDESC_INT(loudness_meter_slot, "Slot", "",
+                              "Shared-memory slot, assigned by BusEffects", -1,
+                              FMOD_FLUTTER_MAX_LOUDNESS_METERS - 1, -1, false,
+                              nullptr);
+
+  std::memset(&description, 0, sizeof(description));
+  description.pluginsdkversion = FMOD_PLUGIN_SDK_VERSION;
+  std::strncpy(description.name, "FmodFlutter Loudness",
+               sizeof(description.name) - 1);
+  description.version = 0x00010000;
+  description.numinputbuffers = 1;
+  description.numoutputbuffers = 1;
+  description.create = LoudnessMeterCreate;
+  description.release = LoudnessMeterRelease;
+  description.read = LoudnessMeterRead;
+  description.numparameters = 2;
+  description.paramdesc = loudness_meter_params;
+  description.setparameterint = LoudnessMeterSetInt;
+  description.getparameterint = LoudnessMeterGetInt;
+  initialized = true;
+  return description;
+}
+
+}  // namespace fmod_flutter
+
+FmodLoudnessReading* fmod_flutter_loudness_readings(void) {
+  return reinterpret_cast<FmodLoudnessReading*>(fmod_flutter::slots);
+}
+
+int fmod_flutter_loudness_reading_count(void) {
+  return FMOD_FLUTTER_MAX_LOUDNESS_METERS;
+}
@@ -0,0 +1,59 @@
+#ifndef FMOD_FLUTTER_LOUDNESS_METER_H_
+#define FMOD_FLUTTER_LOUDNESS_METER_H_
+
+// Loudness meter DSP (ITU-R BS.1770 / EBU R128) and the shared-memory table
+// it publishes into.
+//
+// The meter passes audio through unchanged. Every 100 ms of audio the mixer
+// thread writes a new reading into the meter's slot of a static table, and
+// Dart reads that table directly through dart:ffi, so metering costs no
+// platform channel traffic. Each slot is guarded by a sequence counter that
+// is odd while a write is in progress; readers retry until they see the
+// same even value before and after copying the slot.
+
+#include <stdint.h>
+
+#include <fmod.h>
+
+#include "fmod_flutter_export.h"
+
+#define FMOD_FLUTTER_MAX_LOUDNESS_METERS 16
+
+// Layout shared with lib/src/fmod_native_ffi.dart. Levels are -inf for
+// silence or before enough audio has been measured.
+typedef struct FmodLoudnessReading {
+  uint32_t sequence;
+  int32_t meter_id;  // BusEffects id of the meter, 0 for a free slot
+  float momentary_lufs;   // 400 ms window
+  float short_term_lufs;  // 3 s window
+  float integrated_lufs;  // gated, since the meter was added or reset
+  float rms_db;           // last 100 ms, all channels
+  float peak_db;          // sample peak of the last 100 ms
+  float true_peak_db;     // 4x oversampled peak of the last 100 ms
+} FmodLoudnessReading;
+
+#ifdef __cplusplus
+
+namespace fmod_flutter {
+
+const FMOD_DSP_DESCRIPTION& GetLoudnessMeterDescription();
+
+// Claims a free slot for meter_id. Returns the slot index, or -1 when every
+// slot is taken.
+int AcquireLoudnessSlot(int meter_id);
+void ReleaseLoudnessSlot(int slot);
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// Looked up from Dart.
+FMOD_FLUTTER_EXPORT FmodLoudnessReading* fmod_flutter_loudness_readings(void);
+FMOD_FLUTTER_EXPORT int fmod_flutter_loudness_reading_count(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_LOUDNESS_METER_H_
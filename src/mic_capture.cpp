@@ -0,0 +1,342 @@
+#include "mic_capture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace fmod_flutter {
+
+static const int kDriftMs = 1;
+// The monitor plays the one-second record loop this far behind the record
+// position at most. Half the loop leaves room for drift and driver blocks;
+// a target near a whole loop would play audio the driver is overwriting.
+static const int kMaxLatencyMs = 500;
+// Weight of each new latency measurement in the smoothed value.
+static const double kLatencySmoothing = 0.03;
+
+namespace {
+
+// Written by Update() on the bridge's update tick, read by Dart. The reader
+// skips anything before start, so a new recording never returns audio from
+// the previous one.
+struct MicTap {
+  float samples[FMOD_FLUTTER_MIC_TAP_SAMPLES];
+  std::atomic<uint32_t> write;
+  std::atomic<uint32_t> read;
+  std::atomic<uint32_t> start;
+  std::atomic<int32_t> channels;
+};
+
+}  // namespace
+
+static MicTap tap;
+
+// Pushes whole frames of 16-bit samples as floats; returns the number of
+// samples that did not fit.
+static uint32_t PushTap(const int16_t* samples, uint32_t count,
+                        int channels) {
+  static const uint32_t kMask = FMOD_FLUTTER_MIC_TAP_SAMPLES - 1;
+  uint32_t write = tap.write.load(std::memory_order_relaxed);
+  uint32_t read = tap.read.load(std::memory_order_acquire);
+  uint32_t space = FMOD_FLUTTER_MIC_TAP_SAMPLES - (write - read);
+  uint32_t fit = std::min(count, space);
+  fit -= fit % channels;
+  for (uint32_t i = 0; i < fit; i++) {
+    tap.samples[(write + i) & kMask] = samples[i] * (1.0f / 32768.0f);
+  }
+  tap.write.store(write + fit, std::memory_order_release);
+  return count - fit;
+}
+
+MicCapture::MicCapture()
+    : core_system_(nullptr),
+      sound_(nullptr),
+      channel_(nullptr),
+      driver_(0),
+      monitor_(false),
+      recording_(false),
+      sample_rate_(0),
+      channels_(0),
+      sound_frames_(0),
+      last_record_pos_(0),
+      last_play_pos_(0),
+      min_record_delta_(0),
+      desired_latency_(0),
+      adjusted_latency_(0),
+      drift_threshold_(0),
+      recorded_frames_(0),
+      played_frames_(0),
+      actual_latency_(0.0),
+      dropped_samples_(0),
+      last_result_(FMOD_OK) {}
+
+bool MicCapture::Start(FMOD_SYSTEM* core_system, int driver, bool monitor,
+                       int latency_ms) {
+  Stop();
+  if (latency_ms <= 0 || latency_ms > kMaxLatencyMs) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return false;
+  }
+  int driver_count = 0;
+  last_result_ =
+      FMOD_System_GetRecordNumDrivers(core_system, &driver_count, nullptr);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  if (driver < 0 || driver >= driver_count) {
+    last_result_ = FMOD_ERR_OUTPUT_NODRIVERS;
+    return false;
+  }
+  int rate = 0;
+  int channels = 0;
+  last_result_ = FMOD_System_GetRecordDriverInfo(
+      core_system, driver, nullptr, 0, nullptr, &rate, nullptr, &channels,
+      nullptr);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  if (rate <= 0 || channels <= 0 || channels > FMOD_MAX_CHANNEL_WIDTH) {
+    last_result_ = FMOD_ERR_FORMAT;
+    return false;
+  }
+
+  FMOD_CREATESOUNDEXINFO exinfo;
+  std::memset(&exinfo, 0, sizeof(exinfo));
+  exinfo.cbsize = sizeof(exinfo);
+  exinfo.numchannels = channels;
+  exinfo.format = FMOD_SOUND_FORMAT_PCM16;
+  exinfo.defaultfrequency = rate;
+  exinfo.length = static_cast<unsigned int>(rate) * sizeof(int16_t) * channels;
+  FMOD_SOUND* sound = nullptr;
+  last_result_ = FMOD_System_CreateSound(
+      core_system, nullptr, FMOD_LOOP_NORMAL | FMOD_OPENUSER | FMOD_2D,
+      &exinfo, &sound);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  last_result_ = FMOD_System_RecordStart(core_system, driver, sound, 1);
+  if (last_result_ != FMOD_OK) {
+    FMOD_Sound_Release(sound);
+    return false;
+  }
+
+  core_system_ = core_system;
+  sound_ = sound;
+  driver_ = driver;
+  monitor_ = monitor;
+  recording_ = true;
+  sample_rate_ = rate;
+  channels_ = channels;
+  sound_frames_ = static_cast<unsigned int>(rate);
+  last_record_pos_ = 0;
+  last_play_pos_ = 0;
+  min_record_delta_ = static_cast<unsigned int>(-1);
+  desired_latency_ = static_cast<unsigned int>(
+      static_cast<int64_t>(rate) * latency_ms / 1000);
+  adjusted_latency_ = desired_latency_;
+  drift_threshold_ = static_cast<unsigned int>(rate * kDriftMs / 1000);
+  recorded_frames_ = 0;
+  played_frames_ = 0;
+  actual_latency_ = desired_latency_;
+  dropped_samples_ = 0;
+
+  tap.channels.store(channels);
+  tap.start.store(tap.write.load(std::memory_order_relaxed),
+                  std::memory_order_release);
+  return true;
+}
+
+bool MicCapture::Stop() {
+  if (sound_ == nullptr) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  last_result_ = FMOD_System_RecordStop(core_system_, driver_);
+  if (channel_ != nullptr) {
+    FMOD_Channel_Stop(channel_);
+    channel_ = nullptr;
+  }
+  FMOD_Sound_Release(sound_);
+  sound_ = nullptr;
+  recording_ = false;
+  return last_result_ == FMOD_OK;
+}
+
+void MicCapture::Update() {
+  if (sound_ == nullptr) {
+    return;
+  }
+  FMOD_BOOL recording = 0;
+  FMOD_System_IsRecording(core_system_, driver_, &recording);
+  recording_ = recording != 0;
+
+  unsigned int record_pos = 0;
+  if (FMOD_System_GetRecordPosition(core_system_, driver_, &record_pos) !=
+      FMOD_OK) {
+    return;
+  }
+  unsigned int record_delta =
+      record_pos >= last_record_pos_
+          ? record_pos - last_record_pos_
+          : record_pos + sound_frames_ - last_record_pos_;
+  if (record_delta > 0) {
+    Tap(last_record_pos_, record_delta);
+  }
+  last_record_pos_ = record_pos;
+  recorded_frames_ += record_delta;
+
+  // The smallest delta seen is the driver's block size; a target below it
+  // cannot be held. Nor can one past kMaxLatencyMs.
+  if (record_delta != 0 && record_delta < min_record_delta_) {
+    min_record_delta_ = record_delta;
+    unsigned int max_latency =
+        static_cast<unsigned int>(sample_rate_ * kMaxLatencyMs / 1000);
+    adjusted_latency_ =
+        std::min(std::max(record_delta, desired_latency_), max_latency);
+  }
+
+  if (!monitor_) {
+    return;
+  }
+  if (channel_ == nullptr) {
+    if (recording_ && recorded_frames_ >= adjusted_latency_) {
+      FMOD_System_PlaySound(core_system_, sound_, nullptr, 0, &channel_);
+    }
+    return;
+  }
+
+  FMOD_BOOL playing = 0;
+  if (FMOD_Channel_IsPlaying(channel_, &playing) != FMOD_OK || !playing) {
+    // Stolen or stopped; its position no longer follows the recording.
+    channel_ = nullptr;
+    monitor_ = false;
+    return;
+  }
+  unsigned int play_pos = 0;
+  FMOD_Channel_GetPosition(channel_, &play_pos, FMOD_TIMEUNIT_PCM);
+  unsigned int play_delta = play_pos >= last_play_pos_
+                                ? play_pos - last_play_pos_
+                                : play_pos + sound_frames_ - last_play_pos_;
+  last_play_pos_ = play_pos;
+  played_frames_ += play_delta;
+
+  double latency = static_cast<double>(recorded_frames_ - played_frames_);
+  actual_latency_ = (1.0 - kLatencySmoothing) * actual_latency_ +
+                    kLatencySmoothing * latency;
+  float rate = static_cast<float>(sample_rate_);
+  if (actual_latency_ <
+      static_cast<double>(adjusted_latency_) - drift_threshold_) {
+    // Playback is catching up with the recording.
+    rate -= sample_rate_ / 50;
+  } else if (actual_latency_ >
+             static_cast<double>(adjusted_latency_) + drift_threshold_) {
+    rate += sample_rate_ / 50;
+  }
+  FMOD_Channel_SetFrequency(channel_, rate);
+}
+
+void MicCapture::Tap(unsigned int from_frame, unsigned int frames) {
+  unsigned int frame_bytes = sizeof(int16_t) * channels_;
+  void* first = nullptr;
+  void* second = nullptr;
+  unsigned int first_bytes = 0;
+  unsigned int second_bytes = 0;
+  // Lock returns the wrapped part of the looping sound as a second span.
+  if (FMOD_Sound_Lock(sound_, from_frame * frame_bytes, frames * frame_bytes,
+                      &first, &second, &first_bytes,
+                      &second_bytes) != FMOD_OK) {
+    return;
+  }
+  dropped_samples_ += PushTap(static_cast<const int16_t*>(first),
+                              first_bytes / sizeof(int16_t), channels_);
+  if (second != nullptr) {
+    dropped_samples_ += PushTap(static_cast<const int16_t*>(second),
+                                second_bytes / sizeof(int16_t), channels_);
+  }
+  FMOD_Sound_Unlock(sound_, first, second, first_bytes, second_bytes);
+}
+
+bool MicCapture::GetStats(FmodMicStats* stats) const {
+  if (sound_ == nullptr) {
+    return false;
+  }
+  stats->recording = recording_ ? 1 : 0;
+  stats->monitoring = channel_ != nullptr ? 1 : 0;
+  stats->sample_rate = sample_rate_;
+  stats->channels = channels_;
+  stats->recorded_frames = recorded_frames_;
+  stats->dropped_samples = dropped_samples_;
+  stats->monitor_latency_us =
+      channel_ != nullptr
+          ? static_cast<int64_t>(actual_latency_ * 1e6 / sample_rate_)
+          : 0;
+  stats->target_latency_us =
+      static_cast<int64_t>(adjusted_latency_) * 1000000 / sample_rate_;
+  return true;
+}
+
+void MicCapture::Clear() {
+  if (sound_ != nullptr) {
+    Stop();
+  }
+  core_system_ = nullptr;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodMicCapture {
+  fmod_flutter::MicCapture capture;
+};
+
+FmodMicCapture* fmod_mic_capture_create(void) { return new FmodMicCapture(); }
+
+void fmod_mic_capture_destroy(FmodMicCapture* capture) { delete capture; }
+
+int fmod_mic_capture_start(FmodMicCapture* capture, FMOD_SYSTEM* core_system,
+                           int driver, int monitor, int latency_ms) {
+  return capture->capture.Start(core_system, driver, monitor != 0, latency_ms)
+             ? 1
+             : 0;
+}
+
+int fmod_mic_capture_stop(FmodMicCapture* capture) {
+  return capture->capture.Stop() ? 1 : 0;
+}
+
+void fmod_mic_capture_update(FmodMicCapture* capture) {
+  capture->capture.Update();
+}
+
+int fmod_mic_capture_get_stats(FmodMicCapture* capture, FmodMicStats* stats) {
+  return capture->capture.GetStats(stats) ? 1 : 0;
+}
+
+void fmod_mic_capture_clear(FmodMicCapture* capture) {
+  capture->capture.Clear();
+}
+
+FMOD_RESULT fmod_mic_capture_last_result(FmodMicCapture* capture) {
+  return capture->capture.last_result();
+}
+
+int32_t fmod_flutter_mic_read(float* out, int32_t max_samples) {
+  fmod_flutter::MicTap& tap = fmod_flutter::tap;
+  uint32_t write = tap.write.load(std::memory_order_acquire);
+  uint32_t read = tap.read.load(std::memory_order_relaxed);
+  uint32_t start = tap.start.load(std::memory_order_acquire);
+  if (static_cast<int32_t>(start - read) > 0) {
+    read = start;
+  }
+  int32_t channels = tap.channels.load();
+  if (max_samples <= 0 || channels <= 0) {
+    return 0;
+  }
+  uint32_t count =
+      std::min(static_cast<uint32_t>(max_samples), write - read);
+  count -= count % channels;
+  for (uint32_t i = 0; i < count; i++) {
+    out[i] = tap.samples[(read + i) & (FMOD_FLUTTER_MIC_TAP_SAMPLES - 1)];
+  }
+  tap.read.store(read + count, std::memory_order_release);
+  return static_cast<int32_t>(count);
+}
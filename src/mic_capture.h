@@ -0,0 +1,127 @@
+#ifndef FMOD_FLUTTER_MIC_CAPTURE_H_
+#define FMOD_FLUTTER_MIC_CAPTURE_H_
+
+// Microphone capture on the core system's record API, shared by all native
+// bridges.
+//
+// Recording runs into a looping one-second sound (System::recordStart with
+// loop set). Update(), called from the bridge's update tick, follows the
+// record position and does two things with the audio recorded since the
+// last tick:
+// - taps it into a static ring of float samples that Dart drains through
+//   dart:ffi, so captured PCM crosses no platform channel;
+// - optionally monitors it, playing the same sound a target latency behind
+//   the record position. Record and output clocks drift apart, so the
+//   playback rate is nudged by 2% whenever the smoothed distance leaves a
+//   1 ms window around the target, as in FMOD's record example. A driver
+//   that delivers in blocks larger than the target raises the target to
+//   one block. The target stays within half the loop, so playback never
+//   reaches audio the driver is overwriting.
+
+#include <stdint.h>
+
+#include <fmod.h>
+
+#include "fmod_flutter_export.h"
+
+// Samples the Dart tap holds, about 1.4 s of 48 kHz stereo.
+#define FMOD_FLUTTER_MIC_TAP_SAMPLES (1 << 17)
+
+// Recording statistics.
+typedef struct FmodMicStats {
+  int32_t recording;   // 1 while the driver is recording
+  int32_t monitoring;  // 1 while the monitor channel is playing
+  int32_t sample_rate;
+  int32_t channels;
+  int64_t recorded_frames;
+  int64_t dropped_samples;     // tapped audio lost because Dart fell behind
+  int64_t monitor_latency_us;  // smoothed record-to-playback distance
+  int64_t target_latency_us;
+} FmodMicStats;
+
+#ifdef __cplusplus
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock. Only one capture can feed the Dart tap at a time.
+class MicCapture {
+ public:
+  MicCapture();
+
+  // Starts recording from record driver `driver` at its native rate and
+  // channel count, replacing any recording in progress. With monitor set,
+  // also plays the input back latency_ms behind. latency_ms must be 1 to
+  // 500, or this fails with FMOD_ERR_INVALID_PARAM. Audio tapped before
+  // this call is discarded.
+  bool Start(FMOD_SYSTEM* core_system, int driver, bool monitor,
+             int latency_ms);
+  bool Stop();
+
+  // Taps new audio and corrects monitor drift. Call every update tick.
+  void Update();
+
+  // Returns false when not started.
+  bool GetStats(FmodMicStats* stats) const;
+
+  // Stops recording. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  void Tap(unsigned int from_frame, unsigned int frames);
+
+  FMOD_SYSTEM* core_system_;
+  FMOD_SOUND* sound_;
+  FMOD_CHANNEL* channel_;
+  int driver_;
+  bool monitor_;
+  bool recording_;
+  int sample_rate_;
+  int channels_;
+  unsigned int sound_frames_;
+
+  unsigned int last_record_pos_;
+  unsigned int last_play_pos_;
+  unsigned int min_record_delta_;
+  unsigned int desired_latency_;
+  unsigned int adjusted_latency_;
+  unsigned int drift_threshold_;
+  int64_t recorded_frames_;
+  int64_t played_frames_;
+  double actual_latency_;
+  int64_t dropped_samples_;
+
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodMicCapture FmodMicCapture;
+
+FmodMicCapture* fmod_mic_capture_create(void);
+void fmod_mic_capture_destroy(FmodMicCapture* capture);
+int fmod_mic_capture_start(FmodMicCapture* capture, FMOD_SYSTEM* core_system,
+                           int driver, int monitor, int latency_ms);
+int fmod_mic_capture_stop(FmodMicCapture* capture);
+void fmod_mic_capture_update(FmodMicCapture* capture);
+int fmod_mic_capture_get_stats(FmodMicCapture* capture, FmodMicStats* stats);
+void fmod_mic_capture_clear(FmodMicCapture* capture);
+FMOD_RESULT fmod_mic_capture_last_result(FmodMicCapture* capture);
+
+// Looked up from Dart. Moves up to max_samples interleaved samples (whole
+// frames only) of tapped audio into out and returns how many were moved.
+// Single reader only.
+FMOD_FLUTTER_EXPORT int32_t fmod_flutter_mic_read(float* out,
+                                                  int32_t max_samples);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_MIC_CAPTURE_H_
@@ -0,0 +1,312 @@
+#include "mixer_control.h"
+
+#include <vector>
+
+#include "event_lookup.h"
+
+namespace fmod_flutter {
+
+// Longest path FMOD Studio reports for a bus or VCA.
+static const int kMaxPathLength = 512;
+
+MixerControl::MixerControl() : time_(0.0), last_result_(FMOD_OK) {}
+
+void MixerControl::CacheBanks(FMOD_STUDIO_SYSTEM* studio_system) {
+  int bank_count = 0;
+  if (FMOD_Studio_System_GetBankCount(studio_system, &bank_count) != FMOD_OK ||
+      bank_count <= 0) {
+    return;
+  }
+  std::vector<FMOD_STUDIO_BANK*> banks(bank_count);
+  FMOD_Studio_System_GetBankList(studio_system, banks.data(), bank_count,
+                                 &bank_count);
+
+  char path[kMaxPathLength];
+  for (int b = 0; b < bank_count; b++) {
+    int count = 0;
+    if (FMOD_Studio_Bank_GetBusCount(banks[b], &count) == FMOD_OK &&
+        count > 0) {
+      std::vector<FMOD_STUDIO_BUS*> buses(count);
+      FMOD_Studio_Bank_GetBusList(banks[b], buses.data(), count, &count);
+      for (int i = 0; i < count; i++) {
+        // Fails until the strings bank is loaded; a later call catches up.
+        if (FMOD_Studio_Bus_GetPath(buses[i], path, kMaxPathLength,
+                                    nullptr) == FMOD_OK) {
+          buses_[path] = buses[i];
+        }
+      }
+    }
+
+    count = 0;
+    if (FMOD_Studio_Bank_GetVCACount(banks[b], &count) == FMOD_OK &&
+        count > 0) {
+      std::vector<FMOD_STUDIO_VCA*> vcas(count);
+      FMOD_Studio_Bank_GetVCAList(banks[b], vcas.data(), count, &count);
+      for (int i = 0; i < count; i++) {
+        if (FMOD_Studio_VCA_GetPath(vcas[i], path, kMaxPathLength, nullptr) ==
+            FMOD_OK) {
+          vcas_[path] = vcas[i];
+        }
+      }
+    }
+  }
+}
+
+FMOD_STUDIO_BUS* MixerControl::GetBus(FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path) {
+  auto it = buses_.find(path);
+  if (it != buses_.end()) {
+    last_result_ = FMOD_OK;
+    return it->second;
+  }
+  FMOD_STUDIO_BUS* bus = nullptr;
+  last_result_ = FMOD_Studio_System_GetBus(studio_system, path, &bus);
+  if (last_result_ != FMOD_OK) {
+    return nullptr;
+  }
+  buses_[path] = bus;
+  return bus;
+}
+
+FMOD_STUDIO_VCA* MixerControl::GetVca(FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path) {
+  auto it = vcas_.find(path);
+  if (it != vcas_.end()) {
+    last_result_ = FMOD_OK;
+    return it->second;
+  }
+  FMOD_STUDIO_VCA* vca = nullptr;
+  last_result_ = FMOD_Studio_System_GetVCA(studio_system, path, &vca);
+  if (last_result_ != FMOD_OK) {
+    return nullptr;
+  }
+  vcas_[path] = vca;
+  return vca;
+}
+
+bool MixerControl::SetBusVolume(FMOD_STUDIO_SYSTEM* studio_system,
+                                const char* path, float volume,
+                                float ramp_seconds) {
+  FMOD_STUDIO_BUS* bus = GetBus(studio_system, path);
+  return bus != nullptr && SetVolume(bus, nullptr, volume, ramp_seconds);
+}
+
+bool MixerControl::SetVcaVolume(FMOD_STUDIO_SYSTEM* studio_system,
+                                const char* path, float volume,
+                                float ramp_seconds) {
+  FMOD_STUDIO_VCA* vca = GetVca(studio_system, path);
+  return vca != nullptr && SetVolume(nullptr, vca, volume, ramp_seconds);
+}
+
+bool MixerControl::SetBusMute(FMOD_STUDIO_SYSTEM* studio_system,
+                              const char* path, bool mute) {
+  FMOD_STUDIO_BUS* bus = GetBus(studio_system, path);
+  if (bus == nullptr) {
+    return false;
+  }
+  last_result_ = FMOD_Studio_Bus_SetMute(bus, mute ? 1 : 0);
+  return last_result_ == FMOD_OK;
+}
+
+bool MixerControl::SetBusPaused(FMOD_STUDIO_SYSTEM* studio_system,
+                                const char* path, bool paused) {
+  FMOD_STUDIO_BUS* bus = GetBus(studio_system, path);
+  if (bus == nullptr) {
+    return false;
+  }
+  last_result_ = FMOD_Studio_Bus_SetPaused(bus, paused ? 1 : 0);
+  return last_result_ == FMOD_OK;
+}
+
+bool MixerControl::SetVolume(FMOD_STUDIO_BUS* bus, FMOD_STUDIO_VCA* vca,
+                             float volume, float ramp_seconds) {
+  void* key = bus != nullptr ? static_cast<void*>(bus)
+                             : static_cast<void*>(vca);
+  Ramp ramp = {bus, vca, volume, volume, time_, ramp_seconds};
+
+  if (ramp_seconds <= 0.0f) {
+    ramps_.erase(key);
+    last_result_ = ApplyVolume(ramp, volume);
+    return last_result_ == FMOD_OK;
+  }
+
+  // Start from the volume last set, which is mid-ramp if one is running.
+  last_result_ = bus != nullptr
+                     ? FMOD_Studio_Bus_GetVolume(bus, &ramp.from, nullptr)
+                     : FMOD_Studio_VCA_GetVolume(vca, &ramp.from, nullptr);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  ramps_[key] = ramp;
+  return true;
+}
+
+FMOD_RESULT MixerControl::ApplyVolume(const Ramp& ramp, float volume) {
+  return ramp.bus != nullptr ? FMOD_Studio_Bus_SetVolume(ramp.bus, volume)
+                             : FMOD_Studio_VCA_SetVolume(ramp.vca, volume);
+}
+
+void MixerControl::Update(float elapsed_seconds) {
+  if (elapsed_seconds > 0.0f) {
+    time_ += elapsed_seconds;
+  }
+  if (ramps_.empty()) {
+    return;
+  }
+  for (auto it = ramps_.begin(); it != ramps_.end();) {
+    const Ramp& ramp = it->second;
+    float t = static_cast<float>(time_ - ramp.start) / ramp.seconds;
+    if (t >= 1.0f) {
+      ApplyVolume(ramp, ramp.to);
+      it = ramps_.erase(it);
+    } else {
+      // A handle invalidated by a bank unload ends its ramp.
+      if (ApplyVolume(ramp, ramp.from + (ramp.to - ramp.from) * t) !=
+          FMOD_OK) {
+        it = ramps_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+bool MixerControl::StartSnapshot(FMOD_STUDIO_SYSTEM* studio_system,
+                                 const char* path) {
+  auto it = snapshots_.find(path);
+  if (it != snapshots_.end()) {
+    last_result_ = FMOD_Studio_EventInstance_Start(it->second);
+    return last_result_ == FMOD_OK;
+  }
+
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  last_result_ = GetEvent(studio_system, path, &description);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  FMOD_BOOL is_snapshot = 0;
+  FMOD_Studio_EventDescription_IsSnapshot(description, &is_snapshot);
+  if (!is_snapshot) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return false;
+  }
+
+  FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
+  last_result_ =
+      FMOD_Studio_EventDescription_CreateInstance(description, &instance);
+  if (last_result_ == FMOD_OK) {
+    last_result_ = FMOD_Studio_EventInstance_Start(instance);
+    if (last_result_ != FMOD_OK) {
+      FMOD_Studio_EventInstance_Release(instance);
+    }
+  }
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  snapshots_[path] = instance;
+  return true;
+}
+
+bool MixerControl::StopSnapshot(const char* path, bool allow_fadeout) {
+  auto it = snapshots_.find(path);
+  if (it == snapshots_.end()) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  FMOD_Studio_EventInstance_Stop(it->second,
+                                 allow_fadeout
+                                     ? FMOD_STUDIO_STOP_ALLOWFADEOUT
+                                     : FMOD_STUDIO_STOP_IMMEDIATE);
+  last_result_ = FMOD_Studio_EventInstance_Release(it->second);
+  snapshots_.erase(it);
+  return true;
+}
+
+void MixerControl::Clear() {
+  for (auto& pair : snapshots_) {
+    FMOD_Studio_EventInstance_Stop(pair.second, FMOD_STUDIO_STOP_IMMEDIATE);
+    FMOD_Studio_EventInstance_Release(pair.second);
+  }
+  snapshots_.clear();
+  ramps_.clear();
+  buses_.clear();
+  vcas_.clear();
+}
+
+}  // namespace fmod_flutter
+
+struct FmodMixerControl {
+  fmod_flutter::MixerControl mixer;
+};
+
+FmodMixerControl* fmod_mixer_control_create(void) {
+  return new FmodMixerControl();
+}
+
+void fmod_mixer_control_destroy(FmodMixerControl* mixer) {
+  delete mixer;
+}
+
+void fmod_mixer_control_cache_banks(FmodMixerControl* mixer,
+                                    FMOD_STUDIO_SYSTEM* studio_system) {
+  mixer->mixer.CacheBanks(studio_system);
+}
+
+FMOD_STUDIO_BUS* fmod_mixer_control_get_bus(FmodMixerControl* mixer,
+                                            FMOD_STUDIO_SYSTEM* studio_system,
+                                            const char* path) {
+  return mixer->mixer.GetBus(studio_system, path);
+}
+
+int fmod_mixer_control_set_bus_volume(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path, float volume,
+                                      float ramp_seconds) {
+  return mixer->mixer.SetBusVolume(studio_system, path, volume, ramp_seconds)
+             ? 1
+             : 0;
+}
+
+int fmod_mixer_control_set_vca_volume(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path, float volume,
+                                      float ramp_seconds) {
+  return mixer->mixer.SetVcaVolume(studio_system, path, volume, ramp_seconds)
+             ? 1
+             : 0;
+}
+
+int fmod_mixer_control_set_bus_mute(FmodMixerControl* mixer,
+                                    FMOD_STUDIO_SYSTEM* studio_system,
+                                    const char* path, int mute) {
+  return mixer->mixer.SetBusMute(studio_system, path, mute != 0) ? 1 : 0;
+}
+
+int fmod_mixer_control_set_bus_paused(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path, int paused) {
+  return mixer->mixer.SetBusPaused(studio_system, path, paused != 0) ? 1 : 0;
+}
+
+int fmod_mixer_control_start_snapshot(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path) {
+  return mixer->mixer.StartSnapshot(studio_system, path) ? 1 : 0;
+}
+
+int fmod_mixer_control_stop_snapshot(FmodMixerControl* mixer,
+                                     const char* path, int allow_fadeout) {
+  return mixer->mixer.StopSnapshot(path, allow_fadeout != 0) ? 1 : 0;
+}
+
+void fmod_mixer_control_update(FmodMixerControl* mixer, float elapsed_seconds) {
+  mixer->mixer.Update(elapsed_seconds);
+}
+
+void fmod_mixer_control_clear(FmodMixerControl* mixer) {
+  mixer->mixer.Clear();
+}
+
+FMOD_RESULT fmod_mixer_control_last_result(FmodMixerControl* mixer) {
+  return mixer->mixer.last_result();
+}
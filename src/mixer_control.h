@@ -0,0 +1,129 @@
+#ifndef FMOD_FLUTTER_MIXER_CONTROL_H_
+#define FMOD_FLUTTER_MIXER_CONTROL_H_
+
+// Bus, VCA and snapshot control shared by all native bridges.
+//
+// Bus and VCA handles are cached by path whenever banks are loaded, so
+// mixer calls do not look them up again. Volume changes can ramp over time;
+// Update(), called from the bridge's update tick, interpolates every active
+// ramp so a fade is one call from Dart instead of one per frame. Ramps run
+// on the seconds passed to Update(), like parameter automation, so they
+// follow the mix in offline renders.
+
+#include <fmod_studio.h>
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class MixerControl {
+ public:
+  MixerControl();
+
+  // Caches the bus and VCA handles of every loaded bank. Call after each
+  // bank load; paths are only known once the strings bank is loaded.
+  void CacheBanks(FMOD_STUDIO_SYSTEM* studio_system);
+
+  // Cached handles, falling back to (and caching) a lookup by path.
+  FMOD_STUDIO_BUS* GetBus(FMOD_STUDIO_SYSTEM* studio_system, const char* path);
+  FMOD_STUDIO_VCA* GetVca(FMOD_STUDIO_SYSTEM* studio_system, const char* path);
+
+  // Ramps linearly from the current volume to volume over ramp_seconds, or
+  // sets it at once (cancelling any ramp) when ramp_seconds <= 0.
+  bool SetBusVolume(FMOD_STUDIO_SYSTEM* studio_system, const char* path,
+                    float volume, float ramp_seconds);
+  bool SetVcaVolume(FMOD_STUDIO_SYSTEM* studio_system, const char* path,
+                    float volume, float ramp_seconds);
+  bool SetBusMute(FMOD_STUDIO_SYSTEM* studio_system, const char* path,
+                  bool mute);
+  bool SetBusPaused(FMOD_STUDIO_SYSTEM* studio_system, const char* path,
+                    bool paused);
+
+  // Snapshots are started and stopped by path; starting one that is
+  // already active restarts it.
+  bool StartSnapshot(FMOD_STUDIO_SYSTEM* studio_system, const char* path);
+  bool StopSnapshot(const char* path, bool allow_fadeout);
+
+  // Advances volume ramps by elapsed_seconds.
+  void Update(float elapsed_seconds);
+
+  // Stops snapshots and forgets every handle. Call before releasing the
+  // Studio system.
+  void Clear();
+
+  int active_ramp_count() const { return static_cast<int>(ramps_.size()); }
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  struct Ramp {
+    FMOD_STUDIO_BUS* bus;  // exactly one of bus and vca is set
+    FMOD_STUDIO_VCA* vca;
+    float from;
+    float to;
+    double start;  // time_ when the ramp started
+    float seconds;
+  };
+
+  bool SetVolume(FMOD_STUDIO_BUS* bus, FMOD_STUDIO_VCA* vca, float volume,
+                 float ramp_seconds);
+  FMOD_RESULT ApplyVolume(const Ramp& ramp, float volume);
+
+  std::unordered_map<std::string, FMOD_STUDIO_BUS*> buses_;
+  std::unordered_map<std::string, FMOD_STUDIO_VCA*> vcas_;
+  std::unordered_map<std::string, FMOD_STUDIO_EVENTINSTANCE*> snapshots_;
+  // Keyed by the bus or VCA handle.
+  std::map<void*, Ramp> ramps_;
+  // Seconds advanced by Update() so far.
+  double time_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodMixerControl FmodMixerControl;
+
+FmodMixerControl* fmod_mixer_control_create(void);
+void fmod_mixer_control_destroy(FmodMixerControl* mixer);
+void fmod_mixer_control_cache_banks(FmodMixerControl* mixer,
+                                    FMOD_STUDIO_SYSTEM* studio_system);
+FMOD_STUDIO_BUS* fmod_mixer_control_get_bus(FmodMixerControl* mixer,
+                                            FMOD_STUDIO_SYSTEM* studio_system,
+                                            const char* path);
+int fmod_mixer_control_set_bus_volume(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path, float volume,
+                                      float ramp_seconds);
+int fmod_mixer_control_set_vca_volume(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path, float volume,
+                                      float ramp_seconds);
+int fmod_mixer_control_set_bus_mute(FmodMixerControl* mixer,
+                                    FMOD_STUDIO_SYSTEM* studio_system,
+                                    const char* path, int mute);
+int fmod_mixer_control_set_bus_paused(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path, int paused);
+int fmod_mixer_control_start_snapshot(FmodMixerControl* mixer,
+                                      FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* path);
+int fmod_mixer_control_stop_snapshot(FmodMixerControl* mixer,
+                                     const char* path, int allow_fadeout);
+void fmod_mixer_control_update(FmodMixerControl* mixer, float elapsed_seconds);
+void fmod_mixer_control_clear(FmodMixerControl* mixer);
+FMOD_RESULT fmod_mixer_control_last_result(FmodMixerControl* mixer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_MIXER_CONTROL_H_
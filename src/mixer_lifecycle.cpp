@@ -0,0 +1,93 @@
+#include "mixer_lifecycle.h"
+
+#include <chrono>
+
+namespace fmod_flutter {
+
+MixerLifecycle::MixerLifecycle()
+    : reasons_(0), last_resume_ms_(-1.0), last_result_(FMOD_OK) {}
+
+bool MixerLifecycle::Suspend(FMOD_SYSTEM* core_system, int reason) {
+  if (reasons_ != 0) {
+    reasons_ |= reason;
+    last_result_ = FMOD_OK;
+    return true;
+  }
+  last_result_ = FMOD_System_MixerSuspend(core_system);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  reasons_ = reason;
+  return true;
+}
+
+bool MixerLifecycle::Resume(FMOD_SYSTEM* core_system,
+                            FMOD_STUDIO_SYSTEM* studio_system, int reasons) {
+  if (reasons_ == 0 || (reasons_ & ~reasons) != 0) {
+    // Running, or still suspended for another reason.
+    reasons_ &= ~reasons;
+    last_result_ = FMOD_OK;
+    return true;
+  }
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  last_result_ = FMOD_System_MixerResume(core_system);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  reasons_ = 0;
+  // Commands queued while suspended are applied before the next tick would
+  // get to them.
+  FMOD_Studio_System_FlushCommands(studio_system);
+  last_resume_ms_ = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  return true;
+}
+
+void MixerLifecycle::Clear() {
+  reasons_ = 0;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodMixerLifecycle {
+  fmod_flutter::MixerLifecycle lifecycle;
+};
+
+FmodMixerLifecycle* fmod_mixer_lifecycle_create(void) {
+  return new FmodMixerLifecycle();
+}
+
+void fmod_mixer_lifecycle_destroy(FmodMixerLifecycle* lifecycle) {
+  delete lifecycle;
+}
+
+int fmod_mixer_lifecycle_suspend(FmodMixerLifecycle* lifecycle,
+                                 FMOD_SYSTEM* core_system, int reason) {
+  return lifecycle->lifecycle.Suspend(core_system, reason) ? 1 : 0;
+}
+
+int fmod_mixer_lifecycle_resume(FmodMixerLifecycle* lifecycle,
+                                FMOD_SYSTEM* core_system,
+                                FMOD_STUDIO_SYSTEM* studio_system,
+                                int reasons) {
+  return lifecycle->lifecycle.Resume(core_system, studio_system, reasons) ? 1
+                                                                          : 0;
+}
+
+void fmod_mixer_lifecycle_clear(FmodMixerLifecycle* lifecycle) {
+  lifecycle->lifecycle.Clear();
+}
+
+int fmod_mixer_lifecycle_suspended(FmodMixerLifecycle* lifecycle) {
+  return lifecycle->lifecycle.suspended() ? 1 : 0;
+}
+
+double fmod_mixer_lifecycle_last_resume_ms(FmodMixerLifecycle* lifecycle) {
+  return lifecycle->lifecycle.last_resume_ms();
+}
+
+FMOD_RESULT fmod_mixer_lifecycle_last_result(FmodMixerLifecycle* lifecycle) {
+  return lifecycle->lifecycle.last_result();
+}
@@ -0,0 +1,84 @@
+#ifndef FMOD_FLUTTER_MIXER_LIFECYCLE_H_
+#define FMOD_FLUTTER_MIXER_LIFECYCLE_H_
+
+// Mixer suspend and resume for app lifecycle changes, shared by all native
+// bridges.
+//
+// Pausing the master bus silences output but leaves the mixer thread
+// running. When the app is backgrounded or minimized, the bridges stop
+// their update tick and suspend the mixer with System_MixerSuspend, so
+// FMOD uses no CPU until the app returns. Resume times how long the mixer
+// takes to come back with every queued Studio command applied.
+//
+// The mixer can be suspended for several reasons at once, e.g. an audio
+// interruption while backgrounded; it resumes when the last one clears.
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+// Suspend reasons, combinable as a mask.
+#define FMOD_FLUTTER_SUSPEND_LIFECYCLE 1
+#define FMOD_FLUTTER_SUSPEND_INTERRUPTION 2
+#define FMOD_FLUTTER_SUSPEND_ALL 3
+
+#ifdef __cplusplus
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class MixerLifecycle {
+ public:
+  MixerLifecycle();
+
+  // Adds a suspend reason, suspending the mixer if it is running.
+  bool Suspend(FMOD_SYSTEM* core_system, int reason);
+
+  // Clears the given reasons. When none remain, resumes the mixer and
+  // flushes queued Studio commands, so state set while suspended (e.g.
+  // unpausing the master bus) is live on return.
+  bool Resume(FMOD_SYSTEM* core_system, FMOD_STUDIO_SYSTEM* studio_system,
+              int reasons);
+
+  // Forgets the suspended state. Call after releasing the Studio system.
+  void Clear();
+
+  bool suspended() const { return reasons_ != 0; }
+  int reasons() const { return reasons_; }
+  // Duration of the last Resume() that resumed the mixer, in milliseconds,
+  // or a negative value if there has been none.
+  double last_resume_ms() const { return last_resume_ms_; }
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  int reasons_;
+  double last_resume_ms_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodMixerLifecycle FmodMixerLifecycle;
+
+FmodMixerLifecycle* fmod_mixer_lifecycle_create(void);
+void fmod_mixer_lifecycle_destroy(FmodMixerLifecycle* lifecycle);
+int fmod_mixer_lifecycle_suspend(FmodMixerLifecycle* lifecycle,
+                                 FMOD_SYSTEM* core_system, int reason);
+int fmod_mixer_lifecycle_resume(FmodMixerLifecycle* lifecycle,
+                                FMOD_SYSTEM* core_system,
+                                FMOD_STUDIO_SYSTEM* studio_system,
+                                int reasons);
+void fmod_mixer_lifecycle_clear(FmodMixerLifecycle* lifecycle);
+int fmod_mixer_lifecycle_suspended(FmodMixerLifecycle* lifecycle);
+double fmod_mixer_lifecycle_last_resume_ms(FmodMixerLifecycle* lifecycle);
+FMOD_RESULT fmod_mixer_lifecycle_last_result(FmodMixerLifecycle* lifecycle);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_MIXER_LIFECYCLE_H_
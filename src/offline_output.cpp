@@ -0,0 +1,321 @@
+#include "offline_output.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace fmod_flutter {
+
+static const char kMemoryOutputName[] = "fmod_flutter memory";
+
+OfflineOutput::OfflineOutput()
+    : mode_(FMOD_FLUTTER_OUTPUT_DEVICE),
+      sample_rate_(0),
+      channels_(0),
+      block_length_(0),
+      dropped_frames_(0),
+      last_rendered_seconds_(0.0),
+      last_render_ms_(0.0),
+      last_result_(FMOD_OK) {}
+
+bool OfflineOutput::Configure(FMOD_SYSTEM* core_system, int mode,
+                              const char* wav_path) {
+  switch (mode) {
+    case FMOD_FLUTTER_OUTPUT_DEVICE:
+      last_result_ = FMOD_System_SetOutput(core_system,
+                                           FMOD_OUTPUTTYPE_AUTODETECT);
+      break;
+    case FMOD_FLUTTER_OUTPUT_NOSOUND:
+      last_result_ = FMOD_System_SetOutput(core_system,
+                                           FMOD_OUTPUTTYPE_NOSOUND);
+      break;
+    case FMOD_FLUTTER_OUTPUT_NOSOUND_NRT:
+      last_result_ = FMOD_System_SetOutput(core_system,
+                                           FMOD_OUTPUTTYPE_NOSOUND_NRT);
+      break;
+    case FMOD_FLUTTER_OUTPUT_WAVWRITER_NRT:
+      if (wav_path == nullptr || wav_path[0] == '\0') {
+        last_result_ = FMOD_ERR_INVALID_PARAM;
+        return false;
+      }
+      wav_path_ = wav_path;
+      last_result_ = FMOD_System_SetOutput(core_system,
+                                           FMOD_OUTPUTTYPE_WAVWRITER_NRT);
+      break;
+    case FMOD_FLUTTER_OUTPUT_MEMORY_NRT: {
+      static FMOD_OUTPUT_DESCRIPTION description;
+      if (description.apiversion == 0) {
+        description.apiversion = FMOD_OUTPUT_PLUGIN_VERSION;
+        description.name = kMemoryOutputName;
+        description.version = 1;
+        // Mixes only when update is called, i.e. from System::update.
+        description.method = FMOD_OUTPUT_METHOD_MIX_DIRECT;
+        description.getnumdrivers = GetNumDrivers;
+        description.getdriverinfo = GetDriverInfo;
+        description.init = Init;
+        description.close = Close;
+        description.update = Update;
+      }
+      unsigned int handle = 0;
+      last_result_ =
+          FMOD_System_RegisterOutput(core_system, &description, &handle);
+      if (last_result_ == FMOD_OK) {
+        last_result_ = FMOD_System_SetOutputByPlugin(core_system, handle);
+      }
+      break;
+    }
+    default:
+      last_result_ = FMOD_ERR_INVALID_PARAM;
+      return false;
+  }
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  mode_ = mode;
+  ClearCaptured();
+  return true;
+}
+
+bool OfflineOutput::non_realtime() const {
+  return mode_ == FMOD_FLUTTER_OUTPUT_NOSOUND_NRT ||
+         mode_ == FMOD_FLUTTER_OUTPUT_WAVWRITER_NRT ||
+         mode_ == FMOD_FLUTTER_OUTPUT_MEMORY_NRT;
+}
+
+FMOD_STUDIO_INITFLAGS OfflineOutput::studio_init_flags() const {
+  // Studio's own thread would mix on its schedule rather than Render()'s.
+  return non_realtime() ? FMOD_STUDIO_INIT_SYNCHRONOUS_UPDATE
+                        : FMOD_STUDIO_INIT_NORMAL;
+}
+
+FMOD_INITFLAGS OfflineOutput::core_init_flags() const {
+  // Streams decode in step with the mix, so renders are deterministic.
+  return non_realtime()
+             ? FMOD_INIT_STREAM_FROM_UPDATE | FMOD_INIT_MIX_FROM_UPDATE
+             : FMOD_INIT_NORMAL;
+}
+
+void* OfflineOutput::extra_driver_data() {
+  if (mode_ == FMOD_FLUTTER_OUTPUT_WAVWRITER_NRT) {
+    return const_cast<char*>(wav_path_.c_str());
+  }
+  if (mode_ == FMOD_FLUTTER_OUTPUT_MEMORY_NRT) {
+    return this;
+  }
+  return nullptr;
+}
+
+bool OfflineOutput::Render(FMOD_STUDIO_SYSTEM* studio_system,
+                           FMOD_SYSTEM* core_system, float seconds,
+                           FmodRenderBlockCallback on_block, void* context) {
+  if (!non_realtime()) {
+    last_result_ = FMOD_ERR_UNSUPPORTED;
+    return false;
+  }
+  int rate = 0;
+  unsigned int block_length = 0;
+  FMOD_System_GetSoftwareFormat(core_system, &rate, nullptr, nullptr);
+  FMOD_System_GetDSPBufferSize(core_system, &block_length, nullptr);
+  if (rate <= 0 || block_length == 0 || seconds <= 0.0f) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return false;
+  }
+
+  // Each NRT update mixes one block.
+  long long updates = static_cast<long long>(
+      std::ceil(static_cast<double>(seconds) * rate / block_length));
+  float block_seconds = static_cast<float>(block_length) / rate;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (long long i = 0; i < updates; i++) {
+    last_result_ = FMOD_Studio_System_Update(studio_system);
+    if (last_result_ != FMOD_OK) {
+      return false;
+    }
+    if (on_block != nullptr) {
+      on_block(context, block_seconds);
+    }
+  }
+  last_render_ms_ = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  last_rendered_seconds_ =
+      static_cast<double>(updates) * block_length / rate;
+  return true;
+}
+
+void OfflineOutput::ClearCaptured() {
+  captured_.clear();
+  captured_.shrink_to_fit();
+  dropped_frames_ = 0;
+}
+
+void OfflineOutput::Clear() {
+  mode_ = FMOD_FLUTTER_OUTPUT_DEVICE;
+  wav_path_.clear();
+  sample_rate_ = 0;
+  channels_ = 0;
+  block_.clear();
+  ClearCaptured();
+}
+
+FMOD_RESULT F_CALL OfflineOutput::GetNumDrivers(
+    FMOD_OUTPUT_STATE* /*state*/, int* count) {
+  *count = 1;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL OfflineOutput::GetDriverInfo(
+    FMOD_OUTPUT_STATE* /*state*/, int /*id*/, char* name, int name_length,
+    FMOD_GUID* guid, int* rate, FMOD_SPEAKERMODE* speaker_mode,
+    int* channels) {
+  if (name != nullptr && name_length > 0) {
+    std::strncpy(name, kMemoryOutputName, name_length - 1);
+    name[name_length - 1] = '\0';
+  }
+  if (guid != nullptr) {
+    std::memset(guid, 0, sizeof(*guid));
+  }
+  *rate = 48000;
+  *speaker_mode = FMOD_SPEAKERMODE_STEREO;
+  *channels = 2;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL OfflineOutput::Init(
+    FMOD_OUTPUT_STATE* state, int /*driver*/, FMOD_INITFLAGS /*flags*/,
+    int* rate, FMOD_SPEAKERMODE* /*speaker_mode*/, int* channels,
+    FMOD_SOUND_FORMAT* format, int buffer_length, int* /*buffer_count*/,
+    int* /*additional_buffer_count*/, void* extra_driver_data) {
+  OfflineOutput* output = static_cast<OfflineOutput*>(extra_driver_data);
+  if (output == nullptr || *channels <= 0 || buffer_length <= 0) {
+    return FMOD_ERR_INVALID_PARAM;
+  }
+  *format = FMOD_SOUND_FORMAT_PCMFLOAT;
+  output->sample_rate_ = *rate;
+  output->channels_ = *channels;
+  output->block_length_ = buffer_length;
+  output->block_.assign(static_cast<size_t>(buffer_length) * *channels, 0.0f);
+  state->plugindata = output;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL OfflineOutput::Close(FMOD_OUTPUT_STATE* state) {
+  state->plugindata = nullptr;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL OfflineOutput::Update(FMOD_OUTPUT_STATE* state) {
+  OfflineOutput* output = static_cast<OfflineOutput*>(state->plugindata);
+  if (output == nullptr) {
+    return FMOD_OK;
+  }
+  FMOD_RESULT result = FMOD_OUTPUT_READFROMMIXER(
+      state, output->block_.data(), output->block_length_);
+  if (result != FMOD_OK) {
+    return result;
+  }
+  size_t limit = static_cast<size_t>(kMaxCapturedSeconds) *
+                 output->sample_rate_ * output->channels_;
+  if (output->captured_.size() + output->block_.size() > limit) {
+    output->dropped_frames_ += output->block_length_;
+  } else {
+    output->captured_.insert(output->captured_.end(), output->block_.begin(),
+                             output->block_.end());
+  }
+  return FMOD_OK;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodOfflineOutput {
+  fmod_flutter::OfflineOutput output;
+};
+
+FmodOfflineOutput* fmod_offline_output_create(void) {
+  return new FmodOfflineOutput();
+}
+
+void fmod_offline_output_destroy(FmodOfflineOutput* output) {
+  delete output;
+}
+
+int fmod_offline_output_configure(FmodOfflineOutput* output,
+                                  FMOD_SYSTEM* core_system, int mode,
+                                  const char* wav_path) {
+  return output->output.Configure(core_system, mode, wav_path) ? 1 : 0;
+}
+
+FMOD_STUDIO_INITFLAGS fmod_offline_output_studio_init_flags(
+    FmodOfflineOutput* output) {
+  return output->output.studio_init_flags();
+}
+
+FMOD_INITFLAGS fmod_offline_output_core_init_flags(FmodOfflineOutput* output) {
+  return output->output.core_init_flags();
+}
+
+void* fmod_offline_output_extra_driver_data(FmodOfflineOutput* output) {
+  return output->output.extra_driver_data();
+}
+
+int fmod_offline_output_render(FmodOfflineOutput* output,
+                               FMOD_STUDIO_SYSTEM* studio_system,
+                               FMOD_SYSTEM* core_system, float seconds,
+                               FmodRenderBlockCallback on_block,
+                               void* context) {
+  return output->output.Render(studio_system, core_system, seconds, on_block,
+                               context)
+             ? 1
+             : 0;
+}
+
+int fmod_offline_output_take_captured(FmodOfflineOutput* output,
+                                      float* samples, int max_samples) {
+  const std::vector<float>& captured = output->output.captured();
+  int count = static_cast<int>(captured.size());
+  if (count > max_samples) {
+    count = max_samples;
+  }
+  if (count > 0) {
+    std::memcpy(samples, captured.data(), count * sizeof(float));
+  }
+  output->output.ClearCaptured();
+  return count;
+}
+
+int fmod_offline_output_captured_sample_count(FmodOfflineOutput* output) {
+  return static_cast<int>(output->output.captured().size());
+}
+
+void fmod_offline_output_clear(FmodOfflineOutput* output) {
+  output->output.Clear();
+}
+
+int fmod_offline_output_mode(FmodOfflineOutput* output) {
+  return output->output.mode();
+}
+
+int fmod_offline_output_non_realtime(FmodOfflineOutput* output) {
+  return output->output.non_realtime() ? 1 : 0;
+}
+
+int fmod_offline_output_sample_rate(FmodOfflineOutput* output) {
+  return output->output.sample_rate();
+}
+
+int fmod_offline_output_channels(FmodOfflineOutput* output) {
+  return output->output.channels();
+}
+
+double fmod_offline_output_last_rendered_seconds(FmodOfflineOutput* output) {
+  return output->output.last_rendered_seconds();
+}
+
+double fmod_offline_output_last_render_ms(FmodOfflineOutput* output) {
+  return output->output.last_render_ms();
+}
+
+FMOD_RESULT fmod_offline_output_last_result(FmodOfflineOutput* output) {
+  return output->output.last_result();
+}
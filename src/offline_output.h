@@ -0,0 +1,157 @@
+#ifndef FMOD_FLUTTER_OFFLINE_OUTPUT_H_
+#define FMOD_FLUTTER_OFFLINE_OUTPUT_H_
+
+// Output selection for headless and offline rendering, shared by all native
+// bridges and tool/command_replay.
+//
+// By default FMOD mixes in realtime to the autodetected device. The other
+// modes need no audio device; the non-realtime (NRT) ones mix a block only
+// when Studio updates, synchronously on the updating thread, so Render()
+// can mix minutes of audio in a fraction of the time. MEMORY_NRT uses an
+// output plugin that keeps the mix as interleaved floats, e.g. for
+// comparing against golden audio.
+
+#include <fmod.h>
+#include <fmod_output.h>
+#include <fmod_studio.h>
+
+// Output modes.
+//
+// DEVICE         the autodetected audio device, in realtime (default)
+// NOSOUND        no device, mixing in realtime
+// NOSOUND_NRT    no device, mixing one block per Studio update
+// WAVWRITER_NRT  a .wav file, one block per Studio update
+// MEMORY_NRT     an in-memory buffer, one block per Studio update
+#define FMOD_FLUTTER_OUTPUT_DEVICE 0
+#define FMOD_FLUTTER_OUTPUT_NOSOUND 1
+#define FMOD_FLUTTER_OUTPUT_NOSOUND_NRT 2
+#define FMOD_FLUTTER_OUTPUT_WAVWRITER_NRT 3
+#define FMOD_FLUTTER_OUTPUT_MEMORY_NRT 4
+
+// Called by Render() after each block it mixes, with the seconds of audio
+// in the block, so the bridges advance automation and ramps by mixed time
+// rather than wall-clock time.
+typedef void (*FmodRenderBlockCallback)(void* context, float block_seconds);
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock. In NRT modes FMOD mixes on the thread that updates
+// Studio, which must be that thread too.
+class OfflineOutput {
+ public:
+  OfflineOutput();
+
+  // Selects the output on a core system that is not yet initialized.
+  // wav_path is the file written in WAVWRITER_NRT mode.
+  bool Configure(FMOD_SYSTEM* core_system, int mode, const char* wav_path);
+
+  // Flags and extra driver data for FMOD_Studio_System_Initialize.
+  FMOD_STUDIO_INITFLAGS studio_init_flags() const;
+  FMOD_INITFLAGS core_init_flags() const;
+  void* extra_driver_data();
+
+  // Mixes at least seconds of audio as fast as Studio can update, calling
+  // on_block, if set, after each block. Only in NRT modes; the bridges do
+  // not run their update tick in these modes.
+  bool Render(FMOD_STUDIO_SYSTEM* studio_system, FMOD_SYSTEM* core_system,
+              float seconds, FmodRenderBlockCallback on_block,
+              void* context);
+
+  // MEMORY_NRT: the mix since the last ClearCaptured(), interleaved, at
+  // most kMaxCapturedSeconds; later blocks are dropped and counted.
+  const std::vector<float>& captured() const { return captured_; }
+  void ClearCaptured();
+
+  // Restores the default mode. Call after releasing the Studio system.
+  void Clear();
+
+  int mode() const { return mode_; }
+  bool non_realtime() const;
+  int sample_rate() const { return sample_rate_; }
+  int channels() const { return channels_; }
+  long long dropped_frames() const { return dropped_frames_; }
+  // Audio mixed and time taken by the last Render().
+  double last_rendered_seconds() const { return last_rendered_seconds_; }
+  double last_render_ms() const { return last_render_ms_; }
+  FMOD_RESULT last_result() const { return last_result_; }
+
+  static const int kMaxCapturedSeconds = 120;
+
+ private:
+  static FMOD_RESULT F_CALL GetNumDrivers(FMOD_OUTPUT_STATE* state,
+                                          int* count);
+  static FMOD_RESULT F_CALL GetDriverInfo(FMOD_OUTPUT_STATE* state, int id,
+                                          char* name, int name_length,
+                                          FMOD_GUID* guid, int* rate,
+                                          FMOD_SPEAKERMODE* speaker_mode,
+                                          int* channels);
+  static FMOD_RESULT F_CALL Init(FMOD_OUTPUT_STATE* state, int driver,
+                                 FMOD_INITFLAGS flags, int* rate,
+                                 FMOD_SPEAKERMODE* speaker_mode,
+                                 int* channels, FMOD_SOUND_FORMAT* format,
+                                 int buffer_length, int* buffer_count,
+                                 int* additional_buffer_count,
+                                 void* extra_driver_data);
+  static FMOD_RESULT F_CALL Close(FMOD_OUTPUT_STATE* state);
+  static FMOD_RESULT F_CALL Update(FMOD_OUTPUT_STATE* state);
+
+  int mode_;
+  std::string wav_path_;
+  int sample_rate_;
+  int channels_;
+  int block_length_;
+  std::vector<float> block_;
+  std::vector<float> captured_;
+  long long dropped_frames_;
+  double last_rendered_seconds_;
+  double last_render_ms_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodOfflineOutput FmodOfflineOutput;
+
+FmodOfflineOutput* fmod_offline_output_create(void);
+void fmod_offline_output_destroy(FmodOfflineOutput* output);
+int fmod_offline_output_configure(FmodOfflineOutput* output,
+                                  FMOD_SYSTEM* core_system, int mode,
+                                  const char* wav_path);
+FMOD_STUDIO_INITFLAGS fmod_offline_output_studio_init_flags(
+    FmodOfflineOutput* output);
+FMOD_INITFLAGS fmod_offline_output_core_init_flags(FmodOfflineOutput* output);
+void* fmod_offline_output_extra_driver_data(FmodOfflineOutput* output);
+int fmod_offline_output_render(FmodOfflineOutput* output,
+                               FMOD_STUDIO_SYSTEM* studio_system,
+                               FMOD_SYSTEM* core_system, float seconds,
+                               FmodRenderBlockCallback on_block,
+                               void* context);
+// Copies up to max_samples captured samples into samples and clears the
+// capture; returns the number copied.
+int fmod_offline_output_take_captured(FmodOfflineOutput* output,
+                                      float* samples, int max_samples);
+int fmod_offline_output_captured_sample_count(FmodOfflineOutput* output);
+void fmod_offline_output_clear(FmodOfflineOutput* output);
+int fmod_offline_output_mode(FmodOfflineOutput* output);
+int fmod_offline_output_non_realtime(FmodOfflineOutput* output);
+int fmod_offline_output_sample_rate(FmodOfflineOutput* output);
+int fmod_offline_output_channels(FmodOfflineOutput* output);
+double fmod_offline_output_last_rendered_seconds(FmodOfflineOutput* output);
+double fmod_offline_output_last_render_ms(FmodOfflineOutput* output);
+FMOD_RESULT fmod_offline_output_last_result(FmodOfflineOutput* output);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_OFFLINE_OUTPUT_H_
@@ -0,0 +1,372 @@
+#include "parameter_automation.h"
+
+#include <math.h>
+
+namespace fmod_flutter {
+
+// Floats per keyframe: time, value and the Bezier easing x1, y1, x2, y2.
+static const int kKeyframeStride = 6;
+
+static const float kPi = 3.14159265358979f;
+
+// Minimum data_count of each curve type, indexed by type.
+static const int kCurveDataCounts[] = {2, 3, kKeyframeStride, 5, 7};
+
+// Solves a CSS-style cubic-bezier() easing at progress u. The curve runs
+// from (0, 0) to (1, 1); x is solved for u by Newton's method, falling
+// back to bisection where the slope is too flat.
+float CubicBezierEase(const float* handles, float u) {
+  float cx = 3.0f * handles[0];
+  float bx = 3.0f * (handles[2] - handles[0]) - cx;
+  float ax = 1.0f - cx - bx;
+  float cy = 3.0f * handles[1];
+  float by = 3.0f * (handles[3] - handles[1]) - cy;
+  float ay = 1.0f - cy - by;
+
+  float s = u;
+  bool solved = false;
+  for (int i = 0; i < 8; i++) {
+    float x = ((ax * s + bx) * s + cx) * s - u;
+    if (fabsf(x) < 1e-5f) {
+      solved = true;
+      break;
+    }
+    float slope = (3.0f * ax * s + 2.0f * bx) * s + cx;
+    if (fabsf(slope) < 1e-6f) {
+      break;
+    }
+    s -= x / slope;
+  }
+  if (!solved) {
+    float low = 0.0f;
+    float high = 1.0f;
+    s = u;
+    for (int i = 0; i < 32; i++) {
+      float x = ((ax * s + bx) * s + cx) * s;
+      if (fabsf(x - u) < 1e-5f) {
+        break;
+      }
+      if (x < u) {
+        low = s;
+      } else {
+        high = s;
+      }
+      s = 0.5f * (low + high);
+    }
+  }
+  return ((ay * s + by) * s + cy) * s;
+}
+
+// One cycle of waveform at phase in [0, 1), in [-1, 1]. Every waveform
+// starts at 0 (or rises from -1 for the saw) so phase 0 lines up.
+float LfoWave(int waveform, float phase) {
+  switch (waveform) {
+    case FMOD_FLUTTER_LFO_TRIANGLE:
+      if (phase < 0.25f) return 4.0f * phase;
+      if (phase < 0.75f) return 2.0f - 4.0f * phase;
+      return 4.0f * phase - 4.0f;
+    case FMOD_FLUTTER_LFO_SQUARE:
+      return phase < 0.5f ? 1.0f : -1.0f;
+    case FMOD_FLUTTER_LFO_SAW:
+      return 2.0f * phase - 1.0f;
+    default:
+      return sinf(2.0f * kPi * phase);
+  }
+}
+
+ParameterAutomation::ParameterAutomation()
+    : time_(0.0), next_automation_id_(1), last_result_(FMOD_OK) {}
+
+int ParameterAutomation::Add(FMOD_STUDIO_EVENTINSTANCE* instance,
+                             const char* parameter_name, int type,
+                             const float* data, int data_count) {
+  if (type < FMOD_FLUTTER_CURVE_LINEAR || type > FMOD_FLUTTER_CURVE_ADSR ||
+      data == nullptr || data_count < kCurveDataCounts[type] ||
+      (type == FMOD_FLUTTER_CURVE_KEYFRAMES &&
+       data_count % kKeyframeStride != 0)) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return 0;
+  }
+
+  Automation automation;
+  if (!FindParameter(instance, parameter_name, &automation.parameter)) {
+    return 0;
+  }
+  automation.instance = instance;
+  automation.type = type;
+  automation.data.assign(data, data + data_count);
+  automation.from = 0.0f;
+  automation.release_time = -1.0f;
+  automation.release_from = 0.0f;
+  automation.last_value = 0.0f;
+
+  if (type == FMOD_FLUTTER_CURVE_LINEAR ||
+      type == FMOD_FLUTTER_CURVE_EXPONENTIAL) {
+    last_result_ = FMOD_Studio_EventInstance_GetParameterByID(
+        instance, automation.parameter, &automation.from, nullptr);
+    if (last_result_ != FMOD_OK) {
+      return 0;
+    }
+  }
+
+  EraseParameter(instance, automation.parameter);
+
+  automation.start = time_;
+  bool done = false;
+  last_result_ = Apply(automation, &done);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+
+  int automation_id = next_automation_id_++;
+  if (!done) {
+    automations_[automation_id] = automation;
+  }
+  return automation_id;
+}
+
+bool ParameterAutomation::Release(int automation_id) {
+  auto it = automations_.find(automation_id);
+  if (it == automations_.end() || it->second.type != FMOD_FLUTTER_CURVE_ADSR) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return false;
+  }
+  Automation& automation = it->second;
+  if (automation.release_time < 0.0f) {
+    automation.release_time = static_cast<float>(time_ - automation.start);
+    automation.release_from = automation.last_value;
+  }
+  last_result_ = FMOD_OK;
+  return true;
+}
+
+bool ParameterAutomation::Cancel(int automation_id) {
+  return automations_.erase(automation_id) > 0;
+}
+
+void ParameterAutomation::CancelParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                                          const char* parameter_name) {
+  if (automations_.empty()) {
+    return;
+  }
+  FMOD_STUDIO_PARAMETER_ID parameter;
+  if (FindParameter(instance, parameter_name, &parameter)) {
+    EraseParameter(instance, parameter);
+  }
+}
+
+void ParameterAutomation::CancelInstance(
+    FMOD_STUDIO_EVENTINSTANCE* instance) {
+  for (auto it = automations_.begin(); it != automations_.end();) {
+    if (it->second.instance == instance) {
+      it = automations_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ParameterAutomation::Update(float elapsed_seconds) {
+  if (elapsed_seconds > 0.0f) {
+    time_ += elapsed_seconds;
+  }
+  if (automations_.empty()) {
+    return;
+  }
+  for (auto it = automations_.begin(); it != automations_.end();) {
+    bool done = false;
+    // A released instance returns an invalid handle and ends its curves.
+    if (Apply(it->second, &done) != FMOD_OK || done) {
+      it = automations_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ParameterAutomation::Clear() {
+  automations_.clear();
+}
+
+float ParameterAutomation::Evaluate(Automation& automation, float seconds,
+                                    bool* done) {
+  const float* data = automation.data.data();
+  switch (automation.type) {
+    case FMOD_FLUTTER_CURVE_LINEAR:
+    case FMOD_FLUTTER_CURVE_EXPONENTIAL: {
+      float target = data[0];
+      float u = data[1] > 0.0f ? seconds / data[1] : 1.0f;
+      if (u >= 1.0f) {
+        *done = true;
+        return target;
+      }
+      float curvature =
+          automation.type == FMOD_FLUTTER_CURVE_EXPONENTIAL ? data[2] : 0.0f;
+      if (fabsf(curvature) > 1e-4f) {
+        u = (expf(curvature * u) - 1.0f) / (expf(curvature) - 1.0f);
+      }
+      return automation.from + (target - automation.from) * u;
+    }
+
+    case FMOD_FLUTTER_CURVE_KEYFRAMES: {
+      int count = static_cast<int>(automation.data.size()) / kKeyframeStride;
+      if (seconds <= data[0]) {
+        return data[1];
+      }
+      for (int i = 1; i < count; i++) {
+        const float* key = data + i * kKeyframeStride;
+        if (seconds < key[0]) {
+          const float* previous = key - kKeyframeStride;
+          float span = key[0] - previous[0];
+          float u = span > 0.0f ? (seconds - previous[0]) / span : 1.0f;
+          return previous[1] + (key[1] - previous[1]) *
+                                   CubicBezierEase(key + 2, u);
+        }
+      }
+      *done = true;
+      return data[(count - 1) * kKeyframeStride + 1];
+    }
+
+    case FMOD_FLUTTER_CURVE_LFO: {
+      float center = data[2];
+      if (data[4] > 0.0f && seconds >= data[4]) {
+        *done = true;
+        return center;
+      }
+      float phase = seconds * data[1];
+      phase -= floorf(phase);
+      return center + data[3] * LfoWave(static_cast<int>(data[0]), phase);
+    }
+
+    default: {
+      float floor_level = data[0];
+      float peak = data[1];
+      float sustain = data[2];
+      float attack = data[3];
+      float decay = data[4];
+      float release = data[5];
+      float hold = data[6];
+      if (automation.release_time < 0.0f && hold >= 0.0f &&
+          seconds >= attack + decay + hold) {
+        automation.release_time = attack + decay + hold;
+        automation.release_from = sustain;
+      }
+      if (automation.release_time >= 0.0f) {
+        float u = release > 0.0f
+                      ? (seconds - automation.release_time) / release
+                      : 1.0f;
+        if (u >= 1.0f) {
+          *done = true;
+          return floor_level;
+        }
+        return automation.release_from +
+               (floor_level - automation.release_from) * u;
+      }
+      if (seconds < attack) {
+        return floor_level + (peak - floor_level) * seconds / attack;
+      }
+      if (seconds < attack + decay) {
+        return peak + (sustain - peak) * (seconds - attack) / decay;
+      }
+      return sustain;
+    }
+  }
+}
+
+FMOD_RESULT ParameterAutomation::Apply(Automation& automation, bool* done) {
+  float seconds = static_cast<float>(time_ - automation.start);
+  automation.last_value = Evaluate(automation, seconds, done);
+  return FMOD_Studio_EventInstance_SetParameterByID(
+      automation.instance, automation.parameter, automation.last_value, 0);
+}
+
+bool ParameterAutomation::FindParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                                        const char* parameter_name,
+                                        FMOD_STUDIO_PARAMETER_ID* parameter) {
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  last_result_ = FMOD_Studio_EventInstance_GetDescription(instance,
+                                                          &description);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  FMOD_STUDIO_PARAMETER_DESCRIPTION parameter_description;
+  last_result_ = FMOD_Studio_EventDescription_GetParameterDescriptionByName(
+      description, parameter_name, &parameter_description);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  *parameter = parameter_description.id;
+  return true;
+}
+
+void ParameterAutomation::EraseParameter(
+    FMOD_STUDIO_EVENTINSTANCE* instance,
+    const FMOD_STUDIO_PARAMETER_ID& parameter) {
+  for (auto it = automations_.begin(); it != automations_.end(); ++it) {
+    const Automation& automation = it->second;
+    if (automation.instance == instance &&
+        automation.parameter.data1 == parameter.data1 &&
+        automation.parameter.data2 == parameter.data2) {
+      // Only one curve drives a parameter at a time.
+      automations_.erase(it);
+      return;
+    }
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodParameterAutomation {
+  fmod_flutter::ParameterAutomation automation;
+};
+
+FmodParameterAutomation* fmod_parameter_automation_create(void) {
+  return new FmodParameterAutomation();
+}
+
+void fmod_parameter_automation_destroy(FmodParameterAutomation* automation) {
+  delete automation;
+}
+
+int fmod_parameter_automation_add(FmodParameterAutomation* automation,
+                                  FMOD_STUDIO_EVENTINSTANCE* instance,
+                                  const char* parameter_name, int type,
+                                  const float* data, int data_count) {
+  return automation->automation.Add(instance, parameter_name, type, data,
+                                    data_count);
+}
+
+int fmod_parameter_automation_release(FmodParameterAutomation* automation,
+                                      int automation_id) {
+  return automation->automation.Release(automation_id) ? 1 : 0;
+}
+
+int fmod_parameter_automation_cancel(FmodParameterAutomation* automation,
+                                     int automation_id) {
+  return automation->automation.Cancel(automation_id) ? 1 : 0;
+}
+
+void fmod_parameter_automation_cancel_parameter(
+    FmodParameterAutomation* automation, FMOD_STUDIO_EVENTINSTANCE* instance,
+    const char* parameter_name) {
+  automation->automation.CancelParameter(instance, parameter_name);
+}
+
+void fmod_parameter_automation_cancel_instance(
+    FmodParameterAutomation* automation, FMOD_STUDIO_EVENTINSTANCE* instance) {
+  automation->automation.CancelInstance(instance);
+}
+
+void fmod_parameter_automation_update(FmodParameterAutomation* automation,
+                                      float elapsed_seconds) {
+  automation->automation.Update(elapsed_seconds);
+}
+
+void fmod_parameter_automation_clear(FmodParameterAutomation* automation) {
+  automation->automation.Clear();
+}
+
+FMOD_RESULT fmod_parameter_automation_last_result(
+    FmodParameterAutomation* automation) {
+  return automation->automation.last_result();
+}
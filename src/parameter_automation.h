@@ -0,0 +1,158 @@
+#ifndef FMOD_FLUTTER_PARAMETER_AUTOMATION_H_
+#define FMOD_FLUTTER_PARAMETER_AUTOMATION_H_
+
+// Parameter automation curves shared by all native bridges.
+//
+// Dart submits a curve once against an event instance parameter; Update(),
+// called from the bridge's update tick, evaluates every active curve and
+// applies it with SetParameterByID. A fade or modulation is one call from
+// Dart instead of one setParameter call per frame.
+//
+// Curves run on their own clock, advanced by the seconds passed to
+// Update(): wall-clock time from the realtime tick, mixed time from an
+// offline render, so rendered automation is deterministic.
+
+#include <fmod_studio.h>
+
+// Curve types and the layout of their data, in seconds where timed.
+//
+// LINEAR       {target, duration} from the parameter's current value.
+// EXPONENTIAL  {target, duration, curvature} from the current value, shaped
+//              by (e^(k*u) - 1) / (e^k - 1); k > 0 starts slowly, k < 0
+//              starts quickly and k = 0 is linear.
+// KEYFRAMES    {time, value, x1, y1, x2, y2} per keyframe, times ascending
+//              from the start. Each segment eases into its end keyframe
+//              with a cubic Bezier (x1, y1), (x2, y2) as in CSS
+//              cubic-bezier(); the first keyframe's easing is unused.
+// LFO          {waveform, rate_hz, center, depth, duration}; waveform is
+//              one of FMOD_FLUTTER_LFO_*. Runs until cancelled when
+//              duration <= 0, then returns to center.
+// ADSR         {floor, peak, sustain, attack, decay, release, hold}. Holds
+//              the sustain level for hold seconds, or until released when
+//              hold < 0, then releases to floor.
+#define FMOD_FLUTTER_CURVE_LINEAR 0
+#define FMOD_FLUTTER_CURVE_EXPONENTIAL 1
+#define FMOD_FLUTTER_CURVE_KEYFRAMES 2
+#define FMOD_FLUTTER_CURVE_LFO 3
+#define FMOD_FLUTTER_CURVE_ADSR 4
+
+#define FMOD_FLUTTER_LFO_SINE 0
+#define FMOD_FLUTTER_LFO_TRIANGLE 1
+#define FMOD_FLUTTER_LFO_SQUARE 2
+#define FMOD_FLUTTER_LFO_SAW 3
+
+#ifdef __cplusplus
+
+#include <map>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Solves a CSS cubic-bezier() easing with handles {x1, y1, x2, y2} at
+// progress u in [0, 1], as KEYFRAMES segments do.
+float CubicBezierEase(const float* handles, float u);
+
+// One cycle of an FMOD_FLUTTER_LFO_* waveform at phase in [0, 1), in
+// [-1, 1], as LFO curves use.
+float LfoWave(int waveform, float phase);
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class ParameterAutomation {
+ public:
+  ParameterAutomation();
+
+  // Starts a curve on a parameter of an instance, replacing any curve
+  // already driving it, and applies its first value. Returns the
+  // automation id, or 0 on failure; see last_result().
+  int Add(FMOD_STUDIO_EVENTINSTANCE* instance, const char* parameter_name,
+          int type, const float* data, int data_count);
+
+  // Moves an ADSR curve into its release stage.
+  bool Release(int automation_id);
+
+  // Stops a curve, leaving the parameter at its last value.
+  bool Cancel(int automation_id);
+
+  // Stops any curve driving the named parameter, e.g. when it is set
+  // directly.
+  void CancelParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                       const char* parameter_name);
+
+  // Stops every curve on an instance, e.g. before it is reused.
+  void CancelInstance(FMOD_STUDIO_EVENTINSTANCE* instance);
+
+  // Advances the curves by elapsed_seconds, then evaluates and applies
+  // every curve. Finished curves, and curves whose instance has been
+  // released, are removed.
+  void Update(float elapsed_seconds);
+
+  void Clear();
+
+  int active_count() const { return static_cast<int>(automations_.size()); }
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  struct Automation {
+    FMOD_STUDIO_EVENTINSTANCE* instance;
+    FMOD_STUDIO_PARAMETER_ID parameter;
+    int type;
+    std::vector<float> data;
+    float from;  // value when the curve started, for LINEAR and EXPONENTIAL
+    double start;  // time_ when the curve started
+    // ADSR release stage; release_time < 0 until released.
+    float release_time;
+    float release_from;
+    float last_value;
+  };
+
+  // The curve's value seconds after its start; sets *done at its end.
+  static float Evaluate(Automation& automation, float seconds, bool* done);
+  FMOD_RESULT Apply(Automation& automation, bool* done);
+  bool FindParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                     const char* parameter_name,
+                     FMOD_STUDIO_PARAMETER_ID* parameter);
+  void EraseParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                      const FMOD_STUDIO_PARAMETER_ID& parameter);
+
+  std::map<int, Automation> automations_;
+  // Seconds advanced by Update() so far.
+  double time_;
+  int next_automation_id_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodParameterAutomation FmodParameterAutomation;
+
+FmodParameterAutomation* fmod_parameter_automation_create(void);
+void fmod_parameter_automation_destroy(FmodParameterAutomation* automation);
+int fmod_parameter_automation_add(FmodParameterAutomation* automation,
+                                  FMOD_STUDIO_EVENTINSTANCE* instance,
+                                  const char* parameter_name, int type,
+                                  const float* data, int data_count);
+int fmod_parameter_automation_release(FmodParameterAutomation* automation,
+                                      int automation_id);
+int fmod_parameter_automation_cancel(FmodParameterAutomation* automation,
+                                     int automation_id);
+void fmod_parameter_automation_cancel_parameter(
+    FmodParameterAutomation* automation, FMOD_STUDIO_EVENTINSTANCE* instance,
+    const char* parameter_name);
+void fmod_parameter_automation_cancel_instance(
+    FmodParameterAutomation* automation, FMOD_STUDIO_EVENTINSTANCE* instance);
+void fmod_parameter_automation_update(FmodParameterAutomation* automation,
+                                      float elapsed_seconds);
+void fmod_parameter_automation_clear(FmodParameterAutomation* automation);
+FMOD_RESULT fmod_parameter_automation_last_result(
+    FmodParameterAutomation* automation);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_PARAMETER_AUTOMATION_H_
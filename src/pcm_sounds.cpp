@@ -0,0 +1,268 @@
+#include "pcm_sounds.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+
+#include "event_lookup.h"
+#include "voice_stats.h"
+
+namespace fmod_flutter {
+
+struct PcmBuffer {
+  uint8_t* data;
+  uint32_t size;
+  int references;
+};
+
+// The per-instance state of a programmer sound event, passed as the
+// instance's user data.
+struct ProgrammerSoundBinding {
+  FMOD_SYSTEM* core_system;
+  int32_t buffer_id;
+  PcmFormat format;
+};
+
+// Buffers are created and dropped from Dart's thread, and retained and
+// released from the platform thread and FMOD's Studio thread.
+static std::mutex& BufferMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::map<int32_t, PcmBuffer>& Buffers() {
+  static std::map<int32_t, PcmBuffer> buffers;
+  return buffers;
+}
+
+static int32_t next_buffer_id = 1;
+
+static bool RetainBuffer(int32_t buffer_id, uint8_t** data, uint32_t* size) {
+  std::lock_guard<std::mutex> lock(BufferMutex());
+  std::map<int32_t, PcmBuffer>::iterator it = Buffers().find(buffer_id);
+  if (it == Buffers().end()) {
+    return false;
+  }
+  it->second.references++;
+  if (data != nullptr) {
+    *data = it->second.data;
+  }
+  if (size != nullptr) {
+    *size = it->second.size;
+  }
+  return true;
+}
+
+static void ReleaseBuffer(int32_t buffer_id) {
+  uint8_t* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(BufferMutex());
+    std::map<int32_t, PcmBuffer>::iterator it = Buffers().find(buffer_id);
+    if (it == Buffers().end() || --it->second.references > 0) {
+      return;
+    }
+    data = it->second.data;
+    Buffers().erase(it);
+  }
+  delete[] data;
+}
+
+static int PcmFrameBytes(const PcmFormat& format) {
+  if (format.sample_rate <= 0 || format.channels <= 0 ||
+      format.channels > FMOD_MAX_CHANNEL_WIDTH) {
+    return 0;
+  }
+  switch (format.format) {
+    case FMOD_FLUTTER_PCM_16:
+      return format.channels * 2;
+    case FMOD_FLUTTER_PCM_FLOAT:
+      return format.channels * 4;
+    default:
+      return 0;
+  }
+}
+
+FMOD_RESULT CreatePcmSound(FMOD_SYSTEM* core_system, int32_t buffer_id,
+                           const PcmFormat& format, FMOD_MODE mode,
+                           FMOD_SOUND** sound) {
+  int frame_bytes = PcmFrameBytes(format);
+  if (frame_bytes == 0) {
+    return FMOD_ERR_INVALID_PARAM;
+  }
+  uint8_t* data = nullptr;
+  uint32_t size = 0;
+  if (!RetainBuffer(buffer_id, &data, &size)) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  // A trailing partial frame is left out.
+  uint32_t length = size - size % frame_bytes;
+  if (length == 0) {
+    ReleaseBuffer(buffer_id);
+    return FMOD_ERR_INVALID_PARAM;
+  }
+
+  FMOD_CREATESOUNDEXINFO exinfo;
+  std::memset(&exinfo, 0, sizeof(exinfo));
+  exinfo.cbsize = sizeof(exinfo);
+  exinfo.length = length;
+  exinfo.numchannels = format.channels;
+  exinfo.defaultfrequency = format.sample_rate;
+  exinfo.format = format.format == FMOD_FLUTTER_PCM_16
+                      ? FMOD_SOUND_FORMAT_PCM16
+                      : FMOD_SOUND_FORMAT_PCMFLOAT;
+  // With OPENMEMORY_POINT, a PCM sample plays from data itself.
+  FMOD_RESULT result = FMOD_System_CreateSound(
+      core_system, reinterpret_cast<const char*>(data),
+      mode | FMOD_OPENMEMORY_POINT | FMOD_OPENRAW, &exinfo, sound);
+  if (result != FMOD_OK) {
+    ReleaseBuffer(buffer_id);
+    return result;
+  }
+  FMOD_Sound_SetUserData(*sound,
+                         reinterpret_cast<void*>(
+                             static_cast<intptr_t>(buffer_id)));
+  return FMOD_OK;
+}
+
+FMOD_RESULT ReleasePcmSound(FMOD_SOUND* sound) {
+  void* user_data = nullptr;
+  FMOD_Sound_GetUserData(sound, &user_data);
+  FMOD_RESULT result = FMOD_Sound_Release(sound);
+  // A sound that failed to release may still be reading the buffer.
+  if (result == FMOD_OK && user_data != nullptr) {
+    ReleaseBuffer(
+        static_cast<int32_t>(reinterpret_cast<intptr_t>(user_data)));
+  }
+  return result;
+}
+
+// Called on FMOD's Studio thread.
+static FMOD_RESULT F_CALL ProgrammerSoundCallback(
+    FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event,
+    void* parameters) {
+  if ((type & FMOD_FLUTTER_VOICE_STATS_CALLBACKS) != 0) {
+    return VoiceStats::EventCallback(type, event, parameters);
+  }
+  void* user_data = nullptr;
+  FMOD_Studio_EventInstance_GetUserData(event, &user_data);
+  ProgrammerSoundBinding* binding =
+      static_cast<ProgrammerSoundBinding*>(user_data);
+  if (binding == nullptr) {
+    return FMOD_OK;
+  }
+
+  if (type == FMOD_STUDIO_EVENT_CALLBACK_CREATE_PROGRAMMER_SOUND) {
+    FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES* properties =
+        static_cast<FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES*>(parameters);
+    // Looping instruments loop the sound; others play it once.
+    FMOD_SOUND* sound = nullptr;
+    FMOD_RESULT result =
+        CreatePcmSound(binding->core_system, binding->buffer_id,
+                       binding->format, FMOD_CREATESAMPLE | FMOD_LOOP_NORMAL,
+                       &sound);
+    if (result != FMOD_OK) {
+      return result;
+    }
+    properties->sound = sound;
+    properties->subsoundIndex = -1;
+  } else if (type == FMOD_STUDIO_EVENT_CALLBACK_DESTROY_PROGRAMMER_SOUND) {
+    FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES* properties =
+        static_cast<FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES*>(parameters);
+    ReleasePcmSound(properties->sound);
+  } else if (type == FMOD_STUDIO_EVENT_CALLBACK_DESTROYED) {
+    FMOD_Studio_EventInstance_SetUserData(event, nullptr);
+    ReleaseBuffer(binding->buffer_id);
+    delete binding;
+  }
+  return FMOD_OK;
+}
+
+FMOD_RESULT StartProgrammerSoundEvent(FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* event_path,
+                                      int32_t buffer_id,
+                                      const PcmFormat& format) {
+  // Checked here, as a failure in the callback only silences the
+  // instrument.
+  if (PcmFrameBytes(format) == 0) {
+    return FMOD_ERR_INVALID_PARAM;
+  }
+  FMOD_SYSTEM* core_system = nullptr;
+  FMOD_RESULT result =
+      FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (result != FMOD_OK) {
+    return result;
+  }
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  result = GetEvent(studio_system, event_path, &description);
+  if (result != FMOD_OK) {
+    return result;
+  }
+  if (!RetainBuffer(buffer_id, nullptr, nullptr)) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+
+  FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
+  result = FMOD_Studio_EventDescription_CreateInstance(description, &instance);
+  if (result != FMOD_OK) {
+    ReleaseBuffer(buffer_id);
+    return result;
+  }
+  ProgrammerSoundBinding* binding =
+      new ProgrammerSoundBinding{core_system, buffer_id, format};
+  FMOD_Studio_EventInstance_SetUserData(instance, binding);
+  result = FMOD_Studio_EventInstance_SetCallback(
+      instance, ProgrammerSoundCallback,
+      FMOD_STUDIO_EVENT_CALLBACK_CREATE_PROGRAMMER_SOUND |
+          FMOD_STUDIO_EVENT_CALLBACK_DESTROY_PROGRAMMER_SOUND |
+          FMOD_STUDIO_EVENT_CALLBACK_DESTROYED |
+          FMOD_FLUTTER_VOICE_STATS_CALLBACKS);
+  if (result != FMOD_OK) {
+    FMOD_Studio_EventInstance_SetUserData(instance, nullptr);
+    FMOD_Studio_EventInstance_Release(instance);
+    ReleaseBuffer(buffer_id);
+    delete binding;
+    return result;
+  }
+  result = FMOD_Studio_EventInstance_Start(instance);
+  // Destroyed once it stops; the DESTROYED callback drops the binding.
+  FMOD_Studio_EventInstance_Release(instance);
+  return result;
+}
+
+}  // namespace fmod_flutter
+
+FMOD_RESULT fmod_pcm_sounds_start_programmer_event(
+    FMOD_STUDIO_SYSTEM* studio_system, const char* event_path,
+    int32_t buffer_id, int sample_rate, int channels, int format) {
+  fmod_flutter::PcmFormat pcm_format = {sample_rate, channels, format};
+  return fmod_flutter::StartProgrammerSoundEvent(studio_system, event_path,
+                                                 buffer_id, pcm_format);
+}
+
+int32_t fmod_flutter_pcm_buffer_create(int32_t size) {
+  if (size <= 0) {
+    return 0;
+  }
+  uint8_t* data = new (std::nothrow) uint8_t[size]();
+  if (data == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(fmod_flutter::BufferMutex());
+  int32_t buffer_id = fmod_flutter::next_buffer_id++;
+  fmod_flutter::PcmBuffer buffer = {data, static_cast<uint32_t>(size), 1};
+  fmod_flutter::Buffers()[buffer_id] = buffer;
+  return buffer_id;
+}
+
+uint8_t* fmod_flutter_pcm_buffer_data(int32_t buffer_id) {
+  std::lock_guard<std::mutex> lock(fmod_flutter::BufferMutex());
+  std::map<int32_t, fmod_flutter::PcmBuffer>::iterator it =
+      fmod_flutter::Buffers().find(buffer_id);
+  return it == fmod_flutter::Buffers().end() ? nullptr : it->second.data;
+}
+
+void fmod_flutter_pcm_buffer_release(void* token) {
+  fmod_flutter::ReleaseBuffer(
+      static_cast<int32_t>(reinterpret_cast<intptr_t>(token)));
+}
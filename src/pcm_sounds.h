@@ -0,0 +1,78 @@
+#ifndef FMOD_FLUTTER_PCM_SOUNDS_H_
+#define FMOD_FLUTTER_PCM_SOUNDS_H_
+
+// Sounds over raw PCM that Dart writes straight into native memory, e.g.
+// generated speech or procedural tones.
+//
+// Dart allocates a buffer through dart:ffi and fills the returned memory in
+// place. The bridges then create sounds over that same memory with
+// FMOD_OPENMEMORY_POINT | FMOD_OPENRAW, so nothing is copied on the way to
+// the mixer. Buffers are reference counted: the Dart view holds one
+// reference, dropped by its finalizer, and every sound created over the
+// buffer holds another until the sound is released. The memory is freed
+// when the last of them goes.
+
+#include <stdint.h>
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+#include "fmod_flutter_export.h"
+
+// Sample formats, matching FmodPcmFormat in Dart. Samples are interleaved.
+#define FMOD_FLUTTER_PCM_16 0
+#define FMOD_FLUTTER_PCM_FLOAT 1
+
+#ifdef __cplusplus
+
+namespace fmod_flutter {
+
+struct PcmFormat {
+  int sample_rate;
+  int channels;
+  int format;  // FMOD_FLUTTER_PCM_*
+};
+
+// Creates a sound over the whole of buffer_id's memory, holding a
+// reference to the buffer until ReleasePcmSound. Safe on any thread.
+FMOD_RESULT CreatePcmSound(FMOD_SYSTEM* core_system, int32_t buffer_id,
+                           const PcmFormat& format, FMOD_MODE mode,
+                           FMOD_SOUND** sound);
+
+// Releases a sound, and if CreatePcmSound made it, its buffer reference.
+FMOD_RESULT ReleasePcmSound(FMOD_SOUND* sound);
+
+// Starts a one-shot instance of event_path. Each of its programmer
+// instruments plays a sound over buffer_id's memory, created in the
+// CREATE_PROGRAMMER_SOUND callback and released in
+// DESTROY_PROGRAMMER_SOUND. The instance keeps the buffer until it is
+// destroyed, so Dart may drop its view straight away.
+FMOD_RESULT StartProgrammerSoundEvent(FMOD_STUDIO_SYSTEM* studio_system,
+                                      const char* event_path,
+                                      int32_t buffer_id,
+                                      const PcmFormat& format);
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+FMOD_RESULT fmod_pcm_sounds_start_programmer_event(
+    FMOD_STUDIO_SYSTEM* studio_system, const char* event_path,
+    int32_t buffer_id, int sample_rate, int channels, int format);
+
+// Looked up from Dart. Allocates a zeroed buffer of size bytes holding one
+// reference for the caller. Returns its id, or 0 on failure.
+FMOD_FLUTTER_EXPORT int32_t fmod_flutter_pcm_buffer_create(int32_t size);
+// The buffer's memory, or NULL for an unknown id. The memory never moves.
+FMOD_FLUTTER_EXPORT uint8_t* fmod_flutter_pcm_buffer_data(int32_t buffer_id);
+// Drops the caller's reference. token is the buffer id cast to a pointer,
+// so this can be the native finalizer of the Dart view.
+FMOD_FLUTTER_EXPORT void fmod_flutter_pcm_buffer_release(void* token);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_PCM_SOUNDS_H_
@@ -0,0 +1,302 @@
+#include "pcm_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace fmod_flutter {
+
+namespace {
+
+// A writer announces itself in writers before loading stream, and Destroy
+// clears stream before waiting for writers to drain, so a stream is never
+// deleted under a write.
+struct PcmStreamSlot {
+  std::atomic<PcmStream*> stream;
+  std::atomic<int> writers;
+  int32_t stream_id;  // written before stream is published
+};
+
+}  // namespace
+
+static PcmStreamSlot slots[FMOD_FLUTTER_MAX_PCM_STREAMS];
+
+// Ids carry a serial number above the slot index, so a stale id does not
+// reach a newer stream in the same slot.
+static int32_t next_stream_serial = 0;
+
+static int SlotOf(int32_t stream_id) {
+  return (stream_id - 1) % FMOD_FLUTTER_MAX_PCM_STREAMS;
+}
+
+static uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+PcmStream::PcmStream(int sample_rate, int channels, uint32_t capacity_frames)
+    : sample_rate_(sample_rate),
+      channels_(channels),
+      // 20 ms: FMOD's stream thread refills every 10 ms.
+      decode_frames_(std::max<uint32_t>(256, sample_rate / 50)),
+      // Room for at least two refills.
+      capacity_frames_(RoundUpToPowerOfTwo(
+          std::max<uint32_t>(capacity_frames, decode_frames_ * 2))),
+      ring_(static_cast<size_t>(capacity_frames_) * channels, 0.0f),
+      write_frame_(0),
+      read_frame_(0),
+      primed_(false),
+      underruns_(0),
+      underrun_frames_(0),
+      dropped_frames_(0),
+      core_system_(nullptr),
+      sound_(nullptr) {}
+
+PcmStream::~PcmStream() {
+  // Stops the channel and waits for the stream thread to leave Read().
+  if (sound_ != nullptr) {
+    FMOD_Sound_Release(sound_);
+  }
+}
+
+FMOD_RESULT PcmStream::Start(FMOD_SYSTEM* core_system) {
+  FMOD_CREATESOUNDEXINFO exinfo;
+  std::memset(&exinfo, 0, sizeof(exinfo));
+  exinfo.cbsize = sizeof(exinfo);
+  exinfo.numchannels = channels_;
+  exinfo.defaultfrequency = sample_rate_;
+  exinfo.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+  exinfo.decodebuffersize = decode_frames_;
+  // Endless: one second, looped, read from the ring on every pass.
+  exinfo.length = static_cast<unsigned int>(sample_rate_) * channels_ *
+                  sizeof(float);
+  exinfo.pcmreadcallback = ReadCallback;
+  exinfo.userdata = this;
+  FMOD_RESULT result = FMOD_System_CreateSound(
+      core_system, nullptr,
+      FMOD_OPENUSER | FMOD_CREATESTREAM | FMOD_LOOP_NORMAL | FMOD_2D,
+      &exinfo, &sound_);
+  if (result != FMOD_OK) {
+    sound_ = nullptr;
+    return result;
+  }
+  core_system_ = core_system;
+  return FMOD_System_PlaySound(core_system, sound_, nullptr, 0, nullptr);
+}
+
+uint32_t PcmStream::Write(const float* samples, uint32_t frames) {
+  uint32_t write = write_frame_.load(std::memory_order_relaxed);
+  uint32_t read = read_frame_.load(std::memory_order_acquire);
+  uint32_t count = std::min(frames, capacity_frames_ - (write - read));
+  uint32_t start = write & (capacity_frames_ - 1);
+  uint32_t first = std::min(count, capacity_frames_ - start);
+  std::memcpy(&ring_[static_cast<size_t>(start) * channels_], samples,
+              static_cast<size_t>(first) * channels_ * sizeof(float));
+  std::memcpy(ring_.data(), samples + static_cast<size_t>(first) * channels_,
+              static_cast<size_t>(count - first) * channels_ * sizeof(float));
+  write_frame_.store(write + count, std::memory_order_release);
+
+  primed_.store(true, std::memory_order_relaxed);
+  if (count < frames) {
+    dropped_frames_.fetch_add(frames - count, std::memory_order_relaxed);
+  }
+  return count;
+}
+
+void PcmStream::Read(float* out, uint32_t frames) {
+  uint32_t read = read_frame_.load(std::memory_order_relaxed);
+  uint32_t write = write_frame_.load(std::memory_order_acquire);
+  uint32_t count = std::min(frames, write - read);
+  uint32_t start = read & (capacity_frames_ - 1);
+  uint32_t first = std::min(count, capacity_frames_ - start);
+  std::memcpy(out, &ring_[static_cast<size_t>(start) * channels_],
+              static_cast<size_t>(first) * channels_ * sizeof(float));
+  std::memcpy(out + static_cast<size_t>(first) * channels_, ring_.data(),
+              static_cast<size_t>(count - first) * channels_ * sizeof(float));
+  read_frame_.store(read + count, std::memory_order_release);
+
+  if (count < frames) {
+    std::fill_n(out + static_cast<size_t>(count) * channels_,
+                static_cast<size_t>(frames - count) * channels_, 0.0f);
+    // Silence before the first write is the stream starting, not a gap.
+    if (primed_.load(std::memory_order_relaxed)) {
+      underruns_.fetch_add(1, std::memory_order_relaxed);
+      underrun_frames_.fetch_add(frames - count, std::memory_order_relaxed);
+    }
+  }
+}
+
+FMOD_RESULT F_CALL PcmStream::ReadCallback(FMOD_SOUND* sound, void* data,
+                                           unsigned int length) {
+  void* user_data = nullptr;
+  FMOD_Sound_GetUserData(sound, &user_data);
+  PcmStream* stream = static_cast<PcmStream*>(user_data);
+  if (stream == nullptr) {
+    std::memset(data, 0, length);
+    return FMOD_OK;
+  }
+  stream->Read(static_cast<float*>(data),
+               length / (sizeof(float) * stream->channels_));
+  return FMOD_OK;
+}
+
+void PcmStream::GetStats(FmodPcmStreamStats* stats) const {
+  uint32_t queued = write_frame_.load(std::memory_order_acquire) -
+                    read_frame_.load(std::memory_order_acquire);
+  stats->sample_rate = sample_rate_;
+  stats->channels = channels_;
+  stats->capacity_frames = static_cast<int32_t>(capacity_frames_);
+  stats->queued_frames = static_cast<int32_t>(queued);
+  stats->underruns = underruns_.load(std::memory_order_relaxed);
+  stats->underrun_frames = underrun_frames_.load(std::memory_order_relaxed);
+  stats->dropped_frames = dropped_frames_.load(std::memory_order_relaxed);
+
+  // The decode buffer is counted full, so this is an upper bound.
+  double latency_seconds =
+      static_cast<double>(queued + decode_frames_) / sample_rate_;
+  unsigned int buffer_length = 0;
+  int buffer_count = 0;
+  int output_rate = 0;
+  if (core_system_ != nullptr &&
+      FMOD_System_GetDSPBufferSize(core_system_, &buffer_length,
+                                   &buffer_count) == FMOD_OK &&
+      FMOD_System_GetSoftwareFormat(core_system_, &output_rate, nullptr,
+                                    nullptr) == FMOD_OK &&
+      output_rate > 0) {
+    latency_seconds +=
+        static_cast<double>(buffer_length) * buffer_count / output_rate;
+  }
+  stats->latency_us = static_cast<int64_t>(latency_seconds * 1e6);
+}
+
+PcmStreams::PcmStreams() : last_result_(FMOD_OK) {}
+
+int PcmStreams::Create(FMOD_STUDIO_SYSTEM* studio_system, int sample_rate,
+                       int channels, int capacity_ms) {
+  if (sample_rate <= 0 || channels <= 0 ||
+      channels > FMOD_MAX_CHANNEL_WIDTH || capacity_ms <= 0) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return 0;
+  }
+  FMOD_SYSTEM* core_system = nullptr;
+  last_result_ = FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  int slot = -1;
+  for (int i = 0; i < FMOD_FLUTTER_MAX_PCM_STREAMS; i++) {
+    if (slots[i].stream.load() == nullptr) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0) {
+    last_result_ = FMOD_ERR_MEMORY;
+    return 0;
+  }
+
+  uint32_t capacity_frames = static_cast<uint32_t>(
+      static_cast<int64_t>(sample_rate) * capacity_ms / 1000);
+  PcmStream* stream = new PcmStream(sample_rate, channels, capacity_frames);
+  last_result_ = stream->Start(core_system);
+  if (last_result_ != FMOD_OK) {
+    delete stream;
+    return 0;
+  }
+  int32_t serial = next_stream_serial++;
+  if (next_stream_serial > INT32_MAX / FMOD_FLUTTER_MAX_PCM_STREAMS - 1) {
+    next_stream_serial = 0;
+  }
+  int32_t stream_id = serial * FMOD_FLUTTER_MAX_PCM_STREAMS + slot + 1;
+  slots[slot].stream_id = stream_id;
+  slots[slot].stream.store(stream);
+  stream_ids_.insert(stream_id);
+  return stream_id;
+}
+
+bool PcmStreams::Destroy(int stream_id) {
+  if (stream_ids_.erase(stream_id) == 0) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  PcmStreamSlot& slot = slots[SlotOf(stream_id)];
+  PcmStream* stream = slot.stream.exchange(nullptr);
+  while (slot.writers.load() != 0) {
+    std::this_thread::yield();
+  }
+  delete stream;
+  last_result_ = FMOD_OK;
+  return true;
+}
+
+bool PcmStreams::GetStats(int stream_id,
+                          FmodPcmStreamStats* stats) const {
+  if (stream_ids_.count(stream_id) == 0) {
+    return false;
+  }
+  slots[SlotOf(stream_id)].stream.load()->GetStats(stats);
+  return true;
+}
+
+void PcmStreams::Clear() {
+  while (!stream_ids_.empty()) {
+    Destroy(*stream_ids_.begin());
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodPcmStreams {
+  fmod_flutter::PcmStreams streams;
+};
+
+FmodPcmStreams* fmod_pcm_streams_create(void) { return new FmodPcmStreams(); }
+
+void fmod_pcm_streams_destroy(FmodPcmStreams* streams) { delete streams; }
+
+int fmod_pcm_streams_create_stream(FmodPcmStreams* streams,
+                                   FMOD_STUDIO_SYSTEM* studio_system,
+                                   int sample_rate, int channels,
+                                   int capacity_ms) {
+  return streams->streams.Create(studio_system, sample_rate, channels,
+                                 capacity_ms);
+}
+
+int fmod_pcm_streams_destroy_stream(FmodPcmStreams* streams, int stream_id) {
+  return streams->streams.Destroy(stream_id) ? 1 : 0;
+}
+
+int fmod_pcm_streams_get_stats(FmodPcmStreams* streams, int stream_id,
+                               FmodPcmStreamStats* stats) {
+  return streams->streams.GetStats(stream_id, stats) ? 1 : 0;
+}
+
+void fmod_pcm_streams_clear(FmodPcmStreams* streams) {
+  streams->streams.Clear();
+}
+
+FMOD_RESULT fmod_pcm_streams_last_result(FmodPcmStreams* streams) {
+  return streams->streams.last_result();
+}
+
+int32_t fmod_flutter_pcm_stream_write(int32_t stream_id, const float* samples,
+                                      int32_t count) {
+  if (stream_id <= 0 || count < 0) {
+    return -1;
+  }
+  fmod_flutter::PcmStreamSlot& slot =
+      fmod_flutter::slots[fmod_flutter::SlotOf(stream_id)];
+  slot.writers.fetch_add(1);
+  fmod_flutter::PcmStream* stream = slot.stream.load();
+  int32_t written = -1;
+  if (stream != nullptr && slot.stream_id == stream_id) {
+    uint32_t frames = static_cast<uint32_t>(count / stream->channels());
+    written = static_cast<int32_t>(stream->Write(samples, frames)) *
+              stream->channels();
+  }
+  slot.writers.fetch_sub(1);
+  return written;
+}
@@ -0,0 +1,145 @@
+#ifndef FMOD_FLUTTER_PCM_STREAM_H_
+#define FMOD_FLUTTER_PCM_STREAM_H_
+
+// Streams of PCM pushed continuously from Dart or native code, e.g. voice
+// chat playback or procedural music.
+//
+// Each stream is a user-created FMOD stream (FMOD_OPENUSER) whose
+// pcmreadcallback drains a single-producer, single-consumer ring of float
+// frames. The producer and FMOD's stream thread only exchange two atomic
+// frame counters, so neither side ever blocks the other. When the ring
+// runs dry the callback plays silence and counts an underrun.
+//
+// Streams live in a static table so that Dart can write to them through
+// dart:ffi by id, with no platform channel in the way.
+
+#include <stdint.h>
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+#include "fmod_flutter_export.h"
+
+#define FMOD_FLUTTER_MAX_PCM_STREAMS 16
+
+// Per-stream statistics.
+typedef struct FmodPcmStreamStats {
+  int32_t sample_rate;
+  int32_t channels;
+  int32_t capacity_frames;  // size of the ring
+  int32_t queued_frames;    // written but not yet read by FMOD
+  int64_t underruns;        // reads that ran dry after the first write
+  int64_t underrun_frames;  // frames of silence played in their place
+  int64_t dropped_frames;   // frames refused because the ring was full
+  // Time from a write to the output: the queued frames, FMOD's decode
+  // buffer and the mixer's DSP buffers.
+  int64_t latency_us;
+} FmodPcmStreamStats;
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+namespace fmod_flutter {
+
+// One producer thread and FMOD's stream thread may use a stream at once.
+class PcmStream {
+ public:
+  // capacity_frames is rounded up to a power of two.
+  PcmStream(int sample_rate, int channels, uint32_t capacity_frames);
+  ~PcmStream();
+
+  // Creates the FMOD stream and starts playing it on the master channel
+  // group.
+  FMOD_RESULT Start(FMOD_SYSTEM* core_system);
+
+  // Producer side. Queues up to frames interleaved frames, as many as fit,
+  // and returns how many were queued. Never blocks.
+  uint32_t Write(const float* samples, uint32_t frames);
+
+  void GetStats(FmodPcmStreamStats* stats) const;
+  int channels() const { return channels_; }
+
+ private:
+  static FMOD_RESULT F_CALL ReadCallback(FMOD_SOUND* sound, void* data,
+                                         unsigned int length);
+  // Consumer side, on FMOD's stream thread.
+  void Read(float* out, uint32_t frames);
+
+  const int sample_rate_;
+  const int channels_;
+  const uint32_t decode_frames_;
+  const uint32_t capacity_frames_;
+  std::vector<float> ring_;
+
+  // Frame counters that wrap; the difference is the queued frame count.
+  std::atomic<uint32_t> write_frame_;
+  std::atomic<uint32_t> read_frame_;
+  std::atomic<bool> primed_;
+  std::atomic<int64_t> underruns_;
+  std::atomic<int64_t> underrun_frames_;
+  std::atomic<int64_t> dropped_frames_;
+
+  FMOD_SYSTEM* core_system_;
+  FMOD_SOUND* sound_;
+};
+
+// Creates and destroys the streams of one bridge in the static table.
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock. Writes by id go through fmod_flutter_pcm_stream_write.
+class PcmStreams {
+ public:
+  PcmStreams();
+
+  // Creates a stream buffering up to capacity_ms and starts it. Returns its
+  // id, or 0 on failure; see last_result().
+  int Create(FMOD_STUDIO_SYSTEM* studio_system, int sample_rate,
+             int channels, int capacity_ms);
+  // Stops and releases a stream, after any write in progress finishes.
+  bool Destroy(int stream_id);
+  bool GetStats(int stream_id, FmodPcmStreamStats* stats) const;
+
+  // Destroys every stream. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  std::set<int> stream_ids_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodPcmStreams FmodPcmStreams;
+
+FmodPcmStreams* fmod_pcm_streams_create(void);
+void fmod_pcm_streams_destroy(FmodPcmStreams* streams);
+int fmod_pcm_streams_create_stream(FmodPcmStreams* streams,
+                                   FMOD_STUDIO_SYSTEM* studio_system,
+                                   int sample_rate, int channels,
+                                   int capacity_ms);
+int fmod_pcm_streams_destroy_stream(FmodPcmStreams* streams, int stream_id);
+int fmod_pcm_streams_get_stats(FmodPcmStreams* streams, int stream_id,
+                               FmodPcmStreamStats* stats);
+void fmod_pcm_streams_clear(FmodPcmStreams* streams);
+FMOD_RESULT fmod_pcm_streams_last_result(FmodPcmStreams* streams);
+
+// Looked up from Dart, and callable from any native producer. Queues as
+// many whole frames of count interleaved samples as fit and returns the
+// number of samples queued, or -1 for an unknown stream. Lock-free; one
+// producer per stream at a time.
+FMOD_FLUTTER_EXPORT int32_t fmod_flutter_pcm_stream_write(
+    int32_t stream_id, const float* samples, int32_t count);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_PCM_STREAM_H_
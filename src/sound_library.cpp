@@ -0,0 +1,183 @@
+#include "sound_library.h"
+
+#include <cstring>
+
+#include "compact_codec.h"
+
+namespace fmod_flutter {
+
+// Ahead of FMOD's built-in codecs: the header check is one 16-byte read,
+// and .fca data would otherwise be tried against every other format first.
+static const unsigned int kCompactCodecPriority = 50;
+
+SoundLibrary::SoundLibrary()
+    : core_system_(nullptr),
+      registered_system_(nullptr),
+      next_sound_id_(1),
+      last_result_(FMOD_OK) {}
+
+int SoundLibrary::Load(FMOD_STUDIO_SYSTEM* studio_system, const char* path,
+                       bool stream) {
+  FMOD_MODE mode = stream ? FMOD_CREATESTREAM : FMOD_CREATESAMPLE;
+  return Create(studio_system, path, mode, nullptr);
+}
+
+int SoundLibrary::LoadFromMemory(FMOD_STUDIO_SYSTEM* studio_system,
+                                 const void* data, unsigned int length,
+                                 bool stream) {
+  FMOD_CREATESOUNDEXINFO exinfo;
+  std::memset(&exinfo, 0, sizeof(exinfo));
+  exinfo.cbsize = sizeof(exinfo);
+  exinfo.length = length;
+  FMOD_MODE mode =
+      FMOD_OPENMEMORY | (stream ? FMOD_CREATESTREAM : FMOD_CREATESAMPLE);
+  return Create(studio_system, static_cast<const char*>(data), mode, &exinfo);
+}
+
+int SoundLibrary::Create(FMOD_STUDIO_SYSTEM* studio_system,
+                         const char* name_or_data, FMOD_MODE mode,
+                         FMOD_CREATESOUNDEXINFO* exinfo) {
+  FMOD_SYSTEM* core_system = nullptr;
+  last_result_ = FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (last_result_ != FMOD_OK || !RegisterCodec(core_system)) {
+    return 0;
+  }
+  FMOD_SOUND* sound = nullptr;
+  last_result_ = FMOD_System_CreateSound(core_system, name_or_data,
+                                         mode | FMOD_2D, exinfo, &sound);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  return Add(core_system, sound);
+}
+
+int SoundLibrary::LoadPcm(FMOD_STUDIO_SYSTEM* studio_system,
+                          int32_t buffer_id, const PcmFormat& format) {
+  FMOD_SYSTEM* core_system = nullptr;
+  last_result_ = FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  FMOD_SOUND* sound = nullptr;
+  last_result_ = CreatePcmSound(core_system, buffer_id, format,
+                                FMOD_CREATESAMPLE | FMOD_2D, &sound);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  return Add(core_system, sound);
+}
+
+int SoundLibrary::Add(FMOD_SYSTEM* core_system, FMOD_SOUND* sound) {
+  core_system_ = core_system;
+  int sound_id = next_sound_id_++;
+  sounds_[sound_id] = sound;
+  return sound_id;
+}
+
+bool SoundLibrary::RegisterCodec(FMOD_SYSTEM* core_system) {
+  if (registered_system_ == core_system) {
+    return true;
+  }
+  unsigned int handle = 0;
+  last_result_ = FMOD_System_RegisterCodec(
+      core_system,
+      const_cast<FMOD_CODEC_DESCRIPTION*>(GetCompactCodecDescription()),
+      &handle, kCompactCodecPriority);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  registered_system_ = core_system;
+  return true;
+}
+
+bool SoundLibrary::Play(int sound_id, float volume) {
+  std::map<int, FMOD_SOUND*>::iterator it = sounds_.find(sound_id);
+  if (it == sounds_.end()) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  // Start paused so the volume applies from the first sample.
+  FMOD_CHANNEL* channel = nullptr;
+  last_result_ =
+      FMOD_System_PlaySound(core_system_, it->second, nullptr, 1, &channel);
+  if (last_result_ == FMOD_OK) {
+    FMOD_Channel_SetVolume(channel, volume);
+    last_result_ = FMOD_Channel_SetPaused(channel, 0);
+  }
+  return last_result_ == FMOD_OK;
+}
+
+bool SoundLibrary::Unload(int sound_id) {
+  std::map<int, FMOD_SOUND*>::iterator it = sounds_.find(sound_id);
+  if (it == sounds_.end()) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  last_result_ = ReleasePcmSound(it->second);
+  sounds_.erase(it);
+  return last_result_ == FMOD_OK;
+}
+
+void SoundLibrary::Clear() {
+  for (std::map<int, FMOD_SOUND*>::iterator it = sounds_.begin();
+       it != sounds_.end(); ++it) {
+    ReleasePcmSound(it->second);
+  }
+  sounds_.clear();
+  core_system_ = nullptr;
+  // Codec registrations end with the core system.
+  registered_system_ = nullptr;
+}
+
+const char* SoundLibrary::KernelName() {
+  return GetCompactCodecKernels().name;
+}
+
+}  // namespace fmod_flutter
+
+struct FmodSoundLibrary {
+  fmod_flutter::SoundLibrary library;
+};
+
+FmodSoundLibrary* fmod_sound_library_create(void) {
+  return new FmodSoundLibrary();
+}
+
+void fmod_sound_library_destroy(FmodSoundLibrary* library) {
+  delete library;
+}
+
+int fmod_sound_library_load(FmodSoundLibrary* library,
+                            FMOD_STUDIO_SYSTEM* studio_system,
+                            const char* path, int stream) {
+  return library->library.Load(studio_system, path, stream != 0);
+}
+
+int fmod_sound_library_load_pcm(FmodSoundLibrary* library,
+                                FMOD_STUDIO_SYSTEM* studio_system,
+                                int32_t buffer_id, int sample_rate,
+                                int channels, int format) {
+  fmod_flutter::PcmFormat pcm_format = {sample_rate, channels, format};
+  return library->library.LoadPcm(studio_system, buffer_id, pcm_format);
+}
+
+int fmod_sound_library_play(FmodSoundLibrary* library, int sound_id,
+                            float volume) {
+  return library->library.Play(sound_id, volume) ? 1 : 0;
+}
+
+int fmod_sound_library_unload(FmodSoundLibrary* library, int sound_id) {
+  return library->library.Unload(sound_id) ? 1 : 0;
+}
+
+void fmod_sound_library_clear(FmodSoundLibrary* library) {
+  library->library.Clear();
+}
+
+FMOD_RESULT fmod_sound_library_last_result(FmodSoundLibrary* library) {
+  return library->library.last_result();
+}
+
+const char* fmod_sound_library_kernel_name(void) {
+  return fmod_flutter::SoundLibrary::KernelName();
+}
@@ -0,0 +1,91 @@
+#ifndef FMOD_FLUTTER_SOUND_LIBRARY_H_
+#define FMOD_FLUTTER_SOUND_LIBRARY_H_
+
+// Loose sounds played on the core system, outside Studio banks, e.g. UI
+// sound packs. Any format FMOD decodes can be loaded; the compact .fca
+// format from compact_codec.h is registered with the core system on first
+// use, and costs far less to decode than Vorbis. Raw PCM from a
+// pcm_sounds.h buffer plays from the buffer itself.
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+#include "pcm_sounds.h"
+
+#ifdef __cplusplus
+
+#include <map>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class SoundLibrary {
+ public:
+  SoundLibrary();
+
+  // Loads a sound from a file, or from length bytes of memory, which FMOD
+  // copies. A sample is decoded into memory now; a stream decodes as it
+  // plays. Returns the sound id, or 0 on failure; see last_result().
+  int Load(FMOD_STUDIO_SYSTEM* studio_system, const char* path, bool stream);
+  int LoadFromMemory(FMOD_STUDIO_SYSTEM* studio_system, const void* data,
+                     unsigned int length, bool stream);
+  // Creates a sample over a PCM buffer from pcm_sounds.h without copying
+  // it. The sound keeps the buffer alive until it is unloaded.
+  int LoadPcm(FMOD_STUDIO_SYSTEM* studio_system, int32_t buffer_id,
+              const PcmFormat& format);
+
+  // Plays a loaded sound once on the master channel group. A stream plays
+  // one voice at a time, so playing it again restarts it.
+  bool Play(int sound_id, float volume);
+  bool Unload(int sound_id);
+
+  // Releases every sound. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+  // Name of the .fca decode kernels in use ("sse2", "neon" or "scalar").
+  static const char* KernelName();
+
+ private:
+  int Create(FMOD_STUDIO_SYSTEM* studio_system, const char* name_or_data,
+             FMOD_MODE mode, FMOD_CREATESOUNDEXINFO* exinfo);
+  int Add(FMOD_SYSTEM* core_system, FMOD_SOUND* sound);
+  bool RegisterCodec(FMOD_SYSTEM* core_system);
+
+  FMOD_SYSTEM* core_system_;
+  FMOD_SYSTEM* registered_system_;
+  std::map<int, FMOD_SOUND*> sounds_;
+  int next_sound_id_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodSoundLibrary FmodSoundLibrary;
+
+FmodSoundLibrary* fmod_sound_library_create(void);
+void fmod_sound_library_destroy(FmodSoundLibrary* library);
+int fmod_sound_library_load(FmodSoundLibrary* library,
+                            FMOD_STUDIO_SYSTEM* studio_system,
+                            const char* path, int stream);
+int fmod_sound_library_load_pcm(FmodSoundLibrary* library,
+                                FMOD_STUDIO_SYSTEM* studio_system,
+                                int32_t buffer_id, int sample_rate,
+                                int channels, int format);
+int fmod_sound_library_play(FmodSoundLibrary* library, int sound_id,
+                            float volume);
+int fmod_sound_library_unload(FmodSoundLibrary* library, int sound_id);
+void fmod_sound_library_clear(FmodSoundLibrary* library);
+FMOD_RESULT fmod_sound_library_last_result(FmodSoundLibrary* library);
+const char* fmod_sound_library_kernel_name(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_SOUND_LIBRARY_H_
@@ -0,0 +1,334 @@
+#include "spectrum_analyzer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#include "dsp_effects.h"
+
+namespace fmod_flutter {
+
+static const float kMinFrequency = 20.0f;
+static const float kMaxFrequency = 20000.0f;
+static const float kFloorDb = -100.0f;
+
+// Triple buffers
+
+namespace {
+
+// The writer fills frames[back] and swaps it with the shared middle buffer;
+// the reader swaps its front buffer with the middle one only when the
+// writer has published since the last read (kFresh set).
+struct SpectrumSlot {
+  std::atomic<int32_t> analyzer_id;
+  std::atomic<int> middle;
+  int back;   // writer-owned
+  int front;  // reader-owned
+  FmodSpectrumFrame frames[3];
+};
+
+}  // namespace
+
+static const int kFresh = 4;
+static const int kIndexMask = 3;
+
+static SpectrumSlot slots[FMOD_FLUTTER_MAX_SPECTRUM_ANALYZERS];
+
+static int AcquireSpectrumSlot(int analyzer_id, int band_count) {
+  for (int i = 0; i < FMOD_FLUTTER_MAX_SPECTRUM_ANALYZERS; i++) {
+    SpectrumSlot& slot = slots[i];
+    if (slot.analyzer_id.load() != 0) {
+      continue;
+    }
+    for (int f = 0; f < 3; f++) {
+      slot.frames[f].sequence = 0;
+      slot.frames[f].band_count = band_count;
+      std::fill_n(slot.frames[f].bands, FMOD_FLUTTER_MAX_SPECTRUM_BANDS,
+                  kFloorDb);
+    }
+    slot.back = 0;
+    slot.middle.store(1);
+    slot.front = 2;
+    // Publishing the id makes the slot visible to the reader.
+    slot.analyzer_id.store(analyzer_id, std::memory_order_release);
+    return i;
+  }
+  return -1;
+}
+
+static void ReleaseSpectrumSlot(int slot) {
+  if (slot >= 0 && slot < FMOD_FLUTTER_MAX_SPECTRUM_ANALYZERS) {
+    slots[slot].analyzer_id.store(0);
+  }
+}
+
+static FmodSpectrumFrame* BackFrame(int slot) {
+  return &slots[slot].frames[slots[slot].back];
+}
+
+static void PublishBackFrame(int slot) {
+  SpectrumSlot& s = slots[slot];
+  s.back = s.middle.exchange(s.back | kFresh, std::memory_order_acq_rel) &
+           kIndexMask;
+}
+
+// SpectrumAnalyzers
+
+SpectrumAnalyzers::SpectrumAnalyzers()
+    : next_analyzer_id_(1), last_result_(FMOD_OK) {}
+
+int SpectrumAnalyzers::AddToBus(FMOD_STUDIO_SYSTEM* studio_system,
+                                const char* bus_path, int band_count,
+                                int window_size) {
+  FMOD_STUDIO_BUS* bus = nullptr;
+  last_result_ = FMOD_Studio_System_GetBus(studio_system, bus_path, &bus);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+
+  FMOD_CHANNELGROUP* group = nullptr;
+  last_result_ = AcquireBusChannelGroup(studio_system, bus, &group);
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  return Attach(studio_system, bus, group, band_count, window_size);
+}
+
+int SpectrumAnalyzers::AddToInstance(FMOD_STUDIO_SYSTEM* studio_system,
+                                     FMOD_STUDIO_EVENTINSTANCE* instance,
+                                     int band_count, int window_size) {
+  // A just-started instance has no channel group until its start command
+  // has been executed.
+  FMOD_CHANNELGROUP* group = nullptr;
+  last_result_ = FMOD_Studio_EventInstance_GetChannelGroup(instance, &group);
+  if (last_result_ != FMOD_OK) {
+    FMOD_Studio_System_FlushCommands(studio_system);
+    last_result_ = FMOD_Studio_EventInstance_GetChannelGroup(instance, &group);
+  }
+  if (last_result_ != FMOD_OK) {
+    return 0;
+  }
+  return Attach(studio_system, nullptr, group, band_count, window_size);
+}
+
+int SpectrumAnalyzers::Attach(FMOD_STUDIO_SYSTEM* studio_system,
+                              FMOD_STUDIO_BUS* bus, FMOD_CHANNELGROUP* group,
+                              int band_count, int window_size) {
+  Analyzer analyzer;
+  analyzer.bus = bus;
+  analyzer.group = group;
+  analyzer.dsp = nullptr;
+  analyzer.slot = -1;
+  analyzer.band_count = std::max(
+      1, std::min(band_count, FMOD_FLUTTER_MAX_SPECTRUM_BANDS));
+  analyzer.sample_rate = 0;
+  analyzer.spectrum_length = 0;
+  analyzer.sequence = 0;
+
+  FMOD_SYSTEM* core_system = nullptr;
+  last_result_ = FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (last_result_ == FMOD_OK) {
+    last_result_ = FMOD_System_GetSoftwareFormat(
+        core_system, &analyzer.sample_rate, nullptr, nullptr);
+  }
+  if (last_result_ == FMOD_OK) {
+    last_result_ = FMOD_System_CreateDSPByType(core_system, FMOD_DSP_TYPE_FFT,
+                                               &analyzer.dsp);
+  }
+  if (last_result_ == FMOD_OK) {
+    last_result_ = FMOD_DSP_SetParameterInt(
+        analyzer.dsp, FMOD_DSP_FFT_WINDOWSIZE, window_size);
+  }
+  if (last_result_ == FMOD_OK) {
+    FMOD_DSP_SetParameterInt(analyzer.dsp, FMOD_DSP_FFT_WINDOW,
+                             FMOD_DSP_FFT_WINDOW_HANNING);
+    FMOD_DSP_SetParameterInt(analyzer.dsp, FMOD_DSP_FFT_DOWNMIX,
+                             FMOD_DSP_FFT_DOWNMIX_MONO);
+  }
+
+  int analyzer_id = next_analyzer_id_;
+  if (last_result_ == FMOD_OK) {
+    analyzer.slot = AcquireSpectrumSlot(analyzer_id, analyzer.band_count);
+    if (analyzer.slot < 0) {
+      last_result_ = FMOD_ERR_MEMORY;
+    }
+  }
+  if (last_result_ == FMOD_OK) {
+    // Analyze after the fader and any effects, like a meter.
+    last_result_ =
+        FMOD_ChannelGroup_AddDSP(group, FMOD_CHANNELCONTROL_DSP_HEAD,
+                                 analyzer.dsp);
+  }
+  if (last_result_ != FMOD_OK) {
+    ReleaseAnalyzer(analyzer);
+    return 0;
+  }
+
+  next_analyzer_id_++;
+  analyzers_[analyzer_id] = analyzer;
+  return analyzer_id;
+}
+
+bool SpectrumAnalyzers::Remove(int analyzer_id) {
+  auto it = analyzers_.find(analyzer_id);
+  if (it == analyzers_.end()) {
+    last_result_ = FMOD_ERR_INVALID_HANDLE;
+    return false;
+  }
+  // Fails harmlessly if an event instance has already released the group.
+  FMOD_ChannelGroup_RemoveDSP(it->second.group, it->second.dsp);
+  ReleaseAnalyzer(it->second);
+  analyzers_.erase(it);
+  last_result_ = FMOD_OK;
+  return true;
+}
+
+// Log-spaced band edges, each band at least one bin wide.
+static void ComputeBandBins(int band_count, int sample_rate,
+                            int spectrum_length, std::vector<int>* bins) {
+  float nyquist = sample_rate / 2.0f;
+  float top = std::min(kMaxFrequency, nyquist);
+  float hz_per_bin = nyquist / spectrum_length;
+  bins->resize(band_count + 1);
+  for (int i = 0; i <= band_count; i++) {
+    float frequency = kMinFrequency *
+                      std::pow(top / kMinFrequency,
+                               static_cast<float>(i) / band_count);
+    (*bins)[i] = static_cast<int>(frequency / hz_per_bin + 0.5f);
+  }
+  for (int i = 1; i <= band_count; i++) {
+    (*bins)[i] = std::max((*bins)[i], (*bins)[i - 1] + 1);
+  }
+  for (int i = 0; i <= band_count; i++) {
+    (*bins)[i] = std::min((*bins)[i], spectrum_length);
+  }
+}
+
+void SpectrumAnalyzers::Update() {
+  for (auto& pair : analyzers_) {
+    Analyzer& analyzer = pair.second;
+    void* data = nullptr;
+    unsigned int length = 0;
+    if (FMOD_DSP_GetParameterData(analyzer.dsp, FMOD_DSP_FFT_SPECTRUMDATA,
+                                  &data, &length, nullptr, 0) != FMOD_OK ||
+        data == nullptr) {
+      continue;
+    }
+    const FMOD_DSP_PARAMETER_FFT* fft =
+        static_cast<const FMOD_DSP_PARAMETER_FFT*>(data);
+    if (fft->length <= 0 || fft->numchannels < 1) {
+      continue;
+    }
+
+    if (fft->length != analyzer.spectrum_length) {
+      analyzer.spectrum_length = fft->length;
+      ComputeBandBins(analyzer.band_count, analyzer.sample_rate, fft->length,
+                      &analyzer.band_bins);
+    }
+
+    const float* spectrum = fft->spectrum[0];
+    FmodSpectrumFrame* frame = BackFrame(analyzer.slot);
+    for (int band = 0; band < analyzer.band_count; band++) {
+      int first = analyzer.band_bins[band];
+      int last = analyzer.band_bins[band + 1];
+      // Bands above the last bin repeat it rather than read past the end.
+      if (first >= last) {
+        first = std::min(first, fft->length - 1);
+        last = first + 1;
+      }
+      float power = 0.0f;
+      for (int bin = first; bin < last; bin++) {
+        power += spectrum[bin] * spectrum[bin];
+      }
+      power /= static_cast<float>(last - first);
+      float db = power > 0.0f ? 10.0f * std::log10(power) : kFloorDb;
+      frame->bands[band] = std::max(db, kFloorDb);
+    }
+    frame->band_count = analyzer.band_count;
+    frame->sequence = ++analyzer.sequence;
+    PublishBackFrame(analyzer.slot);
+  }
+}
+
+void SpectrumAnalyzers::Clear() {
+  for (auto& pair : analyzers_) {
+    FMOD_ChannelGroup_RemoveDSP(pair.second.group, pair.second.dsp);
+    ReleaseAnalyzer(pair.second);
+  }
+  analyzers_.clear();
+}
+
+void SpectrumAnalyzers::ReleaseAnalyzer(const Analyzer& analyzer) {
+  if (analyzer.dsp != nullptr) {
+    FMOD_DSP_Release(analyzer.dsp);
+  }
+  ReleaseSpectrumSlot(analyzer.slot);
+  if (analyzer.bus != nullptr) {
+    ReleaseBusChannelGroup(analyzer.bus);
+  }
+}
+
+}  // namespace fmod_flutter
+
+struct FmodSpectrumAnalyzers {
+  fmod_flutter::SpectrumAnalyzers analyzers;
+};
+
+FmodSpectrumAnalyzers* fmod_spectrum_analyzers_create(void) {
+  return new FmodSpectrumAnalyzers();
+}
+
+void fmod_spectrum_analyzers_destroy(FmodSpectrumAnalyzers* analyzers) {
+  delete analyzers;
+}
+
+int fmod_spectrum_analyzers_add_to_bus(FmodSpectrumAnalyzers* analyzers,
+                                       FMOD_STUDIO_SYSTEM* studio_system,
+                                       const char* bus_path, int band_count,
+                                       int window_size) {
+  return analyzers->analyzers.AddToBus(studio_system, bus_path, band_count,
+                                       window_size);
+}
+
+int fmod_spectrum_analyzers_add_to_instance(
+    FmodSpectrumAnalyzers* analyzers, FMOD_STUDIO_SYSTEM* studio_system,
+    FMOD_STUDIO_EVENTINSTANCE* instance, int band_count, int window_size) {
+  return analyzers->analyzers.AddToInstance(studio_system, instance,
+                                            band_count, window_size);
+}
+
+int fmod_spectrum_analyzers_remove(FmodSpectrumAnalyzers* analyzers,
+                                   int analyzer_id) {
+  return analyzers->analyzers.Remove(analyzer_id) ? 1 : 0;
+}
+
+void fmod_spectrum_analyzers_update(FmodSpectrumAnalyzers* analyzers) {
+  analyzers->analyzers.Update();
+}
+
+void fmod_spectrum_analyzers_clear(FmodSpectrumAnalyzers* analyzers) {
+  analyzers->analyzers.Clear();
+}
+
+FMOD_RESULT fmod_spectrum_analyzers_last_result(
+    FmodSpectrumAnalyzers* analyzers) {
+  return analyzers->analyzers.last_result();
+}
+
+const FmodSpectrumFrame* fmod_flutter_spectrum_latest(int32_t analyzer_id) {
+  for (int i = 0; i < FMOD_FLUTTER_MAX_SPECTRUM_ANALYZERS; i++) {
+    fmod_flutter::SpectrumSlot& slot = fmod_flutter::slots[i];
+    if (analyzer_id == 0 ||
+        slot.analyzer_id.load(std::memory_order_acquire) != analyzer_id) {
+      continue;
+    }
+    if (slot.middle.load(std::memory_order_relaxed) & fmod_flutter::kFresh) {
+      slot.front = slot.middle.exchange(slot.front,
+                                        std::memory_order_acq_rel) &
+                   fmod_flutter::kIndexMask;
+    }
+    return &slot.frames[slot.front];
+  }
+  return nullptr;
+}
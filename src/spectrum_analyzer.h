@@ -0,0 +1,123 @@
+#ifndef FMOD_FLUTTER_SPECTRUM_ANALYZER_H_
+#define FMOD_FLUTTER_SPECTRUM_ANALYZER_H_
+
+// Spectrum analyzers for audio-reactive visuals, shared by all native
+// bridges.
+//
+// Each analyzer attaches FMOD's built-in FFT DSP (Hann window, mono
+// downmix) to a bus or event instance. Update(), called from the bridge's
+// update tick rather than the mixer thread, folds the latest FFT into
+// log-spaced bands and publishes them through a per-analyzer triple buffer
+// in static memory. Dart calls fmod_flutter_spectrum_latest() through
+// dart:ffi and views the returned frame in place, so the writer never
+// blocks and nothing is copied on the way to Dart.
+
+#include <stdint.h>
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+#include "fmod_flutter_export.h"
+
+#define FMOD_FLUTTER_MAX_SPECTRUM_ANALYZERS 8
+#define FMOD_FLUTTER_MAX_SPECTRUM_BANDS 128
+
+// Layout shared with lib/src/fmod_native_ffi.dart.
+typedef struct FmodSpectrumFrame {
+  uint32_t sequence;   // frames published so far; 0 before the first
+  int32_t band_count;
+  // Mean power of FMOD's normalized FFT magnitudes in each band, in dB and
+  // floored at -100. Bands are log-spaced from 20 Hz to 20 kHz (or Nyquist).
+  float bands[FMOD_FLUTTER_MAX_SPECTRUM_BANDS];
+} FmodSpectrumFrame;
+
+#ifdef __cplusplus
+
+#include <map>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock.
+class SpectrumAnalyzers {
+ public:
+  SpectrumAnalyzers();
+
+  // band_count is clamped to [1, FMOD_FLUTTER_MAX_SPECTRUM_BANDS];
+  // window_size must be a power of two from 128 to 32768. Returns the
+  // analyzer id, or 0 on failure; see last_result().
+  int AddToBus(FMOD_STUDIO_SYSTEM* studio_system, const char* bus_path,
+               int band_count, int window_size);
+  int AddToInstance(FMOD_STUDIO_SYSTEM* studio_system,
+                    FMOD_STUDIO_EVENTINSTANCE* instance, int band_count,
+                    int window_size);
+  bool Remove(int analyzer_id);
+
+  // Bins and publishes the latest FFT of every analyzer.
+  void Update();
+
+  // Removes every analyzer. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+ private:
+  struct Analyzer {
+    FMOD_STUDIO_BUS* bus;  // nullptr for event instances
+    FMOD_CHANNELGROUP* group;
+    FMOD_DSP* dsp;
+    int slot;
+    int band_count;
+    int sample_rate;
+    // FFT bins [band_bins[i], band_bins[i + 1]) make up band i; rebuilt
+    // when the spectrum length changes.
+    int spectrum_length;
+    std::vector<int> band_bins;
+    uint32_t sequence;
+  };
+
+  int Attach(FMOD_STUDIO_SYSTEM* studio_system, FMOD_STUDIO_BUS* bus,
+             FMOD_CHANNELGROUP* group, int band_count, int window_size);
+  void ReleaseAnalyzer(const Analyzer& analyzer);
+
+  std::map<int, Analyzer> analyzers_;
+  int next_analyzer_id_;
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodSpectrumAnalyzers FmodSpectrumAnalyzers;
+
+FmodSpectrumAnalyzers* fmod_spectrum_analyzers_create(void);
+void fmod_spectrum_analyzers_destroy(FmodSpectrumAnalyzers* analyzers);
+int fmod_spectrum_analyzers_add_to_bus(FmodSpectrumAnalyzers* analyzers,
+                                       FMOD_STUDIO_SYSTEM* studio_system,
+                                       const char* bus_path, int band_count,
+                                       int window_size);
+int fmod_spectrum_analyzers_add_to_instance(
+    FmodSpectrumAnalyzers* analyzers, FMOD_STUDIO_SYSTEM* studio_system,
+    FMOD_STUDIO_EVENTINSTANCE* instance, int band_count, int window_size);
+int fmod_spectrum_analyzers_remove(FmodSpectrumAnalyzers* analyzers,
+                                   int analyzer_id);
+void fmod_spectrum_analyzers_update(FmodSpectrumAnalyzers* analyzers);
+void fmod_spectrum_analyzers_clear(FmodSpectrumAnalyzers* analyzers);
+FMOD_RESULT fmod_spectrum_analyzers_last_result(
+    FmodSpectrumAnalyzers* analyzers);
+
+// Looked up from Dart. Swaps in the newest published frame of the analyzer
+// and returns it; the frame stays untouched until the next call for the
+// same analyzer. Returns NULL for an unknown id. Single reader only.
+FMOD_FLUTTER_EXPORT const FmodSpectrumFrame* fmod_flutter_spectrum_latest(
+    int32_t analyzer_id);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_SPECTRUM_ANALYZER_H_
@@ -0,0 +1,303 @@
+#include "voice_stats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "event_lookup.h"
+
+namespace fmod_flutter {
+
+VoiceStats::VoiceStats()
+    : studio_system_(nullptr),
+      core_system_(nullptr),
+      window_length_(),
+      bank_count_(0),
+      last_result_(FMOD_OK) {
+  std::memset(&window_, 0, sizeof(window_));
+}
+
+bool VoiceStats::Start(FMOD_STUDIO_SYSTEM* studio_system, int window_ms) {
+  Stop();
+  if (window_ms <= 0) {
+    last_result_ = FMOD_ERR_INVALID_PARAM;
+    return false;
+  }
+  FMOD_SYSTEM* core_system = nullptr;
+  last_result_ = FMOD_Studio_System_GetCoreSystem(studio_system, &core_system);
+  if (last_result_ != FMOD_OK) {
+    return false;
+  }
+  studio_system_ = studio_system;
+  core_system_ = core_system;
+  window_length_ = std::chrono::milliseconds(window_ms);
+  windows_.clear();
+  last_events_.clear();
+  started_ = std::chrono::steady_clock::now();
+  ResetWindow(started_);
+  bank_count_ = -1;
+  TrackBanks();
+  return true;
+}
+
+void VoiceStats::Stop() {
+  if (studio_system_ == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < events_.size(); i++) {
+    FMOD_STUDIO_EVENTDESCRIPTION* description = events_[i].description;
+    if (FMOD_Studio_EventDescription_IsValid(description)) {
+      FMOD_Studio_EventDescription_SetCallback(description, nullptr, 0);
+      FMOD_Studio_EventDescription_SetUserData(description, nullptr);
+    }
+  }
+  // Waits out any callback still running on the Studio thread.
+  FMOD_Studio_System_FlushCommands(studio_system_);
+  for (size_t i = 0; i < events_.size(); i++) {
+    delete events_[i].counters;
+  }
+  events_.clear();
+  studio_system_ = nullptr;
+  core_system_ = nullptr;
+}
+
+void VoiceStats::TrackBanks() {
+  int bank_count = 0;
+  if (FMOD_Studio_System_GetBankCount(studio_system_, &bank_count) !=
+          FMOD_OK ||
+      bank_count == bank_count_) {
+    return;
+  }
+  std::vector<FMOD_STUDIO_BANK*> banks(bank_count);
+  if (bank_count > 0 &&
+      FMOD_Studio_System_GetBankList(studio_system_, banks.data(), bank_count,
+                                     &bank_count) != FMOD_OK) {
+    return;
+  }
+  bank_count_ = bank_count;
+
+  std::unordered_set<FMOD_STUDIO_EVENTDESCRIPTION*> tracked;
+  for (size_t i = 0; i < events_.size(); i++) {
+    tracked.insert(events_[i].description);
+  }
+  std::vector<FMOD_STUDIO_EVENTDESCRIPTION*> descriptions;
+  for (int i = 0; i < bank_count; i++) {
+    int event_count = 0;
+    if (FMOD_Studio_Bank_GetEventCount(banks[i], &event_count) != FMOD_OK ||
+        event_count <= 0) {
+      continue;
+    }
+    descriptions.resize(event_count);
+    if (FMOD_Studio_Bank_GetEventList(banks[i], descriptions.data(),
+                                      event_count, &event_count) != FMOD_OK) {
+      continue;
+    }
+    for (int j = 0; j < event_count; j++) {
+      FMOD_STUDIO_EVENTDESCRIPTION* description = descriptions[j];
+      if (!tracked.insert(description).second) {
+        continue;
+      }
+      TrackedEvent event;
+      event.description = description;
+      // The ID key without a strings bank, which the play and control
+      // methods accept as well.
+      event.path = EventKey(description);
+      event.counters = new Counters();
+      event.counters->starts.store(0);
+      event.counters->start_failures.store(0);
+      event.counters->virtualizations.store(0);
+      event.instances = 0;
+      event.peak_instances = 0;
+      FMOD_Studio_EventDescription_SetUserData(description, event.counters);
+      FMOD_Studio_EventDescription_SetCallback(
+          description, EventCallback, FMOD_FLUTTER_VOICE_STATS_CALLBACKS);
+      events_.push_back(event);
+    }
+  }
+}
+
+// Called on FMOD's Studio thread.
+FMOD_RESULT F_CALL VoiceStats::EventCallback(
+    FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event,
+    void* /*parameters*/) {
+  if ((type & FMOD_FLUTTER_VOICE_STATS_CALLBACKS) == 0) {
+    return FMOD_OK;
+  }
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  if (FMOD_Studio_EventInstance_GetDescription(event, &description) !=
+      FMOD_OK) {
+    return FMOD_OK;
+  }
+  void* user_data = nullptr;
+  FMOD_Studio_EventDescription_GetUserData(description, &user_data);
+  Counters* counters = static_cast<Counters*>(user_data);
+  if (counters == nullptr) {
+    return FMOD_OK;
+  }
+  if (type == FMOD_STUDIO_EVENT_CALLBACK_STARTED) {
+    counters->starts.fetch_add(1, std::memory_order_relaxed);
+  } else if (type == FMOD_STUDIO_EVENT_CALLBACK_START_FAILED) {
+    counters->start_failures.fetch_add(1, std::memory_order_relaxed);
+  } else if (type == FMOD_STUDIO_EVENT_CALLBACK_REAL_TO_VIRTUAL) {
+    counters->virtualizations.fetch_add(1, std::memory_order_relaxed);
+  }
+  return FMOD_OK;
+}
+
+void VoiceStats::Update() {
+  if (studio_system_ == nullptr) {
+    return;
+  }
+  TrackBanks();
+
+  int total = 0;
+  int real = 0;
+  if (FMOD_System_GetChannelsPlaying(core_system_, &total, &real) ==
+      FMOD_OK) {
+    int virtual_count = total - real;
+    window_.samples++;
+    window_.real_sum += real;
+    window_.virtual_sum += virtual_count;
+    window_.real_peak = std::max(window_.real_peak, real);
+    window_.virtual_peak = std::max(window_.virtual_peak, virtual_count);
+    if (total >= FMOD_FLUTTER_MAX_CHANNELS) {
+      window_.saturated_samples++;
+    }
+  }
+  for (size_t i = 0; i < events_.size(); i++) {
+    TrackedEvent& event = events_[i];
+    int count = 0;
+    if (FMOD_Studio_EventDescription_GetInstanceCount(event.description,
+                                                      &count) == FMOD_OK) {
+      event.instances = count;
+      event.peak_instances = std::max(event.peak_instances, count);
+    }
+  }
+
+  std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (now - window_start_ >= window_length_) {
+    CloseWindow(now);
+  }
+}
+
+void VoiceStats::CloseWindow(std::chrono::steady_clock::time_point now) {
+  window_.end_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       now - started_)
+                       .count();
+  window_.duration_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now -
+                                                            window_start_)
+          .count();
+  last_events_.clear();
+  for (size_t i = 0; i < events_.size(); i++) {
+    TrackedEvent& event = events_[i];
+    EventStats entry;
+    entry.path = event.path;
+    entry.stats.instances = event.instances;
+    entry.stats.peak_instances = event.peak_instances;
+    entry.stats.starts = event.counters->starts.exchange(0);
+    entry.stats.start_failures = event.counters->start_failures.exchange(0);
+    entry.stats.virtualizations =
+        event.counters->virtualizations.exchange(0);
+    // Instances still live open the next window's peak.
+    event.peak_instances = event.instances;
+
+    window_.starts += entry.stats.starts;
+    window_.start_failures += entry.stats.start_failures;
+    window_.virtualizations += entry.stats.virtualizations;
+    if (entry.stats.peak_instances > 0 || entry.stats.starts > 0 ||
+        entry.stats.start_failures > 0 || entry.stats.virtualizations > 0) {
+      last_events_.push_back(entry);
+    }
+  }
+  std::sort(last_events_.begin(), last_events_.end(),
+            [](const EventStats& a, const EventStats& b) {
+              return a.stats.peak_instances != b.stats.peak_instances
+                         ? a.stats.peak_instances > b.stats.peak_instances
+                         : a.stats.starts > b.stats.starts;
+            });
+  window_.event_count = static_cast<int32_t>(last_events_.size());
+
+  windows_.push_back(window_);
+  if (windows_.size() > FMOD_FLUTTER_VOICE_STATS_WINDOWS) {
+    windows_.pop_front();
+  }
+  ResetWindow(now);
+}
+
+void VoiceStats::ResetWindow(std::chrono::steady_clock::time_point now) {
+  std::memset(&window_, 0, sizeof(window_));
+  window_.max_channels = FMOD_FLUTTER_MAX_CHANNELS;
+  FMOD_System_GetSoftwareChannels(core_system_, &window_.software_channels);
+  window_start_ = now;
+}
+
+int VoiceStats::GetWindows(FmodVoiceStatsWindow* windows,
+                           int capacity) const {
+  int count = std::min(capacity, static_cast<int>(windows_.size()));
+  // The newest windows when there is not room for all of them.
+  size_t first = windows_.size() - count;
+  for (int i = 0; i < count; i++) {
+    windows[i] = windows_[first + i];
+  }
+  return count;
+}
+
+void VoiceStats::Clear() {
+  Stop();
+  windows_.clear();
+  last_events_.clear();
+}
+
+}  // namespace fmod_flutter
+
+struct FmodVoiceStats {
+  fmod_flutter::VoiceStats stats;
+};
+
+FmodVoiceStats* fmod_voice_stats_create(void) { return new FmodVoiceStats(); }
+
+void fmod_voice_stats_destroy(FmodVoiceStats* stats) { delete stats; }
+
+int fmod_voice_stats_start(FmodVoiceStats* stats,
+                           FMOD_STUDIO_SYSTEM* studio_system, int window_ms) {
+  return stats->stats.Start(studio_system, window_ms) ? 1 : 0;
+}
+
+void fmod_voice_stats_stop(FmodVoiceStats* stats) { stats->stats.Stop(); }
+
+void fmod_voice_stats_update(FmodVoiceStats* stats) { stats->stats.Update(); }
+
+int fmod_voice_stats_get_windows(FmodVoiceStats* stats,
+                                 FmodVoiceStatsWindow* windows,
+                                 int capacity) {
+  return stats->stats.GetWindows(windows, capacity);
+}
+
+int fmod_voice_stats_event_count(FmodVoiceStats* stats) {
+  return static_cast<int>(stats->stats.last_events().size());
+}
+
+const char* fmod_voice_stats_get_event(FmodVoiceStats* stats, int index,
+                                       FmodEventVoiceStats* event_stats) {
+  const std::vector<fmod_flutter::VoiceStats::EventStats>& events =
+      stats->stats.last_events();
+  if (index < 0 || index >= static_cast<int>(events.size())) {
+    return nullptr;
+  }
+  *event_stats = events[index].stats;
+  return events[index].path.c_str();
+}
+
+void fmod_voice_stats_clear(FmodVoiceStats* stats) { stats->stats.Clear(); }
+
+FMOD_RESULT fmod_voice_stats_last_result(FmodVoiceStats* stats) {
+  return stats->stats.last_result();
+}
+
+FMOD_RESULT fmod_voice_stats_event_callback(
+    FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event,
+    void* parameters) {
+  return fmod_flutter::VoiceStats::EventCallback(type, event, parameters);
+}
@@ -0,0 +1,188 @@
+#ifndef FMOD_FLUTTER_VOICE_STATS_H_
+#define FMOD_FLUTTER_VOICE_STATS_H_
+
+// Voice and virtualization statistics shared by all native bridges, for
+// sizing the channel limits per device class.
+//
+// While running, Update() samples System::getChannelsPlaying and the live
+// instance count of every event in the loaded banks on each update tick,
+// and a callback on each event description counts starts, starts refused
+// by the event's instance limit and instances going virtual. Samples are
+// aggregated into fixed windows of wall time; the last
+// FMOD_FLUTTER_VOICE_STATS_WINDOWS complete windows are kept.
+//
+// An instance callback replaces the description callback, and instances
+// created before Start() (pre-warmed pools) never get it, so every
+// callback the bridges set on an instance (beat tracking, programmer
+// sounds) asks for FMOD_FLUTTER_VOICE_STATS_CALLBACKS as well and forwards
+// those to VoiceStats::EventCallback.
+
+#include <stdint.h>
+
+#include <fmod_studio.h>
+
+// Channels passed to Studio::System::initialize by every bridge: the most
+// voices, real or virtual, that play at once before FMOD steals them.
+#define FMOD_FLUTTER_MAX_CHANNELS 512
+
+#define FMOD_FLUTTER_VOICE_STATS_WINDOWS 32
+
+// The callback types VoiceStats counts.
+#define FMOD_FLUTTER_VOICE_STATS_CALLBACKS         \
+  (FMOD_STUDIO_EVENT_CALLBACK_STARTED |            \
+   FMOD_STUDIO_EVENT_CALLBACK_START_FAILED |       \
+   FMOD_STUDIO_EVENT_CALLBACK_REAL_TO_VIRTUAL)
+
+// System-wide statistics of one window.
+typedef struct FmodVoiceStatsWindow {
+  int64_t end_us;       // since Start()
+  int64_t duration_us;
+  int32_t samples;      // update ticks sampled
+  int32_t max_channels;       // FMOD_FLUTTER_MAX_CHANNELS
+  int32_t software_channels;  // most voices mixed for real
+  int32_t real_peak;
+  int32_t virtual_peak;
+  // Ticks where real plus virtual voices reached max_channels, so any new
+  // voice stole one.
+  int32_t saturated_samples;
+  // Summed over the samples; divide by samples for the mean.
+  int64_t real_sum;
+  int64_t virtual_sum;
+  // Summed over every event.
+  int32_t starts;
+  int32_t start_failures;   // starts refused by an event's instance limit
+  int32_t virtualizations;  // instances that went virtual
+  int32_t event_count;      // events with instances or counts this window
+} FmodVoiceStatsWindow;
+
+// Statistics of one event over the last complete window.
+typedef struct FmodEventVoiceStats {
+  int32_t instances;       // live at the end of the window
+  int32_t peak_instances;
+  int32_t starts;
+  int32_t start_failures;
+  int32_t virtualizations;
+} FmodEventVoiceStats;
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace fmod_flutter {
+
+// Not thread-safe; the bridges call every method from one thread or under
+// their own lock. The description callbacks only touch atomic counters.
+class VoiceStats {
+ public:
+  struct EventStats {
+    std::string path;  // or the GUID, without a strings bank
+    FmodEventVoiceStats stats;
+  };
+
+  VoiceStats();
+
+  // Starts sampling into windows of window_ms, dropping any earlier
+  // windows. Events in banks loaded later are picked up on the next tick.
+  bool Start(FMOD_STUDIO_SYSTEM* studio_system, int window_ms);
+  // Stops sampling and removes the description callbacks. Complete
+  // windows stay readable.
+  void Stop();
+
+  // Samples one update tick. Call every tick; does nothing when stopped.
+  void Update();
+
+  // Copies up to capacity complete windows, oldest first, and returns how
+  // many were copied.
+  int GetWindows(FmodVoiceStatsWindow* windows, int capacity) const;
+  // Events of the newest complete window that had instances, starts,
+  // failures or virtualizations, busiest first.
+  const std::vector<EventStats>& last_events() const { return last_events_; }
+
+  bool running() const { return studio_system_ != nullptr; }
+
+  // Stops and drops every window. Call before releasing the Studio system.
+  void Clear();
+
+  FMOD_RESULT last_result() const { return last_result_; }
+
+  // The description callback, counting FMOD_FLUTTER_VOICE_STATS_CALLBACKS
+  // types against the instance's event. Instance callbacks forward those
+  // types here; other types and events not tracked are ignored, so it is
+  // safe to call whether or not statistics are running. Called on FMOD's
+  // Studio thread.
+  static FMOD_RESULT F_CALL EventCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type,
+                                          FMOD_STUDIO_EVENTINSTANCE* event,
+                                          void* parameters);
+
+ private:
+  // Written from FMOD's Studio thread.
+  struct Counters {
+    std::atomic<int32_t> starts;
+    std::atomic<int32_t> start_failures;
+    std::atomic<int32_t> virtualizations;
+  };
+
+  struct TrackedEvent {
+    FMOD_STUDIO_EVENTDESCRIPTION* description;
+    std::string path;
+    Counters* counters;
+    int32_t instances;
+    int32_t peak_instances;
+  };
+
+  void TrackBanks();
+  void CloseWindow(std::chrono::steady_clock::time_point now);
+  void ResetWindow(std::chrono::steady_clock::time_point now);
+
+  FMOD_STUDIO_SYSTEM* studio_system_;
+  FMOD_SYSTEM* core_system_;
+  std::chrono::steady_clock::duration window_length_;
+  std::chrono::steady_clock::time_point started_;
+  std::chrono::steady_clock::time_point window_start_;
+  int bank_count_;
+  std::vector<TrackedEvent> events_;
+
+  FmodVoiceStatsWindow window_;
+  std::deque<FmodVoiceStatsWindow> windows_;
+  std::vector<EventStats> last_events_;
+
+  FMOD_RESULT last_result_;
+};
+
+}  // namespace fmod_flutter
+
+extern "C" {
+#endif  // __cplusplus
+
+// C interface for the Objective-C bridges.
+typedef struct FmodVoiceStats FmodVoiceStats;
+
+FmodVoiceStats* fmod_voice_stats_create(void);
+void fmod_voice_stats_destroy(FmodVoiceStats* stats);
+int fmod_voice_stats_start(FmodVoiceStats* stats,
+                           FMOD_STUDIO_SYSTEM* studio_system, int window_ms);
+void fmod_voice_stats_stop(FmodVoiceStats* stats);
+void fmod_voice_stats_update(FmodVoiceStats* stats);
+int fmod_voice_stats_get_windows(FmodVoiceStats* stats,
+                                 FmodVoiceStatsWindow* windows, int capacity);
+int fmod_voice_stats_event_count(FmodVoiceStats* stats);
+// Returns the path of event index of the newest window, valid until the
+// next update, and fills event_stats; null if index is out of range.
+const char* fmod_voice_stats_get_event(FmodVoiceStats* stats, int index,
+                                       FmodEventVoiceStats* event_stats);
+void fmod_voice_stats_clear(FmodVoiceStats* stats);
+FMOD_RESULT fmod_voice_stats_last_result(FmodVoiceStats* stats);
+// VoiceStats::EventCallback, for instance callbacks to forward to.
+FMOD_RESULT fmod_voice_stats_event_callback(
+    FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event,
+    void* parameters);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // FMOD_FLUTTER_VOICE_STATS_H_
@@ -0,0 +1,164 @@
+// Checks the AudioInterruption state machine on Linux.
+//
+// The master channel group calls AudioInterruption makes are answered by
+// stand-ins defined below, which record the pause state and the fade
+// level, so the test needs no FMOD libraries or audio device. Each case
+// runs a sequence of Begin() and End() calls and checks what the master
+// is left with: an End() must restore the pause state from before the
+// interruption, whatever order the interruptions escalated in.
+//
+// Usage: audio_interruption_test
+
+#include <fmod.h>
+
+#include "audio_interruption.h"
+
+#include <cstdio>
+
+namespace {
+
+// The stand-in master channel group.
+struct Master {
+  FMOD_BOOL paused;
+  float fade;
+};
+
+Master master;
+int failures = 0;
+
+FMOD_SYSTEM* const kCoreSystem = reinterpret_cast<FMOD_SYSTEM*>(1);
+FMOD_CHANNELGROUP* const kMaster = reinterpret_cast<FMOD_CHANNELGROUP*>(2);
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void Reset(bool paused) {
+  master.paused = paused;
+  master.fade = 1.0f;
+}
+
+// Begins each kind in turn, then ends the interruption, and checks the
+// active response after each Begin() and the master after End().
+void Run(const char* test, const int policy[3], bool paused_before,
+         const int* kinds, int count, const int* expected_responses) {
+  Reset(paused_before);
+  int failures_before = failures;
+  fmod_flutter::AudioInterruption interruption;
+  interruption.SetPolicy(policy[FMOD_FLUTTER_INTERRUPTION_TRANSIENT],
+                         policy[FMOD_FLUTTER_INTERRUPTION_CAN_DUCK],
+                         policy[FMOD_FLUTTER_INTERRUPTION_LOSS], 0.25f,
+                         0.0f);
+  for (int i = 0; i < count; i++) {
+    int response = interruption.Begin(kCoreSystem, kinds[i]);
+    Expect(response == expected_responses[i], test, "response after Begin");
+    bool pausing = response >= FMOD_FLUTTER_RESPONSE_PAUSE;
+    Expect((master.paused != 0) == (pausing || paused_before), test,
+           "master pause during interruption");
+    Expect(pausing || master.fade < 1.0f, test, "master ducked");
+  }
+  interruption.End(kCoreSystem);
+  Expect(!interruption.active(), test, "interruption still active");
+  Expect((master.paused != 0) == paused_before, test,
+         "master pause state not restored by End");
+  Expect(master.fade == 1.0f, test, "master still ducked after End");
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+}  // namespace
+
+// Stand-ins for the FMOD calls AudioInterruption makes.
+extern "C" {
+
+FMOD_RESULT F_API FMOD_System_GetMasterChannelGroup(
+    FMOD_SYSTEM* system, FMOD_CHANNELGROUP** channelgroup) {
+  *channelgroup = kMaster;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_GetSoftwareFormat(FMOD_SYSTEM* system,
+                                                int* samplerate,
+                                                FMOD_SPEAKERMODE* speakermode,
+                                                int* numrawspeakers) {
+  *samplerate = 48000;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_ChannelGroup_GetDSPClock(
+    FMOD_CHANNELGROUP* channelgroup, unsigned long long* dspclock,
+    unsigned long long* parentclock) {
+  if (dspclock != nullptr) {
+    *dspclock = 0;
+  }
+  if (parentclock != nullptr) {
+    *parentclock = 0;
+  }
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_ChannelGroup_SetFadePointRamp(
+    FMOD_CHANNELGROUP* channelgroup, unsigned long long dspclock,
+    float volume) {
+  master.fade = volume;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_ChannelGroup_GetPaused(FMOD_CHANNELGROUP* channelgroup,
+                                              FMOD_BOOL* paused) {
+  *paused = master.paused;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_ChannelGroup_SetPaused(FMOD_CHANNELGROUP* channelgroup,
+                                              FMOD_BOOL paused) {
+  master.paused = paused;
+  return FMOD_OK;
+}
+
+}  // extern "C"
+
+int main() {
+  const int kDuck = FMOD_FLUTTER_RESPONSE_DUCK;
+  const int kPause = FMOD_FLUTTER_RESPONSE_PAUSE;
+  const int kSuspend = FMOD_FLUTTER_RESPONSE_SUSPEND;
+  const int kTransient = FMOD_FLUTTER_INTERRUPTION_TRANSIENT;
+  const int kCanDuck = FMOD_FLUTTER_INTERRUPTION_CAN_DUCK;
+  const int kLoss = FMOD_FLUTTER_INTERRUPTION_LOSS;
+
+  // Policies indexed by kind: TRANSIENT, CAN_DUCK, LOSS.
+  const int kEscalating[3] = {kPause, kDuck, kSuspend};
+  const int kPauseThenSuspend[3] = {kSuspend, kPause, kSuspend};
+
+  const int kDuckPauseSuspend[] = {kCanDuck, kTransient, kLoss};
+  const int kDuckPauseSuspendResponses[] = {kDuck, kPause, kSuspend};
+  const int kSuspendPauseDuck[] = {kLoss, kTransient, kCanDuck};
+  const int kSuspendPauseDuckResponses[] = {kSuspend, kSuspend, kSuspend};
+  const int kPauseSuspend[] = {kCanDuck, kTransient};
+  const int kPauseSuspendResponses[] = {kPause, kSuspend};
+  const int kDuckOnly[] = {kCanDuck};
+  const int kDuckOnlyResponses[] = {kDuck};
+
+  Run("duck, pause, suspend, end", kEscalating, false, kDuckPauseSuspend, 3,
+      kDuckPauseSuspendResponses);
+  Run("suspend, pause, duck, end", kEscalating, false, kSuspendPauseDuck, 3,
+      kSuspendPauseDuckResponses);
+  Run("pause, suspend, end", kPauseThenSuspend, false, kPauseSuspend, 2,
+      kPauseSuspendResponses);
+  Run("duck, end", kEscalating, false, kDuckOnly, 1, kDuckOnlyResponses);
+  // The app had paused the master itself; End() must leave it paused.
+  Run("paused by app: duck, pause, suspend, end", kEscalating, true,
+      kDuckPauseSuspend, 3, kDuckPauseSuspendResponses);
+  Run("paused by app: pause, suspend, end", kPauseThenSuspend, true,
+      kPauseSuspend, 2, kPauseSuspendResponses);
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,528 @@
+// Generates Dart constants for the events, snapshots, buses, VCAs and
+// parameters in a set of FMOD Studio banks.
+//
+// Each constant carries the path and the ID FMOD Studio gave the object, so
+// a mistyped path fails to compile instead of failing in getEvent at
+// runtime. IDs are what Studio::System::getEventByID and friends take, and
+// resolve without the strings bank. Parameters carry their name and
+// parameter ID.
+//
+// The banks are read through the FMOD Studio API rather than parsed, since
+// the bank format is not documented. Paths come from the strings bank, so it
+// must be among the inputs. Output is sorted by path and stable across runs,
+// so the generated file diffs cleanly when the banks change.
+//
+// Usage: bank_codegen <bank or directory>... [--out FILE] [--prefix NAME]
+
+#include <dirent.h>
+#include <fmod.h>
+#include <fmod_errors.h>
+#include <fmod_studio.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+static const int kMaxPathLength = 512;
+
+struct Options {
+  std::vector<std::string> inputs;
+  std::string out_path;
+  std::string prefix = "Fmod";
+};
+
+struct Entry {
+  std::string path;
+  FMOD_GUID id;
+};
+
+struct Parameter {
+  std::string event_path;  // empty for global parameters
+  std::string name;
+  FMOD_STUDIO_PARAMETER_ID id;
+};
+
+// Everything found in the banks, keyed by path so that objects shared by
+// several banks (buses, VCAs) appear once, in a stable order.
+struct Metadata {
+  std::vector<std::string> bank_names;
+  std::map<std::string, Entry> events;
+  std::map<std::string, Entry> snapshots;
+  std::map<std::string, Entry> buses;
+  std::map<std::string, Entry> vcas;
+  std::map<std::string, Parameter> parameters;  // keyed by event path + name
+};
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: bank_codegen <bank or directory>... [options]\n"
+               "  --out FILE     write the Dart file to FILE (default:\n"
+               "                 standard output)\n"
+               "  --prefix NAME  class name prefix (default Fmod, giving\n"
+               "                 FmodEvents, FmodBuses, ...)\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--out") == 0 && has_value) {
+      options->out_path = argv[++i];
+    } else if (std::strcmp(arg, "--prefix") == 0 && has_value) {
+      options->prefix = argv[++i];
+    } else if (arg[0] != '-') {
+      options->inputs.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  return !options->inputs.empty() && !options->prefix.empty();
+}
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "bank_codegen: %s failed: %d - %s\n", what, result,
+                 FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+bool EndsWith(const std::string& text, const char* suffix) {
+  size_t length = std::strlen(suffix);
+  return text.size() >= length &&
+         text.compare(text.size() - length, length, suffix) == 0;
+}
+
+std::string BaseName(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Expands directories into the .bank files they hold, strings banks first
+// so that paths resolve while the other banks load.
+std::vector<std::string> BankFiles(const std::vector<std::string>& inputs) {
+  std::vector<std::string> files;
+  for (const std::string& input : inputs) {
+    struct stat info;
+    if (stat(input.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+      DIR* handle = opendir(input.c_str());
+      if (handle == nullptr) {
+        continue;
+      }
+      while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (EndsWith(name, ".bank")) {
+          files.push_back(input + "/" + name);
+        }
+      }
+      closedir(handle);
+    } else {
+      files.push_back(input);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  files.erase(std::unique(files.begin(), files.end()), files.end());
+  std::stable_partition(files.begin(), files.end(), [](const std::string& f) {
+    return EndsWith(f, ".strings.bank");
+  });
+  return files;
+}
+
+template <typename Handle>
+bool PathOf(Handle* handle,
+            FMOD_RESULT (*get_path)(Handle*, char*, int, int*),
+            std::string* path) {
+  char buffer[kMaxPathLength];
+  if (get_path(handle, buffer, kMaxPathLength, nullptr) != FMOD_OK) {
+    return false;
+  }
+  *path = buffer;
+  return true;
+}
+
+bool ReadEvents(FMOD_STUDIO_BANK* bank, Metadata* metadata) {
+  int count = 0;
+  if (!Check(FMOD_Studio_Bank_GetEventCount(bank, &count), "GetEventCount")) {
+    return false;
+  }
+  std::vector<FMOD_STUDIO_EVENTDESCRIPTION*> events(count);
+  if (count > 0 &&
+      !Check(FMOD_Studio_Bank_GetEventList(bank, events.data(), count, &count),
+             "GetEventList")) {
+    return false;
+  }
+  for (int i = 0; i < count; i++) {
+    Entry entry;
+    if (!PathOf(events[i], FMOD_Studio_EventDescription_GetPath,
+                &entry.path)) {
+      std::fprintf(stderr,
+                   "bank_codegen: an event has no path; include the "
+                   "strings bank\n");
+      return false;
+    }
+    FMOD_Studio_EventDescription_GetID(events[i], &entry.id);
+    bool snapshot = entry.path.compare(0, 10, "snapshot:/") == 0;
+    (snapshot ? metadata->snapshots : metadata->events)[entry.path] = entry;
+    if (snapshot) {
+      continue;
+    }
+
+    int parameter_count = 0;
+    FMOD_Studio_EventDescription_GetParameterDescriptionCount(
+        events[i], &parameter_count);
+    for (int j = 0; j < parameter_count; j++) {
+      FMOD_STUDIO_PARAMETER_DESCRIPTION description;
+      if (FMOD_Studio_EventDescription_GetParameterDescriptionByIndex(
+              events[i], j, &description) != FMOD_OK) {
+        continue;
+      }
+      // Only parameters setParameter can write; global ones are listed
+      // once from the system.
+      if (description.flags & (FMOD_STUDIO_PARAMETER_READONLY |
+                               FMOD_STUDIO_PARAMETER_AUTOMATIC |
+                               FMOD_STUDIO_PARAMETER_GLOBAL)) {
+        continue;
+      }
+      Parameter parameter;
+      parameter.event_path = entry.path;
+      parameter.name = description.name;
+      parameter.id = description.id;
+      metadata->parameters[entry.path + "\n" + parameter.name] = parameter;
+    }
+  }
+  return true;
+}
+
+bool ReadBuses(FMOD_STUDIO_BANK* bank, Metadata* metadata) {
+  int count = 0;
+  FMOD_Studio_Bank_GetBusCount(bank, &count);
+  std::vector<FMOD_STUDIO_BUS*> buses(count);
+  if (count > 0 &&
+      !Check(FMOD_Studio_Bank_GetBusList(bank, buses.data(), count, &count),
+             "GetBusList")) {
+    return false;
+  }
+  for (int i = 0; i < count; i++) {
+    Entry entry;
+    if (PathOf(buses[i], FMOD_Studio_Bus_GetPath, &entry.path)) {
+      FMOD_Studio_Bus_GetID(buses[i], &entry.id);
+      metadata->buses[entry.path] = entry;
+    }
+  }
+
+  FMOD_Studio_Bank_GetVCACount(bank, &count);
+  std::vector<FMOD_STUDIO_VCA*> vcas(count);
+  if (count > 0 &&
+      !Check(FMOD_Studio_Bank_GetVCAList(bank, vcas.data(), count, &count),
+             "GetVCAList")) {
+    return false;
+  }
+  for (int i = 0; i < count; i++) {
+    Entry entry;
+    if (PathOf(vcas[i], FMOD_Studio_VCA_GetPath, &entry.path)) {
+      FMOD_Studio_VCA_GetID(vcas[i], &entry.id);
+      metadata->vcas[entry.path] = entry;
+    }
+  }
+  return true;
+}
+
+bool ReadGlobalParameters(FMOD_STUDIO_SYSTEM* studio, Metadata* metadata) {
+  int count = 0;
+  FMOD_Studio_System_GetParameterDescriptionCount(studio, &count);
+  std::vector<FMOD_STUDIO_PARAMETER_DESCRIPTION> descriptions(count);
+  if (count > 0 &&
+      !Check(FMOD_Studio_System_GetParameterDescriptionList(
+                 studio, descriptions.data(), count, &count),
+             "GetParameterDescriptionList")) {
+    return false;
+  }
+  for (int i = 0; i < count; i++) {
+    if (descriptions[i].flags & (FMOD_STUDIO_PARAMETER_READONLY |
+                                 FMOD_STUDIO_PARAMETER_AUTOMATIC)) {
+      continue;
+    }
+    Parameter parameter;
+    parameter.name = descriptions[i].name;
+    parameter.id = descriptions[i].id;
+    metadata->parameters["\n" + parameter.name] = parameter;
+  }
+  return true;
+}
+
+bool ReadBanks(const std::vector<std::string>& files, Metadata* metadata) {
+  FMOD_STUDIO_SYSTEM* studio = nullptr;
+  FMOD_SYSTEM* core = nullptr;
+  if (!Check(FMOD_Studio_System_Create(&studio, FMOD_VERSION),
+             "Studio_System_Create")) {
+    return false;
+  }
+  // Metadata only; nothing is played.
+  bool ok = Check(FMOD_Studio_System_GetCoreSystem(studio, &core),
+                  "GetCoreSystem") &&
+            Check(FMOD_System_SetOutput(core, FMOD_OUTPUTTYPE_NOSOUND),
+                  "SetOutput") &&
+            Check(FMOD_Studio_System_Initialize(studio, 32,
+                                                FMOD_STUDIO_INIT_NORMAL,
+                                                FMOD_INIT_NORMAL, nullptr),
+                  "Studio_System_Initialize");
+
+  std::vector<FMOD_STUDIO_BANK*> banks;
+  for (size_t i = 0; ok && i < files.size(); i++) {
+    FMOD_STUDIO_BANK* bank = nullptr;
+    ok = Check(FMOD_Studio_System_LoadBankFile(studio, files[i].c_str(),
+                                               FMOD_STUDIO_LOAD_BANK_NORMAL,
+                                               &bank),
+               files[i].c_str());
+    if (ok) {
+      banks.push_back(bank);
+      metadata->bank_names.push_back(BaseName(files[i]));
+    }
+  }
+  for (size_t i = 0; ok && i < banks.size(); i++) {
+    ok = ReadEvents(banks[i], metadata) && ReadBuses(banks[i], metadata);
+  }
+  ok = ok && ReadGlobalParameters(studio, metadata);
+  FMOD_Studio_System_Release(studio);
+  return ok;
+}
+
+bool IsReserved(const std::string& name) {
+  // Dart reserved words, plus Object members a static cannot shadow.
+  static const char* const kReserved[] = {
+      "assert",   "break",    "case",        "catch",        "class",
+      "const",    "continue", "default",     "do",           "else",
+      "enum",     "extends",  "false",       "final",        "finally",
+      "for",      "if",       "in",          "is",           "new",
+      "null",     "rethrow",  "return",      "super",        "switch",
+      "this",     "throw",    "true",        "try",          "var",
+      "void",     "while",    "with",        "hashCode",     "toString",
+      "runtimeType", "noSuchMethod"};
+  for (const char* reserved : kReserved) {
+    if (name == reserved) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// lowerCamelCase Dart identifier for the part of a path after its scheme:
+// "event:/UI/Menu Open" gives "uiMenuOpen".
+std::string Identifier(const std::string& text) {
+  size_t scheme = text.find(":/");
+  size_t start = scheme == std::string::npos ? 0 : scheme + 2;
+  std::vector<std::string> words;
+  std::string word;
+  for (size_t i = start; i <= text.size(); i++) {
+    char c = i < text.size() ? text[i] : '\0';
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      word += c;
+    } else if (!word.empty()) {
+      words.push_back(word);
+      word.clear();
+    }
+  }
+  std::string name;
+  for (size_t i = 0; i < words.size(); i++) {
+    std::string w = words[i];
+    if (i == 0) {
+      // Lowercase a leading capital run, keeping the capital that starts
+      // the next word: "UIClick" gives "uiClick".
+      size_t run = 0;
+      while (run < w.size() &&
+             std::isupper(static_cast<unsigned char>(w[run]))) {
+        run++;
+      }
+      if (run > 1 && run < w.size() &&
+          std::islower(static_cast<unsigned char>(w[run]))) {
+        run--;
+      }
+      for (size_t j = 0; j < std::max<size_t>(run, 1); j++) {
+        w[j] = static_cast<char>(
+            std::tolower(static_cast<unsigned char>(w[j])));
+      }
+    } else {
+      w[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(w[0])));
+    }
+    name += w;
+  }
+  if (name.empty()) {
+    return name;
+  }
+  if (std::isdigit(static_cast<unsigned char>(name[0]))) {
+    name = "$" + name;
+  }
+  if (IsReserved(name)) {
+    name += "_";
+  }
+  return name;
+}
+
+// Makes name unique within one generated class.
+std::string Unique(std::string name, std::set<std::string>* used) {
+  std::string candidate = name;
+  for (int n = 2; !used->insert(candidate).second; n++) {
+    candidate = name + std::to_string(n);
+  }
+  return candidate;
+}
+
+std::string DartString(const std::string& text) {
+  std::string out = "'";
+  for (char c : text) {
+    if (c == '\'' || c == '\\' || c == '$') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "'";
+}
+
+std::string Hex32(uint32_t value) {
+  char buffer[16];
+  std::snprintf(buffer, sizeof(buffer), "0x%08x", value);
+  return buffer;
+}
+
+// The four little-endian words FmodGuid holds.
+std::string GuidLiteral(const FMOD_GUID& id) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&id);
+  std::string literal = "FmodGuid(";
+  for (int word = 0; word < 4; word++) {
+    uint32_t value = 0;
+    for (int byte = 3; byte >= 0; byte--) {
+      value = (value << 8) | bytes[word * 4 + byte];
+    }
+    literal += (word > 0 ? ", " : "") + Hex32(value);
+  }
+  return literal + ")";
+}
+
+void WriteEntries(FILE* out, const std::string& class_name,
+                  const char* summary, const char* type,
+                  const std::map<std::string, Entry>& entries) {
+  std::fprintf(out, "\n/// %s\nabstract final class %s {%s", summary,
+               class_name.c_str(), entries.empty() ? "" : "\n");
+  std::set<std::string> used;
+  for (const auto& pair : entries) {
+    const Entry& entry = pair.second;
+    if (!used.empty()) {
+      std::fprintf(out, "\n");
+    }
+    std::string name = Identifier(entry.path);
+    if (name.empty()) {
+      // bus:/ and vca:/ roots.
+      name = "master";
+    }
+    name = Unique(name, &used);
+    std::fprintf(out, "  /// `%s`\n  static const %s = %s(\n    %s,\n    %s,\n"
+                 "  );\n",
+                 entry.path.c_str(), name.c_str(), type,
+                 DartString(entry.path).c_str(),
+                 GuidLiteral(entry.id).c_str());
+  }
+  std::fprintf(out, "}\n");
+}
+
+void WriteParameters(FILE* out, const std::string& class_name,
+                     const std::map<std::string, Parameter>& parameters) {
+  std::fprintf(out,
+               "\n/// Parameters setParameter can write, named after their "
+               "event;\n/// global parameters are prefixed with global.\n"
+               "abstract final class %s {%s",
+               class_name.c_str(), parameters.empty() ? "" : "\n");
+  std::set<std::string> used;
+  for (const auto& pair : parameters) {
+    const Parameter& parameter = pair.second;
+    if (!used.empty()) {
+      std::fprintf(out, "\n");
+    }
+    bool global = parameter.event_path.empty();
+    std::string name =
+        Unique(Identifier((global ? "global/" : parameter.event_path + "/") +
+                          parameter.name),
+               &used);
+    std::string doc = "`" + parameter.name + "`" +
+                      (global ? " (global)"
+                              : " of `" + parameter.event_path + "`");
+    std::fprintf(out, "  /// %s\n", doc.c_str());
+    std::fprintf(out,
+                 "  static const %s = FmodParameterRef(\n    %s,\n"
+                 "    %s,\n    %s,\n  );\n",
+                 name.c_str(), DartString(parameter.name).c_str(),
+                 Hex32(parameter.id.data1).c_str(),
+                 Hex32(parameter.id.data2).c_str());
+  }
+  std::fprintf(out, "}\n");
+}
+
+void WriteDart(FILE* out, const Options& options, const Metadata& metadata) {
+  std::fprintf(out, "// Generated by tool/bank_codegen from");
+  for (size_t i = 0; i < metadata.bank_names.size(); i++) {
+    std::fprintf(out, "%s %s", i > 0 ? "," : "",
+                 metadata.bank_names[i].c_str());
+  }
+  std::fprintf(out,
+               ".\n// Do not edit; run the tool again when the banks "
+               "change.\n\n"
+               "import 'package:fmod_flutter/fmod_flutter.dart';\n");
+  const std::string& prefix = options.prefix;
+  WriteEntries(out, prefix + "Events", "Events in the banks.",
+               "FmodEventRef", metadata.events);
+  WriteEntries(out, prefix + "Snapshots", "Snapshots in the banks.",
+               "FmodEventRef", metadata.snapshots);
+  WriteEntries(out, prefix + "Buses", "Mixer buses in the banks.",
+               "FmodBusRef", metadata.buses);
+  WriteEntries(out, prefix + "Vcas", "VCAs in the banks.", "FmodVcaRef",
+               metadata.vcas);
+  WriteParameters(out, prefix + "Parameters", metadata.parameters);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+  std::vector<std::string> files = BankFiles(options.inputs);
+  if (files.empty()) {
+    std::fprintf(stderr, "bank_codegen: no .bank files found\n");
+    return 1;
+  }
+  Metadata metadata;
+  if (!ReadBanks(files, &metadata)) {
+    return 1;
+  }
+
+  FILE* out = stdout;
+  if (!options.out_path.empty()) {
+    out = std::fopen(options.out_path.c_str(), "w");
+    if (out == nullptr) {
+      std::fprintf(stderr, "bank_codegen: cannot write %s\n",
+                   options.out_path.c_str());
+      return 1;
+    }
+  }
+  WriteDart(out, options, metadata);
+  if (out != stdout) {
+    std::fclose(out);
+    std::fprintf(stderr,
+                 "bank_codegen: %zu events, %zu snapshots, %zu buses, "
+                 "%zu VCAs, %zu parameters -> %s\n",
+                 metadata.events.size(), metadata.snapshots.size(),
+                 metadata.buses.size(), metadata.vcas.size(),
+                 metadata.parameters.size(), options.out_path.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Checks where BeatTargetClock() places scheduled beats on the mixer DSP
+// clock, including schedules armed after their beat, which fire at once on
+// the current clock.
+//
+// Usage: beat_clock_test
+
+#include "beat_clock.h"
+
+#include <cstdio>
+
+namespace {
+
+int failures = 0;
+
+// The last timeline beat of an event, as the bridges anchor it.
+struct Anchor {
+  unsigned long long clock;
+  int bar;
+  int beat;
+  int beats_per_bar;
+  float tempo;
+  int sample_rate;
+};
+
+void Check(const char* test, const Anchor& anchor, int bar, int beat,
+           unsigned long long now, unsigned long long expected) {
+  unsigned long long target = fmod_flutter::BeatTargetClock(
+      anchor.clock, anchor.bar, anchor.beat, anchor.beats_per_bar,
+      anchor.tempo, anchor.sample_rate, bar, beat, now);
+  bool ok = target == expected;
+  if (!ok) {
+    std::fprintf(stderr, "FAIL %s: bar %d beat %d at %llu: %llu, not %llu\n",
+                 test, bar, beat, now, target, expected);
+    failures++;
+  }
+  std::printf("%-42s %s\n", test, ok ? "ok" : "failed");
+}
+
+}  // namespace
+
+int main() {
+  // 120 BPM at 48 kHz: 24000 samples per beat.
+  const Anchor k44At120 = {1000000, 3, 2, 4, 120.0f, 48000};
+  // 130 BPM at 48 kHz: 22153.85 samples per beat, truncated.
+  const Anchor k34At130 = {500000, 1, 1, 3, 130.0f, 48000};
+  // Anchored shortly after the mixer started.
+  const Anchor kEarly = {100000, 3, 2, 4, 120.0f, 48000};
+
+  Check("anchor beat itself", k44At120, 3, 2, 1000000, 1000000);
+  Check("next beat", k44At120, 3, 3, 1000000, 1024000);
+  Check("across the bar line", k44At120, 4, 1, 1000000, 1072000);
+  Check("two bars ahead", k44At120, 5, 2, 1010000, 1192000);
+  Check("fractional samples per beat", k34At130, 2, 2, 500000, 588615);
+  Check("target exactly now", k44At120, 3, 3, 1024000, 1024000);
+
+  // Late schedules land on now, so they fire on the tick that arms them.
+  Check("late: beat passed since the anchor", k44At120, 3, 3, 1030000,
+        1030000);
+  Check("late: beat before the anchor", k44At120, 2, 4, 1000000, 1000000);
+  Check("late: beat before clock zero", kEarly, 1, 1, 100000, 100000);
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,96 @@
+# Shared setup for the Linux tools under tool/.
+#
+# Each tool directory stays its own CMake project, so it builds on its own
+# with `cmake -S tool/<name> -B build/<name>`, and declares its executables
+# with fmod_tool():
+#
+#   include(../cmake/FmodTool.cmake)
+#   fmod_tool(<name>
+#     SOURCES <tool sources...>
+#     [SHARED <files in src/...>]
+#     [CORE_ONLY | HEADERS_ONLY]
+#     [TEST [TEST_ARGS <args...>]])
+#
+# SHARED names sources of the plugin's native bridges, relative to src/.
+# Tools link the FMOD Core and Studio libraries; CORE_ONLY links Core only
+# and HEADERS_ONLY links neither, for tools that call no FMOD function or
+# define stand-ins for the ones they call; only those build when the Linux
+# SDK is missing, the others are skipped with a warning. TEST registers the
+# tool with CTest, run with TEST_ARGS; it passes when the tool exits 0.
+
+set(CMAKE_CXX_STANDARD 11)
+set(CMAKE_CXX_STANDARD_REQUIRED ON)
+# The benchmarks mean nothing unoptimized.
+if(NOT CMAKE_BUILD_TYPE)
+  set(CMAKE_BUILD_TYPE Release)
+endif()
+
+enable_testing()
+
+# Shared with the plugin's native bridges
+set(FMOD_TOOL_SHARED_SRC_DIR "${CMAKE_CURRENT_LIST_DIR}/../../src")
+
+# FMOD Studio API for Linux, extracted from fmodstudioapi*linux.tar.gz into
+# engines/linux/ (see engines/README.md), or pass -DFMOD_API_DIR=<...>/api.
+set(FMOD_API_DIR "" CACHE PATH "FMOD Studio API for Linux (the api/ directory)")
+if(NOT FMOD_API_DIR)
+  file(GLOB FMOD_API_CANDIDATES
+    "${CMAKE_CURRENT_LIST_DIR}/../../engines/linux/fmodstudioapi*linux/api")
+  if(FMOD_API_CANDIDATES)
+    list(GET FMOD_API_CANDIDATES 0 FMOD_API_DIR)
+  endif()
+endif()
+
+if(CMAKE_SYSTEM_PROCESSOR MATCHES "aarch64|arm64")
+  set(FMOD_ARCH "arm64")
+else()
+  set(FMOD_ARCH "x86_64")
+endif()
+
+if(FMOD_API_DIR)
+  set(FMOD_INCLUDE_DIRS "${FMOD_API_DIR}/core/inc" "${FMOD_API_DIR}/studio/inc")
+  set(FMOD_CORE_LIB_DIR "${FMOD_API_DIR}/core/lib/${FMOD_ARCH}")
+  set(FMOD_STUDIO_LIB_DIR "${FMOD_API_DIR}/studio/lib/${FMOD_ARCH}")
+else()
+  # The headers vendored for Android are enough for HEADERS_ONLY tools.
+  set(FMOD_INCLUDE_DIRS "${CMAKE_CURRENT_LIST_DIR}/../../android/libs/include")
+endif()
+
+function(fmod_tool name)
+  cmake_parse_arguments(TOOL "CORE_ONLY;HEADERS_ONLY;TEST" ""
+    "SOURCES;SHARED;TEST_ARGS" ${ARGN})
+
+  if(NOT TOOL_HEADERS_ONLY AND NOT FMOD_API_DIR)
+    message(WARNING
+      "Skipping ${name}: FMOD Studio API for Linux not found; set FMOD_API_DIR")
+    return()
+  endif()
+
+  set(shared_sources "")
+  foreach(file ${TOOL_SHARED})
+    list(APPEND shared_sources "${FMOD_TOOL_SHARED_SRC_DIR}/${file}")
+  endforeach()
+
+  add_executable(${name} ${TOOL_SOURCES} ${shared_sources})
+  target_include_directories(${name} SYSTEM PRIVATE ${FMOD_INCLUDE_DIRS})
+  target_include_directories(${name} PRIVATE "${FMOD_TOOL_SHARED_SRC_DIR}")
+
+  if(NOT TOOL_HEADERS_ONLY)
+    if(TOOL_CORE_ONLY)
+      set(lib_dirs "${FMOD_CORE_LIB_DIR}")
+      target_link_libraries(${name} PRIVATE "${FMOD_CORE_LIB_DIR}/libfmod.so")
+    else()
+      set(lib_dirs "${FMOD_CORE_LIB_DIR};${FMOD_STUDIO_LIB_DIR}")
+      target_link_libraries(${name} PRIVATE
+        "${FMOD_CORE_LIB_DIR}/libfmod.so"
+        "${FMOD_STUDIO_LIB_DIR}/libfmodstudio.so"
+      )
+    endif()
+    # Run from the build directory without installing the FMOD libraries
+    set_target_properties(${name} PROPERTIES BUILD_RPATH "${lib_dirs}")
+  endif()
+
+  if(TOOL_TEST)
+    add_test(NAME ${name} COMMAND ${name} ${TOOL_TEST_ARGS})
+  endif()
+endfunction()
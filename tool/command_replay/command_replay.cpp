@@ -0,0 +1,325 @@
+// Replays an FMOD Studio command capture as a repeatable benchmark.
+//
+// Captures are recorded in the app with FmodService.startCommandCapture.
+// The replay loads the same banks, mixes into a non-realtime output with
+// Studio updating synchronously on this thread, and plays the commands back
+// at full speed. Every cost of the session therefore lands in the timed
+// Studio update calls, independent of audio hardware. The mix can be
+// written to a .wav file, or kept in memory and summarized, for comparison
+// against a golden render.
+//
+// Usage: command_replay <capture> [--banks DIR] [--runs N] [--realtime]
+//                       [--slowest N] [--wav FILE | --memory]
+
+#include <fmod.h>
+#include <fmod_errors.h>
+#include <fmod_studio.h>
+#include <sys/resource.h>
+
+#include "offline_output.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  std::string capture_path;
+  std::string bank_dir;
+  int runs = 1;
+  bool realtime = false;
+  int slowest = 5;
+  int output_mode = FMOD_FLUTTER_OUTPUT_NOSOUND_NRT;
+  std::string wav_path;
+};
+
+// One Studio update and the command the replay had reached before it.
+struct Frame {
+  double ms;
+  int command_index;
+};
+
+struct RunStats {
+  double wall_ms = 0.0;
+  double process_cpu_ms = 0.0;
+  int command_count = 0;
+  float replay_length = 0.0f;
+  std::vector<Frame> frames;
+  FMOD_STUDIO_CPU_USAGE studio_cpu = FMOD_STUDIO_CPU_USAGE();
+  FMOD_CPU_USAGE core_cpu = FMOD_CPU_USAGE();
+  double mixed_seconds = 0.0;
+  // MEMORY_NRT only.
+  double peak = 0.0;
+  double rms = 0.0;
+};
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: command_replay <capture> [options]\n"
+               "  --banks DIR    directory of the banks the capture loads\n"
+               "                 (default: the capture's directory)\n"
+               "  --runs N       replay N times and report each run\n"
+               "  --realtime     keep the captured timing instead of\n"
+               "                 replaying at full speed\n"
+               "  --slowest N    list the N slowest updates (default 5)\n"
+               "  --wav FILE     write the mix to FILE\n"
+               "  --memory       keep the mix in memory and report its\n"
+               "                 peak and RMS level\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--banks") == 0 && has_value) {
+      options->bank_dir = argv[++i];
+    } else if (std::strcmp(arg, "--runs") == 0 && has_value) {
+      options->runs = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--slowest") == 0 && has_value) {
+      options->slowest = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--wav") == 0 && has_value) {
+      options->output_mode = FMOD_FLUTTER_OUTPUT_WAVWRITER_NRT;
+      options->wav_path = argv[++i];
+    } else if (std::strcmp(arg, "--memory") == 0) {
+      options->output_mode = FMOD_FLUTTER_OUTPUT_MEMORY_NRT;
+    } else if (std::strcmp(arg, "--realtime") == 0) {
+      options->realtime = true;
+    } else if (arg[0] != '-' && options->capture_path.empty()) {
+      options->capture_path = arg;
+    } else {
+      return false;
+    }
+  }
+  if (options->capture_path.empty() || options->runs < 1) {
+    return false;
+  }
+  if (options->bank_dir.empty()) {
+    size_t slash = options->capture_path.find_last_of('/');
+    options->bank_dir = slash == std::string::npos
+                            ? "."
+                            : options->capture_path.substr(0, slash);
+  }
+  return true;
+}
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "command_replay: %s failed: %d - %s\n", what, result,
+                 FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+double ProcessCpuMs() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Value at fraction q of ascending samples.
+double Percentile(const std::vector<double>& sorted, double q) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+bool Replay(const Options& options, FMOD_STUDIO_SYSTEM* studio,
+            RunStats* stats) {
+  FMOD_STUDIO_COMMANDREPLAY* replay = nullptr;
+  FMOD_STUDIO_COMMANDREPLAY_FLAGS flags =
+      options.realtime ? FMOD_STUDIO_COMMANDREPLAY_NORMAL
+                       : FMOD_STUDIO_COMMANDREPLAY_FAST_FORWARD;
+  if (!Check(FMOD_Studio_System_LoadCommandReplay(
+                 studio, options.capture_path.c_str(), flags, &replay),
+             "LoadCommandReplay")) {
+    return false;
+  }
+  FMOD_Studio_CommandReplay_GetCommandCount(replay, &stats->command_count);
+  FMOD_Studio_CommandReplay_GetLength(replay, &stats->replay_length);
+
+  bool ok = Check(FMOD_Studio_CommandReplay_SetBankPath(
+                      replay, options.bank_dir.c_str()),
+                  "SetBankPath") &&
+            Check(FMOD_Studio_CommandReplay_Start(replay), "Start");
+
+  double cpu_start = ProcessCpuMs();
+  Clock::time_point start = Clock::now();
+  FMOD_STUDIO_PLAYBACK_STATE state = FMOD_STUDIO_PLAYBACK_PLAYING;
+  while (ok && state != FMOD_STUDIO_PLAYBACK_STOPPED) {
+    Frame frame = {0.0, 0};
+    FMOD_Studio_CommandReplay_GetCurrentCommand(replay, &frame.command_index,
+                                                nullptr);
+    Clock::time_point update_start = Clock::now();
+    ok = Check(FMOD_Studio_System_Update(studio), "Update");
+    frame.ms = ElapsedMs(update_start, Clock::now());
+    stats->frames.push_back(frame);
+    FMOD_Studio_CommandReplay_GetPlaybackState(replay, &state);
+  }
+  stats->wall_ms = ElapsedMs(start, Clock::now());
+  stats->process_cpu_ms = ProcessCpuMs() - cpu_start;
+  FMOD_Studio_System_GetCPUUsage(studio, &stats->studio_cpu,
+                                 &stats->core_cpu);
+
+  if (ok && options.slowest > 0) {
+    std::vector<Frame> slowest = stats->frames;
+    size_t count = std::min(slowest.size(),
+                            static_cast<size_t>(options.slowest));
+    std::partial_sort(slowest.begin(), slowest.begin() + count,
+                      slowest.end(), [](const Frame& a, const Frame& b) {
+                        return a.ms > b.ms;
+                      });
+    std::printf("  slowest updates:\n");
+    for (size_t i = 0; i < count; i++) {
+      FMOD_STUDIO_COMMAND_INFO info;
+      std::string name = "?";
+      if (FMOD_Studio_CommandReplay_GetCommandInfo(
+              replay, slowest[i].command_index, &info) == FMOD_OK &&
+          info.commandname != nullptr) {
+        name = info.commandname;
+      }
+      std::printf("    %8.3f ms  at command %d (%s)\n", slowest[i].ms,
+                  slowest[i].command_index, name.c_str());
+    }
+  }
+
+  FMOD_Studio_CommandReplay_Release(replay);
+  return ok;
+}
+
+void PrintStats(const RunStats& stats) {
+  std::vector<double> times;
+  times.reserve(stats.frames.size());
+  double total_ms = 0.0;
+  for (const Frame& frame : stats.frames) {
+    times.push_back(frame.ms);
+    total_ms += frame.ms;
+  }
+  std::sort(times.begin(), times.end());
+
+  std::printf("  commands:        %d over %.2f s captured\n",
+              stats.command_count, stats.replay_length);
+  std::printf("  wall time:       %.2f ms (%.0f commands/s)\n", stats.wall_ms,
+              stats.wall_ms > 0.0
+                  ? stats.command_count * 1000.0 / stats.wall_ms
+                  : 0.0);
+  std::printf("  process cpu:     %.2f ms\n", stats.process_cpu_ms);
+  std::printf("  audio mixed:     %.2f s (%.1fx realtime)\n",
+              stats.mixed_seconds,
+              stats.wall_ms > 0.0 ? stats.mixed_seconds * 1000.0 / stats.wall_ms
+                                  : 0.0);
+  if (stats.peak > 0.0 || stats.rms > 0.0) {
+    std::printf("  mix level:       peak %.4f, rms %.4f\n", stats.peak,
+                stats.rms);
+  }
+  std::printf("  updates:         %zu, mean %.3f ms, p50 %.3f, p95 %.3f, "
+              "p99 %.3f, max %.3f\n",
+              times.size(), times.empty() ? 0.0 : total_ms / times.size(),
+              Percentile(times, 0.5), Percentile(times, 0.95),
+              Percentile(times, 0.99), times.empty() ? 0.0 : times.back());
+  std::printf("  fmod cpu:        studio %.1f%%, dsp %.1f%%, stream %.1f%%, "
+              "update %.1f%%\n",
+              stats.studio_cpu.update, stats.core_cpu.dsp,
+              stats.core_cpu.stream, stats.core_cpu.update);
+}
+
+// Peak and RMS level of an interleaved mix.
+void MeasureMix(const std::vector<float>& samples, RunStats* stats) {
+  double sum = 0.0;
+  for (float sample : samples) {
+    stats->peak = std::max(stats->peak, static_cast<double>(std::fabs(sample)));
+    sum += static_cast<double>(sample) * sample;
+  }
+  stats->rms = samples.empty() ? 0.0 : std::sqrt(sum / samples.size());
+}
+
+bool RunOnce(const Options& options, RunStats* stats) {
+  FMOD_STUDIO_SYSTEM* studio = nullptr;
+  FMOD_SYSTEM* core = nullptr;
+  if (!Check(FMOD_Studio_System_Create(&studio, FMOD_VERSION),
+             "Studio_System_Create")) {
+    return false;
+  }
+  // A non-realtime output mixes only when Studio updates, and a synchronous
+  // update does that on this thread, so the update timings below cover the
+  // whole cost of the session.
+  fmod_flutter::OfflineOutput output;
+  bool ok = Check(FMOD_Studio_System_GetCoreSystem(studio, &core),
+                  "GetCoreSystem");
+  if (ok && !output.Configure(core, options.output_mode,
+                              options.wav_path.c_str())) {
+    ok = Check(output.last_result(), "SetOutput");
+  }
+  ok = ok &&
+       Check(FMOD_Studio_System_Initialize(
+                 studio, 1024, output.studio_init_flags(),
+                 output.core_init_flags(), output.extra_driver_data()),
+             "Studio_System_Initialize") &&
+       Replay(options, studio, stats);
+  if (ok) {
+    int rate = 0;
+    unsigned int block_length = 0;
+    FMOD_System_GetSoftwareFormat(core, &rate, nullptr, nullptr);
+    FMOD_System_GetDSPBufferSize(core, &block_length, nullptr);
+    if (rate > 0) {
+      stats->mixed_seconds =
+          static_cast<double>(stats->frames.size()) * block_length / rate;
+    }
+    MeasureMix(output.captured(), stats);
+  }
+  FMOD_Studio_System_Release(studio);
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  std::vector<double> wall_times;
+  for (int run = 1; run <= options.runs; run++) {
+    std::printf("run %d/%d: %s\n", run, options.runs,
+                options.capture_path.c_str());
+    RunStats stats;
+    if (!RunOnce(options, &stats)) {
+      return 1;
+    }
+    PrintStats(stats);
+    wall_times.push_back(stats.wall_ms);
+  }
+
+  int current_bytes = 0;
+  int peak_bytes = 0;
+  FMOD_Memory_GetStats(&current_bytes, &peak_bytes, 0);
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::printf("memory: fmod peak %.1f KiB, process peak rss %ld KiB\n",
+              peak_bytes / 1024.0, usage.ru_maxrss);
+  if (options.runs > 1) {
+    std::sort(wall_times.begin(), wall_times.end());
+    std::printf("wall time over %d runs: min %.2f ms, median %.2f ms, "
+                "max %.2f ms\n",
+                options.runs, wall_times.front(),
+                Percentile(wall_times, 0.5), wall_times.back());
+  }
+  return 0;
+}
@@ -0,0 +1,242 @@
+// Measures .fca decode throughput on Linux.
+//
+// Decodes the file in memory with the scalar reference and with the SIMD
+// kernels this CPU selects, checking they agree, then times FMOD loading it
+// as a sample through the registered codec. --compare times FMOD loading
+// another file the same way, e.g. the same audio as Vorbis (.ogg).
+//
+// Usage: fca_bench <file.fca> [--runs N] [--compare FILE]
+
+#include <fmod.h>
+#include <fmod_errors.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "compact_codec.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  std::string path;
+  std::string compare_path;
+  int runs = 10;
+};
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: fca_bench <file.fca> [options]\n"
+               "  --runs N        time N decodes of each kind (default 10)\n"
+               "  --compare FILE  also time FMOD loading FILE, e.g. the\n"
+               "                  same audio as Vorbis\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--runs") == 0 && has_value) {
+      options->runs = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--compare") == 0 && has_value) {
+      options->compare_path = argv[++i];
+    } else if (arg[0] != '-' && options->path.empty()) {
+      options->path = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options->path.empty() && options->runs >= 1;
+}
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "fca_bench: %s failed: %d - %s\n", what, result,
+                 FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+void PrintRate(const char* label, double ms, double samples,
+               double seconds) {
+  std::printf("  %-22s %8.2f ms  %8.1f Msamples/s  %8.0fx realtime\n", label,
+              ms, samples / ms / 1000.0, seconds * 1000.0 / ms);
+}
+
+// Median time to decode every frame of data with kernels into out.
+double TimeKernels(const fmod_flutter::CompactCodecKernels& kernels,
+                   const std::vector<uint8_t>& data,
+                   const fmod_flutter::CompactHeader& header, int runs,
+                   std::vector<int16_t>* out) {
+  uint32_t frames = fmod_flutter::CompactFrameCount(header.length);
+  size_t frame_bytes = fmod_flutter::CompactFrameBytes(header.channels);
+  size_t frame_samples =
+      static_cast<size_t>(fmod_flutter::kCompactFrameSamples) *
+      header.channels;
+  std::vector<int16_t> scratch(fmod_flutter::kCompactFrameSamples);
+  out->resize(frames * frame_samples);
+  std::vector<double> times;
+  for (int run = 0; run < runs; run++) {
+    Clock::time_point start = Clock::now();
+    for (uint32_t f = 0; f < frames; f++) {
+      fmod_flutter::DecodeCompactFrame(
+          kernels,
+          data.data() + fmod_flutter::kCompactHeaderBytes + f * frame_bytes,
+          header.channels, scratch.data(), out->data() + f * frame_samples);
+    }
+    times.push_back(ElapsedMs(start));
+  }
+  return Median(times);
+}
+
+// Median time for FMOD to load path as a sample, decoding all of it.
+bool TimeFmodLoad(FMOD_SYSTEM* system, const std::string& path, int runs,
+                  double* ms, double* samples, double* seconds) {
+  std::vector<double> times;
+  for (int run = 0; run < runs; run++) {
+    FMOD_SOUND* sound = nullptr;
+    Clock::time_point start = Clock::now();
+    if (!Check(FMOD_System_CreateSound(system, path.c_str(),
+                                       FMOD_CREATESAMPLE, nullptr, &sound),
+               path.c_str())) {
+      return false;
+    }
+    times.push_back(ElapsedMs(start));
+    if (run == 0) {
+      unsigned int length = 0;
+      float rate = 0.0f;
+      int channels = 0;
+      FMOD_Sound_GetLength(sound, &length, FMOD_TIMEUNIT_PCM);
+      FMOD_Sound_GetDefaults(sound, &rate, nullptr);
+      FMOD_Sound_GetFormat(sound, nullptr, nullptr, &channels, nullptr);
+      *samples = static_cast<double>(length) * channels;
+      *seconds = rate > 0.0f ? length / rate : 0.0;
+    }
+    FMOD_Sound_Release(sound);
+  }
+  *ms = Median(times);
+  return true;
+}
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>* data) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t buffer[65536];
+  size_t read;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data->insert(data->end(), buffer, buffer + read);
+  }
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  std::vector<uint8_t> data;
+  fmod_flutter::CompactHeader header;
+  if (!ReadFile(options.path, &data) ||
+      data.size() < static_cast<size_t>(fmod_flutter::kCompactHeaderBytes) ||
+      !fmod_flutter::ReadCompactHeader(data.data(), &header) ||
+      data.size() < fmod_flutter::kCompactHeaderBytes +
+                        fmod_flutter::CompactFrameCount(header.length) *
+                            fmod_flutter::CompactFrameBytes(header.channels)) {
+    std::fprintf(stderr, "fca_bench: %s is not a complete .fca file\n",
+                 options.path.c_str());
+    return 1;
+  }
+  double samples = static_cast<double>(header.length) * header.channels;
+  double seconds = static_cast<double>(header.length) / header.sample_rate;
+  std::printf("%s: %d ch, %d Hz, %.2f s, median of %d runs\n",
+              options.path.c_str(), header.channels, header.sample_rate,
+              seconds, options.runs);
+
+  const fmod_flutter::CompactCodecKernels& scalar =
+      fmod_flutter::GetScalarCompactCodecKernels();
+  const fmod_flutter::CompactCodecKernels& selected =
+      fmod_flutter::GetCompactCodecKernels();
+  std::vector<int16_t> reference;
+  std::vector<int16_t> output;
+  std::printf("in-memory decode:\n");
+  double scalar_ms =
+      TimeKernels(scalar, data, header, options.runs, &reference);
+  PrintRate(scalar.name, scalar_ms, samples, seconds);
+  if (&selected != &scalar) {
+    double selected_ms =
+        TimeKernels(selected, data, header, options.runs, &output);
+    PrintRate(selected.name, selected_ms, samples, seconds);
+    if (output != reference) {
+      std::fprintf(stderr, "fca_bench: %s output differs from scalar\n",
+                   selected.name);
+      return 1;
+    }
+    std::printf("  %s is %.2fx scalar, bit-identical\n", selected.name,
+                scalar_ms / selected_ms);
+  }
+
+  // No device: only decoding is measured.
+  FMOD_SYSTEM* system = nullptr;
+  unsigned int handle = 0;
+  if (!Check(FMOD_System_Create(&system, FMOD_VERSION), "System_Create")) {
+    return 1;
+  }
+  bool ok =
+      Check(FMOD_System_SetOutput(system, FMOD_OUTPUTTYPE_NOSOUND_NRT),
+            "SetOutput") &&
+      Check(FMOD_System_Init(system, 32, FMOD_INIT_NORMAL, nullptr),
+            "System_Init") &&
+      Check(FMOD_System_RegisterCodec(
+                system,
+                const_cast<FMOD_CODEC_DESCRIPTION*>(
+                    fmod_flutter::GetCompactCodecDescription()),
+                &handle, 50),
+            "RegisterCodec");
+  if (ok) {
+    std::printf("FMOD load as sample:\n");
+    double ms = 0.0;
+    double fmod_samples = 0.0;
+    double fmod_seconds = 0.0;
+    ok = TimeFmodLoad(system, options.path, options.runs, &ms, &fmod_samples,
+                      &fmod_seconds);
+    if (ok) {
+      PrintRate(".fca", ms, fmod_samples, fmod_seconds);
+    }
+    if (ok && !options.compare_path.empty()) {
+      double compare_ms = 0.0;
+      ok = TimeFmodLoad(system, options.compare_path, options.runs,
+                        &compare_ms, &fmod_samples, &fmod_seconds);
+      if (ok) {
+        PrintRate(options.compare_path.c_str(), compare_ms, fmod_samples,
+                  fmod_seconds);
+      }
+    }
+  }
+  FMOD_System_Release(system);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+// Encodes a .wav file into the compact .fca format played by
+// FmodService.loadSound.
+//
+// Reads 16-bit, 24-bit and 32-bit integer PCM and 32-bit float .wav files,
+// then reports the size, the bit rate and the signal-to-noise ratio of the
+// decoded result against the 16-bit source.
+//
+// Usage: fca_encode <input.wav> <output.fca>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "compact_codec.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const unsigned int kFormatPcm = 1;
+const unsigned int kFormatFloat = 3;
+const unsigned int kFormatExtensible = 0xfffe;
+
+struct Wav {
+  int channels = 0;
+  int sample_rate = 0;
+  // Interleaved, converted to 16 bits.
+  std::vector<int16_t> samples;
+};
+
+unsigned int ReadLe(const unsigned char* p, int bytes) {
+  unsigned int value = 0;
+  for (int i = bytes - 1; i >= 0; i--) {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
+int16_t FloatToS16(float value) {
+  float scaled = std::round(value * 32767.0f);
+  return static_cast<int16_t>(
+      scaled < -32768.0f ? -32768.0f : (scaled > 32767.0f ? 32767.0f : scaled));
+}
+
+bool ReadFile(const char* path, std::vector<unsigned char>* data) {
+  FILE* file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  unsigned char buffer[65536];
+  size_t read;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data->insert(data->end(), buffer, buffer + read);
+  }
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  return ok;
+}
+
+bool ParseWav(const std::vector<unsigned char>& data, Wav* wav,
+              std::string* error) {
+  if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+      std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+    *error = "not a RIFF/WAVE file";
+    return false;
+  }
+  unsigned int format = 0;
+  int bits = 0;
+  const unsigned char* pcm = nullptr;
+  size_t pcm_bytes = 0;
+  size_t offset = 12;
+  while (offset + 8 <= data.size()) {
+    const unsigned char* chunk = data.data() + offset;
+    size_t size = ReadLe(chunk + 4, 4);
+    size_t available = data.size() - offset - 8;
+    if (size > available) {
+      size = available;
+    }
+    if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+      format = ReadLe(chunk + 8, 2);
+      wav->channels = static_cast<int>(ReadLe(chunk + 10, 2));
+      wav->sample_rate = static_cast<int>(ReadLe(chunk + 12, 4));
+      bits = static_cast<int>(ReadLe(chunk + 22, 2));
+      if (format == kFormatExtensible && size >= 26) {
+        // The sub-format GUID starts with the plain format tag.
+        format = ReadLe(chunk + 32, 2);
+      }
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      pcm = chunk + 8;
+      pcm_bytes = size;
+    }
+    offset += 8 + size + (size & 1);
+  }
+
+  bool supported = (format == kFormatPcm &&
+                    (bits == 16 || bits == 24 || bits == 32)) ||
+                   (format == kFormatFloat && bits == 32);
+  if (!supported || pcm == nullptr || wav->channels < 1 ||
+      wav->channels > fmod_flutter::kCompactMaxChannels) {
+    *error = "unsupported format (16/24/32-bit PCM or 32-bit float, 1-8 "
+             "channels)";
+    return false;
+  }
+
+  int bytes = bits / 8;
+  size_t count = pcm_bytes / bytes;
+  count -= count % wav->channels;
+  wav->samples.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    const unsigned char* p = pcm + i * bytes;
+    if (format == kFormatFloat) {
+      unsigned int bits32 = ReadLe(p, 4);
+      float value;
+      std::memcpy(&value, &bits32, sizeof(value));
+      wav->samples[i] = FloatToS16(value);
+    } else {
+      // Keep the top 16 bits.
+      wav->samples[i] = static_cast<int16_t>(ReadLe(p + bytes - 2, 2));
+    }
+  }
+  return true;
+}
+
+double SnrDb(const std::vector<int16_t>& source,
+             const std::vector<uint8_t>& encoded, int channels) {
+  fmod_flutter::CompactHeader header;
+  fmod_flutter::ReadCompactHeader(encoded.data(), &header);
+  std::vector<int16_t> scratch(fmod_flutter::kCompactFrameSamples);
+  std::vector<int16_t> frame(scratch.size() * channels);
+  double signal = 0.0;
+  double noise = 0.0;
+  size_t index = 0;
+  uint32_t frames = fmod_flutter::CompactFrameCount(header.length);
+  for (uint32_t f = 0; f < frames; f++) {
+    fmod_flutter::DecodeCompactFrame(
+        fmod_flutter::GetScalarCompactCodecKernels(),
+        encoded.data() + fmod_flutter::kCompactHeaderBytes +
+            f * fmod_flutter::CompactFrameBytes(channels),
+        channels, scratch.data(), frame.data());
+    for (size_t i = 0; i < frame.size() && index < source.size(); i++) {
+      double s = source[index++];
+      double d = s - frame[i];
+      signal += s * s;
+      noise += d * d;
+    }
+  }
+  return noise == 0.0 ? INFINITY : 10.0 * std::log10(signal / noise);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: fca_encode <input.wav> <output.fca>\n");
+    return 2;
+  }
+
+  std::vector<unsigned char> input;
+  Wav wav;
+  std::string error;
+  if (!ReadFile(argv[1], &input)) {
+    std::fprintf(stderr, "fca_encode: cannot read %s\n", argv[1]);
+    return 1;
+  }
+  if (!ParseWav(input, &wav, &error)) {
+    std::fprintf(stderr, "fca_encode: %s: %s\n", argv[1], error.c_str());
+    return 1;
+  }
+
+  uint32_t length = static_cast<uint32_t>(wav.samples.size() / wav.channels);
+  std::vector<uint8_t> encoded;
+  Clock::time_point start = Clock::now();
+  if (!fmod_flutter::EncodeCompactAudio(wav.samples.data(), length,
+                                        wav.channels, wav.sample_rate,
+                                        &encoded)) {
+    std::fprintf(stderr, "fca_encode: %s has no audio\n", argv[1]);
+    return 1;
+  }
+  double encode_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  FILE* file = std::fopen(argv[2], "wb");
+  if (file == nullptr ||
+      std::fwrite(encoded.data(), 1, encoded.size(), file) != encoded.size()) {
+    std::fprintf(stderr, "fca_encode: cannot write %s\n", argv[2]);
+    if (file != nullptr) {
+      std::fclose(file);
+    }
+    return 1;
+  }
+  std::fclose(file);
+
+  double seconds = static_cast<double>(length) / wav.sample_rate;
+  std::printf("%s: %d ch, %d Hz, %.2f s\n", argv[1], wav.channels,
+              wav.sample_rate, seconds);
+  std::printf("%s: %zu bytes, %.2f bits/sample, %.1f kbit/s, %.1f:1 vs "
+              "16-bit\n",
+              argv[2], encoded.size(),
+              encoded.size() * 8.0 / wav.samples.size(),
+              encoded.size() * 8.0 / seconds / 1000.0,
+              wav.samples.size() * 2.0 / encoded.size());
+  std::printf("encoded in %.1f ms, snr %.1f dB\n", encode_ms,
+              SnrDb(wav.samples, encoded, wav.channels));
+  return 0;
+}
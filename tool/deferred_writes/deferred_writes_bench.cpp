@@ -0,0 +1,320 @@
+// Measures what coalescing event instance writes saves on Linux.
+//
+// Plays a number of instances of one event and, on every update tick,
+// sets a parameter, the volume and the pitch of each instance many times,
+// as a gesture stream from Dart would. The same session runs twice: once
+// calling FMOD for every write, as the bridges used to, and once through
+// DeferredWrites, which the bridges now flush before each Studio update.
+// Both runs must leave every instance with the same final values.
+//
+// Studio updates synchronously on this thread into a non-realtime output,
+// so the timings cover the whole cost of each write and of the update that
+// processes it.
+//
+// Usage: deferred_writes_bench <banks dir> <event path> <parameter>
+//                              [--instances N] [--writes N] [--ticks N]
+
+#include <dirent.h>
+#include <fmod.h>
+#include <fmod_errors.h>
+#include <fmod_studio.h>
+
+#include "deferred_writes.h"
+#include "offline_output.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  std::string bank_dir;
+  std::string event_path;
+  std::string parameter;
+  int instances = 8;
+  int writes = 16;  // per instance per tick, of each kind
+  int ticks = 600;
+};
+
+struct RunStats {
+  int64_t writes = 0;
+  int64_t fmod_calls = 0;
+  double write_ms = 0.0;
+  double update_ms = 0.0;
+  double max_tick_ms = 0.0;
+  // Read back from every instance after the last update.
+  std::vector<float> final_values;
+};
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: deferred_writes_bench <banks dir> <event path> "
+               "<parameter> [options]\n"
+               "  --instances N  instances of the event to play (default 8)\n"
+               "  --writes N     parameter, volume and pitch writes per\n"
+               "                 instance per tick (default 16 each)\n"
+               "  --ticks N      update ticks to run (default 600)\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--instances") == 0 && has_value) {
+      options->instances = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--writes") == 0 && has_value) {
+      options->writes = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--ticks") == 0 && has_value) {
+      options->ticks = std::atoi(argv[++i]);
+    } else if (arg[0] != '-') {
+      positional.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  if (positional.size() != 3 || options->instances < 1 ||
+      options->writes < 1 || options->ticks < 1) {
+    return false;
+  }
+  options->bank_dir = positional[0];
+  options->event_path = positional[1];
+  options->parameter = positional[2];
+  return true;
+}
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "deferred_writes_bench: %s failed: %d - %s\n", what,
+                 result, FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Loads every .bank in dir, strings banks first.
+bool LoadBanks(FMOD_STUDIO_SYSTEM* studio, const std::string& dir) {
+  DIR* handle = opendir(dir.c_str());
+  if (handle == nullptr) {
+    std::fprintf(stderr, "deferred_writes_bench: cannot open %s\n",
+                 dir.c_str());
+    return false;
+  }
+  std::vector<std::string> names;
+  while (dirent* entry = readdir(handle)) {
+    std::string name = entry->d_name;
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".bank") == 0) {
+      names.push_back(name);
+    }
+  }
+  closedir(handle);
+  std::stable_partition(names.begin(), names.end(), [](const std::string& n) {
+    return n.find(".strings.") != std::string::npos;
+  });
+  for (const std::string& name : names) {
+    FMOD_STUDIO_BANK* bank = nullptr;
+    std::string path = dir + "/" + name;
+    if (!Check(FMOD_Studio_System_LoadBankFile(studio, path.c_str(),
+                                               FMOD_STUDIO_LOAD_BANK_NORMAL,
+                                               &bank),
+               path.c_str())) {
+      return false;
+    }
+  }
+  return !names.empty();
+}
+
+// The value written by write w of tick t: a sweep over the parameter's
+// range, so consecutive writes differ as they would from a gesture.
+float Sweep(int tick, int write, int writes, float minimum, float maximum) {
+  float phase = std::fmod((tick * writes + write) * 0.01f, 1.0f);
+  return minimum + phase * (maximum - minimum);
+}
+
+bool Run(const Options& options, FMOD_STUDIO_SYSTEM* studio,
+         FMOD_STUDIO_EVENTDESCRIPTION* description,
+         const FMOD_STUDIO_PARAMETER_DESCRIPTION& parameter, bool deferred,
+         RunStats* stats) {
+  std::vector<FMOD_STUDIO_EVENTINSTANCE*> instances(options.instances);
+  for (FMOD_STUDIO_EVENTINSTANCE*& instance : instances) {
+    if (!Check(FMOD_Studio_EventDescription_CreateInstance(description,
+                                                           &instance),
+               "CreateInstance") ||
+        !Check(FMOD_Studio_EventInstance_Start(instance), "Start")) {
+      return false;
+    }
+  }
+  FMOD_Studio_System_Update(studio);
+
+  fmod_flutter::DeferredWrites writes;
+  const char* name = options.parameter.c_str();
+  int64_t direct_calls = 0;
+  bool ok = true;
+  for (int tick = 0; ok && tick < options.ticks; tick++) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; ok && i < instances.size(); i++) {
+      for (int w = 0; ok && w < options.writes; w++) {
+        float value = Sweep(tick, w, options.writes, parameter.minimum,
+                            parameter.maximum);
+        float volume = Sweep(tick, w, options.writes, 0.25f, 1.0f);
+        float pitch = Sweep(tick, w, options.writes, 0.5f, 2.0f);
+        FMOD_RESULT result = FMOD_OK;
+        if (deferred) {
+          if (!writes.SetParameter(instances[i], name, value) ||
+              !writes.SetVolume(instances[i], volume) ||
+              !writes.SetPitch(instances[i], pitch)) {
+            result = writes.last_result();
+          }
+        } else {
+          result = FMOD_Studio_EventInstance_SetParameterByName(
+              instances[i], name, value, 0);
+          if (result == FMOD_OK) {
+            result = FMOD_Studio_EventInstance_SetVolume(instances[i], volume);
+          }
+          if (result == FMOD_OK) {
+            result = FMOD_Studio_EventInstance_SetPitch(instances[i], pitch);
+          }
+          direct_calls += 3;
+        }
+        ok = Check(result, "write");
+      }
+    }
+    writes.Flush();
+    Clock::time_point written = Clock::now();
+    ok = ok && Check(FMOD_Studio_System_Update(studio), "Update");
+    Clock::time_point updated = Clock::now();
+    stats->write_ms += ElapsedMs(start, written);
+    stats->update_ms += ElapsedMs(written, updated);
+    stats->max_tick_ms =
+        std::max(stats->max_tick_ms, ElapsedMs(start, updated));
+  }
+
+  stats->writes = static_cast<int64_t>(options.instances) * options.writes *
+                  options.ticks * 3;
+  if (deferred) {
+    FmodDeferredWriteStats write_stats;
+    writes.GetStats(&write_stats);
+    stats->fmod_calls = write_stats.fmod_calls;
+  } else {
+    stats->fmod_calls = direct_calls;
+  }
+
+  for (FMOD_STUDIO_EVENTINSTANCE* instance : instances) {
+    float value = 0.0f;
+    float volume = 0.0f;
+    float pitch = 0.0f;
+    FMOD_Studio_EventInstance_GetParameterByName(instance, name, &value,
+                                                 nullptr);
+    FMOD_Studio_EventInstance_GetVolume(instance, &volume, nullptr);
+    FMOD_Studio_EventInstance_GetPitch(instance, &pitch, nullptr);
+    stats->final_values.push_back(value);
+    stats->final_values.push_back(volume);
+    stats->final_values.push_back(pitch);
+    FMOD_Studio_EventInstance_Stop(instance, FMOD_STUDIO_STOP_IMMEDIATE);
+    FMOD_Studio_EventInstance_Release(instance);
+  }
+  FMOD_Studio_System_Update(studio);
+  return ok;
+}
+
+void PrintStats(const char* label, const Options& options,
+                const RunStats& stats) {
+  std::printf("%s:\n", label);
+  std::printf("  writes:      %lld\n", static_cast<long long>(stats.writes));
+  std::printf("  fmod calls:  %lld (%.1f per tick)\n",
+              static_cast<long long>(stats.fmod_calls),
+              static_cast<double>(stats.fmod_calls) / options.ticks);
+  std::printf("  write time:  %.2f ms (%.3f ms per tick)\n", stats.write_ms,
+              stats.write_ms / options.ticks);
+  std::printf("  update time: %.2f ms (%.3f ms per tick)\n", stats.update_ms,
+              stats.update_ms / options.ticks);
+  std::printf("  slowest tick: %.3f ms\n", stats.max_tick_ms);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  FMOD_STUDIO_SYSTEM* studio = nullptr;
+  FMOD_SYSTEM* core = nullptr;
+  if (!Check(FMOD_Studio_System_Create(&studio, FMOD_VERSION),
+             "Studio_System_Create")) {
+    return 1;
+  }
+  fmod_flutter::OfflineOutput output;
+  bool ok = Check(FMOD_Studio_System_GetCoreSystem(studio, &core),
+                  "GetCoreSystem");
+  if (ok && !output.Configure(core, FMOD_FLUTTER_OUTPUT_NOSOUND_NRT, "")) {
+    ok = Check(output.last_result(), "SetOutput");
+  }
+  ok = ok &&
+       Check(FMOD_Studio_System_Initialize(
+                 studio, 1024, output.studio_init_flags(),
+                 output.core_init_flags(), output.extra_driver_data()),
+             "Studio_System_Initialize") &&
+       LoadBanks(studio, options.bank_dir);
+
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  FMOD_STUDIO_PARAMETER_DESCRIPTION parameter;
+  ok = ok &&
+       Check(FMOD_Studio_System_GetEvent(studio, options.event_path.c_str(),
+                                         &description),
+             options.event_path.c_str()) &&
+       Check(FMOD_Studio_EventDescription_GetParameterDescriptionByName(
+                 description, options.parameter.c_str(), &parameter),
+             options.parameter.c_str());
+
+  RunStats direct;
+  RunStats deferred;
+  ok = ok && Run(options, studio, description, parameter, false, &direct) &&
+       Run(options, studio, description, parameter, true, &deferred);
+  FMOD_Studio_System_Release(studio);
+  if (!ok) {
+    return 1;
+  }
+
+  std::printf("%d instances x %d writes of each kind x %d ticks\n",
+              options.instances, options.writes, options.ticks);
+  PrintStats("direct", options, direct);
+  PrintStats("deferred", options, deferred);
+  std::printf("fmod calls: %.1fx fewer, writes plus updates %.1fx faster\n",
+              deferred.fmod_calls > 0
+                  ? static_cast<double>(direct.fmod_calls) /
+                        deferred.fmod_calls
+                  : 0.0,
+              deferred.write_ms + deferred.update_ms > 0.0
+                  ? (direct.write_ms + direct.update_ms) /
+                        (deferred.write_ms + deferred.update_ms)
+                  : 0.0);
+
+  // Coalescing must not change where anything ends up.
+  for (size_t i = 0; i < direct.final_values.size(); i++) {
+    if (std::fabs(direct.final_values[i] - deferred.final_values[i]) >
+        1e-4f) {
+      std::fprintf(stderr,
+                   "deferred_writes_bench: final values differ at %zu: "
+                   "%f direct, %f deferred\n",
+                   i, direct.final_values[i], deferred.final_values[i]);
+      return 1;
+    }
+  }
+  std::printf("final values match\n");
+  return 0;
+}
@@ -0,0 +1,366 @@
+// Checks which setter calls DeferredWrites issues on Linux.
+//
+// The FMOD Studio calls it makes are answered by stand-ins defined below,
+// which keep each fake instance's parameter values, volume and pitch and
+// count the calls made. Each case checks that:
+// - nothing reaches FMOD before a flush, and the last write to a parameter,
+//   the volume or the pitch within a tick is the one applied;
+// - more than 32 parameters are applied in several setParametersByIDs
+//   calls of at most 32 each, none lost or repeated;
+// - unknown parameters and released instances fail at the call site, and
+//   calls failing at flush time are counted;
+// - Forget() and FlushInstance() only touch the given instance, and names
+//   are looked up once per event description.
+//
+// Usage: deferred_writes_test
+
+#include <fmod_studio.h>
+
+#include "deferred_writes.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using fmod_flutter::DeferredWrites;
+
+// setParametersByIDs takes at most this many parameters per call.
+const int kMaxParametersPerCall = 32;
+// Every stand-in event has parameters named "p0" to "p<kParameterCount-1>".
+const int kParameterCount = 80;
+
+// A stand-in event instance.
+struct Instance {
+  int event;
+  bool released;
+  std::map<unsigned int, float> parameters;
+  float volume;
+  float pitch;
+};
+
+// Calls made to the stand-ins.
+struct Calls {
+  int parameter_lookups;
+  std::vector<int> parameter_batches;  // count passed to each call
+  int volume;
+  int pitch;
+};
+
+Calls calls;
+int failures = 0;
+
+void Reset() {
+  calls.parameter_lookups = 0;
+  calls.parameter_batches.clear();
+  calls.volume = 0;
+  calls.pitch = 0;
+}
+
+Instance MakeInstance(int event) {
+  Instance instance;
+  instance.event = event;
+  instance.released = false;
+  instance.volume = 1.0f;
+  instance.pitch = 1.0f;
+  return instance;
+}
+
+FMOD_STUDIO_EVENTINSTANCE* Handle(Instance* instance) {
+  return reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(instance);
+}
+
+Instance* Get(FMOD_STUDIO_EVENTINSTANCE* instance) {
+  return reinterpret_cast<Instance*>(instance);
+}
+
+std::string Name(int parameter) {
+  return "p" + std::to_string(parameter);
+}
+
+float Value(const Instance& instance, int parameter) {
+  auto it = instance.parameters.find(static_cast<unsigned int>(parameter));
+  return it != instance.parameters.end() ? it->second : -1.0f;
+}
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void ExpectStats(const DeferredWrites& writes, int total, int coalesced,
+                 int fmod_calls, int failed_calls, int flushes,
+                 const char* test) {
+  FmodDeferredWriteStats stats;
+  writes.GetStats(&stats);
+  if (stats.writes != total || stats.coalesced != coalesced ||
+      stats.fmod_calls != fmod_calls || stats.failed_calls != failed_calls ||
+      stats.flushes != flushes) {
+    std::fprintf(stderr,
+                 "FAIL %s: writes %lld, coalesced %lld, calls %lld, failed "
+                 "%lld, flushes %lld; expected %d, %d, %d, %d, %d\n",
+                 test, static_cast<long long>(stats.writes),
+                 static_cast<long long>(stats.coalesced),
+                 static_cast<long long>(stats.fmod_calls),
+                 static_cast<long long>(stats.failed_calls),
+                 static_cast<long long>(stats.flushes), total, coalesced,
+                 fmod_calls, failed_calls, flushes);
+    failures++;
+  }
+}
+
+void Report(const char* test, int failures_before) {
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+void CheckLastWriteWins() {
+  const char* test = "last write wins";
+  int before = failures;
+  Reset();
+  DeferredWrites writes;
+  Instance instance = MakeInstance(0);
+  FMOD_STUDIO_EVENTINSTANCE* handle = Handle(&instance);
+  for (int i = 1; i <= 5; i++) {
+    writes.SetParameter(handle, "p0", static_cast<float>(i));
+  }
+  writes.SetParameter(handle, "p1", 10.0f);
+  writes.SetVolume(handle, 0.5f);
+  writes.SetVolume(handle, 0.7f);
+  writes.SetPitch(handle, 2.0f);
+  Expect(writes.pending_count() == 1, test, "pending count");
+  Expect(calls.parameter_batches.empty() && calls.volume == 0 &&
+             instance.parameters.empty() && instance.volume == 1.0f,
+         test, "applied before the flush");
+
+  writes.Flush();
+  Expect(calls.parameter_batches.size() == 1 &&
+             calls.parameter_batches[0] == 2,
+         test, "parameters not applied in one call");
+  Expect(Value(instance, 0) == 5.0f && Value(instance, 1) == 10.0f, test,
+         "wrong parameter values");
+  Expect(calls.volume == 1 && instance.volume == 0.7f, test, "wrong volume");
+  Expect(calls.pitch == 1 && instance.pitch == 2.0f, test, "wrong pitch");
+  Expect(writes.pending_count() == 0, test, "pending after the flush");
+  ExpectStats(writes, 9, 5, 3, 0, 1, test);
+
+  // The next tick starts empty; a flush with nothing queued is not counted.
+  writes.Flush();
+  writes.SetPitch(handle, 0.5f);
+  writes.Flush();
+  Expect(calls.parameter_batches.size() == 1 && calls.volume == 1 &&
+             calls.pitch == 2 && instance.pitch == 0.5f,
+         test, "second tick reapplied old writes");
+  ExpectStats(writes, 10, 5, 4, 0, 2, test);
+  Report(test, before);
+}
+
+void CheckBatches() {
+  const char* test = "more than 32 parameters are batched";
+  int before = failures;
+  const int kCounts[] = {31, 32, 33, 64, 65, 80};
+  for (int count : kCounts) {
+    Reset();
+    DeferredWrites writes;
+    Instance instance = MakeInstance(1);
+    FMOD_STUDIO_EVENTINSTANCE* handle = Handle(&instance);
+    for (int p = 0; p < count; p++) {
+      writes.SetParameter(handle, Name(p).c_str(), -2.0f);
+    }
+    // Rewrites every other one, so the batches hold the final values.
+    for (int p = 0; p < count; p += 2) {
+      writes.SetParameter(handle, Name(p).c_str(), static_cast<float>(p));
+    }
+    writes.Flush();
+
+    size_t batches = static_cast<size_t>(
+        (count + kMaxParametersPerCall - 1) / kMaxParametersPerCall);
+    bool sizes_ok = calls.parameter_batches.size() == batches;
+    int applied = 0;
+    for (int batch : calls.parameter_batches) {
+      sizes_ok = sizes_ok && batch > 0 && batch <= kMaxParametersPerCall;
+      applied += batch;
+    }
+    bool values_ok = instance.parameters.size() == static_cast<size_t>(count);
+    for (int p = 0; p < count; p++) {
+      float expected = p % 2 == 0 ? static_cast<float>(p) : -2.0f;
+      values_ok = values_ok && Value(instance, p) == expected;
+    }
+    if (!sizes_ok || applied != count || !values_ok) {
+      std::fprintf(stderr,
+                   "FAIL %s: %d parameters: %zu calls applying %d, values "
+                   "%s\n",
+                   test, count, calls.parameter_batches.size(), applied,
+                   values_ok ? "ok" : "wrong");
+      failures++;
+    }
+    ExpectStats(writes, count + (count + 1) / 2, (count + 1) / 2,
+                static_cast<int>(batches), 0, 1, test);
+  }
+  Report(test, before);
+}
+
+void CheckFailures() {
+  const char* test = "failures and lookups";
+  int before = failures;
+  Reset();
+  DeferredWrites writes;
+  Instance first = MakeInstance(0);
+  Instance second = MakeInstance(0);
+  Instance released = MakeInstance(0);
+  released.released = true;
+
+  Expect(!writes.SetParameter(Handle(&first), "missing", 1.0f) &&
+             writes.last_result() == FMOD_ERR_EVENT_NOTFOUND,
+         test, "unknown parameter accepted");
+  Expect(!writes.SetVolume(Handle(&released), 0.5f) &&
+             writes.last_result() == FMOD_ERR_INVALID_HANDLE,
+         test, "released instance accepted");
+
+  // Both instances share an event, so each name is looked up once.
+  int lookups = calls.parameter_lookups;
+  writes.SetParameter(Handle(&first), "p0", 1.0f);
+  writes.SetParameter(Handle(&first), "p0", 2.0f);
+  writes.SetParameter(Handle(&second), "p0", 3.0f);
+  Expect(calls.parameter_lookups == lookups + 1, test,
+         "parameter looked up again");
+
+  // An instance released between the write and the flush fails there.
+  second.released = true;
+  writes.Flush();
+  Expect(Value(first, 0) == 2.0f && second.parameters.empty(), test,
+         "wrong values after a failed call");
+  Expect(writes.last_result() == FMOD_ERR_INVALID_HANDLE, test,
+         "failed call not reported");
+  ExpectStats(writes, 3, 1, 2, 1, 1, test);
+  Report(test, before);
+}
+
+void CheckForgetAndFlushInstance() {
+  const char* test = "forget and flush one instance";
+  int before = failures;
+  Reset();
+  DeferredWrites writes;
+  Instance instances[3] = {MakeInstance(0), MakeInstance(1), MakeInstance(0)};
+  for (int i = 0; i < 3; i++) {
+    writes.SetParameter(Handle(&instances[i]), "p3", static_cast<float>(i));
+    writes.SetVolume(Handle(&instances[i]), 0.1f * static_cast<float>(i));
+  }
+  Expect(writes.pending_count() == 3, test, "pending count");
+
+  writes.Forget(Handle(&instances[0]));
+  writes.FlushInstance(Handle(&instances[2]));
+  Expect(Value(instances[2], 3) == 2.0f && instances[2].volume == 0.2f &&
+             instances[1].parameters.empty() && instances[1].volume == 1.0f,
+         test, "FlushInstance applied the wrong writes");
+  Expect(writes.pending_count() == 1, test, "pending count after flushing");
+
+  writes.Flush();
+  Expect(Value(instances[1], 3) == 1.0f && instances[1].volume == 0.1f,
+         test, "remaining writes not applied");
+  Expect(instances[0].parameters.empty() && instances[0].volume == 1.0f,
+         test, "forgotten writes applied");
+  ExpectStats(writes, 6, 0, 4, 0, 2, test);
+
+  writes.Clear();
+  ExpectStats(writes, 0, 0, 0, 0, 0, test);
+  Report(test, before);
+}
+
+}  // namespace
+
+// Stand-ins for the FMOD Studio calls DeferredWrites makes. Event
+// descriptions are the event number stored in the pointer, and parameter
+// ids carry the parameter number and event.
+extern "C" {
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_GetDescription(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance,
+    FMOD_STUDIO_EVENTDESCRIPTION** description) {
+  Instance* instance = Get(eventinstance);
+  if (instance->released) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  *description = reinterpret_cast<FMOD_STUDIO_EVENTDESCRIPTION*>(
+      static_cast<intptr_t>(0x1000 + instance->event));
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_GetParameterDescriptionByName(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription, const char* name,
+    FMOD_STUDIO_PARAMETER_DESCRIPTION* parameter) {
+  calls.parameter_lookups++;
+  for (int p = 0; p < kParameterCount; p++) {
+    if (Name(p) == name) {
+      std::memset(parameter, 0, sizeof(*parameter));
+      parameter->id.data1 = static_cast<unsigned int>(p);
+      parameter->id.data2 = static_cast<unsigned int>(
+          reinterpret_cast<intptr_t>(eventdescription));
+      return FMOD_OK;
+    }
+  }
+  return FMOD_ERR_EVENT_NOTFOUND;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetParametersByIDs(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance,
+    const FMOD_STUDIO_PARAMETER_ID* ids, float* values, int count,
+    FMOD_BOOL ignoreseekspeed) {
+  (void)ignoreseekspeed;
+  calls.parameter_batches.push_back(count);
+  Instance* instance = Get(eventinstance);
+  if (instance->released) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  if (count < 1 || count > kMaxParametersPerCall) {
+    return FMOD_ERR_INVALID_PARAM;
+  }
+  for (int i = 0; i < count; i++) {
+    instance->parameters[ids[i].data1] = values[i];
+  }
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetVolume(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, float volume) {
+  calls.volume++;
+  Instance* instance = Get(eventinstance);
+  if (instance->released) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  instance->volume = volume;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetPitch(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, float pitch) {
+  calls.pitch++;
+  Instance* instance = Get(eventinstance);
+  if (instance->released) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  instance->pitch = pitch;
+  return FMOD_OK;
+}
+
+}  // extern "C"
+
+int main() {
+  CheckLastWriteWins();
+  CheckBatches();
+  CheckFailures();
+  CheckForgetAndFlushInstance();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
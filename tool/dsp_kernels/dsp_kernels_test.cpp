@@ -0,0 +1,300 @@
+// Checks that the DSP kernels picked for this CPU match the scalar
+// reference bit for bit, and times both.
+//
+// Every kernel runs on the same pseudo-random input through
+// GetScalarDspKernels() and GetDspKernels() for 1 to 12 interleaved
+// channels and odd frame counts, so the SIMD loops always leave a tail for
+// their scalar remainder, and the outputs and carried state are compared
+// bit for bit. soft_clip and biquad are also run in place. Timings are
+// printed per kernel for the common channel layouts.
+//
+// The kernels need no FMOD libraries, so the test runs without the SDK.
+//
+// Usage: dsp_kernels_test [--iterations N]
+
+#include "dsp_kernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using fmod_flutter::BiquadCoefficients;
+using fmod_flutter::DspKernels;
+using fmod_flutter::kTruePeakPhases;
+
+typedef std::chrono::steady_clock Clock;
+
+const int kMaxChannels = 12;
+const int kFrameCounts[] = {1, 3, 5, 7, 9, 15, 17, 31, 33, 63, 255, 1023};
+// As used by the loudness meter.
+const int kTapCount = 12;
+// Frames per timed call, one FMOD DSP block.
+const int kBenchFrames = 1024;
+const int kBenchChannels[] = {1, 2, 6, 8, 12};
+
+// A second-order low-pass at 1 kHz for 48 kHz, Q 0.707.
+const BiquadCoefficients kLowPass = {0.003916f, 0.007832f, 0.003916f,
+                                     -1.815341f, 0.831006f};
+
+int failures = 0;
+
+// Deterministic so failures reproduce.
+class Random {
+ public:
+  explicit Random(unsigned int seed) : state_(seed) {}
+
+  // Uniform in [-range, range).
+  float Next(float range) {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return (static_cast<float>(state_ % 65536) / 32768.0f - 1.0f) * range;
+  }
+
+  void Fill(std::vector<float>* values, float range) {
+    for (float& value : *values) {
+      value = Next(range);
+    }
+  }
+
+ private:
+  unsigned int state_;
+};
+
+// Reports the first element that differs in its bits.
+bool Compare(const char* kernel, const char* what, int channels, int frames,
+             const std::vector<float>& expected,
+             const std::vector<float>& actual) {
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (std::memcmp(&expected[i], &actual[i], sizeof(float)) != 0) {
+      std::fprintf(stderr,
+                   "FAIL %s %s: %d channels, %d frames, element %zu: "
+                   "%.9g (scalar) != %.9g\n",
+                   kernel, what, channels, frames, i, expected[i], actual[i]);
+      failures++;
+      return false;
+    }
+  }
+  return true;
+}
+
+void CheckSoftClip(const DspKernels& scalar, const DspKernels& fast,
+                   int channels, int frames, Random* random) {
+  // Reaches past the clip limit of +/-3 after the gain.
+  std::vector<float> in(frames * channels);
+  random->Fill(&in, 4.0f);
+  std::vector<float> expected(in.size());
+  std::vector<float> actual(in.size());
+  scalar.soft_clip(in.data(), expected.data(), static_cast<int>(in.size()),
+                   1.7f, 0.9f);
+  fast.soft_clip(in.data(), actual.data(), static_cast<int>(in.size()), 1.7f,
+                 0.9f);
+  Compare("soft_clip", "out", channels, frames, expected, actual);
+
+  actual = in;
+  fast.soft_clip(actual.data(), actual.data(), static_cast<int>(in.size()),
+                 1.7f, 0.9f);
+  Compare("soft_clip", "in place", channels, frames, expected, actual);
+}
+
+void CheckBiquad(const DspKernels& scalar, const DspKernels& fast,
+                 int channels, int frames, Random* random) {
+  std::vector<float> in(frames * channels);
+  random->Fill(&in, 1.0f);
+  std::vector<float> state(2 * channels);
+  random->Fill(&state, 0.1f);
+
+  std::vector<float> expected(in.size());
+  std::vector<float> expected_z1(state.begin(), state.begin() + channels);
+  std::vector<float> expected_z2(state.begin() + channels, state.end());
+  scalar.biquad(in.data(), expected.data(), frames, channels, kLowPass,
+                expected_z1.data(), expected_z2.data());
+
+  std::vector<float> actual(in.size());
+  std::vector<float> z1(state.begin(), state.begin() + channels);
+  std::vector<float> z2(state.begin() + channels, state.end());
+  fast.biquad(in.data(), actual.data(), frames, channels, kLowPass,
+              z1.data(), z2.data());
+  Compare("biquad", "out", channels, frames, expected, actual);
+  Compare("biquad", "z1", channels, frames, expected_z1, z1);
+  Compare("biquad", "z2", channels, frames, expected_z2, z2);
+
+  actual = in;
+  z1.assign(state.begin(), state.begin() + channels);
+  z2.assign(state.begin() + channels, state.end());
+  fast.biquad(actual.data(), actual.data(), frames, channels, kLowPass,
+              z1.data(), z2.data());
+  Compare("biquad", "in place", channels, frames, expected, actual);
+}
+
+void CheckChannelPower(const DspKernels& scalar, const DspKernels& fast,
+                       int channels, int frames, Random* random) {
+  std::vector<float> in(frames * channels);
+  random->Fill(&in, 1.0f);
+  // Carried over from an earlier block.
+  std::vector<float> sums(channels);
+  random->Fill(&sums, 4.0f);
+  for (float& sum : sums) {
+    sum = std::fabs(sum);
+  }
+  std::vector<float> peaks(channels, 0.25f);
+
+  std::vector<float> expected_sums = sums;
+  std::vector<float> expected_peaks = peaks;
+  scalar.channel_power(in.data(), frames, channels, expected_sums.data(),
+                       expected_peaks.data());
+  fast.channel_power(in.data(), frames, channels, sums.data(), peaks.data());
+  Compare("channel_power", "sum_squares", channels, frames, expected_sums,
+          sums);
+  Compare("channel_power", "peaks", channels, frames, expected_peaks, peaks);
+}
+
+void CheckTruePeak(const DspKernels& scalar, const DspKernels& fast,
+                   const std::vector<float>& taps, int channels, int frames,
+                   Random* random) {
+  // kTapCount - 1 frames of history ahead of the block.
+  std::vector<float> buffer((frames + kTapCount - 1) * channels);
+  random->Fill(&buffer, 1.0f);
+  const float* in = buffer.data() + (kTapCount - 1) * channels;
+  std::vector<float> expected(channels, 0.5f);
+  std::vector<float> actual(channels, 0.5f);
+  scalar.true_peak(in, frames, channels, taps.data(), kTapCount,
+                   expected.data());
+  fast.true_peak(in, frames, channels, taps.data(), kTapCount, actual.data());
+  Compare("true_peak", "peaks", channels, frames, expected, actual);
+}
+
+struct BenchBuffers {
+  std::vector<float> in;
+  std::vector<float> history;  // kTapCount - 1 frames, then in
+  std::vector<float> out;
+  std::vector<float> z1;
+  std::vector<float> z2;
+  std::vector<float> sums;
+  std::vector<float> peaks;
+};
+
+// Nanoseconds per frame of each kernel, over iterations calls.
+void Time(const DspKernels& kernels, const std::vector<float>& taps,
+          int channels, int iterations, BenchBuffers* b, double* ns) {
+  const int frames = kBenchFrames;
+  const float* history = b->history.data() + (kTapCount - 1) * channels;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    kernels.soft_clip(b->in.data(), b->out.data(), frames * channels, 1.7f,
+                      0.9f);
+  }
+  Clock::time_point soft_clip_end = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    kernels.biquad(b->in.data(), b->out.data(), frames, channels, kLowPass,
+                   b->z1.data(), b->z2.data());
+  }
+  Clock::time_point biquad_end = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    kernels.channel_power(b->in.data(), frames, channels, b->sums.data(),
+                          b->peaks.data());
+  }
+  Clock::time_point power_end = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    kernels.true_peak(history, frames, channels, taps.data(), kTapCount,
+                      b->peaks.data());
+  }
+  Clock::time_point true_peak_end = Clock::now();
+
+  double calls = static_cast<double>(iterations) * frames;
+  ns[0] = std::chrono::duration<double, std::nano>(soft_clip_end - start)
+              .count() / calls;
+  ns[1] = std::chrono::duration<double, std::nano>(biquad_end -
+                                                   soft_clip_end)
+              .count() / calls;
+  ns[2] = std::chrono::duration<double, std::nano>(power_end - biquad_end)
+              .count() / calls;
+  ns[3] = std::chrono::duration<double, std::nano>(true_peak_end -
+                                                   power_end)
+              .count() / calls;
+}
+
+void PrintTimings(const DspKernels& scalar, const DspKernels& fast,
+                  const std::vector<float>& taps, int iterations,
+                  Random* random) {
+  static const char* const kKernels[] = {"soft_clip", "biquad",
+                                         "channel_power", "true_peak"};
+  std::printf("\n%d-frame blocks, %d calls each, ns per frame:\n",
+              kBenchFrames, iterations);
+  std::printf("%-14s %8s %10s %10s %8s\n", "kernel", "channels", "scalar",
+              fast.name, "speedup");
+  for (int channels : kBenchChannels) {
+    BenchBuffers b;
+    b.in.resize(kBenchFrames * channels);
+    random->Fill(&b.in, 1.0f);
+    b.history.resize((kBenchFrames + kTapCount - 1) * channels);
+    random->Fill(&b.history, 1.0f);
+    b.out.resize(b.in.size());
+    b.z1.assign(channels, 0.0f);
+    b.z2.assign(channels, 0.0f);
+    b.sums.assign(channels, 0.0f);
+    b.peaks.assign(channels, 0.0f);
+
+    double scalar_ns[4];
+    double fast_ns[4];
+    Time(scalar, taps, channels, iterations, &b, scalar_ns);
+    Time(fast, taps, channels, iterations, &b, fast_ns);
+    for (int k = 0; k < 4; k++) {
+      std::printf("%-14s %8d %10.2f %10.2f %7.1fx\n", kKernels[k], channels,
+                  scalar_ns[k], fast_ns[k],
+                  fast_ns[k] > 0.0 ? scalar_ns[k] / fast_ns[k] : 0.0);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = 200;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::atoi(argv[++i]);
+    } else {
+      std::fprintf(stderr, "Usage: dsp_kernels_test [--iterations N]\n");
+      return 2;
+    }
+  }
+  if (iterations < 1) {
+    std::fprintf(stderr, "dsp_kernels_test: --iterations must be positive\n");
+    return 2;
+  }
+
+  const DspKernels& scalar = fmod_flutter::GetScalarDspKernels();
+  const DspKernels& fast = fmod_flutter::GetDspKernels();
+  std::printf("kernels: %s\n", fast.name);
+
+  Random random(12345);
+  std::vector<float> taps(kTapCount * kTruePeakPhases);
+  random.Fill(&taps, 0.5f);
+
+  int cases = 0;
+  for (int channels = 1; channels <= kMaxChannels; channels++) {
+    for (int frames : kFrameCounts) {
+      CheckSoftClip(scalar, fast, channels, frames, &random);
+      CheckBiquad(scalar, fast, channels, frames, &random);
+      CheckChannelPower(scalar, fast, channels, frames, &random);
+      CheckTruePeak(scalar, fast, taps, channels, frames, &random);
+      cases++;
+    }
+  }
+  std::printf("%d layouts x 4 kernels compared against scalar: %s\n", cases,
+              failures == 0 ? "bit-identical" : "MISMATCH");
+
+  PrintTimings(scalar, fast, taps, iterations, &random);
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d comparisons failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
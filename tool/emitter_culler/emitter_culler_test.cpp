@@ -0,0 +1,318 @@
+// Checks which emitters EmitterCuller starts and stops as emitters and
+// listeners move.
+//
+// Besides hand-placed cases for hysteresis, several listeners, unbounded
+// emitters and radii past the largest grid cell, a randomized run moves
+// emitters between positions snapped to cell boundaries and compares every
+// tick against a brute-force model of the same rules:
+// - an inactive emitter starts once a listener is within its max distance;
+// - an active one stops once every listener is farther than its max
+//   distance plus the hysteresis margin;
+// - an emitter with max distance <= 0 starts and is never stopped.
+//
+// Calls no FMOD function, so it runs without the SDK.
+//
+// Usage: emitter_culler_test
+
+#include "emitter_culler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using fmod_flutter::EmitterCuller;
+
+int failures = 0;
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void Report(const char* test, int failures_before) {
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+bool Contains(const std::vector<int>& ids, int id) {
+  return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// Evaluates with one listener at (x, 0, 0).
+void EvaluateAt(EmitterCuller* culler, float x) {
+  const float listener[] = {x, 0.0f, 0.0f};
+  culler->Evaluate(listener, 1);
+}
+
+void CheckHysteresis() {
+  const char* test = "enter and leave with hysteresis";
+  int before = failures;
+  EmitterCuller culler;
+  culler.SetHysteresis(0.1f);
+  culler.Add(1, 10.0f, false);
+
+  culler.Move(1, 20.0f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(culler.activated().empty(), test, "started out of range");
+
+  culler.Move(1, 10.0f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(Contains(culler.activated(), 1), test,
+         "not started at its max distance");
+
+  culler.Move(1, 10.9f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(culler.deactivated().empty(), test, "stopped inside the margin");
+
+  culler.Move(1, 11.5f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(Contains(culler.deactivated(), 1), test,
+         "not stopped past the margin");
+
+  culler.Move(1, 10.5f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(culler.activated().empty(), test, "restarted inside the margin");
+
+  culler.Move(1, 9.0f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(Contains(culler.activated(), 1), test, "not restarted in range");
+  Expect(culler.active_count() == 1, test, "active count");
+
+  // Emitters added as playing are stopped once out of range.
+  culler.Add(2, 10.0f, true);
+  culler.Move(2, 50.0f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(Contains(culler.deactivated(), 2), test,
+         "playing emitter out of range not stopped");
+
+  // Removing an active emitter reports nothing.
+  culler.Remove(1);
+  EvaluateAt(&culler, 0.0f);
+  Expect(culler.deactivated().empty() && culler.active_count() == 0, test,
+         "removed emitter still tracked");
+  Report(test, before);
+}
+
+void CheckListeners() {
+  const char* test = "multiple listeners";
+  int before = failures;
+  EmitterCuller culler;
+  culler.SetHysteresis(0.0f);
+  culler.Add(1, 10.0f, false);
+  culler.Move(1, 1005.0f, 0.0f, 0.0f);
+
+  const float near_second[] = {0.0f, 0.0f, 0.0f, 1000.0f, 0.0f, 0.0f};
+  culler.Evaluate(near_second, 2);
+  Expect(Contains(culler.activated(), 1), test,
+         "not started near the second listener");
+
+  // Still near one of them: keeps playing.
+  const float swapped[] = {1000.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  culler.Evaluate(swapped, 2);
+  Expect(culler.deactivated().empty(), test, "stopped near a listener");
+
+  const float far[] = {0.0f, 0.0f, 0.0f, 2000.0f, 0.0f, 0.0f};
+  culler.Evaluate(far, 2);
+  Expect(Contains(culler.deactivated(), 1), test,
+         "not stopped away from both listeners");
+
+  // No listeners: every bounded emitter is out of range.
+  culler.Move(1, 0.0f, 0.0f, 0.0f);
+  culler.Evaluate(near_second, 2);
+  Expect(Contains(culler.activated(), 1), test, "not started at listener");
+  culler.Evaluate(near_second, 0);
+  Expect(Contains(culler.deactivated(), 1), test,
+         "not stopped without listeners");
+  Report(test, before);
+}
+
+void CheckUnbounded() {
+  const char* test = "max distance 0 is never culled";
+  int before = failures;
+  EmitterCuller culler;
+  culler.Add(1, 0.0f, false);
+  culler.Add(2, -1.0f, false);
+  culler.Move(1, 1e6f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  Expect(Contains(culler.activated(), 1) && Contains(culler.activated(), 2),
+         test, "not started");
+  culler.Move(1, -1e6f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 0.0f);
+  culler.Evaluate(nullptr, 0);
+  Expect(culler.deactivated().empty() && culler.activated().empty(), test,
+         "stopped or restarted");
+  Expect(culler.active_count() == 2, test, "active count");
+  Report(test, before);
+}
+
+void CheckWideRadius() {
+  const char* test = "large radii stay out of the grid";
+  int before = failures;
+  EmitterCuller culler;
+  culler.SetHysteresis(0.1f);
+  culler.Add(1, 10.0f, false);
+  culler.Add(2, 5000.0f, false);
+  Expect(culler.cell_size() == 10.0f, test,
+         "cell size grew to the large radius");
+
+  EvaluateAt(&culler, 4000.0f);
+  Expect(Contains(culler.activated(), 2) && culler.activated().size() == 1,
+         test, "wrong emitters started 4 km away");
+  EvaluateAt(&culler, 5400.0f);
+  Expect(culler.deactivated().empty(), test, "stopped inside the margin");
+  EvaluateAt(&culler, 5600.0f);
+  Expect(Contains(culler.deactivated(), 2), test,
+         "not stopped past the margin");
+
+  culler.Move(2, 100000.0f, 0.0f, 0.0f);
+  EvaluateAt(&culler, 96000.0f);
+  Expect(Contains(culler.activated(), 2), test, "not started after a move");
+  culler.Remove(2);
+  Expect(culler.emitter_count() == 1 && culler.active_count() == 0, test,
+         "not removed");
+  EvaluateAt(&culler, 0.0f);
+  Expect(Contains(culler.activated(), 1), test, "grid emitter not started");
+  Report(test, before);
+}
+
+// Deterministic so failures reproduce.
+class Random {
+ public:
+  explicit Random(unsigned int seed) : state_(seed) {}
+
+  unsigned int Next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  // A multiple of step in [-range, range], so many positions fall exactly
+  // on cell boundaries.
+  float Snapped(int range, float step) {
+    int steps = static_cast<int>(range / step);
+    return static_cast<float>(static_cast<int>(Next() % (2 * steps + 1)) -
+                              steps) *
+           step;
+  }
+
+ private:
+  unsigned int state_;
+};
+
+struct ModelEmitter {
+  float position[3];
+  float max_distance;
+  bool active;
+};
+
+float NearestDistance(const float* position, const std::vector<float>& listeners) {
+  float nearest = -1.0f;
+  for (size_t l = 0; l + 2 < listeners.size(); l += 3) {
+    float dx = position[0] - listeners[l];
+    float dy = position[1] - listeners[l + 1];
+    float dz = position[2] - listeners[l + 2];
+    float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (nearest < 0.0f || distance < nearest) {
+      nearest = distance;
+    }
+  }
+  return nearest;
+}
+
+void CheckAgainstModel() {
+  const char* test = "random moves match a brute-force model";
+  int before = failures;
+  const float kHysteresis = 0.1f;
+  const float kRadii[] = {2.5f, 5.0f, 10.0f, 0.0f, 400.0f};
+  EmitterCuller culler;
+  culler.SetHysteresis(kHysteresis);
+  Random random(2024);
+  std::vector<ModelEmitter> model(300);
+  for (size_t id = 0; id < model.size(); id++) {
+    ModelEmitter& emitter = model[id];
+    emitter.max_distance = kRadii[id % 5];
+    emitter.active = false;
+    culler.Add(static_cast<int>(id), emitter.max_distance, false);
+    for (float& coord : emitter.position) {
+      coord = random.Snapped(40, 2.5f);
+    }
+    culler.Move(static_cast<int>(id), emitter.position[0],
+                emitter.position[1], emitter.position[2]);
+  }
+
+  for (int tick = 0; tick < 500 && failures == before; tick++) {
+    // Moves a tenth of the emitters and one to three listeners.
+    for (int i = 0; i < 30; i++) {
+      int id = static_cast<int>(random.Next() % model.size());
+      for (float& coord : model[id].position) {
+        coord = random.Snapped(40, 2.5f);
+      }
+      culler.Move(id, model[id].position[0], model[id].position[1],
+                  model[id].position[2]);
+    }
+    std::vector<float> listeners(3 * (1 + random.Next() % 3));
+    for (float& coord : listeners) {
+      coord = random.Snapped(40, 5.0f);
+    }
+    culler.Evaluate(listeners.data(),
+                    static_cast<int>(listeners.size() / 3));
+
+    for (size_t id = 0; id < model.size(); id++) {
+      ModelEmitter& emitter = model[id];
+      float distance = NearestDistance(emitter.position, listeners);
+      bool start = false;
+      bool stop = false;
+      if (emitter.max_distance <= 0.0f) {
+        start = !emitter.active;
+      } else if (emitter.active) {
+        stop = distance > emitter.max_distance * (1.0f + kHysteresis);
+      } else {
+        start = distance <= emitter.max_distance;
+      }
+      emitter.active = (emitter.active && !stop) || start;
+      bool started = Contains(culler.activated(), static_cast<int>(id));
+      bool stopped = Contains(culler.deactivated(), static_cast<int>(id));
+      if (started != start || stopped != stop) {
+        std::fprintf(stderr,
+                     "FAIL %s: tick %d, emitter %zu at (%g, %g, %g), max "
+                     "distance %g, nearest listener %g: %s\n",
+                     test, tick, id, emitter.position[0], emitter.position[1],
+                     emitter.position[2], emitter.max_distance, distance,
+                     start ? "not started"
+                     : stop ? "not stopped"
+                            : "started or stopped wrongly");
+        failures++;
+        break;
+      }
+    }
+  }
+  int active = 0;
+  for (const ModelEmitter& emitter : model) {
+    active += emitter.active ? 1 : 0;
+  }
+  Expect(culler.active_count() == active, test, "active count");
+  Report(test, before);
+}
+
+}  // namespace
+
+int main() {
+  CheckHysteresis();
+  CheckListeners();
+  CheckUnbounded();
+  CheckWideRadius();
+  CheckAgainstModel();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,318 @@
+// Compares looking events up by path with looking them up by ID on Linux.
+//
+// Loads every bank in a directory except the strings banks, checks that
+// each event resolves by ID without them, then loads the strings banks and
+// reports the memory they cost. It then times four lookups of every event:
+//
+//   path       Studio::System::getEvent with the event path
+//   id string  Studio::System::getEvent with the braced ID string
+//   id key     fmod_flutter::GetEvent with the ID key, as the bridges do for
+//              events Dart names by ID
+//   id         Studio::System::getEventByID
+//
+// Usage: event_lookup_bench <banks dir> [--rounds N]
+
+#include <dirent.h>
+#include <fmod.h>
+#include <fmod_errors.h>
+#include <fmod_studio.h>
+
+#include "event_lookup.h"
+#include "offline_output.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+static const int kMaxPathLength = 512;
+
+struct Options {
+  std::string bank_dir;
+  int rounds = 200;
+};
+
+struct Event {
+  std::string path;
+  std::string key;
+  FMOD_GUID id;
+};
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: event_lookup_bench <banks dir> [options]\n"
+               "  --rounds N  times every event is looked up each way\n"
+               "              (default 200)\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--rounds") == 0 && has_value) {
+      options->rounds = std::atoi(argv[++i]);
+    } else if (arg[0] != '-') {
+      positional.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  if (positional.size() != 1 || options->rounds < 1) {
+    return false;
+  }
+  options->bank_dir = positional[0];
+  return true;
+}
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "event_lookup_bench: %s failed: %d - %s\n", what,
+                 result, FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+bool IsStringsBank(const std::string& name) {
+  return name.find(".strings.") != std::string::npos;
+}
+
+// The .bank files in dir, sorted.
+bool ListBanks(const std::string& dir, std::vector<std::string>* names) {
+  DIR* handle = opendir(dir.c_str());
+  if (handle == nullptr) {
+    std::fprintf(stderr, "event_lookup_bench: cannot open %s\n",
+                 dir.c_str());
+    return false;
+  }
+  while (dirent* entry = readdir(handle)) {
+    std::string name = entry->d_name;
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".bank") == 0) {
+      names->push_back(name);
+    }
+  }
+  closedir(handle);
+  std::sort(names->begin(), names->end());
+  return true;
+}
+
+// Loads the banks in names that are (or are not) strings banks.
+bool LoadBanks(FMOD_STUDIO_SYSTEM* studio, const std::string& dir,
+               const std::vector<std::string>& names, bool strings,
+               std::vector<FMOD_STUDIO_BANK*>* banks) {
+  for (const std::string& name : names) {
+    if (IsStringsBank(name) != strings) {
+      continue;
+    }
+    FMOD_STUDIO_BANK* bank = nullptr;
+    std::string path = dir + "/" + name;
+    if (!Check(FMOD_Studio_System_LoadBankFile(studio, path.c_str(),
+                                               FMOD_STUDIO_LOAD_BANK_NORMAL,
+                                               &bank),
+               path.c_str())) {
+      return false;
+    }
+    banks->push_back(bank);
+  }
+  return true;
+}
+
+int CurrentMemory() {
+  int current = 0;
+  int peak = 0;
+  FMOD_Memory_GetStats(&current, &peak, 1);
+  return current;
+}
+
+// Every event in banks, with its ID; paths are filled in later.
+void CollectEvents(const std::vector<FMOD_STUDIO_BANK*>& banks,
+                   std::vector<Event>* events) {
+  std::vector<FMOD_STUDIO_EVENTDESCRIPTION*> descriptions;
+  for (FMOD_STUDIO_BANK* bank : banks) {
+    int count = 0;
+    if (FMOD_Studio_Bank_GetEventCount(bank, &count) != FMOD_OK ||
+        count <= 0) {
+      continue;
+    }
+    descriptions.resize(count);
+    if (FMOD_Studio_Bank_GetEventList(bank, descriptions.data(), count,
+                                      &count) != FMOD_OK) {
+      continue;
+    }
+    for (int i = 0; i < count; i++) {
+      Event event;
+      if (FMOD_Studio_EventDescription_GetID(descriptions[i], &event.id) ==
+          FMOD_OK) {
+        event.key = fmod_flutter::EventIdKey(event.id);
+        events->push_back(event);
+      }
+    }
+  }
+}
+
+enum Lookup { kPath, kIdString, kIdKey, kId, kLookupCount };
+
+const char* const kLookupNames[kLookupCount] = {"path", "id string",
+                                                "id key", "id"};
+
+FMOD_RESULT Find(FMOD_STUDIO_SYSTEM* studio, const Event& event,
+                 Lookup lookup) {
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  switch (lookup) {
+    case kPath:
+      return FMOD_Studio_System_GetEvent(studio, event.path.c_str(),
+                                         &description);
+    case kIdString:
+      return FMOD_Studio_System_GetEvent(studio, event.key.c_str(),
+                                         &description);
+    case kIdKey:
+      return fmod_flutter::GetEvent(studio, event.key.c_str(), &description);
+    default:
+      return FMOD_Studio_System_GetEventByID(studio, &event.id,
+                                             &description);
+  }
+}
+
+// Looks every event up rounds times; returns the mean and best round in
+// nanoseconds per lookup.
+bool Time(FMOD_STUDIO_SYSTEM* studio, const std::vector<Event>& events,
+          Lookup lookup, int rounds, double* mean_ns, double* best_ns) {
+  double total = 0.0;
+  *best_ns = 0.0;
+  for (int round = 0; round < rounds; round++) {
+    Clock::time_point start = Clock::now();
+    for (const Event& event : events) {
+      FMOD_RESULT result = Find(studio, event, lookup);
+      if (result != FMOD_OK) {
+        std::string what = std::string(kLookupNames[lookup]) + " lookup of " +
+                           event.path;
+        return Check(result, what.c_str());
+      }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() -
+                                                         start)
+                    .count() /
+                events.size();
+    total += ns;
+    if (round == 0 || ns < *best_ns) {
+      *best_ns = ns;
+    }
+  }
+  *mean_ns = total / rounds;
+  return true;
+}
+
+bool Run(const Options& options, FMOD_STUDIO_SYSTEM* studio) {
+  std::vector<std::string> names;
+  if (!ListBanks(options.bank_dir, &names)) {
+    return false;
+  }
+  std::vector<FMOD_STUDIO_BANK*> banks;
+  std::vector<FMOD_STUDIO_BANK*> strings_banks;
+  int before = CurrentMemory();
+  if (!LoadBanks(studio, options.bank_dir, names, false, &banks)) {
+    return false;
+  }
+  int without_strings = CurrentMemory();
+
+  std::vector<Event> events;
+  CollectEvents(banks, &events);
+  if (events.empty()) {
+    std::fprintf(stderr, "event_lookup_bench: no events in %s\n",
+                 options.bank_dir.c_str());
+    return false;
+  }
+  size_t found = 0;
+  for (const Event& event : events) {
+    if (Find(studio, event, kIdKey) == FMOD_OK) {
+      found++;
+    }
+  }
+  std::printf("without strings banks: %zu of %zu events found by id\n",
+              found, events.size());
+
+  if (!LoadBanks(studio, options.bank_dir, names, true, &strings_banks)) {
+    return false;
+  }
+  if (strings_banks.empty()) {
+    std::fprintf(stderr,
+                 "event_lookup_bench: no strings bank; paths are unknown\n");
+    return false;
+  }
+  int with_strings = CurrentMemory();
+  std::printf("FMOD memory: %d KiB for the other banks, %d KiB more for "
+              "the strings banks\n",
+              (without_strings - before) / 1024,
+              (with_strings - without_strings) / 1024);
+
+  for (Event& event : events) {
+    FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+    char path[kMaxPathLength];
+    if (!Check(FMOD_Studio_System_GetEventByID(studio, &event.id,
+                                               &description),
+               event.key.c_str()) ||
+        !Check(FMOD_Studio_EventDescription_GetPath(description, path,
+                                                    kMaxPathLength, nullptr),
+               event.key.c_str())) {
+      return false;
+    }
+    event.path = path;
+  }
+
+  std::printf("%zu events x %d rounds\n", events.size(), options.rounds);
+  std::printf("  %-10s %12s %12s\n", "lookup", "mean ns", "best ns");
+  double means[kLookupCount];
+  for (int lookup = 0; lookup < kLookupCount; lookup++) {
+    double best = 0.0;
+    if (!Time(studio, events, static_cast<Lookup>(lookup), options.rounds,
+              &means[lookup], &best)) {
+      return false;
+    }
+    std::printf("  %-10s %12.1f %12.1f\n", kLookupNames[lookup],
+                means[lookup], best);
+  }
+  if (means[kIdKey] > 0.0) {
+    std::printf("path lookups take %.2fx as long as id key lookups\n",
+                means[kPath] / means[kIdKey]);
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  FMOD_STUDIO_SYSTEM* studio = nullptr;
+  FMOD_SYSTEM* core = nullptr;
+  if (!Check(FMOD_Studio_System_Create(&studio, FMOD_VERSION),
+             "Studio_System_Create")) {
+    return 1;
+  }
+  fmod_flutter::OfflineOutput output;
+  bool ok = Check(FMOD_Studio_System_GetCoreSystem(studio, &core),
+                  "GetCoreSystem");
+  if (ok && !output.Configure(core, FMOD_FLUTTER_OUTPUT_NOSOUND_NRT, "")) {
+    ok = Check(output.last_result(), "SetOutput");
+  }
+  ok = ok &&
+       Check(FMOD_Studio_System_Initialize(
+                 studio, 1024, output.studio_init_flags(),
+                 output.core_init_flags(), output.extra_driver_data()),
+             "Studio_System_Initialize") &&
+       Run(options, studio);
+  FMOD_Studio_System_Release(studio);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,394 @@
+// Renders a fixed scene from the example banks through the in-memory
+// output and compares the mix against a checked-in reference.
+//
+// The scene plays event:/main_music with its first settable parameter
+// automated, ramps the master bus down and fires event:/gun_shoot one
+// second in, all mixed by OfflineOutput::Render() in MEMORY_NRT mode with
+// automation and ramps advanced by the rendered time. The scene is rendered
+// twice, and the two mixes must agree; the first is then reduced to the RMS
+// level of each channel over 100 ms windows and compared against the
+// reference within kToleranceDb. Levels, rather than samples, keep the
+// reference small and let it survive FMOD updates that change resampling by
+// a fraction of a dB.
+//
+// Needs the FMOD SDK. Without a reference file the test is skipped (exit
+// 77); --update writes one from the current render.
+//
+// Usage: golden_audio_test --banks DIR --reference FILE [--update]
+
+#include <fmod.h>
+#include <fmod_errors.h>
+#include <fmod_studio.h>
+
+#include "mixer_control.h"
+#include "offline_output.h"
+#include "parameter_automation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kSampleRate = 48000;
+const unsigned int kBlockLength = 1024;
+const int kWindowMs = 100;
+// Levels below this are compared as this, so silence and noise-floor
+// differences do not fail the test.
+const double kFloorDb = -70.0;
+// Allowed difference per window against the reference.
+const double kToleranceDb = 0.5;
+// Allowed difference per window between the two renders of one run.
+const double kRepeatToleranceDb = 0.01;
+// Exit code CTest reports as skipped; see CMakeLists.txt.
+const int kSkipExitCode = 77;
+
+const char* const kBanks[] = {"Master.bank", "Master.strings.bank",
+                              "Music.bank", "SFX.bank"};
+const char kMusicEvent[] = "event:/main_music";
+const char kOneShotEvent[] = "event:/gun_shoot";
+const char kMasterBus[] = "bus:/";
+
+int failures = 0;
+
+struct Options {
+  std::string bank_dir;
+  std::string reference_path;
+  bool update = false;
+};
+
+// RMS level in dB per 100 ms window and channel, interleaved by channel.
+struct Levels {
+  int sample_rate = 0;
+  int channels = 0;
+  std::vector<double> db;
+};
+
+// What the render callbacks advance.
+struct Scene {
+  fmod_flutter::MixerControl mixer;
+  fmod_flutter::ParameterAutomation automation;
+};
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "golden_audio_test: %s failed: %d - %s\n", what,
+                 result, FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void OnRenderBlock(void* context, float block_seconds) {
+  Scene* scene = static_cast<Scene*>(context);
+  scene->mixer.Update(block_seconds);
+  scene->automation.Update(block_seconds);
+}
+
+bool StartEvent(FMOD_STUDIO_SYSTEM* studio, const char* path,
+                FMOD_STUDIO_EVENTINSTANCE** instance) {
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  return Check(FMOD_Studio_System_GetEvent(studio, path, &description),
+               path) &&
+         Check(FMOD_Studio_EventDescription_CreateInstance(description,
+                                                           instance),
+               "CreateInstance") &&
+         Check(FMOD_Studio_EventInstance_Start(*instance), "Start");
+}
+
+// Ramps the first parameter of instance a user can set from its minimum
+// to its maximum over two seconds. Returns false only on an FMOD error;
+// an event without such a parameter is left alone.
+bool AutomateFirstParameter(FMOD_STUDIO_EVENTINSTANCE* instance,
+                            fmod_flutter::ParameterAutomation* automation) {
+  FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+  int count = 0;
+  if (!Check(FMOD_Studio_EventInstance_GetDescription(instance, &description),
+             "GetDescription") ||
+      !Check(FMOD_Studio_EventDescription_GetParameterDescriptionCount(
+                 description, &count),
+             "GetParameterDescriptionCount")) {
+    return false;
+  }
+  const FMOD_STUDIO_PARAMETER_FLAGS kNotSettable =
+      FMOD_STUDIO_PARAMETER_READONLY | FMOD_STUDIO_PARAMETER_AUTOMATIC |
+      FMOD_STUDIO_PARAMETER_GLOBAL;
+  for (int i = 0; i < count; i++) {
+    FMOD_STUDIO_PARAMETER_DESCRIPTION parameter;
+    if (!Check(FMOD_Studio_EventDescription_GetParameterDescriptionByIndex(
+                   description, i, &parameter),
+               "GetParameterDescriptionByIndex")) {
+      return false;
+    }
+    if ((parameter.flags & kNotSettable) != 0) {
+      continue;
+    }
+    if (!Check(FMOD_Studio_EventInstance_SetParameterByID(
+                   instance, parameter.id, parameter.minimum, 0),
+               "SetParameterByID")) {
+      return false;
+    }
+    const float curve[] = {parameter.maximum, 2.0f};
+    if (automation->Add(instance, parameter.name, FMOD_FLUTTER_CURVE_LINEAR,
+                        curve, 2) == 0) {
+      return Check(automation->last_result(), "ParameterAutomation::Add");
+    }
+    std::printf("automating %s.%s\n", kMusicEvent, parameter.name);
+    return true;
+  }
+  return true;
+}
+
+// Plays the scene into a fresh Studio system and returns the mix.
+bool RenderScene(const Options& options, std::vector<float>* mix,
+                 int* channels) {
+  FMOD_STUDIO_SYSTEM* studio = nullptr;
+  FMOD_SYSTEM* core = nullptr;
+  if (!Check(FMOD_Studio_System_Create(&studio, FMOD_VERSION),
+             "Studio_System_Create")) {
+    return false;
+  }
+  fmod_flutter::OfflineOutput output;
+  Scene scene;
+  bool ok = Check(FMOD_Studio_System_GetCoreSystem(studio, &core),
+                  "GetCoreSystem");
+  if (ok && !output.Configure(core, FMOD_FLUTTER_OUTPUT_MEMORY_NRT, "")) {
+    ok = Check(output.last_result(), "SetOutput");
+  }
+  ok = ok &&
+       Check(FMOD_System_SetSoftwareFormat(core, kSampleRate,
+                                           FMOD_SPEAKERMODE_STEREO, 0),
+             "SetSoftwareFormat") &&
+       Check(FMOD_System_SetDSPBufferSize(core, kBlockLength, 4),
+             "SetDSPBufferSize") &&
+       Check(FMOD_Studio_System_Initialize(
+                 studio, 64, output.studio_init_flags(),
+                 output.core_init_flags(), output.extra_driver_data()),
+             "Studio_System_Initialize");
+  for (const char* bank : kBanks) {
+    std::string path = options.bank_dir + "/" + bank;
+    FMOD_STUDIO_BANK* handle = nullptr;
+    ok = ok && Check(FMOD_Studio_System_LoadBankFile(
+                         studio, path.c_str(),
+                         FMOD_STUDIO_LOAD_BANK_NORMAL, &handle),
+                     bank) &&
+         Check(FMOD_Studio_Bank_LoadSampleData(handle), "LoadSampleData");
+  }
+  // Sample data loads on FMOD's loading thread; waiting for it keeps the
+  // first blocks of the render the same every run.
+  ok = ok && Check(FMOD_Studio_System_FlushSampleLoading(studio),
+                   "FlushSampleLoading");
+
+  FMOD_STUDIO_EVENTINSTANCE* music = nullptr;
+  FMOD_STUDIO_EVENTINSTANCE* one_shot = nullptr;
+  if (ok) {
+    scene.mixer.CacheBanks(studio);
+    ok = StartEvent(studio, kMusicEvent, &music) &&
+         AutomateFirstParameter(music, &scene.automation);
+  }
+  if (ok && !scene.mixer.SetBusVolume(studio, kMasterBus, 0.25f, 2.0f)) {
+    ok = Check(scene.mixer.last_result(), "SetBusVolume");
+  }
+  if (ok && !output.Render(studio, core, 1.0f, OnRenderBlock, &scene)) {
+    ok = Check(output.last_result(), "Render");
+  }
+  ok = ok && StartEvent(studio, kOneShotEvent, &one_shot) &&
+       Check(FMOD_Studio_EventInstance_Release(one_shot), "Release");
+  if (ok && !output.Render(studio, core, 2.0f, OnRenderBlock, &scene)) {
+    ok = Check(output.last_result(), "Render");
+  }
+
+  if (ok) {
+    *mix = output.captured();
+    *channels = output.channels();
+    ok = !mix->empty() && *channels > 0 && output.dropped_frames() == 0 &&
+         output.sample_rate() == kSampleRate;
+    if (!ok) {
+      std::fprintf(stderr, "golden_audio_test: unexpected capture: %zu "
+                           "samples, %d channels at %d Hz\n",
+                   mix->size(), *channels, output.sample_rate());
+    }
+  }
+  scene.automation.Clear();
+  scene.mixer.Clear();
+  FMOD_Studio_System_Release(studio);
+  return ok;
+}
+
+Levels MeasureLevels(const std::vector<float>& mix, int channels) {
+  Levels levels;
+  levels.sample_rate = kSampleRate;
+  levels.channels = channels;
+  size_t window = static_cast<size_t>(kSampleRate) * kWindowMs / 1000;
+  size_t frames = mix.size() / channels;
+  for (size_t start = 0; start + window <= frames; start += window) {
+    for (int c = 0; c < channels; c++) {
+      double sum = 0.0;
+      for (size_t f = start; f < start + window; f++) {
+        double sample = mix[f * channels + c];
+        sum += sample * sample;
+      }
+      double rms = std::sqrt(sum / window);
+      double db = rms > 0.0 ? 20.0 * std::log10(rms) : kFloorDb;
+      levels.db.push_back(std::max(db, kFloorDb));
+    }
+  }
+  return levels;
+}
+
+bool ReadReference(const std::string& path, Levels* levels) {
+  FILE* file = std::fopen(path.c_str(), "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char line[256];
+  bool ok = false;
+  // First line: "# <rate> Hz, <channels> channels, <ms> ms windows".
+  int window_ms = 0;
+  if (std::fgets(line, sizeof(line), file) != nullptr &&
+      std::sscanf(line, "# %d Hz, %d channels, %d ms windows",
+                  &levels->sample_rate, &levels->channels, &window_ms) == 3 &&
+      window_ms == kWindowMs && levels->channels > 0) {
+    ok = true;
+    double value = 0.0;
+    while (std::fscanf(file, "%lf", &value) == 1) {
+      levels->db.push_back(value);
+    }
+  }
+  std::fclose(file);
+  if (!ok) {
+    std::fprintf(stderr, "golden_audio_test: %s is not a reference file\n",
+                 path.c_str());
+  }
+  return ok;
+}
+
+bool WriteReference(const std::string& path, const Levels& levels) {
+  FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    std::fprintf(stderr, "golden_audio_test: cannot write %s\n",
+                 path.c_str());
+    return false;
+  }
+  std::fprintf(file, "# %d Hz, %d channels, %d ms windows\n",
+               levels.sample_rate, levels.channels, kWindowMs);
+  for (size_t i = 0; i < levels.db.size(); i++) {
+    std::fprintf(file, "%.2f%c", levels.db[i],
+                 (i + 1) % levels.channels == 0 ? '\n' : ' ');
+  }
+  std::fclose(file);
+  return true;
+}
+
+// Reports the first window that differs by more than tolerance_db.
+bool CompareLevels(const Levels& expected, const Levels& actual,
+                   double tolerance_db, const char* test) {
+  if (expected.sample_rate != actual.sample_rate ||
+      expected.channels != actual.channels ||
+      expected.db.size() != actual.db.size()) {
+    std::fprintf(stderr, "FAIL %s: %d Hz, %d channels, %zu windows != "
+                         "%d Hz, %d channels, %zu windows\n",
+                 test, expected.sample_rate, expected.channels,
+                 expected.db.size() / expected.channels, actual.sample_rate,
+                 actual.channels, actual.db.size() / actual.channels);
+    failures++;
+    return false;
+  }
+  for (size_t i = 0; i < expected.db.size(); i++) {
+    if (std::fabs(expected.db[i] - actual.db[i]) > tolerance_db) {
+      std::fprintf(stderr,
+                   "FAIL %s: window %zu (%d ms), channel %zu: %.2f dB "
+                   "expected, %.2f dB\n",
+                   test, i / expected.channels,
+                   static_cast<int>(i / expected.channels) * kWindowMs,
+                   i % expected.channels, expected.db[i], actual.db[i]);
+      failures++;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(argv[i], "--banks") == 0 && has_value) {
+      options->bank_dir = argv[++i];
+    } else if (std::strcmp(argv[i], "--reference") == 0 && has_value) {
+      options->reference_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--update") == 0) {
+      options->update = true;
+    } else {
+      return false;
+    }
+  }
+  return !options->bank_dir.empty() && !options->reference_path.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::fprintf(stderr, "Usage: golden_audio_test --banks DIR "
+                         "--reference FILE [--update]\n");
+    return 2;
+  }
+
+  std::vector<float> first;
+  std::vector<float> second;
+  int channels = 0;
+  if (!RenderScene(options, &first, &channels) ||
+      !RenderScene(options, &second, &channels)) {
+    return 1;
+  }
+  Levels levels = MeasureLevels(first, channels);
+  std::printf("rendered %zu frames, %d channels, %zu windows\n",
+              first.size() / channels, channels,
+              levels.db.size() / channels);
+
+  bool repeat_ok = CompareLevels(levels, MeasureLevels(second, channels),
+                                 kRepeatToleranceDb, "repeat render");
+  std::printf("%-42s %s\n", "two renders of the scene agree",
+              repeat_ok ? "ok" : "failed");
+
+  if (options.update) {
+    if (!WriteReference(options.reference_path, levels)) {
+      return 1;
+    }
+    std::printf("wrote %s\n", options.reference_path.c_str());
+    return failures > 0 ? 1 : 0;
+  }
+
+  Levels reference;
+  FILE* probe = std::fopen(options.reference_path.c_str(), "r");
+  if (probe == nullptr) {
+    std::printf("no reference at %s; run with --update to write one\n",
+                options.reference_path.c_str());
+    return failures > 0 ? 1 : kSkipExitCode;
+  }
+  std::fclose(probe);
+  bool read_ok = ReadReference(options.reference_path, &reference);
+  Expect(read_ok, "reference", "unreadable reference file");
+  bool match_ok = read_ok && CompareLevels(reference, levels, kToleranceDb,
+                                           "reference");
+  std::printf("%-42s %s\n", "mix matches the reference levels",
+              match_ok ? "ok" : "failed");
+
+  if (failures > 0) {
+    std::printf("%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
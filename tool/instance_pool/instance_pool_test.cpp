@@ -0,0 +1,373 @@
+// Checks InstancePool's reuse, accounting and releases on Linux.
+//
+// The FMOD Studio calls the pool makes are answered by stand-ins defined
+// below, which hand out fake event instances and record what was done to
+// them. Each case checks that:
+// - plays served from the pool count as hits and created ones as misses,
+//   per event and summed over every pool;
+// - instances recycled into a full pool, or into no pool, are released;
+// - an instance still fading out is kept but only reused once stopped, and
+//   comes back unpaused with volume and pitch reset;
+// - idle instances invalidated behind the pool's back are dropped;
+// - shrinking or removing a pool releases its surplus idle instances and
+//   unloads the event's sample data.
+//
+// Usage: instance_pool_test
+
+#include <fmod_studio.h>
+
+#include "instance_pool.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using fmod_flutter::InstancePool;
+
+// A stand-in event instance.
+struct Instance {
+  int event;
+  FMOD_STUDIO_PLAYBACK_STATE state;
+  bool valid;
+  bool released;
+  bool paused;
+  float volume;
+  float pitch;
+};
+
+const char* const kEvents[] = {"event:/gun_shoot", "event:/player_hurt"};
+const int kEventCount = 2;
+
+std::vector<std::unique_ptr<Instance>> instances;
+int sample_data_loads[kEventCount];
+int failures = 0;
+
+void Reset() {
+  instances.clear();
+  std::memset(sample_data_loads, 0, sizeof(sample_data_loads));
+}
+
+Instance* Get(FMOD_STUDIO_EVENTINSTANCE* instance) {
+  return reinterpret_cast<Instance*>(instance);
+}
+
+FMOD_STUDIO_EVENTDESCRIPTION* Description(int event) {
+  return reinterpret_cast<FMOD_STUDIO_EVENTDESCRIPTION*>(
+      static_cast<intptr_t>(0x1000 + event));
+}
+
+int ReleasedCount() {
+  int count = 0;
+  for (const auto& instance : instances) {
+    count += instance->released ? 1 : 0;
+  }
+  return count;
+}
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void ExpectStats(const InstancePool& pool, const char* event_path, int idle,
+                 int capacity, int hits, int misses, const char* test) {
+  FmodInstancePoolStats stats;
+  if (!pool.GetStats(event_path, &stats)) {
+    Expect(false, test, "no stats");
+    return;
+  }
+  if (stats.idle_count != idle || stats.capacity != capacity ||
+      stats.hits != hits || stats.misses != misses) {
+    std::fprintf(stderr,
+                 "FAIL %s: %s: idle %d, capacity %d, hits %lld, misses %lld; "
+                 "expected %d, %d, %d, %d\n",
+                 test, event_path != nullptr ? event_path : "all pools",
+                 stats.idle_count, stats.capacity,
+                 static_cast<long long>(stats.hits),
+                 static_cast<long long>(stats.misses), idle, capacity, hits,
+                 misses);
+    failures++;
+  }
+}
+
+void Report(const char* test, int failures_before) {
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+// Marks an acquired instance stopped, as the bridges do before recycling.
+void Finish(FMOD_STUDIO_EVENTINSTANCE* instance) {
+  Get(instance)->state = FMOD_STUDIO_PLAYBACK_STOPPED;
+}
+
+void CheckHitsAndMisses() {
+  const char* test = "hits and misses";
+  int before = failures;
+  Reset();
+  InstancePool pool;
+  Expect(pool.Configure(nullptr, kEvents[0], 2, 3), test, "Configure");
+  Expect(instances.size() == 2, test, "not prewarmed");
+  Expect(sample_data_loads[0] == 1, test, "sample data not loaded");
+  ExpectStats(pool, kEvents[0], 2, 3, 0, 0, test);
+
+  FMOD_STUDIO_EVENTINSTANCE* played[3];
+  for (FMOD_STUDIO_EVENTINSTANCE*& instance : played) {
+    instance = pool.Acquire(nullptr, kEvents[0]);
+    Expect(instance != nullptr, test, "Acquire");
+    Get(instance)->state = FMOD_STUDIO_PLAYBACK_PLAYING;
+  }
+  ExpectStats(pool, kEvents[0], 0, 3, 2, 1, test);
+  Expect(instances.size() == 3, test, "miss did not create an instance");
+
+  for (FMOD_STUDIO_EVENTINSTANCE* instance : played) {
+    Finish(instance);
+    pool.Recycle(kEvents[0], instance);
+  }
+  ExpectStats(pool, kEvents[0], 3, 3, 2, 1, test);
+  Expect(ReleasedCount() == 0, test, "released with room in the pool");
+
+  Expect(pool.Acquire(nullptr, kEvents[0]) == played[2], test,
+         "newest idle instance not reused first");
+  ExpectStats(pool, kEvents[0], 2, 3, 3, 1, test);
+
+  // A second pool adds to the totals.
+  Expect(pool.Configure(nullptr, kEvents[1], 0, 1), test, "Configure");
+  pool.Acquire(nullptr, kEvents[1]);
+  ExpectStats(pool, kEvents[1], 0, 1, 0, 1, test);
+  ExpectStats(pool, nullptr, 2, 4, 3, 2, test);
+  Report(test, before);
+}
+
+void CheckReleaseWhenFull() {
+  const char* test = "release when full or unpooled";
+  int before = failures;
+  Reset();
+  InstancePool pool;
+  pool.Configure(nullptr, kEvents[0], 0, 2);
+  std::vector<FMOD_STUDIO_EVENTINSTANCE*> played;
+  for (int i = 0; i < 4; i++) {
+    played.push_back(pool.Acquire(nullptr, kEvents[0]));
+  }
+  ExpectStats(pool, kEvents[0], 0, 2, 0, 4, test);
+  for (FMOD_STUDIO_EVENTINSTANCE* instance : played) {
+    Finish(instance);
+    pool.Recycle(kEvents[0], instance);
+  }
+  ExpectStats(pool, kEvents[0], 2, 2, 0, 4, test);
+  Expect(ReleasedCount() == 2, test, "surplus instances not released");
+  Expect(!Get(played[0])->released && !Get(played[1])->released &&
+             Get(played[2])->released && Get(played[3])->released,
+         test, "released the wrong instances");
+
+  // Events without a pool create and release every time.
+  FmodInstancePoolStats stats;
+  FMOD_STUDIO_EVENTINSTANCE* unpooled = pool.Acquire(nullptr, kEvents[1]);
+  Expect(unpooled != nullptr, test, "Acquire without a pool");
+  Expect(!pool.GetStats(kEvents[1], &stats), test, "stats without a pool");
+  Finish(unpooled);
+  pool.Recycle(kEvents[1], unpooled);
+  Expect(Get(unpooled)->released, test, "unpooled instance not released");
+
+  Expect(pool.Acquire(nullptr, "event:/missing") == nullptr &&
+             pool.last_result() == FMOD_ERR_EVENT_NOTFOUND,
+         test, "missing event not reported");
+  Report(test, before);
+}
+
+void CheckFadingInstances() {
+  const char* test = "fading instances wait until stopped";
+  int before = failures;
+  Reset();
+  InstancePool pool;
+  pool.Configure(nullptr, kEvents[0], 0, 2);
+  FMOD_STUDIO_EVENTINSTANCE* fading = pool.Acquire(nullptr, kEvents[0]);
+  Instance* state = Get(fading);
+  state->state = FMOD_STUDIO_PLAYBACK_STOPPING;
+  state->paused = true;
+  state->volume = 0.2f;
+  state->pitch = 2.0f;
+  pool.Recycle(kEvents[0], fading);
+  ExpectStats(pool, kEvents[0], 1, 2, 0, 1, test);
+
+  FMOD_STUDIO_EVENTINSTANCE* other = pool.Acquire(nullptr, kEvents[0]);
+  Expect(other != fading, test, "reused while fading out");
+  ExpectStats(pool, kEvents[0], 1, 2, 0, 2, test);
+
+  state->state = FMOD_STUDIO_PLAYBACK_STOPPED;
+  Expect(pool.Acquire(nullptr, kEvents[0]) == fading, test,
+         "not reused once stopped");
+  Expect(!state->paused && state->volume == 1.0f && state->pitch == 1.0f,
+         test, "reused instance not reset");
+  ExpectStats(pool, kEvents[0], 0, 2, 1, 2, test);
+
+  // An idle instance invalidated elsewhere, e.g. by a bank unload, is
+  // dropped instead of handed out.
+  Finish(other);
+  pool.Recycle(kEvents[0], other);
+  Get(other)->valid = false;
+  FMOD_STUDIO_EVENTINSTANCE* fresh = pool.Acquire(nullptr, kEvents[0]);
+  Expect(fresh != other && fresh != nullptr, test,
+         "invalid instance handed out");
+  ExpectStats(pool, kEvents[0], 0, 2, 1, 3, test);
+  Report(test, before);
+}
+
+void CheckShrinkAndRemove() {
+  const char* test = "shrink, remove and clear";
+  int before = failures;
+  Reset();
+  InstancePool pool;
+  pool.Configure(nullptr, kEvents[0], 4, 4);
+  pool.Configure(nullptr, kEvents[1], 2, 2);
+  Expect(pool.Configure(nullptr, kEvents[0], 0, 1), test, "Configure");
+  ExpectStats(pool, kEvents[0], 1, 1, 0, 0, test);
+  Expect(ReleasedCount() == 3, test, "shrink did not release");
+  Expect(sample_data_loads[0] == 1, test, "sample data reloaded");
+
+  Expect(pool.Configure(nullptr, kEvents[0], 0, 0), test, "Configure");
+  FmodInstancePoolStats stats;
+  Expect(!pool.GetStats(kEvents[0], &stats), test, "pool not removed");
+  Expect(ReleasedCount() == 4, test, "removal did not release");
+  Expect(sample_data_loads[0] == 0, test, "sample data not unloaded");
+
+  pool.Clear();
+  Expect(ReleasedCount() == 6, test, "Clear did not release");
+  Expect(!pool.GetStats(kEvents[1], &stats), test, "Clear left a pool");
+  Report(test, before);
+}
+
+}  // namespace
+
+// Stand-ins for the FMOD Studio calls InstancePool and the event lookup
+// make.
+extern "C" {
+
+FMOD_RESULT F_API FMOD_Studio_System_GetEvent(
+    FMOD_STUDIO_SYSTEM* system, const char* path,
+    FMOD_STUDIO_EVENTDESCRIPTION** event) {
+  (void)system;
+  for (int i = 0; i < kEventCount; i++) {
+    if (std::strcmp(path, kEvents[i]) == 0) {
+      *event = Description(i);
+      return FMOD_OK;
+    }
+  }
+  return FMOD_ERR_EVENT_NOTFOUND;
+}
+
+FMOD_RESULT F_API FMOD_Studio_System_GetEventByID(
+    FMOD_STUDIO_SYSTEM* system, const FMOD_GUID* id,
+    FMOD_STUDIO_EVENTDESCRIPTION** event) {
+  (void)system;
+  (void)id;
+  (void)event;
+  return FMOD_ERR_EVENT_NOTFOUND;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_GetID(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription, FMOD_GUID* id) {
+  (void)eventdescription;
+  (void)id;
+  return FMOD_ERR_UNSUPPORTED;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_GetPath(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription, char* path, int size,
+    int* retrieved) {
+  (void)eventdescription;
+  (void)path;
+  (void)size;
+  (void)retrieved;
+  return FMOD_ERR_UNSUPPORTED;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_LoadSampleData(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription) {
+  sample_data_loads[reinterpret_cast<intptr_t>(eventdescription) - 0x1000]++;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_UnloadSampleData(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription) {
+  sample_data_loads[reinterpret_cast<intptr_t>(eventdescription) - 0x1000]--;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_CreateInstance(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription,
+    FMOD_STUDIO_EVENTINSTANCE** instance) {
+  Instance* created = new Instance();
+  created->event =
+      static_cast<int>(reinterpret_cast<intptr_t>(eventdescription) - 0x1000);
+  created->state = FMOD_STUDIO_PLAYBACK_STOPPED;
+  created->valid = true;
+  created->released = false;
+  created->paused = false;
+  created->volume = 1.0f;
+  created->pitch = 1.0f;
+  instances.emplace_back(created);
+  *instance = reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(created);
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_GetPlaybackState(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance,
+    FMOD_STUDIO_PLAYBACK_STATE* state) {
+  Instance* instance = Get(eventinstance);
+  if (!instance->valid || instance->released) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  *state = instance->state;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetPaused(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, FMOD_BOOL paused) {
+  Get(eventinstance)->paused = paused != 0;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetVolume(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, float volume) {
+  Get(eventinstance)->volume = volume;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetPitch(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, float pitch) {
+  Get(eventinstance)->pitch = pitch;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_Release(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance) {
+  Instance* instance = Get(eventinstance);
+  if (instance->released) {
+    std::fprintf(stderr, "FAIL: instance released twice\n");
+    failures++;
+  }
+  instance->released = true;
+  return FMOD_OK;
+}
+
+}  // extern "C"
+
+int main() {
+  CheckHitsAndMisses();
+  CheckReleaseWhenFull();
+  CheckFadingInstances();
+  CheckShrinkAndRemove();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
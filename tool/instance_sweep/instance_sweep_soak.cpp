@@ -0,0 +1,451 @@
+// Soak test for reclaiming event instances that finish on their own.
+//
+// Plays one-shot events a million times through the bridges' start and
+// recycle path: each play takes an instance from the event's InstancePool,
+// starts it, tracks it and has InstanceSweeper watch it, and after every
+// Studio update the finished instances the sweep reports are recycled into
+// the pool, as FmodBridge::SweepFinishedInstances does. Every play is
+// tracked under a key of its own, the event path plus a play number, as if
+// the app played a million distinct events once each, so no later play
+// ever replaces a finished instance; only the sweep can reclaim it.
+//
+// FMOD's memory, its live instance count and the tracked instances are
+// sampled as the session runs. The test fails unless the sweep reclaimed
+// instances and all three level off once the first tenth of the plays is
+// done. With --no-sweep nothing reclaims the finished instances and the
+// test fails, which shows the checks catch a leak.
+//
+// Studio updates synchronously on this thread into a non-realtime output,
+// so every update mixes one block and the events play out in less than
+// real time.
+//
+// Usage: instance_sweep_soak <banks dir> <event path> [<event path> ...]
+//                            [--plays N] [--per-tick N] [--pool N]
+//                            [--budget N] [--no-sweep]
+
+#include <dirent.h>
+#include <fmod.h>
+#include <fmod_errors.h>
+#include <fmod_studio.h>
+
+#include "instance_pool.h"
+#include "instance_sweeper.h"
+#include "offline_output.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Memory and instance samples taken over the session.
+const int kSamples = 20;
+
+// Growth allowed between the first-tenth sample and the end, for FMOD's
+// allocator settling and instances that happen to be live at the end.
+const double kMemoryTolerance = 0.10;
+
+// The most live or tracked instances allowed at any later sample, as a
+// multiple of the first-tenth sample, which the number of plays in flight
+// bounds once the sweep keeps up.
+const int kInstanceGrowth = 2;
+
+struct Options {
+  std::string bank_dir;
+  std::vector<std::string> event_paths;
+  int64_t plays = 1000000;
+  int per_tick = 4;
+  int pool = 8;
+  int budget = FMOD_FLUTTER_INSTANCE_SWEEP_BUDGET;
+  bool sweep = true;
+};
+
+struct Sample {
+  int64_t plays;
+  int memory;
+  int live_instances;
+  int tracked;
+};
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: instance_sweep_soak <banks dir> <event path> "
+               "[<event path> ...] [options]\n"
+               "  --plays N     one-shots to play (default 1000000)\n"
+               "  --per-tick N  plays per update tick (default 4)\n"
+               "  --pool N      idle instances pooled per event (default 8,\n"
+               "                0 releases every recycled instance)\n"
+               "  --budget N    instances checked per sweep (default %d)\n"
+               "  --no-sweep    track instances without sweeping; the test\n"
+               "                then fails as finished instances pile up\n",
+               FMOD_FLUTTER_INSTANCE_SWEEP_BUDGET);
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(arg, "--plays") == 0 && has_value) {
+      options->plays = std::atoll(argv[++i]);
+    } else if (std::strcmp(arg, "--per-tick") == 0 && has_value) {
+      options->per_tick = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--pool") == 0 && has_value) {
+      options->pool = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--budget") == 0 && has_value) {
+      options->budget = std::atoi(argv[++i]);
+    } else if (std::strcmp(arg, "--no-sweep") == 0) {
+      options->sweep = false;
+    } else if (arg[0] != '-') {
+      positional.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  if (positional.size() < 2 || options->plays < kSamples ||
+      options->per_tick < 1 || options->pool < 0 || options->budget < 1) {
+    return false;
+  }
+  options->bank_dir = positional[0];
+  options->event_paths.assign(positional.begin() + 1, positional.end());
+  return true;
+}
+
+bool Check(FMOD_RESULT result, const char* what) {
+  if (result != FMOD_OK) {
+    std::fprintf(stderr, "instance_sweep_soak: %s failed: %d - %s\n", what,
+                 result, FMOD_ErrorString(result));
+    return false;
+  }
+  return true;
+}
+
+double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Loads every .bank in dir, strings banks first.
+bool LoadBanks(FMOD_STUDIO_SYSTEM* studio, const std::string& dir) {
+  DIR* handle = opendir(dir.c_str());
+  if (handle == nullptr) {
+    std::fprintf(stderr, "instance_sweep_soak: cannot open %s\n",
+                 dir.c_str());
+    return false;
+  }
+  std::vector<std::string> names;
+  while (dirent* entry = readdir(handle)) {
+    std::string name = entry->d_name;
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".bank") == 0) {
+      names.push_back(name);
+    }
+  }
+  closedir(handle);
+  std::stable_partition(names.begin(), names.end(), [](const std::string& n) {
+    return n.find(".strings.") != std::string::npos;
+  });
+  for (const std::string& name : names) {
+    FMOD_STUDIO_BANK* bank = nullptr;
+    std::string path = dir + "/" + name;
+    if (!Check(FMOD_Studio_System_LoadBankFile(studio, path.c_str(),
+                                               FMOD_STUDIO_LOAD_BANK_NORMAL,
+                                               &bank),
+               path.c_str())) {
+      return false;
+    }
+  }
+  return !names.empty();
+}
+
+int CurrentMemory() {
+  int current = 0;
+  int peak = 0;
+  FMOD_Memory_GetStats(&current, &peak, 1);
+  return current;
+}
+
+// Instances FMOD holds for the events, counting each event once.
+int LiveInstances(std::vector<FMOD_STUDIO_EVENTDESCRIPTION*> descriptions) {
+  std::sort(descriptions.begin(), descriptions.end());
+  descriptions.erase(std::unique(descriptions.begin(), descriptions.end()),
+                     descriptions.end());
+  int total = 0;
+  for (FMOD_STUDIO_EVENTDESCRIPTION* description : descriptions) {
+    int count = 0;
+    FMOD_Studio_EventDescription_GetInstanceCount(description, &count);
+    total += count;
+  }
+  return total;
+}
+
+// The event instance table, pool and sweeper of a bridge, driven the way
+// FmodBridge::StartEvent, RecycleInstance and SweepFinishedInstances drive
+// them. The bridges track an instance under its event path; here the key
+// is a play of its own, so the table keeps the event path for the pool.
+class Session {
+ public:
+  Session(FMOD_STUDIO_SYSTEM* studio, bool sweep)
+      : studio_(studio), sweep_(sweep) {}
+
+  bool ConfigurePool(const std::string& event_path, int capacity) {
+    return pool_.Configure(studio_, event_path.c_str(), 0, capacity) ||
+           Check(pool_.last_result(), "configure pool");
+  }
+
+  // Plays event_path and tracks the instance under key.
+  bool StartEvent(const std::string& key, const std::string& event_path) {
+    FMOD_STUDIO_EVENTINSTANCE* instance =
+        pool_.Acquire(studio_, event_path.c_str());
+    if (instance == nullptr) {
+      return Check(pool_.last_result(), event_path.c_str());
+    }
+    FMOD_RESULT result = FMOD_Studio_EventInstance_Start(instance);
+    if (result != FMOD_OK) {
+      pool_.Recycle(event_path.c_str(), instance);
+      return Check(result, "Start");
+    }
+    Tracked tracked = {event_path, instance};
+    instances_[key] = tracked;
+    if (sweep_) {
+      sweeper_.Watch(key.c_str(), instance);
+    }
+    return true;
+  }
+
+  // Recycles the tracked instances the sweep found finished and returns
+  // how many. Call after each Studio update.
+  int SweepFinishedInstances(int budget) {
+    if (sweeper_.Sweep(budget) == 0) {
+      return 0;
+    }
+    int reclaimed = 0;
+    for (const auto& finished : sweeper_.finished()) {
+      auto it = instances_.find(finished.key);
+      if (it == instances_.end() || it->second.instance != finished.instance) {
+        continue;
+      }
+      RecycleInstance(it->second);
+      instances_.erase(it);
+      reclaimed++;
+    }
+    return reclaimed;
+  }
+
+  size_t tracked() const { return instances_.size(); }
+  int watched() const { return sweeper_.watched_count(); }
+  bool GetPoolStats(FmodInstancePoolStats* stats) const {
+    return pool_.GetStats(nullptr, stats);
+  }
+
+  // Releases the pooled instances. Call before releasing the Studio
+  // system.
+  void Clear() {
+    sweeper_.Clear();
+    pool_.Clear();
+    instances_.clear();
+  }
+
+ private:
+  struct Tracked {
+    std::string event_path;
+    FMOD_STUDIO_EVENTINSTANCE* instance;
+  };
+
+  void RecycleInstance(const Tracked& tracked) {
+    sweeper_.Forget(tracked.instance);
+    pool_.Recycle(tracked.event_path.c_str(), tracked.instance);
+  }
+
+  FMOD_STUDIO_SYSTEM* studio_;
+  bool sweep_;
+  std::unordered_map<std::string, Tracked> instances_;
+  fmod_flutter::InstancePool pool_;
+  fmod_flutter::InstanceSweeper sweeper_;
+};
+
+// Returns the first sample after the first tenth of the plays whose count
+// exceeds the limit, or null.
+const Sample* FindGrowth(const std::vector<Sample>& samples, int limit,
+                         int Sample::*count) {
+  for (size_t i = kSamples / 10; i < samples.size(); i++) {
+    if (samples[i].*count > limit) {
+      return &samples[i];
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return 2;
+  }
+
+  FMOD_STUDIO_SYSTEM* studio = nullptr;
+  FMOD_SYSTEM* core = nullptr;
+  if (!Check(FMOD_Studio_System_Create(&studio, FMOD_VERSION),
+             "Studio_System_Create")) {
+    return 1;
+  }
+  fmod_flutter::OfflineOutput output;
+  bool ok = Check(FMOD_Studio_System_GetCoreSystem(studio, &core),
+                  "GetCoreSystem");
+  if (ok && !output.Configure(core, FMOD_FLUTTER_OUTPUT_NOSOUND_NRT, "")) {
+    ok = Check(output.last_result(), "SetOutput");
+  }
+  ok = ok &&
+       Check(FMOD_Studio_System_Initialize(
+                 studio, 1024, output.studio_init_flags(),
+                 output.core_init_flags(), output.extra_driver_data()),
+             "Studio_System_Initialize") &&
+       LoadBanks(studio, options.bank_dir);
+
+  Session session(studio, options.sweep);
+  std::vector<FMOD_STUDIO_EVENTDESCRIPTION*> descriptions;
+  for (size_t i = 0; ok && i < options.event_paths.size(); i++) {
+    const char* path = options.event_paths[i].c_str();
+    FMOD_STUDIO_EVENTDESCRIPTION* description = nullptr;
+    FMOD_BOOL oneshot = 0;
+    ok = Check(FMOD_Studio_System_GetEvent(studio, path, &description),
+               path) &&
+         Check(FMOD_Studio_EventDescription_IsOneshot(description, &oneshot),
+               path) &&
+         Check(FMOD_Studio_EventDescription_LoadSampleData(description),
+               path);
+    if (ok && !oneshot) {
+      // Looping and sustained events never stop on their own.
+      std::fprintf(stderr, "instance_sweep_soak: %s is not a one-shot\n",
+                   path);
+      ok = false;
+    }
+    if (ok && options.pool > 0) {
+      ok = session.ConfigurePool(path, options.pool);
+    }
+    descriptions.push_back(description);
+  }
+  if (!ok) {
+    session.Clear();
+    FMOD_Studio_System_Release(studio);
+    return 1;
+  }
+  FMOD_Studio_System_FlushSampleLoading(studio);
+
+  std::vector<Sample> samples;
+  int64_t sample_every = options.plays / kSamples;
+  int64_t plays = 0;
+  int64_t reclaimed = 0;
+  int64_t ticks = 0;
+  double sweep_ms = 0.0;
+  double max_sweep_ms = 0.0;
+  int max_watched = 0;
+  while (ok && plays < options.plays) {
+    for (int i = 0; ok && i < options.per_tick && plays < options.plays;
+         i++) {
+      const std::string& path =
+          options.event_paths[plays % options.event_paths.size()];
+      ok = session.StartEvent(path + "#" + std::to_string(plays), path);
+      if (!ok) {
+        break;
+      }
+      plays++;
+      if (plays % sample_every == 0) {
+        samples.push_back({plays, CurrentMemory(),
+                           LiveInstances(descriptions),
+                           static_cast<int>(session.tracked())});
+      }
+    }
+    ok = ok && Check(FMOD_Studio_System_Update(studio), "Update");
+    ticks++;
+
+    Clock::time_point start = Clock::now();
+    reclaimed += session.SweepFinishedInstances(options.budget);
+    double elapsed = ElapsedMs(start, Clock::now());
+    sweep_ms += elapsed;
+    max_sweep_ms = std::max(max_sweep_ms, elapsed);
+    max_watched = std::max(max_watched, session.watched());
+  }
+  FmodInstancePoolStats pool_stats;
+  bool pooled = session.GetPoolStats(&pool_stats);
+  session.Clear();
+  FMOD_Studio_System_Release(studio);
+  if (!ok) {
+    return 1;
+  }
+
+  std::printf("%lld plays over %lld ticks, %d plays per tick, each under "
+              "its own key\n",
+              static_cast<long long>(plays), static_cast<long long>(ticks),
+              options.per_tick);
+  std::printf("reclaimed by the sweep: %lld\n",
+              static_cast<long long>(reclaimed));
+  if (pooled) {
+    std::printf("pool: %lld plays reused an instance, %lld created one\n",
+                static_cast<long long>(pool_stats.hits),
+                static_cast<long long>(pool_stats.misses));
+  }
+  std::printf("sweep: %.4f ms per tick on average, %.4f ms at most, "
+              "%d instances watched at most\n",
+              sweep_ms / ticks, max_sweep_ms, max_watched);
+  std::printf("%10s %12s %10s %8s\n", "plays", "fmod bytes", "instances",
+              "tracked");
+  for (const Sample& sample : samples) {
+    std::printf("%10lld %12d %10d %8d\n", static_cast<long long>(sample.plays),
+                sample.memory, sample.live_instances, sample.tracked);
+  }
+
+  bool passed = true;
+  if (reclaimed == 0) {
+    std::fprintf(stderr, "instance_sweep_soak: no instance was reclaimed\n");
+    passed = false;
+  }
+  // Memory must have levelled off once the first tenth of the plays is
+  // done.
+  const Sample& settled = samples[kSamples / 10 - 1];
+  const Sample& last = samples.back();
+  if (last.memory > settled.memory * (1.0 + kMemoryTolerance)) {
+    std::fprintf(stderr,
+                 "instance_sweep_soak: memory grew from %d to %d bytes\n",
+                 settled.memory, last.memory);
+    passed = false;
+  }
+  // So must the live and tracked instances. Releases take effect at the
+  // next Studio update, so the instances reclaimed by the last sweep and
+  // started since may still be counted.
+  int slack = options.budget + options.per_tick;
+  const Sample* grown =
+      FindGrowth(samples, kInstanceGrowth * settled.live_instances + slack,
+                 &Sample::live_instances);
+  if (grown != nullptr) {
+    std::fprintf(stderr,
+                 "instance_sweep_soak: %d instances live after %lld plays, "
+                 "%d after %lld\n",
+                 grown->live_instances, static_cast<long long>(grown->plays),
+                 settled.live_instances,
+                 static_cast<long long>(settled.plays));
+    passed = false;
+  }
+  grown = FindGrowth(samples, kInstanceGrowth * settled.tracked + slack,
+                     &Sample::tracked);
+  if (grown != nullptr) {
+    std::fprintf(stderr,
+                 "instance_sweep_soak: %d instances tracked after %lld "
+                 "plays, %d after %lld\n",
+                 grown->tracked, static_cast<long long>(grown->plays),
+                 settled.tracked, static_cast<long long>(settled.plays));
+    passed = false;
+  }
+  if (!passed) {
+    return 1;
+  }
+  std::printf("memory and instances flat\n");
+  return 0;
+}
@@ -0,0 +1,297 @@
+// Checks the loudness meter DSP against ITU-R BS.1770 and EBU Tech 3341.
+//
+// The meter runs through its FMOD_DSP_DESCRIPTION callbacks on a stand-in
+// DSP state that only reports the sample rate, and its readings are taken
+// from the shared-memory table Dart reads. Checks that:
+// - the K-weighting response at 48 kHz matches the filter coefficients
+//   given in BS.1770 within 0.05 dB, and at 44.1 kHz within 0.1 dB;
+// - the Tech 3341 minimum-requirement signals 1 to 6 give the expected
+//   momentary, short-term and gated integrated loudness within 0.1 LU,
+//   with the LFE channel of 5.1 ignored;
+// - a reset restarts integrated loudness.
+//
+// Calls no FMOD function, so it runs without the SDK.
+//
+// Usage: loudness_meter_test
+
+#include <fmod.h>
+
+#include "dsp_effects.h"
+#include "loudness_meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+// Frames per read callback, as the mixer would use.
+const int kBlockLength = 1024;
+
+int failures = 0;
+int sample_rate = 48000;
+
+FMOD_RESULT F_CALL GetSampleRate(FMOD_DSP_STATE* dsp_state, int* rate) {
+  (void)dsp_state;
+  *rate = sample_rate;
+  return FMOD_OK;
+}
+
+// A meter DSP fed with sines, one per channel at a shared frequency.
+class Meter {
+ public:
+  Meter(int rate, int channels) : channels_(channels), phase_(0.0) {
+    sample_rate = rate;
+    std::memset(&functions_, 0, sizeof(functions_));
+    functions_.getsamplerate = GetSampleRate;
+    std::memset(&state_, 0, sizeof(state_));
+    state_.functions = &functions_;
+    description().create(&state_);
+    slot_ = fmod_flutter::AcquireLoudnessSlot(1);
+    description().setparameterint(&state_, FMOD_FLUTTER_LOUDNESS_METER_SLOT,
+                                  slot_);
+  }
+
+  ~Meter() {
+    description().release(&state_);
+    fmod_flutter::ReleaseLoudnessSlot(slot_);
+  }
+
+  // Plays a sine at frequency with the given peak level per channel, in
+  // dBFS; levels below -200 are silence.
+  void Play(double frequency, const double* levels_db, double seconds) {
+    std::vector<double> amplitudes(channels_);
+    for (int ch = 0; ch < channels_; ch++) {
+      amplitudes[ch] =
+          levels_db[ch] < -200.0 ? 0.0 : std::pow(10.0, levels_db[ch] / 20.0);
+    }
+    std::vector<float> input(kBlockLength * channels_);
+    std::vector<float> output(kBlockLength * channels_);
+    long long frames = std::llround(seconds * sample_rate);
+    double step = 2.0 * kPi * frequency / sample_rate;
+    while (frames > 0) {
+      int length = static_cast<int>(std::min<long long>(frames, kBlockLength));
+      for (int i = 0; i < length; i++) {
+        double sample = std::sin(phase_);
+        phase_ = std::fmod(phase_ + step, 2.0 * kPi);
+        for (int ch = 0; ch < channels_; ch++) {
+          input[i * channels_ + ch] =
+              static_cast<float>(amplitudes[ch] * sample);
+        }
+      }
+      int out_channels = 0;
+      description().read(&state_, input.data(), output.data(),
+                         static_cast<unsigned int>(length), channels_,
+                         &out_channels);
+      frames -= length;
+    }
+  }
+
+  // Plays the same level on every channel.
+  void PlayAll(double frequency, double level_db, double seconds) {
+    std::vector<double> levels(channels_, level_db);
+    Play(frequency, levels.data(), seconds);
+  }
+
+  void Reset() {
+    description().setparameterint(&state_, FMOD_FLUTTER_LOUDNESS_METER_RESET,
+                                  1);
+  }
+
+  const FmodLoudnessReading& reading() const {
+    return fmod_flutter_loudness_readings()[slot_];
+  }
+
+ private:
+  static const FMOD_DSP_DESCRIPTION& description() {
+    return fmod_flutter::GetLoudnessMeterDescription();
+  }
+
+  int channels_;
+  double phase_;
+  int slot_;
+  FMOD_DSP_STATE_FUNCTIONS functions_;
+  FMOD_DSP_STATE state_;
+};
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void ExpectNear(double actual, double expected, double tolerance,
+                const char* test, const char* what) {
+  if (!(std::fabs(actual - expected) <= tolerance)) {
+    std::fprintf(stderr, "FAIL %s: %s is %.3f, expected %.3f +- %.2f\n",
+                 test, what, actual, expected, tolerance);
+    failures++;
+  }
+}
+
+void Report(const char* test, int failures_before) {
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+// Power gain in dB of a biquad at frequency, for a 48 kHz sample rate.
+double BiquadGainDb(const double* b, const double* a, double frequency) {
+  double w = 2.0 * kPi * frequency / 48000.0;
+  double num_re = b[0] + b[1] * std::cos(w) + b[2] * std::cos(2.0 * w);
+  double num_im = -b[1] * std::sin(w) - b[2] * std::sin(2.0 * w);
+  double den_re = 1.0 + a[1] * std::cos(w) + a[2] * std::cos(2.0 * w);
+  double den_im = -a[1] * std::sin(w) - a[2] * std::sin(2.0 * w);
+  return 10.0 * std::log10((num_re * num_re + num_im * num_im) /
+                           (den_re * den_re + den_im * den_im));
+}
+
+// The K-weighting of BS.1770 Annex 1, from its 48 kHz coefficients.
+double KWeightingDb(double frequency) {
+  const double pre_b[] = {1.53512485958697, -2.69169618940638,
+                          1.19839281085285};
+  const double pre_a[] = {1.0, -1.69065929318241, 0.73248077421585};
+  const double rlb_b[] = {1.0, -2.0, 1.0};
+  const double rlb_a[] = {1.0, -1.99004745483398, 0.99007225036621};
+  return BiquadGainDb(pre_b, pre_a, frequency) +
+         BiquadGainDb(rlb_b, rlb_a, frequency);
+}
+
+void CheckKWeighting() {
+  const char* test = "K-weighting matches BS.1770";
+  int before = failures;
+  const double kFrequencies[] = {30.0,   60.0,   100.0,  250.0,  500.0,
+                                 1000.0, 2000.0, 4000.0, 8000.0, 12000.0};
+  const int kRates[] = {48000, 44100};
+  const double kTolerances[] = {0.05, 0.1};
+  for (int r = 0; r < 2; r++) {
+    for (double frequency : kFrequencies) {
+      Meter meter(kRates[r], 1);
+      // A mono sine at 0 dBFS has a mean square of 1/2.
+      meter.PlayAll(frequency, 0.0, 2.0);
+      double expected = -0.691 + 10.0 * std::log10(0.5) +
+                        KWeightingDb(frequency);
+      char what[64];
+      std::snprintf(what, sizeof(what), "%g Hz at %d Hz", frequency,
+                    kRates[r]);
+      ExpectNear(meter.reading().momentary_lufs, expected, kTolerances[r],
+                 test, what);
+    }
+  }
+  Report(test, before);
+}
+
+// One segment of a Tech 3341 signal: a 1 kHz sine at a level per channel.
+struct Segment {
+  double seconds;
+  double levels_db[6];
+};
+
+struct Case {
+  const char* name;
+  int channels;
+  std::vector<Segment> segments;
+  double momentary;  // checked when not NAN, as is short_term
+  double short_term;
+  double integrated;
+};
+
+void CheckTech3341() {
+  const char* test = "EBU Tech 3341 cases 1 to 6";
+  int before = failures;
+  const double kNone = NAN;
+  const double kLfe = -10.0;  // loud, so any leak into the sum shows
+  std::vector<Case> cases = {
+      {"case 1", 2, {{20.0, {-23.0, -23.0}}}, -23.0, -23.0, -23.0},
+      {"case 2", 2, {{20.0, {-33.0, -33.0}}}, -33.0, -33.0, -33.0},
+      {"case 3",
+       2,
+       {{10.0, {-36.0, -36.0}}, {60.0, {-23.0, -23.0}},
+        {10.0, {-36.0, -36.0}}},
+       kNone,
+       kNone,
+       -23.0},
+      {"case 4",
+       2,
+       {{10.0, {-72.0, -72.0}},
+        {10.0, {-36.0, -36.0}},
+        {60.0, {-23.0, -23.0}},
+        {10.0, {-36.0, -36.0}},
+        {10.0, {-72.0, -72.0}}},
+       kNone,
+       kNone,
+       -23.0},
+      {"case 5",
+       2,
+       {{20.0, {-26.0, -26.0}}, {20.1, {-20.0, -20.0}},
+        {20.0, {-26.0, -26.0}}},
+       kNone,
+       kNone,
+       -23.0},
+      // FMOD orders 5.1 as L R C LFE Ls Rs.
+      {"case 6",
+       6,
+       {{20.0, {-28.0, -28.0, -24.0, kLfe, -30.0, -30.0}}},
+       -23.0,
+       -23.0,
+       -23.0},
+  };
+  for (const Case& c : cases) {
+    Meter meter(48000, c.channels);
+    for (const Segment& segment : c.segments) {
+      meter.Play(1000.0, segment.levels_db, segment.seconds);
+    }
+    char what[64];
+    if (!std::isnan(c.momentary)) {
+      std::snprintf(what, sizeof(what), "%s momentary", c.name);
+      ExpectNear(meter.reading().momentary_lufs, c.momentary, 0.1, test, what);
+    }
+    if (!std::isnan(c.short_term)) {
+      std::snprintf(what, sizeof(what), "%s short-term", c.name);
+      ExpectNear(meter.reading().short_term_lufs, c.short_term, 0.1, test,
+                 what);
+    }
+    std::snprintf(what, sizeof(what), "%s integrated", c.name);
+    ExpectNear(meter.reading().integrated_lufs, c.integrated, 0.1, test, what);
+  }
+  Report(test, before);
+}
+
+void CheckReset() {
+  const char* test = "reset restarts integrated loudness";
+  int before = failures;
+  Meter meter(48000, 2);
+  meter.PlayAll(1000.0, -20.0, 10.0);
+  ExpectNear(meter.reading().integrated_lufs, -20.0, 0.1, test,
+             "before the reset");
+  meter.Reset();
+  meter.PlayAll(1000.0, -30.0, 10.0);
+  ExpectNear(meter.reading().integrated_lufs, -30.0, 0.1, test,
+             "after the reset");
+
+  // Silence never passes the absolute gate.
+  Meter silent(48000, 2);
+  silent.PlayAll(1000.0, -1000.0, 2.0);
+  Expect(std::isinf(silent.reading().integrated_lufs) &&
+             std::isinf(silent.reading().momentary_lufs),
+         test, "silence has a level");
+  Report(test, before);
+}
+
+}  // namespace
+
+int main() {
+  CheckKWeighting();
+  CheckTech3341();
+  CheckReset();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,369 @@
+// Checks MicCapture on Linux against a simulated loopback device.
+//
+// The FMOD record and channel calls MicCapture makes are answered by
+// stand-ins defined below: a record driver that writes a known sample
+// sequence into the looping record sound in whole driver blocks, and a
+// monitor channel that reads the same sound back at its playback rate on
+// an output clock that drifts from the record clock. The test needs no
+// FMOD libraries or audio device. Each case checks that:
+// - the Dart tap returns every recorded frame, in order;
+// - the monitor plays exactly the recorded audio, never audio the driver
+//   has not written yet or has already overwritten;
+// - the smoothed monitor latency settles around its target;
+// - Start() rejects a monitor latency the one-second loop cannot hold.
+//
+// Usage: mic_capture_test
+
+#include <fmod.h>
+
+#include "mic_capture.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const int kRate = 48000;
+const int kChannels = 2;
+// The bridges tick at about 60 Hz.
+const int kTickMs = 16;
+
+// The stand-in record driver and its looping sound.
+struct Driver {
+  int block_frames;
+  bool recording;
+  bool sound_created;
+  std::vector<int16_t> data;
+  unsigned int loop_frames;
+  unsigned int record_pos;
+  int64_t recorded_frames;
+  double due_frames;
+};
+
+// The stand-in monitor channel.
+struct Monitor {
+  bool playing;
+  double position;  // fractional frames into the loop
+  double due_frames;
+  float frequency;
+  double output_drift;  // output clock rate over record clock rate, minus 1
+  int64_t played_frames;
+  int64_t wrong_frames;  // frames that were not the recorded audio
+};
+
+Driver driver;
+Monitor monitor;
+int failures = 0;
+
+FMOD_SYSTEM* const kCoreSystem = reinterpret_cast<FMOD_SYSTEM*>(1);
+FMOD_SOUND* const kSound = reinterpret_cast<FMOD_SOUND*>(2);
+FMOD_CHANNEL* const kChannel = reinterpret_cast<FMOD_CHANNEL*>(3);
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+// The sample the driver records for frame `frame` of the recording.
+int16_t Sample(int64_t frame, int channel) {
+  return static_cast<int16_t>(frame % 32749 - 16384 + channel);
+}
+
+void Reset(int block_frames, double output_drift) {
+  driver = Driver();
+  driver.block_frames = block_frames;
+  monitor = Monitor();
+  monitor.output_drift = output_drift;
+}
+
+// Advances both clocks by one tick: the driver delivers the whole blocks
+// due by now, and the monitor channel plays what its rate allows.
+void AdvanceDevice() {
+  if (driver.recording) {
+    driver.due_frames += kRate * kTickMs / 1000.0;
+    while (driver.due_frames >= driver.block_frames) {
+      driver.due_frames -= driver.block_frames;
+      for (int i = 0; i < driver.block_frames; i++) {
+        for (int ch = 0; ch < kChannels; ch++) {
+          driver.data[driver.record_pos * kChannels + ch] =
+              Sample(driver.recorded_frames, ch);
+        }
+        driver.record_pos = (driver.record_pos + 1) % driver.loop_frames;
+        driver.recorded_frames++;
+      }
+    }
+  }
+  if (monitor.playing) {
+    monitor.due_frames += kRate * kTickMs / 1000.0 *
+                          (1.0 + monitor.output_drift) * monitor.frequency /
+                          kRate;
+    while (monitor.due_frames >= 1.0) {
+      monitor.due_frames -= 1.0;
+      unsigned int frame = static_cast<unsigned int>(monitor.position);
+      if (driver.data[frame * kChannels] !=
+          Sample(monitor.played_frames, 0)) {
+        monitor.wrong_frames++;
+      }
+      monitor.played_frames++;
+      monitor.position = std::fmod(monitor.position + 1.0,
+                                   static_cast<double>(driver.loop_frames));
+    }
+  }
+}
+
+struct Result {
+  int64_t tapped_frames;
+  int64_t tap_errors;
+  // Largest distance of the smoothed monitor latency from its target over
+  // the second half of the run.
+  int64_t max_latency_error_us;
+  FmodMicStats stats;
+};
+
+// Records for `seconds`, reading the tap every tick like Dart does.
+Result Record(fmod_flutter::MicCapture* capture, int seconds) {
+  Result result;
+  std::memset(&result, 0, sizeof(result));
+  std::vector<float> samples(FMOD_FLUTTER_MIC_TAP_SAMPLES);
+  int ticks = seconds * 1000 / kTickMs;
+  for (int tick = 0; tick < ticks; tick++) {
+    AdvanceDevice();
+    capture->Update();
+    int32_t count = fmod_flutter_mic_read(
+        samples.data(), static_cast<int32_t>(samples.size()));
+    for (int32_t i = 0; i < count; i++) {
+      int64_t frame = result.tapped_frames + i / kChannels;
+      float expected = Sample(frame, i % kChannels) * (1.0f / 32768.0f);
+      if (samples[i] != expected) {
+        result.tap_errors++;
+      }
+    }
+    result.tapped_frames += count / kChannels;
+
+    capture->GetStats(&result.stats);
+    if (tick >= ticks / 2 && result.stats.monitoring) {
+      int64_t error = std::llabs(result.stats.monitor_latency_us -
+                                 result.stats.target_latency_us);
+      if (error > result.max_latency_error_us) {
+        result.max_latency_error_us = error;
+      }
+    }
+  }
+  return result;
+}
+
+void CheckRejected(int latency_ms) {
+  char test[64];
+  std::snprintf(test, sizeof(test), "rejects a %d ms monitor latency",
+                latency_ms);
+  Reset(480, 0.0);
+  int failures_before = failures;
+  fmod_flutter::MicCapture capture;
+  Expect(!capture.Start(kCoreSystem, 0, true, latency_ms), test,
+         "Start succeeded");
+  Expect(capture.last_result() == FMOD_ERR_INVALID_PARAM, test,
+         "last_result is not FMOD_ERR_INVALID_PARAM");
+  Expect(!driver.sound_created && !driver.recording, test,
+         "recording started anyway");
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+// Records `seconds` with the driver delivering `block_frames` at a time
+// and, with monitor set, an output clock `output_drift` off the record
+// clock, and checks what the tap and the monitor got.
+void CheckLoopback(const char* test, bool monitor_on, int latency_ms,
+                   int block_frames, double output_drift,
+                   int64_t expected_target_us) {
+  Reset(block_frames, output_drift);
+  int failures_before = failures;
+  fmod_flutter::MicCapture capture;
+  Expect(capture.Start(kCoreSystem, 0, monitor_on, latency_ms), test,
+         "Start failed");
+  const int kSeconds = 20;
+  Result result = Record(&capture, kSeconds);
+
+  Expect(result.stats.recorded_frames == driver.recorded_frames, test,
+         "recorded frames differ from the driver's");
+  Expect(result.tapped_frames == driver.recorded_frames, test,
+         "tap missed recorded frames");
+  Expect(result.tap_errors == 0, test, "tap returned the wrong samples");
+  Expect(result.stats.dropped_samples == 0, test, "tap dropped samples");
+  if (monitor_on) {
+    Expect(result.stats.monitoring == 1, test, "monitor not playing");
+    Expect(monitor.played_frames > kRate * (kSeconds - 1), test,
+           "monitor played too little");
+    Expect(monitor.wrong_frames == 0, test,
+           "monitor played audio other than the recording");
+    Expect(result.stats.target_latency_us == expected_target_us, test,
+           "unexpected target latency");
+    // The drift window is 1 ms; allow a driver block of jitter on top.
+    int64_t block_us = static_cast<int64_t>(block_frames) * 1000000 / kRate;
+    Expect(result.max_latency_error_us <= 1000 + block_us, test,
+           "monitor latency did not settle around the target");
+  }
+  capture.Stop();
+  Expect(!driver.recording && !driver.sound_created && !monitor.playing,
+         test, "Stop left the device running");
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+}  // namespace
+
+// Stand-ins for the FMOD calls MicCapture makes.
+extern "C" {
+
+FMOD_RESULT F_API FMOD_System_GetRecordNumDrivers(FMOD_SYSTEM* system,
+                                                  int* numdrivers,
+                                                  int* numconnected) {
+  *numdrivers = 1;
+  if (numconnected != nullptr) {
+    *numconnected = 1;
+  }
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_GetRecordDriverInfo(
+    FMOD_SYSTEM* system, int id, char* name, int namelen, FMOD_GUID* guid,
+    int* systemrate, FMOD_SPEAKERMODE* speakermode, int* speakermodechannels,
+    FMOD_DRIVER_STATE* state) {
+  *systemrate = kRate;
+  *speakermodechannels = kChannels;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_CreateSound(FMOD_SYSTEM* system,
+                                          const char* name_or_data,
+                                          FMOD_MODE mode,
+                                          FMOD_CREATESOUNDEXINFO* exinfo,
+                                          FMOD_SOUND** sound) {
+  driver.sound_created = true;
+  driver.data.assign(exinfo->length / sizeof(int16_t), 0);
+  driver.loop_frames = exinfo->length / (sizeof(int16_t) * kChannels);
+  *sound = kSound;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Sound_Release(FMOD_SOUND* sound) {
+  driver.sound_created = false;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_RecordStart(FMOD_SYSTEM* system, int id,
+                                          FMOD_SOUND* sound, FMOD_BOOL loop) {
+  driver.recording = true;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_RecordStop(FMOD_SYSTEM* system, int id) {
+  driver.recording = false;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_IsRecording(FMOD_SYSTEM* system, int id,
+                                          FMOD_BOOL* recording) {
+  *recording = driver.recording ? 1 : 0;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_GetRecordPosition(FMOD_SYSTEM* system, int id,
+                                                unsigned int* position) {
+  *position = driver.record_pos;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Sound_Lock(FMOD_SOUND* sound, unsigned int offset,
+                                  unsigned int length, void** ptr1,
+                                  void** ptr2, unsigned int* len1,
+                                  unsigned int* len2) {
+  unsigned int size =
+      static_cast<unsigned int>(driver.data.size() * sizeof(int16_t));
+  char* bytes = reinterpret_cast<char*>(driver.data.data());
+  *ptr1 = bytes + offset;
+  if (offset + length <= size) {
+    *len1 = length;
+    *ptr2 = nullptr;
+    *len2 = 0;
+  } else {
+    *len1 = size - offset;
+    *ptr2 = bytes;
+    *len2 = length - *len1;
+  }
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Sound_Unlock(FMOD_SOUND* sound, void* ptr1,
+                                    void* ptr2, unsigned int len1,
+                                    unsigned int len2) {
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_PlaySound(FMOD_SYSTEM* system,
+                                        FMOD_SOUND* sound,
+                                        FMOD_CHANNELGROUP* channelgroup,
+                                        FMOD_BOOL paused,
+                                        FMOD_CHANNEL** channel) {
+  monitor.playing = true;
+  monitor.position = 0.0;
+  monitor.due_frames = 0.0;
+  monitor.frequency = static_cast<float>(kRate);
+  *channel = kChannel;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Channel_Stop(FMOD_CHANNEL* channel) {
+  monitor.playing = false;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Channel_IsPlaying(FMOD_CHANNEL* channel,
+                                         FMOD_BOOL* isplaying) {
+  *isplaying = monitor.playing ? 1 : 0;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Channel_GetPosition(FMOD_CHANNEL* channel,
+                                           unsigned int* position,
+                                           FMOD_TIMEUNIT postype) {
+  *position = static_cast<unsigned int>(monitor.position);
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Channel_SetFrequency(FMOD_CHANNEL* channel,
+                                            float frequency) {
+  monitor.frequency = frequency;
+  return FMOD_OK;
+}
+
+}  // extern "C"
+
+int main() {
+  CheckRejected(0);
+  CheckRejected(501);
+  CheckRejected(1000);
+
+  // 10 ms driver blocks unless noted.
+  CheckLoopback("tap only", false, 50, 480, 0.0, 0);
+  CheckLoopback("monitor 50 ms, output 0.5% fast", true, 50, 480, 0.005,
+                50000);
+  CheckLoopback("monitor 50 ms, output 0.5% slow", true, 50, 480, -0.005,
+                50000);
+  CheckLoopback("monitor 500 ms, output 0.5% fast", true, 500, 480, 0.005,
+                500000);
+  // A driver block longer than the target raises the target to one block.
+  CheckLoopback("monitor 20 ms, 40 ms driver blocks", true, 20, 1920, 0.005,
+                40000);
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,433 @@
+// Checks the curve math of ParameterAutomation on Linux.
+//
+// CubicBezierEase() and LfoWave() are checked directly. Every curve type is
+// then run through ParameterAutomation against a stand-in event parameter,
+// defined below, with Update() stepping the curve clock to exact times, so
+// each case reads the value the curve would set at that time. The cases
+// cover:
+// - Bezier easings reach 0 and 1 at their ends and, for handles within
+//   [0, 1], never fall in between;
+// - each LFO waveform stays in [-1, 1] and hits its peaks at phase 0.25
+//   and 0.75;
+// - LINEAR and EXPONENTIAL start at the current value, end on target and
+//   are monotonic;
+// - KEYFRAMES hold the first value before the first key, pass through every
+//   key at its time and survive keys that share a time;
+// - ADSR with a zero attack or decay, a release during the attack, an
+//   automatic release after hold, and a zero release.
+//
+// Usage: parameter_automation_test
+
+#include <fmod_studio.h>
+
+#include "parameter_automation.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using fmod_flutter::CubicBezierEase;
+using fmod_flutter::LfoWave;
+using fmod_flutter::ParameterAutomation;
+
+// Any non-null handles; the stand-ins never dereference them.
+FMOD_STUDIO_EVENTINSTANCE* const kInstance =
+    reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(0x1000);
+FMOD_STUDIO_EVENTDESCRIPTION* const kDescription =
+    reinterpret_cast<FMOD_STUDIO_EVENTDESCRIPTION*>(0x2000);
+const char kParameter[] = "Intensity";
+
+// The stand-in parameter: its value and whether it has ever been NaN.
+float parameter_value = 0.0f;
+bool parameter_nan = false;
+
+int failures = 0;
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void ExpectNear(float actual, float expected, const char* test,
+                const char* what) {
+  if (!(std::fabs(actual - expected) <= 1e-3f)) {
+    std::fprintf(stderr, "FAIL %s: %s is %.6f, not %.6f\n", test, what,
+                 actual, expected);
+    failures++;
+  }
+}
+
+void Report(const char* test, int failures_before) {
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+// Drives one curve on the stand-in parameter with an exact clock.
+class Runner {
+ public:
+  // Starts a curve on the parameter, which holds from.
+  Runner(int type, const std::vector<float>& data, float from)
+      : now_(0.0) {
+    parameter_value = from;
+    parameter_nan = false;
+    id_ = automation_.Add(kInstance, kParameter, type, data.data(),
+                          static_cast<int>(data.size()));
+  }
+
+  // The parameter's value once the curve clock reaches seconds.
+  float At(double seconds) {
+    automation_.Update(static_cast<float>(seconds - now_));
+    now_ = seconds;
+    return parameter_value;
+  }
+
+  bool Release() { return automation_.Release(id_); }
+
+  int id() const { return id_; }
+  bool active() const { return automation_.active_count() > 0; }
+
+ private:
+  ParameterAutomation automation_;
+  int id_;
+  double now_;
+};
+
+void CheckBezierEase() {
+  const char* test = "Bezier easing: ends and monotonicity";
+  int before = failures;
+  // linear, ease, ease-in, ease-out, ease-in-out, and two with a flat
+  // slope at one end.
+  static const float kHandles[][4] = {
+      {0.0f, 0.0f, 1.0f, 1.0f},   {0.25f, 0.1f, 0.25f, 1.0f},
+      {0.42f, 0.0f, 1.0f, 1.0f},  {0.0f, 0.0f, 0.58f, 1.0f},
+      {0.42f, 0.0f, 0.58f, 1.0f}, {0.0f, 0.0f, 0.0f, 1.0f},
+      {1.0f, 0.0f, 1.0f, 1.0f}};
+  for (const float* handles : kHandles) {
+    ExpectNear(CubicBezierEase(handles, 0.0f), 0.0f, test, "y(0)");
+    ExpectNear(CubicBezierEase(handles, 1.0f), 1.0f, test, "y(1)");
+    float previous = 0.0f;
+    for (int i = 0; i <= 1000; i++) {
+      float y = CubicBezierEase(handles, i / 1000.0f);
+      if (y < previous - 1e-4f) {
+        std::fprintf(stderr,
+                     "FAIL %s: (%g, %g, %g, %g) falls from %f to %f at %f\n",
+                     test, handles[0], handles[1], handles[2], handles[3],
+                     previous, y, i / 1000.0f);
+        failures++;
+        break;
+      }
+      previous = y;
+    }
+  }
+  for (int i = 0; i <= 10; i++) {
+    ExpectNear(CubicBezierEase(kHandles[0], i / 10.0f), i / 10.0f, test,
+               "linear handles");
+  }
+  // CSS ease at x = 0.5.
+  ExpectNear(CubicBezierEase(kHandles[1], 0.5f), 0.8024f, test, "ease(0.5)");
+  // Handles past [0, 1] overshoot in between but still land on the ends.
+  static const float kBack[] = {0.34f, 1.56f, 0.64f, 1.0f};
+  ExpectNear(CubicBezierEase(kBack, 0.0f), 0.0f, test, "overshoot y(0)");
+  ExpectNear(CubicBezierEase(kBack, 1.0f), 1.0f, test, "overshoot y(1)");
+  Expect(CubicBezierEase(kBack, 0.6f) > 1.0f, test, "overshoot peak");
+  Report(test, before);
+}
+
+void CheckLfoWave() {
+  const char* test = "LFO waveforms: range and peaks";
+  int before = failures;
+  const int kWaves[] = {FMOD_FLUTTER_LFO_SINE, FMOD_FLUTTER_LFO_TRIANGLE,
+                        FMOD_FLUTTER_LFO_SQUARE, FMOD_FLUTTER_LFO_SAW};
+  for (int wave : kWaves) {
+    for (int i = 0; i < 1000; i++) {
+      float value = LfoWave(wave, i / 1000.0f);
+      if (!(value >= -1.0f && value <= 1.0f)) {
+        std::fprintf(stderr, "FAIL %s: waveform %d is %f at %f\n", test, wave,
+                     value, i / 1000.0f);
+        failures++;
+        break;
+      }
+    }
+  }
+  for (int wave : {FMOD_FLUTTER_LFO_SINE, FMOD_FLUTTER_LFO_TRIANGLE}) {
+    ExpectNear(LfoWave(wave, 0.0f), 0.0f, test, "phase 0");
+    ExpectNear(LfoWave(wave, 0.25f), 1.0f, test, "phase 0.25");
+    ExpectNear(LfoWave(wave, 0.5f), 0.0f, test, "phase 0.5");
+    ExpectNear(LfoWave(wave, 0.75f), -1.0f, test, "phase 0.75");
+  }
+  // The triangle has no jumps, including across the cycle.
+  for (int i = 0; i < 1000; i++) {
+    float step = std::fabs(LfoWave(FMOD_FLUTTER_LFO_TRIANGLE,
+                                   (i + 1) % 1000 / 1000.0f) -
+                           LfoWave(FMOD_FLUTTER_LFO_TRIANGLE, i / 1000.0f));
+    if (step > 0.0041f) {
+      Expect(false, test, "triangle jumps");
+      break;
+    }
+  }
+  ExpectNear(LfoWave(FMOD_FLUTTER_LFO_SQUARE, 0.1f), 1.0f, test, "square");
+  ExpectNear(LfoWave(FMOD_FLUTTER_LFO_SQUARE, 0.6f), -1.0f, test, "square");
+  ExpectNear(LfoWave(FMOD_FLUTTER_LFO_SAW, 0.0f), -1.0f, test, "saw start");
+  ExpectNear(LfoWave(FMOD_FLUTTER_LFO_SAW, 0.5f), 0.0f, test, "saw middle");
+  Report(test, before);
+}
+
+void CheckLinear() {
+  const char* test = "LINEAR: current value to target";
+  int before = failures;
+  Runner runner(FMOD_FLUTTER_CURVE_LINEAR, {10.0f, 1.0f}, 2.0f);
+  Expect(runner.id() != 0, test, "Add failed");
+  ExpectNear(runner.At(0.0), 2.0f, test, "start");
+  ExpectNear(runner.At(0.25), 4.0f, test, "0.25 s");
+  ExpectNear(runner.At(0.5), 6.0f, test, "0.5 s");
+  Expect(runner.active(), test, "ended early");
+  ExpectNear(runner.At(1.0), 10.0f, test, "end");
+  Expect(!runner.active(), test, "still running at its end");
+
+  Runner instant(FMOD_FLUTTER_CURVE_LINEAR, {10.0f, 0.0f}, 2.0f);
+  Expect(instant.id() != 0, test, "zero duration: Add failed");
+  ExpectNear(parameter_value, 10.0f, test, "zero duration");
+  Expect(!instant.active(), test, "zero duration still running");
+
+  Runner invalid(FMOD_FLUTTER_CURVE_LINEAR, {10.0f}, 2.0f);
+  Expect(invalid.id() == 0, test, "accepted a short curve");
+  Report(test, before);
+}
+
+void CheckExponential() {
+  const char* test = "EXPONENTIAL: ends, shape and monotonicity";
+  int before = failures;
+  // (e^(k/2) - 1) / (e^k - 1) for k = 4.
+  const float kMidpoint = 0.1192029f;
+  for (float curvature : {4.0f, -4.0f, 0.0f}) {
+    Runner runner(FMOD_FLUTTER_CURVE_EXPONENTIAL, {1.0f, 1.0f, curvature},
+                  0.0f);
+    ExpectNear(runner.At(0.0), 0.0f, test, "start");
+    float previous = 0.0f;
+    for (int i = 1; i < 20; i++) {
+      float value = runner.At(i / 20.0);
+      Expect(value >= previous, test, "falls");
+      previous = value;
+      if (i == 10) {
+        float expected = curvature > 0.0f   ? kMidpoint
+                         : curvature < 0.0f ? 1.0f - kMidpoint
+                                            : 0.5f;
+        ExpectNear(value, expected, test, "midpoint");
+      }
+    }
+    ExpectNear(runner.At(1.0), 1.0f, test, "end");
+    Expect(!runner.active(), test, "still running at its end");
+  }
+  Report(test, before);
+}
+
+void CheckKeyframes() {
+  const char* test = "KEYFRAMES: keys, holds and boundaries";
+  int before = failures;
+  // time, value, x1, y1, x2, y2
+  Runner runner(FMOD_FLUTTER_CURVE_KEYFRAMES,
+                {0.5f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+                 1.5f, 5.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+                 2.5f, 3.0f, 0.25f, 0.1f, 0.25f, 1.0f},
+                0.0f);
+  ExpectNear(runner.At(0.0), 1.0f, test, "before the first key");
+  ExpectNear(runner.At(0.5), 1.0f, test, "first key");
+  ExpectNear(runner.At(1.0), 3.0f, test, "linear segment middle");
+  ExpectNear(runner.At(1.5), 5.0f, test, "second key");
+  static const float kEase[] = {0.25f, 0.1f, 0.25f, 1.0f};
+  ExpectNear(runner.At(2.0), 5.0f - 2.0f * CubicBezierEase(kEase, 0.5f),
+             test, "eased segment middle");
+  Expect(runner.active(), test, "ended early");
+  ExpectNear(runner.At(2.5), 3.0f, test, "last key");
+  Expect(!runner.active(), test, "still running after the last key");
+
+  // Two keys at one time make a step instead of dividing by zero.
+  Runner step(FMOD_FLUTTER_CURVE_KEYFRAMES,
+              {0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+               1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+               1.0f, 4.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+               2.0f, 4.0f, 0.0f, 0.0f, 1.0f, 1.0f},
+              0.0f);
+  ExpectNear(step.At(0.5), 0.0f, test, "before the step");
+  ExpectNear(step.At(1.0), 4.0f, test, "at the step");
+  ExpectNear(step.At(1.5), 4.0f, test, "after the step");
+  Expect(!parameter_nan, test, "step set NaN");
+
+  // A single key is a constant that ends after its time.
+  Runner single(FMOD_FLUTTER_CURVE_KEYFRAMES,
+                {1.0f, 7.0f, 0.0f, 0.0f, 1.0f, 1.0f}, 0.0f);
+  ExpectNear(single.At(0.0), 7.0f, test, "single key");
+  ExpectNear(single.At(1.5), 7.0f, test, "single key end");
+  Expect(!single.active(), test, "single key still running");
+  Report(test, before);
+}
+
+void CheckLfo() {
+  const char* test = "LFO: center, depth and duration";
+  int before = failures;
+  // sine at 1 Hz around 5 by 2 for 2 seconds
+  Runner runner(FMOD_FLUTTER_CURVE_LFO,
+                {FMOD_FLUTTER_LFO_SINE, 1.0f, 5.0f, 2.0f, 2.0f}, 0.0f);
+  ExpectNear(runner.At(0.0), 5.0f, test, "start");
+  ExpectNear(runner.At(0.25), 7.0f, test, "peak");
+  ExpectNear(runner.At(1.75), 3.0f, test, "trough, second cycle");
+  ExpectNear(runner.At(2.0), 5.0f, test, "end");
+  Expect(!runner.active(), test, "still running at its end");
+
+  Runner endless(FMOD_FLUTTER_CURVE_LFO,
+                 {FMOD_FLUTTER_LFO_SAW, 2.0f, 0.0f, 1.0f, 0.0f}, 0.0f);
+  ExpectNear(endless.At(100.25), 0.0f, test, "endless saw");
+  Expect(endless.active(), test, "endless LFO ended");
+  Report(test, before);
+}
+
+// floor, peak, sustain, attack, decay, release, hold
+void CheckAdsr() {
+  const char* test = "ADSR: stages";
+  int before = failures;
+  Runner runner(FMOD_FLUTTER_CURVE_ADSR,
+                {0.0f, 1.0f, 0.5f, 1.0f, 1.0f, 1.0f, -1.0f}, 0.0f);
+  ExpectNear(runner.At(0.0), 0.0f, test, "start");
+  ExpectNear(runner.At(0.5), 0.5f, test, "attack");
+  ExpectNear(runner.At(1.0), 1.0f, test, "peak");
+  ExpectNear(runner.At(1.5), 0.75f, test, "decay");
+  ExpectNear(runner.At(10.0), 0.5f, test, "sustain held until released");
+  Expect(runner.Release(), test, "Release failed");
+  ExpectNear(runner.At(10.5), 0.25f, test, "release");
+  ExpectNear(runner.At(11.0), 0.0f, test, "floor");
+  Expect(!runner.active(), test, "still running after release");
+  Report(test, before);
+}
+
+void CheckAdsrZeroStages() {
+  const char* test = "ADSR: zero attack, decay and release";
+  int before = failures;
+  Runner no_attack(FMOD_FLUTTER_CURVE_ADSR,
+                   {0.0f, 1.0f, 0.5f, 0.0f, 1.0f, 1.0f, -1.0f}, 0.0f);
+  ExpectNear(no_attack.At(0.0), 1.0f, test, "zero attack starts at peak");
+  ExpectNear(no_attack.At(0.5), 0.75f, test, "zero attack decay");
+
+  Runner no_decay(FMOD_FLUTTER_CURVE_ADSR,
+                  {0.0f, 1.0f, 0.5f, 1.0f, 0.0f, 1.0f, -1.0f}, 0.0f);
+  ExpectNear(no_decay.At(0.5), 0.5f, test, "zero decay attack");
+  ExpectNear(no_decay.At(1.0), 0.5f, test, "zero decay drops to sustain");
+  Expect(!parameter_nan, test, "zero decay set NaN");
+
+  Runner neither(FMOD_FLUTTER_CURVE_ADSR,
+                 {0.0f, 1.0f, 0.5f, 0.0f, 0.0f, 1.0f, -1.0f}, 0.0f);
+  ExpectNear(neither.At(0.0), 0.5f, test, "zero attack and decay");
+  Expect(!parameter_nan, test, "zero attack and decay set NaN");
+
+  Runner no_release(FMOD_FLUTTER_CURVE_ADSR,
+                    {0.2f, 1.0f, 0.5f, 1.0f, 1.0f, 0.0f, -1.0f}, 0.0f);
+  no_release.At(3.0);
+  Expect(no_release.Release(), test, "Release failed");
+  ExpectNear(no_release.At(3.0), 0.2f, test, "zero release drops to floor");
+  Expect(!no_release.active(), test, "zero release still running");
+  Report(test, before);
+}
+
+void CheckAdsrReleaseMidAttack() {
+  const char* test = "ADSR: release during the attack";
+  int before = failures;
+  Runner runner(FMOD_FLUTTER_CURVE_ADSR,
+                {0.0f, 1.0f, 0.5f, 1.0f, 1.0f, 1.0f, -1.0f}, 0.0f);
+  ExpectNear(runner.At(0.5), 0.5f, test, "attack");
+  Expect(runner.Release(), test, "Release failed");
+  // Releases from where the attack got to, not from sustain or peak.
+  ExpectNear(runner.At(0.75), 0.375f, test, "release");
+  ExpectNear(runner.At(1.5), 0.0f, test, "floor");
+  Expect(!runner.active(), test, "still running after release");
+  Report(test, before);
+}
+
+void CheckAdsrHold() {
+  const char* test = "ADSR: automatic release after hold";
+  int before = failures;
+  Runner runner(FMOD_FLUTTER_CURVE_ADSR,
+                {0.0f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f, 1.0f}, 0.0f);
+  ExpectNear(runner.At(1.5), 0.5f, test, "hold");
+  ExpectNear(runner.At(2.0), 0.5f, test, "release starts");
+  ExpectNear(runner.At(2.5), 0.25f, test, "release");
+  ExpectNear(runner.At(3.0), 0.0f, test, "floor");
+  Expect(!runner.active(), test, "still running after release");
+  Report(test, before);
+}
+
+}  // namespace
+
+// Stand-ins for the FMOD Studio calls ParameterAutomation makes: one event
+// with one parameter.
+extern "C" {
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_GetDescription(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance,
+    FMOD_STUDIO_EVENTDESCRIPTION** description) {
+  if (eventinstance != kInstance) {
+    return FMOD_ERR_INVALID_HANDLE;
+  }
+  *description = kDescription;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventDescription_GetParameterDescriptionByName(
+    FMOD_STUDIO_EVENTDESCRIPTION* eventdescription, const char* name,
+    FMOD_STUDIO_PARAMETER_DESCRIPTION* parameter) {
+  (void)eventdescription;
+  (void)name;
+  parameter->name = kParameter;
+  parameter->id.data1 = 1;
+  parameter->id.data2 = 2;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_GetParameterByID(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, FMOD_STUDIO_PARAMETER_ID id,
+    float* value, float* finalvalue) {
+  (void)eventinstance;
+  (void)id;
+  *value = parameter_value;
+  if (finalvalue != nullptr) {
+    *finalvalue = parameter_value;
+  }
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Studio_EventInstance_SetParameterByID(
+    FMOD_STUDIO_EVENTINSTANCE* eventinstance, FMOD_STUDIO_PARAMETER_ID id,
+    float value, FMOD_BOOL ignoreseekspeed) {
+  (void)eventinstance;
+  (void)id;
+  (void)ignoreseekspeed;
+  if (std::isnan(value)) {
+    parameter_nan = true;
+  }
+  parameter_value = value;
+  return FMOD_OK;
+}
+
+}  // extern "C"
+
+int main() {
+  CheckBezierEase();
+  CheckLfoWave();
+  CheckLinear();
+  CheckExponential();
+  CheckKeyframes();
+  CheckLfo();
+  CheckAdsr();
+  CheckAdsrZeroStages();
+  CheckAdsrReleaseMidAttack();
+  CheckAdsrHold();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
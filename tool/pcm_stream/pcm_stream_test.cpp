@@ -0,0 +1,374 @@
+// Checks the PCM stream ring on Linux, with the test standing in for
+// FMOD's stream thread.
+//
+// The FMOD calls PcmStreams makes are answered by stand-ins defined below;
+// the one creating the sound keeps its pcmreadcallback, which the test
+// then calls as FMOD's stream thread would. Checks that:
+// - frames come out in order and intact as the ring wraps around, for
+//   write and read sizes that do not divide its capacity;
+// - writes past the free space are cut to whole frames that fit and the
+//   rest counted as dropped;
+// - reads that run dry play silence and count an underrun, except before
+//   the first write;
+// - stale and destroyed stream ids are refused;
+// - a producer thread and a consumer thread running at once pass every
+//   frame through in order.
+//
+// Usage: pcm_stream_test
+
+#include <fmod.h>
+#include <fmod_studio.h>
+
+#include "pcm_stream.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fmod_flutter::PcmStreams;
+
+const int kSampleRate = 48000;
+// What PcmStream reads per callback and rounds its ring up to at 48 kHz.
+const int kDecodeFrames = 960;
+const int kCapacityFrames = 2048;
+// Frames passed between the producer and consumer threads.
+const uint32_t kThreadedFrames = 500000;
+
+// The sound the stand-ins created last.
+struct Sound {
+  FMOD_SOUND_PCMREAD_CALLBACK read;
+  void* user_data;
+  int channels;
+  unsigned int decode_frames;
+  bool released;
+};
+
+Sound sound;
+int failures = 0;
+
+FMOD_STUDIO_SYSTEM* const kStudio =
+    reinterpret_cast<FMOD_STUDIO_SYSTEM*>(static_cast<intptr_t>(0x1000));
+FMOD_SYSTEM* const kCore =
+    reinterpret_cast<FMOD_SYSTEM*>(static_cast<intptr_t>(0x2000));
+
+// Reads frames as FMOD's stream thread would.
+std::vector<float> Read(int frames) {
+  std::vector<float> out(static_cast<size_t>(frames) * sound.channels, -1.0f);
+  sound.read(reinterpret_cast<FMOD_SOUND*>(&sound), out.data(),
+             static_cast<unsigned int>(out.size() * sizeof(float)));
+  return out;
+}
+
+// Frame n holds n + 1 on channel 0, -(n + 1) on channel 1 and so on, so
+// silence and out-of-order frames both show.
+float SampleOf(uint32_t frame, int channel) {
+  float value = static_cast<float>(frame + 1);
+  return channel % 2 == 0 ? value : -value;
+}
+
+std::vector<float> Frames(uint32_t first, int frames, int channels) {
+  std::vector<float> samples(static_cast<size_t>(frames) * channels);
+  for (int i = 0; i < frames; i++) {
+    for (int ch = 0; ch < channels; ch++) {
+      samples[static_cast<size_t>(i) * channels + ch] =
+          SampleOf(first + i, ch);
+    }
+  }
+  return samples;
+}
+
+int32_t Write(int stream_id, const std::vector<float>& samples) {
+  return fmod_flutter_pcm_stream_write(stream_id, samples.data(),
+                                       static_cast<int32_t>(samples.size()));
+}
+
+FmodPcmStreamStats Stats(const PcmStreams& streams, int stream_id) {
+  FmodPcmStreamStats stats;
+  std::memset(&stats, 0, sizeof(stats));
+  streams.GetStats(stream_id, &stats);
+  return stats;
+}
+
+void Expect(bool condition, const char* test, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAIL %s: %s\n", test, what);
+    failures++;
+  }
+}
+
+void Report(const char* test, int failures_before) {
+  std::printf("%-42s %s\n", test,
+              failures == failures_before ? "ok" : "failed");
+}
+
+void CheckWrapAround() {
+  const char* test = "frames survive the ring wrapping";
+  int before = failures;
+  const int kChannels = 3;
+  PcmStreams streams;
+  int id = streams.Create(kStudio, kSampleRate, kChannels, 10);
+  Expect(id > 0, test, "Create");
+  FmodPcmStreamStats stats = Stats(streams, id);
+  Expect(stats.capacity_frames == kCapacityFrames, test, "capacity");
+  Expect(sound.decode_frames == kDecodeFrames, test, "decode buffer");
+
+  // 700-frame writes against 960-frame reads wrap at a different offset
+  // each pass.
+  uint32_t written = 0;
+  uint32_t read = 0;
+  while (read < 50 * kCapacityFrames && failures == before) {
+    while (stats.queued_frames + 700 <= kCapacityFrames) {
+      Expect(Write(id, Frames(written, 700, kChannels)) == 700 * kChannels,
+             test, "write refused with room");
+      written += 700;
+      stats = Stats(streams, id);
+    }
+    std::vector<float> out = Read(kDecodeFrames);
+    for (int i = 0; i < kDecodeFrames; i++) {
+      for (int ch = 0; ch < kChannels; ch++) {
+        if (out[static_cast<size_t>(i) * kChannels + ch] !=
+            SampleOf(read + i, ch)) {
+          std::fprintf(stderr, "FAIL %s: frame %u channel %d is %g\n", test,
+                       read + i, ch, out[static_cast<size_t>(i) * kChannels +
+                                         ch]);
+          failures++;
+          i = kDecodeFrames;
+          break;
+        }
+      }
+    }
+    read += kDecodeFrames;
+    stats = Stats(streams, id);
+    Expect(stats.queued_frames == static_cast<int32_t>(written - read), test,
+           "queued frames");
+  }
+  Expect(stats.underruns == 0 && stats.dropped_frames == 0, test,
+         "underran or dropped");
+  Report(test, before);
+}
+
+void CheckDropsAndUnderruns() {
+  const char* test = "drops and underruns are counted";
+  int before = failures;
+  PcmStreams streams;
+  int id = streams.Create(kStudio, kSampleRate, 2, 10);
+
+  // Silence before the first write is the stream starting.
+  std::vector<float> out = Read(kDecodeFrames);
+  FmodPcmStreamStats stats = Stats(streams, id);
+  Expect(out[0] == 0.0f && out.back() == 0.0f, test, "start not silent");
+  Expect(stats.underruns == 0 && stats.underrun_frames == 0, test,
+         "start counted as an underrun");
+
+  // 3000 frames plus a half frame into a 2048-frame ring.
+  std::vector<float> samples = Frames(0, 3000, 2);
+  samples.push_back(0.5f);
+  Expect(Write(id, samples) == kCapacityFrames * 2, test,
+         "wrong number of samples accepted");
+  stats = Stats(streams, id);
+  Expect(stats.queued_frames == kCapacityFrames, test, "queued frames");
+  Expect(stats.dropped_frames == 3000 - kCapacityFrames, test,
+         "dropped frames");
+  Expect(Write(id, Frames(0, 1, 2)) == 0, test, "write into a full ring");
+  stats = Stats(streams, id);
+  Expect(stats.dropped_frames == 3001 - kCapacityFrames, test,
+         "dropped frames of a full ring");
+
+  // 2048 frames: two full reads, then 128 frames and 832 of silence.
+  Read(kDecodeFrames);
+  Read(kDecodeFrames);
+  out = Read(kDecodeFrames);
+  const int kLeft = kCapacityFrames - 2 * kDecodeFrames;
+  Expect(out[(kLeft - 1) * 2] == SampleOf(kCapacityFrames - 1, 0) &&
+             out[kLeft * 2] == 0.0f && out.back() == 0.0f,
+         test, "underrun not filled with silence");
+  stats = Stats(streams, id);
+  Expect(stats.underruns == 1 && stats.underrun_frames == kDecodeFrames - kLeft,
+         test, "partial underrun");
+  Read(kDecodeFrames);
+  stats = Stats(streams, id);
+  Expect(stats.underruns == 2 &&
+             stats.underrun_frames == 2 * kDecodeFrames - kLeft,
+         test, "empty read not counted");
+
+  // The decode buffer and the stand-in mixer's 4 x 1024 frames.
+  Write(id, Frames(0, 480, 2));
+  stats = Stats(streams, id);
+  Expect(stats.latency_us == (480 + kDecodeFrames + 4096) * 1000000LL /
+                                 kSampleRate,
+         test, "latency");
+  Report(test, before);
+}
+
+void CheckStreamIds() {
+  const char* test = "stale ids are refused";
+  int before = failures;
+  PcmStreams streams;
+  int first = streams.Create(kStudio, kSampleRate, 1, 10);
+  Expect(streams.Destroy(first) && sound.released, test, "Destroy");
+  Expect(Write(first, Frames(0, 1, 1)) == -1, test, "destroyed id written");
+  // Reuses the slot under a new id.
+  int second = streams.Create(kStudio, kSampleRate, 1, 10);
+  Expect(second != first, test, "id reused");
+  Expect(Write(first, Frames(0, 1, 1)) == -1, test, "stale id written");
+  Expect(Write(second, Frames(0, 1, 1)) == 1, test, "new id refused");
+  Expect(!streams.Destroy(first) &&
+             streams.last_result() == FMOD_ERR_INVALID_HANDLE,
+         test, "stale id destroyed");
+  Expect(streams.Create(kStudio, kSampleRate, 0, 10) == 0 &&
+             streams.last_result() == FMOD_ERR_INVALID_PARAM,
+         test, "zero channels accepted");
+  streams.Clear();
+  Expect(Write(second, Frames(0, 1, 1)) == -1, test, "cleared id written");
+  Report(test, before);
+}
+
+void CheckConcurrent() {
+  const char* test = "producer and consumer threads";
+  int before = failures;
+  PcmStreams streams;
+  int id = streams.Create(kStudio, kSampleRate, 2, 10);
+
+  // Writes in odd sizes, retrying whatever did not fit, and yields after
+  // each write so the ring rarely fills and the boundaries between writes
+  // drift around it. Gives up once the consumer stops on a bad frame.
+  std::atomic<bool> stop(false);
+  std::thread producer([id, &stop]() {
+    uint32_t written = 0;
+    int size = 1;
+    while (written < kThreadedFrames && !stop.load()) {
+      int frames = static_cast<int>(
+          std::min<uint32_t>(static_cast<uint32_t>(size), kThreadedFrames -
+                                                              written));
+      int32_t accepted = Write(id, Frames(written, frames, 2));
+      written += static_cast<uint32_t>(accepted / 2);
+      size = size % 331 + 13;
+      std::this_thread::yield();
+    }
+  });
+
+  // Reads in odd sizes too, so reads straddle the end of the ring. Silent
+  // frames are underruns; every other frame must be the next one.
+  uint32_t received = 0;
+  int size = 5;
+  bool in_order = true;
+  while (received < kThreadedFrames && in_order) {
+    std::vector<float> out = Read(size);
+    size = size % kDecodeFrames + 53;
+    for (size_t i = 0; i < out.size(); i += 2) {
+      if (out[i] == 0.0f && out[i + 1] == 0.0f) {
+        continue;
+      }
+      if (out[i] != SampleOf(received, 0) ||
+          out[i + 1] != SampleOf(received, 1)) {
+        std::fprintf(stderr, "FAIL %s: frame %u is (%g, %g)\n", test,
+                     received, out[i], out[i + 1]);
+        failures++;
+        in_order = false;
+        break;
+      }
+      received++;
+    }
+  }
+  stop.store(true);
+  producer.join();
+  Expect(received == kThreadedFrames, test, "frames lost");
+  Report(test, before);
+}
+
+}  // namespace
+
+// Stand-ins for the FMOD calls PcmStreams makes.
+extern "C" {
+
+FMOD_RESULT F_API FMOD_Studio_System_GetCoreSystem(FMOD_STUDIO_SYSTEM* system,
+                                                   FMOD_SYSTEM** coresystem) {
+  (void)system;
+  *coresystem = kCore;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_CreateSound(FMOD_SYSTEM* system,
+                                          const char* name_or_data,
+                                          FMOD_MODE mode,
+                                          FMOD_CREATESOUNDEXINFO* exinfo,
+                                          FMOD_SOUND** sound_out) {
+  (void)system;
+  (void)name_or_data;
+  if ((mode & FMOD_OPENUSER) == 0 ||
+      exinfo->format != FMOD_SOUND_FORMAT_PCMFLOAT) {
+    return FMOD_ERR_FORMAT;
+  }
+  sound.read = exinfo->pcmreadcallback;
+  sound.user_data = exinfo->userdata;
+  sound.channels = exinfo->numchannels;
+  sound.decode_frames = exinfo->decodebuffersize;
+  sound.released = false;
+  *sound_out = reinterpret_cast<FMOD_SOUND*>(&sound);
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_PlaySound(FMOD_SYSTEM* system,
+                                        FMOD_SOUND* sound_in,
+                                        FMOD_CHANNELGROUP* channelgroup,
+                                        FMOD_BOOL paused,
+                                        FMOD_CHANNEL** channel) {
+  (void)system;
+  (void)sound_in;
+  (void)channelgroup;
+  (void)paused;
+  (void)channel;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Sound_GetUserData(FMOD_SOUND* sound_in,
+                                         void** userdata) {
+  *userdata = reinterpret_cast<Sound*>(sound_in)->user_data;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_Sound_Release(FMOD_SOUND* sound_in) {
+  reinterpret_cast<Sound*>(sound_in)->released = true;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_GetDSPBufferSize(FMOD_SYSTEM* system,
+                                               unsigned int* bufferlength,
+                                               int* numbuffers) {
+  (void)system;
+  *bufferlength = 1024;
+  *numbuffers = 4;
+  return FMOD_OK;
+}
+
+FMOD_RESULT F_API FMOD_System_GetSoftwareFormat(FMOD_SYSTEM* system,
+                                                int* samplerate,
+                                                FMOD_SPEAKERMODE* speakermode,
+                                                int* numrawspeakers) {
+  (void)system;
+  (void)speakermode;
+  (void)numrawspeakers;
+  *samplerate = kSampleRate;
+  return FMOD_OK;
+}
+
+}  // extern "C"
+
+int main() {
+  CheckWrapAround();
+  CheckDropsAndUnderruns();
+  CheckStreamIds();
+  CheckConcurrent();
+
+  if (failures > 0) {
+    std::fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
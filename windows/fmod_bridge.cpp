@@ -2,16 +2,32 @@
 
 #include <iostream>
 #include <chrono>
+#include <cstring>
 
 namespace fmod_flutter {
 
-FmodBridge::FmodBridge() : studio_system_(nullptr), core_system_(nullptr), running_(false) {}
+// How far ahead of a beat a schedule is armed on the DSP clock. Must cover
+// at least one update tick (~16 ms) plus scheduling jitter.
+static const int kBeatScheduleLookaheadMs = 50;
+
+// Packed spatial layout: position, velocity, forward and up vectors
+// (matches FMOD_3D_ATTRIBUTES).
+static const int kSpatialFloatsPerEntity = 12;
+
+FmodBridge::FmodBridge()
+    : studio_system_(nullptr),
+      core_system_(nullptr),
+      next_emitter_id_(1),
+      listener_count_(1),
+      emitter_culling_(false),
+      next_beat_schedule_id_(1),
+      running_(false) {}
 
 FmodBridge::~FmodBridge() {
   Release();
 }
 
-bool FmodBridge::Initialize() {
+bool FmodBridge::Initialize(int output_mode, const std::string& wav_path) {
   FMOD_RESULT result;
 
   // Create FMOD Studio System
@@ -30,17 +46,23 @@ bool FmodBridge::Initialize() {
     return false;
   }
 
-  // Set output type to auto-detect
-  result = FMOD_System_SetOutput(core_system_, FMOD_OUTPUTTYPE_AUTODETECT);
-  if (result != FMOD_OK) {
-    std::cerr << "FmodBridge: Warning - failed to set output type: "
-              << result << " - " << FMOD_ErrorString(result) << std::endl;
+  // Auto-detect the device unless a headless or offline output was asked for
+  if (!offline_output_.Configure(core_system_, output_mode,
+                                 wav_path.c_str())) {
+    result = offline_output_.last_result();
+    std::cerr << "FmodBridge: Failed to set output type " << output_mode
+              << ": " << result << " - " << FMOD_ErrorString(result)
+              << std::endl;
+    if (output_mode != FMOD_FLUTTER_OUTPUT_DEVICE) {
+      return false;
+    }
   }
 
   // Initialize FMOD Studio System
-  result = FMOD_Studio_System_Initialize(studio_system_, 512,
-                                         FMOD_STUDIO_INIT_NORMAL,
-                                         FMOD_INIT_NORMAL, nullptr);
+  result = FMOD_Studio_System_Initialize(
+      studio_system_, FMOD_FLUTTER_MAX_CHANNELS,
+      offline_output_.studio_init_flags(),
+      offline_output_.core_init_flags(), offline_output_.extra_driver_data());
   if (result != FMOD_OK) {
     std::cerr << "FmodBridge: Failed to initialize FMOD Studio System: "
               << result << " - " << FMOD_ErrorString(result) << std::endl;
@@ -57,8 +79,10 @@ bool FmodBridge::Initialize() {
   std::cout << "FmodBridge: FMOD initialized successfully (Windows)" << std::endl;
 
   // Start background update thread (~60fps), matching iOS behavior
-  running_ = true;
-  update_thread_ = std::thread(&FmodBridge::UpdateLoop, this);
+  if (!offline_output_.non_realtime()) {
+    running_ = true;
+    update_thread_ = std::thread(&FmodBridge::UpdateLoop, this);
+  }
 
   return true;
 }
@@ -79,6 +103,12 @@ bool FmodBridge::LoadBank(const std::string& path) {
     return false;
   }
 
+  {
+    std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+    mixer_control_.CacheBanks(studio_system_);
+    global_parameters_.CacheBanks(studio_system_);
+  }
+
   std::cout << "FmodBridge: Loaded bank: " << path << std::endl;
   return true;
 }
@@ -89,19 +119,53 @@ bool FmodBridge::PlayEvent(const std::string& event_path) {
     return false;
   }
 
-  FMOD_RESULT result;
-
-  // Get the event description
-  FMOD_STUDIO_EVENTDESCRIPTION* event_description = nullptr;
-  result = FMOD_Studio_System_GetEvent(studio_system_, event_path.c_str(),
-                                       &event_description);
-  if (result != FMOD_OK) {
-    std::cerr << "FmodBridge: Failed to get event " << event_path << ": "
-              << result << " - " << FMOD_ErrorString(result) << std::endl;
+  if (!StartEvent(event_path, 0)) {
     return false;
   }
 
-  // Check if an instance is already playing for this event
+  std::cout << "FmodBridge: Started playing event: " << event_path << std::endl;
+  return true;
+}
+
+unsigned long long FmodBridge::PlayEventAt(const std::string& event_path,
+                                           unsigned long long dsp_clock_offset,
+                                           unsigned long long from_dsp_clock) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  unsigned long long base = from_dsp_clock;
+  if (base == 0) {
+    int sample_rate = 0;
+    if (!GetMixerClock(&base, &sample_rate)) {
+      std::cerr << "FmodBridge: Failed to read mixer DSP clock" << std::endl;
+      return 0;
+    }
+  }
+
+  unsigned long long start_clock = base + dsp_clock_offset;
+  if (!StartEvent(event_path, start_clock)) {
+    return 0;
+  }
+
+  std::cout << "FmodBridge: Started playing event: " << event_path
+            << " at dsp clock " << start_clock << std::endl;
+  return start_clock;
+}
+
+bool FmodBridge::GetDspClock(unsigned long long* dsp_clock, int* sample_rate) {
+  return GetMixerClock(dsp_clock, sample_rate);
+}
+
+bool FmodBridge::StartEvent(const std::string& event_path,
+                            unsigned long long start_clock) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  FMOD_RESULT result;
+
+  // Check if an instance is already playing for this event. A restart stops
+  // it and goes through the same acquire, flush, delay and start steps as a
+  // fresh start, so a scheduled restart delays a channel group that exists.
   auto it = event_instances_.find(event_path);
   if (it != event_instances_.end()) {
     FMOD_STUDIO_PLAYBACK_STATE state;
@@ -112,48 +176,70 @@ bool FmodBridge::PlayEvent(const std::string& event_path) {
       std::cout << "FmodBridge: Restarting already playing event: "
                 << event_path << std::endl;
       FMOD_Studio_EventInstance_Stop(it->second, FMOD_STUDIO_STOP_IMMEDIATE);
-      FMOD_Studio_EventInstance_Start(it->second);
-      return true;
-    } else {
-      FMOD_Studio_EventInstance_Release(it->second);
-      event_instances_.erase(it);
     }
+    RecycleInstance(event_path, it->second);
+    event_instances_.erase(it);
   }
 
-  // Create an instance of the event
-  FMOD_STUDIO_EVENTINSTANCE* event_instance = nullptr;
-  result = FMOD_Studio_EventDescription_CreateInstance(event_description,
-                                                       &event_instance);
-  if (result != FMOD_OK) {
+  // Take an idle instance from the event's pool, or create one
+  FMOD_STUDIO_EVENTINSTANCE* event_instance =
+      instance_pool_.Acquire(studio_system_, event_path.c_str());
+  if (event_instance == nullptr) {
+    result = instance_pool_.last_result();
     std::cerr << "FmodBridge: Failed to create event instance for "
               << event_path << ": " << result << " - "
               << FMOD_ErrorString(result) << std::endl;
     return false;
   }
 
+  FMOD_Studio_EventInstance_SetUserData(event_instance, this);
+  FMOD_Studio_EventInstance_SetCallback(
+      event_instance, &FmodBridge::BeatCallback,
+      FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_BEAT |
+          FMOD_STUDIO_EVENT_CALLBACK_DESTROYED |
+          FMOD_FLUTTER_VOICE_STATS_CALLBACKS);
+
+  if (start_clock != 0) {
+    // The channel group only exists once the create command has been
+    // processed, so flush before delaying it.
+    FMOD_CHANNELGROUP* group = nullptr;
+    FMOD_Studio_System_FlushCommands(studio_system_);
+    result = FMOD_Studio_EventInstance_GetChannelGroup(event_instance, &group);
+    if (result == FMOD_OK) {
+      FMOD_ChannelGroup_SetDelay(group, start_clock, 0, 0);
+    } else {
+      std::cerr << "FmodBridge: Failed to get channel group for " << event_path
+                << ", starting immediately: " << result << " - "
+                << FMOD_ErrorString(result) << std::endl;
+    }
+  }
+
   // Start the event
   result = FMOD_Studio_EventInstance_Start(event_instance);
   if (result != FMOD_OK) {
     std::cerr << "FmodBridge: Failed to start event " << event_path << ": "
               << result << " - " << FMOD_ErrorString(result) << std::endl;
-    FMOD_Studio_EventInstance_Release(event_instance);
+    instance_pool_.Recycle(event_path.c_str(), event_instance);
     return false;
   }
 
   // Store the instance for later control
   event_instances_[event_path] = event_instance;
-  std::cout << "FmodBridge: Started playing event: " << event_path << std::endl;
-
+  instance_sweeper_.Watch(event_path.c_str(), event_instance);
   return true;
 }
 
 bool FmodBridge::StopEvent(const std::string& event_path) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
   auto it = event_instances_.find(event_path);
   if (it == event_instances_.end()) {
     std::cerr << "FmodBridge: No instance found for " << event_path << std::endl;
     return false;
   }
 
+  // Writes from earlier in this tick still apply to the fade-out; the
+  // instance is recycled below, which drops anything still queued.
+  deferred_writes_.FlushInstance(it->second);
   FMOD_RESULT result = FMOD_Studio_EventInstance_Stop(
       it->second, FMOD_STUDIO_STOP_ALLOWFADEOUT);
 
@@ -163,7 +249,7 @@ bool FmodBridge::StopEvent(const std::string& event_path) {
     return false;
   }
 
-  FMOD_Studio_EventInstance_Release(it->second);
+  RecycleInstance(event_path, it->second);
   event_instances_.erase(it);
 
   std::cout << "FmodBridge: Stopped event: " << event_path << std::endl;
@@ -172,16 +258,16 @@ bool FmodBridge::StopEvent(const std::string& event_path) {
 
 bool FmodBridge::SetParameter(const std::string& event_path,
                               const std::string& param_name, float value) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
   auto it = event_instances_.find(event_path);
   if (it == event_instances_.end()) {
     std::cerr << "FmodBridge: No instance found for " << event_path << std::endl;
     return false;
   }
 
-  FMOD_RESULT result = FMOD_Studio_EventInstance_SetParameterByName(
-      it->second, param_name.c_str(), value, false);
-
-  if (result != FMOD_OK) {
+  parameter_automation_.CancelParameter(it->second, param_name.c_str());
+  if (!deferred_writes_.SetParameter(it->second, param_name.c_str(), value)) {
+    FMOD_RESULT result = deferred_writes_.last_result();
     std::cerr << "FmodBridge: Failed to set parameter " << param_name
               << " on " << event_path << ": " << result << " - "
               << FMOD_ErrorString(result) << std::endl;
@@ -192,6 +278,7 @@ bool FmodBridge::SetParameter(const std::string& event_path,
 }
 
 bool FmodBridge::SetPaused(const std::string& event_path, bool paused) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
   auto it = event_instances_.find(event_path);
   if (it == event_instances_.end()) {
     std::cerr << "FmodBridge: No instance found for " << event_path << std::endl;
@@ -211,15 +298,15 @@ bool FmodBridge::SetPaused(const std::string& event_path, bool paused) {
 }
 
 bool FmodBridge::SetVolume(const std::string& event_path, float volume) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
   auto it = event_instances_.find(event_path);
   if (it == event_instances_.end()) {
     std::cerr << "FmodBridge: No instance found for " << event_path << std::endl;
     return false;
   }
 
-  FMOD_RESULT result = FMOD_Studio_EventInstance_SetVolume(it->second, volume);
-
-  if (result != FMOD_OK) {
+  if (!deferred_writes_.SetVolume(it->second, volume)) {
+    FMOD_RESULT result = deferred_writes_.last_result();
     std::cerr << "FmodBridge: Failed to set volume on " << event_path << ": "
               << result << " - " << FMOD_ErrorString(result) << std::endl;
     return false;
@@ -228,70 +315,1208 @@ bool FmodBridge::SetVolume(const std::string& event_path, float volume) {
   return true;
 }
 
+bool FmodBridge::SetPitch(const std::string& event_path, float pitch) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  auto it = event_instances_.find(event_path);
+  if (it == event_instances_.end()) {
+    std::cerr << "FmodBridge: No instance found for " << event_path << std::endl;
+    return false;
+  }
+
+  if (!deferred_writes_.SetPitch(it->second, pitch)) {
+    FMOD_RESULT result = deferred_writes_.last_result();
+    std::cerr << "FmodBridge: Failed to set pitch on " << event_path << ": "
+              << result << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
 bool FmodBridge::SetMasterPaused(bool paused) {
   if (studio_system_ == nullptr) {
     std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
     return false;
   }
 
-  FMOD_STUDIO_BUS* master_bus = nullptr;
-  FMOD_RESULT result = FMOD_Studio_System_GetBus(studio_system_, "bus:/",
-                                                  &master_bus);
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.SetBusPaused(studio_system_, "bus:/", paused)) {
+    LogMixerError("set paused state of", "bus:/");
+    return false;
+  }
+
+  std::cout << "FmodBridge: Master bus paused = "
+            << (paused ? "YES" : "NO") << std::endl;
+  return true;
+}
+
+bool FmodBridge::SetBusVolume(const std::string& bus_path, float volume,
+                              int ramp_ms) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.SetBusVolume(studio_system_, bus_path.c_str(), volume,
+                                   ramp_ms / 1000.0f)) {
+    LogMixerError("set volume of", bus_path);
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::SetVcaVolume(const std::string& vca_path, float volume,
+                              int ramp_ms) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.SetVcaVolume(studio_system_, vca_path.c_str(), volume,
+                                   ramp_ms / 1000.0f)) {
+    LogMixerError("set volume of", vca_path);
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::SetBusMute(const std::string& bus_path, bool mute) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.SetBusMute(studio_system_, bus_path.c_str(), mute)) {
+    LogMixerError("set mute state of", bus_path);
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::SetBusPaused(const std::string& bus_path, bool paused) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.SetBusPaused(studio_system_, bus_path.c_str(), paused)) {
+    LogMixerError("set paused state of", bus_path);
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::StartSnapshot(const std::string& snapshot_path) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.StartSnapshot(studio_system_, snapshot_path.c_str())) {
+    LogMixerError("start snapshot", snapshot_path);
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::StopSnapshot(const std::string& snapshot_path,
+                              bool allow_fadeout) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mixer_control_.StopSnapshot(snapshot_path.c_str(), allow_fadeout)) {
+    std::cerr << "FmodBridge: Snapshot not active: " << snapshot_path
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int FmodBridge::AutomateParameter(const std::string& event_path,
+                                  const std::string& param_name, int type,
+                                  const float* data, int data_count) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  auto it = event_instances_.find(event_path);
+  if (it == event_instances_.end()) {
+    std::cerr << "FmodBridge: No instance found for " << event_path << std::endl;
+    return 0;
+  }
 
-  if (result != FMOD_OK || master_bus == nullptr) {
-    std::cerr << "FmodBridge: Failed to get master bus: "
+  // The curve starts from the parameter's latest value.
+  deferred_writes_.Flush();
+  int automation_id = parameter_automation_.Add(
+      it->second, param_name.c_str(), type, data, data_count);
+  if (automation_id == 0) {
+    FMOD_RESULT result = parameter_automation_.last_result();
+    std::cerr << "FmodBridge: Failed to automate parameter " << param_name
+              << " on " << event_path << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+  }
+  return automation_id;
+}
+
+bool FmodBridge::ReleaseAutomation(int automation_id) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!parameter_automation_.Release(automation_id)) {
+    std::cerr << "FmodBridge: No envelope automation found with id "
+              << automation_id << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::CancelAutomation(int automation_id) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  return parameter_automation_.Cancel(automation_id);
+}
+
+bool FmodBridge::ConfigureInstancePool(const std::string& event_path,
+                                       int prewarm_count, int capacity) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!instance_pool_.Configure(studio_system_, event_path.c_str(),
+                                prewarm_count, capacity)) {
+    FMOD_RESULT result = instance_pool_.last_result();
+    std::cerr << "FmodBridge: Failed to configure instance pool for "
+              << event_path << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::GetInstancePoolStats(const std::string& event_path,
+                                      FmodInstancePoolStats* stats) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  return instance_pool_.GetStats(
+      event_path.empty() ? nullptr : event_path.c_str(), stats);
+}
+
+// Returns a stopped (or stopping) instance to its event's pool. Curves,
+// queued writes and beat tracking are dropped so a reused instance starts
+// clean.
+void FmodBridge::RecycleInstance(const std::string& event_path,
+                                 FMOD_STUDIO_EVENTINSTANCE* instance) {
+  parameter_automation_.CancelInstance(instance);
+  deferred_writes_.Forget(instance);
+  instance_sweeper_.Forget(instance);
+  {
+    std::lock_guard<std::mutex> lock(beat_mutex_);
+    beat_states_.erase(instance);
+  }
+  instance_pool_.Recycle(event_path.c_str(), instance);
+}
+
+bool FmodBridge::SetGlobalParameter(const std::string& name, float value) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!global_parameters_.Set(studio_system_, name.c_str(), value)) {
+    FMOD_RESULT result = global_parameters_.last_result();
+    std::cerr << "FmodBridge: Failed to set global parameter " << name << ": "
               << result << " - " << FMOD_ErrorString(result) << std::endl;
     return false;
   }
+  return true;
+}
 
-  result = FMOD_Studio_Bus_SetPaused(master_bus, paused ? 1 : 0);
+bool FmodBridge::GetGlobalParameter(const std::string& name, float* value) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
 
-  if (result != FMOD_OK) {
-    std::cerr << "FmodBridge: Failed to set master paused state: "
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!global_parameters_.Get(studio_system_, name.c_str(), value)) {
+    FMOD_RESULT result = global_parameters_.last_result();
+    std::cerr << "FmodBridge: Failed to get global parameter " << name << ": "
               << result << " - " << FMOD_ErrorString(result) << std::endl;
     return false;
   }
+  return true;
+}
 
-  std::cout << "FmodBridge: Master bus paused = "
-            << (paused ? "YES" : "NO") << std::endl;
+std::vector<int32_t> FmodBridge::ResolveGlobalParameters(
+    const std::vector<std::string>& names) {
+  std::vector<int32_t> slots(names.size(), -1);
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return slots;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  for (size_t i = 0; i < names.size(); i++) {
+    slots[i] = global_parameters_.Resolve(studio_system_, names[i].c_str());
+    if (slots[i] < 0) {
+      std::cerr << "FmodBridge: No global parameter named " << names[i]
+                << std::endl;
+    }
+  }
+  return slots;
+}
+
+bool FmodBridge::SetGlobalParameters(const int32_t* slots, const float* values,
+                                     int count) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!global_parameters_.SetBatch(studio_system_, slots, values, count)) {
+    FMOD_RESULT result = global_parameters_.last_result();
+    std::cerr << "FmodBridge: Failed to set global parameters: " << result
+              << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
   return true;
 }
 
-void FmodBridge::Update() {
-  if (studio_system_ != nullptr) {
-    FMOD_Studio_System_Update(studio_system_);
+void FmodBridge::LogMixerError(const char* action, const std::string& path) {
+  FMOD_RESULT result = mixer_control_.last_result();
+  std::cerr << "FmodBridge: Failed to " << action << " " << path << ": "
+            << result << " - " << FMOD_ErrorString(result) << std::endl;
+}
+
+int FmodBridge::CreateEmitter(const std::string& event_path, bool start) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  FMOD_STUDIO_EVENTDESCRIPTION* event_description = nullptr;
+  FMOD_RESULT result =
+      GetEvent(studio_system_, event_path.c_str(), &event_description);
+  if (result != FMOD_OK) {
+    std::cerr << "FmodBridge: Failed to get event " << event_path << ": "
+              << result << " - " << FMOD_ErrorString(result) << std::endl;
+    return 0;
+  }
+
+  float min_distance = 0.0f;
+  float max_distance = 0.0f;
+  FMOD_BOOL is_3d = 0;
+  FMOD_Studio_EventDescription_Is3D(event_description, &is_3d);
+  if (is_3d) {
+    FMOD_Studio_EventDescription_GetMinMaxDistance(
+        event_description, &min_distance, &max_distance);
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  int emitter_id = next_emitter_id_;
+  Emitter emitter = {event_description, nullptr, {}, max_distance, start};
+  emitter.attributes.forward.z = 1.0f;
+  emitter.attributes.up.y = 1.0f;
+
+  if (emitter_culling_ && start) {
+    // Started on the next update tick if a listener is in range.
+    emitter_culler_.Add(emitter_id, max_distance, false);
+  } else {
+    result = FMOD_Studio_EventDescription_CreateInstance(event_description,
+                                                         &emitter.instance);
+    if (result != FMOD_OK) {
+      std::cerr << "FmodBridge: Failed to create emitter instance for "
+                << event_path << ": " << result << " - "
+                << FMOD_ErrorString(result) << std::endl;
+      return 0;
+    }
+
+    if (start) {
+      result = FMOD_Studio_EventInstance_Start(emitter.instance);
+      if (result != FMOD_OK) {
+        std::cerr << "FmodBridge: Failed to start emitter " << event_path
+                  << ": " << result << " - " << FMOD_ErrorString(result)
+                  << std::endl;
+        FMOD_Studio_EventInstance_Release(emitter.instance);
+        return 0;
+      }
+    }
   }
+
+  next_emitter_id_++;
+  emitters_[emitter_id] = emitter;
+  return emitter_id;
 }
 
-void FmodBridge::Release() {
-  // Stop the update thread
-  running_ = false;
-  if (update_thread_.joinable()) {
-    update_thread_.join();
+bool FmodBridge::ReleaseEmitter(int emitter_id) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  auto it = emitters_.find(emitter_id);
+  if (it == emitters_.end()) {
+    std::cerr << "FmodBridge: No emitter found with id " << emitter_id
+              << std::endl;
+    return false;
   }
 
-  // Stop and release all event instances
-  for (auto& pair : event_instances_) {
-    FMOD_Studio_EventInstance_Stop(pair.second, FMOD_STUDIO_STOP_IMMEDIATE);
-    FMOD_Studio_EventInstance_Release(pair.second);
+  DeactivateEmitter(&it->second);
+  emitter_culler_.Remove(emitter_id);
+  emitters_.erase(it);
+  return true;
+}
+
+bool FmodBridge::UpdateSpatial(const float* listeners, int listener_count,
+                               const int32_t* emitter_ids,
+                               const float* emitters, int emitter_count) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
   }
-  event_instances_.clear();
 
-  // Release FMOD Studio system
-  if (studio_system_ != nullptr) {
-    FMOD_Studio_System_Release(studio_system_);
-    studio_system_ = nullptr;
-    core_system_ = nullptr;
+  if (listener_count < 1 || listener_count > FMOD_MAX_LISTENERS) {
+    std::cerr << "FmodBridge: Invalid listener count " << listener_count
+              << std::endl;
+    return false;
   }
 
-  std::cout << "FmodBridge: Released FMOD resources" << std::endl;
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+
+  if (listener_count != listener_count_) {
+    FMOD_Studio_System_SetNumListeners(studio_system_, listener_count);
+    listener_count_ = listener_count;
+  }
+
+  FMOD_3D_ATTRIBUTES attributes;
+  listener_positions_.resize(listener_count * 3);
+  for (int i = 0; i < listener_count; i++) {
+    std::memcpy(&attributes, listeners + i * kSpatialFloatsPerEntity,
+                sizeof(attributes));
+    FMOD_Studio_System_SetListenerAttributes(studio_system_, i, &attributes,
+                                             nullptr);
+    listener_positions_[i * 3] = attributes.position.x;
+    listener_positions_[i * 3 + 1] = attributes.position.y;
+    listener_positions_[i * 3 + 2] = attributes.position.z;
+  }
+
+  for (int i = 0; i < emitter_count; i++) {
+    auto it = emitters_.find(emitter_ids[i]);
+    if (it == emitters_.end()) {
+      continue;
+    }
+    Emitter& emitter = it->second;
+    std::memcpy(&emitter.attributes, emitters + i * kSpatialFloatsPerEntity,
+                sizeof(emitter.attributes));
+    if (emitter_culling_ && emitter.playing) {
+      emitter_culler_.Move(it->first, emitter.attributes.position.x,
+                           emitter.attributes.position.y,
+                           emitter.attributes.position.z);
+    }
+    if (emitter.instance != nullptr) {
+      FMOD_Studio_EventInstance_Set3DAttributes(emitter.instance,
+                                                &emitter.attributes);
+    }
+  }
+
+  return true;
 }
 
-void FmodBridge::UpdateLoop() {
-  while (running_) {
-    if (studio_system_ != nullptr) {
-      FMOD_Studio_System_Update(studio_system_);
+void FmodBridge::SetEmitterCulling(bool enabled, float hysteresis) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  emitter_culler_.SetHysteresis(hysteresis);
+  if (emitter_culling_ == enabled) {
+    return;
+  }
+  emitter_culling_ = enabled;
+
+  for (auto& pair : emitters_) {
+    Emitter& emitter = pair.second;
+    if (!emitter.playing) {
+      continue;
+    }
+    if (enabled) {
+      emitter_culler_.Add(pair.first, emitter.max_distance,
+                          emitter.instance != nullptr);
+      emitter_culler_.Move(pair.first, emitter.attributes.position.x,
+                           emitter.attributes.position.y,
+                           emitter.attributes.position.z);
+    } else {
+      // Bring back everything that was culled.
+      ActivateEmitter(pair.first, &emitter);
     }
+  }
+  if (!enabled) {
+    emitter_culler_.Clear();
+  }
+
+  std::cout << "FmodBridge: Emitter culling "
+            << (enabled ? "enabled" : "disabled") << std::endl;
+}
+
+bool FmodBridge::ActivateEmitter(int emitter_id, Emitter* emitter) {
+  if (emitter->instance != nullptr) {
+    return true;
+  }
+
+  FMOD_RESULT result = FMOD_Studio_EventDescription_CreateInstance(
+      emitter->description, &emitter->instance);
+  if (result != FMOD_OK) {
+    std::cerr << "FmodBridge: Failed to create instance for emitter "
+              << emitter_id << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    emitter->instance = nullptr;
+    return false;
+  }
+
+  FMOD_Studio_EventInstance_Set3DAttributes(emitter->instance,
+                                            &emitter->attributes);
+  FMOD_Studio_EventInstance_Start(emitter->instance);
+  return true;
+}
+
+void FmodBridge::DeactivateEmitter(Emitter* emitter) {
+  if (emitter->instance == nullptr) {
+    return;
+  }
+  FMOD_Studio_EventInstance_Stop(emitter->instance,
+                                 FMOD_STUDIO_STOP_ALLOWFADEOUT);
+  FMOD_Studio_EventInstance_Release(emitter->instance);
+  emitter->instance = nullptr;
+}
+
+void FmodBridge::ProcessEmitterCulling() {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!emitter_culling_ || emitters_.empty()) {
+    return;
+  }
+
+  emitter_culler_.Evaluate(listener_positions_.data(),
+                           static_cast<int>(listener_positions_.size() / 3));
+
+  for (int emitter_id : emitter_culler_.deactivated()) {
+    auto it = emitters_.find(emitter_id);
+    if (it != emitters_.end()) {
+      DeactivateEmitter(&it->second);
+    }
+  }
+
+  for (int emitter_id : emitter_culler_.activated()) {
+    auto it = emitters_.find(emitter_id);
+    if (it != emitters_.end()) {
+      ActivateEmitter(emitter_id, &it->second);
+    }
+  }
+}
+
+int FmodBridge::AddBusEffect(const std::string& bus_path, int type,
+                             const int32_t* parameter_indices,
+                             const float* parameter_values, int count) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  int effect_id = bus_effects_.Add(studio_system_, bus_path.c_str(), type,
+                                   parameter_indices, parameter_values, count);
+  if (effect_id == 0) {
+    FMOD_RESULT result = bus_effects_.last_result();
+    std::cerr << "FmodBridge: Failed to add effect to bus " << bus_path << ": "
+              << result << " - " << FMOD_ErrorString(result) << std::endl;
+    return 0;
+  }
+
+  std::cout << "FmodBridge: Added effect " << effect_id << " to bus "
+            << bus_path << " (" << BusEffects::KernelName() << " kernels)"
+            << std::endl;
+  return effect_id;
+}
+
+bool FmodBridge::RemoveBusEffect(int effect_id) {
+  if (!bus_effects_.Remove(effect_id)) {
+    std::cerr << "FmodBridge: No bus effect found with id " << effect_id
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::SetBusEffectParameter(int effect_id, int index, float value) {
+  if (!bus_effects_.SetParameter(effect_id, index, value)) {
+    FMOD_RESULT result = bus_effects_.last_result();
+    std::cerr << "FmodBridge: Failed to set parameter " << index
+              << " on bus effect " << effect_id << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int FmodBridge::AddSpectrumAnalyzer(const std::string& target, int band_count,
+                                    int window_size) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  int analyzer_id = 0;
+  if (target.rfind("bus:/", 0) == 0) {
+    analyzer_id = spectrum_analyzers_.AddToBus(studio_system_, target.c_str(),
+                                               band_count, window_size);
+  } else {
+    auto it = event_instances_.find(target);
+    if (it == event_instances_.end()) {
+      std::cerr << "FmodBridge: No instance found for " << target
+                << std::endl;
+      return 0;
+    }
+    analyzer_id = spectrum_analyzers_.AddToInstance(
+        studio_system_, it->second, band_count, window_size);
+  }
+
+  if (analyzer_id == 0) {
+    FMOD_RESULT result = spectrum_analyzers_.last_result();
+    std::cerr << "FmodBridge: Failed to add spectrum analyzer to " << target
+              << ": " << result << " - " << FMOD_ErrorString(result)
+              << std::endl;
+  }
+  return analyzer_id;
+}
+
+bool FmodBridge::RemoveSpectrumAnalyzer(int analyzer_id) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!spectrum_analyzers_.Remove(analyzer_id)) {
+    std::cerr << "FmodBridge: No spectrum analyzer found with id "
+              << analyzer_id << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int FmodBridge::ScheduleAtBeat(const std::string& event_path, int bar,
+                               int beat, const std::string& start_event_path) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(beat_mutex_);
+  BeatSchedule schedule = {next_beat_schedule_id_++, event_path, bar, beat,
+                           start_event_path};
+  beat_schedules_.push_back(schedule);
+
+  std::cout << "FmodBridge: Scheduled beat " << bar << "." << beat << " on "
+            << event_path << " (id " << schedule.id << ")" << std::endl;
+  return schedule.id;
+}
+
+bool FmodBridge::CancelBeatSchedule(int schedule_id) {
+  std::lock_guard<std::mutex> lock(beat_mutex_);
+  for (auto it = beat_schedules_.begin(); it != beat_schedules_.end(); ++it) {
+    if (it->id == schedule_id) {
+      beat_schedules_.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<FiredBeatSchedule> FmodBridge::DrainFiredBeatSchedules() {
+  std::lock_guard<std::mutex> lock(beat_mutex_);
+  std::vector<FiredBeatSchedule> fired;
+  fired.swap(fired_beat_schedules_);
+  return fired;
+}
+
+std::vector<std::string> FmodBridge::DrainFinishedEvents() {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  std::vector<std::string> finished;
+  finished.swap(finished_events_);
+  return finished;
+}
+
+void FmodBridge::SetNotificationCallback(std::function<void()> callback) {
+  notification_callback_ = std::move(callback);
+}
+
+// static
+FMOD_RESULT F_CALL FmodBridge::BeatCallback(
+    FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event,
+    void* parameters) {
+  // Replaces the voice statistics description callback on this instance.
+  if ((type & FMOD_FLUTTER_VOICE_STATS_CALLBACKS) != 0) {
+    return VoiceStats::EventCallback(type, event, parameters);
+  }
+
+  void* user_data = nullptr;
+  FMOD_Studio_EventInstance_GetUserData(event, &user_data);
+  FmodBridge* bridge = static_cast<FmodBridge*>(user_data);
+  if (bridge == nullptr) {
+    return FMOD_OK;
+  }
+
+  std::lock_guard<std::mutex> lock(bridge->beat_mutex_);
+
+  if (type == FMOD_STUDIO_EVENT_CALLBACK_DESTROYED) {
+    bridge->beat_states_.erase(event);
+    return FMOD_OK;
+  }
+
+  const auto* props =
+      static_cast<const FMOD_STUDIO_TIMELINE_BEAT_PROPERTIES*>(parameters);
+  BeatState& state = bridge->beat_states_[event];
+  state.bar = props->bar;
+  state.beat = props->beat;
+  state.beats_per_bar = props->timesignatureupper;
+  state.tempo = props->tempo;
+  state.position = props->position;
+  state.anchored = false;
+  state.anchor_clock = 0;
+  return FMOD_OK;
+}
+
+bool FmodBridge::GetMixerClock(unsigned long long* clock, int* sample_rate) {
+  if (core_system_ == nullptr) {
+    return false;
+  }
+
+  FMOD_CHANNELGROUP* master_group = nullptr;
+  if (FMOD_System_GetMasterChannelGroup(core_system_, &master_group) !=
+          FMOD_OK ||
+      FMOD_ChannelGroup_GetDSPClock(master_group, clock, nullptr) != FMOD_OK) {
+    return false;
+  }
+
+  return FMOD_System_GetSoftwareFormat(core_system_, sample_rate, nullptr,
+                                       nullptr) == FMOD_OK;
+}
+
+void FmodBridge::ProcessBeatSchedules() {
+  std::lock_guard<std::recursive_mutex> instances_lock(instances_mutex_);
+  std::vector<BeatSchedule> armed;
+  std::vector<unsigned long long> armed_clocks;
+
+  {
+    std::lock_guard<std::mutex> lock(beat_mutex_);
+    if (beat_schedules_.empty()) {
+      return;
+    }
+
+    unsigned long long now = 0;
+    int sample_rate = 0;
+    if (!GetMixerClock(&now, &sample_rate) || sample_rate <= 0) {
+      return;
+    }
+
+    const long long lookahead =
+        static_cast<long long>(sample_rate) * kBeatScheduleLookaheadMs / 1000;
+
+    for (auto it = beat_schedules_.begin(); it != beat_schedules_.end();) {
+      auto instance_it = event_instances_.find(it->event_path);
+      if (instance_it == event_instances_.end()) {
+        ++it;
+        continue;
+      }
+
+      auto state_it = beat_states_.find(instance_it->second);
+      if (state_it == beat_states_.end() || state_it->second.tempo <= 0.0f) {
+        ++it;
+        continue;
+      }
+
+      BeatState& state = state_it->second;
+      if (!state.anchored) {
+        // Place the beat on the DSP clock by how far the timeline has moved
+        // past it since the callback fired
+        int timeline_position = state.position;
+        FMOD_Studio_EventInstance_GetTimelinePosition(instance_it->second,
+                                                      &timeline_position);
+        long long since_beat =
+            static_cast<long long>(timeline_position - state.position) *
+            sample_rate / 1000;
+        state.anchor_clock = now - (since_beat > 0 ? since_beat : 0);
+        state.anchored = true;
+      }
+
+      // A beat already behind now lands on now and fires at once.
+      unsigned long long target = BeatTargetClock(
+          state.anchor_clock, state.bar, state.beat, state.beats_per_bar,
+          state.tempo, sample_rate, it->bar, it->beat, now);
+      if (target - now > static_cast<unsigned long long>(lookahead)) {
+        ++it;
+        continue;
+      }
+
+      fired_beat_schedules_.push_back({it->id, it->bar, it->beat, target});
+      armed.push_back(*it);
+      armed_clocks.push_back(target);
+      it = beat_schedules_.erase(it);
+    }
+  }
+
+  // Started outside beat_mutex_: flushing waits on the Studio thread, which
+  // takes beat_mutex_ when delivering callbacks
+  for (size_t i = 0; i < armed.size(); i++) {
+    if (!armed[i].start_event_path.empty()) {
+      StartEvent(armed[i].start_event_path, armed_clocks[i]);
+    }
+  }
+
+  if (!armed.empty() && notification_callback_) {
+    notification_callback_();
+  }
+}
+
+void FmodBridge::Update() {
+  if (studio_system_ != nullptr) {
+    {
+      std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+      deferred_writes_.Flush();
+    }
+    FMOD_Studio_System_Update(studio_system_);
+    ProcessBeatSchedules();
+    ProcessEmitterCulling();
+
+    std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+    // Ramps and curves follow the wall clock here; renders advance them by
+    // the audio they mix instead, in OnRenderBlock.
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    float elapsed = 0.0f;
+    if (last_update_ != std::chrono::steady_clock::time_point() &&
+        !offline_output_.non_realtime()) {
+      elapsed = std::chrono::duration<float>(now - last_update_).count();
+    }
+    last_update_ = now;
+    mixer_control_.Update(elapsed);
+    parameter_automation_.Update(elapsed);
+    spectrum_analyzers_.Update();
+    mic_capture_.Update();
+    voice_stats_.Update();
+    SweepFinishedInstances();
+    RefreshInstanceStates();
+  }
+}
+
+void FmodBridge::SweepFinishedInstances() {
+  if (instance_sweeper_.Sweep(FMOD_FLUTTER_INSTANCE_SWEEP_BUDGET) == 0) {
+    return;
+  }
+  bool notify = false;
+  for (const auto& finished : instance_sweeper_.finished()) {
+    // Dart may have played the event again since; only the tracked
+    // instance is reclaimed.
+    auto it = event_instances_.find(finished.key);
+    if (it == event_instances_.end() || it->second != finished.instance) {
+      continue;
+    }
+    RecycleInstance(finished.key, finished.instance);
+    event_instances_.erase(it);
+    finished_events_.push_back(finished.key);
+    notify = true;
+  }
+  if (notify && notification_callback_) {
+    notification_callback_();
+  }
+}
+
+void FmodBridge::RefreshInstanceStates() {
+  instance_states_.Begin();
+  for (const auto& pair : event_instances_) {
+    instance_states_.Add(pair.first.c_str(), pair.second);
+  }
+  for (const auto& pair : emitters_) {
+    if (pair.second.instance != nullptr) {
+      instance_states_.AddEmitter(pair.first, pair.second.instance);
+    }
+  }
+}
+
+void FmodBridge::Release() {
+  // Stop the update thread
+  running_ = false;
+  if (update_thread_.joinable()) {
+    update_thread_.join();
+  }
+
+  // Stop and release all event instances
+  {
+    std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+    for (auto& pair : event_instances_) {
+      FMOD_Studio_EventInstance_Stop(pair.second, FMOD_STUDIO_STOP_IMMEDIATE);
+      FMOD_Studio_EventInstance_Release(pair.second);
+    }
+    event_instances_.clear();
+    instance_sweeper_.Clear();
+    finished_events_.clear();
+
+    for (auto& pair : emitters_) {
+      if (pair.second.instance != nullptr) {
+        FMOD_Studio_EventInstance_Stop(pair.second.instance,
+                                       FMOD_STUDIO_STOP_IMMEDIATE);
+        FMOD_Studio_EventInstance_Release(pair.second.instance);
+      }
+    }
+    emitters_.clear();
+    emitter_culler_.Clear();
+    listener_positions_.clear();
+    listener_count_ = 1;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(beat_mutex_);
+    beat_schedules_.clear();
+    fired_beat_schedules_.clear();
+  }
+
+  bus_effects_.Clear();
+  sound_library_.Clear();
+  pcm_streams_.Clear();
+  {
+    std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+    spectrum_analyzers_.Clear();
+    mic_capture_.Clear();
+    voice_stats_.Clear();
+    instance_states_.Clear();
+    deferred_writes_.Clear();
+    mixer_control_.Clear();
+    parameter_automation_.Clear();
+    global_parameters_.Clear();
+    instance_pool_.Clear();
+    last_update_ = std::chrono::steady_clock::time_point();
+  }
+
+  // Release FMOD Studio system
+  if (studio_system_ != nullptr) {
+    mixer_lifecycle_.Resume(core_system_, studio_system_,
+                            FMOD_FLUTTER_SUSPEND_ALL);
+    mixer_lifecycle_.Clear();
+    FMOD_Studio_System_Release(studio_system_);
+    studio_system_ = nullptr;
+    core_system_ = nullptr;
+    offline_output_.Clear();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(beat_mutex_);
+    beat_states_.clear();
+  }
+
+  std::cout << "FmodBridge: Released FMOD resources" << std::endl;
+}
+
+bool FmodBridge::SuspendMixer() {
+  if (core_system_ == nullptr) {
+    return false;
+  }
+  if (mixer_lifecycle_.suspended()) {
+    return true;
+  }
+
+  // Nothing to update while suspended
+  running_ = false;
+  if (update_thread_.joinable()) {
+    update_thread_.join();
+  }
+
+  if (!mixer_lifecycle_.Suspend(core_system_, FMOD_FLUTTER_SUSPEND_LIFECYCLE)) {
+    FMOD_RESULT result = mixer_lifecycle_.last_result();
+    std::cerr << "FmodBridge: Failed to suspend mixer: " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    if (!offline_output_.non_realtime()) {
+      running_ = true;
+      update_thread_ = std::thread(&FmodBridge::UpdateLoop, this);
+    }
+    return false;
+  }
+  std::cout << "FmodBridge: Mixer suspended" << std::endl;
+  return true;
+}
+
+bool FmodBridge::ResumeMixer() {
+  if (core_system_ == nullptr) {
+    return false;
+  }
+  if (!mixer_lifecycle_.suspended()) {
+    return true;
+  }
+
+  if (!mixer_lifecycle_.Resume(core_system_, studio_system_,
+                               FMOD_FLUTTER_SUSPEND_LIFECYCLE)) {
+    FMOD_RESULT result = mixer_lifecycle_.last_result();
+    std::cerr << "FmodBridge: Failed to resume mixer: " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  if (!offline_output_.non_realtime()) {
+    running_ = true;
+    update_thread_ = std::thread(&FmodBridge::UpdateLoop, this);
+  }
+  std::cout << "FmodBridge: Mixer resumed in "
+            << mixer_lifecycle_.last_resume_ms() << " ms" << std::endl;
+  return true;
+}
+
+double FmodBridge::LastMixerResumeMs() const {
+  return mixer_lifecycle_.last_resume_ms();
+}
+
+bool FmodBridge::Render(float seconds, double* rendered_seconds,
+                        double* render_ms) {
+  if (studio_system_ == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  deferred_writes_.Flush();
+  if (!offline_output_.Render(studio_system_, core_system_, seconds,
+                              &FmodBridge::OnRenderBlock, this)) {
+    FMOD_RESULT result = offline_output_.last_result();
+    std::cerr << "FmodBridge: Failed to render " << seconds << " s: "
+              << result << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  *rendered_seconds = offline_output_.last_rendered_seconds();
+  *render_ms = offline_output_.last_render_ms();
+  return true;
+}
+
+bool FmodBridge::TakeRenderedAudio(std::vector<float>* samples,
+                                   int* sample_rate, int* channels) {
+  if (offline_output_.mode() != FMOD_FLUTTER_OUTPUT_MEMORY_NRT) {
+    return false;
+  }
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  *samples = offline_output_.captured();
+  *sample_rate = offline_output_.sample_rate();
+  *channels = offline_output_.channels();
+  offline_output_.ClearCaptured();
+  return true;
+}
+
+int FmodBridge::LoadSound(const std::string& path, bool stream) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  int sound_id = sound_library_.Load(studio_system_, path.c_str(), stream);
+  if (sound_id == 0) {
+    FMOD_RESULT result = sound_library_.last_result();
+    std::cerr << "FmodBridge: Failed to load sound " << path << ": " << result
+              << " - " << FMOD_ErrorString(result) << std::endl;
+    return 0;
+  }
+
+  std::cout << "FmodBridge: Loaded sound " << sound_id << " from " << path
+            << " (" << SoundLibrary::KernelName() << " .fca kernels)"
+            << std::endl;
+  return sound_id;
+}
+
+bool FmodBridge::PlayLoadedSound(int sound_id, float volume) {
+  if (!sound_library_.Play(sound_id, volume)) {
+    FMOD_RESULT result = sound_library_.last_result();
+    std::cerr << "FmodBridge: Failed to play sound " << sound_id << ": "
+              << result << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::UnloadSound(int sound_id) {
+  if (!sound_library_.Unload(sound_id)) {
+    std::cerr << "FmodBridge: No sound found with id " << sound_id
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int FmodBridge::LoadPcmSound(int32_t buffer_id, int sample_rate,
+                             int channels, int format) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  PcmFormat pcm_format = {sample_rate, channels, format};
+  int sound_id = sound_library_.LoadPcm(studio_system_, buffer_id, pcm_format);
+  if (sound_id == 0) {
+    FMOD_RESULT result = sound_library_.last_result();
+    std::cerr << "FmodBridge: Failed to create sound from PCM buffer "
+              << buffer_id << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    return 0;
+  }
+  return sound_id;
+}
+
+bool FmodBridge::PlayEventWithPcm(const std::string& event_path,
+                                  int32_t buffer_id, int sample_rate,
+                                  int channels, int format) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  PcmFormat pcm_format = {sample_rate, channels, format};
+  FMOD_RESULT result = StartProgrammerSoundEvent(
+      studio_system_, event_path.c_str(), buffer_id, pcm_format);
+  if (result != FMOD_OK) {
+    std::cerr << "FmodBridge: Failed to play " << event_path
+              << " with PCM buffer " << buffer_id << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int FmodBridge::CreatePcmStream(int sample_rate, int channels,
+                                int capacity_ms) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return 0;
+  }
+
+  int stream_id = pcm_streams_.Create(studio_system_, sample_rate, channels,
+                                      capacity_ms);
+  if (stream_id == 0) {
+    FMOD_RESULT result = pcm_streams_.last_result();
+    std::cerr << "FmodBridge: Failed to create PCM stream: " << result
+              << " - " << FMOD_ErrorString(result) << std::endl;
+    return 0;
+  }
+
+  std::cout << "FmodBridge: Created PCM stream " << stream_id << " ("
+            << sample_rate << " Hz, " << channels << " channels)"
+            << std::endl;
+  return stream_id;
+}
+
+bool FmodBridge::ReleasePcmStream(int stream_id) {
+  if (!pcm_streams_.Destroy(stream_id)) {
+    std::cerr << "FmodBridge: No PCM stream found with id " << stream_id
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool FmodBridge::GetPcmStreamStats(int stream_id,
+                                   FmodPcmStreamStats* stats) {
+  return pcm_streams_.GetStats(stream_id, stats);
+}
+
+bool FmodBridge::StartRecording(int driver, bool monitor, int latency_ms) {
+  if (core_system_ == nullptr) {
+    std::cerr << "FmodBridge: Core system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!mic_capture_.Start(core_system_, driver, monitor, latency_ms)) {
+    FMOD_RESULT result = mic_capture_.last_result();
+    std::cerr << "FmodBridge: Failed to start recording from driver "
+              << driver << ": " << result << " - "
+              << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+
+  std::cout << "FmodBridge: Recording from driver " << driver
+            << (monitor ? " with monitoring" : "") << std::endl;
+  return true;
+}
+
+bool FmodBridge::StopRecording() {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  return mic_capture_.Stop();
+}
+
+bool FmodBridge::GetRecordingStats(FmodMicStats* stats) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  return mic_capture_.GetStats(stats);
+}
+
+bool FmodBridge::StartVoiceStats(int window_ms) {
+  if (studio_system_ == nullptr) {
+    std::cerr << "FmodBridge: Studio system not initialized" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  if (!voice_stats_.Start(studio_system_, window_ms)) {
+    FMOD_RESULT result = voice_stats_.last_result();
+    std::cerr << "FmodBridge: Failed to start voice stats: " << result
+              << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void FmodBridge::StopVoiceStats() {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  voice_stats_.Stop();
+}
+
+void FmodBridge::GetVoiceStats(std::vector<FmodVoiceStatsWindow>* windows,
+                               std::vector<VoiceStats::EventStats>* events) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  windows->resize(FMOD_FLUTTER_VOICE_STATS_WINDOWS);
+  windows->resize(voice_stats_.GetWindows(windows->data(),
+                                          FMOD_FLUTTER_VOICE_STATS_WINDOWS));
+  *events = voice_stats_.last_events();
+}
+
+void FmodBridge::QueryInstances(std::vector<FmodInstanceState>* states,
+                                std::vector<std::string>* keys) {
+  std::lock_guard<std::recursive_mutex> lock(instances_mutex_);
+  int count = instance_states_.count();
+  states->assign(instance_states_.states(), instance_states_.states() + count);
+  keys->clear();
+  for (int i = 0; i < count; i++) {
+    keys->push_back(instance_states_.key(i));
+  }
+}
+
+bool FmodBridge::StartCommandCapture(const std::string& filename,
+                                     bool flush_each_command) {
+  if (studio_system_ == nullptr) {
+    return false;
+  }
+  FMOD_RESULT result = FMOD_Studio_System_StartCommandCapture(
+      studio_system_, filename.c_str(),
+      flush_each_command ? FMOD_STUDIO_COMMANDCAPTURE_FILEFLUSH
+                         : FMOD_STUDIO_COMMANDCAPTURE_NORMAL);
+  if (result != FMOD_OK) {
+    std::cerr << "FmodBridge: Failed to start command capture: " << result
+              << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  std::cout << "FmodBridge: Capturing commands to " << filename << std::endl;
+  return true;
+}
+
+bool FmodBridge::StopCommandCapture() {
+  if (studio_system_ == nullptr) {
+    return false;
+  }
+  FMOD_RESULT result = FMOD_Studio_System_StopCommandCapture(studio_system_);
+  if (result != FMOD_OK) {
+    std::cerr << "FmodBridge: Failed to stop command capture: " << result
+              << " - " << FMOD_ErrorString(result) << std::endl;
+    return false;
+  }
+  std::cout << "FmodBridge: Command capture stopped" << std::endl;
+  return true;
+}
+
+void FmodBridge::OnRenderBlock(void* context, float block_seconds) {
+  // Render() runs under instances_mutex_.
+  FmodBridge* bridge = static_cast<FmodBridge*>(context);
+  bridge->mixer_control_.Update(block_seconds);
+  bridge->parameter_automation_.Update(block_seconds);
+}
+
+void FmodBridge::UpdateLoop() {
+  while (running_) {
+    Update();
     std::this_thread::sleep_for(std::chrono::milliseconds(16));
   }
 }
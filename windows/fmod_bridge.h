@@ -3,39 +3,324 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <functional>
+#include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
 
 #include <fmod_studio.h>
 #include <fmod.h>
 #include <fmod_errors.h>
 
+#include "beat_clock.h"
+#include "deferred_writes.h"
+#include "dsp_effects.h"
+#include "emitter_culler.h"
+#include "event_lookup.h"
+#include "global_parameters.h"
+#include "instance_pool.h"
+#include "instance_states.h"
+#include "instance_sweeper.h"
+#include "mic_capture.h"
+#include "mixer_control.h"
+#include "mixer_lifecycle.h"
+#include "offline_output.h"
+#include "parameter_automation.h"
+#include "pcm_stream.h"
+#include "sound_library.h"
+#include "spectrum_analyzer.h"
+#include "voice_stats.h"
+
 namespace fmod_flutter {
 
+// A beat schedule that has been armed on the mixer DSP clock.
+struct FiredBeatSchedule {
+  int id;
+  int bar;
+  int beat;
+  unsigned long long dsp_clock;
+};
+
 class FmodBridge {
  public:
   FmodBridge();
   ~FmodBridge();
 
-  bool Initialize();
+  // output_mode is one of FMOD_FLUTTER_OUTPUT_*; wav_path is the file
+  // written in WAVWRITER_NRT mode. Non-realtime modes run no update thread;
+  // the mix advances only in Render() and Update().
+  bool Initialize(int output_mode, const std::string& wav_path);
   bool LoadBank(const std::string& path);
+  // Event methods take an event path or an ID key (see event_lookup.h).
   bool PlayEvent(const std::string& event_path);
+  // Starts event_path on mixer DSP clock from_dsp_clock + dsp_clock_offset
+  // (from_dsp_clock 0 means now). Returns the start clock, or 0 on failure.
+  unsigned long long PlayEventAt(const std::string& event_path,
+                                 unsigned long long dsp_clock_offset,
+                                 unsigned long long from_dsp_clock);
+  bool GetDspClock(unsigned long long* dsp_clock, int* sample_rate);
   bool StopEvent(const std::string& event_path);
   bool SetParameter(const std::string& event_path, const std::string& param_name, float value);
   bool SetPaused(const std::string& event_path, bool paused);
   bool SetVolume(const std::string& event_path, float volume);
+  bool SetPitch(const std::string& event_path, float pitch);
   bool SetMasterPaused(bool paused);
+
+  // Bus, VCA and snapshot control through handles cached at bank load.
+  // Volumes ramp linearly over ramp_ms on the update thread (0 = at once).
+  bool SetBusVolume(const std::string& bus_path, float volume, int ramp_ms);
+  bool SetVcaVolume(const std::string& vca_path, float volume, int ramp_ms);
+  bool SetBusMute(const std::string& bus_path, bool mute);
+  bool SetBusPaused(const std::string& bus_path, bool paused);
+  bool StartSnapshot(const std::string& snapshot_path);
+  bool StopSnapshot(const std::string& snapshot_path, bool allow_fadeout);
+
+  // Schedules work on a timeline beat (1-based bar/beat) of a playing event.
+  // If start_event_path is non-empty that event is started on the beat using
+  // the DSP clock. Returns the schedule id, or 0 on failure.
+  int ScheduleAtBeat(const std::string& event_path, int bar, int beat,
+                     const std::string& start_event_path);
+  bool CancelBeatSchedule(int schedule_id);
+  std::vector<FiredBeatSchedule> DrainFiredBeatSchedules();
+  // Events whose instance finished on its own and was reclaimed by the
+  // update thread since the last call.
+  std::vector<std::string> DrainFinishedEvents();
+
+  // Creates a dedicated instance of event_path driven by UpdateSpatial.
+  // Returns the emitter id, or 0 on failure.
+  int CreateEmitter(const std::string& event_path, bool start);
+  bool ReleaseEmitter(int emitter_id);
+  // Applies packed 3D attributes (12 floats per entity: position, velocity,
+  // forward, up) for all listeners and emitters in one pass.
+  bool UpdateSpatial(const float* listeners, int listener_count,
+                     const int32_t* emitter_ids, const float* emitters,
+                     int emitter_count);
+  // When enabled, emitters only hold an event instance while a listener is
+  // within the event's max distance; hysteresis is a fraction of that
+  // distance an emitter may drift past before its instance is released.
+  void SetEmitterCulling(bool enabled, float hysteresis);
+
+  // Appends a built-in DSP effect (FMOD_FLUTTER_DSP_*) to a bus, applying
+  // count (index, value) parameter pairs first. Returns the effect id, or 0
+  // on failure.
+  int AddBusEffect(const std::string& bus_path, int type,
+                   const int32_t* parameter_indices,
+                   const float* parameter_values, int count);
+  bool RemoveBusEffect(int effect_id);
+  bool SetBusEffectParameter(int effect_id, int index, float value);
+
+  // Attaches an FFT analyzer to a bus ("bus:/...") or to the playing
+  // instance of an event path. Frames are published on the update thread
+  // for Dart to read through FFI. Returns the analyzer id, or 0 on failure.
+  int AddSpectrumAnalyzer(const std::string& target, int band_count,
+                          int window_size);
+  bool RemoveSpectrumAnalyzer(int analyzer_id);
+
+  // Drives a parameter of an event's instance with a curve evaluated on the
+  // update thread; see parameter_automation.h for types and data layouts.
+  // Returns the automation id, or 0 on failure.
+  int AutomateParameter(const std::string& event_path,
+                        const std::string& param_name, int type,
+                        const float* data, int data_count);
+  bool ReleaseAutomation(int automation_id);
+  bool CancelAutomation(int automation_id);
+
+  // Keeps up to capacity stopped instances of an event for reuse by
+  // PlayEvent, creating prewarm_count of them now. A capacity of 0 removes
+  // the pool.
+  bool ConfigureInstancePool(const std::string& event_path, int prewarm_count,
+                             int capacity);
+  // Statistics for one event's pool, or all pools when event_path is empty.
+  bool GetInstancePoolStats(const std::string& event_path,
+                            FmodInstancePoolStats* stats);
+
+  // Global parameters. IDs are resolved at bank load; Dart resolves names
+  // to slots once and then sets many globals per frame in one call.
+  bool SetGlobalParameter(const std::string& name, float value);
+  bool GetGlobalParameter(const std::string& name, float* value);
+  std::vector<int32_t> ResolveGlobalParameters(
+      const std::vector<std::string>& names);
+  bool SetGlobalParameters(const int32_t* slots, const float* values,
+                           int count);
+
+  // Stops the update thread and suspends the mixer, e.g. while the window
+  // is minimized, and brings both back. Call from the platform thread.
+  bool SuspendMixer();
+  bool ResumeMixer();
+  // Duration of the last resume in milliseconds, negative if none.
+  double LastMixerResumeMs() const;
+
+  // Mixes seconds of audio faster than realtime in a non-realtime output
+  // mode, reporting the audio mixed and the time it took.
+  bool Render(float seconds, double* rendered_seconds, double* render_ms);
+  // Moves out the mix captured in MEMORY_NRT mode, interleaved.
+  bool TakeRenderedAudio(std::vector<float>* samples, int* sample_rate,
+                         int* channels);
+
+  // Loose sounds outside Studio banks, including the compact .fca format.
+  // LoadSound returns a sound id, or 0 on failure.
+  int LoadSound(const std::string& path, bool stream);
+  bool PlayLoadedSound(int sound_id, float volume);
+  bool UnloadSound(int sound_id);
+  // Sounds over PCM that Dart wrote into a pcm_sounds.h buffer, without a
+  // copy. LoadPcmSound adds one to the loose sounds above; PlayEventWithPcm
+  // starts a one-shot event whose programmer instruments play the buffer.
+  int LoadPcmSound(int32_t buffer_id, int sample_rate, int channels,
+                   int format);
+  bool PlayEventWithPcm(const std::string& event_path, int32_t buffer_id,
+                        int sample_rate, int channels, int format);
+
+  // Streams that Dart pushes float PCM into through dart:ffi. Create
+  // returns a stream id, or 0 on failure.
+  int CreatePcmStream(int sample_rate, int channels, int capacity_ms);
+  bool ReleasePcmStream(int stream_id);
+  bool GetPcmStreamStats(int stream_id, FmodPcmStreamStats* stats);
+
+  // Records from record driver `driver`, optionally monitoring the input
+  // latency_ms behind. Dart drains the audio through dart:ffi.
+  bool StartRecording(int driver, bool monitor, int latency_ms);
+  bool StopRecording();
+  bool GetRecordingStats(FmodMicStats* stats);
+
+  // Voice and virtualization statistics aggregated over windows of
+  // window_ms. GetVoiceStats returns the complete windows, oldest first,
+  // and the events of the newest one.
+  bool StartVoiceStats(int window_ms);
+  void StopVoiceStats();
+  void GetVoiceStats(std::vector<FmodVoiceStatsWindow>* windows,
+                     std::vector<VoiceStats::EventStats>* events);
+
+  // Every live event and emitter instance as of the last update tick, with
+  // the event key of each.
+  void QueryInstances(std::vector<FmodInstanceState>* states,
+                      std::vector<std::string>* keys);
+
+  // Records every Studio API call to a file that the command_replay tool
+  // can play back. flush_each_command keeps the file complete if the app
+  // crashes, at the cost of a write per command.
+  bool StartCommandCapture(const std::string& filename,
+                           bool flush_each_command);
+  bool StopCommandCapture();
+
+  // Invoked from the update thread when there are notifications to drain.
+  void SetNotificationCallback(std::function<void()> callback);
+
   void Update();
   void Release();
 
  private:
+  // Latest timeline beat reported by FMOD for an event instance.
+  struct BeatState {
+    int bar;
+    int beat;
+    int beats_per_bar;
+    float tempo;
+    int position;
+    bool anchored;
+    unsigned long long anchor_clock;
+  };
+
+  struct Emitter {
+    FMOD_STUDIO_EVENTDESCRIPTION* description;
+    // nullptr while the emitter is culled.
+    FMOD_STUDIO_EVENTINSTANCE* instance;
+    FMOD_3D_ATTRIBUTES attributes;
+    // From the event description; 0 for 2D events, which are never culled.
+    float max_distance;
+    // Started by the caller; only playing emitters are culled.
+    bool playing;
+  };
+
+  struct BeatSchedule {
+    int id;
+    std::string event_path;
+    int bar;
+    int beat;
+    std::string start_event_path;
+  };
+
+  static FMOD_RESULT F_CALL BeatCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type,
+                                         FMOD_STUDIO_EVENTINSTANCE* event,
+                                         void* parameters);
+
+  bool StartEvent(const std::string& event_path,
+                  unsigned long long start_clock);
+  bool GetMixerClock(unsigned long long* clock, int* sample_rate);
+  void ProcessBeatSchedules();
+  void ProcessEmitterCulling();
+  void RecycleInstance(const std::string& event_path,
+                       FMOD_STUDIO_EVENTINSTANCE* instance);
+  void LogMixerError(const char* action, const std::string& path);
+  bool ActivateEmitter(int emitter_id, Emitter* emitter);
+  void DeactivateEmitter(Emitter* emitter);
+  void SweepFinishedInstances();
+  void RefreshInstanceStates();
   void UpdateLoop();
+  // Advances automation and ramps after each block Render() mixes.
+  static void OnRenderBlock(void* context, float block_seconds);
 
   FMOD_STUDIO_SYSTEM* studio_system_;
   FMOD_SYSTEM* core_system_;
   std::unordered_map<std::string, FMOD_STUDIO_EVENTINSTANCE*> event_instances_;
+  // Guards event_instances_, which the update thread also reads.
+  std::recursive_mutex instances_mutex_;
+
+  std::unordered_map<int, Emitter> emitters_;
+  int next_emitter_id_;
+  int listener_count_;
+  // Listener positions (xyz per listener) from the last UpdateSpatial.
+  std::vector<float> listener_positions_;
+  EmitterCuller emitter_culler_;
+  bool emitter_culling_;
+
+  // Guarded by instances_mutex_; the update thread advances its ramps.
+  MixerControl mixer_control_;
+  // Guarded by instances_mutex_.
+  GlobalParameters global_parameters_;
+  // Guarded by instances_mutex_.
+  InstancePool instance_pool_;
+  // Guarded by instances_mutex_; the update thread applies its curves.
+  ParameterAutomation parameter_automation_;
+  BusEffects bus_effects_;
+  // Guarded by instances_mutex_; the update thread publishes its frames.
+  SpectrumAnalyzers spectrum_analyzers_;
+  // Used from the platform thread only.
+  MixerLifecycle mixer_lifecycle_;
+  // Used from the platform thread only; in its non-realtime modes there is
+  // no update thread.
+  OfflineOutput offline_output_;
+  // Used from the platform thread only.
+  SoundLibrary sound_library_;
+  // Used from the platform thread only; writes come straight from Dart.
+  PcmStreams pcm_streams_;
+  // Guarded by instances_mutex_; the update thread taps the recording.
+  MicCapture mic_capture_;
+  // Guarded by instances_mutex_; the update thread samples the voices.
+  VoiceStats voice_stats_;
+  // Guarded by instances_mutex_; the update thread flushes it before each
+  // Studio update.
+  DeferredWrites deferred_writes_;
+  // Guarded by instances_mutex_; the update thread refreshes it every tick.
+  InstanceStates instance_states_;
+  // Guarded by instances_mutex_, as is finished_events_; the update thread
+  // sweeps it every tick.
+  InstanceSweeper instance_sweeper_;
+  std::vector<std::string> finished_events_;
+
+  // Written by FMOD's Studio thread from BeatCallback.
+  std::mutex beat_mutex_;
+  std::unordered_map<FMOD_STUDIO_EVENTINSTANCE*, BeatState> beat_states_;
+  std::vector<BeatSchedule> beat_schedules_;
+  std::vector<FiredBeatSchedule> fired_beat_schedules_;
+  int next_beat_schedule_id_;
+
+  std::function<void()> notification_callback_;
   std::thread update_thread_;
   std::atomic<bool> running_;
+  // When Update() last ran; unset before the first.
+  std::chrono::steady_clock::time_point last_update_;
 };
 
 }  // namespace fmod_flutter
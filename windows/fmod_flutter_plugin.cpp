@@ -8,11 +8,16 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <variant>
 
 namespace fmod_flutter {
 
+// Posted to the top-level window by the bridge's update thread so that
+// notifications are delivered to Dart on the platform thread.
+static const UINT kNotifyMessage = WM_APP + 0x464D;
+
 // Returns the directory containing the running executable.
 static std::filesystem::path GetExecutableDir() {
   wchar_t path_buf[MAX_PATH];
@@ -34,6 +39,33 @@ static std::string ResolveAssetPath(const std::string& asset_path) {
   return asset_path;
 }
 
+// Reads an integer argument, which the standard codec encodes as either
+// int32 or int64 depending on its magnitude.
+static bool GetInt64(const flutter::EncodableValue& value, int64_t* out) {
+  if (std::holds_alternative<int32_t>(value) ||
+      std::holds_alternative<int64_t>(value)) {
+    *out = value.LongValue();
+    return true;
+  }
+  return false;
+}
+
+// Reads the event an event method targets: a path, or an event ID sent as
+// the 16 bytes of an FMOD_GUID, which becomes its ID key.
+static bool GetEventKey(const flutter::EncodableValue& value,
+                        std::string* out) {
+  if (const auto *path = std::get_if<std::string>(&value)) {
+    *out = *path;
+    return true;
+  }
+  const auto *id = std::get_if<std::vector<uint8_t>>(&value);
+  if (id && id->size() == 16) {
+    *out = EventIdKey(id->data());
+    return true;
+  }
+  return false;
+}
+
 // static
 void FmodFlutterPlugin::RegisterWithRegistrar(
     flutter::PluginRegistrarWindows *registrar) {
@@ -42,9 +74,10 @@ void FmodFlutterPlugin::RegisterWithRegistrar(
           registrar->messenger(), "fmod_flutter",
           &flutter::StandardMethodCodec::GetInstance());
 
-  auto plugin = std::make_unique<FmodFlutterPlugin>();
+  auto *channel_pointer = channel.get();
+  auto plugin = std::make_unique<FmodFlutterPlugin>(registrar, std::move(channel));
 
-  channel->SetMethodCallHandler(
+  channel_pointer->SetMethodCallHandler(
       [plugin_pointer = plugin.get()](const auto &call, auto result) {
         plugin_pointer->HandleMethodCall(call, std::move(result));
       });
@@ -52,10 +85,70 @@ void FmodFlutterPlugin::RegisterWithRegistrar(
   registrar->AddPlugin(std::move(plugin));
 }
 
-FmodFlutterPlugin::FmodFlutterPlugin()
-    : fmod_bridge_(std::make_unique<FmodBridge>()) {}
+FmodFlutterPlugin::FmodFlutterPlugin(
+    flutter::PluginRegistrarWindows *registrar,
+    std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel)
+    : registrar_(registrar),
+      channel_(std::move(channel)),
+      fmod_bridge_(std::make_unique<FmodBridge>()) {
+  window_proc_id_ = registrar_->RegisterTopLevelWindowProcDelegate(
+      [this](HWND hwnd, UINT message, WPARAM wparam,
+             LPARAM lparam) -> std::optional<LRESULT> {
+        if (message == kNotifyMessage) {
+          DeliverNotifications();
+          return 0;
+        }
+        // Suspend the mixer while minimized; other handlers still see the
+        // message.
+        if (message == WM_SIZE) {
+          if (wparam == SIZE_MINIMIZED) {
+            fmod_bridge_->SuspendMixer();
+          } else if (wparam == SIZE_RESTORED || wparam == SIZE_MAXIMIZED) {
+            fmod_bridge_->ResumeMixer();
+          }
+        }
+        return std::nullopt;
+      });
 
-FmodFlutterPlugin::~FmodFlutterPlugin() {}
+  fmod_bridge_->SetNotificationCallback([this]() {
+    flutter::FlutterView *view = registrar_->GetView();
+    if (view != nullptr) {
+      PostMessage(GetAncestor(view->GetNativeWindow(), GA_ROOT),
+                  kNotifyMessage, 0, 0);
+    }
+  });
+}
+
+FmodFlutterPlugin::~FmodFlutterPlugin() {
+  fmod_bridge_->Release();
+  registrar_->UnregisterTopLevelWindowProcDelegate(window_proc_id_);
+}
+
+void FmodFlutterPlugin::DeliverNotifications() {
+  for (const auto &fired : fmod_bridge_->DrainFiredBeatSchedules()) {
+    channel_->InvokeMethod(
+        "onBeatScheduleFired",
+        std::make_unique<flutter::EncodableValue>(flutter::EncodableMap{
+            {flutter::EncodableValue("id"), flutter::EncodableValue(fired.id)},
+            {flutter::EncodableValue("bar"), flutter::EncodableValue(fired.bar)},
+            {flutter::EncodableValue("beat"),
+             flutter::EncodableValue(fired.beat)},
+            {flutter::EncodableValue("dspClock"),
+             flutter::EncodableValue(static_cast<int64_t>(fired.dsp_clock))},
+        }));
+  }
+
+  std::vector<std::string> finished = fmod_bridge_->DrainFinishedEvents();
+  if (!finished.empty()) {
+    flutter::EncodableList paths;
+    for (const auto &path : finished) {
+      paths.push_back(flutter::EncodableValue(path));
+    }
+    channel_->InvokeMethod(
+        "onEventsFinished",
+        std::make_unique<flutter::EncodableValue>(std::move(paths)));
+  }
+}
 
 void FmodFlutterPlugin::HandleMethodCall(
     const flutter::MethodCall<flutter::EncodableValue> &method_call,
@@ -63,7 +156,27 @@ void FmodFlutterPlugin::HandleMethodCall(
   const auto &method_name = method_call.method_name();
 
   if (method_name == "initialize") {
-    bool success = fmod_bridge_->Initialize();
+    // Output mode and WAV path are optional; the default is the device.
+    int output_mode = FMOD_FLUTTER_OUTPUT_DEVICE;
+    std::string wav_path;
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto output_it = args->find(flutter::EncodableValue("output"));
+      if (output_it != args->end()) {
+        const auto *value = std::get_if<int32_t>(&output_it->second);
+        if (value) {
+          output_mode = *value;
+        }
+      }
+      auto wav_it = args->find(flutter::EncodableValue("wavPath"));
+      if (wav_it != args->end()) {
+        const auto *value = std::get_if<std::string>(&wav_it->second);
+        if (value) {
+          wav_path = std::filesystem::absolute(*value).string();
+        }
+      }
+    }
+    bool success = fmod_bridge_->Initialize(output_mode, wav_path);
     result->Success(flutter::EncodableValue(success));
 
   } else if (method_name == "loadBanks") {
@@ -95,9 +208,9 @@ void FmodFlutterPlugin::HandleMethodCall(
     if (args) {
       auto it = args->find(flutter::EncodableValue("path"));
       if (it != args->end()) {
-        const auto *path = std::get_if<std::string>(&it->second);
-        if (path) {
-          fmod_bridge_->PlayEvent(*path);
+        std::string path;
+        if (GetEventKey(it->second, &path)) {
+          fmod_bridge_->PlayEvent(path);
           result->Success();
           return;
         }
@@ -105,14 +218,54 @@ void FmodFlutterPlugin::HandleMethodCall(
     }
     result->Error("INVALID_ARGS", "Event path required");
 
+  } else if (method_name == "playEventAt") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto offset_it = args->find(flutter::EncodableValue("offset"));
+      auto from_it = args->find(flutter::EncodableValue("fromDspClock"));
+      if (path_it != args->end() && offset_it != args->end()) {
+        std::string path;
+        int64_t offset = 0;
+        int64_t from = 0;
+        if (from_it != args->end()) {
+          GetInt64(from_it->second, &from);
+        }
+        if (GetEventKey(path_it->second, &path) &&
+            GetInt64(offset_it->second, &offset)) {
+          unsigned long long start_clock = fmod_bridge_->PlayEventAt(
+              path, static_cast<unsigned long long>(offset > 0 ? offset : 0),
+              static_cast<unsigned long long>(from));
+          result->Success(
+              flutter::EncodableValue(static_cast<int64_t>(start_clock)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path and offset required");
+
+  } else if (method_name == "getDspClock") {
+    unsigned long long dsp_clock = 0;
+    int sample_rate = 0;
+    if (fmod_bridge_->GetDspClock(&dsp_clock, &sample_rate)) {
+      result->Success(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("dspClock"),
+           flutter::EncodableValue(static_cast<int64_t>(dsp_clock))},
+          {flutter::EncodableValue("sampleRate"),
+           flutter::EncodableValue(sample_rate)},
+      }));
+    } else {
+      result->Success();
+    }
+
   } else if (method_name == "stopEvent") {
     const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
     if (args) {
       auto it = args->find(flutter::EncodableValue("path"));
       if (it != args->end()) {
-        const auto *path = std::get_if<std::string>(&it->second);
-        if (path) {
-          fmod_bridge_->StopEvent(*path);
+        std::string path;
+        if (GetEventKey(it->second, &path)) {
+          fmod_bridge_->StopEvent(path);
           result->Success();
           return;
         }
@@ -128,11 +281,11 @@ void FmodFlutterPlugin::HandleMethodCall(
       auto value_it = args->find(flutter::EncodableValue("value"));
       if (path_it != args->end() && param_it != args->end() &&
           value_it != args->end()) {
-        const auto *path = std::get_if<std::string>(&path_it->second);
+        std::string path;
         const auto *param = std::get_if<std::string>(&param_it->second);
         const auto *value = std::get_if<double>(&value_it->second);
-        if (path && param && value) {
-          fmod_bridge_->SetParameter(*path, *param, static_cast<float>(*value));
+        if (GetEventKey(path_it->second, &path) && param && value) {
+          fmod_bridge_->SetParameter(path, *param, static_cast<float>(*value));
           result->Success();
           return;
         }
@@ -146,10 +299,10 @@ void FmodFlutterPlugin::HandleMethodCall(
       auto path_it = args->find(flutter::EncodableValue("path"));
       auto paused_it = args->find(flutter::EncodableValue("paused"));
       if (path_it != args->end() && paused_it != args->end()) {
-        const auto *path = std::get_if<std::string>(&path_it->second);
+        std::string path;
         const auto *paused = std::get_if<bool>(&paused_it->second);
-        if (path && paused) {
-          fmod_bridge_->SetPaused(*path, *paused);
+        if (GetEventKey(path_it->second, &path) && paused) {
+          fmod_bridge_->SetPaused(path, *paused);
           result->Success();
           return;
         }
@@ -163,10 +316,10 @@ void FmodFlutterPlugin::HandleMethodCall(
       auto path_it = args->find(flutter::EncodableValue("path"));
       auto volume_it = args->find(flutter::EncodableValue("volume"));
       if (path_it != args->end() && volume_it != args->end()) {
-        const auto *path = std::get_if<std::string>(&path_it->second);
+        std::string path;
         const auto *volume = std::get_if<double>(&volume_it->second);
-        if (path && volume) {
-          fmod_bridge_->SetVolume(*path, static_cast<float>(*volume));
+        if (GetEventKey(path_it->second, &path) && volume) {
+          fmod_bridge_->SetVolume(path, static_cast<float>(*volume));
           result->Success();
           return;
         }
@@ -174,6 +327,23 @@ void FmodFlutterPlugin::HandleMethodCall(
     }
     result->Error("INVALID_ARGS", "Path and volume required");
 
+  } else if (method_name == "setPitch") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto pitch_it = args->find(flutter::EncodableValue("pitch"));
+      if (path_it != args->end() && pitch_it != args->end()) {
+        std::string path;
+        const auto *pitch = std::get_if<double>(&pitch_it->second);
+        if (GetEventKey(path_it->second, &path) && pitch) {
+          fmod_bridge_->SetPitch(path, static_cast<float>(*pitch));
+          result->Success();
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path and pitch required");
+
   } else if (method_name == "setMasterPaused") {
     const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
     if (args) {
@@ -189,6 +359,896 @@ void FmodFlutterPlugin::HandleMethodCall(
     }
     result->Error("INVALID_ARGS", "Paused state required");
 
+  } else if (method_name == "setBusVolume") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto volume_it = args->find(flutter::EncodableValue("volume"));
+      auto ramp_it = args->find(flutter::EncodableValue("rampMs"));
+      if (path_it != args->end() && volume_it != args->end() &&
+          ramp_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *volume = std::get_if<double>(&volume_it->second);
+        const auto *ramp_ms = std::get_if<int32_t>(&ramp_it->second);
+        if (path && volume && ramp_ms) {
+          result->Success(flutter::EncodableValue(fmod_bridge_->SetBusVolume(
+              *path, static_cast<float>(*volume), *ramp_ms)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path, volume, and ramp required");
+
+  } else if (method_name == "setVcaVolume") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto volume_it = args->find(flutter::EncodableValue("volume"));
+      auto ramp_it = args->find(flutter::EncodableValue("rampMs"));
+      if (path_it != args->end() && volume_it != args->end() &&
+          ramp_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *volume = std::get_if<double>(&volume_it->second);
+        const auto *ramp_ms = std::get_if<int32_t>(&ramp_it->second);
+        if (path && volume && ramp_ms) {
+          result->Success(flutter::EncodableValue(fmod_bridge_->SetVcaVolume(
+              *path, static_cast<float>(*volume), *ramp_ms)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path, volume, and ramp required");
+
+  } else if (method_name == "setBusMute") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto muted_it = args->find(flutter::EncodableValue("muted"));
+      if (path_it != args->end() && muted_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *muted = std::get_if<bool>(&muted_it->second);
+        if (path && muted) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->SetBusMute(*path, *muted)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path and muted state required");
+
+  } else if (method_name == "setBusPaused") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto paused_it = args->find(flutter::EncodableValue("paused"));
+      if (path_it != args->end() && paused_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *paused = std::get_if<bool>(&paused_it->second);
+        if (path && paused) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->SetBusPaused(*path, *paused)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path and paused state required");
+
+  } else if (method_name == "startSnapshot") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      if (path_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        if (path) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->StartSnapshot(*path)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Snapshot path required");
+
+  } else if (method_name == "stopSnapshot") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto fadeout_it = args->find(flutter::EncodableValue("allowFadeOut"));
+      if (path_it != args->end() && fadeout_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *allow_fadeout = std::get_if<bool>(&fadeout_it->second);
+        if (path && allow_fadeout) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->StopSnapshot(*path, *allow_fadeout)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Snapshot path and fade out flag required");
+
+  } else if (method_name == "suspendMixer") {
+    result->Success(flutter::EncodableValue(fmod_bridge_->SuspendMixer()));
+
+  } else if (method_name == "resumeMixer") {
+    result->Success(flutter::EncodableValue(fmod_bridge_->ResumeMixer()));
+
+  } else if (method_name == "getMixerResumeLatency") {
+    double latency_ms = fmod_bridge_->LastMixerResumeMs();
+    if (latency_ms >= 0.0) {
+      result->Success(flutter::EncodableValue(latency_ms));
+    } else {
+      result->Success();
+    }
+
+  } else if (method_name == "renderOffline") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto seconds_it = args->find(flutter::EncodableValue("seconds"));
+      if (seconds_it != args->end()) {
+        const auto *seconds = std::get_if<double>(&seconds_it->second);
+        if (seconds) {
+          double rendered_seconds = 0.0;
+          double render_ms = 0.0;
+          if (fmod_bridge_->Render(static_cast<float>(*seconds),
+                                   &rendered_seconds, &render_ms)) {
+            result->Success(flutter::EncodableValue(flutter::EncodableMap{
+                {flutter::EncodableValue("renderedSeconds"),
+                 flutter::EncodableValue(rendered_seconds)},
+                {flutter::EncodableValue("renderMs"),
+                 flutter::EncodableValue(render_ms)},
+            }));
+          } else {
+            result->Success();
+          }
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Render duration required");
+
+  } else if (method_name == "getRenderedAudio") {
+    std::vector<float> samples;
+    int sample_rate = 0;
+    int channels = 0;
+    if (fmod_bridge_->TakeRenderedAudio(&samples, &sample_rate, &channels)) {
+      result->Success(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("sampleRate"),
+           flutter::EncodableValue(sample_rate)},
+          {flutter::EncodableValue("channels"),
+           flutter::EncodableValue(channels)},
+          {flutter::EncodableValue("samples"),
+           flutter::EncodableValue(std::move(samples))},
+      }));
+    } else {
+      result->Success();
+    }
+
+  } else if (method_name == "loadSound") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto stream_it = args->find(flutter::EncodableValue("stream"));
+      if (path_it != args->end() && stream_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *stream = std::get_if<bool>(&stream_it->second);
+        if (path && stream) {
+          std::string resolved = ResolveAssetPath(*path);
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->LoadSound(resolved, *stream)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Sound path and stream flag required");
+
+  } else if (method_name == "playSound") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      auto volume_it = args->find(flutter::EncodableValue("volume"));
+      if (id_it != args->end() && volume_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        const auto *volume = std::get_if<double>(&volume_it->second);
+        if (id && volume) {
+          result->Success(flutter::EncodableValue(fmod_bridge_->PlayLoadedSound(
+              *id, static_cast<float>(*volume))));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Sound id and volume required");
+
+  } else if (method_name == "unloadSound") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->UnloadSound(*id)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Sound id required");
+
+  } else if (method_name == "createPcmSound") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto buffer_it = args->find(flutter::EncodableValue("bufferId"));
+      auto rate_it = args->find(flutter::EncodableValue("sampleRate"));
+      auto channels_it = args->find(flutter::EncodableValue("channels"));
+      auto format_it = args->find(flutter::EncodableValue("format"));
+      if (buffer_it != args->end() && rate_it != args->end() &&
+          channels_it != args->end() && format_it != args->end()) {
+        const auto *buffer_id = std::get_if<int32_t>(&buffer_it->second);
+        const auto *rate = std::get_if<int32_t>(&rate_it->second);
+        const auto *channels = std::get_if<int32_t>(&channels_it->second);
+        const auto *format = std::get_if<int32_t>(&format_it->second);
+        if (buffer_id && rate && channels && format) {
+          result->Success(flutter::EncodableValue(fmod_bridge_->LoadPcmSound(
+              *buffer_id, *rate, *channels, *format)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "PCM buffer id and format required");
+
+  } else if (method_name == "playEventWithPcm") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto buffer_it = args->find(flutter::EncodableValue("bufferId"));
+      auto rate_it = args->find(flutter::EncodableValue("sampleRate"));
+      auto channels_it = args->find(flutter::EncodableValue("channels"));
+      auto format_it = args->find(flutter::EncodableValue("format"));
+      if (path_it != args->end() && buffer_it != args->end() &&
+          rate_it != args->end() && channels_it != args->end() &&
+          format_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *buffer_id = std::get_if<int32_t>(&buffer_it->second);
+        const auto *rate = std::get_if<int32_t>(&rate_it->second);
+        const auto *channels = std::get_if<int32_t>(&channels_it->second);
+        const auto *format = std::get_if<int32_t>(&format_it->second);
+        if (path && buffer_id && rate && channels && format) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->PlayEventWithPcm(*path, *buffer_id, *rate,
+                                             *channels, *format)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS",
+                  "Event path, PCM buffer id and format required");
+
+  } else if (method_name == "createPcmStream") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto rate_it = args->find(flutter::EncodableValue("sampleRate"));
+      auto channels_it = args->find(flutter::EncodableValue("channels"));
+      auto capacity_it = args->find(flutter::EncodableValue("capacityMs"));
+      if (rate_it != args->end() && channels_it != args->end() &&
+          capacity_it != args->end()) {
+        const auto *rate = std::get_if<int32_t>(&rate_it->second);
+        const auto *channels = std::get_if<int32_t>(&channels_it->second);
+        const auto *capacity = std::get_if<int32_t>(&capacity_it->second);
+        if (rate && channels && capacity) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->CreatePcmStream(*rate, *channels, *capacity)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS",
+                  "Sample rate, channels and capacity required");
+
+  } else if (method_name == "releasePcmStream") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->ReleasePcmStream(*id)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Stream id required");
+
+  } else if (method_name == "getPcmStreamStats") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          FmodPcmStreamStats stats;
+          if (fmod_bridge_->GetPcmStreamStats(*id, &stats)) {
+            result->Success(flutter::EncodableValue(flutter::EncodableMap{
+                {flutter::EncodableValue("sampleRate"),
+                 flutter::EncodableValue(stats.sample_rate)},
+                {flutter::EncodableValue("channels"),
+                 flutter::EncodableValue(stats.channels)},
+                {flutter::EncodableValue("capacityFrames"),
+                 flutter::EncodableValue(stats.capacity_frames)},
+                {flutter::EncodableValue("queuedFrames"),
+                 flutter::EncodableValue(stats.queued_frames)},
+                {flutter::EncodableValue("underruns"),
+                 flutter::EncodableValue(stats.underruns)},
+                {flutter::EncodableValue("underrunFrames"),
+                 flutter::EncodableValue(stats.underrun_frames)},
+                {flutter::EncodableValue("droppedFrames"),
+                 flutter::EncodableValue(stats.dropped_frames)},
+                {flutter::EncodableValue("latencyUs"),
+                 flutter::EncodableValue(stats.latency_us)},
+            }));
+          } else {
+            result->Success();
+          }
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Stream id required");
+
+  } else if (method_name == "startRecording") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto driver_it = args->find(flutter::EncodableValue("driver"));
+      auto monitor_it = args->find(flutter::EncodableValue("monitor"));
+      auto latency_it = args->find(flutter::EncodableValue("latencyMs"));
+      if (driver_it != args->end() && monitor_it != args->end() &&
+          latency_it != args->end()) {
+        const auto *driver = std::get_if<int32_t>(&driver_it->second);
+        const auto *monitor = std::get_if<bool>(&monitor_it->second);
+        const auto *latency = std::get_if<int32_t>(&latency_it->second);
+        if (driver && monitor && latency) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->StartRecording(*driver, *monitor, *latency)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Driver, monitor and latency required");
+
+  } else if (method_name == "stopRecording") {
+    result->Success(flutter::EncodableValue(fmod_bridge_->StopRecording()));
+
+  } else if (method_name == "startVoiceStats") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto window_it = args->find(flutter::EncodableValue("windowMs"));
+      if (window_it != args->end()) {
+        const auto *window_ms = std::get_if<int32_t>(&window_it->second);
+        if (window_ms) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->StartVoiceStats(*window_ms)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Window length required");
+
+  } else if (method_name == "stopVoiceStats") {
+    fmod_bridge_->StopVoiceStats();
+    result->Success();
+
+  } else if (method_name == "getVoiceStats") {
+    std::vector<FmodVoiceStatsWindow> windows;
+    std::vector<VoiceStats::EventStats> events;
+    fmod_bridge_->GetVoiceStats(&windows, &events);
+    flutter::EncodableList window_list;
+    for (const auto &window : windows) {
+      window_list.push_back(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("endUs"),
+           flutter::EncodableValue(window.end_us)},
+          {flutter::EncodableValue("durationUs"),
+           flutter::EncodableValue(window.duration_us)},
+          {flutter::EncodableValue("samples"),
+           flutter::EncodableValue(window.samples)},
+          {flutter::EncodableValue("maxChannels"),
+           flutter::EncodableValue(window.max_channels)},
+          {flutter::EncodableValue("softwareChannels"),
+           flutter::EncodableValue(window.software_channels)},
+          {flutter::EncodableValue("realPeak"),
+           flutter::EncodableValue(window.real_peak)},
+          {flutter::EncodableValue("virtualPeak"),
+           flutter::EncodableValue(window.virtual_peak)},
+          {flutter::EncodableValue("saturatedSamples"),
+           flutter::EncodableValue(window.saturated_samples)},
+          {flutter::EncodableValue("realSum"),
+           flutter::EncodableValue(window.real_sum)},
+          {flutter::EncodableValue("virtualSum"),
+           flutter::EncodableValue(window.virtual_sum)},
+          {flutter::EncodableValue("starts"),
+           flutter::EncodableValue(window.starts)},
+          {flutter::EncodableValue("startFailures"),
+           flutter::EncodableValue(window.start_failures)},
+          {flutter::EncodableValue("virtualizations"),
+           flutter::EncodableValue(window.virtualizations)},
+      }));
+    }
+    flutter::EncodableList event_list;
+    for (const auto &event : events) {
+      event_list.push_back(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("path"),
+           flutter::EncodableValue(event.path)},
+          {flutter::EncodableValue("instances"),
+           flutter::EncodableValue(event.stats.instances)},
+          {flutter::EncodableValue("peakInstances"),
+           flutter::EncodableValue(event.stats.peak_instances)},
+          {flutter::EncodableValue("starts"),
+           flutter::EncodableValue(event.stats.starts)},
+          {flutter::EncodableValue("startFailures"),
+           flutter::EncodableValue(event.stats.start_failures)},
+          {flutter::EncodableValue("virtualizations"),
+           flutter::EncodableValue(event.stats.virtualizations)},
+      }));
+    }
+    result->Success(flutter::EncodableValue(flutter::EncodableMap{
+        {flutter::EncodableValue("windows"),
+         flutter::EncodableValue(window_list)},
+        {flutter::EncodableValue("events"),
+         flutter::EncodableValue(event_list)},
+    }));
+
+  } else if (method_name == "queryInstances") {
+    std::vector<FmodInstanceState> states;
+    std::vector<std::string> keys;
+    fmod_bridge_->QueryInstances(&states, &keys);
+    // Records go to Dart as raw bytes, parsed by FmodInstanceSnapshot.
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(states.data());
+    flutter::EncodableList key_list;
+    for (const auto &key : keys) {
+      key_list.push_back(flutter::EncodableValue(key));
+    }
+    result->Success(flutter::EncodableValue(flutter::EncodableMap{
+        {flutter::EncodableValue("states"),
+         flutter::EncodableValue(std::vector<uint8_t>(
+             bytes, bytes + states.size() * sizeof(FmodInstanceState)))},
+        {flutter::EncodableValue("keys"),
+         flutter::EncodableValue(key_list)},
+    }));
+
+  } else if (method_name == "getRecordingStats") {
+    FmodMicStats stats;
+    if (fmod_bridge_->GetRecordingStats(&stats)) {
+      result->Success(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("recording"),
+           flutter::EncodableValue(stats.recording != 0)},
+          {flutter::EncodableValue("monitoring"),
+           flutter::EncodableValue(stats.monitoring != 0)},
+          {flutter::EncodableValue("sampleRate"),
+           flutter::EncodableValue(stats.sample_rate)},
+          {flutter::EncodableValue("channels"),
+           flutter::EncodableValue(stats.channels)},
+          {flutter::EncodableValue("recordedFrames"),
+           flutter::EncodableValue(stats.recorded_frames)},
+          {flutter::EncodableValue("droppedSamples"),
+           flutter::EncodableValue(stats.dropped_samples)},
+          {flutter::EncodableValue("monitorLatencyUs"),
+           flutter::EncodableValue(stats.monitor_latency_us)},
+          {flutter::EncodableValue("targetLatencyUs"),
+           flutter::EncodableValue(stats.target_latency_us)},
+      }));
+    } else {
+      result->Success();
+    }
+
+  } else if (method_name == "startCommandCapture") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto flush_it = args->find(flutter::EncodableValue("flushEachCommand"));
+      if (path_it != args->end() && flush_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *flush = std::get_if<bool>(&flush_it->second);
+        if (path && flush) {
+          // Relative paths resolve against the working directory
+          std::error_code error;
+          std::string full_path =
+              std::filesystem::absolute(*path, error).string();
+          if (error || !fmod_bridge_->StartCommandCapture(full_path, *flush)) {
+            result->Success();
+          } else {
+            result->Success(flutter::EncodableValue(full_path));
+          }
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Capture path and flush flag required");
+
+  } else if (method_name == "stopCommandCapture") {
+    result->Success(flutter::EncodableValue(fmod_bridge_->StopCommandCapture()));
+
+  } else if (method_name == "configureInstancePool") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto prewarm_it = args->find(flutter::EncodableValue("prewarm"));
+      auto capacity_it = args->find(flutter::EncodableValue("capacity"));
+      if (path_it != args->end() && prewarm_it != args->end() &&
+          capacity_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *prewarm = std::get_if<int32_t>(&prewarm_it->second);
+        const auto *capacity = std::get_if<int32_t>(&capacity_it->second);
+        if (path && prewarm && capacity) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->ConfigureInstancePool(*path, *prewarm, *capacity)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path, prewarm count, and capacity required");
+
+  } else if (method_name == "getInstancePoolStats") {
+    std::string path;
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      if (path_it != args->end()) {
+        const auto *value = std::get_if<std::string>(&path_it->second);
+        if (value) {
+          path = *value;
+        }
+      }
+    }
+    FmodInstancePoolStats stats;
+    if (fmod_bridge_->GetInstancePoolStats(path, &stats)) {
+      result->Success(flutter::EncodableValue(flutter::EncodableMap{
+          {flutter::EncodableValue("idleCount"),
+           flutter::EncodableValue(stats.idle_count)},
+          {flutter::EncodableValue("capacity"),
+           flutter::EncodableValue(stats.capacity)},
+          {flutter::EncodableValue("hits"),
+           flutter::EncodableValue(stats.hits)},
+          {flutter::EncodableValue("misses"),
+           flutter::EncodableValue(stats.misses)},
+      }));
+    } else {
+      result->Success();
+    }
+
+  } else if (method_name == "setGlobalParameter") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto name_it = args->find(flutter::EncodableValue("name"));
+      auto value_it = args->find(flutter::EncodableValue("value"));
+      if (name_it != args->end() && value_it != args->end()) {
+        const auto *name = std::get_if<std::string>(&name_it->second);
+        const auto *value = std::get_if<double>(&value_it->second);
+        if (name && value) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->SetGlobalParameter(*name,
+                                               static_cast<float>(*value))));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Name and value required");
+
+  } else if (method_name == "getGlobalParameter") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto name_it = args->find(flutter::EncodableValue("name"));
+      if (name_it != args->end()) {
+        const auto *name = std::get_if<std::string>(&name_it->second);
+        if (name) {
+          float value = 0.0f;
+          if (fmod_bridge_->GetGlobalParameter(*name, &value)) {
+            result->Success(flutter::EncodableValue(static_cast<double>(value)));
+          } else {
+            result->Success();
+          }
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Name required");
+
+  } else if (method_name == "resolveGlobalParameters") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto names_it = args->find(flutter::EncodableValue("names"));
+      if (names_it != args->end()) {
+        const auto *list = std::get_if<flutter::EncodableList>(&names_it->second);
+        if (list) {
+          std::vector<std::string> names;
+          for (const auto &value : *list) {
+            const auto *name = std::get_if<std::string>(&value);
+            names.push_back(name ? *name : std::string());
+          }
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->ResolveGlobalParameters(names)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Parameter names required");
+
+  } else if (method_name == "setGlobalParameters") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto slots_it = args->find(flutter::EncodableValue("slots"));
+      auto values_it = args->find(flutter::EncodableValue("values"));
+      if (slots_it != args->end() && values_it != args->end()) {
+        const auto *slots =
+            std::get_if<std::vector<int32_t>>(&slots_it->second);
+        const auto *values =
+            std::get_if<std::vector<float>>(&values_it->second);
+        if (slots && values && values->size() >= slots->size()) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->SetGlobalParameters(
+                  slots->data(), values->data(),
+                  static_cast<int>(slots->size()))));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Slots and values required");
+
+  } else if (method_name == "automateParameter") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto param_it = args->find(flutter::EncodableValue("parameter"));
+      auto type_it = args->find(flutter::EncodableValue("type"));
+      auto data_it = args->find(flutter::EncodableValue("data"));
+      if (path_it != args->end() && param_it != args->end() &&
+          type_it != args->end() && data_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *param = std::get_if<std::string>(&param_it->second);
+        const auto *type = std::get_if<int32_t>(&type_it->second);
+        const auto *data = std::get_if<std::vector<float>>(&data_it->second);
+        if (path && param && type && data) {
+          result->Success(flutter::EncodableValue(fmod_bridge_->AutomateParameter(
+              *path, *param, *type, data->data(),
+              static_cast<int>(data->size()))));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path, parameter, type, and curve data required");
+
+  } else if (method_name == "releaseAutomation" ||
+             method_name == "cancelAutomation") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          bool success = method_name == "releaseAutomation"
+                             ? fmod_bridge_->ReleaseAutomation(*id)
+                             : fmod_bridge_->CancelAutomation(*id);
+          result->Success(flutter::EncodableValue(success));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Automation id required");
+
+  } else if (method_name == "scheduleAtBeat") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto bar_it = args->find(flutter::EncodableValue("bar"));
+      auto beat_it = args->find(flutter::EncodableValue("beat"));
+      auto start_it = args->find(flutter::EncodableValue("startEvent"));
+      if (path_it != args->end() && bar_it != args->end() &&
+          beat_it != args->end()) {
+        std::string path;
+        const auto *bar = std::get_if<int32_t>(&bar_it->second);
+        const auto *beat = std::get_if<int32_t>(&beat_it->second);
+        std::string start_event;
+        if (start_it != args->end()) {
+          GetEventKey(start_it->second, &start_event);
+        }
+        if (GetEventKey(path_it->second, &path) && bar && beat) {
+          int id = fmod_bridge_->ScheduleAtBeat(path, *bar, *beat,
+                                                start_event);
+          result->Success(flutter::EncodableValue(id));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Path, bar, and beat required");
+
+  } else if (method_name == "cancelBeatSchedule") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->CancelBeatSchedule(*id)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Schedule id required");
+
+  } else if (method_name == "createEmitter") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("path"));
+      auto start_it = args->find(flutter::EncodableValue("start"));
+      if (path_it != args->end()) {
+        std::string path;
+        const bool *start = nullptr;
+        if (start_it != args->end()) {
+          start = std::get_if<bool>(&start_it->second);
+        }
+        if (GetEventKey(path_it->second, &path)) {
+          int id = fmod_bridge_->CreateEmitter(path, start ? *start : true);
+          result->Success(flutter::EncodableValue(id));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Event path required");
+
+  } else if (method_name == "releaseEmitter") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->ReleaseEmitter(*id)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Emitter id required");
+
+  } else if (method_name == "updateSpatial") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto listeners_it = args->find(flutter::EncodableValue("listeners"));
+      auto ids_it = args->find(flutter::EncodableValue("emitterIds"));
+      auto emitters_it = args->find(flutter::EncodableValue("emitters"));
+      if (listeners_it != args->end() && ids_it != args->end() &&
+          emitters_it != args->end()) {
+        const auto *listeners =
+            std::get_if<std::vector<float>>(&listeners_it->second);
+        const auto *ids = std::get_if<std::vector<int32_t>>(&ids_it->second);
+        const auto *emitters =
+            std::get_if<std::vector<float>>(&emitters_it->second);
+        if (listeners && ids && emitters &&
+            emitters->size() >= ids->size() * 12) {
+          bool success = fmod_bridge_->UpdateSpatial(
+              listeners->data(), static_cast<int>(listeners->size() / 12),
+              ids->data(), emitters->data(), static_cast<int>(ids->size()));
+          result->Success(flutter::EncodableValue(success));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS",
+                  "Listeners, emitter ids, and emitters required");
+
+  } else if (method_name == "setEmitterCulling") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto enabled_it = args->find(flutter::EncodableValue("enabled"));
+      auto hysteresis_it = args->find(flutter::EncodableValue("hysteresis"));
+      if (enabled_it != args->end() && hysteresis_it != args->end()) {
+        const auto *enabled = std::get_if<bool>(&enabled_it->second);
+        const auto *hysteresis = std::get_if<double>(&hysteresis_it->second);
+        if (enabled && hysteresis) {
+          fmod_bridge_->SetEmitterCulling(*enabled,
+                                          static_cast<float>(*hysteresis));
+          result->Success();
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Enabled and hysteresis required");
+
+  } else if (method_name == "addBusEffect") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto path_it = args->find(flutter::EncodableValue("busPath"));
+      auto type_it = args->find(flutter::EncodableValue("type"));
+      auto indices_it = args->find(flutter::EncodableValue("parameterIndices"));
+      auto values_it = args->find(flutter::EncodableValue("parameterValues"));
+      if (path_it != args->end() && type_it != args->end() &&
+          indices_it != args->end() && values_it != args->end()) {
+        const auto *path = std::get_if<std::string>(&path_it->second);
+        const auto *type = std::get_if<int32_t>(&type_it->second);
+        const auto *indices =
+            std::get_if<std::vector<int32_t>>(&indices_it->second);
+        const auto *values =
+            std::get_if<std::vector<float>>(&values_it->second);
+        if (path && type && indices && values &&
+            values->size() >= indices->size()) {
+          result->Success(flutter::EncodableValue(fmod_bridge_->AddBusEffect(
+              *path, *type, indices->data(), values->data(),
+              static_cast<int>(indices->size()))));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Bus path, type, and parameters required");
+
+  } else if (method_name == "removeBusEffect") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          result->Success(
+              flutter::EncodableValue(fmod_bridge_->RemoveBusEffect(*id)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Effect id required");
+
+  } else if (method_name == "setBusEffectParameter") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      auto index_it = args->find(flutter::EncodableValue("index"));
+      auto value_it = args->find(flutter::EncodableValue("value"));
+      if (id_it != args->end() && index_it != args->end() &&
+          value_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        const auto *index = std::get_if<int32_t>(&index_it->second);
+        const auto *value = std::get_if<double>(&value_it->second);
+        if (id && index && value) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->SetBusEffectParameter(*id, *index,
+                                                  static_cast<float>(*value))));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Effect id, index, and value required");
+
+  } else if (method_name == "addSpectrumAnalyzer") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto target_it = args->find(flutter::EncodableValue("target"));
+      auto bands_it = args->find(flutter::EncodableValue("bands"));
+      auto window_it = args->find(flutter::EncodableValue("windowSize"));
+      if (target_it != args->end() && bands_it != args->end() &&
+          window_it != args->end()) {
+        const auto *target = std::get_if<std::string>(&target_it->second);
+        const auto *bands = std::get_if<int32_t>(&bands_it->second);
+        const auto *window_size = std::get_if<int32_t>(&window_it->second);
+        if (target && bands && window_size) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->AddSpectrumAnalyzer(*target, *bands,
+                                                *window_size)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Target, bands, and window size required");
+
+  } else if (method_name == "removeSpectrumAnalyzer") {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (args) {
+      auto id_it = args->find(flutter::EncodableValue("id"));
+      if (id_it != args->end()) {
+        const auto *id = std::get_if<int32_t>(&id_it->second);
+        if (id) {
+          result->Success(flutter::EncodableValue(
+              fmod_bridge_->RemoveSpectrumAnalyzer(*id)));
+          return;
+        }
+      }
+    }
+    result->Error("INVALID_ARGS", "Analyzer id required");
+
   } else if (method_name == "update") {
     fmod_bridge_->Update();
     result->Success();
@@ -14,7 +14,9 @@ class FmodFlutterPlugin : public flutter::Plugin {
  public:
   static void RegisterWithRegistrar(flutter::PluginRegistrarWindows *registrar);
 
-  FmodFlutterPlugin();
+  FmodFlutterPlugin(
+      flutter::PluginRegistrarWindows *registrar,
+      std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel);
   virtual ~FmodFlutterPlugin();
 
   // Disallow copy and assign.
@@ -26,7 +28,14 @@ class FmodFlutterPlugin : public flutter::Plugin {
       const flutter::MethodCall<flutter::EncodableValue> &method_call,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+  // Forwards notifications queued by the bridge's update thread to Dart.
+  // Runs on the platform thread.
+  void DeliverNotifications();
+
+  flutter::PluginRegistrarWindows *registrar_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
   std::unique_ptr<FmodBridge> fmod_bridge_;
+  int window_proc_id_ = -1;
 };
 
 }  // namespace fmod_flutter